@@ -7,12 +7,15 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #include "api/api_messages_search_merged.h"
 
+#include "data/data_messages_search_index.h"
+#include "data/data_session.h"
 #include "history/history.h"
 
 namespace Api {
 
 MessagesSearchMerged::MessagesSearchMerged(not_null<History*> history)
-: _apiSearch(history) {
+: _history(history)
+, _apiSearch(history) {
 	if (const auto migrated = history->migrateFrom()) {
 		_migratedSearch.emplace(migrated);
 	}
@@ -21,6 +24,15 @@ MessagesSearchMerged::MessagesSearchMerged(not_null<History*> history)
 			if (_concatedFound.total >= 0 && _migratedFirstFound.total >= 0) {
 				_waitingForTotal = false;
 				_concatedFound.total += _migratedFirstFound.total;
+				if (base::take(_shownWithoutMigrated)) {
+					_nextFounds.fire({});
+				} else {
+					_newFounds.fire({});
+				}
+			} else if (_concatedFound.total >= 0 && !_shownWithoutMigrated) {
+				// The migrated results are older than all of the main ones,
+				// so the main ones are shown without waiting for them.
+				_shownWithoutMigrated = true;
 				_newFounds.fire({});
 			}
 		} else {
@@ -80,13 +92,40 @@ void MessagesSearchMerged::clear() {
 }
 
 void MessagesSearchMerged::search(const Request &search) {
+	showLocalFound(search);
 	if (_migratedSearch) {
 		_waitingForTotal = true;
+		_shownWithoutMigrated = false;
 		_migratedSearch->searchMessages(search);
 	}
 	_apiSearch.searchMessages(search);
 }
 
+void MessagesSearchMerged::showLocalFound(const Request &search) {
+	if (!Data::MessagesSearchIndex::Enabled()
+		|| search.query.isEmpty()
+		|| search.from
+		|| !search.tags.empty()) {
+		return;
+	}
+	const auto &index = _history->owner().messagesSearchIndex();
+	auto messages = index.search(_history, search.query);
+	if (const auto migrated = _history->migrateFrom()) {
+		auto more = index.search(migrated, search.query);
+		messages.insert(end(messages), begin(more), end(more));
+	}
+	if (messages.empty()) {
+		return;
+	}
+
+	// The server results have a non-empty token and replace these ones.
+	_concatedFound = FoundMessages{
+		.total = int(messages.size()),
+		.messages = std::move(messages),
+	};
+	_newFounds.fire({});
+}
+
 void MessagesSearchMerged::searchMore() {
 	if (_migratedSearch && _isFull) {
 		_migratedSearch->searchMore();
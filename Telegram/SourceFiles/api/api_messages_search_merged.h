@@ -37,7 +37,9 @@ public:
 
 private:
 	void addFound(const FoundMessages &data);
+	void showLocalFound(const Request &search);
 
+	const not_null<History*> _history;
 	MessagesSearch _apiSearch;
 
 	std::optional<MessagesSearch> _migratedSearch;
@@ -46,6 +48,7 @@ private:
 	FoundMessages _concatedFound;
 
 	bool _waitingForTotal = false;
+	bool _shownWithoutMigrated = false;
 	bool _isFull = false;
 
 	rpl::event_stream<> _newFounds;
@@ -142,7 +142,7 @@ void SendProgressManager::send(const Key &key, int progress) {
 		action
 	)).done([=](const MTPBool &result, mtpRequestId requestId) {
 		done(requestId);
-	}).send();
+	}).afterDelay(MTP::kBackgroundRequestDelay).send();
 	_requests.emplace(key, requestId);
 
 	if (key.type == Type::Typing) {
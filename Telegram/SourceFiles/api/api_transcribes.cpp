@@ -17,8 +17,29 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "history/history_item_helpers.h"
 #include "main/main_app_config.h"
 #include "main/main_session.h"
+#include "storage/cache/storage_cache_database.h"
 
 namespace Api {
+namespace {
+
+[[nodiscard]] DocumentData *TranscribedDocument(
+		not_null<HistoryItem*> item) {
+	const auto media = item->media();
+	return media ? media->document() : nullptr;
+}
+
+void ToggleRound(
+		not_null<HistoryItem*> item,
+		Transcribes::Entry &entry) {
+	if (const auto document = TranscribedDocument(item)) {
+		if (document->isVideoMessage()) {
+			entry.roundview = true;
+			document->owner().requestItemViewRefresh(item);
+		}
+	}
+}
+
+} // namespace
 
 Transcribes::Transcribes(not_null<ApiWrap*> api)
 : _session(&api->session())
@@ -78,7 +99,7 @@ void Transcribes::toggle(not_null<HistoryItem*> item) {
 		load(item);
 		//_session->data().requestItemRepaint(item);
 		_session->data().requestItemResize(item);
-	} else if (!i->second.requestId) {
+	} else if (!i->second.requestId && !_checkingCache.contains(id)) {
 		i->second.shown = !i->second.shown;
 		if (i->second.roundview) {
 			_session->data().requestItemViewRefresh(item);
@@ -108,6 +129,9 @@ void Transcribes::apply(const MTPDupdateTranscribedAudio &update) {
 	j->second.result = text;
 	j->second.pending = update.is_pending();
 	if (const auto item = _session->data().message(i->second)) {
+		if (!j->second.pending) {
+			saveCached(item, text);
+		}
 		if (j->second.roundview) {
 			_session->data().requestItemViewRefresh(item);
 		}
@@ -119,16 +143,61 @@ void Transcribes::load(not_null<HistoryItem*> item) {
 	if (!item->isHistoryEntry() || item->isLocal()) {
 		return;
 	}
-	const auto toggleRound = [](not_null<HistoryItem*> item, Entry &entry) {
-		if (const auto media = item->media()) {
-			if (const auto document = media->document()) {
-				if (document->isVideoMessage()) {
-					entry.roundview = true;
-					document->owner().requestItemViewRefresh(item);
-				}
-			}
-		}
-	};
+	const auto document = TranscribedDocument(item);
+	if (!document) {
+		request(item);
+		return;
+	}
+	const auto id = item->fullId();
+	auto &entry = _map.emplace(id).first->second;
+	entry.shown = true;
+	entry.failed = false;
+	entry.pending = true;
+	_checkingCache.emplace(id);
+
+	const auto weak = base::make_weak(this);
+	const auto key = Data::TranscriptionCacheKey(document->id);
+	_session->data().cache().get(key, [=](QByteArray &&value) {
+		crl::on_main(weak, [=, value = std::move(value)] {
+			cachedChecked(id, value);
+		});
+	});
+}
+
+void Transcribes::cachedChecked(FullMsgId id, const QByteArray &value) {
+	if (!_checkingCache.remove(id)) {
+		return;
+	}
+	const auto item = _session->data().message(id);
+	if (!item) {
+		_map.remove(id);
+		return;
+	} else if (value.isEmpty()) {
+		request(item);
+		return;
+	}
+	auto &entry = _map[id];
+	entry.pending = false;
+	entry.result = QString::fromUtf8(value);
+	ToggleRound(item, entry);
+	_session->data().requestItemResize(item);
+}
+
+void Transcribes::saveCached(
+		not_null<HistoryItem*> item,
+		const QString &text) {
+	const auto document = TranscribedDocument(item);
+	if (!document || text.isEmpty()) {
+		return;
+	}
+	_session->data().cache().put(
+		Data::TranscriptionCacheKey(document->id),
+		Storage::Cache::Database::TaggedValue(
+			text.toUtf8(),
+			Data::kMessagesCacheTag));
+}
+
+void Transcribes::request(not_null<HistoryItem*> item) {
 	const auto id = item->fullId();
 	const auto requestId = _api.request(MTPmessages_TranscribeAudio(
 		item->history()->peer->input,
@@ -158,7 +227,10 @@ void Transcribes::load(not_null<HistoryItem*> item) {
 		entry.result = qs(data.vtext());
 		_ids.emplace(data.vtranscription_id().v, id);
 		if (const auto item = _session->data().message(id)) {
-			toggleRound(item, entry);
+			if (!entry.pending) {
+				saveCached(item, entry.result);
+			}
+			ToggleRound(item, entry);
 			_session->data().requestItemResize(item);
 		}
 	}).fail([=](const MTP::Error &error) {
@@ -170,7 +242,7 @@ void Transcribes::load(not_null<HistoryItem*> item) {
 			entry.toolong = true;
 		}
 		if (const auto item = _session->data().message(id)) {
-			toggleRound(item, entry);
+			ToggleRound(item, entry);
 			_session->data().requestItemResize(item);
 		}
 	}).send();
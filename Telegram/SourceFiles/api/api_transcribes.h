@@ -7,6 +7,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #pragma once
 
+#include "base/weak_ptr.h"
 #include "mtproto/sender.h"
 
 class ApiWrap;
@@ -17,7 +18,7 @@ class Session;
 
 namespace Api {
 
-class Transcribes final {
+class Transcribes final : public base::has_weak_ptr {
 public:
 	explicit Transcribes(not_null<ApiWrap*> api);
 
@@ -45,6 +46,9 @@ public:
 
 private:
 	void load(not_null<HistoryItem*> item);
+	void request(not_null<HistoryItem*> item);
+	void cachedChecked(FullMsgId id, const QByteArray &value);
+	void saveCached(not_null<HistoryItem*> item, const QString &text);
 
 	const not_null<Main::Session*> _session;
 	MTP::Sender _api;
@@ -55,6 +59,7 @@ private:
 
 	base::flat_map<FullMsgId, Entry> _map;
 	base::flat_map<uint64, FullMsgId> _ids;
+	base::flat_set<FullMsgId> _checkingCache;
 
 };
 
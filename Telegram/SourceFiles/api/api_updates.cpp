@@ -8,6 +8,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "api/api_updates.h"
 
 #include "api/api_authorizations.h"
+#include "api/api_updates_recorder.h"
 #include "api/api_user_names.h"
 #include "api/api_chat_participants.h"
 #include "api/api_global_privacy.h"
@@ -72,6 +73,9 @@ constexpr auto kChannelGetDifferenceLimit = 100;
 // 1s wait after show channel history before sending getChannelDifference.
 constexpr auto kWaitForChannelGetDifference = crl::time(1000);
 
+// Max getChannelDifference requests for channels catching up at once.
+constexpr auto kChannelCatchUpConcurrency = 8;
+
 // If nothing is received in 1 min we ping.
 constexpr auto kNoUpdatesTimeout = 60 * 1000;
 
@@ -240,9 +244,19 @@ Updates::Updates(not_null<Main::Session*> session)
 , _idleFinishTimer([=] { checkIdleFinish(); }) {
 	_ptsWaiter.setRequesting(true);
 
+	if (UpdatesRecorder::Enabled()) {
+		_recorder = std::make_unique<UpdatesRecorder>(session);
+	}
+
 	session->account().mtpUpdates(
 	) | rpl::start_with_next([=](const MTPUpdates &updates) {
-		mtpUpdateReceived(updates);
+		if (_recorder) {
+			_recorder->record(UpdatesRecorder::Kind::Updates, updates, [&] {
+				mtpUpdateReceived(updates);
+			});
+		} else {
+			mtpUpdateReceived(updates);
+		}
 	}, _lifetime);
 
 	session->account().mtpNewSessionCreated(
@@ -278,6 +292,8 @@ Updates::Updates(not_null<Main::Session*> session)
 	}, _lifetime);
 }
 
+Updates::~Updates() = default;
+
 Main::Session &Updates::session() const {
 	return *_session;
 }
@@ -417,6 +433,7 @@ void Updates::channelDifferenceDone(
 			"{ good - after not final channelDifference was received }%1"
 			).arg(_session->mtp().isTestMode() ? " TESTMODE" : ""));
 		getChannelDifference(channel);
+		return;
 	} else if (inActiveChats(channel)) {
 		channel->ptsSetWaitingForShortPoll(timeout
 			? (timeout * crl::time(1000))
@@ -424,6 +441,7 @@ void Updates::channelDifferenceDone(
 	} else {
 		channel->ptsSetWaitingForShortPoll(-1);
 	}
+	channelCatchUpFinished(channel);
 }
 
 void Updates::feedChannelDifference(
@@ -450,6 +468,66 @@ void Updates::channelDifferenceFail(
 		error.type(),
 		error.description()));
 	failDifferenceStartTimerFor(channel);
+	channelCatchUpFinished(channel);
+}
+
+void Updates::queueChannelCatchUp(not_null<ChannelData*> channel) {
+	if (_catchUpRunning.contains(channel)) {
+		return;
+	} else if (_catchUpQueued.empty() && _catchUpRunning.empty()) {
+		_catchUpStarted = crl::now();
+		_catchUpFinished = 0;
+	}
+	_catchUpQueued.emplace(channel);
+	sendChannelCatchUps();
+}
+
+int Updates::channelCatchUpPriority(not_null<ChannelData*> channel) const {
+	if (inActiveChats(channel)) {
+		return 0;
+	}
+	const auto history = session().data().historyLoaded(channel->id);
+	if (!history) {
+		return 3;
+	} else if (history->isPinnedDialog(FilterId())) {
+		return 1;
+	} else if (history->unreadCount() > 0) {
+		return 2;
+	}
+	return 3;
+}
+
+void Updates::sendChannelCatchUps() {
+	while (!_catchUpQueued.empty()
+		&& int(_catchUpRunning.size()) < kChannelCatchUpConcurrency) {
+		const auto i = ranges::min_element(
+			_catchUpQueued,
+			ranges::less(),
+			[&](not_null<ChannelData*> channel) {
+				return channelCatchUpPriority(channel);
+			});
+		const auto channel = *i;
+		_catchUpQueued.erase(i);
+
+		getChannelDifference(channel);
+		if (channel->ptsRequesting()) {
+			_catchUpRunning.emplace(channel);
+		} else {
+			++_catchUpFinished;
+		}
+	}
+	if (_catchUpQueued.empty() && _catchUpRunning.empty() && _catchUpStarted) {
+		MTP_LOG(0, ("Channel Catch-up: %1 channels in %2 ms."
+			).arg(_catchUpFinished
+			).arg(crl::now() - base::take(_catchUpStarted)));
+	}
+}
+
+void Updates::channelCatchUpFinished(not_null<ChannelData*> channel) {
+	if (_catchUpRunning.remove(channel)) {
+		++_catchUpFinished;
+		sendChannelCatchUps();
+	}
 }
 
 void Updates::stateDone(const MTPupdates_State &state) {
@@ -681,19 +759,50 @@ void Updates::getDifference() {
 
 	_ptsWaiter.setRequesting(true);
 
-	api().request(MTPupdates_GetDifference(
-		MTP_flags(0),
-		MTP_int(_ptsWaiter.current()),
-		MTPint(), // pts_limit
-		MTPint(), // pts_total_limit
-		MTP_int(_updatesDate),
-		MTP_int(_updatesQts),
-		MTPint() // qts_limit
-	)).done([=](const MTPupdates_Difference &result) {
-		differenceDone(result);
-	}).fail([=](const MTP::Error &error) {
-		differenceFail(error);
-	}).send();
+	// A difference after a long sleep may contain thousands of messages,
+	// so the reply is parsed on a background thread. Other updates wait
+	// in _ptsWaiter until it is applied, because it is still requesting.
+	const auto weak = base::make_weak(_session.get());
+	auto onDone = [=](const MTP::Response &response) {
+		crl::async([=, reply = response.reply] {
+			auto result = MTPupdates_Difference();
+			auto from = reply.constData();
+			const auto parsed = result.read(from, from + reply.size());
+			crl::on_main(weak, [=, result = std::move(result)] {
+				if (!parsed) {
+					LOG(("API Error: could not parse updates.difference."));
+					failDifferenceStartTimerFor(nullptr);
+				} else if (_recorder) {
+					_recorder->record(
+						UpdatesRecorder::Kind::Difference,
+						reply,
+						[&] { differenceDone(result); });
+				} else {
+					differenceDone(result);
+				}
+			});
+		});
+		return true;
+	};
+	auto onFail = [=](const MTP::Error &error, const MTP::Response &) {
+		if (MTP::IsDefaultHandledError(error)) {
+			return false;
+		} else if (weak) {
+			differenceFail(error);
+		}
+		return true;
+	};
+	_session->mtp().send(
+		MTPupdates_GetDifference(
+			MTP_flags(0),
+			MTP_int(_ptsWaiter.current()),
+			MTPint(), // pts_limit
+			MTPint(), // pts_total_limit
+			MTP_int(_updatesDate),
+			MTP_int(_updatesQts),
+			MTPint()), // qts_limit
+		std::move(onDone),
+		std::move(onFail));
 }
 
 void Updates::getChannelDifference(
@@ -727,7 +836,14 @@ void Updates::getChannelDifference(
 		MTP_int(channel->pts()),
 		MTP_int(kChannelGetDifferenceLimit)
 	)).done([=](const MTPupdates_ChannelDifference &result) {
-		channelDifferenceDone(channel, result);
+		if (_recorder) {
+			_recorder->record(
+				UpdatesRecorder::Kind::ChannelDifference,
+				result,
+				[&] { channelDifferenceDone(channel, result); });
+		} else {
+			channelDifferenceDone(channel, result);
+		}
 	}).fail([=](const MTP::Error &error) {
 		channelDifferenceFail(channel, error);
 	}).send();
@@ -2314,7 +2430,7 @@ void Updates::feedUpdate(const MTPUpdate &update) {
 		if (const auto channel = session().data().channelLoaded(d.vchannel_id())) {
 			const auto pts = d.vpts();
 			if (!pts || channel->pts() < pts->v) {
-				getChannelDifference(channel);
+				queueChannelCatchUp(channel);
 			}
 		}
 	} break;
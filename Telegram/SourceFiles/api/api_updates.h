@@ -27,9 +27,12 @@ struct EmojiInteractionsBunch;
 
 namespace Api {
 
+class UpdatesRecorder;
+
 class Updates final {
 public:
 	explicit Updates(not_null<Main::Session*> session);
+	~Updates();
 
 	[[nodiscard]] Main::Session &session() const;
 	[[nodiscard]] ApiWrap &api() const;
@@ -103,6 +106,11 @@ private:
 	void getChannelDifference(
 		not_null<ChannelData*> channel,
 		ChannelDifferenceRequest from = ChannelDifferenceRequest::Unknown);
+	void queueChannelCatchUp(not_null<ChannelData*> channel);
+	void sendChannelCatchUps();
+	void channelCatchUpFinished(not_null<ChannelData*> channel);
+	[[nodiscard]] int channelCatchUpPriority(
+		not_null<ChannelData*> channel) const;
 	void differenceDone(const MTPupdates_Difference &result);
 	void differenceFail(const MTP::Error &error);
 	void feedDifference(
@@ -194,6 +202,13 @@ private:
 		not_null<ChannelData*>,
 		mtpRequestId> _rangeDifferenceRequests;
 
+	// Channels that got updateChannelTooLong, usually from a difference
+	// after a long sleep, get their differences a few at a time.
+	base::flat_set<not_null<ChannelData*>> _catchUpQueued;
+	base::flat_set<not_null<ChannelData*>> _catchUpRunning;
+	crl::time _catchUpStarted = 0;
+	int _catchUpFinished = 0;
+
 	crl::time _lastUpdateTime = 0;
 	bool _handlingChannelDifference = false;
 
@@ -208,6 +223,8 @@ private:
 	bool _lastWasOnline = false;
 	rpl::variable<bool> _isIdle = false;
 
+	std::unique_ptr<UpdatesRecorder> _recorder;
+
 	rpl::lifetime _lifetime;
 
 };
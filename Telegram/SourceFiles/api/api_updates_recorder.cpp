@@ -0,0 +1,100 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "api/api_updates_recorder.h"
+
+#include "base/options.h"
+#include "data/data_changes.h"
+#include "main/main_session.h"
+
+#include <QtCore/QDateTime>
+
+namespace Api {
+namespace {
+
+constexpr auto kRecordMagic = qint32(0x52554454); // "TDUR"
+constexpr auto kRecordVersion = qint32(1);
+
+base::options::toggle RecordUpdatesOption({
+	.id = kOptionRecordUpdates,
+	.name = "Record updates",
+	.description = "Write all received updates and differences with their "
+		"apply time to a file in the tdata folder. "
+		"The file contains private data of the account.",
+	.restartRequired = true,
+});
+
+[[nodiscard]] QString RecordPath() {
+	return cWorkingDir() + u"tdata/updates_%1.tdur"_q.arg(
+		QDateTime::currentDateTime().toString(u"yyyyMMdd_hhmmss"_q));
+}
+
+} // namespace
+
+const char kOptionRecordUpdates[] = "record-updates";
+
+UpdatesRecorder::UpdatesRecorder(not_null<Main::Session*> session)
+: _session(session)
+, _started(crl::now())
+, _file(RecordPath()) {
+	if (!_file.open(QIODevice::WriteOnly)) {
+		LOG(("Updates Recorder: Could not open '%1' for writing."
+			).arg(_file.fileName()));
+		return;
+	}
+	_stream.setDevice(&_file);
+	_stream.setVersion(QDataStream::Qt_5_1);
+	_stream << kRecordMagic << kRecordVersion;
+	LOG(("Updates Recorder: Writing to '%1'.").arg(_file.fileName()));
+}
+
+UpdatesRecorder::~UpdatesRecorder() {
+	if (!_records) {
+		return;
+	}
+	LOG(("Updates Recorder: %1 records, %2 ms total, %3 ms worst, "
+		"%4 changes."
+		).arg(_records
+		).arg(_total / 1000.
+		).arg(_worst / 1000.
+		).arg(_changes));
+}
+
+bool UpdatesRecorder::Enabled() {
+	return RecordUpdatesOption.value();
+}
+
+void UpdatesRecorder::record(
+		Kind kind,
+		const mtpBuffer &buffer,
+		FnMut<void()> apply) {
+	const auto changes = _session->changes().updatedCount();
+	const auto start = crl::profile();
+	apply();
+	const auto duration = crl::profile() - start;
+	const auto caused = _session->changes().updatedCount() - changes;
+
+	++_records;
+	_changes += caused;
+	_total += duration;
+	_worst = std::max(_worst, duration);
+
+	if (!_stream.device()) {
+		return;
+	}
+	_stream
+		<< qint32(kind)
+		<< qint64(crl::now() - _started)
+		<< qint64(duration)
+		<< qint64(caused)
+		<< QByteArray(
+			reinterpret_cast<const char*>(buffer.constData()),
+			buffer.size() * sizeof(mtpPrime));
+	_file.flush();
+}
+
+} // namespace Api
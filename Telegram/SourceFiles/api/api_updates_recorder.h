@@ -0,0 +1,59 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include <QtCore/QFile>
+#include <QtCore/QDataStream>
+
+namespace Main {
+class Session;
+} // namespace Main
+
+namespace Api {
+
+extern const char kOptionRecordUpdates[];
+
+// Writes the received updates and differences to a file in tdata,
+// each record with the time it took to apply it and the count of the
+// Data::Changes notifications it caused.
+class UpdatesRecorder final {
+public:
+	enum class Kind : qint32 {
+		Updates = 1,
+		Difference = 2,
+		ChannelDifference = 3,
+	};
+
+	explicit UpdatesRecorder(not_null<Main::Session*> session);
+	~UpdatesRecorder();
+
+	[[nodiscard]] static bool Enabled();
+
+	template <typename Data>
+	void record(Kind kind, const Data &data, FnMut<void()> apply) {
+		auto buffer = mtpBuffer();
+		data.write(buffer);
+		record(kind, buffer, std::move(apply));
+	}
+	void record(Kind kind, const mtpBuffer &buffer, FnMut<void()> apply);
+
+private:
+	const not_null<Main::Session*> _session;
+	const crl::time _started = 0;
+
+	QFile _file;
+	QDataStream _stream;
+
+	int64 _records = 0;
+	int64 _changes = 0;
+	crl::profile_time _total = 0;
+	crl::profile_time _worst = 0;
+
+};
+
+} // namespace Api
@@ -8,6 +8,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "api/api_views.h"
 
 #include "apiwrap.h"
+#include "core/application.h"
 #include "data/data_peer.h"
 #include "data/data_peer_id.h"
 #include "data/data_session.h"
@@ -22,6 +23,10 @@ namespace {
 constexpr auto kSendViewsTimeout = crl::time(1000);
 constexpr auto kPollExtendedMediaPeriod = 30 * crl::time(1000);
 constexpr auto kMaxPollPerRequest = 100;
+constexpr auto kPollHiddenDelay = 60 * crl::time(1000);
+
+// Each poll of a chat that didn't change anything doubles its period.
+constexpr auto kMaxPollBackoffShift = 3;
 
 } // namespace
 
@@ -72,8 +77,9 @@ void ViewsManager::pollExtendedMedia(
 	request.ids.emplace(id);
 	if (force) {
 		request.forced = true;
+		_pollUnchanged.remove(peer);
 	}
-	const auto delay = force ? 1 : kPollExtendedMediaPeriod;
+	const auto delay = pollDelay(peer, force);
 	if (!request.id && (!request.when || force)) {
 		request.when = crl::now() + delay;
 	}
@@ -82,6 +88,17 @@ void ViewsManager::pollExtendedMedia(
 	}
 }
 
+crl::time ViewsManager::pollDelay(
+		not_null<PeerData*> peer,
+		bool forced) const {
+	if (forced) {
+		return 1;
+	}
+	const auto i = _pollUnchanged.find(peer);
+	const auto shift = (i != end(_pollUnchanged)) ? i->second : 0;
+	return kPollExtendedMediaPeriod << shift;
+}
+
 void ViewsManager::viewsIncrement() {
 	for (auto i = _toIncrement.begin(); i != _toIncrement.cend();) {
 		if (_incrementRequests.contains(i->first)) {
@@ -104,7 +121,7 @@ void ViewsManager::viewsIncrement() {
 			done(ids, result, requestId);
 		}).fail([=](const MTP::Error &error, mtpRequestId requestId) {
 			fail(error, requestId);
-		}).afterDelay(5).send();
+		}).afterDelay(MTP::kBackgroundRequestDelay).send();
 
 		_incrementRequests.emplace(i->first, requestId);
 		i = _toIncrement.erase(i);
@@ -112,6 +129,11 @@ void ViewsManager::viewsIncrement() {
 }
 
 void ViewsManager::sendPollRequests() {
+	if (!Core::App().hasShownWindows()) {
+		// Nobody sees the polled messages, check again later.
+		_pollTimer.callOnce(kPollHiddenDelay);
+		return;
+	}
 	const auto now = crl::now();
 	auto toRequest = base::flat_map<not_null<PeerData*>, QVector<MTPint>>();
 	auto nearest = crl::time();
@@ -158,19 +180,29 @@ void ViewsManager::sendPollRequests(
 			for (auto i = begin(_pollRequests); i != end(_pollRequests);) {
 				if (i->second.id == id) {
 					const auto peer = i->first->id;
+					auto changed = false;
 					for (const auto &itemId : i->second.sent) {
 						if (const auto item = owner->message(peer, itemId)) {
 							owner->requestItemRepaint(item);
+							changed |= !item->hasUnpaidContent();
+						} else {
+							changed = true;
 						}
 					}
+					if (changed) {
+						_pollUnchanged.remove(i->first);
+					} else {
+						auto &shift = _pollUnchanged[i->first];
+						shift = std::min(shift + 1, kMaxPollBackoffShift);
+					}
 					i->second.sent.clear();
 					i->second.id = 0;
 					if (i->second.ids.empty()) {
 						i = _pollRequests.erase(i);
 					} else {
-						const auto delay = i->second.forced
-							? 1
-							: kPollExtendedMediaPeriod;
+						const auto delay = pollDelay(
+							i->first,
+							i->second.forced);
 						i->second.when = now + delay;
 						if (!_pollTimer.isActive() || i->second.forced) {
 							_pollTimer.callOnce(delay);
@@ -190,7 +222,7 @@ void ViewsManager::sendPollRequests(
 			finish(id);
 		}).fail([=](const MTP::Error &error, mtpRequestId id) {
 			finish(id);
-		}).send();
+		}).afterDelay(MTP::kIdleRequestDelay).send();
 
 		_pollRequests[peer].id = requestId;
 	}
@@ -37,6 +37,10 @@ private:
 		bool forced = false;
 	};
 
+	[[nodiscard]] crl::time pollDelay(
+		not_null<PeerData*> peer,
+		bool forced) const;
+
 	void viewsIncrement();
 	void sendPollRequests();
 	void sendPollRequests(
@@ -62,6 +66,7 @@ private:
 	base::flat_map<
 		not_null<PeerData*>,
 		PollExtendedMediaRequest> _pollRequests;
+	base::flat_map<not_null<PeerData*>, int> _pollUnchanged;
 	base::Timer _pollTimer;
 
 };
@@ -86,6 +86,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "storage/file_upload.h"
 #include "storage/storage_account.h"
 
+#include <QtCore/QThread>
+
 namespace {
 
 // Save draft to the cloud with 1 sec extra delay.
@@ -96,11 +98,13 @@ constexpr auto kTopPromotionMinDelay = TimeId(10);
 constexpr auto kSmallDelayMs = 5;
 constexpr auto kReadFeaturedSetsTimeout = crl::time(1000);
 constexpr auto kFileLoaderQueueStopTimeout = crl::time(5000);
+constexpr auto kFileLoaderMaxWorkers = 4;
 constexpr auto kStickersByEmojiInvalidateTimeout = crl::time(6 * 1000);
 constexpr auto kNotifySettingSaveTimeout = crl::time(1000);
 constexpr auto kDialogsFirstLoad = 20;
 constexpr auto kDialogsPerPage = 500;
 constexpr auto kStatsSessionKillTimeout = 10 * crl::time(1000);
+constexpr auto kFullPeerReceivedTimeout = crl::time(1000);
 
 using PhotoFileLocationId = Data::PhotoFileLocationId;
 using DocumentFileLocationId = Data::DocumentFileLocationId;
@@ -133,6 +137,13 @@ void ShowChannelsLimitBox(not_null<PeerData*> peer) {
 	}
 }
 
+[[nodiscard]] int FileLoaderWorkersCount() {
+	return std::clamp(
+		QThread::idealThreadCount() / 2,
+		1,
+		kFileLoaderMaxWorkers);
+}
+
 [[nodiscard]] FileLoadTo FileLoadTaskOptions(const Api::SendAction &action) {
 	const auto peer = action.history->peer;
 	return FileLoadTo(
@@ -152,7 +163,9 @@ ApiWrap::ApiWrap(not_null<Main::Session*> session)
 , _draftsSaveTimer([=] { saveDraftsToCloud(); })
 , _featuredSetsReadTimer([=] { readFeaturedSets(); })
 , _dialogsLoadState(std::make_unique<DialogsLoadState>())
-, _fileLoader(std::make_unique<TaskQueue>(kFileLoaderQueueStopTimeout))
+, _fileLoader(std::make_unique<TaskQueue>(
+	kFileLoaderQueueStopTimeout,
+	FileLoaderWorkersCount()))
 , _topPromotionTimer([=] { refreshTopPromotion(); })
 , _updateNotifyTimer([=] { sendNotifySettingsUpdates(); })
 , _statsSessionKillTimer([=] { checkStatsSessions(); })
@@ -197,7 +210,12 @@ ApiWrap::ApiWrap(not_null<Main::Session*> session)
 	});
 }
 
-ApiWrap::~ApiWrap() = default;
+ApiWrap::~ApiWrap() {
+	if (_coalescedRequests) {
+		LOG(("API: Coalesced %1 duplicate requests."
+			).arg(_coalescedRequests));
+	}
+}
 
 Main::Session &ApiWrap::session() const {
 	return *_session;
@@ -580,6 +598,9 @@ void ApiWrap::requestMessageData(
 	auto &requests = (peer && peer->isChannel())
 		? _channelMessageDataRequests[peer->asChannel()][msgId]
 		: _messageDataRequests[msgId];
+	if (requests.requestId || !requests.callbacks.empty()) {
+		++_coalescedRequests;
+	}
 	if (done) {
 		requests.callbacks.push_back(std::move(done));
 	}
@@ -1122,8 +1143,23 @@ void ApiWrap::requestWallPaper(
 	}).send();
 }
 
+bool ApiWrap::receivedRecently(
+		base::flat_map<not_null<PeerData*>, crl::time> &received,
+		not_null<PeerData*> peer) {
+	const auto i = received.find(peer);
+	if (i == end(received)) {
+		return false;
+	} else if (crl::now() - i->second >= kFullPeerReceivedTimeout) {
+		received.erase(i);
+		return false;
+	}
+	return true;
+}
+
 void ApiWrap::requestFullPeer(not_null<PeerData*> peer) {
-	if (_fullPeerRequests.contains(peer)) {
+	if (_fullPeerRequests.contains(peer)
+		|| receivedRecently(_fullPeerReceived, peer)) {
+		++_coalescedRequests;
 		return;
 	}
 
@@ -1196,6 +1232,7 @@ void ApiWrap::gotChatFull(
 	});
 
 	_fullPeerRequests.remove(peer);
+	_fullPeerReceived[peer] = crl::now();
 	_session->changes().peerUpdated(
 		peer,
 		Data::PeerUpdate::Flag::FullInfo);
@@ -1217,13 +1254,16 @@ void ApiWrap::gotUserFull(
 		});
 	});
 	_fullPeerRequests.remove(user);
+	_fullPeerReceived[user] = crl::now();
 	_session->changes().peerUpdated(
 		user,
 		Data::PeerUpdate::Flag::FullInfo);
 }
 
 void ApiWrap::requestPeerSettings(not_null<PeerData*> peer) {
-	if (!_requestedPeerSettings.emplace(peer).second) {
+	if (receivedRecently(_peerSettingsReceived, peer)
+		|| !_requestedPeerSettings.emplace(peer).second) {
+		++_coalescedRequests;
 		return;
 	}
 	request(MTPmessages_GetPeerSettings(
@@ -1234,6 +1274,7 @@ void ApiWrap::requestPeerSettings(not_null<PeerData*> peer) {
 			_session->data().processChats(data.vchats());
 			peer->setBarSettings(data.vsettings());
 			_requestedPeerSettings.erase(peer);
+			_peerSettingsReceived[peer] = crl::now();
 		});
 	}).fail([=] {
 		_requestedPeerSettings.erase(peer);
@@ -1349,13 +1390,13 @@ void ApiWrap::markContentsRead(
 			MTP_vector<MTPint>(markedIds)
 		)).done([=](const MTPmessages_AffectedMessages &result) {
 			applyAffectedMessages(result);
-		}).send();
+		}).afterDelay(MTP::kBackgroundRequestDelay).send();
 	}
 	for (const auto &channelIds : channelMarkedIds) {
 		request(MTPchannels_ReadMessageContents(
 			channelIds.first->inputChannel,
 			MTP_vector<MTPint>(channelIds.second)
-		)).send();
+		)).afterDelay(MTP::kBackgroundRequestDelay).send();
 	}
 }
 
@@ -1368,13 +1409,13 @@ void ApiWrap::markContentsRead(not_null<HistoryItem*> item) {
 		request(MTPchannels_ReadMessageContents(
 			channel->inputChannel,
 			ids
-		)).send();
+		)).afterDelay(MTP::kBackgroundRequestDelay).send();
 	} else {
 		request(MTPmessages_ReadMessageContents(
 			ids
 		)).done([=](const MTPmessages_AffectedMessages &result) {
 			applyAffectedMessages(result);
-		}).send();
+		}).afterDelay(MTP::kBackgroundRequestDelay).send();
 	}
 }
 
@@ -2596,6 +2637,7 @@ void ApiWrap::updateSavedGifs() {
 }
 
 void ApiWrap::updateMasks() {
+	_session->data().stickers().ensureMasksLoaded();
 	const auto now = crl::now();
 	requestMasks(now);
 	requestRecentStickers(now, true);
@@ -464,6 +464,9 @@ private:
 		ChannelData *channel,
 		bool onlyExisting = false);
 
+	[[nodiscard]] bool receivedRecently(
+		base::flat_map<not_null<PeerData*>, crl::time> &received,
+		not_null<PeerData*> peer);
 	void gotChatFull(
 		not_null<PeerData*> peer,
 		const MTPmessages_ChatFull &result);
@@ -586,6 +589,11 @@ private:
 	PeerRequests _fullPeerRequests;
 	base::flat_set<not_null<PeerData*>> _requestedPeerSettings;
 
+	// Different widgets often ask for the same peer at nearly one moment.
+	base::flat_map<not_null<PeerData*>, crl::time> _fullPeerReceived;
+	base::flat_map<not_null<PeerData*>, crl::time> _peerSettingsReceived;
+	int _coalescedRequests = 0;
+
 	base::flat_map<
 		not_null<History*>,
 		std::pair<mtpRequestId,Fn<void()>>> _historyArchivedRequests;
@@ -0,0 +1,152 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "benchmarks/benchmark_main.h"
+
+#include "base/integration.h"
+
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonObject>
+
+#include <cstdio>
+
+namespace Benchmark {
+namespace {
+
+constexpr auto kWarmupIterations = 3;
+constexpr auto kMinIterations = 10;
+constexpr auto kMaxIterations = 1000;
+constexpr auto kTimeLimit = crl::profile_time(2'000'000);
+
+struct Case {
+	const char *name = nullptr;
+	Fn<Body()> prepare;
+};
+
+class BaseIntegration final : public base::Integration {
+public:
+	using Integration::Integration;
+
+	void enterFromEventLoop(FnMut<void()> &&method) {
+		method();
+	}
+	bool logSkipDebug() {
+		return true;
+	}
+	void logMessageDebug(const QString &message) {
+	}
+	void logMessage(const QString &message) {
+	}
+
+};
+
+[[nodiscard]] std::vector<Case> &Cases() {
+	static auto result = std::vector<Case>();
+	return result;
+}
+
+[[nodiscard]] QJsonObject Run(const Case &entry) {
+	const auto body = entry.prepare();
+	for (auto i = 0; i != kWarmupIterations; ++i) {
+		body();
+	}
+	auto durations = std::vector<crl::profile_time>();
+	durations.reserve(kMaxIterations);
+	const auto started = crl::profile();
+	while (int(durations.size()) < kMaxIterations) {
+		const auto start = crl::profile();
+		body();
+		const auto finish = crl::profile();
+		durations.push_back(finish - start);
+		if (int(durations.size()) >= kMinIterations
+			&& finish - started >= kTimeLimit) {
+			break;
+		}
+	}
+	const auto total = ranges::accumulate(
+		durations,
+		crl::profile_time(0));
+	ranges::sort(durations);
+	return QJsonObject{
+		{ u"name"_q, QString::fromLatin1(entry.name) },
+		{ u"iterations"_q, int(durations.size()) },
+		{ u"min_us"_q, double(durations.front()) },
+		{ u"median_us"_q, double(durations[durations.size() / 2]) },
+		{ u"mean_us"_q, double(total) / durations.size() },
+	};
+}
+
+} // namespace
+
+void Register(const char *name, Fn<Body()> prepare) {
+	Cases().push_back({ .name = name, .prepare = std::move(prepare) });
+}
+
+} // namespace Benchmark
+
+// Usage: benchmarks [-filter <name part>] [-output <path.json>]
+int main(int argc, char *argv[]) {
+	using namespace Benchmark;
+
+	auto app = QCoreApplication(argc, argv);
+
+	auto base = BaseIntegration(argc, argv);
+	base::Integration::Set(&base);
+
+	auto filter = QString();
+	auto output = QString();
+	const auto arguments = app.arguments();
+	for (auto i = 1; i + 1 < arguments.size(); i += 2) {
+		if (arguments[i] == u"-filter"_q) {
+			filter = arguments[i + 1];
+		} else if (arguments[i] == u"-output"_q) {
+			output = arguments[i + 1];
+		}
+	}
+
+	auto cases = Cases();
+	ranges::sort(cases, std::less<>(), [](const Case &entry) {
+		return QByteArray(entry.name);
+	});
+	auto results = QJsonArray();
+	for (const auto &entry : cases) {
+		if (!filter.isEmpty()
+			&& !QString::fromLatin1(entry.name).contains(filter)) {
+			continue;
+		}
+		const auto result = Run(entry);
+		std::fprintf(
+			stderr,
+			"%s: %.1f us median\n",
+			entry.name,
+			result.value(u"median_us"_q).toDouble());
+		results.push_back(result);
+	}
+	const auto json = QJsonDocument(QJsonObject{
+		{ u"benchmarks"_q, results },
+	}).toJson();
+	if (output.isEmpty()) {
+		std::fwrite(json.constData(), 1, json.size(), stdout);
+		return 0;
+	}
+	auto f = QFile(output);
+	if (!f.open(QIODevice::WriteOnly)
+		|| (f.write(json) != json.size())) {
+		std::fprintf(stderr, "Could not write '%s'.\n", qPrintable(output));
+		return 1;
+	}
+	return 0;
+}
+
+namespace crl {
+
+rpl::producer<> on_main_update_requests() {
+	return rpl::never<>();
+}
+
+} // namespace crl
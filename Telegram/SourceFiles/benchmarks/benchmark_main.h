@@ -0,0 +1,20 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include "base/basic_types.h"
+
+namespace Benchmark {
+
+// The body is measured, the preparation before it is not.
+using Body = Fn<void()>;
+
+// Called from static initializers, the name should be a string literal.
+void Register(const char *name, Fn<Body()> prepare);
+
+} // namespace Benchmark
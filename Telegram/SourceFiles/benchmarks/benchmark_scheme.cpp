@@ -0,0 +1,201 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "benchmarks/benchmark_main.h"
+
+namespace Benchmark {
+namespace {
+
+constexpr auto kMessagesCount = 1000;
+constexpr auto kUsersCount = 100;
+constexpr auto kChannelsCount = 50;
+
+[[nodiscard]] MTPMessage GenerateMessage(int index) {
+	using Flag = MTPDmessage::Flag;
+	const auto text = u"Message number %1. Lorem ipsum dolor sit amet, "
+		"consectetur adipiscing elit, sed do eiusmod tempor incididunt "
+		"ut labore et dolore magna aliqua."_q.arg(index);
+	return MTP_message(
+		MTP_flags(Flag::f_from_id | Flag::f_entities),
+		MTP_int(index + 1),
+		MTP_peerUser(MTP_long(index % kUsersCount + 1)),
+		MTPint(), // from_boosts_applied
+		MTP_peerUser(MTP_long(kUsersCount + 1)),
+		MTPPeer(), // saved_peer_id
+		MTPMessageFwdHeader(),
+		MTPlong(), // via_bot_id
+		MTPlong(), // via_business_bot_id
+		MTPMessageReplyHeader(),
+		MTP_int(1700000000 + index),
+		MTP_string(text),
+		MTPMessageMedia(),
+		MTPReplyMarkup(),
+		MTP_vector<MTPMessageEntity>(1, MTP_messageEntityBold(
+			MTP_int(0),
+			MTP_int(7))),
+		MTPint(), // views
+		MTPint(), // forwards
+		MTPMessageReplies(),
+		MTPint(), // edit_date
+		MTPstring(), // post_author
+		MTPlong(), // grouped_id
+		MTPMessageReactions(),
+		MTPVector<MTPRestrictionReason>(),
+		MTPint(), // ttl_period
+		MTPint(), // quick_reply_shortcut_id
+		MTPlong(), // effect
+		MTPFactCheck());
+}
+
+[[nodiscard]] MTPUser GenerateUser(int index) {
+	using Flag = MTPDuser::Flag;
+	return MTP_user(
+		MTP_flags(Flag::f_access_hash
+			| Flag::f_first_name
+			| Flag::f_username),
+		MTP_long(index + 1),
+		MTP_long(0x1234567890LL + index),
+		MTP_string(u"User %1"_q.arg(index)),
+		MTPstring(), // last_name
+		MTP_string(u"user_%1"_q.arg(index)),
+		MTPstring(), // phone
+		MTPUserProfilePhoto(),
+		MTPUserStatus(),
+		MTPint(), // bot_info_version
+		MTPVector<MTPRestrictionReason>(),
+		MTPstring(), // bot_inline_placeholder
+		MTPstring(), // lang_code
+		MTPEmojiStatus(),
+		MTPVector<MTPUsername>(),
+		MTPint(), // stories_max_id
+		MTPPeerColor(), // color
+		MTPPeerColor(), // profile_color
+		MTPint()); // bot_active_users
+}
+
+[[nodiscard]] MTPChat GenerateChannel(int index) {
+	using Flag = MTPDchannel::Flag;
+	return MTP_channel(
+		MTP_flags(Flag::f_megagroup
+			| Flag::f_access_hash
+			| Flag::f_participants_count),
+		MTP_long(index + 1),
+		MTP_long(0x1234567890LL + index),
+		MTP_string(u"Channel %1"_q.arg(index)),
+		MTPstring(), // username
+		MTP_chatPhotoEmpty(),
+		MTP_int(1700000000),
+		MTPVector<MTPRestrictionReason>(),
+		MTPChatAdminRights(),
+		MTPChatBannedRights(),
+		MTPChatBannedRights(), // default_banned_rights
+		MTP_int(1000 + index),
+		MTPVector<MTPUsername>(),
+		MTPint(), // stories_max_id
+		MTPPeerColor(), // color
+		MTPPeerColor(), // profile_color
+		MTPEmojiStatus(),
+		MTPint(), // level
+		MTPint()); // subscription_until_date
+}
+
+[[nodiscard]] QVector<MTPUser> GenerateUsers() {
+	auto result = QVector<MTPUser>();
+	result.reserve(kUsersCount);
+	for (auto i = 0; i != kUsersCount; ++i) {
+		result.push_back(GenerateUser(i));
+	}
+	return result;
+}
+
+[[nodiscard]] MTPmessages_Messages GenerateMessages() {
+	auto messages = QVector<MTPMessage>();
+	messages.reserve(kMessagesCount);
+	for (auto i = 0; i != kMessagesCount; ++i) {
+		messages.push_back(GenerateMessage(i));
+	}
+	return MTP_messages_messages(
+		MTP_vector<MTPMessage>(std::move(messages)),
+		MTP_vector<MTPChat>(),
+		MTP_vector<MTPUser>(GenerateUsers()));
+}
+
+// Half of the messages are new ones in private chats, the other half
+// comes as updateNewChannelMessage in the known channels.
+[[nodiscard]] MTPupdates_Difference GenerateDifference() {
+	auto messages = QVector<MTPMessage>();
+	auto updates = QVector<MTPUpdate>();
+	messages.reserve(kMessagesCount / 2);
+	updates.reserve(kMessagesCount - kMessagesCount / 2);
+	for (auto i = 0; i != kMessagesCount; ++i) {
+		auto message = GenerateMessage(i);
+		if (i % 2) {
+			updates.push_back(MTP_updateNewChannelMessage(
+				std::move(message),
+				MTP_int(i + 1),
+				MTP_int(1)));
+		} else {
+			messages.push_back(std::move(message));
+		}
+	}
+	auto chats = QVector<MTPChat>();
+	chats.reserve(kChannelsCount);
+	for (auto i = 0; i != kChannelsCount; ++i) {
+		chats.push_back(GenerateChannel(i));
+	}
+	return MTP_updates_difference(
+		MTP_vector<MTPMessage>(std::move(messages)),
+		MTP_vector<MTPEncryptedMessage>(),
+		MTP_vector<MTPUpdate>(std::move(updates)),
+		MTP_vector<MTPChat>(std::move(chats)),
+		MTP_vector<MTPUser>(GenerateUsers()),
+		MTP_updates_state(
+			MTP_int(kMessagesCount),
+			MTP_int(0), // qts
+			MTP_int(1700000000 + kMessagesCount),
+			MTP_int(1), // seq
+			MTP_int(0))); // unread_count
+}
+
+template <typename Type>
+[[nodiscard]] mtpBuffer Serialize(const Type &data) {
+	auto result = mtpBuffer();
+	data.write(result);
+	return result;
+}
+
+template <typename Type>
+[[nodiscard]] Fn<Body()> PrepareDeserialize(Fn<Type()> generate) {
+	return [=] {
+		const auto buffer = Serialize(generate());
+		return [=] {
+			auto from = buffer.constData();
+			const auto till = from + buffer.size();
+			auto result = Type();
+			Assert(result.read(from, till) && (from == till));
+		};
+	};
+}
+
+const auto Registered = [] {
+	Register("scheme/messages_serialize", [] {
+		const auto data = GenerateMessages();
+		return [=] {
+			Assert(!Serialize(data).isEmpty());
+		};
+	});
+	Register(
+		"scheme/messages_deserialize",
+		PrepareDeserialize<MTPmessages_Messages>(GenerateMessages));
+	Register(
+		"scheme/difference_deserialize",
+		PrepareDeserialize<MTPupdates_Difference>(GenerateDifference));
+	return true;
+}();
+
+} // namespace
+} // namespace Benchmark
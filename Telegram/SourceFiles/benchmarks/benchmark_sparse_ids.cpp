@@ -0,0 +1,63 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "benchmarks/benchmark_main.h"
+
+#include "storage/storage_sparse_ids_list.h"
+
+namespace Benchmark {
+namespace {
+
+constexpr auto kSlicesCount = 200;
+constexpr auto kSliceSize = 100;
+constexpr auto kSliceStep = 80;
+constexpr auto kTopId = MsgId(kSlicesCount * kSliceStep + kSliceSize);
+
+[[nodiscard]] std::vector<MsgId> SliceIds(MsgRange range) {
+	auto result = std::vector<MsgId>();
+	result.reserve(kSliceSize);
+	for (auto id = range.from; id <= range.till; ++id) {
+		result.push_back(id);
+	}
+	return result;
+}
+
+const auto Registered = [] {
+	// Slices loaded while scrolling up, each overlapping the previous.
+	Register("storage/sparse_ids_add_slices_up", [] {
+		return [] {
+			auto list = Storage::SparseIdsList();
+			for (auto i = 0; i != kSlicesCount; ++i) {
+				const auto till = kTopId - MsgId(i * kSliceStep);
+				const auto range = MsgRange(till - kSliceSize + 1, till);
+				list.addSlice(SliceIds(range), range, int(kTopId.bare));
+			}
+			Assert(!list.empty());
+		};
+	});
+
+	// Slices loaded from both ends and united in the middle.
+	Register("storage/sparse_ids_add_slices_both", [] {
+		return [] {
+			auto list = Storage::SparseIdsList();
+			for (auto i = 0; i != kSlicesCount / 2; ++i) {
+				const auto till = kTopId - MsgId(i * kSliceStep);
+				const auto top = MsgRange(till - kSliceSize + 1, till);
+				list.addSlice(SliceIds(top), top, int(kTopId.bare));
+
+				const auto from = MsgId(i * kSliceStep + 1);
+				const auto bottom = MsgRange(from, from + kSliceSize - 1);
+				list.addSlice(SliceIds(bottom), bottom, int(kTopId.bare));
+			}
+			Assert(!list.empty());
+		};
+	});
+	return true;
+}();
+
+} // namespace
+} // namespace Benchmark
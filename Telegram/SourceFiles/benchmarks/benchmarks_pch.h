@@ -0,0 +1,26 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+#include <QtCore/QFile>
+
+#include <crl/crl.h>
+#include <rpl/rpl.h>
+
+#include <vector>
+#include <optional>
+
+#include <range/v3/all.hpp>
+
+#include "base/basic_types.h"
+#include "base/flat_map.h"
+#include "base/flat_set.h"
+#include "data/data_msg_id.h"
+#include "scheme.h"
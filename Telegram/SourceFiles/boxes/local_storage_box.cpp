@@ -559,6 +559,20 @@ void LocalStorageBox::setupLimits(not_null<Ui::VerticalLayout*> container) {
 			label->setText(tr::lng_local_storage_time_limit(tr::now, lt_limit, text));
 			limitsChanged();
 		});
+
+	const auto lookups = _session->data().cacheLookupStats();
+	if (lookups.total > 0) {
+		const auto percent = (lookups.found * 100) / lookups.total;
+		container->add(
+			object_ptr<Ui::LabelSimple>(
+				container,
+				st::localStorageLimitLabel,
+				tr::lng_local_storage_hit_rate(
+					tr::now,
+					lt_percent,
+					QString::number(percent))),
+			st::localStorageLimitLabelMargin);
+	}
 }
 
 void LocalStorageBox::limitsChanged() {
@@ -1117,6 +1117,7 @@ void PeerListContent::addToSearchIndex(not_null<PeerListRow*> row) {
 	}
 
 	removeFromSearchIndex(row);
+	clearLocalFilterResults();
 	row->setNameFirstLetters(row->generateNameFirstLetters());
 	for (auto ch : row->nameFirstLetters()) {
 		_searchIndex[ch].push_back(row);
@@ -1126,6 +1127,7 @@ void PeerListContent::addToSearchIndex(not_null<PeerListRow*> row) {
 void PeerListContent::removeFromSearchIndex(not_null<PeerListRow*> row) {
 	const auto &nameFirstLetters = row->nameFirstLetters();
 	if (!nameFirstLetters.empty()) {
+		clearLocalFilterResults();
 		for (auto ch : row->nameFirstLetters()) {
 			auto it = _searchIndex.find(ch);
 			if (it != _searchIndex.cend()) {
@@ -1140,6 +1142,26 @@ void PeerListContent::removeFromSearchIndex(not_null<PeerListRow*> row) {
 	}
 }
 
+void PeerListContent::clearLocalFilterResults() {
+	_localFilterWords.clear();
+	_localFilterResults.clear();
+}
+
+bool PeerListContent::refinesLocalFilter(const QStringList &words) const {
+	if (_localFilterWords.isEmpty()) {
+		return false;
+	}
+	for (const auto &was : _localFilterWords) {
+		const auto refined = ranges::any_of(words, [&](const QString &now) {
+			return now.startsWith(was);
+		});
+		if (!refined) {
+			return false;
+		}
+	}
+	return true;
+}
+
 void PeerListContent::prependRow(std::unique_ptr<PeerListRow> row) {
 	Expects(row != nullptr);
 
@@ -1257,6 +1279,7 @@ void PeerListContent::clearAllContent() {
 	_rowsByPeer.clear();
 	_filterResults.clear();
 	_searchIndex.clear();
+	clearLocalFilterResults();
 	_rows.clear();
 	_searchRows.clear();
 	_searchQuery
@@ -2050,28 +2073,34 @@ void PeerListContent::searchQueryChanged(QString query) {
 		if (_controller->searchInLocal() && !searchWordsList.isEmpty()) {
 			Assert(_hiddenRows.empty());
 
+			// Each row that matches the new query matched the previous
+			// one as well, when every previous word is a prefix of a new.
 			auto minimalList = (const std::vector<not_null<PeerListRow*>>*)nullptr;
-			for (const auto &searchWord : searchWordsList) {
-				auto searchWordStart = searchWord[0].toLower();
-				auto it = _searchIndex.find(searchWordStart);
-				if (it == _searchIndex.cend()) {
-					// Some word can't be found in any row.
-					minimalList = nullptr;
-					break;
-				} else if (!minimalList || minimalList->size() > it->second.size()) {
-					minimalList = &it->second;
+			if (refinesLocalFilter(searchWordsList)) {
+				minimalList = &_localFilterResults;
+			} else {
+				for (const auto &searchWord : searchWordsList) {
+					auto searchWordStart = searchWord[0].toLower();
+					auto it = _searchIndex.find(searchWordStart);
+					if (it == _searchIndex.cend()) {
+						// Some word can't be found in any row.
+						minimalList = nullptr;
+						break;
+					} else if (!minimalList || minimalList->size() > it->second.size()) {
+						minimalList = &it->second;
+					}
 				}
 			}
+			auto found = std::vector<not_null<PeerListRow*>>();
 			if (minimalList) {
 				auto searchWordInNames = [](
 						not_null<PeerListRow*> row,
 						const QString &searchWord) {
-					for (auto &nameWord : row->generateNameWords()) {
-						if (nameWord.startsWith(searchWord)) {
-							return true;
-						}
-					}
-					return false;
+					// Name words are sorted, so the first word that is
+					// not less than the searched one is the only candidate.
+					const auto &nameWords = row->generateNameWords();
+					const auto i = nameWords.lower_bound(searchWord);
+					return (i != end(nameWords)) && i->startsWith(searchWord);
 				};
 				auto allSearchWordsInNames = [&](
 						not_null<PeerListRow*> row) {
@@ -2083,13 +2112,16 @@ void PeerListContent::searchQueryChanged(QString query) {
 					return true;
 				};
 
-				_filterResults.reserve(minimalList->size());
+				found.reserve(minimalList->size());
 				for (const auto &row : *minimalList) {
 					if (allSearchWordsInNames(row)) {
-						_filterResults.push_back(row);
+						found.push_back(row);
 					}
 				}
 			}
+			_filterResults = found;
+			_localFilterWords = searchWordsList;
+			_localFilterResults = std::move(found);
 		}
 		if (_controller->hasComplexSearch()) {
 			_controller->search(_searchQuery);
@@ -2302,6 +2334,15 @@ void PeerListContent::updateRow(not_null<PeerListRow*> row, RowIndex hint) {
 	updateRow(findRowIndex(row, hint));
 }
 
+bool PeerListContent::isRowVisible(not_null<PeerListRow*> row) {
+	const auto index = findRowIndex(row);
+	if (index.value < 0) {
+		return false;
+	}
+	const auto top = getRowTop(index);
+	return (top + _rowHeight > _visibleTop) && (top < _visibleBottom);
+}
+
 void PeerListContent::updateRow(RowIndex index) {
 	if (index.value < 0) {
 		return;
@@ -2373,6 +2414,20 @@ PeerListContent::RowIndex PeerListContent::findRowIndex(
 		return result;
 	}
 
+	// With only hidden rows filtered out the order is the same as in
+	// _rows, so we don't scan all of them for each updated row.
+	if (_searchQuery.isEmpty() && !row->isSearchResult()) {
+		const auto i = ranges::lower_bound(
+			_filterResults,
+			row->absoluteIndex(),
+			ranges::less(),
+			[](not_null<PeerListRow*> row) { return row->absoluteIndex(); });
+		if (i != end(_filterResults) && *i == row) {
+			result.value = int(i - begin(_filterResults));
+			return result;
+		}
+	}
+
 	auto count = shownRowsCount();
 	for (result.value = 0; result.value != count; ++result.value) {
 		if (getRow(result) == row) {
@@ -331,6 +331,7 @@ public:
 	virtual void peerListPrependRow(std::unique_ptr<PeerListRow> row) = 0;
 	virtual void peerListPrependRowFromSearchResult(not_null<PeerListRow*> row) = 0;
 	virtual void peerListUpdateRow(not_null<PeerListRow*> row) = 0;
+	virtual bool peerListIsRowVisible(not_null<PeerListRow*> row) = 0;
 	virtual void peerListRemoveRow(not_null<PeerListRow*> row) = 0;
 	virtual void peerListConvertRowToSearchResult(not_null<PeerListRow*> row) = 0;
 	virtual bool peerListIsRowChecked(not_null<PeerListRow*> row) = 0;
@@ -655,6 +656,7 @@ public:
 	void updateRow(not_null<PeerListRow*> row) {
 		updateRow(row, RowIndex());
 	}
+	[[nodiscard]] bool isRowVisible(not_null<PeerListRow*> row);
 	void removeRow(not_null<PeerListRow*> row);
 	void convertRowToSearchResult(not_null<PeerListRow*> row);
 	int fullRowsCount() const;
@@ -810,6 +812,8 @@ private:
 	void addToSearchIndex(not_null<PeerListRow*> row);
 	bool addingToSearchIndex() const;
 	void removeFromSearchIndex(not_null<PeerListRow*> row);
+	void clearLocalFilterResults();
+	[[nodiscard]] bool refinesLocalFilter(const QStringList &words) const;
 	void setSearchQuery(const QString &query, const QString &normalizedQuery);
 	bool showingSearch() const {
 		return !_hiddenRows.empty() || !_searchQuery.isEmpty();
@@ -862,6 +866,11 @@ private:
 	std::vector<not_null<PeerListRow*>> _filterResults;
 	base::flat_set<not_null<PeerListRow*>> _hiddenRows;
 
+	// Local matches of the last query, the next query that only adds
+	// letters or words is looked up among them. Reset on index changes.
+	QStringList _localFilterWords;
+	std::vector<not_null<PeerListRow*>> _localFilterResults;
+
 	int _aboveHeight = 0;
 	int _belowHeight = 0;
 	bool _hideEmpty = false;
@@ -917,6 +926,9 @@ public:
 	void peerListUpdateRow(not_null<PeerListRow*> row) override {
 		_content->updateRow(row);
 	}
+	bool peerListIsRowVisible(not_null<PeerListRow*> row) override {
+		return _content->isRowVisible(row);
+	}
 	void peerListRemoveRow(not_null<PeerListRow*> row) override {
 		_content->removeRow(row);
 	}
@@ -68,6 +68,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 namespace {
 
 constexpr auto kMaxMessageLength = 4096;
+constexpr auto kMaxParallelPrepare = 4;
 
 using Ui::SendFilesWay;
 
@@ -560,19 +561,40 @@ void SendFilesBox::enqueueNextPrepare() {
 	if (_list.filesToProcess.empty()) {
 		return;
 	}
-	auto file = std::move(_list.filesToProcess.front());
-	_list.filesToProcess.pop_front();
+	struct Batch {
+		std::vector<Ui::PreparedFile> files;
+		std::atomic<int> left = 0;
+	};
+	const auto batch = std::make_shared<Batch>();
+	while (!_list.filesToProcess.empty()
+		&& !_list.filesToProcess.front().information
+		&& int(batch->files.size()) < kMaxParallelPrepare) {
+		batch->files.push_back(std::move(_list.filesToProcess.front()));
+		_list.filesToProcess.pop_front();
+	}
+	const auto count = int(batch->files.size());
+	batch->left = count;
+
+	// Prepare a few files at once, but add them in the original order.
 	const auto weak = Ui::MakeWeak(this);
 	_preparing = true;
 	const auto sideLimit = PhotoSideLimit(); // Get on main thread.
-	crl::async([weak, sideLimit, file = std::move(file)]() mutable {
-		Storage::PrepareDetails(file, st::sendMediaPreviewSize, sideLimit);
-		crl::on_main([weak, file = std::move(file)]() mutable {
-			if (weak) {
-				weak->addPreparedAsyncFile(std::move(file));
+	for (auto i = 0; i != count; ++i) {
+		crl::async([=] {
+			Storage::PrepareDetails(
+				batch->files[i],
+				st::sendMediaPreviewSize,
+				sideLimit);
+			if (--batch->left) {
+				return;
 			}
+			crl::on_main([=] {
+				if (weak) {
+					weak->addPreparedAsyncFiles(base::take(batch->files));
+				}
+			});
 		});
-	});
+	}
 }
 
 void SendFilesBox::prepare() {
@@ -1551,12 +1573,15 @@ bool SendFilesBox::addFiles(Ui::PreparedList list) {
 	return true;
 }
 
-void SendFilesBox::addPreparedAsyncFile(Ui::PreparedFile &&file) {
-	Expects(file.information != nullptr);
-
+void SendFilesBox::addPreparedAsyncFiles(
+		std::vector<Ui::PreparedFile> &&files) {
 	_preparing = false;
 	const auto count = int(_list.files.size());
-	addFile(std::move(file));
+	for (auto &file : files) {
+		Assert(file.information != nullptr);
+
+		addFile(std::move(file));
+	}
 	enqueueNextPrepare();
 	if (_list.files.size() > count) {
 		refreshAllAfterChanges(count);
@@ -239,7 +239,7 @@ private:
 	void refreshAllAfterChanges(int fromItem, Fn<void()> perform = nullptr);
 
 	void enqueueNextPrepare();
-	void addPreparedAsyncFile(Ui::PreparedFile &&file);
+	void addPreparedAsyncFiles(std::vector<Ui::PreparedFile> &&files);
 
 	void checkCharsLimitation();
 
@@ -336,8 +336,10 @@ protected:
 
 private:
 	struct Element {
+		void ensureMediaCreated() const;
+
 		not_null<DocumentData*> document;
-		std::shared_ptr<Data::DocumentMedia> documentMedia;
+		mutable std::shared_ptr<Data::DocumentMedia> documentMedia;
 		Lottie::Animation *lottie = nullptr;
 		Media::Clip::ReaderPointer webm;
 		Ui::Text::CustomEmoji *emoji = nullptr;
@@ -942,10 +944,7 @@ void StickerSetBox::Inner::applySet(const TLStickerSet &set) {
 			}
 			_pack.push_back(document);
 			if (!document->isPremiumSticker() || premiumPossible) {
-				_elements.push_back({
-					document,
-					document->createMediaView(),
-				});
+				_elements.push_back({ document });
 			}
 		}
 		for (const auto &pack : data.vpacks().v) {
@@ -1653,7 +1652,7 @@ not_null<Lottie::MultiPlayer*> StickerSetBox::Inner::getLottiePlayer() {
 	if (!_lottiePlayer) {
 		_lottiePlayer = std::make_unique<Lottie::MultiPlayer>(
 			Lottie::Quality::Default,
-			Lottie::MakeFrameRenderer());
+			ChatHelpers::SharedLottieRenderer());
 		_lottiePlayer->updates(
 		) | rpl::start_with_next([=] {
 			updateItems();
@@ -1807,6 +1806,13 @@ void StickerSetBox::Inner::visibleTopBottomUpdated(
 	}
 }
 
+void StickerSetBox::Inner::Element::ensureMediaCreated() const {
+	if (documentMedia) {
+		return;
+	}
+	documentMedia = document->createMediaView();
+}
+
 void StickerSetBox::Inner::setupLottie(int index) {
 	auto &element = _elements[index];
 
@@ -1985,16 +1991,21 @@ void StickerSetBox::Inner::paintSticker(
 		shakeTransform(p, index, position, now);
 	}
 
+	// The media of the stickers is created when they are painted for
+	// the first time, so opening a large set doesn't wait for all of it.
 	const auto &element = _elements[index];
 	const auto document = element.document;
-	const auto &media = element.documentMedia;
 	const auto sticker = document->sticker();
-	media->checkStickerSmall();
-
 	if (sticker->setType == Data::StickersType::Emoji) {
 		const_cast<Inner*>(this)->setupEmoji(index);
-	} else if (media->loaded()) {
-		if (sticker->isLottie() && !element.lottie) {
+	} else {
+		element.ensureMediaCreated();
+	}
+	const auto &media = element.documentMedia;
+	if (media) {
+		media->checkStickerSmall();
+		if (!media->loaded()) {
+		} else if (sticker->isLottie() && !element.lottie) {
 			const_cast<Inner*>(this)->setupLottie(index);
 		} else if (sticker->isWebm() && !element.webm) {
 			const_cast<Inner*>(this)->setupWebm(index);
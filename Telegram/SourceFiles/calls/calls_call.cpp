@@ -14,6 +14,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "boxes/abstract_box.h"
 #include "calls/calls_instance.h"
 #include "calls/calls_panel.h"
+#include "calls/calls_statistics.h"
 #include "core/application.h"
 #include "core/core_settings.h"
 #include "data/data_session.h"
@@ -57,6 +58,15 @@ const auto RegisterV2 = tgcalls::Register<tgcalls::InstanceV2Impl>();
 const auto RegV2Ref = tgcalls::Register<tgcalls::InstanceV2ReferenceImpl>();
 const auto RegisterLegacy = tgcalls::Register<tgcalls::InstanceImplLegacy>();
 
+// Starting the tgcalls threads takes noticeable time, do it while the
+// call is ringing instead of right after it was accepted.
+void WarmUpMediaEngine() {
+	static auto warmedUp = false;
+	if (!std::exchange(warmedUp, true)) {
+		tgcalls::StaticThreads::getThreads();
+	}
+}
+
 [[nodiscard]] base::flat_set<int64> CollectEndpointIds(
 		const QVector<MTPPhoneConnection> &list) {
 	auto result = base::flat_set<int64>();
@@ -244,6 +254,25 @@ Call::Call(
 	}
 	setupMediaDevices();
 	setupOutgoingVideo();
+	crl::on_main(this, WarmUpMediaEngine);
+
+	if (StatisticsEnabled()) {
+		_statistics = std::make_unique<StatisticsCollector>(
+			u"call"_q,
+			[=](Fn<void(StatisticsSample)> done) {
+				auto sample = StatisticsSample{
+					.signalBars = _signalBarCount.current(),
+				};
+				if (_instance) {
+					const auto traffic = _instance->getTrafficStats();
+					sample.bytesSent = int64(traffic.bytesSentWifi
+						+ traffic.bytesSentMobile);
+					sample.bytesReceived = int64(traffic.bytesReceivedWifi
+						+ traffic.bytesReceivedMobile);
+				}
+				done(sample);
+			});
+	}
 }
 
 void Call::generateModExpFirst(bytes::const_span randomSeed) {
@@ -562,6 +591,10 @@ QString Call::getDebugLog() const {
 		: QString();
 }
 
+StatisticsCollector *Call::statistics() const {
+	return _statistics.get();
+}
+
 void Call::startWaitingTrack() {
 	_waitingTrack = Media::Audio::Current().createTrack();
 	const auto trackFileName = Core::App().settings().getSoundPath(
@@ -890,6 +923,7 @@ void Call::createAndStartController(const MTPDphoneCall &call) {
 	if (!checkCallFields(call) || _authKey.size() != kAuthKeySize) {
 		return;
 	}
+	_controllerStarted = crl::now();
 
 	const auto &protocol = call.vprotocol().c_phoneCallProtocol();
 	const auto &serverConfig = _user->session().serverConfig();
@@ -1095,6 +1129,10 @@ void Call::handleControllerStateChange(tgcalls::State state) {
 
 	case tgcalls::State::Established: {
 		DEBUG_LOG(("Call Info: State changed to Established."));
+		if (_controllerStarted) {
+			LOG(("Call Info: Established in %1 ms."
+				).arg(crl::now() - base::take(_controllerStarted)));
+		}
 		setState(State::Established);
 	} break;
 
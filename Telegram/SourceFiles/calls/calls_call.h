@@ -36,6 +36,8 @@ struct DeviceResolvedId;
 
 namespace Calls {
 
+class StatisticsCollector;
+
 struct DhConfig {
 	int32 version = 0;
 	int32 g = 0;
@@ -205,6 +207,7 @@ public:
 	bytes::vector getKeyShaForFingerprint() const;
 
 	QString getDebugLog() const;
+	[[nodiscard]] StatisticsCollector *statistics() const;
 
 	//void setAudioVolume(bool input, float level);
 	void setAudioDuckingEnabled(bool enabled);
@@ -295,6 +298,7 @@ private:
 	bool _answerAfterDhConfigReceived = false;
 	rpl::variable<int> _signalBarCount = kSignalBarStarting;
 	crl::time _startTime = 0;
+	crl::time _controllerStarted = 0;
 	base::DelayedCallTimer _finishByTimeoutTimer;
 	base::Timer _discardByTimeoutTimer;
 
@@ -317,6 +321,7 @@ private:
 	uint64 _keyFingerprint = 0;
 
 	std::unique_ptr<tgcalls::Instance> _instance;
+	std::unique_ptr<StatisticsCollector> _statistics;
 	std::shared_ptr<tgcalls::VideoCaptureInterface> _videoCapture;
 	QString _videoCaptureDeviceId;
 	bool _videoCaptureIsScreencast = false;
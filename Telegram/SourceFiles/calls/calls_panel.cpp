@@ -18,6 +18,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "calls/ui/calls_device_menu.h"
 #include "calls/calls_emoji_fingerprint.h"
 #include "calls/calls_signal_bars.h"
+#include "calls/calls_statistics.h"
 #include "calls/calls_userpic.h"
 #include "calls/calls_video_bubble.h"
 #include "calls/calls_video_incoming.h"
@@ -419,11 +420,20 @@ void Panel::reinitWithCall(Call *call) {
 		_incoming = nullptr;
 		_outgoingVideoBubble = nullptr;
 		_powerSaveBlocker = nullptr;
+		_statisticsOverlay.destroy();
 		return;
 	}
 
 	_user = _call->user();
 
+	if (const auto statistics = _call->statistics()) {
+		_statisticsOverlay = CreateStatisticsOverlay(
+			widget(),
+			statistics->textValue());
+	} else {
+		_statisticsOverlay.destroy();
+	}
+
 	auto remoteMuted = _call->remoteAudioStateValue(
 	) | rpl::map(rpl::mappers::_1 == Call::RemoteAudioState::Muted);
 	rpl::duplicate(
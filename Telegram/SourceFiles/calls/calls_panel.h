@@ -173,6 +173,7 @@ private:
 	object_ptr<Ui::PaddingWrap<Ui::FlatLabel>> _remoteAudioMute = { nullptr };
 	object_ptr<Ui::PaddingWrap<Ui::FlatLabel>> _remoteLowBattery
 		= { nullptr };
+	object_ptr<Ui::RpWidget> _statisticsOverlay = { nullptr };
 	std::unique_ptr<Userpic> _userpic;
 	std::unique_ptr<VideoBubble> _outgoingVideoBubble;
 	QPixmap _bottomShadow;
@@ -0,0 +1,238 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "calls/calls_statistics.h"
+
+#include "base/options.h"
+#include "ui/rp_widget.h"
+#include "ui/painter.h"
+#include "styles/style_basic.h"
+
+#include <QtCore/QDir>
+
+#ifdef Q_OS_WIN
+#include "base/platform/win/base_windows_h.h"
+#else // Q_OS_WIN
+#include <ctime>
+#endif // Q_OS_WIN
+
+namespace Calls {
+namespace {
+
+constexpr auto kSampleTimeout = crl::time(1000);
+
+base::options::toggle CallStatisticsOption({
+	.id = kOptionCallStatistics,
+	.name = "Show call statistics",
+	.description = "Show traffic, video frame rate and CPU load over "
+		"the call window and write them each second to a CSV file "
+		"in the DebugLogs folder.",
+});
+
+// Time the process spent on all the CPU cores.
+[[nodiscard]] crl::time ProcessCpuTime() {
+#ifdef Q_OS_WIN
+	auto creation = FILETIME();
+	auto exit = FILETIME();
+	auto kernel = FILETIME();
+	auto user = FILETIME();
+	if (!GetProcessTimes(
+			GetCurrentProcess(),
+			&creation,
+			&exit,
+			&kernel,
+			&user)) {
+		return 0;
+	}
+	const auto value = [](const FILETIME &time) {
+		return (uint64(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+	};
+	// FILETIME is in 100 nanoseconds.
+	return crl::time((value(kernel) + value(user)) / 10000);
+#else // Q_OS_WIN
+	return crl::time(std::clock() * 1000. / CLOCKS_PER_SEC);
+#endif // Q_OS_WIN
+}
+
+[[nodiscard]] QString CsvPath(const QString &name) {
+	return cWorkingDir() + u"DebugLogs/last_%1_statistics.csv"_q.arg(name);
+}
+
+class Overlay final : public Ui::RpWidget {
+public:
+	Overlay(not_null<Ui::RpWidget*> parent, rpl::producer<QString> text);
+
+private:
+	void paintEvent(QPaintEvent *e) override;
+
+	void updateGeometry();
+
+	const not_null<Ui::RpWidget*> _parent;
+	QStringList _lines;
+
+};
+
+Overlay::Overlay(
+	not_null<Ui::RpWidget*> parent,
+	rpl::producer<QString> text)
+: RpWidget(parent)
+, _parent(parent) {
+	setAttribute(Qt::WA_TransparentForMouseEvents);
+
+	std::move(text) | rpl::start_with_next([=](const QString &text) {
+		_lines = text.split('\n', Qt::SkipEmptyParts);
+		updateGeometry();
+		raise();
+		update();
+	}, lifetime());
+
+	_parent->sizeValue() | rpl::start_with_next([=] {
+		updateGeometry();
+	}, lifetime());
+}
+
+void Overlay::updateGeometry() {
+	const auto &font = st::normalFont;
+	const auto padding = font->height / 2;
+	auto width = 0;
+	for (const auto &line : _lines) {
+		width = std::max(width, font->width(line));
+	}
+	setGeometry(
+		padding,
+		padding,
+		width + 2 * padding,
+		int(_lines.size()) * font->height + 2 * padding);
+	setVisible(!_lines.isEmpty());
+}
+
+void Overlay::paintEvent(QPaintEvent *e) {
+	auto p = QPainter(this);
+	p.fillRect(rect(), QColor(0, 0, 0, 160));
+
+	const auto &font = st::normalFont;
+	const auto padding = font->height / 2;
+	p.setFont(font);
+	p.setPen(QColor(255, 255, 255));
+	auto top = padding;
+	for (const auto &line : _lines) {
+		p.drawText(padding, top + font->ascent, line);
+		top += font->height;
+	}
+}
+
+} // namespace
+
+const char kOptionCallStatistics[] = "call-statistics";
+
+bool StatisticsEnabled() {
+	return CallStatisticsOption.value();
+}
+
+StatisticsCollector::StatisticsCollector(
+	const QString &name,
+	Request request)
+: _request(std::move(request))
+, _timer([=] { sample(); })
+, _csv(CsvPath(name))
+, _started(crl::now())
+, _previousTime(_started)
+, _previousCpuTime(ProcessCpuTime()) {
+	_timer.callEach(kSampleTimeout);
+}
+
+rpl::producer<QString> StatisticsCollector::textValue() const {
+	return _text.value();
+}
+
+void StatisticsCollector::sample() {
+	if (_requesting) {
+		return;
+	}
+	_requesting = true;
+	_request(crl::guard(this, [=](StatisticsSample sample) {
+		_requesting = false;
+		apply(sample);
+	}));
+}
+
+void StatisticsCollector::apply(const StatisticsSample &sample) {
+	const auto now = crl::now();
+	const auto cpuTime = ProcessCpuTime();
+	const auto elapsed = std::max(now - _previousTime, crl::time(1));
+	const auto perSecond = [&](int64 value, int64 previous) {
+		return (value >= 0 && previous >= 0)
+			? ((value - previous) * 1000 / elapsed)
+			: int64(-1);
+	};
+	const auto sent = perSecond(sample.bytesSent, _previous.bytesSent);
+	const auto received = perSecond(
+		sample.bytesReceived,
+		_previous.bytesReceived);
+	const auto fps = perSecond(sample.videoFrames, _previous.videoFrames);
+	const auto cpu = (cpuTime - _previousCpuTime) * 100 / elapsed;
+	_previous = sample;
+	_previousTime = now;
+	_previousCpuTime = cpuTime;
+
+	auto text = QStringList();
+	if (sent >= 0 && received >= 0) {
+		text.push_back(u"Sent: %1 KB/s, received: %2 KB/s"_q
+			.arg(sent / 1024)
+			.arg(received / 1024));
+	}
+	if (sample.videoTracks >= 0) {
+		text.push_back((fps >= 0)
+			? u"Video: %1 tracks, %2 fps"_q.arg(sample.videoTracks).arg(fps)
+			: u"Video: %1 tracks"_q.arg(sample.videoTracks));
+	}
+	if (sample.signalBars >= 0) {
+		text.push_back(u"Signal: %1 bars"_q.arg(sample.signalBars));
+	}
+	text.push_back(u"CPU: %1%"_q.arg(cpu));
+	_text = text.join('\n');
+
+	writeLine(QByteArray::number(now - _started)
+		+ ',' + QByteArray::number(sent)
+		+ ',' + QByteArray::number(received)
+		+ ',' + QByteArray::number(sample.videoTracks)
+		+ ',' + QByteArray::number(fps)
+		+ ',' + QByteArray::number(sample.signalBars)
+		+ ',' + QByteArray::number(cpu)
+		+ '\n');
+}
+
+void StatisticsCollector::writeLine(const QByteArray &line) {
+	if (_csvFailed) {
+		return;
+	} else if (!_csv.isOpen()) {
+		QDir().mkpath(QFileInfo(_csv).absolutePath());
+		const auto header = QByteArray("time_ms,sent_bytes_per_second,"
+			"received_bytes_per_second,video_tracks,video_fps,"
+			"signal_bars,cpu_percent\n");
+		if (!_csv.open(QIODevice::WriteOnly | QIODevice::Truncate)
+			|| _csv.write(header) != header.size()) {
+			LOG(("Call Error: Could not write statistics to '%1'."
+				).arg(_csv.fileName()));
+			_csvFailed = true;
+			_csv.close();
+			return;
+		}
+	}
+	if (_csv.write(line) != line.size() || !_csv.flush()) {
+		_csvFailed = true;
+		_csv.close();
+	}
+}
+
+object_ptr<Ui::RpWidget> CreateStatisticsOverlay(
+		not_null<Ui::RpWidget*> parent,
+		rpl::producer<QString> text) {
+	return object_ptr<Overlay>(parent, std::move(text));
+}
+
+} // namespace Calls
@@ -0,0 +1,68 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include "base/object_ptr.h"
+#include "base/timer.h"
+#include "base/weak_ptr.h"
+
+#include <QtCore/QFile>
+
+namespace Ui {
+class RpWidget;
+} // namespace Ui
+
+namespace Calls {
+
+extern const char kOptionCallStatistics[];
+
+// Counters are totals since the call start, unknown values are negative.
+struct StatisticsSample {
+	int64 bytesSent = -1;
+	int64 bytesReceived = -1;
+	int64 videoFrames = -1;
+	int videoTracks = -1;
+	int signalBars = -1;
+};
+
+// Enabled by the "call-statistics" experimental option.
+[[nodiscard]] bool StatisticsEnabled();
+
+// Samples the call each second, keeps the text for the overlay and
+// appends each sample to a CSV file in the DebugLogs folder.
+class StatisticsCollector final : public base::has_weak_ptr {
+public:
+	using Request = Fn<void(Fn<void(StatisticsSample)> done)>;
+
+	StatisticsCollector(const QString &name, Request request);
+
+	[[nodiscard]] rpl::producer<QString> textValue() const;
+
+private:
+	void sample();
+	void apply(const StatisticsSample &sample);
+	void writeLine(const QByteArray &line);
+
+	const Request _request;
+	base::Timer _timer;
+	QFile _csv;
+	StatisticsSample _previous;
+	crl::time _started = 0;
+	crl::time _previousTime = 0;
+	crl::time _previousCpuTime = 0;
+	rpl::variable<QString> _text;
+	bool _requesting = false;
+	bool _csvFailed = false;
+
+};
+
+[[nodiscard]] object_ptr<Ui::RpWidget> CreateStatisticsOverlay(
+	not_null<Ui::RpWidget*> parent,
+	rpl::producer<QString> text);
+
+} // namespace Calls
@@ -560,14 +560,19 @@ void TopBar::initBlobsUnder(
 	}, _blobs->lifetime());
 
 	group->levelUpdates(
-	) | rpl::filter([=](const LevelUpdate &update) {
-		return !state->hideLastTime && (update.value > state->lastLevel);
-	}) | rpl::start_with_next([=](const LevelUpdate &update) {
+	) | rpl::filter([=] {
+		return !state->hideLastTime;
+	}) | rpl::map([=](const LevelUpdates &updates) {
+		return ranges::max(
+			updates | ranges::views::transform(&LevelUpdate::value));
+	}) | rpl::filter([=](float level) {
+		return (level > state->lastLevel);
+	}) | rpl::start_with_next([=](float level) {
 		if (state->lastLevel == 0.) {
 			state->levelTimer.callEach(kBlobUpdateInterval);
 		}
-		state->lastLevel = update.value;
-		state->paint.setLevel(update.value);
+		state->lastLevel = level;
+		state->paint.setLevel(level);
 	}, _blobs->lifetime());
 
 	_blobs->setAttribute(Qt::WA_TransparentForMouseEvents);
@@ -8,6 +8,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "calls/group/calls_group_call.h"
 
 #include "calls/group/calls_group_common.h"
+#include "calls/group/calls_group_video_quality.h"
+#include "calls/calls_statistics.h"
 #include "main/main_session.h"
 #include "api/api_send_progress.h"
 #include "api/api_updates.h"
@@ -46,12 +48,14 @@ namespace {
 constexpr auto kMaxInvitePerSlice = 10;
 constexpr auto kCheckLastSpokeInterval = crl::time(1000);
 constexpr auto kCheckJoinedTimeout = 4 * crl::time(1000);
+constexpr auto kLevelUpdatesTimeout = crl::time(1000) / 30;
+constexpr auto kStreamHealthLogTimeout = 30 * crl::time(1000);
 constexpr auto kUpdateSendActionEach = crl::time(500);
 constexpr auto kPlayConnectingEach = crl::time(1056) + 2 * crl::time(1000);
 constexpr auto kFixManualLargeVideoDuration = 5 * crl::time(1000);
 constexpr auto kFixSpeakingLargeVideoDuration = 3 * crl::time(1000);
-constexpr auto kFullAsMediumsCount = 4; // 1 Full is like 4 Mediums.
-constexpr auto kMaxMediumQualities = 16; // 4 Fulls or 16 Mediums.
+constexpr auto kFullAsMediumsCount
+	= Group::VideoQualityPlanner::kFullAsMediumsCount;
 
 [[nodiscard]] const Data::GroupCallParticipant *LookupParticipant(
 		not_null<PeerData*> peer,
@@ -583,6 +587,7 @@ GroupCall::GroupCall(
 , _scheduleDate(info.scheduleDate)
 , _lastSpokeCheckTimer([=] { checkLastSpoke(); })
 , _checkJoinedTimer([=] { checkJoined(); })
+, _levelUpdatesTimer([=] { sendLevelUpdates(); })
 , _playbackDeviceId(
 	&Core::App().mediaDevices(),
 	Webrtc::DeviceType::Playback,
@@ -656,6 +661,23 @@ GroupCall::GroupCall(
 	setupMediaDevices();
 	setupOutgoingVideo();
 
+	_videoQualityPlanner = std::make_unique<Group::VideoQualityPlanner>();
+	_videoQualityPlanner->budgetChanges(
+	) | rpl::start_with_next([=] {
+		updateRequestedVideoChannelsDelayed();
+	}, _lifetime);
+
+	if (StatisticsEnabled()) {
+		_statistics = std::make_unique<StatisticsCollector>(
+			u"group_call"_q,
+			[=](Fn<void(StatisticsSample)> done) {
+				done({
+					.videoFrames = _videoFramesShown,
+					.videoTracks = int(_activeVideoTracks.size()),
+				});
+			});
+	}
+
 	if (_id) {
 		join(inputCall);
 	} else {
@@ -666,6 +688,10 @@ GroupCall::GroupCall(
 	}
 }
 
+StatisticsCollector *GroupCall::statistics() const {
+	return _statistics.get();
+}
+
 GroupCall::~GroupCall() {
 	destroyScreencast();
 	destroyController();
@@ -1224,9 +1250,13 @@ void GroupCall::markEndpointActive(
 			const auto size = track->frameSize();
 			if (size.isEmpty()) {
 				track->markFrameShown();
-			} else if (!activeTrack->shown) {
-				activeTrack->shown = true;
-				markTrackShown(endpoint, true);
+			} else {
+				_videoQualityPlanner->frameReceived(endpoint.id);
+				++_videoFramesShown;
+				if (!activeTrack->shown) {
+					activeTrack->shown = true;
+					markTrackShown(endpoint, true);
+				}
 			}
 			activeTrack->trackSize = size;
 		}, i->second->lifetime);
@@ -1253,6 +1283,7 @@ void GroupCall::markEndpointActive(
 		}
 		markTrackShown(endpoint, false);
 		markTrackPaused(endpoint, false);
+		_videoQualityPlanner->trackRemoved(endpoint.id);
 		_activeVideoTracks.erase(i);
 	}
 	updateRequestedVideoChannelsDelayed();
@@ -1805,7 +1836,7 @@ void GroupCall::setMuted(MuteState mute) {
 			toggleScreenSharing(std::nullopt);
 		}
 		if (wasSpeaking && !nowSpeaking && _joinState.ssrc) {
-			_levelUpdates.fire(LevelUpdate{
+			addLevelUpdate(LevelUpdate{
 				.ssrc = _joinState.ssrc,
 				.value = 0.f,
 				.voice = false,
@@ -2556,7 +2587,9 @@ void GroupCall::broadcastPartStart(std::shared_ptr<LoadPartTask> task) {
 	const auto scale = raw->scale();
 	const auto videoChannel = raw->videoChannel();
 	const auto videoQuality = raw->videoQuality();
+	const auto sent = crl::now();
 	const auto finish = [=](tgcalls::BroadcastPart &&part) {
+		countBroadcastPart(part, crl::now() - sent);
 		raw->done(std::move(part));
 		_broadcastParts.erase(raw);
 	};
@@ -2626,6 +2659,37 @@ void GroupCall::broadcastPartStart(std::shared_ptr<LoadPartTask> task) {
 	_broadcastParts.emplace(raw, LoadingPart{ std::move(task), requestId });
 }
 
+void GroupCall::countBroadcastPart(
+		const tgcalls::BroadcastPart &part,
+		crl::time loadDuration) {
+	using Status = tgcalls::BroadcastPart::Status;
+
+	// The latency is how far the part is behind the live edge
+	// at the time the server sent it to us.
+	auto &health = _streamHealth;
+	++health.parts;
+	health.loadDuration += loadDuration;
+	if (part.status == Status::NotReady) {
+		++health.notReadyParts;
+	} else if (part.status == Status::Success) {
+		const auto latency = crl::time(part.responseTimestamp * 1000.)
+			- crl::time(part.timestampMilliseconds);
+		health.maxLatency = std::max(health.maxLatency, latency);
+	}
+	const auto now = crl::now();
+	if (!health.started) {
+		health.started = now;
+	} else if (now - health.started >= kStreamHealthLogTimeout) {
+		LOG(("Call Info: Stream health - %1 parts, %2 not ready, "
+			"%3 ms average load, %4 ms max latency."
+			).arg(health.parts
+			).arg(health.notReadyParts
+			).arg(health.loadDuration / health.parts
+			).arg(health.maxLatency));
+		health = StreamHealth{ .started = now };
+	}
+}
+
 void GroupCall::broadcastPartCancel(not_null<LoadPartTask*> task) {
 	const auto i = _broadcastParts.find(task);
 	if (i != end(_broadcastParts)) {
@@ -2817,17 +2881,19 @@ void GroupCall::updateRequestedVideoChannels() {
 		});
 	}
 
-	// We limit `count(Full) * kFullAsMediumsCount + count(medium)`.
+	// We limit `count(Full) * kFullAsMediumsCount + count(medium)`
+	// by the budget, lowered while the video doesn't keep up.
 	//
 	// Try to preserve all qualities; If not
 	// Try to preserve all screencasts as Full and cameras as Medium; If not
 	// Try to preserve all screencasts as Full; If not
-	// Try to preserve all cameras as Medium;
+	// Try to preserve as many cameras as Medium as we can;
+	const auto budget = _videoQualityPlanner->mediumsBudget();
 	const auto mediumsCount = mediums
 		+ (fullcameras + fullscreencasts) * kFullAsMediumsCount;
-	const auto downgradeSome = (mediumsCount > kMaxMediumQualities);
+	const auto downgradeSome = (mediumsCount > budget);
 	const auto downgradeAll = (fullscreencasts * kFullAsMediumsCount)
-		> kMaxMediumQualities;
+		> budget;
 	if (downgradeSome) {
 		for (auto &channel : channels) {
 			if (channel.maxQuality == Quality::Full) {
@@ -2848,13 +2914,27 @@ void GroupCall::updateRequestedVideoChannels() {
 			fullscreencasts = 0;
 		}
 	}
-	if (mediums > kMaxMediumQualities) {
+	if (mediums > budget) {
+		auto left = budget;
 		for (auto &channel : channels) {
-			if (channel.maxQuality == Quality::Medium) {
+			if (channel.maxQuality != Quality::Medium) {
+				continue;
+			} else if (left > 0) {
+				--left;
+			} else {
 				channel.maxQuality = Quality::Thumbnail;
 			}
 		}
 	}
+	for (const auto &channel : channels) {
+		_videoQualityPlanner->setRequestedQuality(
+			channel.endpointId,
+			((channel.maxQuality == Quality::Full)
+				? Group::VideoQuality::Full
+				: (channel.maxQuality == Quality::Medium)
+				? Group::VideoQuality::Medium
+				: Group::VideoQuality::Thumbnail));
+	}
 	_instance->setRequestedVideoChannels(std::move(channels));
 }
 
@@ -3018,7 +3098,7 @@ void GroupCall::audioLevelsUpdated(const tgcalls::GroupLevelsUpdate &data) {
 		const auto voice = value.voice;
 		const auto me = (ssrc == _joinState.ssrc);
 		const auto ignore = me && meMuted();
-		_levelUpdates.fire(LevelUpdate{
+		addLevelUpdate(LevelUpdate{
 			.ssrc = ssrc,
 			.value = ignore ? 0.f : level,
 			.voice = (!ignore && voice),
@@ -3064,6 +3144,26 @@ void GroupCall::audioLevelsUpdated(const tgcalls::GroupLevelsUpdate &data) {
 	}
 }
 
+void GroupCall::addLevelUpdate(LevelUpdate update) {
+	// With many speakers levels come too often to repaint on each one.
+	_pendingLevelUpdates[update.ssrc] = update;
+	if (!_levelUpdatesTimer.isActive()) {
+		_levelUpdatesTimer.callOnce(kLevelUpdatesTimeout);
+	}
+}
+
+void GroupCall::sendLevelUpdates() {
+	if (_pendingLevelUpdates.empty()) {
+		return;
+	}
+	auto updates = LevelUpdates();
+	updates.reserve(_pendingLevelUpdates.size());
+	for (const auto &[ssrc, update] : base::take(_pendingLevelUpdates)) {
+		updates.push_back(update);
+	}
+	_levelUpdates.fire(std::move(updates));
+}
+
 void GroupCall::checkLastSpoke() {
 	const auto real = lookupReal();
 	if (!real) {
@@ -21,6 +21,7 @@ namespace tgcalls {
 class GroupInstanceCustomImpl;
 struct GroupLevelsUpdate;
 struct GroupNetworkState;
+struct BroadcastPart;
 struct GroupParticipantDescription;
 class VideoCaptureInterface;
 } // namespace tgcalls
@@ -53,8 +54,11 @@ struct RejoinEvent;
 struct RtmpInfo;
 enum class VideoQuality;
 enum class Error;
+class VideoQualityPlanner;
 } // namespace Group
 
+class StatisticsCollector;
+
 enum class MuteState {
 	Active,
 	PushToTalk,
@@ -80,6 +84,9 @@ struct LevelUpdate {
 	bool me = false;
 };
 
+// The latest level of each ssrc that changed since the previous batch.
+using LevelUpdates = std::vector<LevelUpdate>;
+
 enum class VideoEndpointType {
 	Camera,
 	Screen,
@@ -325,7 +332,7 @@ public:
 		return _instanceState.value();
 	}
 
-	[[nodiscard]] rpl::producer<LevelUpdate> levelUpdates() const {
+	[[nodiscard]] rpl::producer<LevelUpdates> levelUpdates() const {
 		return _levelUpdates.events();
 	}
 	[[nodiscard]] auto videoStreamActiveUpdates() const
@@ -356,6 +363,7 @@ public:
 	-> rpl::producer<VideoEndpoint> {
 		return _videoEndpointLarge.value();
 	}
+	[[nodiscard]] StatisticsCollector *statistics() const;
 	[[nodiscard]] auto activeVideoTracks() const
 	-> const base::flat_map<VideoEndpoint, std::unique_ptr<VideoTrack>> & {
 		return _activeVideoTracks;
@@ -431,6 +439,13 @@ private:
 		std::shared_ptr<LoadPartTask> task;
 		mtpRequestId requestId = 0;
 	};
+	struct StreamHealth {
+		crl::time started = 0;
+		crl::time loadDuration = 0;
+		crl::time maxLatency = 0;
+		int parts = 0;
+		int notReadyParts = 0;
+	};
 
 	enum class FinishType {
 		None,
@@ -471,6 +486,9 @@ private:
 
 	void broadcastPartStart(std::shared_ptr<LoadPartTask> task);
 	void broadcastPartCancel(not_null<LoadPartTask*> task);
+	void countBroadcastPart(
+		const tgcalls::BroadcastPart &part,
+		crl::time loadDuration);
 	void mediaChannelDescriptionsStart(
 		std::shared_ptr<MediaChannelDescriptionsTask> task);
 	void mediaChannelDescriptionsCancel(
@@ -525,6 +543,8 @@ private:
 	void setScreenInstanceConnected(tgcalls::GroupNetworkState networkState);
 	void setScreenInstanceMode(InstanceMode mode);
 	void checkLastSpoke();
+	void addLevelUpdate(LevelUpdate update);
+	void sendLevelUpdates();
 	void pushToTalkCancel();
 
 	void checkGlobalShortcutAvailability();
@@ -588,6 +608,7 @@ private:
 
 	MTP::DcId _broadcastDcId = 0;
 	base::flat_map<not_null<LoadPartTask*>, LoadingPart> _broadcastParts;
+	StreamHealth _streamHealth;
 	base::flat_set<
 		std::shared_ptr<MediaChannelDescriptionsTask>,
 		base::pointer_comparator<
@@ -653,13 +674,18 @@ private:
 	base::flags<SendUpdateType> _pendingSelfUpdates;
 	bool _requireARGB32 = true;
 
-	rpl::event_stream<LevelUpdate> _levelUpdates;
+	rpl::event_stream<LevelUpdates> _levelUpdates;
+	base::flat_map<uint32, LevelUpdate> _pendingLevelUpdates;
+	base::Timer _levelUpdatesTimer;
 	rpl::event_stream<VideoStateToggle> _videoStreamActiveUpdates;
 	rpl::event_stream<VideoStateToggle> _videoStreamPausedUpdates;
 	rpl::event_stream<VideoStateToggle> _videoStreamShownUpdates;
 	base::flat_map<
 		VideoEndpoint,
 		std::unique_ptr<VideoTrack>> _activeVideoTracks;
+	std::unique_ptr<Group::VideoQualityPlanner> _videoQualityPlanner;
+	std::unique_ptr<StatisticsCollector> _statistics;
+	int64 _videoFramesShown = 0;
 	base::flat_set<VideoEndpoint> _shownVideoTracks;
 	rpl::variable<VideoEndpoint> _videoEndpointLarge;
 	rpl::variable<bool> _videoEndpointPinned = false;
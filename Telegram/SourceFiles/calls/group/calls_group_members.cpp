@@ -142,6 +142,7 @@ private:
 		bool nowSounding,
 		uint32 nowSsrc);
 	void removeRow(not_null<Row*> row);
+	void refreshRowsDelayed();
 	void removeRowFromSoundingMap(not_null<Row*> row);
 	void updateRowLevel(not_null<Row*> row, float level);
 	void checkRowPosition(not_null<Row*> row);
@@ -194,6 +195,7 @@ private:
 
 	crl::time _soundingAnimationHideLastTime = 0;
 	bool _skipRowLevelUpdate = false;
+	bool _refreshRowsScheduled = false;
 
 	PanelMode _mode = PanelMode::Default;
 	Ui::CrossLineAnimation _inactiveCrossLine;
@@ -262,9 +264,12 @@ Members::Controller::Controller(
 			_soundingAnimation.stop();
 			return false;
 		}
+		// In large voice chats most of the sounding rows are scrolled away.
 		for (const auto &[ssrc, row] : _soundingRowBySsrc) {
-			row->updateBlobAnimation(now);
-			delegate()->peerListUpdateRow(row);
+			if (delegate()->peerListIsRowVisible(row)) {
+				row->updateBlobAnimation(now);
+				delegate()->peerListUpdateRow(row);
+			}
 		}
 		return true;
 	});
@@ -289,10 +294,12 @@ void Members::Controller::setupListChangeViewers() {
 	}, _lifetime);
 
 	_call->levelUpdates(
-	) | rpl::start_with_next([=](const LevelUpdate &update) {
-		const auto i = _soundingRowBySsrc.find(update.ssrc);
-		if (i != end(_soundingRowBySsrc)) {
-			updateRowLevel(i->second, update.value);
+	) | rpl::start_with_next([=](const LevelUpdates &updates) {
+		for (const auto &update : updates) {
+			const auto i = _soundingRowBySsrc.find(update.ssrc);
+			if (i != end(_soundingRowBySsrc)) {
+				updateRowLevel(i->second, update.value);
+			}
 		}
 	}, _lifetime);
 
@@ -416,7 +423,7 @@ void Members::Controller::subscribeToChanges(not_null<Data::GroupCall*> real) {
 					updateRow(row, update.was, nullptr);
 				} else {
 					removeRow(row);
-					delegate()->peerListRefreshRows();
+					refreshRowsDelayed();
 				}
 			}
 		} else {
@@ -531,7 +538,7 @@ void Members::Controller::updateRow(
 			}
 			delegate()->peerListAppendRow(std::move(row));
 		}
-		delegate()->peerListRefreshRows();
+		refreshRowsDelayed();
 	}
 	static constexpr auto kInvited = Row::State::Invited;
 	const auto reorder = [&] {
@@ -765,6 +772,19 @@ void Members::Controller::removeRow(not_null<Row*> row) {
 	delegate()->peerListRemoveRow(row);
 }
 
+void Members::Controller::refreshRowsDelayed() {
+	// Participants come in slices, refresh the list once for a slice.
+	if (_refreshRowsScheduled) {
+		return;
+	}
+	_refreshRowsScheduled = true;
+	crl::on_main(this, [=] {
+		if (base::take(_refreshRowsScheduled)) {
+			delegate()->peerListRefreshRows();
+		}
+	});
+}
+
 void Members::Controller::removeRowFromSoundingMap(not_null<Row*> row) {
 	// There may be 0, 1 or 2 entries for a row.
 	for (auto i = begin(_soundingRowBySsrc); i != end(_soundingRowBySsrc);) {
@@ -16,6 +16,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "calls/group/calls_group_invite_controller.h"
 #include "calls/group/ui/calls_group_scheduled_labels.h"
 #include "calls/group/ui/desktop_capture_choose_source.h"
+#include "calls/calls_statistics.h"
 #include "ui/platform/ui_platform_window_title.h"
 #include "ui/platform/ui_platform_utility.h"
 #include "ui/controls/call_mute_button.h"
@@ -568,12 +569,19 @@ void Panel::initControls() {
 	}, _callLifetime);
 
 	_call->levelUpdates(
-	) | rpl::filter([=](const LevelUpdate &update) {
-		return update.me;
-	}) | rpl::start_with_next([=](const LevelUpdate &update) {
-		_mute->setLevel(update.value);
+	) | rpl::start_with_next([=](const LevelUpdates &updates) {
+		const auto i = ranges::find(updates, true, &LevelUpdate::me);
+		if (i != end(updates)) {
+			_mute->setLevel(i->value);
+		}
 	}, _callLifetime);
 
+	if (const auto statistics = _call->statistics()) {
+		_statisticsOverlay = CreateStatisticsOverlay(
+			widget(),
+			statistics->textValue());
+	}
+
 	_call->real(
 	) | rpl::start_with_next([=](not_null<Data::GroupCall*> real) {
 		setupRealMuteButtonState(real);
@@ -241,6 +241,7 @@ private:
 	rpl::lifetime _callLifetime;
 
 	object_ptr<Ui::RpWidget> _titleBackground = { nullptr };
+	object_ptr<Ui::RpWidget> _statisticsOverlay = { nullptr };
 	object_ptr<Ui::FlatLabel> _title = { nullptr };
 	object_ptr<Ui::FlatLabel> _titleSeparator = { nullptr };
 	object_ptr<Ui::FlatLabel> _viewers = { nullptr };
@@ -0,0 +1,112 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "calls/group/calls_group_video_quality.h"
+
+#include "calls/group/calls_group_common.h"
+
+namespace Calls::Group {
+namespace {
+
+constexpr auto kCheckTimeout = 2 * crl::time(1000);
+constexpr auto kMinMediumQualities = 2;
+
+// Mostly static screencasts send few frames, they say nothing.
+constexpr auto kMinPeakFps = 10.;
+
+// The peak lowers slowly, so a stream that became slower by itself
+// doesn't look like we are behind forever.
+constexpr auto kPeakFpsDecay = 0.97;
+
+constexpr auto kBehindRatio = 0.6;
+constexpr auto kHealthyRatio = 0.85;
+constexpr auto kHealthyChecksToGrow = 5;
+
+} // namespace
+
+VideoQualityPlanner::VideoQualityPlanner()
+: _timer([=] { check(); }) {
+}
+
+void VideoQualityPlanner::frameReceived(const std::string &endpointId) {
+	++_tracks[endpointId].frames;
+	if (!_timer.isActive()) {
+		_lastCheck = crl::now();
+		_timer.callEach(kCheckTimeout);
+	}
+}
+
+void VideoQualityPlanner::setRequestedQuality(
+		const std::string &endpointId,
+		VideoQuality quality) {
+	auto &track = _tracks[endpointId];
+	if (track.quality != quality) {
+		// Different layers may have different frame rates.
+		track.quality = quality;
+		track.peakFps = 0.;
+	}
+}
+
+void VideoQualityPlanner::trackRemoved(const std::string &endpointId) {
+	_tracks.remove(endpointId);
+	if (_tracks.empty()) {
+		_timer.cancel();
+	}
+}
+
+int VideoQualityPlanner::mediumsBudget() const {
+	return _budget;
+}
+
+rpl::producer<> VideoQualityPlanner::budgetChanges() const {
+	return _budgetChanges.events();
+}
+
+void VideoQualityPlanner::check() {
+	const auto now = crl::now();
+	const auto seconds = (now - base::take(_lastCheck, now)) / 1000.;
+	if (seconds <= 0.) {
+		return;
+	}
+	auto received = 0.;
+	auto expected = 0.;
+	for (auto &[endpointId, track] : _tracks) {
+		const auto fps = base::take(track.frames) / seconds;
+		if (track.quality == VideoQuality::Thumbnail) {
+			continue;
+		} else if (track.peakFps >= kMinPeakFps) {
+			received += std::min(fps, track.peakFps);
+			expected += track.peakFps;
+		}
+		track.peakFps = std::max(fps, track.peakFps * kPeakFpsDecay);
+	}
+	if (expected <= 0.) {
+		return;
+	}
+	const auto ratio = received / expected;
+	if (ratio < kBehindRatio) {
+		_healthyChecks = 0;
+		setBudget(std::max(_budget * 3 / 4, kMinMediumQualities));
+	} else if (ratio >= kHealthyRatio
+		&& ++_healthyChecks >= kHealthyChecksToGrow) {
+		_healthyChecks = 0;
+		setBudget(std::min(_budget + 1, kMaxMediumQualities));
+	}
+}
+
+void VideoQualityPlanner::setBudget(int budget) {
+	if (_budget == budget) {
+		return;
+	}
+	LOG(("Call Info: Video qualities budget %1 -> %2 mediums."
+		).arg(_budget
+		).arg(budget));
+	_budget = budget;
+	_budgetChanges.fire({});
+}
+
+} // namespace Calls::Group
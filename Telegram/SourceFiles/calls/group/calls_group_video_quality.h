@@ -0,0 +1,57 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include "base/timer.h"
+
+namespace Calls::Group {
+
+enum class VideoQuality;
+
+// Budget of the requested video qualities, counted in Medium ones.
+//
+// Tiles ask for qualities by their size in the Viewport. If the video
+// frames start coming noticeably slower than they did at the same
+// quality, the budget is lowered, so the heaviest streams are
+// downgraded step by step. It slowly grows back while frames keep up.
+class VideoQualityPlanner final {
+public:
+	static constexpr auto kFullAsMediumsCount = 4; // 1 Full is 4 Mediums.
+	static constexpr auto kMaxMediumQualities = 16; // 4 Fulls or 16 Mediums.
+
+	VideoQualityPlanner();
+
+	void frameReceived(const std::string &endpointId);
+	void setRequestedQuality(
+		const std::string &endpointId,
+		VideoQuality quality);
+	void trackRemoved(const std::string &endpointId);
+
+	[[nodiscard]] int mediumsBudget() const;
+	[[nodiscard]] rpl::producer<> budgetChanges() const;
+
+private:
+	struct Track {
+		VideoQuality quality = VideoQuality();
+		int frames = 0;
+		float64 peakFps = 0.;
+	};
+
+	void check();
+	void setBudget(int budget);
+
+	base::flat_map<std::string, Track> _tracks;
+	base::Timer _timer;
+	crl::time _lastCheck = 0;
+	int _budget = kMaxMediumQualities;
+	int _healthyChecks = 0;
+	rpl::event_stream<> _budgetChanges;
+
+};
+
+} // namespace Calls::Group
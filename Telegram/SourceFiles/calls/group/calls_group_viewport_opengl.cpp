@@ -32,6 +32,10 @@ constexpr auto kNoiseTextureSize = 256;
 // The more the scale - more blurred the image.
 constexpr auto kBlurTextureSizeFactor = 4.;
 constexpr auto kBlurOpacity = 0.65;
+
+// The blurred background is hardly distinguishable between frames,
+// so the two blur passes are reused for several frames in a row.
+constexpr auto kBlurUpdateTimeout = crl::time(100);
 constexpr auto kDitherNoiseAmount = 0.002;
 
 constexpr auto kQuads = 9;
@@ -320,6 +324,16 @@ void Viewport::RendererGL::init(
 	_frameBuffer->create();
 	_frameBuffer->bind();
 	_frameBuffer->allocate(kValues * sizeof(GLfloat));
+
+	// Pixel unpack buffers are not available in OpenGL ES 2.0.
+	const auto context = widget->context();
+	if (!context->isOpenGLES() || context->format().majorVersion() >= 3) {
+		_unpackBuffer.emplace(QOpenGLBuffer::PixelUnpackBuffer);
+		_unpackBuffer->setUsagePattern(QOpenGLBuffer::StreamDraw);
+		if (!_unpackBuffer->create()) {
+			_unpackBuffer = std::nullopt;
+		}
+	}
 	_downscaleProgram.yuv420.emplace();
 	_downscaleVertexShader = LinkProgram(
 		&*_downscaleProgram.yuv420,
@@ -393,6 +407,7 @@ void Viewport::RendererGL::deinit(
 		not_null<QOpenGLWidget*> widget,
 		QOpenGLFunctions *f) {
 	_frameBuffer = std::nullopt;
+	_unpackBuffer = std::nullopt;
 	_frameVertexShader = nullptr;
 	_imageProgram = std::nullopt;
 	_downscaleProgram.argb32 = std::nullopt;
@@ -766,13 +781,28 @@ void Viewport::RendererGL::paintTile(
 		unscaled,
 		geometry.size(),
 		_factor);
+	const auto blurImageIndex = _userpicFrame ? 0 : (data.index + 1);
+	const auto now = crl::now();
+	const auto reblur = (tileData.textureBlurSize != blurSize)
+		|| (tileData.blurRotation != frameRotation)
+		|| (tileData.blurMirror != tile->mirror())
+		|| ((tileData.blurTrackIndex != 0) != (blurImageIndex != 0))
+		|| (tileData.blurTrackIndex != blurImageIndex
+			&& now - tileData.blurredAt >= kBlurUpdateTimeout);
 	prepareObjects(f, tileData, blurSize);
-	f.glViewport(0, 0, blurSize.width(), blurSize.height());
+	if (reblur) {
+		tileData.blurTrackIndex = blurImageIndex;
+		tileData.blurRotation = frameRotation;
+		tileData.blurMirror = tile->mirror();
+		tileData.blurredAt = now;
 
-	bindFrame(f, data, tileData, _downscaleProgram);
+		f.glViewport(0, 0, blurSize.width(), blurSize.height());
 
-	drawDownscalePass(f, tileData);
-	drawFirstBlurPass(f, tileData, blurSize);
+		bindFrame(f, data, tileData, _downscaleProgram);
+
+		drawDownscalePass(f, tileData);
+		drawFirstBlurPass(f, tileData, blurSize);
+	}
 
 	f.glBindFramebuffer(GL_FRAMEBUFFER, defaultFramebufferObject);
 	setDefaultViewport(f);
@@ -989,6 +1019,20 @@ void Viewport::RendererGL::bindFrame(
 	} else {
 		const auto yuv = data.yuv420;
 		program.yuv420->bind();
+
+		// With the planes in an unpack buffer the texture uploads don't
+		// wait for the driver to copy the frame from our memory.
+		const auto unpack = upload && fillUnpackBuffer({ {
+			{ yuv->y.data, yuv->y.stride * yuv->size.height() },
+			{ yuv->u.data, yuv->u.stride * yuv->chromaSize.height() },
+			{ yuv->v.data, yuv->v.stride * yuv->chromaSize.height() },
+		} });
+		const auto source = [&](int plane, const void *data) {
+			return unpack
+				? reinterpret_cast<const void*>(
+					quintptr(_unpackOffsets[plane]))
+				: data;
+		};
 		f.glActiveTexture(GL_TEXTURE0);
 		tileData.textures.bind(f, 0);
 		if (upload) {
@@ -1000,7 +1044,7 @@ void Viewport::RendererGL::bindFrame(
 				yuv->size,
 				tileData.textureSize,
 				yuv->y.stride,
-				yuv->y.data);
+				source(0, yuv->y.data));
 			tileData.textureSize = yuv->size;
 			tileData.rgbaSize = QSize();
 		}
@@ -1014,7 +1058,7 @@ void Viewport::RendererGL::bindFrame(
 				yuv->chromaSize,
 				tileData.textureChromaSize,
 				yuv->u.stride,
-				yuv->u.data);
+				source(1, yuv->u.data));
 		}
 		f.glActiveTexture(GL_TEXTURE2);
 		tileData.textures.bind(f, 2);
@@ -1026,16 +1070,53 @@ void Viewport::RendererGL::bindFrame(
 				yuv->chromaSize,
 				tileData.textureChromaSize,
 				yuv->v.stride,
-				yuv->v.data);
+				source(2, yuv->v.data));
 			tileData.textureChromaSize = yuv->chromaSize;
 			f.glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 		}
+		if (unpack) {
+			_unpackBuffer->release();
+		}
 		program.yuv420->setUniformValue("y_texture", GLint(0));
 		program.yuv420->setUniformValue("u_texture", GLint(1));
 		program.yuv420->setUniformValue("v_texture", GLint(2));
 	}
 }
 
+bool Viewport::RendererGL::fillUnpackBuffer(
+		const std::array<UnpackPlane, 3> &planes) {
+	if (!_unpackBuffer) {
+		return false;
+	}
+	auto size = 0;
+	for (auto i = 0; i != int(planes.size()); ++i) {
+		_unpackOffsets[i] = size;
+		size += (planes[i].size + 15) & ~15;
+	}
+	_unpackBuffer->bind();
+
+	// Allocating each time orphans the storage of the previous frame,
+	// so we don't wait until the previous upload is finished.
+	_unpackBuffer->allocate(size);
+	const auto mapped = static_cast<char*>(
+		_unpackBuffer->map(QOpenGLBuffer::WriteOnly));
+	if (!mapped) {
+		LOG(("OpenGL Error: Could not map the pixel unpack buffer."));
+		_unpackBuffer->release();
+		_unpackBuffer = std::nullopt;
+		return false;
+	}
+	for (auto i = 0; i != int(planes.size()); ++i) {
+		memcpy(mapped + _unpackOffsets[i], planes[i].data, planes[i].size);
+	}
+	if (!_unpackBuffer->unmap()) {
+		// The buffer contents are lost, upload this frame directly.
+		_unpackBuffer->release();
+		return false;
+	}
+	return true;
+}
+
 void Viewport::RendererGL::uploadTexture(
 		QOpenGLFunctions &f,
 		GLint internalformat,
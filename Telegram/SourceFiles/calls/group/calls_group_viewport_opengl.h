@@ -58,6 +58,10 @@ private:
 		mutable QSize textureSize;
 		mutable QSize textureChromaSize;
 		mutable QSize textureBlurSize;
+		int blurTrackIndex = -1;
+		int blurRotation = 0;
+		crl::time blurredAt = 0;
+		bool blurMirror = false;
 		bool stale = false;
 		bool pause = false;
 		bool outline = false;
@@ -66,6 +70,10 @@ private:
 		std::optional<QOpenGLShaderProgram> argb32;
 		std::optional<QOpenGLShaderProgram> yuv420;
 	};
+	struct UnpackPlane {
+		const void *data = nullptr;
+		int size = 0;
+	};
 
 	void setDefaultViewport(QOpenGLFunctions &f);
 	void paintTile(
@@ -109,6 +117,8 @@ private:
 		not_null<VideoTile*> tile,
 		TileData &tileData);
 
+	[[nodiscard]] bool fillUnpackBuffer(
+		const std::array<UnpackPlane, 3> &planes);
 	void uploadTexture(
 		QOpenGLFunctions &f,
 		GLint internalformat,
@@ -135,6 +145,8 @@ private:
 	bool _rgbaFrame = false;
 	bool _userpicFrame;
 	std::optional<QOpenGLBuffer> _frameBuffer;
+	std::optional<QOpenGLBuffer> _unpackBuffer;
+	std::array<int, 3> _unpackOffsets = { { 0 } };
 	Program _downscaleProgram;
 	std::optional<QOpenGLShaderProgram> _blurProgram;
 	Program _frameProgram;
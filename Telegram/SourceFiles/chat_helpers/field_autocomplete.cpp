@@ -64,7 +64,7 @@ namespace {
 
 template <typename T, typename U>
 inline int indexOfInFirstN(const T &v, const U &elem, int last) {
-	for (auto b = v.cbegin(), i = b, e = b + std::max(int(v.size()), last)
+	for (auto b = v.cbegin(), i = b, e = b + std::min(int(v.size()), last)
 		; i != e
 		; ++i) {
 		if (i->user == elem) {
@@ -151,7 +151,6 @@ private:
 	const not_null<StickerRows*> _srows;
 	Ui::RoundRect _overBg;
 	rpl::lifetime _stickersLifetime;
-	std::weak_ptr<Lottie::FrameRenderer> _lottieRenderer;
 	base::unique_qptr<Ui::PopupMenu> _menu;
 	int _stickersPerRow = 1;
 	int _recentInlineBotsInRows = 0;
@@ -452,9 +451,9 @@ void FieldAutocomplete::updateFiltered(bool resetScroll) {
 		}
 
 		auto filterNotPassedByUsername = [this](UserData *user) -> bool {
-			if (PrimaryUsername(user).startsWith(_filter, Qt::CaseInsensitive)) {
-				const auto exactUsername
-					= (PrimaryUsername(user).size() == _filter.size());
+			const auto username = PrimaryUsername(user);
+			if (username.startsWith(_filter, Qt::CaseInsensitive)) {
+				const auto exactUsername = (username.size() == _filter.size());
 				return exactUsername;
 			}
 			return true;
@@ -1470,12 +1469,7 @@ void FieldAutocomplete::Inner::rowsUpdated() {
 
 auto FieldAutocomplete::Inner::getLottieRenderer()
 -> std::shared_ptr<Lottie::FrameRenderer> {
-	if (auto result = _lottieRenderer.lock()) {
-		return result;
-	}
-	auto result = Lottie::MakeFrameRenderer();
-	_lottieRenderer = result;
-	return result;
+	return SharedLottieRenderer();
 }
 
 void FieldAutocomplete::Inner::setupLottie(StickerSuggestion &suggestion) {
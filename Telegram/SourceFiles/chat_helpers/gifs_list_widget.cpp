@@ -53,6 +53,7 @@ namespace {
 constexpr auto kSearchRequestDelay = 400;
 constexpr auto kMinRepaintDelay = crl::time(33);
 constexpr auto kMinAfterScrollDelay = crl::time(33);
+constexpr auto kStartPlayersAfterScrollDelay = crl::time(200);
 
 } // namespace
 
@@ -358,6 +359,18 @@ void GifsListWidget::paintInlineItems(Painter &p, QRect clip) {
 	using namespace InlineBots::Layout;
 	PaintContext context(crl::now(), false, gifPaused, false);
 
+	// Don't create a clip reader for each cell passed by a fast scroll.
+	const auto settleIn = _lastScrolledAt
+		+ kStartPlayersAfterScrollDelay
+		- context.ms;
+	if (settleIn > 0) {
+		context.scrolling = true;
+		if (!_updateInlineItems.isActive()
+			|| _updateInlineItems.remainingTime() > settleIn) {
+			_updateInlineItems.callOnce(settleIn);
+		}
+	}
+
 	auto paintItem = [&](not_null<const ItemBase*> item, QPoint point) {
 		p.translate(point.x(), point.y());
 		item->paint(
@@ -171,6 +171,19 @@ void DownloadDictionaryInBackground(
 	BackgroundLoaderChanged.fire_copy(id);
 }
 
+// Dictionaries are loaded only when the first spellchecked field appears.
+bool LanguagesRequested = false;
+
+void ApplyLanguages() {
+	if (!LanguagesRequested) {
+		return;
+	}
+	const auto settings = &Core::App().settings();
+	Platform::Spellchecker::UpdateLanguages(settings->spellcheckerEnabled()
+		? settings->dictionariesEnabled()
+		: std::vector<int>());
+}
+
 void AddExceptions() {
 	const auto exceptions = ranges::views::all(
 		kExceptions
@@ -365,6 +378,13 @@ std::vector<int> DefaultLanguages() {
 	return langs;
 }
 
+void RequestLanguages() {
+	if (!LanguagesRequested) {
+		LanguagesRequested = true;
+		ApplyLanguages();
+	}
+}
+
 void Start(not_null<Main::Session*> session) {
 	Spellchecker::SetPhrases({ {
 		{ &ph::lng_spellchecker_submenu, tr::lng_spellchecker_submenu() },
@@ -375,16 +395,7 @@ void Start(not_null<Main::Session*> session) {
 	const auto settings = &Core::App().settings();
 	auto &lifetime = session->lifetime();
 
-	const auto onEnabled = [=](auto enabled) {
-		Platform::Spellchecker::UpdateLanguages(
-			enabled
-				? settings->dictionariesEnabled()
-				: std::vector<int>());
-	};
-
-	const auto guard = gsl::finally([=] {
-		onEnabled(settings->spellcheckerEnabled());
-	});
+	const auto guard = gsl::finally(ApplyLanguages);
 
 	if (Platform::Spellchecker::IsSystemSpellchecker()) {
 		Spellchecker::SupportedScriptsChanged()
@@ -400,12 +411,10 @@ void Start(not_null<Main::Session*> session) {
 	Spellchecker::SetWorkingDirPath(DictionariesPath());
 
 	settings->dictionariesEnabledChanges(
-	) | rpl::start_with_next([](auto dictionaries) {
-		Platform::Spellchecker::UpdateLanguages(dictionaries);
-	}, lifetime);
+	) | rpl::start_with_next(ApplyLanguages, lifetime);
 
 	settings->spellcheckerEnabledChanges(
-	) | rpl::start_with_next(onEnabled, lifetime);
+	) | rpl::start_with_next(ApplyLanguages, lifetime);
 
 	const auto method = QGuiApplication::inputMethod();
 
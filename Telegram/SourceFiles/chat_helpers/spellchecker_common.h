@@ -35,6 +35,9 @@ bool WriteDefaultDictionary();
 std::vector<Dict> Dictionaries();
 
 void Start(not_null<Main::Session*> session);
+
+// Loads the enabled dictionaries, called when a spellchecked field is created.
+void RequestLanguages();
 [[nodiscard]] rpl::producer<QString> ButtonManageDictsState(
 	not_null<Main::Session*> session);
 
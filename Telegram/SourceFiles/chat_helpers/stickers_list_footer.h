@@ -281,7 +281,6 @@ private:
 
 	static constexpr auto kVisibleIconsCount = 8;
 
-	std::weak_ptr<Lottie::FrameRenderer> _lottieRenderer;
 	std::vector<StickerIcon> _icons;
 	Fn<std::shared_ptr<Lottie::FrameRenderer>()> _renderer;
 	uint64 _activeByScrollId = 0;
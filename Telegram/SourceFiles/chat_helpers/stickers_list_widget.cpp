@@ -714,6 +714,9 @@ void StickersListWidget::fillLocalSearchRows(const QString &query) {
 		return true;
 	};
 
+	if (base::take(_searchIndexDirty)) {
+		refreshSearchIndex();
+	}
 	const auto &sets = session().data().stickers().sets();
 	for (const auto &[setId, titleWords] : _searchIndex) {
 		if (allSearchWordsInTitle(titleWords)) {
@@ -1142,7 +1145,7 @@ void StickersListWidget::checkVisibleLottie() {
 	}
 	const auto visibleTop = getVisibleTop();
 	const auto visibleBottom = getVisibleBottom();
-	const auto destroyAfterDistance = (visibleBottom - visibleTop) * 2;
+	const auto destroyAfterDistance = (visibleBottom - visibleTop);
 	const auto destroyAbove = visibleTop - destroyAfterDistance;
 	const auto destroyBelow = visibleBottom + destroyAfterDistance;
 	enumerateSections([&](const SectionInfo &info) {
@@ -2128,7 +2131,9 @@ void StickersListWidget::refreshFeaturedSets() {
 }
 
 void StickersListWidget::refreshSearchSets() {
-	refreshSearchIndex();
+	// Preparing the search words of all the sets is not cheap,
+	// so the index is rebuilt only when it is used.
+	_searchIndexDirty = true;
 
 	const auto &sets = session().data().stickers().sets();
 	const auto skipPremium = !session().premiumPossible();
@@ -2659,12 +2664,7 @@ void StickersListWidget::showPreview() {
 
 auto StickersListWidget::getLottieRenderer()
 -> std::shared_ptr<Lottie::FrameRenderer> {
-	if (auto result = _lottieRenderer.lock()) {
-		return result;
-	}
-	auto result = Lottie::MakeFrameRenderer();
-	_lottieRenderer = result;
-	return result;
+	return SharedLottieRenderer();
 }
 
 void StickersListWidget::showStickerSet(uint64 setId) {
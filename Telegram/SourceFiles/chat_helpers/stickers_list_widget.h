@@ -389,7 +389,6 @@ private:
 	std::vector<bool> _custom;
 	std::vector<EmojiPtr> _cornerEmoji;
 	base::flat_set<not_null<DocumentData*>> _favedStickersMap;
-	std::weak_ptr<Lottie::FrameRenderer> _lottieRenderer;
 
 	bool _paintAsPremium = false;
 	bool _showingSetById = false;
@@ -444,6 +443,7 @@ private:
 	rpl::variable<int> _recentShownCount;
 	std::map<QString, std::vector<uint64>> _searchCache;
 	std::vector<std::pair<uint64, QStringList>> _searchIndex;
+	bool _searchIndexDirty = true;
 	base::Timer _searchRequestTimer;
 	QString _searchQuery, _searchNextQuery;
 	mtpRequestId _searchRequestId = 0;
@@ -37,6 +37,16 @@ uint8 LottieCacheKeyShift(uint8 replacementsTag, StickerLottieSize sizeTag) {
 	return ((replacementsTag << 4) & 0xF0) | (uint8(sizeTag) & 0x0F);
 }
 
+std::shared_ptr<Lottie::FrameRenderer> SharedLottieRenderer() {
+	static auto Shared = std::weak_ptr<Lottie::FrameRenderer>();
+	if (auto result = Shared.lock()) {
+		return result;
+	}
+	auto result = Lottie::MakeFrameRenderer();
+	Shared = result;
+	return result;
+}
+
 template <typename Method>
 auto LottieCachedFromContent(
 		Method &&method,
@@ -73,6 +73,10 @@ enum class StickerLottieSize : uint8 {
 	uint8 replacementsTag,
 	StickerLottieSize sizeTag);
 
+// One render thread for all the sticker and emoji panels, kept while
+// any player uses it. Each panel still pauses its invisible animations.
+[[nodiscard]] std::shared_ptr<Lottie::FrameRenderer> SharedLottieRenderer();
+
 [[nodiscard]] std::unique_ptr<Lottie::SinglePlayer> LottiePlayerFromDocument(
 	not_null<Data::DocumentMedia*> media,
 	StickerLottieSize sizeTag,
@@ -18,6 +18,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_channel.h"
 #include "data/data_download_manager.h"
 #include "base/battery_saving.h"
+#include "base/call_delayed.h"
 #include "base/event_filter.h"
 #include "base/concurrent_timer.h"
 #include "base/options.h"
@@ -25,6 +26,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "base/timer.h"
 #include "base/unixtime.h"
 #include "core/core_settings.h"
+#include "core/core_startup_trace.h"
 #include "core/update_checker.h"
 #include "core/shortcuts.h"
 #include "core/sandbox.h"
@@ -112,13 +114,22 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include <QtGui/QScreen>
 #include <QtGui/QWindow>
 
+#if QT_VERSION >= QT_VERSION_CHECK(6, 3, 0)
+#include <QtNetwork/QNetworkInformation>
+#endif // Qt >= 6.3.0
+
 namespace Core {
 namespace {
 
 constexpr auto kQuitPreventTimeoutMs = crl::time(1500);
 constexpr auto kAutoLockTimeoutLateMs = crl::time(3000);
 constexpr auto kClearEmojiImageSourceTimeout = 10 * crl::time(1000);
+constexpr auto kStartupTraceDuration = 15 * crl::time(1000);
 constexpr auto kFileOpenTimeoutMs = crl::time(1000);
+constexpr auto kIdleTasksTimeout = 30 * crl::time(1000);
+constexpr auto kIdleTasksMaxDelay = 30 * 60 * crl::time(1000);
+constexpr auto kIdleTasksNextDelay = crl::time(100);
+constexpr auto kNetworkChangeDelay = crl::time(300);
 
 LaunchState GlobalLaunchState/* = LaunchState::Running*/;
 
@@ -184,7 +195,12 @@ Application::Application()
 , _emojiKeywords(std::make_unique<ChatHelpers::EmojiKeywords>())
 , _tray(std::make_unique<Tray>())
 , _autoLockTimer([=] { checkAutoLock(); })
-, _fileOpenTimer([=] { checkFileOpen(); }) {
+, _fileOpenTimer([=] { checkFileOpen(); })
+, _idleTasksTimer([=] { checkIdleTasks(); })
+, _networkChangeTimer([=] {
+	LOG(("Network Info: Network changed, reconnecting."));
+	_networkChanges.fire({});
+}) {
 	Ui::Integration::Set(&_private->uiIntegration);
 
 	_platformIntegration->init();
@@ -227,9 +243,9 @@ void Application::closeAdditionalWindows() {
 }
 
 Application::~Application() {
-	if (_saveSettingsTimer && _saveSettingsTimer->isActive()) {
-		Local::writeSettings();
-	}
+	StartupTrace::Finish();
+
+	saveSettingsNowIfNeeded();
 
 	_windowStack.clear();
 	setLastActiveWindow(nullptr);
@@ -270,18 +286,27 @@ Application::~Application() {
 }
 
 void Application::run() {
+	const auto trace = StartupTrace::Span("Application::run");
+
 	// Depends on OpenSSL on macOS, so on ThirdParty::start().
 	// Depends on notifications settings.
 	_notifications = std::make_unique<Window::Notifications::System>();
 
-	startLocalStorage();
+	{
+		const auto trace = StartupTrace::Span("Local storage");
+		startLocalStorage();
+	}
 
-	style::SetCustomFont(settings().customFontFamily());
-	style::internal::StartFonts();
+	{
+		const auto trace = StartupTrace::Span("Fonts");
+		style::SetCustomFont(settings().customFontFamily());
+		style::internal::StartFonts();
+	}
 
 	ValidateScale();
 
 	refreshGlobalProxy(); // Depends on app settings being read.
+	startNetworkWatcher();
 
 	if (const auto old = Local::oldSettingsVersion(); old < AppVersion) {
 		autoRegisterUrlScheme();
@@ -301,11 +326,14 @@ void Application::run() {
 	_translator = std::make_unique<Lang::Translator>();
 	QCoreApplication::instance()->installTranslator(_translator.get());
 
-	style::StartManager(cScale());
-	Ui::InitTextOptions();
-	Ui::StartCachedCorners();
-	Ui::Emoji::Init();
-	Ui::PreloadTextSpoilerMask();
+	{
+		const auto trace = StartupTrace::Span("Styles and emoji");
+		style::StartManager(cScale());
+		Ui::InitTextOptions();
+		Ui::StartCachedCorners();
+		Ui::Emoji::Init();
+		Ui::PreloadTextSpoilerMask();
+	}
 	startShortcuts();
 	startEmojiImageLoader();
 	startSystemDarkModeViewer();
@@ -335,13 +363,19 @@ void Application::run() {
 
 	DEBUG_LOG(("Application Info: starting app..."));
 
-	// Create mime database, so it won't be slow later.
-	QMimeDatabase().mimeTypeForName(u"text/plain"_q);
+	// Create mime database in the background, so it won't be slow later.
+	crl::async([] {
+		const auto trace = StartupTrace::Span("Mime database");
+		QMimeDatabase().mimeTypeForName(u"text/plain"_q);
+	});
 
 	// Check now to avoid re-entrance later.
 	[[maybe_unused]] const auto ivSupported = Iv::ShowButton();
 
-	_windows.emplace(nullptr, std::make_unique<Window::Controller>());
+	{
+		const auto trace = StartupTrace::Span("Window");
+		_windows.emplace(nullptr, std::make_unique<Window::Controller>());
+	}
 	setLastActiveWindow(_windows.front().second.get());
 	_windowInSettings = _lastActivePrimaryWindow = _lastActiveWindow;
 
@@ -388,10 +422,16 @@ void Application::run() {
 
 	DEBUG_LOG(("Application Info: window created..."));
 
-	startDomain();
+	{
+		const auto trace = StartupTrace::Span("Domain");
+		startDomain();
+	}
 	startTray();
 
-	_lastActivePrimaryWindow->firstShow();
+	{
+		const auto trace = StartupTrace::Span("First show");
+		_lastActivePrimaryWindow->firstShow();
+	}
 
 	startMediaView();
 
@@ -428,6 +468,12 @@ void Application::run() {
 	}
 
 	processCreatedWindow(_lastActivePrimaryWindow);
+
+	if (StartupTrace::Enabled()) {
+		base::call_delayed(kStartupTraceDuration, this, [] {
+			StartupTrace::Finish();
+		});
+	}
 }
 
 void Application::autoRegisterUrlScheme() {
@@ -642,6 +688,18 @@ bool Application::isActiveForTrayMenu() const {
 	});
 }
 
+bool Application::hasShownWindows() const {
+	if (_mediaView && !_mediaView->isHidden() && !_mediaView->isMinimized()) {
+		return true;
+	}
+	return ranges::any_of(ranges::views::values(_windows), [=](
+			const std::unique_ptr<Window::Controller> &controller) {
+		const auto widget = controller->widget();
+		return !widget->isHidden()
+			&& !(widget->windowState() & Qt::WindowMinimized);
+	});
+}
+
 bool Application::hideMediaView() {
 	if (_mediaView
 		&& _mediaView->isFullScreen()
@@ -733,7 +791,11 @@ const Settings &Application::settings() const {
 }
 
 void Application::saveSettingsDelayed(crl::time delay) {
-	if (_saveSettingsTimer) {
+	// Don't postpone an already planned write, so that a stream of small
+	// changes is written at most once in a delay and is not lost on crash.
+	if (_saveSettingsTimer
+		&& (!_saveSettingsTimer->isActive()
+			|| _saveSettingsTimer->remainingTime() > delay)) {
 		_saveSettingsTimer->callOnce(delay);
 	}
 }
@@ -742,6 +804,13 @@ void Application::saveSettings() {
 	Local::writeSettings();
 }
 
+void Application::saveSettingsNowIfNeeded() {
+	if (_saveSettingsTimer && _saveSettingsTimer->isActive()) {
+		_saveSettingsTimer->cancel();
+		saveSettings();
+	}
+}
+
 bool Application::canReadDefaultDownloadPath() const {
 	return KSandbox::isInside()
 		? base::CanReadDirectory(
@@ -798,6 +867,36 @@ auto Application::proxyChanges() const -> rpl::producer<ProxyChange> {
 	return _proxyChanges.events();
 }
 
+rpl::producer<> Application::networkChanges() const {
+	return _networkChanges.events();
+}
+
+void Application::startNetworkWatcher() {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 3, 0)
+	using Information = QNetworkInformation;
+	if (!Information::load(Information::Feature::Reachability)) {
+		LOG(("Network Info: Could not load network information backend."));
+		return;
+	}
+	const auto information = Information::instance();
+	const auto changed = [=] {
+		// A burst of changes comes while the interfaces go up and down.
+		const auto reachability = information->reachability();
+		if (reachability == Information::Reachability::Disconnected) {
+			_networkChangeTimer.cancel();
+		} else {
+			_networkChangeTimer.callOnce(kNetworkChangeDelay);
+		}
+	};
+	connect(information, &Information::reachabilityChanged, this, changed);
+	connect(
+		information,
+		&Information::transportMediumChanged,
+		this,
+		changed);
+#endif // Qt >= 6.3.0
+}
+
 void Application::badMtprotoConfigurationError() {
 	if (settings().proxy().isEnabled() && !_badProxyDisableBox) {
 		const auto disableCallback = [=] {
@@ -952,6 +1051,15 @@ void Application::handleAppDeactivated() {
 		session->updates().updateOnline();
 	}
 	Ui::Tooltip::Hide();
+
+	saveSettingsNowIfNeeded();
+	if (_domain->started()) {
+		for (const auto &[index, account] : _domain->accounts()) {
+			if (const auto other = account->maybeSession()) {
+				other->saveSettingsNowIfNeeded();
+			}
+		}
+	}
 }
 
 rpl::producer<bool> Application::appDeactivatedValue() const {
@@ -1230,6 +1338,41 @@ void Application::updateNonIdle() {
 	}
 }
 
+void Application::runWhenIdle(Fn<void()> callback) {
+	Expects(callback != nullptr);
+
+	_idleTasks.push_back({
+		.callback = std::move(callback),
+		.added = crl::now(),
+	});
+	if (!_idleTasksTimer.isActive()) {
+		_idleTasksTimer.callOnce(kIdleTasksNextDelay);
+	}
+}
+
+void Application::checkIdleTasks() {
+	if (_idleTasks.empty()) {
+		return;
+	}
+	const auto now = crl::now();
+	const auto idle = now - lastNonIdleTime();
+	const auto oldest = _idleTasks.front().added;
+	if (idle < kIdleTasksTimeout && now - oldest < kIdleTasksMaxDelay) {
+		_idleTasksTimer.callOnce(std::min(
+			kIdleTasksTimeout - idle,
+			oldest + kIdleTasksMaxDelay - now));
+		return;
+	}
+
+	// Run one task at a time, so that a returning user doesn't wait.
+	const auto callback = std::move(_idleTasks.front().callback);
+	_idleTasks.erase(begin(_idleTasks));
+	if (!_idleTasks.empty()) {
+		_idleTasksTimer.callOnce(kIdleTasksNextDelay);
+	}
+	callback();
+}
+
 crl::time Application::lastNonIdleTime() const {
 	return std::max(
 		base::Platform::LastUserInputTime().value_or(0),
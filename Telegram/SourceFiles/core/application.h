@@ -193,6 +193,7 @@ public:
 	void notifyFileDialogShown(bool shown);
 	void checkSystemDarkMode();
 	[[nodiscard]] bool isActiveForTrayMenu() const;
+	[[nodiscard]] bool hasShownWindows() const;
 	void closeChatFromWindows(not_null<PeerData*> peer);
 	void checkWindowId(not_null<Window::Controller*> window);
 	void activate();
@@ -208,6 +209,7 @@ public:
 	[[nodiscard]] const Settings &settings() const;
 	void saveSettingsDelayed(crl::time delay = kDefaultSaveDelay);
 	void saveSettings();
+	void saveSettingsNowIfNeeded();
 
 	[[nodiscard]] bool canReadDefaultDownloadPath() const;
 	[[nodiscard]] bool canSaveFileWithoutAskingForPath() const;
@@ -220,6 +222,11 @@ public:
 		const MTP::ProxyData &proxy,
 		MTP::ProxyData::Settings settings);
 	[[nodiscard]] rpl::producer<ProxyChange> proxyChanges() const;
+
+	// Fired when the system reports a new network route (another Wi-Fi,
+	// a cable plugged in, a VPN toggled) to reconnect right away instead
+	// of waiting for the old connections to time out.
+	[[nodiscard]] rpl::producer<> networkChanges() const;
 	void badMtprotoConfigurationError();
 
 	// Databases.
@@ -273,6 +280,7 @@ public:
 	void checkStartUrl();
 	void checkSendPaths();
 	void checkFileOpen();
+	void checkIdleTasks();
 	bool openLocalUrl(const QString &url, QVariant context);
 	bool openInternalUrl(const QString &url, QVariant context);
 	[[nodiscard]] QString changelogLink() const;
@@ -315,6 +323,9 @@ public:
 	[[nodiscard]] crl::time lastNonIdleTime() const;
 	void updateNonIdle();
 
+	// Deferred maintenance, run one by one while the user is away.
+	void runWhenIdle(Fn<void()> callback);
+
 	void registerLeaveSubscription(not_null<QWidget*> widget);
 	void unregisterLeaveSubscription(not_null<QWidget*> widget);
 
@@ -322,6 +333,7 @@ public:
 	void postponeCall(FnMut<void()> &&callable);
 	void refreshGlobalProxy();
 	void refreshApplicationIcon();
+	void startNetworkWatcher();
 
 	void quitPreventFinished();
 
@@ -397,6 +409,7 @@ private:
 	InstanceSetter _setter = { this };
 
 	rpl::event_stream<ProxyChange> _proxyChanges;
+	rpl::event_stream<> _networkChanges;
 
 	// Some fields are just moved from the declaration.
 	struct Private;
@@ -454,6 +467,15 @@ private:
 	QStringList _filesToOpen;
 	base::Timer _fileOpenTimer;
 
+	struct IdleTask {
+		Fn<void()> callback;
+		crl::time added = 0;
+	};
+	std::vector<IdleTask> _idleTasks;
+	base::Timer _idleTasksTimer;
+
+	base::Timer _networkChangeTimer;
+
 	std::optional<base::Timer> _saveSettingsTimer;
 
 	struct LeaveFilter {
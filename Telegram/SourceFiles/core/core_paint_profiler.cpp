@@ -0,0 +1,249 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "core/core_paint_profiler.h"
+
+#include "base/options.h"
+#include "base/timer.h"
+#include "ui/rp_widget.h"
+#include "ui/painter.h"
+#include "styles/style_basic.h"
+
+#include <array>
+
+namespace Core {
+namespace {
+
+base::options::toggle PaintProfilerOption({
+	.id = kOptionPaintProfiler,
+	.name = "Show paint profiler",
+	.description = "Show the per-frame paint time of the chat, the chats "
+		"list, the chat background, shared media and the media viewer "
+		"over the window and write a summary to the log on exit.",
+	.restartRequired = true,
+});
+
+} // namespace
+
+const char kOptionPaintProfiler[] = "paint-profiler";
+
+} // namespace Core
+
+namespace Core::PaintProfiler {
+namespace {
+
+constexpr auto kSectionsCount = int(Section::kCount);
+constexpr auto kSlowFrame = crl::profile_time(16667);
+constexpr auto kOverlayUpdateTimeout = crl::time(1000);
+
+struct Stats {
+	crl::profile_time lastDuration = 0;
+	int lastElements = 0;
+	int lastLayouts = 0;
+	int64 frames = 0;
+	int64 slowFrames = 0;
+	int64 elements = 0;
+	int64 layouts = 0;
+	crl::profile_time total = 0;
+	crl::profile_time worst = 0;
+};
+
+std::array<Stats, kSectionsCount> AllStats;
+Scope *CurrentScope = nullptr;
+int64 LayoutsOutside = 0;
+
+[[nodiscard]] const char *SectionName(Section section) {
+	switch (section) {
+	case Section::History: return "history";
+	case Section::HistoryThroughput: return "history_throughput";
+	case Section::Dialogs: return "dialogs";
+	case Section::ChatBackground: return "background";
+	case Section::Overview: return "overview";
+	case Section::MediaViewer: return "media_viewer";
+	}
+	Unexpected("Section in PaintProfiler::SectionName.");
+}
+
+[[nodiscard]] QString Milliseconds(crl::profile_time value) {
+	return QString::number(value / 1000., 'f', 1);
+}
+
+[[nodiscard]] QStringList OverlayLines(int64 layoutsPerSecond) {
+	auto result = QStringList(u"Paint profiler: last frame | session"_q);
+	for (auto i = 0; i != kSectionsCount; ++i) {
+		const auto &stats = AllStats[i];
+		if (!stats.frames) {
+			continue;
+		}
+		result.push_back(u"%1: %2 ms, %3 elements, %4 layouts | "
+			"%5 ms avg, %6 ms worst, %7 slow of %8"_q
+			.arg(SectionName(Section(i)))
+			.arg(Milliseconds(stats.lastDuration))
+			.arg(stats.lastElements)
+			.arg(stats.lastLayouts)
+			.arg(Milliseconds(stats.total / stats.frames))
+			.arg(Milliseconds(stats.worst))
+			.arg(stats.slowFrames)
+			.arg(stats.frames));
+	}
+	result.push_back(u"layouts outside of paint: %1 per second"_q
+		.arg(layoutsPerSecond));
+	return result;
+}
+
+class Overlay final : public Ui::RpWidget {
+public:
+	explicit Overlay(not_null<Ui::RpWidget*> parent);
+
+private:
+	void paintEvent(QPaintEvent *e) override;
+
+	void refresh();
+	void updateGeometry();
+
+	const not_null<Ui::RpWidget*> _parent;
+
+	base::Timer _timer;
+	QStringList _lines;
+	int64 _layoutsOutside = 0;
+
+};
+
+Overlay::Overlay(not_null<Ui::RpWidget*> parent)
+: RpWidget(parent)
+, _parent(parent)
+, _timer([=] { refresh(); }) {
+	setAttribute(Qt::WA_TransparentForMouseEvents);
+
+	_parent->sizeValue() | rpl::start_with_next([=] {
+		updateGeometry();
+	}, lifetime());
+
+	refresh();
+	_timer.callEach(kOverlayUpdateTimeout);
+}
+
+void Overlay::refresh() {
+	const auto layouts = LayoutsOutside - _layoutsOutside;
+	_layoutsOutside = LayoutsOutside;
+	_lines = OverlayLines(layouts * 1000 / kOverlayUpdateTimeout);
+	updateGeometry();
+	raise();
+	update();
+}
+
+void Overlay::updateGeometry() {
+	const auto &font = st::normalFont;
+	const auto padding = font->height / 2;
+	auto width = 0;
+	for (const auto &line : _lines) {
+		width = std::max(width, font->width(line));
+	}
+	const auto outer = width + 2 * padding;
+	setGeometry(
+		_parent->width() - outer - padding,
+		padding,
+		outer,
+		int(_lines.size()) * font->height + 2 * padding);
+}
+
+void Overlay::paintEvent(QPaintEvent *e) {
+	auto p = QPainter(this);
+	p.fillRect(rect(), QColor(0, 0, 0, 160));
+
+	const auto &font = st::normalFont;
+	const auto padding = font->height / 2;
+	p.setFont(font);
+	p.setPen(QColor(255, 255, 255));
+	auto top = padding;
+	for (const auto &line : _lines) {
+		p.drawText(padding, top + font->ascent, line);
+		top += font->height;
+	}
+}
+
+} // namespace
+
+bool Enabled() {
+	static const auto result = PaintProfilerOption.value();
+	return result;
+}
+
+Scope::Scope(Section section)
+: _section(section)
+, _enabled(Enabled()) {
+	if (_enabled) {
+		_parent = std::exchange(CurrentScope, this);
+		_start = crl::profile();
+	}
+}
+
+Scope::~Scope() {
+	if (!_enabled) {
+		return;
+	}
+	const auto duration = crl::profile() - _start;
+	const auto own = std::max(duration - _children, crl::profile_time());
+	CurrentScope = _parent;
+	if (_parent) {
+		_parent->_children += duration;
+	}
+	auto &stats = AllStats[int(_section)];
+	stats.lastDuration = own;
+	stats.lastElements = _elements;
+	stats.lastLayouts = _layouts;
+	++stats.frames;
+	if (own > kSlowFrame) {
+		++stats.slowFrames;
+	}
+	stats.elements += _elements;
+	stats.layouts += _layouts;
+	stats.total += own;
+	stats.worst = std::max(stats.worst, own);
+}
+
+void CountElement() {
+	if (CurrentScope) {
+		++CurrentScope->_elements;
+	}
+}
+
+void CountLayout() {
+	if (CurrentScope) {
+		++CurrentScope->_layouts;
+	} else if (Enabled()) {
+		++LayoutsOutside;
+	}
+}
+
+object_ptr<Ui::RpWidget> CreateOverlay(not_null<Ui::RpWidget*> parent) {
+	auto result = object_ptr<Overlay>(parent);
+	result->lifetime().add([] { WriteSummary(); });
+	return result;
+}
+
+void WriteSummary() {
+	for (auto i = 0; i != kSectionsCount; ++i) {
+		const auto &stats = AllStats[i];
+		if (!stats.frames) {
+			continue;
+		}
+		LOG(("Paint Profiler: %1 - %2 frames, %3 ms avg, %4 ms worst, "
+			"%5 slow, %6 elements, %7 layouts."
+			).arg(SectionName(Section(i))
+			).arg(stats.frames
+			).arg(Milliseconds(stats.total / stats.frames)
+			).arg(Milliseconds(stats.worst)
+			).arg(stats.slowFrames
+			).arg(stats.elements
+			).arg(stats.layouts));
+	}
+	LOG(("Paint Profiler: %1 layouts outside of paint."
+		).arg(LayoutsOutside));
+}
+
+} // namespace Core::PaintProfiler
@@ -0,0 +1,74 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include "base/object_ptr.h"
+
+#include <crl/crl_time.h>
+
+namespace Ui {
+class RpWidget;
+} // namespace Ui
+
+namespace Core {
+
+extern const char kOptionPaintProfiler[];
+
+} // namespace Core
+
+namespace Core::PaintProfiler {
+
+enum class Section : uchar {
+	History,
+	HistoryThroughput,
+	Dialogs,
+	ChatBackground,
+	Overview,
+	MediaViewer,
+
+	kCount,
+};
+
+// Enabled by the "paint-profiler" experimental option, main thread only.
+[[nodiscard]] bool Enabled();
+
+// Time of the nested scopes is not counted in the outer one.
+class Scope final {
+public:
+	explicit Scope(Section section);
+	~Scope();
+
+	Scope(const Scope &other) = delete;
+	Scope &operator=(const Scope &other) = delete;
+
+private:
+	friend void CountElement();
+	friend void CountLayout();
+
+	Scope *_parent = nullptr;
+	crl::profile_time _start = 0;
+	crl::profile_time _children = 0;
+	int _elements = 0;
+	int _layouts = 0;
+	Section _section = Section();
+	bool _enabled = false;
+
+};
+
+// Both are accounted to the innermost active scope.
+void CountElement();
+void CountLayout();
+
+// Shows the last frame and the session statistics over the parent.
+[[nodiscard]] object_ptr<Ui::RpWidget> CreateOverlay(
+	not_null<Ui::RpWidget*> parent);
+
+// Called when the overlay is destroyed, writes the session summary.
+void WriteSummary();
+
+} // namespace Core::PaintProfiler
@@ -7,12 +7,21 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #include "core/core_settings_proxy.h"
 
+#include "base/options.h"
 #include "base/platform/base_platform_info.h"
 #include "storage/serialize_common.h"
 
 namespace Core {
 namespace {
 
+base::options::toggle SpreadMediaOverProxiesOption({
+	.id = kOptionSpreadMediaOverProxies,
+	.name = "Spread media over proxies",
+	.description = "Use all saved proxies in turn for the file download "
+		"and upload connections, falling back to the selected one when "
+		"a proxy can't connect.",
+});
+
 [[nodiscard]] qint32 ProxySettingsToInt(MTP::ProxyData::Settings settings) {
 	switch(settings) {
 	case MTP::ProxyData::Settings::System: return 0;
@@ -90,6 +99,8 @@ namespace {
 
 } // namespace
 
+const char kOptionSpreadMediaOverProxies[] = "spread-media-over-proxies";
+
 SettingsProxy::SettingsProxy()
 : _tryIPv6(!Platform::IsWindows()) {
 }
@@ -208,6 +219,22 @@ void SettingsProxy::setSelected(MTP::ProxyData value) {
 	_selected = value;
 }
 
+MTP::ProxyData SettingsProxy::selectedForMedia(int index) const {
+	Expects(index >= 0);
+
+	if (!isEnabled() || !SpreadMediaOverProxiesOption.value()) {
+		return _selected;
+	}
+	auto usable = std::vector<const MTP::ProxyData*>{ &_selected };
+	for (const auto &proxy : _list) {
+		if (proxy != _selected
+			&& proxy.status() == MTP::ProxyData::Status::Valid) {
+			usable.push_back(&proxy);
+		}
+	}
+	return *usable[index % int(usable.size())];
+}
+
 const std::vector<MTP::ProxyData> &SettingsProxy::list() const {
 	return _list;
 }
@@ -11,6 +11,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 namespace Core {
 
+extern const char kOptionSpreadMediaOverProxies[];
+
 class SettingsProxy final {
 public:
 	SettingsProxy();
@@ -35,6 +37,11 @@ public:
 	[[nodiscard]] MTP::ProxyData selected() const;
 	void setSelected(MTP::ProxyData value);
 
+	// With the spread-media-over-proxies option the download and upload
+	// sessions use the selected proxy and the valid ones from the list
+	// in turn, the first media session always uses the selected one.
+	[[nodiscard]] MTP::ProxyData selectedForMedia(int index) const;
+
 	[[nodiscard]] const std::vector<MTP::ProxyData> &list() const;
 	[[nodiscard]] std::vector<MTP::ProxyData> &list();
 
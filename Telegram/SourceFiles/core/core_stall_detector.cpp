@@ -0,0 +1,238 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "core/core_stall_detector.h"
+
+#include "base/flat_map.h"
+#include "core/crash_reports.h"
+
+#include <QtCore/QAbstractEventDispatcher>
+#include <QtCore/QMetaEnum>
+#include <QtCore/QWaitCondition>
+#include <QtCore/QThread>
+#include <QtCore/QMutex>
+#include <QtCore/QDir>
+
+#include <array>
+#include <atomic>
+
+namespace Core::StallDetector {
+namespace {
+
+constexpr auto kCheckTimeout = 50;
+constexpr auto kThresholds = std::array{
+	crl::time(100),
+	crl::time(500),
+	crl::time(2000),
+};
+constexpr auto kThresholdsCount = int(kThresholds.size());
+constexpr auto kAnnotationEntries = 3;
+
+struct Stats {
+	std::array<int, kThresholdsCount> counts = {};
+	crl::time longest = 0;
+};
+
+// Written on the main thread, read on the watcher thread.
+std::atomic<crl::time> BusySince = 0;
+std::atomic<const char*> DispatchedReceiver = nullptr;
+std::atomic<int> DispatchedEvent = 0;
+
+bool DetectorEnabled = false;
+
+[[nodiscard]] QByteArray CurrentKey() {
+	const auto receiver = DispatchedReceiver.load();
+	const auto event = DispatchedEvent.load();
+	const auto name = QMetaEnum::fromType<QEvent::Type>().valueToKey(event);
+	return QByteArray(receiver ? receiver : "(unknown)")
+		+ ' '
+		+ (name ? QByteArray(name) : QByteArray::number(event));
+}
+
+class Watcher final : public QThread {
+public:
+	Watcher();
+
+	void stop();
+
+protected:
+	void run() override;
+
+private:
+	void record(const QByteArray &key, crl::time duration);
+	void writeReport() const;
+
+	QMutex _mutex;
+	QWaitCondition _condition;
+	base::flat_map<QByteArray, Stats> _stats;
+	QDateTime _started;
+	bool _stopped = false;
+
+};
+
+Watcher::Watcher() : _started(QDateTime::currentDateTime()) {
+	start(QThread::LowPriority);
+}
+
+void Watcher::stop() {
+	{
+		QMutexLocker lock(&_mutex);
+		_stopped = true;
+		_condition.wakeAll();
+	}
+	wait();
+}
+
+void Watcher::run() {
+	auto tracked = crl::time(0);
+	auto longest = crl::time(0);
+	auto key = QByteArray();
+
+	QMutexLocker lock(&_mutex);
+	while (!_stopped) {
+		_condition.wait(&_mutex, kCheckTimeout);
+		const auto since = BusySince.load();
+		if (since != tracked) {
+			if (longest) {
+				record(key, longest);
+			}
+			tracked = since;
+			longest = 0;
+		}
+		if (!tracked) {
+			continue;
+		}
+		const auto duration = crl::now() - tracked;
+		if (duration < kThresholds.front()) {
+			continue;
+		} else if (!longest) {
+			key = CurrentKey();
+		}
+		if (longest < kThresholds.back()
+			&& duration >= kThresholds.back()) {
+			LOG(("Stall Warning: main thread is busy with '%1' for %2 ms."
+				).arg(QString::fromLatin1(key)
+				).arg(duration));
+		}
+		longest = duration;
+	}
+}
+
+void Watcher::record(const QByteArray &key, crl::time duration) {
+	auto &stats = _stats[key];
+	for (auto i = 0; i != kThresholdsCount; ++i) {
+		if (duration >= kThresholds[i]) {
+			++stats.counts[i];
+		}
+	}
+	stats.longest = std::max(stats.longest, duration);
+	writeReport();
+}
+
+void Watcher::writeReport() const {
+	auto sorted = std::vector<std::pair<QByteArray, Stats>>(
+		_stats.begin(),
+		_stats.end());
+	ranges::sort(sorted, ranges::greater(), [](const auto &entry) {
+		return std::make_pair(
+			entry.second.counts.front(),
+			entry.second.longest);
+	});
+
+	auto report = QStringList();
+	auto annotation = QStringList();
+	for (const auto &[key, stats] : sorted) {
+		report.push_back(u"%1: %2 over 100 ms, %3 over 500 ms, "
+			"%4 over 2 s, longest %5 ms"_q
+			.arg(QString::fromLatin1(key))
+			.arg(stats.counts[0])
+			.arg(stats.counts[1])
+			.arg(stats.counts[2])
+			.arg(stats.longest));
+		if (annotation.size() < kAnnotationEntries) {
+			annotation.push_back(u"%1 x%2 max %3"_q
+				.arg(QString::fromLatin1(key))
+				.arg(stats.counts[0])
+				.arg(stats.longest));
+		}
+	}
+	CrashReports::SetAnnotation("Stalls", annotation.join(u"; "_q));
+
+	const auto folder = cWorkingDir() + u"DebugLogs/"_q;
+	QDir().mkpath(folder);
+	auto f = QFile(folder + u"last_stalls.txt"_q);
+	if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+		return;
+	}
+	f.write(u"Main thread stalls since %1:\n\n%2\n"_q.arg(
+		_started.toString(u"yyyy.MM.dd hh:mm:ss"_q),
+		report.join('\n')).toUtf8());
+}
+
+struct State {
+	std::unique_ptr<Watcher> watcher;
+	QMetaObject::Connection awake;
+	QMetaObject::Connection aboutToBlock;
+};
+
+[[nodiscard]] State &GlobalState() {
+	static auto result = State();
+	return result;
+}
+
+} // namespace
+
+void Start() {
+	Expects(!DetectorEnabled);
+
+	const auto dispatcher = QAbstractEventDispatcher::instance();
+	if (!dispatcher) {
+		return;
+	}
+	auto &state = GlobalState();
+	state.awake = QObject::connect(
+		dispatcher,
+		&QAbstractEventDispatcher::awake,
+		[] {
+			// Nested event loops wake up while the outer one is busy.
+			if (!BusySince.load()) {
+				BusySince = crl::now();
+			}
+		});
+	state.aboutToBlock = QObject::connect(
+		dispatcher,
+		&QAbstractEventDispatcher::aboutToBlock,
+		[] { BusySince = 0; });
+	state.watcher = std::make_unique<Watcher>();
+	DetectorEnabled = true;
+}
+
+void Finish() {
+	if (!DetectorEnabled) {
+		return;
+	}
+	DetectorEnabled = false;
+	auto &state = GlobalState();
+	QObject::disconnect(base::take(state.awake));
+	QObject::disconnect(base::take(state.aboutToBlock));
+	state.watcher->stop();
+	state.watcher = nullptr;
+	BusySince = 0;
+}
+
+bool Enabled() {
+	return DetectorEnabled;
+}
+
+void EventDispatched(not_null<QObject*> receiver, not_null<QEvent*> e) {
+	DispatchedReceiver.store(
+		receiver->metaObject()->className(),
+		std::memory_order_relaxed);
+	DispatchedEvent.store(int(e->type()), std::memory_order_relaxed);
+}
+
+} // namespace Core::StallDetector
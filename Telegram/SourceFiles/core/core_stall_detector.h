@@ -0,0 +1,25 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+namespace Core::StallDetector {
+
+// Started with the debug logs enabled. Main thread event loop iterations
+// longer than 100 ms, 500 ms and 2 s are counted for the event that the
+// loop was dispatching and written to DebugLogs/last_stalls.txt and to
+// the crash report annotations.
+void Start();
+void Finish();
+
+[[nodiscard]] bool Enabled();
+
+// Called from Sandbox::notify() for the events dispatched right from
+// the event loop, main thread only.
+void EventDispatched(not_null<QObject*> receiver, not_null<QEvent*> e);
+
+} // namespace Core::StallDetector
@@ -0,0 +1,123 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "core/core_startup_trace.h"
+
+#include "base/flat_map.h"
+
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonObject>
+#include <QtCore/QThread>
+#include <QtCore/QMutex>
+#include <QtCore/QDir>
+
+#include <atomic>
+
+namespace Core::StartupTrace {
+namespace {
+
+struct Event {
+	const char *name = nullptr;
+	crl::profile_time start = 0;
+	crl::profile_time duration = 0;
+	int thread = 0;
+};
+
+struct State {
+	QMutex mutex;
+	std::vector<Event> events;
+	base::flat_map<Qt::HANDLE, int> threads;
+	crl::profile_time started = 0;
+};
+
+std::atomic<bool> TraceEnabled = false;
+
+[[nodiscard]] State &GlobalState() {
+	static auto result = State();
+	return result;
+}
+
+void Write(const State &state) {
+	auto events = QJsonArray();
+	for (const auto &event : state.events) {
+		events.push_back(QJsonObject{
+			{ u"name"_q, QString::fromLatin1(event.name) },
+			{ u"cat"_q, u"startup"_q },
+			{ u"ph"_q, u"X"_q },
+			{ u"ts"_q, double(event.start - state.started) },
+			{ u"dur"_q, double(event.duration) },
+			{ u"pid"_q, 1 },
+			{ u"tid"_q, event.thread },
+		});
+	}
+	const auto folder = cWorkingDir() + u"DebugLogs/"_q;
+	const auto path = folder + u"startup_trace.json"_q;
+	QDir().mkpath(folder);
+	auto f = QFile(path);
+	if (!f.open(QIODevice::WriteOnly)) {
+		LOG(("Startup Trace Error: could not open '%1'.").arg(path));
+		return;
+	}
+	f.write(QJsonDocument(QJsonObject{
+		{ u"traceEvents"_q, events },
+	}).toJson(QJsonDocument::Compact));
+	LOG(("Startup Trace: %1 spans written to '%2'."
+		).arg(state.events.size()
+		).arg(path));
+}
+
+} // namespace
+
+void Start() {
+	auto &state = GlobalState();
+	QMutexLocker lock(&state.mutex);
+	state.started = crl::profile();
+	TraceEnabled = true;
+}
+
+bool Enabled() {
+	return TraceEnabled;
+}
+
+void Finish() {
+	if (!TraceEnabled.exchange(false)) {
+		return;
+	}
+	auto &state = GlobalState();
+	QMutexLocker lock(&state.mutex);
+	Write(state);
+	state.events = std::vector<Event>();
+	state.threads = base::flat_map<Qt::HANDLE, int>();
+}
+
+Span::Span(const char *name)
+: _name(TraceEnabled ? name : nullptr)
+, _start(_name ? crl::profile() : 0) {
+}
+
+Span::~Span() {
+	if (!_name || !TraceEnabled) {
+		return;
+	}
+	const auto duration = crl::profile() - _start;
+	const auto handle = QThread::currentThreadId();
+
+	auto &state = GlobalState();
+	QMutexLocker lock(&state.mutex);
+	const auto i = state.threads.emplace(
+		handle,
+		int(state.threads.size()) + 1).first;
+	state.events.push_back({
+		.name = _name,
+		.start = _start,
+		.duration = duration,
+		.thread = i->second,
+	});
+}
+
+} // namespace Core::StartupTrace
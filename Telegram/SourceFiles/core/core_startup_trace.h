@@ -0,0 +1,35 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include <crl/crl_time.h>
+
+namespace Core::StartupTrace {
+
+// Enabled by the -tracestartup command line argument, the spans are
+// written to DebugLogs/startup_trace.json in the Chrome trace format.
+void Start();
+[[nodiscard]] bool Enabled();
+void Finish();
+
+// The name should be a string literal, it is stored by pointer.
+class Span final {
+public:
+	explicit Span(const char *name);
+	~Span();
+
+	Span(const Span &other) = delete;
+	Span &operator=(const Span &other) = delete;
+
+private:
+	const char *_name = nullptr;
+	crl::profile_time _start = 0;
+
+};
+
+} // namespace Core::StartupTrace
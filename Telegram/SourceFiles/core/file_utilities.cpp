@@ -377,7 +377,7 @@ bool GetDefault(
 		QString path = files.isEmpty() ? QString() : QFileInfo(files.back()).absoluteDir().absolutePath();
 		if (!path.isEmpty() && path != cDialogLastPath()) {
 			cSetDialogLastPath(path);
-			Local::writeSettings();
+			Core::App().saveSettingsDelayed();
 		}
 		return !files.isEmpty();
 	} else if (type == Type::ReadFolder) {
@@ -397,7 +397,7 @@ bool GetDefault(
 		auto path = QFileInfo(file).absoluteDir().absolutePath();
 		if (!path.isEmpty() && path != cDialogLastPath()) {
 			cSetDialogLastPath(path);
-			Local::writeSettings();
+			Core::App().saveSettingsDelayed();
 		}
 	}
 	files = QStringList(file);
@@ -21,6 +21,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "core/local_url_handlers.h"
 #include "core/update_checker.h"
 #include "core/deadlock_detector.h"
+#include "core/core_stall_detector.h"
 #include "base/timer.h"
 #include "base/concurrent_timer.h"
 #include "base/invoke_queued.h"
@@ -196,6 +197,9 @@ void Sandbox::launchApplication() {
 			_deadlockDetector = std::make_unique<PingThread>(this);
 		}
 #endif // !_DEBUG
+		if (Logs::DebugEnabled()) {
+			StallDetector::Start();
+		}
 
 		_application = std::make_unique<Application>();
 
@@ -594,6 +598,10 @@ bool Sandbox::notify(QObject *receiver, QEvent *e) {
 		return notifyOrInvoke(receiver, e);
 	}
 
+	if (_eventNestingLevel == _loopNestingLevel
+		&& StallDetector::Enabled()) {
+		StallDetector::EventDispatched(receiver, e);
+	}
 	const auto wrap = createEventNestingLevel();
 	if (e->type() == QEvent::UpdateRequest) {
 		const auto weak = QPointer<QObject>(receiver);
@@ -650,6 +658,8 @@ void Sandbox::closeApplication() {
 	_localSocket.close();
 
 	_updateChecker = nullptr;
+
+	StallDetector::Finish();
 }
 
 uint64 Sandbox::execExternal(const QString &cmd) {
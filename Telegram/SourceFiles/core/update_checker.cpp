@@ -1173,7 +1173,10 @@ rpl::producer<> Updater::ready() const {
 }
 
 void Updater::check() {
-	start(false);
+	// The scheduled checks may download and unpack a big update.
+	Core::App().runWhenIdle(crl::guard(this, [=] {
+		start(false);
+	}));
 }
 
 void Updater::handleReady() {
@@ -40,15 +40,12 @@ void Factchecks::requestFor(not_null<HistoryItem*> item) {
 	if (const auto factcheck = item->Get<HistoryMessageFactcheck>()) {
 		factcheck->requested = true;
 	}
-	if (!_requestTimer.isActive()) {
-		_requestTimer.callOnce(kRequestDelay);
-	}
-	const auto changed = !_pending.empty()
-		&& (_pending.front()->history() != item->history());
-	const auto added = _pending.emplace(item).second;
-	if (changed) {
-		request();
-	} else if (added && _pending.size() == 1) {
+	// Items of different chats wait for the same timer, so browsing
+	// through many channels doesn't send a request for each of them.
+	const auto history = item->history();
+	_lastHistory = history;
+	if (_pending[history].emplace(item).second
+		&& !_requestTimer.isActive()) {
 		_requestTimer.callOnce(kRequestDelay);
 	}
 }
@@ -61,7 +58,12 @@ void Factchecks::subscribeIfNotYet() {
 
 	_session->data().itemRemoved(
 	) | rpl::start_with_next([=](not_null<const HistoryItem*> item) {
-		_pending.remove(item);
+		const auto j = _pending.find(item->history());
+		if (j != end(_pending)
+			&& j->second.remove(item)
+			&& j->second.empty()) {
+			_pending.erase(j);
+		}
 		const auto i = ranges::find(_requested, item.get());
 		if (i != end(_requested)) {
 			*i = nullptr;
@@ -77,18 +79,20 @@ void Factchecks::request() {
 	}
 	_session->api().request(base::take(_requestId)).cancel();
 
+	// The chat that was painted last is most likely the visible one.
+	const auto last = _lastHistory
+		? _pending.find(_lastHistory)
+		: end(_pending);
+	const auto i = (last != end(_pending)) ? last : begin(_pending);
+	const auto history = i->first;
+	const auto items = std::move(i->second);
+	_pending.erase(i);
+
 	auto ids = QVector<MTPint>();
-	ids.reserve(_pending.size());
-	const auto history = _pending.front()->history();
-	for (auto i = begin(_pending); i != end(_pending);) {
-		const auto &item = *i;
-		if (item->history() == history) {
-			_requested.push_back(item);
-			ids.push_back(MTP_int(item->id.bare));
-			i = _pending.erase(i);
-		} else {
-			++i;
-		}
+	ids.reserve(items.size());
+	for (const auto &item : items) {
+		_requested.push_back(item);
+		ids.push_back(MTP_int(item->id.bare));
 	}
 	_requestId = _session->api().request(MTPmessages_GetFactCheck(
 		history->peer->input,
@@ -9,6 +9,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include "base/timer.h"
 
+class History;
 class HistoryItem;
 struct HistoryMessageFactcheck;
 
@@ -58,7 +59,10 @@ private:
 	const not_null<Main::Session*> _session;
 
 	base::Timer _requestTimer;
-	base::flat_set<not_null<HistoryItem*>> _pending;
+	base::flat_map<
+		not_null<History*>,
+		base::flat_set<not_null<HistoryItem*>>> _pending;
+	History *_lastHistory = nullptr;
 	std::vector<HistoryItem*> _requested;
 	mtpRequestId _requestId = 0;
 	bool _subscribed = false;
@@ -165,7 +165,16 @@ HistoryItem *ScheduledMessages::lookupItem(PeerId peer, MsgId msg) const {
 		return nullptr;
 	}
 
-	const auto &items = i->second.items;
+	const auto &list = i->second;
+	if (IsScheduledMsgId(msg)) {
+		const auto j = list.itemById.find(LocalToRemoteMsgId(msg));
+		if (j != end(list.itemById) && j->second->id == msg) {
+			return j->second;
+		}
+	}
+
+	// Messages that are being sent are not in the index yet.
+	const auto &items = list.items;
 	const auto j = ranges::find_if(items, [&](auto &item) {
 		return item->id == msg;
 	});
@@ -343,6 +352,7 @@ void ScheduledMessages::apply(
 	if (i == end(_data)) {
 		return;
 	}
+	_updatesSuspended = true;
 	for (const auto &id : update.vmessages().v) {
 		const auto &list = i->second;
 		const auto j = list.itemById.find(id.v);
@@ -354,6 +364,7 @@ void ScheduledMessages::apply(
 			}
 		}
 	}
+	_updatesSuspended = false;
 	_updates.fire_copy(history);
 }
 
@@ -579,9 +590,11 @@ void ScheduledMessages::updated(
 		const base::flat_set<not_null<HistoryItem*>> &added,
 		const base::flat_set<not_null<HistoryItem*>> &clear) {
 	if (!clear.empty()) {
+		_updatesSuspended = true;
 		for (const auto &item : clear) {
 			item->destroy();
 		}
+		_updatesSuspended = false;
 	}
 	const auto i = _data.find(history);
 	if (i != end(_data)) {
@@ -613,7 +626,9 @@ void ScheduledMessages::remove(not_null<const HistoryItem*> item) {
 	if (list.items.empty()) {
 		_data.erase(i);
 	}
-	_updates.fire_copy(history);
+	if (!_updatesSuspended) {
+		_updates.fire_copy(history);
+	}
 }
 
 uint64 ScheduledMessages::countListHash(const List &list) const {
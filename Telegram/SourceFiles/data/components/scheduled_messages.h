@@ -93,6 +93,10 @@ private:
 	base::flat_map<not_null<History*>, Request> _requests;
 	rpl::event_stream<not_null<History*>> _updates;
 
+	// When many messages are destroyed at once the update is fired once,
+	// instead of rebuilding the shown list after each of them.
+	bool _updatesSuspended = false;
+
 	rpl::lifetime _lifetime;
 
 };
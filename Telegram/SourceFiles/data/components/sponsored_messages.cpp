@@ -446,7 +446,7 @@ void SponsoredMessages::view(const FullMsgId &fullId) {
 		request.requestId = 0;
 	}).fail([=] {
 		_viewRequests.remove(randomId);
-	}).send();
+	}).afterDelay(MTP::kBackgroundRequestDelay).send();
 }
 
 SponsoredMessages::Details SponsoredMessages::lookupDetails(
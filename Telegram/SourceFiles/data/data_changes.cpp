@@ -7,15 +7,31 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #include "data/data_changes.h"
 
+#include "base/options.h"
 #include "main/main_session.h"
 
 namespace Data {
+namespace {
+
+constexpr auto kFrameDuration = crl::time(16);
+
+base::options::toggle OptionFrameAlignedChanges({
+	.id = kOptionFrameAlignedChanges,
+	.name = "Frame aligned data updates",
+	.description = "Send the merged data change notifications not more "
+		"often than once in an animation frame.",
+});
+
+} // namespace
+
+const char kOptionFrameAlignedChanges[] = "frame-aligned-changes";
 
 template <typename DataType, typename UpdateType>
 void Changes::Manager<DataType, UpdateType>::updated(
 		not_null<DataType*> data,
 		Flags flags,
 		bool dropScheduled) {
+	++_updatedCount;
 	sendRealtimeNotifications(data, flags);
 	if (dropScheduled) {
 		const auto i = _updates.find(data);
@@ -88,7 +104,9 @@ void Changes::Manager<DataType, UpdateType>::sendNotifications() {
 	}
 }
 
-Changes::Changes(not_null<Main::Session*> session) : _session(session) {
+Changes::Changes(not_null<Main::Session*> session)
+: _session(session)
+, _notifyTimer([=] { sendNotifications(); }) {
 }
 
 Main::Session &Changes::session() const {
@@ -305,12 +323,20 @@ rpl::producer<StoryUpdate> Changes::realtimeStoryUpdates(
 }
 
 void Changes::scheduleNotifications() {
-	if (!_notify) {
-		_notify = true;
-		crl::on_main(&session(), [=] {
-			sendNotifications();
-		});
+	if (_notify) {
+		return;
 	}
+	_notify = true;
+	if (OptionFrameAlignedChanges.value()) {
+		const auto passed = crl::now() - _notifiedAt;
+		if (passed >= 0 && passed < kFrameDuration) {
+			_notifyTimer.callOnce(kFrameDuration - passed);
+			return;
+		}
+	}
+	crl::on_main(&session(), [=] {
+		sendNotifications();
+	});
 }
 
 void Changes::sendNotifications() {
@@ -318,6 +344,8 @@ void Changes::sendNotifications() {
 		return;
 	}
 	_notify = false;
+	_notifyTimer.cancel();
+	_notifiedAt = crl::now();
 	_peerChanges.sendNotifications();
 	_historyChanges.sendNotifications();
 	_messageChanges.sendNotifications();
@@ -326,4 +354,13 @@ void Changes::sendNotifications() {
 	_storyChanges.sendNotifications();
 }
 
+int64 Changes::updatedCount() const {
+	return _peerChanges.updatedCount()
+		+ _historyChanges.updatedCount()
+		+ _messageChanges.updatedCount()
+		+ _entryChanges.updatedCount()
+		+ _topicChanges.updatedCount()
+		+ _storyChanges.updatedCount();
+}
+
 } // namespace Data
@@ -8,6 +8,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #pragma once
 
 #include "base/flags.h"
+#include "base/timer.h"
 
 class History;
 class PeerData;
@@ -245,6 +246,11 @@ struct StoryUpdate {
 
 };
 
+extern const char kOptionFrameAlignedChanges[];
+
+// Updates are merged by flags for each object and are sent together,
+// realtime updates are sent right away. With the frame aligned option
+// merged updates are sent not more often than once in an animation frame.
 class Changes final {
 public:
 	explicit Changes(not_null<Main::Session*> session);
@@ -344,6 +350,9 @@ public:
 
 	void sendNotifications();
 
+	// Count of the *Updated() calls, for the updates recorder.
+	[[nodiscard]] int64 updatedCount() const;
+
 private:
 	template <typename DataType, typename UpdateType>
 	class Manager final {
@@ -369,6 +378,10 @@ private:
 
 		void sendNotifications();
 
+		[[nodiscard]] int64 updatedCount() const {
+			return _updatedCount;
+		}
+
 	private:
 		static constexpr auto kCount = details::CountBit<Flag>() + 1;
 
@@ -379,6 +392,7 @@ private:
 		std::array<rpl::event_stream<UpdateType>, kCount> _realtimeStreams;
 		base::flat_map<not_null<DataType*>, Flags> _updates;
 		rpl::event_stream<UpdateType> _stream;
+		int64 _updatedCount = 0;
 
 	};
 
@@ -394,6 +408,8 @@ private:
 	Manager<Dialogs::Entry, EntryUpdate> _entryChanges;
 	Manager<Story, StoryUpdate> _storyChanges;
 
+	base::Timer _notifyTimer;
+	crl::time _notifiedAt = 0;
 	bool _notify = false;
 
 };
@@ -105,7 +105,7 @@ QString FileNameUnsafe(
 			QString path = dir.absolutePath();
 			if (path != cDialogLastPath()) {
 				cSetDialogLastPath(path);
-				Local::writeSettings();
+				Core::App().saveSettingsDelayed();
 			}
 		}
 
@@ -526,7 +526,7 @@ void DocumentData::setDataAndCache(const QByteArray &data) {
 		media->setBytes(data);
 	}
 	if (saveToCache() && data.size() <= Storage::kMaxFileInMemory) {
-		owner().cache().put(
+		owner().cacheFor(cacheTag(), data.size()).put(
 			cacheKey(),
 			Storage::Cache::Database::TaggedValue(
 				base::duplicate(data),
@@ -1025,6 +1025,9 @@ void DocumentData::save(
 		if (fromCloud == LoadFromCloudOrLocal) {
 			_loader->permitLoadFromCloud();
 		}
+		if (!autoLoading) {
+			_loader->setAutoLoading(false);
+		}
 	} else {
 		status = FileReady;
 		auto reader = owner().streaming().sharedReader(this, origin, true);
@@ -1738,7 +1741,9 @@ void DocumentData::collectLocalData(not_null<DocumentData*> local) {
 		return;
 	}
 
-	_owner->cache().copyIfEmpty(local->cacheKey(), cacheKey());
+	_owner->cacheFor(cacheTag(), size).copyIfEmpty(
+		local->cacheKey(),
+		cacheKey());
 	if (const auto localMedia = local->activeMediaView()) {
 		auto media = createMediaView();
 		media->collectLocalData(localMedia.get());
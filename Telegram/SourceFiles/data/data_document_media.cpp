@@ -358,6 +358,20 @@ float64 DocumentMedia::progress() const {
 		: (loaded() ? 1. : 0.);
 }
 
+int64 DocumentMedia::memoryBytes() const {
+	auto result = int64(_bytes.size() + _videoThumbnailBytes.size());
+	for (const auto image : {
+			_goodThumbnail.get(),
+			_inlineThumbnail.get(),
+			_thumbnail.get(),
+			_sticker.get() }) {
+		if (image) {
+			result += image->memoryBytes();
+		}
+	}
+	return result;
+}
+
 bool DocumentMedia::canBePlayed(HistoryItem *item) const {
 	return !_owner->inappPlaybackFailed()
 		&& _owner->useStreamingLoader()
@@ -43,6 +43,7 @@ namespace {
 constexpr auto kClearLoadingTimeout = 5 * crl::time(1000);
 constexpr auto kMaxFileSize = 4000 * int64(1024 * 1024);
 constexpr auto kMaxResolvePerAttempt = 100;
+constexpr auto kResolveNextDelay = crl::time(200);
 
 constexpr auto ByItem = [](const auto &entry) {
 	if constexpr (std::is_same_v<decltype(entry), const DownloadingId&>) {
@@ -119,7 +120,8 @@ struct DownloadManager::DeleteFilesDescriptor {
 };
 
 DownloadManager::DownloadManager()
-: _clearLoadingTimer([=] { clearLoading(); }) {
+: _clearLoadingTimer([=] { clearLoading(); })
+, _resolveNextTimer([=] { resolveNext(); }) {
 }
 
 DownloadManager::~DownloadManager() = default;
@@ -729,9 +731,20 @@ void DownloadManager::resolveRequestsFinished(
 		}
 		_loadedAdded.fire(&*i);
 	}
-	crl::on_main(session, [=] {
-		resolve(session, sessionData(session));
-	});
+
+	// Give the main thread some rest between the batches,
+	// each of them checks the files and fills the downloads section.
+	if (!_resolveNextTimer.isActive()) {
+		_resolveNextTimer.callOnce(kResolveNextDelay);
+	}
+}
+
+void DownloadManager::resolveNext() {
+	for (auto &[session, data] : _sessions) {
+		if (!data.resolveSentTotal && !data.resolveSentRequests) {
+			resolve(session, data);
+		}
+	}
 }
 
 void DownloadManager::checkFullResolveDone() {
@@ -156,6 +156,7 @@ private:
 	void resolveRequestsFinished(
 		not_null<Main::Session*> session,
 		SessionData &data);
+	void resolveNext();
 	void checkFullResolveDone();
 
 	[[nodiscard]] not_null<HistoryItem*> regenerateItem(
@@ -198,6 +199,7 @@ private:
 	rpl::variable<bool> _loadedResolveDone;
 
 	base::Timer _clearLoadingTimer;
+	base::Timer _resolveNextTimer;
 
 };
 
@@ -36,7 +36,11 @@ namespace {
 
 constexpr auto kTopicsFirstLoad = 20;
 constexpr auto kLoadedTopicsMinCount = 20;
-constexpr auto kTopicsPerPage = 500;
+
+// Next pages are requested by the chats list when it is scrolled close to
+// the end, so keep them small enough to be applied in a single frame.
+constexpr auto kTopicsPerPage = 100;
+
 constexpr auto kStalePerRequest = 100;
 constexpr auto kShowTopicNamesCount = 8;
 // constexpr auto kGeneralColorId = 0xA9A9A9;
@@ -16,15 +16,19 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_folder.h"
 #include "data/data_forum.h"
 #include "data/data_forum_topic.h"
+#include "data/data_replies_list.h"
 #include "data/data_user.h"
+#include "base/options.h"
 #include "base/unixtime.h"
 #include "base/random.h"
 #include "main/main_session.h"
 #include "window/notifications_manager.h"
+#include "window/window_session_controller.h"
 #include "history/history.h"
 #include "history/history_item.h"
 #include "history/history_item_helpers.h"
 #include "history/view/history_view_element.h"
+#include "storage/cache/storage_cache_database.h"
 #include "core/application.h"
 #include "apiwrap.h"
 
@@ -32,9 +36,73 @@ namespace Data {
 namespace {
 
 constexpr auto kReadRequestTimeout = 3 * crl::time(1000);
+constexpr auto kReadRequestsBatchWindow = crl::time(1000);
+constexpr auto kCachedHistoryMaxSize = 512 * 1024;
+constexpr auto kUnloadColdCheckPeriod = 60 * crl::time(1000);
+constexpr auto kColdHistoryTimeout = 10 * 60 * crl::time(1000);
+constexpr auto kLoadedViewsBudget = 20'000;
+constexpr auto kMaxBackgroundHistoryRequests = 8;
+constexpr auto kRecentlyVisitedTimeout = 5 * 60 * crl::time(1000);
+constexpr auto kKeptRepliesLists = 8;
+
+base::options::toggle OptionCacheChatHistory({
+	.id = kOptionCacheChatHistory,
+	.name = "Cache recently opened chats",
+	.description = "Keep the last page of recently opened chats in the "
+		"local cache and show it until the chat is loaded from the server.",
+});
+
+base::options::toggle OptionUnloadColdHistories({
+	.id = kOptionUnloadColdHistories,
+	.name = "Unload chats not opened recently",
+	.description = "Free the loaded messages of chats that were not opened "
+		"for ten minutes when too many messages are loaded.",
+});
+
+[[nodiscard]] QByteArray SerializeCachedHistory(
+		const MTPmessages_Messages &result) {
+	// Only the messages and the peers they reference are kept,
+	// the channel pts and the topics always come from the server.
+	const auto cached = result.match([](
+			const MTPDmessages_messagesNotModified &) {
+		return std::optional<MTPmessages_Messages>();
+	}, [](const auto &data) {
+		return std::make_optional(MTP_messages_messages(
+			data.vmessages(),
+			data.vchats(),
+			data.vusers()));
+	});
+	if (!cached) {
+		return QByteArray();
+	}
+	auto buffer = mtpBuffer();
+	cached->write(buffer);
+	return QByteArray(
+		reinterpret_cast<const char*>(buffer.constData()),
+		buffer.size() * sizeof(mtpPrime));
+}
+
+[[nodiscard]] std::optional<MTPmessages_Messages> DeserializeCachedHistory(
+		const QByteArray &bytes) {
+	if (bytes.isEmpty() || (bytes.size() % sizeof(mtpPrime))) {
+		return std::nullopt;
+	}
+	auto from = reinterpret_cast<const mtpPrime*>(bytes.constData());
+	const auto till = from + (bytes.size() / sizeof(mtpPrime));
+	auto result = MTPmessages_Messages();
+	if (!result.read(from, till)
+		|| (from != till)
+		|| (result.type() != mtpc_messages_messages)) {
+		return std::nullopt;
+	}
+	return result;
+}
 
 } // namespace
 
+const char kOptionCacheChatHistory[] = "cache-chat-history";
+const char kOptionUnloadColdHistories[] = "unload-cold-histories";
+
 MTPInputReplyTo ReplyToForMTP(
 		not_null<History*> history,
 		FullReplyTo replyTo) {
@@ -100,7 +168,9 @@ MTPInputMedia WebPageForMTP(
 
 Histories::Histories(not_null<Session*> owner)
 : _owner(owner)
-, _readRequestsTimer([=] { sendReadRequests(); }) {
+, _readRequestsTimer([=] { sendReadRequests(); })
+, _unloadColdTimer([=] { unloadColdHistories(); }) {
+	_unloadColdTimer.callEach(kUnloadColdCheckPeriod);
 }
 
 Session &Histories::owner() const {
@@ -129,12 +199,16 @@ not_null<History*> Histories::findOrCreate(PeerId peerId) {
 }
 
 void Histories::unloadAll() {
+	forgetRepliesLists(nullptr);
 	for (const auto &[peerId, history] : _map) {
 		history->clear(History::ClearType::Unload);
 	}
 }
 
 void Histories::clearAll() {
+	_queuedHistoryRequests.clear();
+	_visited.clear();
+	forgetRepliesLists(nullptr);
 	_map.clear();
 }
 
@@ -553,6 +627,218 @@ void Histories::requestGroupAround(not_null<HistoryItem*> item) {
 		ChatListGroupRequest{ .aroundId = id, .requestId = requestId });
 }
 
+void Histories::requestCachedHistory(
+		not_null<History*> history,
+		Fn<void(const MTPmessages_Messages&)> done) {
+	Expects(done != nullptr);
+
+	if (!OptionCacheChatHistory.value()) {
+		return;
+	}
+	const auto peerId = history->peer->id;
+	const auto session = &this->session();
+	_owner->cache().get(HistoryCacheKey(peerId), [=](QByteArray &&value) {
+		auto cached = DeserializeCachedHistory(value);
+		if (!cached) {
+			return;
+		}
+		crl::on_main(session, [=, cached = std::move(*cached)] {
+			if (find(peerId)) {
+				done(dropLoadedPeers(cached.c_messages_messages()));
+			}
+		});
+	});
+}
+
+void Histories::cacheHistory(
+		not_null<History*> history,
+		const MTPmessages_Messages &result) {
+	if (!OptionCacheChatHistory.value()) {
+		return;
+	}
+	auto bytes = SerializeCachedHistory(result);
+	if (bytes.isEmpty() || bytes.size() > kCachedHistoryMaxSize) {
+		return;
+	}
+	_owner->cache().put(
+		HistoryCacheKey(history->peer->id),
+		Storage::Cache::Database::TaggedValue(
+			std::move(bytes),
+			kMessagesCacheTag));
+}
+
+void Histories::forgetCachedHistory(not_null<History*> history) {
+	_owner->cache().remove(HistoryCacheKey(history->peer->id));
+}
+
+void Histories::historyVisited(not_null<History*> history) {
+	_visited[history] = crl::now();
+	sendQueuedHistoryRequests();
+}
+
+int Histories::loadedViewsCount() const {
+	auto result = 0;
+	for (const auto &[peerId, history] : _map) {
+		for (const auto &block : history->blocks) {
+			result += int(block->messages.size());
+		}
+	}
+	return result;
+}
+
+int Histories::LoadedViewsBudget() {
+	return kLoadedViewsBudget;
+}
+
+base::flat_set<not_null<History*>> Histories::shownHistories() const {
+	auto result = base::flat_set<not_null<History*>>();
+	const auto add = [&](History *history) {
+		if (history) {
+			result.emplace(history);
+			if (const auto from = history->peer->migrateFrom()) {
+				if (const auto migrated = _owner->historyLoaded(from)) {
+					result.emplace(migrated);
+				}
+			}
+			if (const auto to = history->peer->migrateTo()) {
+				if (const auto migrated = _owner->historyLoaded(to)) {
+					result.emplace(migrated);
+				}
+			}
+		}
+	};
+	for (const auto &window : session().windows()) {
+		add(window->activeChatCurrent().owningHistory());
+	}
+	return result;
+}
+
+void Histories::unloadColdHistories() {
+	if (!OptionUnloadColdHistories.value()) {
+		return;
+	}
+	auto loaded = loadedViewsCount();
+	if (loaded <= kLoadedViewsBudget) {
+		return;
+	}
+	const auto now = crl::now();
+	const auto shown = shownHistories();
+	auto cold = std::vector<std::pair<crl::time, not_null<History*>>>();
+	for (const auto &[peerId, history] : _map) {
+		const auto raw = history.get();
+		if (raw->blocks.empty() || shown.contains(raw)) {
+			continue;
+		}
+		const auto i = _visited.find(raw);
+		const auto visited = (i != end(_visited)) ? i->second : 0;
+		if (visited + kColdHistoryTimeout < now) {
+			cold.emplace_back(visited, raw);
+		}
+	}
+	ranges::sort(cold, ranges::less(), [](const auto &pair) {
+		return pair.first;
+	});
+	const auto was = loaded;
+	auto unloaded = 0;
+	for (const auto &[visited, history] : cold) {
+		if (loaded <= kLoadedViewsBudget) {
+			break;
+		}
+		for (const auto &block : history->blocks) {
+			loaded -= int(block->messages.size());
+		}
+		forgetRepliesLists(history);
+		history->clear(History::ClearType::Unload);
+		_visited.remove(history);
+		++unloaded;
+	}
+	DEBUG_LOG(("Histories: Unloaded %1 cold chats, views %2 -> %3."
+		).arg(unloaded
+		).arg(was
+		).arg(loaded));
+}
+
+std::shared_ptr<RepliesList> Histories::repliesList(
+		not_null<History*> history,
+		MsgId rootId) {
+	auto &weak = _repliesLists[{ history, rootId }];
+	auto result = weak.lock();
+	if (result) {
+		_recentRepliesLists.erase(
+			ranges::remove(_recentRepliesLists, result),
+			end(_recentRepliesLists));
+	} else {
+		result = std::make_shared<RepliesList>(history, rootId);
+		weak = result;
+	}
+	_recentRepliesLists.push_back(result);
+	if (int(_recentRepliesLists.size()) > kKeptRepliesLists) {
+		_recentRepliesLists.erase(begin(_recentRepliesLists));
+		for (auto i = begin(_repliesLists); i != end(_repliesLists);) {
+			if (i->second.expired()) {
+				i = _repliesLists.erase(i);
+			} else {
+				++i;
+			}
+		}
+	}
+	return result;
+}
+
+void Histories::forgetRepliesLists(History *history) {
+	// Unloaded messages are removed from the lists one by one,
+	// so a kept list would lose its loaded range anyway.
+	auto removed = std::vector<std::shared_ptr<RepliesList>>();
+	for (auto i = begin(_repliesLists); i != end(_repliesLists);) {
+		if (!history || i->first.first == history) {
+			if (const auto strong = i->second.lock()) {
+				removed.push_back(strong);
+			}
+			i = _repliesLists.erase(i);
+		} else {
+			++i;
+		}
+	}
+	for (const auto &list : removed) {
+		_recentRepliesLists.erase(
+			ranges::remove(_recentRepliesLists, list),
+			end(_recentRepliesLists));
+	}
+}
+
+MTPmessages_Messages Histories::dropLoadedPeers(
+		const MTPDmessages_messages &data) const {
+	// Peers that are loaded already are newer than the cached ones.
+	auto chats = QVector<MTPChat>();
+	chats.reserve(data.vchats().v.size());
+	for (const auto &chat : data.vchats().v) {
+		const auto peerId = chat.match([](const MTPDchannel &data) {
+			return peerFromChannel(data.vid().v);
+		}, [](const MTPDchannelForbidden &data) {
+			return peerFromChannel(data.vid().v);
+		}, [](const auto &data) {
+			return peerFromChat(data.vid().v);
+		});
+		if (!_owner->peerLoaded(peerId)) {
+			chats.push_back(chat);
+		}
+	}
+	auto users = QVector<MTPUser>();
+	users.reserve(data.vusers().v.size());
+	for (const auto &user : data.vusers().v) {
+		const auto peerId = user.match([](const auto &data) {
+			return peerFromUser(data.vid().v);
+		});
+		if (!_owner->peerLoaded(peerId)) {
+			users.push_back(user);
+		}
+	}
+	return MTP_messages_messages(
+		data.vmessages(),
+		MTP_vector<MTPChat>(std::move(chats)),
+		MTP_vector<MTPUser>(std::move(users)));
+}
+
 void Histories::sendPendingReadInbox(not_null<History*> history) {
 	if (const auto state = lookup(history)) {
 		DEBUG_LOG(("Reading: send pending now with till %1 and when %2"
@@ -565,18 +851,50 @@ void Histories::sendPendingReadInbox(not_null<History*> history) {
 	}
 }
 
+void Histories::scheduleReadDiscussion(
+		not_null<RepliesList*> replies,
+		crl::time delay) {
+	const auto when = crl::now() + delay;
+	const auto i = _readDiscussions.find(replies);
+	if (i != end(_readDiscussions) && i->second <= when) {
+		return;
+	}
+	_readDiscussions[replies] = when;
+	if (!_readRequestsTimer.isActive()
+		|| _readRequestsTimer.remainingTime() > delay) {
+		_readRequestsTimer.callOnce(delay);
+	}
+}
+
+bool Histories::readDiscussionScheduled(
+		not_null<RepliesList*> replies) const {
+	return _readDiscussions.contains(replies);
+}
+
+bool Histories::cancelReadDiscussion(not_null<RepliesList*> replies) {
+	return _readDiscussions.remove(replies);
+}
+
 void Histories::sendReadRequests() {
 	DEBUG_LOG(("Reading: send requests with count %1.").arg(_states.size()));
-	if (_states.empty()) {
+	if (_states.empty() && _readDiscussions.empty()) {
 		return;
 	}
 	const auto now = crl::now();
+
+	// Whatever is due soon goes with the due ones in the same container.
+	const auto due = ranges::any_of(_states, [&](const auto &pair) {
+		return pair.second.willReadTill && (pair.second.willReadWhen <= now);
+	}) || ranges::any_of(_readDiscussions, [&](const auto &pair) {
+		return (pair.second <= now);
+	});
+	const auto sendTill = due ? (now + kReadRequestsBatchWindow) : now;
 	auto next = std::optional<crl::time>();
 	for (auto &[history, state] : _states) {
 		if (!state.willReadTill) {
 			DEBUG_LOG(("Reading: skipping zero till."));
 			continue;
-		} else if (state.willReadWhen <= now) {
+		} else if (state.willReadWhen <= sendTill) {
 			DEBUG_LOG(("Reading: sending with till %1."
 				).arg(state.willReadTill.bare));
 			sendReadRequest(history, state);
@@ -585,11 +903,26 @@ void Histories::sendReadRequests() {
 			next = state.willReadWhen;
 		}
 	}
+	auto readDiscussions = std::vector<not_null<RepliesList*>>();
+	for (auto i = begin(_readDiscussions); i != end(_readDiscussions);) {
+		if (i->second <= sendTill) {
+			readDiscussions.push_back(i->first);
+			i = _readDiscussions.erase(i);
+		} else {
+			if (!next || *next > i->second) {
+				next = i->second;
+			}
+			++i;
+		}
+	}
 	if (next.has_value()) {
 		_readRequestsTimer.callOnce(*next - now);
 	} else {
 		_readRequestsTimer.cancel();
 	}
+	for (const auto replies : readDiscussions) {
+		replies->sendReadTillRequest();
+	}
 }
 
 void Histories::sendReadRequest(not_null<History*> history, State &state) {
@@ -624,7 +957,9 @@ void Histories::sendReadRequest(not_null<History*> history, State &state) {
 			return session().api().request(MTPchannels_ReadHistory(
 				channel->inputChannel,
 				MTP_int(tillId)
-			)).done(finished).fail(finished).send();
+			)).done(finished).fail(finished).afterDelay(
+				MTP::kBackgroundRequestDelay
+			).send();
 		} else {
 			return session().api().request(MTPmessages_ReadHistory(
 				history->peer->input,
@@ -634,7 +969,7 @@ void Histories::sendReadRequest(not_null<History*> history, State &state) {
 				finished();
 			}).fail([=] {
 				finished();
-			}).send();
+			}).afterDelay(MTP::kBackgroundRequestDelay).send();
 		}
 	});
 }
@@ -661,6 +996,21 @@ bool Histories::postponeHistoryRequest(const State &state) const {
 	return (i != end(state.sent));
 }
 
+int Histories::historyRequestPriority(
+		not_null<History*> history,
+		const base::flat_set<not_null<History*>> &shown,
+		crl::time now) const {
+	if (shown.contains(history)) {
+		return 0;
+	} else if (history->isPinnedDialog(FilterId())) {
+		return 1;
+	}
+	const auto i = _visited.find(history);
+	return (i != end(_visited) && now - i->second < kRecentlyVisitedTimeout)
+		? 2
+		: 3;
+}
+
 bool Histories::postponeEntryRequest(const State &state) const {
 	return ranges::any_of(state.sent, [](const auto &pair) {
 		return pair.second.type != RequestType::History;
@@ -898,10 +1248,20 @@ int Histories::sendRequest(
 	auto &state = _states[history];
 	const auto id = ++_requestAutoincrement;
 	_historyByRequest.emplace(id, history);
-	if (type == RequestType::History && postponeHistoryRequest(state)) {
-		state.postponed.emplace(
-			id,
-			PostponedHistoryRequest{ std::move(generator) });
+	if (type == RequestType::History) {
+		if (postponeHistoryRequest(state)) {
+			state.postponed.emplace(
+				id,
+				PostponedHistoryRequest{ std::move(generator) });
+		} else if (shownHistories().contains(history)) {
+			sendHistoryRequest(history, state, id, std::move(generator), false);
+		} else if (_backgroundHistoryRequests < kMaxBackgroundHistoryRequests) {
+			sendHistoryRequest(history, state, id, std::move(generator), true);
+		} else {
+			_queuedHistoryRequests.emplace(
+				id,
+				QueuedHistoryRequest{ history, std::move(generator) });
+		}
 		return id;
 	}
 	const auto requestId = generator([=] { checkPostponed(history, id); });
@@ -920,6 +1280,8 @@ int Histories::sendRequest(
 			auto &[id, sent] = pair;
 			if (sent.type != RequestType::History) {
 				return false;
+			} else if (sent.background) {
+				--_backgroundHistoryRequests;
 			}
 			state.postponed.emplace(
 				id,
@@ -930,10 +1292,67 @@ int Histories::sendRequest(
 		state.sent.erase(
 			ranges::remove_if(state.sent, resendHistoryRequest),
 			end(state.sent));
+		sendQueuedHistoryRequests();
 	}
 	return id;
 }
 
+void Histories::sendHistoryRequest(
+		not_null<History*> history,
+		State &state,
+		int id,
+		Fn<mtpRequestId(Fn<void()> finish)> generator,
+		bool background) {
+	if (background) {
+		++_backgroundHistoryRequests;
+	}
+	const auto requestId = generator([=] { checkPostponed(history, id); });
+	state.sent.emplace(id, SentRequest{
+		std::move(generator),
+		requestId,
+		RequestType::History,
+		background,
+	});
+}
+
+void Histories::sendQueuedHistoryRequests() {
+	if (_queuedHistoryRequests.empty()) {
+		return;
+	}
+	const auto shown = shownHistories();
+	const auto now = crl::now();
+	while (!_queuedHistoryRequests.empty()) {
+		const auto i = ranges::min_element(
+			_queuedHistoryRequests,
+			ranges::less(),
+			[&](const auto &pair) {
+				return historyRequestPriority(pair.second.history, shown, now);
+			});
+		const auto interactive = shown.contains(i->second.history);
+		if (!interactive
+			&& _backgroundHistoryRequests >= kMaxBackgroundHistoryRequests) {
+			break;
+		}
+		const auto id = i->first;
+		auto queued = std::move(i->second);
+		_queuedHistoryRequests.erase(i);
+
+		auto &state = _states[queued.history];
+		if (postponeHistoryRequest(state)) {
+			state.postponed.emplace(
+				id,
+				PostponedHistoryRequest{ std::move(queued.generator) });
+		} else {
+			sendHistoryRequest(
+				queued.history,
+				state,
+				id,
+				std::move(queued.generator),
+				!interactive);
+		}
+	}
+}
+
 void Histories::sendCreateTopicRequest(
 		not_null<History*> history,
 		MsgId rootId) {
@@ -1109,6 +1528,7 @@ void Histories::cancelRequest(int id) {
 	if (!history) {
 		return;
 	}
+	_queuedHistoryRequests.remove(id);
 	const auto state = lookup(*history);
 	if (!state) {
 		return;
@@ -1132,10 +1552,15 @@ void Histories::finishSentRequest(
 		int id) {
 	_historyByRequest.remove(id);
 	const auto i = state->sent.find(id);
+	const auto background = (i != end(state->sent))
+		&& i->second.background;
 	if (i != end(state->sent)) {
 		session().api().request(i->second.id).cancel();
 		state->sent.erase(i);
 	}
+	if (background) {
+		--_backgroundHistoryRequests;
+	}
 	if (!state->postponed.empty() && !postponeHistoryRequest(*state)) {
 		for (auto &[id, postponed] : base::take(state->postponed)) {
 			const auto requestId = postponed.generator([=, id=id] {
@@ -1160,6 +1585,9 @@ void Histories::finishSentRequest(
 		postponeRequestDialogEntries();
 	}
 	checkEmptyState(history);
+	if (background) {
+		sendQueuedHistoryRequests();
+	}
 }
 
 Histories::State *Histories::lookup(not_null<History*> history) {
@@ -25,8 +25,12 @@ namespace Data {
 
 class Session;
 class Folder;
+class RepliesList;
 struct WebPageDraft;
 
+extern const char kOptionCacheChatHistory[];
+extern const char kOptionUnloadColdHistories[];
+
 [[nodiscard]] MTPInputReplyTo ReplyToForMTP(
 	not_null<History*> history,
 	FullReplyTo replyTo);
@@ -64,6 +68,14 @@ public:
 	void readClientSideMessage(not_null<HistoryItem*> item);
 	void sendPendingReadInbox(not_null<History*> history);
 
+	// Sent together with the pending chats read requests.
+	void scheduleReadDiscussion(
+		not_null<RepliesList*> replies,
+		crl::time delay);
+	[[nodiscard]] bool readDiscussionScheduled(
+		not_null<RepliesList*> replies) const;
+	bool cancelReadDiscussion(not_null<RepliesList*> replies);
+
 	void requestDialogEntry(not_null<Data::Folder*> folder);
 	void requestDialogEntry(
 		not_null<History*> history,
@@ -74,6 +86,29 @@ public:
 
 	void requestGroupAround(not_null<HistoryItem*> item);
 
+	// The last page of recently opened chats is kept in the local cache,
+	// so that they can be painted before the server responds.
+	void requestCachedHistory(
+		not_null<History*> history,
+		Fn<void(const MTPmessages_Messages&)> done);
+	void cacheHistory(
+		not_null<History*> history,
+		const MTPmessages_Messages &result);
+	void forgetCachedHistory(not_null<History*> history);
+
+	// When there are more message views than the budget allows, views of
+	// chats that were not opened for a while are unloaded, they are
+	// loaded again when the chat is opened, like after a jump.
+	void historyVisited(not_null<History*> history);
+	[[nodiscard]] int loadedViewsCount() const;
+	[[nodiscard]] static int LoadedViewsBudget();
+
+	// A few recently closed comment threads keep their loaded messages,
+	// so that reopening them doesn't request the thread from scratch.
+	[[nodiscard]] std::shared_ptr<RepliesList> repliesList(
+		not_null<History*> history,
+		MsgId rootId);
+
 	void deleteMessages(
 		not_null<History*> history,
 		const QVector<MTPint> &ids,
@@ -143,6 +178,11 @@ private:
 		Fn<mtpRequestId(Fn<void()> finish)> generator;
 		mtpRequestId id = 0;
 		RequestType type = RequestType::None;
+		bool background = false;
+	};
+	struct QueuedHistoryRequest {
+		not_null<History*> history;
+		Fn<mtpRequestId(Fn<void()> finish)> generator;
 	};
 	struct State {
 		base::flat_map<int, PostponedHistoryRequest> postponed;
@@ -197,16 +237,34 @@ private:
 		not_null<State*> state,
 		int id);
 	[[nodiscard]] bool postponeHistoryRequest(const State &state) const;
+	[[nodiscard]] int historyRequestPriority(
+		not_null<History*> history,
+		const base::flat_set<not_null<History*>> &shown,
+		crl::time now) const;
+	void sendHistoryRequest(
+		not_null<History*> history,
+		State &state,
+		int id,
+		Fn<mtpRequestId(Fn<void()> finish)> generator,
+		bool background);
+	void sendQueuedHistoryRequests();
 	[[nodiscard]] bool postponeEntryRequest(const State &state) const;
 	void postponeRequestDialogEntries();
 
 	void sendDialogRequests();
 
+	[[nodiscard]] MTPmessages_Messages dropLoadedPeers(
+		const MTPDmessages_messages &data) const;
+
+	void unloadColdHistories();
+	[[nodiscard]] base::flat_set<not_null<History*>> shownHistories() const;
+
 	[[nodiscard]] bool isCreatingTopic(
 		not_null<History*> history,
 		MsgId rootId) const;
 	void sendCreateTopicRequest(not_null<History*> history, MsgId rootId);
 	void cancelDelayedByTopicRequest(int id);
+	void forgetRepliesLists(History *history);
 
 	const not_null<Session*> _owner;
 
@@ -214,7 +272,14 @@ private:
 	base::flat_map<not_null<History*>, State> _states;
 	base::flat_map<int, not_null<History*>> _historyByRequest;
 	int _requestAutoincrement = 0;
+
+	// History requests of the shown chats are never queued.
+	base::flat_map<int, QueuedHistoryRequest> _queuedHistoryRequests;
+	int _backgroundHistoryRequests = 0;
 	base::Timer _readRequestsTimer;
+	base::flat_map<not_null<RepliesList*>, crl::time> _readDiscussions;
+	base::Timer _unloadColdTimer;
+	base::flat_map<not_null<History*>, crl::time> _visited;
 
 	base::flat_set<not_null<Data::Folder*>> _dialogFolderRequests;
 	base::flat_map<
@@ -236,6 +301,12 @@ private:
 	base::flat_map<FullMsgId, MsgId> _createdTopicIds;
 	base::flat_set<mtpRequestId> _creatingTopicRequests;
 
+	// Destroyed before the histories, the lists use them.
+	base::flat_map<
+		std::pair<not_null<History*>, MsgId>,
+		std::weak_ptr<RepliesList>> _repliesLists;
+	std::vector<std::shared_ptr<RepliesList>> _recentRepliesLists;
+
 };
 
 } // namespace Data
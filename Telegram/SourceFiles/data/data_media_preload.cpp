@@ -22,12 +22,35 @@ namespace Data {
 namespace {
 
 constexpr auto kDefaultPreloadPrefix = 4 * 1024 * 1024;
+constexpr auto kMinPreloadPrefix = 256 * 1024;
+constexpr auto kPreloadDuration = crl::time(3000);
+constexpr auto kHeaderBytesPerSecond = 1024;
+constexpr auto kMaxRunningPreloads = 3;
+constexpr auto kMaxRunningBytes = int64(8 * 1024 * 1024);
+
+// Below the default priority of the files loaded for the shown media.
+constexpr auto kVideoPreloadPriority = -1;
 
 [[nodiscard]] int64 ChoosePreloadPrefix(not_null<DocumentData*> video) {
-	const auto result = video->videoPreloadPrefix();
-	return result
-		? result
-		: std::min(int64(kDefaultPreloadPrefix), video->size);
+	if (const auto result = video->videoPreloadPrefix()) {
+		return result;
+	}
+	const auto duration = video->duration();
+	if (duration <= 0) {
+		return std::min(int64(kDefaultPreloadPrefix), video->size);
+	}
+
+	// Without the server hint estimate the moov box size from duration
+	// and add enough data for the first group of frames to be decoded.
+	const auto seconds = (duration + 999) / 1000;
+	const auto header = seconds * kHeaderBytesPerSecond;
+	const auto frames = video->size * kPreloadDuration / duration;
+	return std::min(
+		std::clamp(
+			header + frames,
+			int64(kMinPreloadPrefix),
+			int64(kDefaultPreloadPrefix)),
+		video->size);
 }
 
 } // namespace
@@ -130,7 +153,7 @@ void VideoPreload::load() {
 	for (auto i = 0; i != parts; ++i) {
 		_parts.emplace(i * part, QByteArray());
 	}
-	addToQueue();
+	addToQueue(kVideoPreloadPriority);
 }
 
 void VideoPreload::done(QByteArray result) {
@@ -161,8 +184,9 @@ bool VideoPreload::readyToRequest() const {
 	return !_failed && (_nextRequestOffset < _parts.size() * part);
 }
 
-int64 VideoPreload::takeNextRequestOffset() {
+int64 VideoPreload::takeNextRequestOffset(int limit) {
 	Expects(readyToRequest());
+	Expects(limit == Storage::kDownloadPartSize);
 
 	_requestedOffsets.emplace(_nextRequestOffset);
 	_nextRequestOffset += Storage::kDownloadPartSize;
@@ -206,4 +230,95 @@ bool VideoPreload::setWebFileSizeHook(int64 size) {
 	return false;
 }
 
+VideoPreloadScheduler::VideoPreloadScheduler(not_null<Session*> owner)
+: _owner(owner) {
+}
+
+VideoPreloadScheduler::~VideoPreloadScheduler() = default;
+
+void VideoPreloadScheduler::setWindow(
+		not_null<const void*> requester,
+		std::vector<Entry> entries) {
+	if (entries.empty()) {
+		clearWindow(requester);
+		return;
+	}
+	_windows[requester.get()] = std::move(entries);
+	check();
+}
+
+void VideoPreloadScheduler::clearWindow(not_null<const void*> requester) {
+	if (_windows.remove(requester.get())) {
+		check();
+	}
+}
+
+bool VideoPreloadScheduler::wanted(not_null<DocumentData*> video) const {
+	for (const auto &[requester, entries] : _windows) {
+		if (ranges::contains(entries, video, &Entry::video)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void VideoPreloadScheduler::check() {
+	for (auto i = begin(_running); i != end(_running);) {
+		if (wanted(i->first)) {
+			++i;
+		} else {
+			_runningBytes -= i->second.prefix;
+			i = _running.erase(i);
+		}
+	}
+
+	// Round-robin between the windows, so that each of them gets the
+	// videos closest to its viewport preloaded first.
+	auto index = 0;
+	auto more = true;
+	while (more && int(_running.size()) < kMaxRunningPreloads) {
+		more = false;
+		for (const auto &[requester, entries] : _windows) {
+			if (index >= int(entries.size())) {
+				continue;
+			}
+			more = true;
+			const auto &entry = entries[index];
+			const auto video = entry.video;
+			if (_finished.contains(video)
+				|| _running.contains(video)
+				|| !VideoPreload::Can(video)) {
+				continue;
+			}
+			const auto prefix = ChoosePreloadPrefix(video);
+			if (!_running.empty()
+				&& (_runningBytes + prefix > kMaxRunningBytes)) {
+				return;
+			}
+			_runningBytes += prefix;
+			auto &running = _running[video];
+			running.prefix = prefix;
+			running.task = std::make_unique<VideoPreload>(
+				video,
+				FileOrigin(FileOriginMessage(entry.context)),
+				[=] { crl::on_main(this, [=] { finished(video); }); });
+			if (int(_running.size()) >= kMaxRunningPreloads) {
+				return;
+			}
+		}
+		++index;
+	}
+}
+
+void VideoPreloadScheduler::finished(not_null<DocumentData*> video) {
+	const auto i = _running.find(video);
+	if (i == end(_running)) {
+		return;
+	}
+	_runningBytes -= i->second.prefix;
+	_running.erase(i);
+	_finished.emplace(video);
+	check();
+}
+
 } // namespace Data
@@ -11,6 +11,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 namespace Data {
 
+class Session;
 class PhotoMedia;
 struct FileOrigin;
 
@@ -65,7 +66,7 @@ private:
 	void done(QByteArray result);
 
 	bool readyToRequest() const override;
-	int64 takeNextRequestOffset() override;
+	int64 takeNextRequestOffset(int limit) override;
 	bool feedPart(int64 offset, const QByteArray &bytes) override;
 	void cancelOnFail() override;
 	bool setWebFileSizeHook(int64 size) override;
@@ -80,4 +81,41 @@ private:
 
 };
 
+// Preloads the beginnings of videos around the chat viewports, limiting
+// the amount of data loaded at the same time by all the viewports.
+class VideoPreloadScheduler final : public base::has_weak_ptr {
+public:
+	struct Entry {
+		not_null<DocumentData*> video;
+		FullMsgId context;
+	};
+
+	explicit VideoPreloadScheduler(not_null<Session*> owner);
+	~VideoPreloadScheduler();
+
+	// Entries should be ordered by distance from the viewport. Preloads
+	// of videos that are not in any window anymore are cancelled.
+	void setWindow(
+		not_null<const void*> requester,
+		std::vector<Entry> entries);
+	void clearWindow(not_null<const void*> requester);
+
+private:
+	struct Running {
+		std::unique_ptr<VideoPreload> task;
+		int64 prefix = 0;
+	};
+
+	void check();
+	void finished(not_null<DocumentData*> video);
+	[[nodiscard]] bool wanted(not_null<DocumentData*> video) const;
+
+	const not_null<Session*> _owner;
+	base::flat_map<const void*, std::vector<Entry>> _windows;
+	base::flat_map<not_null<DocumentData*>, Running> _running;
+	base::flat_set<not_null<DocumentData*>> _finished;
+	int64 _runningBytes = 0;
+
+};
+
 } // namespace Data
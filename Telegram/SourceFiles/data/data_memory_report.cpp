@@ -0,0 +1,95 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "data/data_memory_report.h"
+
+#include "data/data_session.h"
+#include "data/data_histories.h"
+#include "data/data_photo.h"
+#include "data/data_photo_media.h"
+#include "data/data_document.h"
+#include "data/data_document_media.h"
+#include "media/clip/media_clip_reader.h"
+#include "media/clip/media_clip_frame_pool.h"
+
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QJsonArray>
+
+namespace Data {
+namespace {
+
+[[nodiscard]] QString FormatBytes(int64 bytes) {
+	return (bytes >= 1024 * 1024)
+		? QString::number(bytes / float64(1024 * 1024), 'f', 1) + " MB"
+		: QString::number(bytes / 1024) + " KB";
+}
+
+} // namespace
+
+std::vector<MemoryCategory> CollectMemoryReport(not_null<Session*> owner) {
+	auto photos = MemoryCategory{ .name = u"photo_media"_q };
+	owner->enumeratePhotos([&](not_null<PhotoData*> photo) {
+		if (const auto media = photo->activeMediaView()) {
+			++photos.count;
+			photos.bytes += media->memoryBytes();
+		}
+	});
+	auto documents = MemoryCategory{ .name = u"document_media"_q };
+	owner->enumerateDocuments([&](not_null<DocumentData*> document) {
+		if (const auto media = document->activeMediaView()) {
+			++documents.count;
+			documents.bytes += media->memoryBytes();
+		}
+	});
+	return {
+		std::move(photos),
+		std::move(documents),
+		MemoryCategory{
+			.name = u"clip_readers"_q,
+			.count = Media::Clip::Reader::AliveCount(),
+			.bytes = Media::Clip::internal::FramePool::Instance().bytes(),
+		},
+		MemoryCategory{
+			.name = u"history_views"_q,
+			.count = owner->histories().loadedViewsCount(),
+		},
+	};
+}
+
+QString MemoryReportText(const std::vector<MemoryCategory> &report) {
+	auto result = QStringList();
+	auto total = int64();
+	for (const auto &category : report) {
+		total += category.bytes;
+		result.push_back(category.name
+			+ ": "
+			+ QString::number(category.count)
+			+ (category.bytes ? (", " + FormatBytes(category.bytes)) : ""));
+	}
+	result.push_back("total: " + FormatBytes(total));
+	return result.join('\n');
+}
+
+QByteArray MemoryReportJson(const std::vector<MemoryCategory> &report) {
+	auto categories = QJsonArray();
+	auto total = int64();
+	for (const auto &category : report) {
+		total += category.bytes;
+		categories.append(QJsonObject{
+			{ u"name"_q, category.name },
+			{ u"count"_q, category.count },
+			{ u"bytes"_q, double(category.bytes) },
+		});
+	}
+	return QJsonDocument(QJsonObject{
+		{ u"categories"_q, categories },
+		{ u"total_bytes"_q, double(total) },
+	}).toJson();
+}
+
+} // namespace Data
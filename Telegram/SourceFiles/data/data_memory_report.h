@@ -0,0 +1,28 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+namespace Data {
+
+class Session;
+
+struct MemoryCategory {
+	QString name;
+	int count = 0;
+	int64 bytes = 0; // Zero if the size is not tracked.
+};
+
+// Approximate per-category memory usage of loaded media and views.
+[[nodiscard]] std::vector<MemoryCategory> CollectMemoryReport(
+	not_null<Session*> owner);
+[[nodiscard]] QString MemoryReportText(
+	const std::vector<MemoryCategory> &report);
+[[nodiscard]] QByteArray MemoryReportJson(
+	const std::vector<MemoryCategory> &report);
+
+} // namespace Data
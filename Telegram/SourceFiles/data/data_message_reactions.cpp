@@ -1661,7 +1661,7 @@ void Reactions::pollCollected() {
 			finalize();
 		}).fail([=] {
 			finalize();
-		}).send();
+		}).afterDelay(MTP::kIdleRequestDelay).send();
 	}
 }
 
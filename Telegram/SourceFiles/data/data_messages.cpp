@@ -326,6 +326,11 @@ bool MessagesSliceBuilder::applyUpdate(const MessagesSliceUpdate &update) {
 	auto skippedAfter = (update.range.till == MaxMessagePosition)
 		? 0
 		: std::optional<int> {};
+	const auto was = std::make_tuple(
+		_ids,
+		_fullCount,
+		_skippedBefore,
+		_skippedAfter);
 	mergeSliceData(
 		update.count,
 		needMergeMessages
@@ -333,7 +338,11 @@ bool MessagesSliceBuilder::applyUpdate(const MessagesSliceUpdate &update) {
 			: base::flat_set<MessagePosition> {},
 		skippedBefore,
 		skippedAfter);
-	return true;
+
+	// Busy chats send many updates that leave this window as it was,
+	// don't make the viewers rebuild the same slice again for them.
+	return (std::tie(_ids, _fullCount, _skippedBefore, _skippedAfter)
+		!= was);
 }
 
 bool MessagesSliceBuilder::removeOne(MessagePosition messageId) {
@@ -0,0 +1,227 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "data/data_messages_search_index.h"
+
+#include "base/options.h"
+#include "history/history.h"
+#include "history/history_item.h"
+#include "data/data_peer.h"
+
+namespace Data {
+namespace {
+
+constexpr auto kMaxWordsPerMessage = 256;
+constexpr auto kMaxResults = 100;
+
+base::options::toggle LocalMessagesSearch({
+	.id = kOptionLocalMessagesSearch,
+	.name = "Local messages search",
+	.description = "Index the texts of the loaded messages, show "
+		"the matching ones at once when searching in a chat and suggest "
+		"their hashtags in the chats list search.",
+	.restartRequired = true,
+});
+
+template <typename List>
+void SortUnique(List &list) {
+	ranges::sort(list);
+	list.erase(ranges::unique(list), end(list));
+}
+
+[[nodiscard]] std::vector<QString> ItemWords(const QString &text) {
+	const auto list = TextUtilities::PrepareSearchWords(text);
+	auto result = std::vector<QString>(list.begin(), list.end());
+	SortUnique(result);
+	if (int(result.size()) > kMaxWordsPerMessage) {
+		result.resize(kMaxWordsPerMessage);
+	}
+	return result;
+}
+
+[[nodiscard]] std::vector<QString> ItemHashtags(
+		const TextWithEntities &text) {
+	auto result = std::vector<QString>();
+	for (const auto &entity : text.entities) {
+		if (entity.type() == EntityType::Hashtag && entity.length() > 1) {
+			result.push_back(
+				text.text.mid(entity.offset() + 1, entity.length() - 1));
+		}
+	}
+	SortUnique(result);
+	return result;
+}
+
+} // namespace
+
+const char kOptionLocalMessagesSearch[] = "local-messages-search";
+
+MessagesSearchIndex::MessagesSearchIndex()
+: _enabled(Enabled()) {
+}
+
+bool MessagesSearchIndex::Enabled() {
+	return LocalMessagesSearch.value();
+}
+
+void MessagesSearchIndex::update(not_null<HistoryItem*> item) {
+	if (!_enabled) {
+		return;
+	}
+	const auto &text = item->originalText();
+	auto indexed = (text.text.isEmpty() || !item->isRegular())
+		? Indexed()
+		: Indexed{ ItemWords(text.text), ItemHashtags(text) };
+	const auto i = _items.find(item);
+	if (i != end(_items)) {
+		if (i->second == indexed) {
+			return;
+		}
+		removeIndexed(item, i->second);
+		_items.erase(i);
+	}
+	if (!indexed.words.empty() || !indexed.hashtags.empty()) {
+		add(item, indexed);
+		_items.emplace(item, std::move(indexed));
+	}
+}
+
+void MessagesSearchIndex::remove(not_null<HistoryItem*> item) {
+	if (!_enabled) {
+		return;
+	}
+	const auto i = _items.find(item);
+	if (i != end(_items)) {
+		removeIndexed(item, i->second);
+		_items.erase(i);
+	}
+}
+
+void MessagesSearchIndex::add(
+		not_null<HistoryItem*> item,
+		const Indexed &indexed) {
+	if (!indexed.words.empty()) {
+		auto &peer = _peers[item->history()->peer->id];
+		for (const auto &word : indexed.words) {
+			peer[word].emplace(item);
+		}
+	}
+	for (const auto &text : indexed.hashtags) {
+		auto &hashtag = _hashtags[text.toLower()];
+		hashtag.text = text;
+		++hashtag.count;
+	}
+}
+
+void MessagesSearchIndex::removeIndexed(
+		not_null<HistoryItem*> item,
+		const Indexed &indexed) {
+	for (const auto &text : indexed.hashtags) {
+		const auto i = _hashtags.find(text.toLower());
+		if (i != end(_hashtags) && !--i->second.count) {
+			_hashtags.erase(i);
+		}
+	}
+	const auto i = _peers.find(item->history()->peer->id);
+	if (i == end(_peers)) {
+		return;
+	}
+	auto &peer = i->second;
+	for (const auto &word : indexed.words) {
+		const auto j = peer.find(word);
+		if (j != end(peer)) {
+			j->second.remove(item);
+			if (j->second.empty()) {
+				peer.erase(j);
+			}
+		}
+	}
+	if (peer.empty()) {
+		_peers.erase(i);
+	}
+}
+
+auto MessagesSearchIndex::matching(
+		const Words &words,
+		const QString &prefix) const -> Items {
+	auto result = Items();
+	for (auto i = words.lower_bound(prefix); i != end(words); ++i) {
+		if (!i->first.startsWith(prefix)) {
+			break;
+		}
+		result.insert(end(result), begin(i->second), end(i->second));
+	}
+	SortUnique(result);
+	return result;
+}
+
+MessageIdsList MessagesSearchIndex::search(
+		not_null<History*> history,
+		const QString &query) const {
+	const auto i = _peers.find(history->peer->id);
+	if (!_enabled || i == end(_peers)) {
+		return {};
+	}
+	const auto words = TextUtilities::PrepareSearchWords(query);
+	if (words.isEmpty()) {
+		return {};
+	}
+	auto found = Items();
+	auto first = true;
+	for (const auto &word : words) {
+		auto items = matching(i->second, word);
+		if (first) {
+			found = std::move(items);
+			first = false;
+		} else {
+			auto both = Items();
+			ranges::set_intersection(found, items, std::back_inserter(both));
+			found = std::move(both);
+		}
+		if (found.empty()) {
+			return {};
+		}
+	}
+	ranges::sort(found, [](
+			not_null<HistoryItem*> a,
+			not_null<HistoryItem*> b) {
+		return a->id > b->id;
+	});
+	if (int(found.size()) > kMaxResults) {
+		found.resize(kMaxResults);
+	}
+	return found | ranges::views::transform([](not_null<HistoryItem*> item) {
+		return item->fullId();
+	}) | ranges::to<MessageIdsList>;
+}
+
+std::vector<QString> MessagesSearchIndex::hashtags(
+		const QString &prefix,
+		int limit) const {
+	const auto key = prefix.toLower();
+	auto found = std::vector<not_null<const Hashtag*>>();
+	for (auto i = _hashtags.lower_bound(key); i != end(_hashtags); ++i) {
+		if (!i->first.startsWith(key)) {
+			break;
+		}
+		found.push_back(&i->second);
+	}
+	ranges::stable_sort(found, [](
+			not_null<const Hashtag*> a,
+			not_null<const Hashtag*> b) {
+		return a->count > b->count;
+	});
+	if (int(found.size()) > limit) {
+		found.resize(limit);
+	}
+	return found | ranges::views::transform([](
+			not_null<const Hashtag*> hashtag) {
+		return hashtag->text;
+	}) | ranges::to_vector;
+}
+
+} // namespace Data
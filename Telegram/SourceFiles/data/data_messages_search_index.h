@@ -0,0 +1,71 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+class History;
+class HistoryItem;
+
+namespace Data {
+
+extern const char kOptionLocalMessagesSearch[];
+
+// Word index of the texts of the messages that are loaded in memory,
+// used to show the first search results before the server responds.
+// Main thread only.
+class MessagesSearchIndex final {
+public:
+	MessagesSearchIndex();
+
+	[[nodiscard]] static bool Enabled();
+
+	void update(not_null<HistoryItem*> item);
+	void remove(not_null<HistoryItem*> item);
+
+	// Every query word should be a prefix of some word of the message.
+	// The result is sorted from the newest message to the oldest one.
+	[[nodiscard]] MessageIdsList search(
+		not_null<History*> history,
+		const QString &query) const;
+
+	// Hashtags of all the indexed messages without the '#' that start
+	// with the prefix, the most used ones first.
+	[[nodiscard]] std::vector<QString> hashtags(
+		const QString &prefix,
+		int limit) const;
+
+private:
+	using Items = std::vector<not_null<HistoryItem*>>;
+	using Words = std::map<QString, base::flat_set<not_null<HistoryItem*>>>;
+
+	struct Indexed {
+		std::vector<QString> words;
+		std::vector<QString> hashtags;
+
+		friend inline bool operator==(
+			const Indexed &,
+			const Indexed &) = default;
+	};
+	struct Hashtag {
+		QString text;
+		int count = 0;
+	};
+
+	void add(not_null<HistoryItem*> item, const Indexed &indexed);
+	void removeIndexed(not_null<HistoryItem*> item, const Indexed &indexed);
+	[[nodiscard]] Items matching(
+		const Words &words,
+		const QString &prefix) const;
+
+	const bool _enabled = false;
+	base::flat_map<PeerId, Words> _peers;
+	std::unordered_map<not_null<HistoryItem*>, Indexed> _items;
+	std::map<QString, Hashtag> _hashtags;
+
+};
+
+} // namespace Data
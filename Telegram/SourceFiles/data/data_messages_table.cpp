@@ -0,0 +1,110 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "data/data_messages_table.h"
+
+namespace Data {
+namespace {
+
+constexpr auto kMinCapacity = 64;
+
+} // namespace
+
+uint64 MessagesTable::Hash(FullMsgId id) {
+	auto result = (id.peer.value * 0x9E3779B97F4A7C15ULL)
+		^ uint64(id.msg.bare);
+	result ^= (result >> 33);
+	result *= 0xFF51AFD7ED558CCDULL;
+	result ^= (result >> 33);
+	return result;
+}
+
+int MessagesTable::lookup(FullMsgId id) const {
+	if (_entries.empty()) {
+		return -1;
+	}
+	const auto mask = int(_entries.size()) - 1;
+	for (auto index = int(Hash(id) & mask);; index = (index + 1) & mask) {
+		const auto &entry = _entries[index];
+		if (!entry.id) {
+			return -1;
+		} else if (entry.id == id && entry.item) {
+			return index;
+		}
+	}
+}
+
+HistoryItem *MessagesTable::find(FullMsgId id) const {
+	const auto index = lookup(id);
+	return (index >= 0) ? _entries[index].item : nullptr;
+}
+
+HistoryItem *MessagesTable::insert(
+		FullMsgId id,
+		not_null<HistoryItem*> item) {
+	Expects(id.msg != 0);
+
+	if (const auto index = lookup(id); index >= 0) {
+		return std::exchange(_entries[index].item, item.get());
+	}
+	const auto capacity = int(_entries.size());
+	if ((_count + _removed + 1) * 4 > capacity * 3) {
+		// Grow only if the live entries need it, otherwise just drop
+		// the removed markers.
+		const auto enough = ((_count + 1) * 2 > capacity)
+			? std::max(capacity * 2, kMinCapacity)
+			: capacity;
+		rehash(enough);
+	}
+	const auto mask = int(_entries.size()) - 1;
+	for (auto index = int(Hash(id) & mask);; index = (index + 1) & mask) {
+		auto &entry = _entries[index];
+		if (!entry.item) {
+			if (entry.id) {
+				--_removed;
+			}
+			entry = { .id = id, .item = item.get() };
+			++_count;
+			return nullptr;
+		}
+	}
+}
+
+HistoryItem *MessagesTable::take(FullMsgId id) {
+	const auto index = lookup(id);
+	if (index < 0) {
+		return nullptr;
+	}
+	--_count;
+	++_removed;
+	return base::take(_entries[index].item);
+}
+
+void MessagesTable::clear() {
+	base::take(_entries);
+	_count = _removed = 0;
+}
+
+void MessagesTable::rehash(int capacity) {
+	Expects(!(capacity & (capacity - 1)));
+
+	auto was = std::exchange(_entries, std::vector<Entry>(capacity));
+	const auto mask = capacity - 1;
+	for (const auto &entry : was) {
+		if (!entry.item) {
+			continue;
+		}
+		auto index = int(Hash(entry.id) & mask);
+		while (_entries[index].id) {
+			index = (index + 1) & mask;
+		}
+		_entries[index] = entry;
+	}
+	_removed = 0;
+}
+
+} // namespace Data
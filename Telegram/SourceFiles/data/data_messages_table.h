@@ -0,0 +1,47 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+class HistoryItem;
+
+namespace Data {
+
+// Open addressing hash table of registered messages.
+// All entries are kept in a single array with linear probing,
+// so a lookup doesn't allocate and doesn't chase list nodes.
+class MessagesTable final {
+public:
+	[[nodiscard]] HistoryItem *find(FullMsgId id) const;
+
+	// Returns the item previously registered with this id, if any.
+	HistoryItem *insert(FullMsgId id, not_null<HistoryItem*> item);
+	HistoryItem *take(FullMsgId id);
+
+	void clear();
+
+	[[nodiscard]] int size() const {
+		return _count;
+	}
+
+private:
+	struct Entry {
+		FullMsgId id; // Empty id marks a free entry.
+		HistoryItem *item = nullptr; // Nullptr with an id marks a removed.
+	};
+
+	[[nodiscard]] static uint64 Hash(FullMsgId id);
+	[[nodiscard]] int lookup(FullMsgId id) const;
+	void rehash(int capacity);
+
+	std::vector<Entry> _entries;
+	int _count = 0;
+	int _removed = 0;
+
+};
+
+} // namespace Data
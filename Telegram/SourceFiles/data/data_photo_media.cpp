@@ -144,6 +144,20 @@ bool PhotoMedia::loaded() const {
 		&& (_images[index].goodFor >= PhotoSize::Large);
 }
 
+int64 PhotoMedia::memoryBytes() const {
+	auto result = int64(_videoBytesSmall.size() + _videoBytesLarge.size());
+	if (_inlineThumbnail) {
+		result += _inlineThumbnail->memoryBytes();
+	}
+	for (const auto &image : _images) {
+		result += image.bytes.size();
+		if (image.data) {
+			result += image.data->memoryBytes();
+		}
+	}
+	return result;
+}
+
 float64 PhotoMedia::progress() const {
 	return (_owner->uploading() || _owner->loading())
 		? _owner->progress()
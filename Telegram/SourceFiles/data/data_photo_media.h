@@ -39,6 +39,7 @@ public:
 
 	[[nodiscard]] bool loaded() const;
 	[[nodiscard]] float64 progress() const;
+	[[nodiscard]] int64 memoryBytes() const;
 
 	[[nodiscard]] bool autoLoadThumbnailAllowed(
 		not_null<PeerData*> peer) const;
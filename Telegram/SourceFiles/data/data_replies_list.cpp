@@ -67,8 +67,7 @@ RepliesList::RepliesList(
 : _history(history)
 , _owningTopic(owningTopic)
 , _rootId(rootId)
-, _creating(IsCreating(history, rootId))
-, _readRequestTimer([=] { sendReadTillRequest(); }) {
+, _creating(IsCreating(history, rootId)) {
 	if (_owningTopic) {
 		_owningTopic->destroyed(
 		) | rpl::start_with_next([=] {
@@ -83,7 +82,7 @@ RepliesList::RepliesList(
 RepliesList::~RepliesList() {
 	histories().cancelRequest(base::take(_beforeId));
 	histories().cancelRequest(base::take(_afterId));
-	if (_readRequestTimer.isActive()) {
+	if (histories().cancelReadDiscussion(this)) {
 		sendReadTillRequest();
 	}
 	if (_divider) {
@@ -840,7 +839,9 @@ MsgId RepliesList::computeOutboxReadTillFull() const {
 
 void RepliesList::setUnreadCount(std::optional<int> count) {
 	_unreadCount = count;
-	if (!count && !_readRequestTimer.isActive() && !_readRequestId) {
+	if (!count
+		&& !histories().readDiscussionScheduled(this)
+		&& !_readRequestId) {
 		reloadUnreadCountIfNeeded();
 	}
 }
@@ -983,11 +984,9 @@ void RepliesList::readTill(
 				post->setCommentsInboxReadTill(now);
 			}
 		}
-		if (!_readRequestTimer.isActive()) {
-			_readRequestTimer.callOnce(fast ? 0 : kReadRequestTimeout);
-		} else if (fast && _readRequestTimer.remainingTime() > 0) {
-			_readRequestTimer.callOnce(0);
-		}
+		histories().scheduleReadDiscussion(
+			this,
+			fast ? 0 : kReadRequestTimeout);
 	}
 	if (const auto topic = _history->peer->forumTopicFor(_rootId)) {
 		Core::App().notifications().clearIncomingFromTopic(topic);
@@ -995,9 +994,7 @@ void RepliesList::readTill(
 }
 
 void RepliesList::sendReadTillRequest() {
-	if (_readRequestTimer.isActive()) {
-		_readRequestTimer.cancel();
-	}
+	histories().cancelReadDiscussion(this);
 	const auto api = &_history->session().api();
 	api->request(base::take(_readRequestId)).cancel();
 
@@ -1008,14 +1005,14 @@ void RepliesList::sendReadTillRequest() {
 	)).done(crl::guard(this, [=] {
 		_readRequestId = 0;
 		reloadUnreadCountIfNeeded();
-	})).send();
+	})).afterDelay(MTP::kBackgroundRequestDelay).send();
 }
 
 void RepliesList::reloadUnreadCountIfNeeded() {
 	if (unreadCountKnown()) {
 		return;
 	} else if (inboxReadTillId() < computeInboxReadTillFull()) {
-		_readRequestTimer.callOnce(0);
+		histories().scheduleReadDiscussion(this, 0);
 	} else {
 		requestUnreadCount();
 	}
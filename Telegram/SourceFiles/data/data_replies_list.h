@@ -65,6 +65,9 @@ public:
 	void readTill(not_null<HistoryItem*> item);
 	void readTill(MsgId tillId);
 
+	// Called by Histories when the scheduled read request is due.
+	void sendReadTillRequest();
+
 	[[nodiscard]] bool canDeleteMyTopic() const;
 
 	[[nodiscard]] rpl::lifetime &lifetime() {
@@ -100,7 +103,6 @@ private:
 	void setUnreadCount(std::optional<int> count);
 	void readTill(MsgId tillId, HistoryItem *tillIdItem);
 	void checkReadTillEnd();
-	void sendReadTillRequest();
 	void reloadUnreadCountIfNeeded();
 
 	const not_null<History*> _history;
@@ -123,7 +125,6 @@ private:
 	int _beforeId = 0;
 	int _afterId = 0;
 
-	base::Timer _readRequestTimer;
 	mtpRequestId _readRequestId = 0;
 
 	mtpRequestId _reloadUnreadCountRequestId = 0;
@@ -68,6 +68,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_stories.h"
 #include "data/data_streaming.h"
 #include "data/data_media_rotation.h"
+#include "data/data_media_preload.h"
 #include "data/data_histories.h"
 #include "data/data_peer_values.h"
 #include "data/data_premium_limits.h"
@@ -84,6 +85,8 @@ namespace {
 
 using ViewElement = HistoryView::Element;
 
+constexpr auto kSmallCacheMediaSizeLimit = int64(512 * 1024);
+
 // s: box 100x100
 // m: box 320x320
 // x: box 800x800
@@ -248,6 +251,7 @@ Session::Session(not_null<Main::Session*> session)
 , _savedMessages(std::make_unique<SavedMessages>(this))
 , _chatbots(std::make_unique<Chatbots>(this))
 , _businessInfo(std::make_unique<BusinessInfo>(this))
+, _videoPreloads(std::make_unique<VideoPreloadScheduler>(this))
 , _shortcutMessages(std::make_unique<ShortcutMessages>(this)) {
 	_cache->open(_session->local().cacheKey());
 	_bigFileCache->open(_session->local().cacheBigFileKey());
@@ -391,8 +395,8 @@ void Session::clear() {
 	_session->scheduledMessages().clear();
 	_session->sponsoredMessages().clear();
 	_dependentMessages.clear();
-	base::take(_messages);
-	base::take(_nonChannelMessages);
+	_messages.clear();
+	_nonChannelMessages.clear();
 	_messageByRandomId.clear();
 	_sentMessagesData.clear();
 	cSetRecentInlineBots(RecentInlineBots());
@@ -1180,11 +1184,7 @@ void Session::registerInvitedToCallUser(
 		not_null<UserData*> user) {
 	const auto call = peer->groupCall();
 	if (call && call->id() == callId) {
-		const auto inCall = ranges::contains(
-			call->participants(),
-			user,
-			&Data::GroupCallParticipant::peer);
-		if (inCall) {
+		if (call->participantByPeer(user)) {
 			return;
 		}
 	}
@@ -1254,6 +1254,19 @@ void Session::enumerateBroadcasts(
 	}
 }
 
+void Session::enumeratePhotos(Fn<void(not_null<PhotoData*>)> action) const {
+	for (const auto &[id, photo] : _photos) {
+		action(photo.get());
+	}
+}
+
+void Session::enumerateDocuments(
+		Fn<void(not_null<DocumentData*>)> action) const {
+	for (const auto &[id, document] : _documents) {
+		action(document.get());
+	}
+}
+
 not_null<History*> Session::history(PeerId peerId) {
 	return _histories->findOrCreate(peerId);
 }
@@ -1347,6 +1360,25 @@ Storage::Cache::Database &Session::cacheBigFile() {
 	return *_bigFileCache;
 }
 
+Storage::Cache::Database &Session::cacheFor(uint8 tag, int64 size) {
+	const auto media = (tag == kAnimationCacheTag)
+		|| (tag == kVideoMessageCacheTag);
+	return (media && size > kSmallCacheMediaSizeLimit)
+		? cacheBigFile()
+		: cache();
+}
+
+void Session::cacheLookupFinished(bool found) {
+	++_cacheLookupStats.total;
+	if (found) {
+		++_cacheLookupStats.found;
+	}
+}
+
+auto Session::cacheLookupStats() const -> CacheLookupStats {
+	return _cacheLookupStats;
+}
+
 void Session::suggestStartExport(TimeId availableAt) {
 	_exportAvailableAt = availableAt;
 	suggestStartExport();
@@ -1638,6 +1670,10 @@ rpl::producer<not_null<const ViewElement*>> Session::viewLayoutChanged() const {
 }
 
 void Session::notifyNewItemAdded(not_null<HistoryItem*> item) {
+	if (_newItemsBatchLevel > 0) {
+		_newItemAddedInBatch = item->fullId();
+		return;
+	}
 	_newItemAdded.fire_copy(item);
 }
 
@@ -1654,27 +1690,23 @@ rpl::producer<GiftUpdate> Session::giftUpdates() const {
 }
 
 HistoryItem *Session::changeMessageId(PeerId peerId, MsgId wasId, MsgId nowId) {
-	const auto list = messagesListForInsert(peerId);
-	const auto i = list->find(wasId);
-	if (i == list->end()) {
+	const auto item = _messages.take({ peerId, wasId });
+	if (!item) {
 		return nullptr;
 	}
-	const auto item = i->second;
-	list->erase(i);
-	const auto &[j, ok] = list->emplace(nowId, item);
+	const auto existing = _messages.insert({ peerId, nowId }, item);
 
 	if (!peerIsChannel(peerId)) {
 		if (IsServerMsgId(wasId)) {
-			const auto k = _nonChannelMessages.find(wasId);
-			Assert(k != end(_nonChannelMessages));
-			_nonChannelMessages.erase(k);
+			const auto removed = _nonChannelMessages.take({ PeerId(), wasId });
+			Assert(removed == item);
 		}
 		if (IsServerMsgId(nowId)) {
-			_nonChannelMessages.emplace(nowId, item);
+			_nonChannelMessages.insert({ PeerId(), nowId }, item);
 		}
 	}
 
-	Ensures(ok);
+	Ensures(!existing);
 	return item;
 }
 
@@ -2388,12 +2420,19 @@ void Session::processMessages(
 		const auto id = IdFromMessage(message); // Only 32 bit values here.
 		indices.emplace((uint64(uint32(id.bare)) << 32) | uint64(i), i);
 	}
+	++_newItemsBatchLevel;
 	for (const auto &[position, index] : indices) {
 		addNewMessage(
 			data[index],
 			MessageFlags(),
 			type);
 	}
+	if (!--_newItemsBatchLevel) {
+		const auto last = base::take(_newItemAddedInBatch);
+		if (const auto item = last ? message(last) : nullptr) {
+			_newItemAdded.fire_copy(item);
+		}
+	}
 }
 
 void Session::processMessages(
@@ -2423,29 +2462,17 @@ void Session::processExistingMessages(
 	});
 }
 
-const Session::Messages *Session::messagesList(PeerId peerId) const {
-	const auto i = _messages.find(peerId);
-	return (i != end(_messages)) ? &i->second : nullptr;
-}
-
-auto Session::messagesListForInsert(PeerId peerId)
--> not_null<Messages*> {
-	return &_messages[peerId];
-}
-
 void Session::registerMessage(not_null<HistoryItem*> item) {
 	const auto peerId = item->history()->peer->id;
-	const auto list = messagesListForInsert(peerId);
 	const auto itemId = item->id;
-	const auto i = list->find(itemId);
-	if (i != list->end()) {
+	if (const auto existing = _messages.find({ peerId, itemId })) {
 		LOG(("App Error: Trying to re-registerMessage()."));
-		i->second->destroy();
+		existing->destroy();
 	}
-	list->emplace(itemId, item);
+	_messages.insert({ peerId, itemId }, item);
 
 	if (!peerIsChannel(peerId) && IsServerMsgId(itemId)) {
-		_nonChannelMessages.emplace(itemId, item);
+		_nonChannelMessages.insert({ PeerId(), itemId }, item);
 	}
 }
 
@@ -2503,18 +2530,13 @@ void Session::checkTTLs() {
 void Session::processMessagesDeleted(
 		PeerId peerId,
 		const QVector<MTPint> &data) {
-	const auto list = messagesList(peerId);
 	const auto affected = historyLoaded(peerId);
-	if (!list && !affected) {
-		return;
-	}
 
 	auto historiesToCheck = base::flat_set<not_null<History*>>();
 	for (const auto &messageId : data) {
-		const auto i = list ? list->find(messageId.v) : Messages::iterator();
-		if (list && i != list->end()) {
-			const auto history = i->second->history();
-			i->second->destroy();
+		if (const auto item = message(peerId, messageId.v)) {
+			const auto history = item->history();
+			item->destroy();
 			if (!history->chatListMessageKnown()) {
 				historiesToCheck.emplace(history);
 			}
@@ -2573,6 +2595,7 @@ void Session::unregisterMessage(not_null<HistoryItem*> item) {
 		item,
 		Data::MessageUpdate::Flag::Destroyed);
 	groups().unregisterMessage(item);
+	_messagesSearchIndex.remove(item);
 	removeDependencyMessage(item);
 	for (auto i = begin(_highlightings); i != end(_highlightings);) {
 		if (i->second == item) {
@@ -2581,10 +2604,10 @@ void Session::unregisterMessage(not_null<HistoryItem*> item) {
 			++i;
 		}
 	}
-	messagesListForInsert(peerId)->erase(itemId);
+	_messages.take({ peerId, itemId });
 
 	if (!peerIsChannel(peerId) && IsServerMsgId(itemId)) {
-		_nonChannelMessages.erase(itemId);
+		_nonChannelMessages.take({ PeerId(), itemId });
 	}
 }
 
@@ -2609,17 +2632,7 @@ bool Session::suggestToGigagroup(not_null<ChannelData*> group) const {
 }
 
 HistoryItem *Session::message(PeerId peerId, MsgId itemId) const {
-	if (!itemId) {
-		return nullptr;
-	}
-
-	const auto data = messagesList(peerId);
-	if (!data) {
-		return nullptr;
-	}
-
-	const auto i = data->find(itemId);
-	return (i != data->end()) ? i->second.get() : nullptr;
+	return itemId ? _messages.find({ peerId, itemId }) : nullptr;
 }
 
 HistoryItem *Session::message(
@@ -2636,8 +2649,7 @@ HistoryItem *Session::nonChannelMessage(MsgId itemId) const {
 	if (!IsServerMsgId(itemId)) {
 		return nullptr;
 	}
-	const auto i = _nonChannelMessages.find(itemId);
-	return (i != end(_nonChannelMessages)) ? i->second.get() : nullptr;
+	return _nonChannelMessages.find({ PeerId(), itemId });
 }
 
 void Session::updateDependentMessages(not_null<HistoryItem*> item) {
@@ -3514,6 +3526,43 @@ not_null<WebPageData*> Session::webpage(
 	return result;
 }
 
+void Session::processInstantViewPage(const MTPPage &page) {
+	for (const auto &photo : page.data().vphotos().v) {
+		processPhoto(photo);
+	}
+	for (const auto &document : page.data().vdocuments().v) {
+		processDocument(document);
+	}
+	const auto process = [&](
+			const MTPPageBlock &block,
+			const auto &self) -> void {
+		block.match([&](const MTPDpageBlockChannel &data) {
+			processChat(data.vchannel());
+		}, [&](const MTPDpageBlockCover &data) {
+			self(data.vcover(), self);
+		}, [&](const MTPDpageBlockEmbedPost &data) {
+			for (const auto &block : data.vblocks().v) {
+				self(block, self);
+			}
+		}, [&](const MTPDpageBlockCollage &data) {
+			for (const auto &block : data.vitems().v) {
+				self(block, self);
+			}
+		}, [&](const MTPDpageBlockSlideshow &data) {
+			for (const auto &block : data.vitems().v) {
+				self(block, self);
+			}
+		}, [&](const MTPDpageBlockDetails &data) {
+			for (const auto &block : data.vblocks().v) {
+				self(block, self);
+			}
+		}, [](const auto &) {});
+	};
+	for (const auto &block : page.data().vblocks().v) {
+		process(block, process);
+	}
+}
+
 void Session::webpageApplyFields(
 		not_null<WebPageData*> page,
 		const MTPDwebPage &data) {
@@ -3612,42 +3661,6 @@ void Session::webpageApplyFields(
 			}, [](const auto &) {});
 		}
 	}
-	if (const auto page = data.vcached_page()) {
-		for (const auto &photo : page->data().vphotos().v) {
-			processPhoto(photo);
-		}
-		for (const auto &document : page->data().vdocuments().v) {
-			processDocument(document);
-		}
-		const auto process = [&](
-				const MTPPageBlock &block,
-				const auto &self) -> void {
-			block.match([&](const MTPDpageBlockChannel &data) {
-				processChat(data.vchannel());
-			}, [&](const MTPDpageBlockCover &data) {
-				self(data.vcover(), self);
-			}, [&](const MTPDpageBlockEmbedPost &data) {
-				for (const auto &block : data.vblocks().v) {
-					self(block, self);
-				}
-			}, [&](const MTPDpageBlockCollage &data) {
-				for (const auto &block : data.vitems().v) {
-					self(block, self);
-				}
-			}, [&](const MTPDpageBlockSlideshow &data) {
-				for (const auto &block : data.vitems().v) {
-					self(block, self);
-				}
-			}, [&](const MTPDpageBlockDetails &data) {
-				for (const auto &block : data.vblocks().v) {
-					self(block, self);
-				}
-			}, [](const auto &) {});
-		};
-		for (const auto &block : page->data().vblocks().v) {
-			process(block, process);
-		}
-	}
 	const auto type = story ? WebPageType::Story : ParseWebPageType(data);
 	auto iv = (data.vcached_page() && !IgnoreIv(type))
 		? std::make_unique<Iv::Data>(data, *data.vcached_page())
@@ -11,6 +11,9 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "dialogs/dialogs_main_list.h"
 #include "data/data_groups.h"
 #include "data/data_cloud_file.h"
+#include "data/data_messages_table.h"
+#include "data/data_messages_search_index.h"
+#include "data/data_shared_texts.h"
 #include "history/history_location_manager.h"
 #include "base/timer.h"
 
@@ -68,6 +71,7 @@ class Stories;
 class SavedMessages;
 class Chatbots;
 class BusinessInfo;
+class VideoPreloadScheduler;
 struct ReactionId;
 struct UnavailableReason;
 
@@ -164,6 +168,9 @@ public:
 	[[nodiscard]] BusinessInfo &businessInfo() const {
 		return *_businessInfo;
 	}
+	[[nodiscard]] VideoPreloadScheduler &videoPreloads() const {
+		return *_videoPreloads;
+	}
 
 	[[nodiscard]] MsgId nextNonHistoryEntryId() {
 		return ++_nonHistoryEntryId;
@@ -188,6 +195,24 @@ public:
 	[[nodiscard]] Storage::Cache::Database &cache();
 	[[nodiscard]] Storage::Cache::Database &cacheBigFile();
 
+	// Large animations and videos are kept with the big files,
+	// so that they don't push small often used files out of the cache.
+	[[nodiscard]] Storage::Cache::Database &cacheFor(uint8 tag, int64 size);
+
+	struct CacheLookupStats {
+		int found = 0;
+		int total = 0;
+	};
+	void cacheLookupFinished(bool found);
+	[[nodiscard]] CacheLookupStats cacheLookupStats() const;
+
+	[[nodiscard]] SharedTexts &sharedTexts() {
+		return _sharedTexts;
+	}
+	[[nodiscard]] MessagesSearchIndex &messagesSearchIndex() {
+		return _messagesSearchIndex;
+	}
+
 	[[nodiscard]] not_null<PeerData*> peer(PeerId id);
 	[[nodiscard]] not_null<PeerData*> peer(UserId id) = delete;
 	[[nodiscard]] not_null<UserData*> user(UserId id);
@@ -241,6 +266,8 @@ public:
 	void enumerateUsers(Fn<void(not_null<UserData*>)> action) const;
 	void enumerateGroups(Fn<void(not_null<PeerData*>)> action) const;
 	void enumerateBroadcasts(Fn<void(not_null<ChannelData*>)> action) const;
+	void enumeratePhotos(Fn<void(not_null<PhotoData*>)> action) const;
+	void enumerateDocuments(Fn<void(not_null<DocumentData*>)> action) const;
 	[[nodiscard]] UserData *userByPhone(const QString &phone) const;
 	[[nodiscard]] PeerData *peerByUsername(const QString &username) const;
 
@@ -291,6 +318,8 @@ public:
 	[[nodiscard]] rpl::producer<not_null<const HistoryItem*>> itemLayoutChanged() const;
 	void notifyViewLayoutChange(not_null<const ViewElement*> view);
 	[[nodiscard]] rpl::producer<not_null<const ViewElement*>> viewLayoutChanged() const;
+	// While a batch of received messages is processed only the last
+	// added item is reported, when the whole batch is applied.
 	void notifyNewItemAdded(not_null<HistoryItem*> item);
 	[[nodiscard]] rpl::producer<not_null<HistoryItem*>> newItemAdded() const;
 	void notifyGiftUpdate(GiftUpdate &&update);
@@ -590,6 +619,10 @@ public:
 	not_null<WebPageData*> processWebpage(const MTPWebPage &data);
 	not_null<WebPageData*> processWebpage(const MTPDwebPage &data);
 	not_null<WebPageData*> processWebpage(const MTPDwebPagePending &data);
+
+	// Photos, documents and channels of a cached page are processed
+	// only when the instant view is shown, not with every message.
+	void processInstantViewPage(const MTPPage &page);
 	[[nodiscard]] not_null<WebPageData*> webpage(
 		WebPageId id,
 		const QString &siteName,
@@ -790,8 +823,6 @@ public:
 	void clearLocalStorage();
 
 private:
-	using Messages = std::unordered_map<MsgId, not_null<HistoryItem*>>;
-
 	void suggestStartExport();
 
 	void setupMigrationViewer();
@@ -813,8 +844,6 @@ private:
 		Folder *requestFolder,
 		const MTPDdialogFolder &data);
 
-	const Messages *messagesList(PeerId peerId) const;
-	not_null<Messages*> messagesListForInsert(PeerId peerId);
 	not_null<HistoryItem*> registerMessage(
 		std::unique_ptr<HistoryItem> item);
 	HistoryItem *changeMessageId(PeerId peerId, MsgId wasId, MsgId nowId);
@@ -923,6 +952,9 @@ private:
 
 	Storage::DatabasePointer _cache;
 	Storage::DatabasePointer _bigFileCache;
+	CacheLookupStats _cacheLookupStats;
+	SharedTexts _sharedTexts;
+	MessagesSearchIndex _messagesSearchIndex;
 
 	TimeId _exportAvailableAt = 0;
 	QPointer<Ui::BoxContent> _exportSuggestion;
@@ -938,6 +970,8 @@ private:
 	rpl::event_stream<not_null<const HistoryItem*>> _itemLayoutChanges;
 	rpl::event_stream<not_null<const ViewElement*>> _viewLayoutChanges;
 	rpl::event_stream<not_null<HistoryItem*>> _newItemAdded;
+	FullMsgId _newItemAddedInBatch;
+	int _newItemsBatchLevel = 0;
 	rpl::event_stream<GiftUpdate> _giftUpdates;
 	rpl::event_stream<not_null<const HistoryItem*>> _itemRepaintRequest;
 	rpl::event_stream<not_null<const ViewElement*>> _viewRepaintRequest;
@@ -965,14 +999,14 @@ private:
 	Dialogs::IndexedList _contactsNoChatsList;
 
 	MsgId _localMessageIdCounter = StartClientMsgId;
-	std::unordered_map<PeerId, Messages> _messages;
+	MessagesTable _messages;
 	std::map<
 		not_null<HistoryItem*>,
 		base::flat_set<not_null<HistoryItem*>>> _dependentMessages;
 	std::map<TimeId, base::flat_set<not_null<HistoryItem*>>> _ttlMessages;
 	base::Timer _ttlCheckTimer;
 
-	std::unordered_map<MsgId, not_null<HistoryItem*>> _nonChannelMessages;
+	MessagesTable _nonChannelMessages; // Keyed by FullMsgId(0, msgId).
 
 	base::flat_map<uint64, FullMsgId> _messageByRandomId;
 	base::flat_map<uint64, SentData> _sentMessagesData;
@@ -1112,6 +1146,7 @@ private:
 	const std::unique_ptr<SavedMessages> _savedMessages;
 	const std::unique_ptr<Chatbots> _chatbots;
 	const std::unique_ptr<BusinessInfo> _businessInfo;
+	const std::unique_ptr<VideoPreloadScheduler> _videoPreloads;
 	std::unique_ptr<ShortcutMessages> _shortcutMessages;
 
 	MsgId _nonHistoryEntryId = ShortcutMaxMsgId;
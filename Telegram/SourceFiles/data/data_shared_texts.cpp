@@ -0,0 +1,48 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "data/data_shared_texts.h"
+
+namespace Data {
+namespace {
+
+constexpr auto kMinSharedLength = 128;
+constexpr auto kCleanupAfterAdded = 1024;
+
+} // namespace
+
+void SharedTexts::share(TextWithEntities &text) {
+	if (text.text.size() < kMinSharedLength) {
+		return;
+	}
+	const auto i = _texts.find(text.text);
+	if (i == end(_texts)) {
+		_texts.emplace(text.text, text.entities);
+		if (++_addedSinceCleanup >= kCleanupAfterAdded) {
+			removeUnused();
+		}
+		return;
+	}
+	text.text = i->first;
+	if (text.entities == i->second) {
+		text.entities = i->second;
+	}
+}
+
+void SharedTexts::removeUnused() {
+	_addedSinceCleanup = 0;
+	for (auto i = begin(_texts); i != end(_texts);) {
+		// Nobody else holds the text, so it is not worth keeping.
+		if (i->first.isDetached()) {
+			i = _texts.erase(i);
+		} else {
+			++i;
+		}
+	}
+}
+
+} // namespace Data
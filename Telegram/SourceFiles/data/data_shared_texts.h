@@ -0,0 +1,27 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+namespace Data {
+
+// Long message texts that repeat, like forwarded posts and bot templates,
+// are made to share the same implicitly shared QString and entities,
+// an edited message simply detaches its own copy. Main thread only.
+class SharedTexts final {
+public:
+	void share(TextWithEntities &text);
+
+private:
+	void removeUnused();
+
+	std::unordered_map<QString, EntitiesInText> _texts;
+	int _addedSinceCleanup = 0;
+
+};
+
+} // namespace Data
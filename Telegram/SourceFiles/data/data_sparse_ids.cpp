@@ -157,6 +157,60 @@ SparseIdsSliceBuilder::SparseIdsSliceBuilder(
 , _limitAfter(limitAfter) {
 }
 
+template <typename Range>
+void SparseIdsSliceBuilder::mergeSliceData(
+		std::optional<int> count,
+		const Range &messageIds,
+		std::optional<int> skippedBefore,
+		std::optional<int> skippedAfter) {
+	if (messageIds.empty()) {
+		if (count && _fullCount != count) {
+			_fullCount = count;
+			if (*_fullCount <= _ids.size()) {
+				_fullCount = _ids.size();
+				_skippedBefore = _skippedAfter = 0;
+			}
+		}
+		fillSkippedAndSliceToLimits();
+		return;
+	}
+	if (count) {
+		_fullCount = count;
+	}
+	auto wasMinId = _ids.empty() ? -1 : _ids.front();
+	auto wasMaxId = _ids.empty() ? -1 : _ids.back();
+	_ids.merge(messageIds.begin(), messageIds.end());
+
+	auto adjustSkippedBefore = [&](MsgId oldId, int oldSkippedBefore) {
+		auto it = _ids.find(oldId);
+		Assert(it != _ids.end());
+		_skippedBefore = oldSkippedBefore - (it - _ids.begin());
+		accumulate_max(*_skippedBefore, 0);
+	};
+	if (skippedBefore) {
+		adjustSkippedBefore(messageIds.front(), *skippedBefore);
+	} else if (wasMinId >= 0 && _skippedBefore) {
+		adjustSkippedBefore(wasMinId, *_skippedBefore);
+	} else {
+		_skippedBefore = std::nullopt;
+	}
+
+	auto adjustSkippedAfter = [&](MsgId oldId, int oldSkippedAfter) {
+		auto it = _ids.find(oldId);
+		Assert(it != _ids.end());
+		_skippedAfter = oldSkippedAfter - (_ids.end() - it - 1);
+		accumulate_max(*_skippedAfter, 0);
+	};
+	if (skippedAfter) {
+		adjustSkippedAfter(messageIds.back(), *skippedAfter);
+	} else if (wasMaxId >= 0 && _skippedAfter) {
+		adjustSkippedAfter(wasMaxId, *_skippedAfter);
+	} else {
+		_skippedAfter = std::nullopt;
+	}
+	fillSkippedAndSliceToLimits();
+}
+
 bool SparseIdsSliceBuilder::applyInitial(
 		const Storage::SparseIdsListResult &result) {
 	mergeSliceData(
@@ -187,14 +241,49 @@ bool SparseIdsSliceBuilder::applyUpdate(
 	auto skippedAfter = (update.range.till == ServerMaxMsgId)
 		? 0
 		: std::optional<int> {};
+	const auto was = snapshot();
+	const auto changed = [&] {
+		// Busy chats send many updates that leave this window as it was,
+		// don't make the viewers rebuild the same slice again for them.
+		return (snapshot() != was);
+	};
+	if (!needMergeMessages) {
+		mergeSliceData(
+			update.count,
+			base::flat_set<MsgId>(),
+			skippedBefore,
+			skippedAfter);
+		return changed();
+	}
+	const auto &all = *update.messages;
+	if (!_key || all.empty()) {
+		mergeSliceData(update.count, all, skippedBefore, skippedAfter);
+		return changed();
+	}
+
+	// Only ids around the key survive sliceToLimits(), so merge just
+	// that part of the list slice, it can have many thousands of ids.
+	const auto around = ranges::lower_bound(all, _key);
+	const auto from = around
+		- std::min(int(around - all.begin()), _limitBefore);
+	const auto till = around
+		+ std::min(int(all.end() - around), _limitAfter + 1);
+	if (from == till) {
+		mergeSliceData(update.count, all, skippedBefore, skippedAfter);
+		return changed();
+	}
+	if (skippedBefore) {
+		*skippedBefore += int(from - all.begin());
+	}
+	if (skippedAfter) {
+		*skippedAfter += int(all.end() - till);
+	}
 	mergeSliceData(
 		update.count,
-		needMergeMessages
-			? *update.messages
-			: base::flat_set<MsgId> {},
+		ranges::make_subrange(from, till),
 		skippedBefore,
 		skippedAfter);
-	return true;
+	return changed();
 }
 
 bool SparseIdsSliceBuilder::removeOne(MsgId messageId) {
@@ -243,59 +332,6 @@ void SparseIdsSliceBuilder::checkInsufficient() {
 	sliceToLimits();
 }
 
-void SparseIdsSliceBuilder::mergeSliceData(
-		std::optional<int> count,
-		const base::flat_set<MsgId> &messageIds,
-		std::optional<int> skippedBefore,
-		std::optional<int> skippedAfter) {
-	if (messageIds.empty()) {
-		if (count && _fullCount != count) {
-			_fullCount = count;
-			if (*_fullCount <= _ids.size()) {
-				_fullCount = _ids.size();
-				_skippedBefore = _skippedAfter = 0;
-			}
-		}
-		fillSkippedAndSliceToLimits();
-		return;
-	}
-	if (count) {
-		_fullCount = count;
-	}
-	auto wasMinId = _ids.empty() ? -1 : _ids.front();
-	auto wasMaxId = _ids.empty() ? -1 : _ids.back();
-	_ids.merge(messageIds.begin(), messageIds.end());
-
-	auto adjustSkippedBefore = [&](MsgId oldId, int oldSkippedBefore) {
-		auto it = _ids.find(oldId);
-		Assert(it != _ids.end());
-		_skippedBefore = oldSkippedBefore - (it - _ids.begin());
-		accumulate_max(*_skippedBefore, 0);
-	};
-	if (skippedBefore) {
-		adjustSkippedBefore(messageIds.front(), *skippedBefore);
-	} else if (wasMinId >= 0 && _skippedBefore) {
-		adjustSkippedBefore(wasMinId, *_skippedBefore);
-	} else {
-		_skippedBefore = std::nullopt;
-	}
-
-	auto adjustSkippedAfter = [&](MsgId oldId, int oldSkippedAfter) {
-		auto it = _ids.find(oldId);
-		Assert(it != _ids.end());
-		_skippedAfter = oldSkippedAfter - (_ids.end() - it - 1);
-		accumulate_max(*_skippedAfter, 0);
-	};
-	if (skippedAfter) {
-		adjustSkippedAfter(messageIds.back(), *skippedAfter);
-	} else if (wasMaxId >= 0 && _skippedAfter) {
-		adjustSkippedAfter(wasMaxId, *_skippedAfter);
-	} else {
-		_skippedAfter = std::nullopt;
-	}
-	fillSkippedAndSliceToLimits();
-}
-
 void SparseIdsSliceBuilder::fillSkippedAndSliceToLimits() {
 	if (_fullCount) {
 		if (_skippedBefore && !_skippedAfter) {
@@ -179,9 +179,10 @@ private:
 	void fillSkippedAndSliceToLimits();
 	void sliceToLimits();
 
+	template <typename Range>
 	void mergeSliceData(
 		std::optional<int> count,
-		const base::flat_set<MsgId> &messageIds,
+		const Range &messageIds,
 		std::optional<int> skippedBefore = std::nullopt,
 		std::optional<int> skippedAfter = std::nullopt);
 
@@ -43,6 +43,7 @@ constexpr auto kMaxSegmentsCount = 180;
 constexpr auto kPollingIntervalChat = 5 * TimeId(60);
 constexpr auto kPollingIntervalViewer = 1 * TimeId(60);
 constexpr auto kPollViewsInterval = 10 * crl::time(1000);
+constexpr auto kPollHiddenDelay = 60 * crl::time(1000);
 constexpr auto kPollingViewsPerPage = Story::kRecentViewersMax;
 
 using UpdateFlag = StoryUpdate::Flag;
@@ -2085,6 +2086,10 @@ void Stories::maybeSchedulePolling(
 }
 
 void Stories::sendPollingRequests() {
+	if (!Core::App().hasShownWindows()) {
+		_pollingTimer.callOnce(kPollHiddenDelay);
+		return;
+	}
 	auto min = 0;
 	const auto now = base::unixtime::now();
 	for (const auto &[story, settings] : _pollingSettings) {
@@ -2107,6 +2112,9 @@ void Stories::sendPollingRequests() {
 void Stories::sendPollingViewsRequests() {
 	if (_pollingViews.empty()) {
 		return;
+	} else if (!Core::App().hasShownWindows()) {
+		_pollingViewsTimer.callOnce(kPollHiddenDelay);
+		return;
 	} else if (!_viewsRequestId) {
 		Assert(_viewsDone == nullptr);
 		const auto story = _pollingViews.front();
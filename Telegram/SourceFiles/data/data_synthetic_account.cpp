@@ -0,0 +1,339 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "data/data_synthetic_account.h"
+
+#include "data/data_session.h"
+#include "data/stickers/data_stickers.h"
+#include "history/history.h"
+
+namespace Data {
+namespace {
+
+constexpr auto kIdBase = uint64(0x7F'0000'0000ULL);
+constexpr auto kAccessHashBase = uint64(0x5EED'0000'0000ULL);
+constexpr auto kDateBase = TimeId(1700000000);
+
+constexpr auto kFirstNames = std::array{
+	"Alice", "Bob", "Carol", "Dave", "Erin", "Frank", "Grace", "Heidi",
+	"Ivan", "Judy", "Mallory", "Niaj", "Olivia", "Peggy", "Rupert",
+	"Sybil", "Trent", "Victor", "Walter", "Yusuf",
+};
+constexpr auto kLastNames = std::array{
+	"Smith", "Johnson", "Ivanov", "Garcia", "Muller", "Rossi", "Silva",
+	"Kowalski", "Nguyen", "Tanaka", "Novak", "Dubois", "Hansen", "Costa",
+	"Petrov", "Khan", "Lopez",
+};
+constexpr auto kWords = std::array{
+	"lorem", "ipsum", "dolor", "sit", "amet", "consectetur", "adipiscing",
+	"elit", "sed", "do", "eiusmod", "tempor", "incididunt", "ut",
+	"labore", "et", "dolore", "magna", "aliqua", "enim", "ad", "minim",
+	"veniam", "quis", "nostrud", "exercitation", "ullamco", "laboris",
+};
+constexpr auto kEmoticons = std::array{
+	"\xF0\x9F\x98\x80", // grinning
+	"\xF0\x9F\x98\x82", // joy
+	"\xF0\x9F\x98\x8D", // heart eyes
+	"\xF0\x9F\x91\x8D", // thumbs up
+	"\xF0\x9F\x94\xA5", // fire
+};
+
+template <typename Array>
+[[nodiscard]] QString Pick(const Array &values, int index) {
+	return QString::fromUtf8(values[index % int(values.size())]);
+}
+
+[[nodiscard]] QString GenerateText(int index) {
+	auto result = QString();
+	const auto count = 3 + (index * 7) % 24;
+	for (auto i = 0; i != count; ++i) {
+		if (i) {
+			result.append(' ');
+		}
+		result.append(Pick(kWords, index * 31 + i * 17));
+	}
+	return result;
+}
+
+[[nodiscard]] UserId SyntheticUserId(int index) {
+	return UserId(kIdBase + index);
+}
+
+[[nodiscard]] MTPUser GenerateUser(int index) {
+	using Flag = MTPDuser::Flag;
+	return MTP_user(
+		MTP_flags(Flag::f_access_hash
+			| Flag::f_first_name
+			| Flag::f_last_name
+			| Flag::f_status),
+		MTP_long(SyntheticUserId(index).bare),
+		MTP_long(kAccessHashBase + index),
+		MTP_string(Pick(kFirstNames, index)),
+		MTP_string(Pick(kLastNames, index / int(kFirstNames.size()))),
+		MTPstring(), // username
+		MTPstring(), // phone
+		MTPUserProfilePhoto(),
+		MTP_userStatusRecently(MTP_flags(0)),
+		MTPint(), // bot_info_version
+		MTPVector<MTPRestrictionReason>(),
+		MTPstring(), // bot_inline_placeholder
+		MTPstring(), // lang_code
+		MTPEmojiStatus(),
+		MTPVector<MTPUsername>(),
+		MTPint(), // stories_max_id
+		MTPPeerColor(), // color
+		MTPPeerColor(), // profile_color
+		MTPint()); // bot_active_users
+}
+
+[[nodiscard]] MTPChat GenerateGroup(ChannelId id, int members) {
+	using Flag = MTPDchannel::Flag;
+	return MTP_channel(
+		MTP_flags(Flag::f_megagroup
+			| Flag::f_access_hash
+			| Flag::f_participants_count),
+		MTP_long(id.bare),
+		MTP_long(kAccessHashBase + id.bare),
+		MTP_string(u"Synthetic Group"_q),
+		MTPstring(), // username
+		MTP_chatPhotoEmpty(),
+		MTP_int(kDateBase),
+		MTPVector<MTPRestrictionReason>(),
+		MTPChatAdminRights(),
+		MTPChatBannedRights(),
+		MTPChatBannedRights(), // default_banned_rights
+		MTP_int(members),
+		MTPVector<MTPUsername>(),
+		MTPint(), // stories_max_id
+		MTPPeerColor(), // color
+		MTPPeerColor(), // profile_color
+		MTPEmojiStatus(),
+		MTPint(), // level
+		MTPint()); // subscription_until_date
+}
+
+[[nodiscard]] MTPMessage GenerateMessage(
+		MsgId id,
+		PeerId peer,
+		UserId from,
+		TimeId date,
+		int index) {
+	using Flag = MTPDmessage::Flag;
+	return MTP_message(
+		MTP_flags(Flag::f_from_id),
+		MTP_int(id.bare),
+		peerToMTP(peerFromUser(from)),
+		MTPint(), // from_boosts_applied
+		peerToMTP(peer),
+		MTPPeer(), // saved_peer_id
+		MTPMessageFwdHeader(),
+		MTPlong(), // via_bot_id
+		MTPlong(), // via_business_bot_id
+		MTPMessageReplyHeader(),
+		MTP_int(date),
+		MTP_string(GenerateText(index)),
+		MTPMessageMedia(),
+		MTPReplyMarkup(),
+		MTPVector<MTPMessageEntity>(),
+		MTPint(), // views
+		MTPint(), // forwards
+		MTPMessageReplies(),
+		MTPint(), // edit_date
+		MTPstring(), // post_author
+		MTPlong(), // grouped_id
+		MTPMessageReactions(),
+		MTPVector<MTPRestrictionReason>(),
+		MTPint(), // ttl_period
+		MTPint(), // quick_reply_shortcut_id
+		MTPlong(), // effect
+		MTPFactCheck());
+}
+
+[[nodiscard]] MTPDialog GenerateDialog(
+		PeerId peer,
+		MsgId topMessage,
+		int unreadCount) {
+	using Flag = MTPDdialog::Flag;
+	return MTP_dialog(
+		MTP_flags(peerIsChannel(peer) ? Flag::f_pts : Flag(0)),
+		peerToMTP(peer),
+		MTP_int(topMessage.bare),
+		MTP_int(topMessage.bare - unreadCount), // read_inbox_max_id
+		MTP_int(topMessage.bare), // read_outbox_max_id
+		MTP_int(unreadCount),
+		MTP_int(0), // unread_mentions_count
+		MTP_int(0), // unread_reactions_count
+		MTP_peerNotifySettings(
+			MTP_flags(0),
+			MTPBool(), // show_previews
+			MTPBool(), // silent
+			MTPint(), // mute_until
+			MTPNotificationSound(),
+			MTPNotificationSound(),
+			MTPNotificationSound(),
+			MTPBool(), // stories_muted
+			MTPBool(), // stories_hide_sender
+			MTPNotificationSound(),
+			MTPNotificationSound(),
+			MTPNotificationSound()),
+		MTP_int(1), // pts
+		MTPDraftMessage(),
+		MTPint(), // folder_id
+		MTPint()); // ttl_period
+}
+
+[[nodiscard]] MTPDocument GenerateSticker(
+		uint64 id,
+		const MTPInputStickerSet &set,
+		int index) {
+	return MTP_document(
+		MTP_flags(0),
+		MTP_long(id),
+		MTP_long(kAccessHashBase + id),
+		MTP_bytes(),
+		MTP_int(kDateBase),
+		MTP_string("image/webp"),
+		MTP_long(16 * 1024 + index),
+		MTPVector<MTPPhotoSize>(),
+		MTPVector<MTPVideoSize>(),
+		MTP_int(2),
+		MTP_vector<MTPDocumentAttribute>(QVector<MTPDocumentAttribute>{
+			MTP_documentAttributeImageSize(MTP_int(512), MTP_int(512)),
+			MTP_documentAttributeSticker(
+				MTP_flags(0),
+				MTP_string(Pick(kEmoticons, index)),
+				set,
+				MTPMaskCoords()),
+		}));
+}
+
+[[nodiscard]] MTPmessages_StickerSet GenerateStickerSet(
+		int index,
+		int count) {
+	const auto setId = kIdBase + index;
+	const auto accessHash = kAccessHashBase + setId;
+	const auto input = MTP_inputStickerSetID(
+		MTP_long(setId),
+		MTP_long(accessHash));
+	auto documents = QVector<MTPDocument>();
+	auto ids = QVector<MTPlong>();
+	documents.reserve(count);
+	ids.reserve(count);
+	for (auto i = 0; i != count; ++i) {
+		const auto id = kIdBase + uint64(index) * count + i;
+		documents.push_back(GenerateSticker(id, input, i));
+		ids.push_back(MTP_long(id));
+	}
+	const auto title = Pick(kWords, index) + ' ' + Pick(kWords, index / 7);
+	return MTP_messages_stickerSet(
+		MTP_stickerSet(
+			MTP_flags(0),
+			MTPint(), // installed_date
+			MTP_long(setId),
+			MTP_long(accessHash),
+			MTP_string(title),
+			MTP_string(u"synthetic_%1"_q.arg(index)),
+			MTPVector<MTPPhotoSize>(),
+			MTPint(), // thumb_dc_id
+			MTPint(), // thumb_version
+			MTPlong(), // thumb_document_id
+			MTP_int(count),
+			MTP_int(index)),
+		MTP_vector<MTPStickerPack>(1, MTP_stickerPack(
+			MTP_string(Pick(kEmoticons, index)),
+			MTP_vector<MTPlong>(std::move(ids)))),
+		MTP_vector<MTPStickerKeyword>(),
+		MTP_vector<MTPDocument>(std::move(documents)));
+}
+
+void FillDialogs(not_null<Session*> owner, int count) {
+	auto users = QVector<MTPUser>();
+	auto messages = QVector<MTPMessage>();
+	auto dialogs = QVector<MTPDialog>();
+	users.reserve(count);
+	messages.reserve(count);
+	dialogs.reserve(count);
+	for (auto i = 0; i != count; ++i) {
+		const auto peer = peerFromUser(SyntheticUserId(i));
+		const auto unread = (i % 10) ? 0 : 1;
+		users.push_back(GenerateUser(i));
+		messages.push_back(GenerateMessage(
+			MsgId(1),
+			peer,
+			SyntheticUserId(i),
+			kDateBase + (count - i) * 60,
+			i));
+		dialogs.push_back(GenerateDialog(peer, MsgId(1), unread));
+	}
+	owner->processUsers(MTP_vector<MTPUser>(std::move(users)));
+	owner->applyDialogs(nullptr, messages, dialogs);
+}
+
+void FillGroup(
+		not_null<Session*> owner,
+		int authors,
+		int members,
+		int count) {
+	const auto channelId = ChannelId(kIdBase);
+	const auto peer = peerFromChannel(channelId);
+	auto messages = QVector<MTPMessage>();
+	messages.reserve(count);
+	for (auto i = count; i != 0; --i) {
+		messages.push_back(GenerateMessage(
+			MsgId(i),
+			peer,
+			SyntheticUserId((i * 13) % std::max(authors, 1)),
+			kDateBase - (count - i) * 30,
+			i));
+	}
+	owner->processChats(MTP_vector<MTPChat>(1, GenerateGroup(
+		channelId,
+		members)));
+	if (messages.isEmpty()) {
+		return;
+	}
+	owner->applyDialogs(
+		nullptr,
+		{ messages.front() },
+		{ GenerateDialog(peer, MsgId(count), 0) });
+
+	const auto history = owner->history(peer);
+	history->addOlderSlice(messages);
+	history->addOlderSlice({});
+}
+
+void FillStickers(not_null<Session*> owner, int sets, int perSet) {
+	auto &stickers = owner->stickers();
+	for (auto i = 0; i != sets; ++i) {
+		const auto set = GenerateStickerSet(i, perSet);
+		stickers.feedSetFull(set.c_messages_stickerSet());
+	}
+}
+
+} // namespace
+
+void FillSyntheticAccount(
+		not_null<Session*> owner,
+		const SyntheticAccountSizes &sizes) {
+	const auto started = crl::now();
+	FillDialogs(owner, sizes.dialogs);
+	FillGroup(
+		owner,
+		sizes.dialogs,
+		sizes.groupMembers,
+		sizes.groupMessages);
+	FillStickers(owner, sizes.stickerSets, sizes.stickersPerSet);
+	owner->chatsListChanged(nullptr);
+	LOG(("Synthetic Account: %1 dialogs, %2 group messages, "
+		"%3 sticker sets generated in %4 ms."
+		).arg(sizes.dialogs
+		).arg(sizes.groupMessages
+		).arg(sizes.stickerSets
+		).arg(crl::now() - started));
+}
+
+} // namespace Data
@@ -0,0 +1,32 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+namespace Data {
+
+class Session;
+
+struct SyntheticAccountSizes {
+	int dialogs = 50'000;
+	int stickerSets = 1000;
+	int stickersPerSet = 20;
+	int groupMembers = 200'000;
+	int groupMessages = 10'000;
+};
+
+// Fills the session with generated users and their dialogs, a large
+// group with a loaded history and not installed sticker sets, all
+// offline, to measure the chats list, search and history at scale.
+// The peer and set ids are far from the real ones, nothing is saved.
+// Only the members count of the group is generated, as its members
+// list is requested from the server when it is shown.
+void FillSyntheticAccount(
+	not_null<Session*> owner,
+	const SyntheticAccountSizes &sizes = {});
+
+} // namespace Data
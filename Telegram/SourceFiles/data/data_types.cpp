@@ -22,6 +22,11 @@ constexpr auto kAudioAlbumThumbCacheTag = 0x0000000000000300ULL;
 constexpr auto kWebDocumentCacheTag = 0x0000020000000000ULL;
 constexpr auto kUrlCacheTag = 0x0000030000000000ULL;
 constexpr auto kGeoPointCacheTag = 0x0000040000000000ULL;
+constexpr auto kHistoryCacheTag = 0x0000000000000400ULL;
+constexpr auto kCustomEmojiDocumentCacheTag = 0x0000000000000500ULL;
+constexpr auto kTranscriptionCacheTag = 0x0000000000000600ULL;
+constexpr auto kTranslationCacheTag = 0x0000050000000000ULL;
+constexpr auto kWebPagePreviewCacheTag = 0x0000060000000000ULL;
 
 } // namespace
 
@@ -95,6 +100,62 @@ Storage::Cache::Key AudioAlbumThumbCacheKey(
 	};
 }
 
+Storage::Cache::Key HistoryCacheKey(PeerId peerId) {
+	return Storage::Cache::Key{
+		Data::kHistoryCacheTag,
+		peerId.value,
+	};
+}
+
+Storage::Cache::Key CustomEmojiDocumentCacheKey(uint64 id) {
+	return Storage::Cache::Key{
+		Data::kCustomEmojiDocumentCacheTag,
+		id,
+	};
+}
+
+Storage::Cache::Key TranscriptionCacheKey(uint64 documentId) {
+	return Storage::Cache::Key{
+		Data::kTranscriptionCacheTag,
+		documentId,
+	};
+}
+
+Storage::Cache::Key TranslationCacheKey(
+		FullMsgId itemId,
+		TimeId edited,
+		const QString &twoLetterCode) {
+	const auto string = u"%1:%2:%3:%4"_q
+		.arg(itemId.peer.value)
+		.arg(itemId.msg.bare)
+		.arg(edited)
+		.arg(twoLetterCode).toUtf8();
+	const auto hash = openssl::Sha256(bytes::make_span(string));
+	const auto bytes = bytes::make_span(hash);
+	const auto bytes1 = bytes.subspan(0, sizeof(uint32));
+	const auto bytes2 = bytes.subspan(sizeof(uint32), sizeof(uint64));
+	const auto part1 = *reinterpret_cast<const uint32*>(bytes1.data());
+	const auto part2 = *reinterpret_cast<const uint64*>(bytes2.data());
+	return Storage::Cache::Key{
+		Data::kTranslationCacheTag | part1,
+		part2
+	};
+}
+
+Storage::Cache::Key WebPagePreviewCacheKey(const QString &link) {
+	const auto string = link.toUtf8();
+	const auto hash = openssl::Sha256(bytes::make_span(string));
+	const auto bytes = bytes::make_span(hash);
+	const auto bytes1 = bytes.subspan(0, sizeof(uint32));
+	const auto bytes2 = bytes.subspan(sizeof(uint32), sizeof(uint64));
+	const auto part1 = *reinterpret_cast<const uint32*>(bytes1.data());
+	const auto part2 = *reinterpret_cast<const uint64*>(bytes2.data());
+	return Storage::Cache::Key{
+		Data::kWebPagePreviewCacheTag | part1,
+		part2
+	};
+}
+
 } // namespace Data
 
 void MessageCursor::fillFrom(not_null<const Ui::InputField*> field) {
@@ -67,6 +67,18 @@ UserData::UserData(not_null<Data::Session*> owner, PeerId id)
 
 UserData::~UserData() = default;
 
+auto UserData::details() const -> const Details & {
+	static const auto empty = Details();
+	return _details ? *_details : empty;
+}
+
+auto UserData::detailsForWrite() -> Details & {
+	if (!_details) {
+		_details = std::make_unique<Details>();
+	}
+	return *_details;
+}
+
 bool UserData::canShareThisContact() const {
 	return canShareThisContactFast()
 		|| !owner().findContactPhone(peerToUser(id)).isEmpty();
@@ -115,42 +127,46 @@ void UserData::setPhoto(const MTPUserProfilePhoto &photo) {
 
 auto UserData::unavailableReasons() const
 -> const std::vector<Data::UnavailableReason> & {
-	return _unavailableReasons;
+	return details().unavailableReasons;
 }
 
 void UserData::setUnavailableReasonsList(
 		std::vector<Data::UnavailableReason> &&reasons) {
-	_unavailableReasons = std::move(reasons);
+	if (_details || !reasons.empty()) {
+		detailsForWrite().unavailableReasons = std::move(reasons);
+	}
 }
 
 void UserData::setCommonChatsCount(int count) {
-	if (_commonChatsCount != count) {
-		_commonChatsCount = count;
+	if (details().commonChatsCount != count) {
+		detailsForWrite().commonChatsCount = count;
 		session().changes().peerUpdated(this, UpdateFlag::CommonChats);
 	}
 }
 
 int UserData::peerGiftsCount() const {
-	return _peerGiftsCount;
+	return details().peerGiftsCount;
 }
 
 void UserData::setPeerGiftsCount(int count) {
-	if (_peerGiftsCount != count) {
-		_peerGiftsCount = count;
+	if (details().peerGiftsCount != count) {
+		detailsForWrite().peerGiftsCount = count;
 		session().changes().peerUpdated(this, UpdateFlag::PeerGifts);
 	}
 }
 
 bool UserData::hasPrivateForwardName() const {
-	return !_privateForwardName.isEmpty();
+	return !details().privateForwardName.isEmpty();
 }
 
 QString UserData::privateForwardName() const {
-	return _privateForwardName;
+	return details().privateForwardName;
 }
 
 void UserData::setPrivateForwardName(const QString &name) {
-	_privateForwardName = name;
+	if (_details || !name.isEmpty()) {
+		detailsForWrite().privateForwardName = name;
+	}
 }
 
 bool UserData::hasActiveStories() const {
@@ -203,18 +219,20 @@ void UserData::setBusinessDetails(Data::BusinessDetails details) {
 }
 
 ChannelId UserData::personalChannelId() const {
-	return _personalChannelId;
+	return details().personalChannelId;
 }
 
 MsgId UserData::personalChannelMessageId() const {
-	return _personalChannelMessageId;
+	return details().personalChannelMessageId;
 }
 
 void UserData::setPersonalChannel(ChannelId channelId, MsgId messageId) {
-	if (_personalChannelId != channelId
-		|| _personalChannelMessageId != messageId) {
-		_personalChannelId = channelId;
-		_personalChannelMessageId = messageId;
+	const auto &now = details();
+	if (now.personalChannelId != channelId
+		|| now.personalChannelMessageId != messageId) {
+		auto &write = detailsForWrite();
+		write.personalChannelId = channelId;
+		write.personalChannelMessageId = messageId;
 		session().changes().peerUpdated(this, UpdateFlag::PersonalChannel);
 	}
 }
@@ -500,7 +518,7 @@ UserData::CallsStatus UserData::callsStatus() const {
 }
 
 int UserData::commonChatsCount() const {
-	return _commonChatsCount;
+	return details().commonChatsCount;
 }
 
 void UserData::setCallsStatus(CallsStatus callsStatus) {
@@ -512,12 +530,12 @@ void UserData::setCallsStatus(CallsStatus callsStatus) {
 
 
 Data::Birthday UserData::birthday() const {
-	return _birthday;
+	return details().birthday;
 }
 
 void UserData::setBirthday(Data::Birthday value) {
-	if (_birthday != value) {
-		_birthday = value;
+	if (details().birthday != value) {
+		detailsForWrite().birthday = value;
 		session().changes().peerUpdated(this, UpdateFlag::Birthday);
 
 		if (isSelf()) {
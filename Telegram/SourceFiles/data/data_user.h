@@ -219,23 +219,30 @@ private:
 	void setUnavailableReasonsList(
 		std::vector<Data::UnavailableReason> &&reasons) override;
 
+	// Profile fields that most of the loaded users never get,
+	// like members of huge groups, are allocated only when set.
+	struct Details {
+		Data::Birthday birthday;
+		std::vector<Data::UnavailableReason> unavailableReasons;
+		QString privateForwardName;
+		ChannelId personalChannelId = 0;
+		MsgId personalChannelMessageId = 0;
+		int commonChatsCount = 0;
+		int peerGiftsCount = 0;
+	};
+	[[nodiscard]] const Details &details() const;
+	[[nodiscard]] Details &detailsForWrite();
+
 	Flags _flags;
 	Data::LastseenStatus _lastseen;
-	Data::Birthday _birthday;
-	int _commonChatsCount = 0;
-	int _peerGiftsCount = 0;
 	ContactStatus _contactStatus = ContactStatus::Unknown;
 	CallsStatus _callsStatus = CallsStatus::Unknown;
 
 	Data::UsernamesInfo _username;
 
 	std::unique_ptr<Data::BusinessDetails> _businessDetails;
-	std::vector<Data::UnavailableReason> _unavailableReasons;
+	std::unique_ptr<Details> _details;
 	QString _phone;
-	QString _privateForwardName;
-
-	ChannelId _personalChannelId = 0;
-	MsgId _personalChannelMessageId = 0;
 
 	uint64 _accessHash = 0;
 	static constexpr auto kInaccessibleAccessHashOld
@@ -27,6 +27,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "ffmpeg/ffmpeg_frame_generator.h"
 #include "chat_helpers/stickers_lottie.h"
 #include "storage/file_download.h" // kMaxFileInMemory
+#include "storage/cache/storage_cache_database.h"
 #include "ui/effects/credits_graphics.h"
 #include "ui/widgets/fields/input_field.h"
 #include "ui/text/custom_emoji_instance.h"
@@ -42,6 +43,9 @@ namespace Data {
 namespace {
 
 constexpr auto kMaxPerRequest = 100;
+constexpr auto kWarmupDelay = 10 * crl::time(1000);
+constexpr auto kWarmupInterval = crl::time(100);
+constexpr auto kWarmupFramesLimit = 180;
 #if 0 // inject-to-on_main
 constexpr auto kUnsubscribeUpdatesDelay = 3 * crl::time(1000);
 #endif
@@ -96,6 +100,64 @@ private:
 		: FrameSizeFromTag(tag);
 }
 
+[[nodiscard]] Storage::Cache::Key CacheKeyFromTag(
+		not_null<DocumentData*> document,
+		SizeTag tag) {
+	const auto baseKey = document->bigFileBaseCacheKey();
+	if (!baseKey) {
+		return {};
+	}
+	return Storage::Cache::Key{
+		baseKey.high,
+		baseKey.low + ChatHelpers::LottieCacheKeyShift(
+			0x0F,
+			LottieSizeFromTag(tag)),
+	};
+}
+
+[[nodiscard]] std::unique_ptr<Ui::FrameGenerator> MakeFrameGenerator(
+		StickerType type,
+		const QByteArray &bytes) {
+	switch (type) {
+	case StickerType::Tgs:
+		return std::make_unique<Lottie::FrameGenerator>(bytes);
+	case StickerType::Webm:
+		return std::make_unique<FFmpeg::FrameGenerator>(bytes);
+	case StickerType::Webp:
+		return std::make_unique<Ui::ImageFrameGenerator>(bytes);
+	}
+	Unexpected("Type in custom emoji sticker frame generator.");
+}
+
+[[nodiscard]] QByteArray RenderToCache(
+		std::unique_ptr<Ui::FrameGenerator> generator,
+		int size) {
+	auto cache = Ui::CustomEmoji::Cache(size);
+	if (const auto count = generator->count()) {
+		cache.reserve(std::min(count, kWarmupFramesLimit));
+	}
+	auto storage = QImage();
+	for (auto i = 0; i != kWarmupFramesLimit; ++i) {
+		auto frame = generator->renderNext(
+			std::move(storage),
+			QSize(size, size),
+			Qt::KeepAspectRatio);
+		if (frame.image.isNull()) {
+			break;
+		}
+		cache.add(frame.duration, frame.image);
+		if (frame.last || !frame.duration) {
+			break;
+		}
+		storage = std::move(frame.image);
+	}
+	if (!cache.frames()) {
+		return QByteArray();
+	}
+	cache.finish();
+	return cache.serialize();
+}
+
 [[nodiscard]] QString InternalPrefix() {
 	return u"internal:"_q;
 }
@@ -142,6 +204,8 @@ private:
 	struct Resolve {
 		Fn<void(LoadResult)> requested;
 		QString entityData;
+		Session *owner = nullptr;
+		DocumentId id = 0;
 	};
 	struct Process {
 		std::shared_ptr<DocumentMedia> media;
@@ -224,6 +288,9 @@ void CustomEmojiLoader::resolved(not_null<DocumentData*> document) {
 
 void CustomEmojiLoader::load(Fn<void(LoadResult)> loaded) {
 	if (const auto resolve = std::get_if<Resolve>(&_state)) {
+		if (!resolve->requested && resolve->owner) {
+			resolve->owner->customEmojiManager().prioritize(resolve->id);
+		}
 		resolve->requested = std::move(loaded);
 	} else if (const auto lookup = std::get_if<Lookup>(&_state)) {
 		if (!lookup->process) {
@@ -277,16 +344,7 @@ bool CustomEmojiLoader::loading() {
 
 Storage::Cache::Key CustomEmojiLoader::cacheKey(
 		not_null<DocumentData*> document) const {
-	const auto baseKey = document->bigFileBaseCacheKey();
-	if (!baseKey) {
-		return {};
-	}
-	return Storage::Cache::Key{
-		baseKey.high,
-		baseKey.low + ChatHelpers::LottieCacheKeyShift(
-			0x0F,
-			LottieSizeFromTag(_tag)),
-	};
+	return CacheKeyFromTag(document, _tag);
 }
 
 void CustomEmojiLoader::startCacheLookup(
@@ -375,17 +433,8 @@ void CustomEmojiLoader::check() {
 		}
 	};
 	const auto type = document->sticker()->type;
-	auto generator = [=, bytes = Lottie::ReadContent(data, filepath)]()
-	-> std::unique_ptr<Ui::FrameGenerator> {
-		switch (type) {
-		case StickerType::Tgs:
-			return std::make_unique<Lottie::FrameGenerator>(bytes);
-		case StickerType::Webm:
-			return std::make_unique<FFmpeg::FrameGenerator>(bytes);
-		case StickerType::Webp:
-			return std::make_unique<Ui::ImageFrameGenerator>(bytes);
-		}
-		Unexpected("Type in custom emoji sticker frame generator.");
+	auto generator = [=, bytes = Lottie::ReadContent(data, filepath)] {
+		return MakeFrameGenerator(type, bytes);
 	};
 	auto renderer = std::make_unique<Renderer>(RendererDescriptor{
 		.generator = std::move(generator),
@@ -407,7 +456,11 @@ auto CustomEmojiLoader::InitialState(
 	if (document->sticker()) {
 		return Lookup{ document };
 	}
-	return Resolve{ .entityData = SerializeCustomEmojiId(id) };
+	return Resolve{
+		.entityData = SerializeCustomEmojiId(id),
+		.owner = owner,
+		.id = id,
+	};
 }
 
 void CustomEmojiLoader::cancel() {
@@ -442,7 +495,14 @@ Ui::CustomEmoji::Preview CustomEmojiLoader::preview() {
 
 CustomEmojiManager::CustomEmojiManager(not_null<Session*> owner)
 : _owner(owner)
-, _repaintTimer([=] { invokeRepaints(); }) {
+, _repaintTimer([=] { invokeRepaints(); })
+, _warmupTimer([=] { warmupNext(); }) {
+	owner->stickers().updated(
+		StickersType::Emoji
+	) | rpl::start_with_next([=] {
+		scheduleWarmup();
+	}, _lifetime);
+
 	const auto appConfig = &owner->session().appConfig();
 	appConfig->value(
 	) | rpl::take_while([=] {
@@ -633,10 +693,7 @@ void CustomEmojiManager::resolve(
 	}
 	_resolvers[documentId].emplace(listener);
 	_listeners[listener].emplace(documentId);
-	_pendingForRequest.emplace(documentId);
-	if (!_requestId && _pendingForRequest.size() == 1) {
-		crl::on_main(this, [=] { request(); });
-	}
+	enqueueForRequest(documentId);
 }
 
 void CustomEmojiManager::unregisterListener(not_null<Listener*> listener) {
@@ -724,10 +781,7 @@ auto CustomEmojiManager::createLoaderWithSetId(
 	} else {
 		const auto i = SizeIndex(tag);
 		_loaders[i][documentId].push_back(base::make_weak(result));
-		_pendingForRequest.emplace(documentId);
-		if (!_requestId && _pendingForRequest.size() == 1) {
-			crl::on_main(this, [=] { request(); });
-		}
+		enqueueForRequest(documentId);
 	}
 	return { std::move(result), uint64(), false };
 }
@@ -738,9 +792,66 @@ QString CustomEmojiManager::lookupSetName(uint64 setId) {
 	return (i != end(sets)) ? i->second->title : QString();
 }
 
+void CustomEmojiManager::enqueueForRequest(DocumentId documentId) {
+	if (_pendingForRequest.contains(documentId)
+		|| !_cacheLookups.emplace(documentId).second) {
+		return;
+	} else if (_cacheChecked.contains(documentId)) {
+		_cacheLookups.remove(documentId);
+		_pendingForRequest.emplace(documentId);
+		if (!_requestId && _pendingForRequest.size() == 1) {
+			crl::on_main(this, [=] { request(); });
+		}
+		return;
+	}
+	const auto weak = base::make_weak(this);
+	const auto key = CustomEmojiDocumentCacheKey(documentId);
+	_owner->cache().get(key, [=](QByteArray &&value) {
+		auto parsed = std::optional<MTPDocument>();
+		if (!value.isEmpty() && !(value.size() % sizeof(mtpPrime))) {
+			auto from = reinterpret_cast<const mtpPrime*>(value.constData());
+			const auto till = from + (value.size() / sizeof(mtpPrime));
+			auto result = MTPDocument();
+			if (result.read(from, till)) {
+				parsed = std::move(result);
+			}
+		}
+		crl::on_main(weak, [=, parsed = std::move(parsed)] {
+			_cacheLookups.remove(documentId);
+			_cacheChecked.emplace(documentId);
+			if (parsed) {
+				resolved(_owner->processDocument(*parsed));
+			}
+			if (!_owner->document(documentId)->sticker()) {
+				enqueueForRequest(documentId);
+			}
+		});
+	});
+}
+
+void CustomEmojiManager::prioritize(DocumentId documentId) {
+	if (_pendingForRequest.contains(documentId)) {
+		_pendingVisible.emplace(documentId);
+	}
+}
+
+void CustomEmojiManager::resolved(not_null<DocumentData*> document) {
+	fillColoredFlags(document);
+	processLoaders(document);
+	processListeners(document);
+	requestSetFor(document);
+}
+
 void CustomEmojiManager::request() {
 	auto ids = QVector<MTPlong>();
 	ids.reserve(std::min(kMaxPerRequest, int(_pendingForRequest.size())));
+	while (!_pendingVisible.empty() && ids.size() < kMaxPerRequest) {
+		const auto i = _pendingVisible.end() - 1;
+		if (_pendingForRequest.remove(*i)) {
+			ids.push_back(MTP_long(*i));
+		}
+		_pendingVisible.erase(i);
+	}
 	while (!_pendingForRequest.empty() && ids.size() < kMaxPerRequest) {
 		const auto i = _pendingForRequest.end() - 1;
 		ids.push_back(MTP_long(*i));
@@ -755,10 +866,16 @@ void CustomEmojiManager::request() {
 	)).done([=](const MTPVector<MTPDocument> &result) {
 		for (const auto &entry : result.v) {
 			const auto document = _owner->processDocument(entry);
-			fillColoredFlags(document);
-			processLoaders(document);
-			processListeners(document);
-			requestSetFor(document);
+			auto buffer = mtpBuffer();
+			entry.write(buffer);
+			_owner->cache().put(
+				CustomEmojiDocumentCacheKey(document->id),
+				Storage::Cache::Database::TaggedValue(
+					QByteArray(
+						reinterpret_cast<const char*>(buffer.constData()),
+						buffer.size() * sizeof(mtpPrime)),
+					kStickerCacheTag));
+			resolved(document);
 		}
 		requestFinished();
 	}).fail([=] {
@@ -831,6 +948,116 @@ void CustomEmojiManager::requestSetFor(not_null<DocumentData*> document) {
 	});
 }
 
+void CustomEmojiManager::scheduleWarmup() {
+	if (!_warmupDocument && !_warmupTimer.isActive()) {
+		_warmupTimer.callOnce(kWarmupDelay);
+	}
+}
+
+void CustomEmojiManager::fillWarmupQueue() {
+	const auto &sets = _owner->stickers().sets();
+	for (const auto setId : _owner->stickers().emojiSetsOrder()) {
+		const auto i = sets.find(setId);
+		if (i == end(sets)) {
+			continue;
+		}
+		for (const auto &document : i->second->stickers) {
+			if (document->sticker() && !_warmedUp.contains(document->id)) {
+				_warmupQueue.push_back(document);
+			}
+		}
+	}
+}
+
+void CustomEmojiManager::warmupNext() {
+	Expects(!_warmupDocument);
+
+	if (_warmupQueue.empty()) {
+		fillWarmupQueue();
+	}
+	const auto &instances = _instances[SizeIndex(SizeTag::Normal)];
+	while (!_warmupQueue.empty()) {
+		const auto document = _warmupQueue.front();
+		_warmupQueue.pop_front();
+		if (!_warmedUp.emplace(document->id).second
+			|| instances.contains(document->id)) {
+			// Emoji shown on screen fills the cache by itself.
+			continue;
+		}
+		const auto key = CacheKeyFromTag(document, SizeTag::Normal);
+		if (!key) {
+			continue;
+		}
+		_warmupDocument = document;
+		const auto weak = base::make_weak(this);
+		_owner->cacheBigFile().get(key, [=](QByteArray value) {
+			crl::on_main(weak, [=, cached = !value.isEmpty()] {
+				if (cached) {
+					warmupFinish();
+				} else {
+					warmupLoad();
+				}
+			});
+		});
+		return;
+	}
+}
+
+void CustomEmojiManager::warmupLoad() {
+	Expects(_warmupDocument != nullptr);
+
+	_warmupMedia = _warmupDocument->createMediaView();
+	_warmupMedia->checkStickerLarge();
+	if (!warmupCheck()) {
+		_owner->session().downloaderTaskFinished(
+		) | rpl::start_with_next([=] {
+			warmupCheck();
+		}, _warmupLifetime);
+	}
+}
+
+bool CustomEmojiManager::warmupCheck() {
+	Expects(_warmupMedia != nullptr);
+
+	const auto document = _warmupMedia->owner();
+	const auto data = _warmupMedia->bytes();
+	const auto filepath = document->filepath();
+	if (data.isEmpty() && filepath.isEmpty()) {
+		return false;
+	}
+	_warmupLifetime.destroy();
+	_warmupMedia = nullptr;
+
+	const auto type = document->sticker()->type;
+	const auto size = FrameSizeFromTag(SizeTag::Normal);
+	const auto key = CacheKeyFromTag(document, SizeTag::Normal);
+	const auto weak = base::make_weak(this);
+	crl::async([=, bytes = Lottie::ReadContent(data, filepath)] {
+		auto value = RenderToCache(MakeFrameGenerator(type, bytes), size);
+		crl::on_main(weak, [=, value = std::move(value)]() mutable {
+			const auto size = value.size();
+			if (!size) {
+			} else if (size <= Storage::kMaxFileInMemory) {
+				_owner->cacheBigFile().put(key, std::move(value));
+			} else {
+				LOG(("Data Error: Cached emoji size too big: %1.").arg(size));
+			}
+			warmupFinish();
+		});
+	});
+	return true;
+}
+
+void CustomEmojiManager::warmupFinish() {
+	_warmupDocument = nullptr;
+	if (_warmupQueue.empty()) {
+		fillWarmupQueue();
+	}
+	if (!_warmupQueue.empty()) {
+		_warmupTimer.callOnce(kWarmupInterval);
+	}
+}
+
 int CustomEmojiManager::SizeIndex(SizeTag tag) {
 	const auto result = static_cast<int>(tag);
 
@@ -19,6 +19,7 @@ class Session;
 namespace Data {
 
 class Session;
+class DocumentMedia;
 class CustomEmojiLoader;
 
 enum class CustomEmojiSizeTag : uchar {
@@ -69,6 +70,9 @@ public:
 	[[nodiscard]] rpl::producer<not_null<DocumentData*>> resolve(
 		DocumentId documentId);
 
+	// Emoji that are being painted are resolved before the others.
+	void prioritize(DocumentId documentId);
+
 	[[nodiscard]] std::unique_ptr<Ui::CustomEmoji::Loader> createLoader(
 		not_null<DocumentData*> document,
 		SizeTag tag,
@@ -127,8 +131,10 @@ private:
 		SizeTag tag,
 		int sizeOverride = 0);
 
+	void enqueueForRequest(DocumentId documentId);
 	void request();
 	void requestFinished();
+	void resolved(not_null<DocumentData*> document);
 	void repaintLater(
 		not_null<Ui::CustomEmoji::Instance*> instance,
 		Ui::CustomEmoji::RepaintRequest request);
@@ -140,6 +146,15 @@ private:
 	void processListeners(not_null<DocumentData*> document);
 	void requestSetFor(not_null<DocumentData*> document);
 
+	// Renders Normal size frame caches of installed emoji sets
+	// one by one, so that chats don't render emoji on first open.
+	void scheduleWarmup();
+	void fillWarmupQueue();
+	void warmupNext();
+	void warmupLoad();
+	bool warmupCheck();
+	void warmupFinish();
+
 	[[nodiscard]] Ui::CustomEmoji::Preview prepareNonExactPreview(
 		DocumentId documentId,
 		SizeTag tag,
@@ -178,6 +193,12 @@ private:
 		not_null<Listener*>,
 		base::flat_set<DocumentId>> _listeners;
 	base::flat_set<DocumentId> _pendingForRequest;
+	base::flat_set<DocumentId> _pendingVisible;
+
+	// Resolved documents are kept in the cache database, so that
+	// they are not requested again after the app restarts.
+	base::flat_set<DocumentId> _cacheLookups;
+	base::flat_set<DocumentId> _cacheChecked;
 
 	mtpRequestId _requestId = 0;
 
@@ -189,6 +210,13 @@ private:
 	bool _repaintTimerScheduled = false;
 	bool _requestSetsScheduled = false;
 
+	std::deque<not_null<DocumentData*>> _warmupQueue;
+	base::flat_set<DocumentId> _warmedUp;
+	DocumentData *_warmupDocument = nullptr;
+	std::shared_ptr<DocumentMedia> _warmupMedia;
+	base::Timer _warmupTimer;
+	rpl::lifetime _warmupLifetime;
+
 	std::vector<InternalEmojiData> _internalEmoji;
 	base::flat_map<not_null<const style::icon*>, QString> _iconEmoji;
 
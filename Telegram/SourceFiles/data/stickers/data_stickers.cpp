@@ -181,6 +181,37 @@ rpl::producer<> Stickers::savedGifsUpdated() const {
 	return _savedGifsUpdated.events();
 }
 
+void Stickers::setSetsLocalLoader(Fn<void()> loader) {
+	_setsLocalLoader = std::move(loader);
+}
+
+void Stickers::setMasksLocalLoader(Fn<void()> loader) {
+	_masksLocalLoader = std::move(loader);
+}
+
+void Stickers::setSavedGifsLocalLoader(Fn<void()> loader) {
+	_savedGifsLocalLoader = std::move(loader);
+}
+
+void Stickers::ensureSetsLoaded() const {
+	// The loader fills the lists through the same accessors.
+	if (const auto loader = base::take(_setsLocalLoader)) {
+		loader();
+	}
+}
+
+void Stickers::ensureMasksLoaded() const {
+	if (const auto loader = base::take(_masksLocalLoader)) {
+		loader();
+	}
+}
+
+void Stickers::ensureSavedGifsLoaded() const {
+	if (const auto loader = base::take(_savedGifsLocalLoader)) {
+		loader();
+	}
+}
+
 void Stickers::notifyStickerSetInstalled(uint64 setId) {
 	_stickerSetInstalled.fire(std::move(setId));
 }
@@ -314,6 +345,7 @@ void Stickers::incrementSticker(not_null<DocumentData*> document) {
 void Stickers::addSavedGif(
 		std::shared_ptr<ChatHelpers::Show> show,
 		not_null<DocumentData*> document) {
+	ensureSavedGifsLoaded();
 	const auto index = _savedGifs.indexOf(document);
 	if (!index) {
 		return;
@@ -824,6 +856,9 @@ void Stickers::specialSetReceived(
 		uint64 hash,
 		const QVector<MTPStickerPack> &packs,
 		const QVector<MTPint> &usageDates) {
+	if (setId == CloudRecentAttachedSetId) {
+		ensureMasksLoaded();
+	}
 	auto &sets = setsRef();
 	auto it = sets.find(setId);
 
@@ -1725,13 +1760,7 @@ void Stickers::feedSetStickers(
 
 	const auto isArchived = !!(set->flags & SetFlag::Archived);
 	if ((set->flags & SetFlag::Installed) && !isArchived) {
-		if (isEmoji) {
-			session().local().writeInstalledCustomEmoji();
-		} else if (isMasks) {
-			session().local().writeInstalledMasks();
-		} else {
-			session().local().writeInstalledStickers();
-		}
+		session().local().writeInstalledSetsDelayed(set->type());
 	}
 	if (set->flags & SetFlag::Featured) {
 		if (isEmoji) {
@@ -150,39 +150,51 @@ public:
 		return _featuredSetsUnreadCount.value();
 	}
 	[[nodiscard]] const StickersSets &sets() const {
+		ensureSetsLoaded();
 		return _sets;
 	}
 	[[nodiscard]] StickersSets &setsRef() {
+		ensureSetsLoaded();
 		return _sets;
 	}
 	[[nodiscard]] const StickersSetsOrder &setsOrder() const {
+		ensureSetsLoaded();
 		return _setsOrder;
 	}
 	[[nodiscard]] StickersSetsOrder &setsOrderRef() {
+		ensureSetsLoaded();
 		return _setsOrder;
 	}
 	[[nodiscard]] const StickersSetsOrder &maskSetsOrder() const {
+		ensureMasksLoaded();
 		return _maskSetsOrder;
 	}
 	[[nodiscard]] StickersSetsOrder &maskSetsOrderRef() {
+		ensureMasksLoaded();
 		return _maskSetsOrder;
 	}
 	[[nodiscard]] const StickersSetsOrder &emojiSetsOrder() const {
+		ensureSetsLoaded();
 		return _emojiSetsOrder;
 	}
 	[[nodiscard]] StickersSetsOrder &emojiSetsOrderRef() {
+		ensureSetsLoaded();
 		return _emojiSetsOrder;
 	}
 	[[nodiscard]] const StickersSetsOrder &featuredSetsOrder() const {
+		ensureSetsLoaded();
 		return _featuredSetsOrder;
 	}
 	[[nodiscard]] StickersSetsOrder &featuredSetsOrderRef() {
+		ensureSetsLoaded();
 		return _featuredSetsOrder;
 	}
 	[[nodiscard]] const StickersSetsOrder &featuredEmojiSetsOrder() const {
+		ensureSetsLoaded();
 		return _featuredEmojiSetsOrder;
 	}
 	[[nodiscard]] StickersSetsOrder &featuredEmojiSetsOrderRef() {
+		ensureSetsLoaded();
 		return _featuredEmojiSetsOrder;
 	}
 	[[nodiscard]] const StickersSetsOrder &archivedSetsOrder() const {
@@ -198,11 +210,23 @@ public:
 		return _archivedMaskSetsOrder;
 	}
 	[[nodiscard]] const SavedGifs &savedGifs() const {
+		ensureSavedGifsLoaded();
 		return _savedGifs;
 	}
 	[[nodiscard]] SavedGifs &savedGifsRef() {
+		ensureSavedGifsLoaded();
 		return _savedGifs;
 	}
+
+	// Masks and saved GIFs are not needed right after the start, so they
+	// are read from the local storage only when first accessed.
+	// Inactive accounts defer reading all of their sets the same way.
+	void setSetsLocalLoader(Fn<void()> loader);
+	void setMasksLocalLoader(Fn<void()> loader);
+	void setSavedGifsLocalLoader(Fn<void()> loader);
+	void ensureSetsLoaded() const;
+	void ensureMasksLoaded() const;
+	void ensureSavedGifsLoaded() const;
 	void removeFromRecentSet(not_null<DocumentData*> document);
 
 	void addSavedGif(
@@ -321,6 +345,9 @@ private:
 	StickersSetsOrder _archivedSetsOrder;
 	StickersSetsOrder _archivedMaskSetsOrder;
 	SavedGifs _savedGifs;
+	mutable Fn<void()> _setsLocalLoader;
+	mutable Fn<void()> _masksLocalLoader;
+	mutable Fn<void()> _savedGifsLocalLoader;
 
 };
 
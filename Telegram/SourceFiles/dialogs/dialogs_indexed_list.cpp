@@ -12,10 +12,33 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "history/history.h"
 
 namespace Dialogs {
+namespace {
+
+constexpr auto kPrefixLength = 2;
+
+[[nodiscard]] base::flat_set<QString> ComputePrefixes(Key key) {
+	auto result = base::flat_set<QString>();
+	for (const auto &word : key.entry()->chatListNameWords()) {
+		if (word.size() >= kPrefixLength) {
+			result.emplace(word.mid(0, kPrefixLength));
+		}
+	}
+	return result;
+}
+
+[[nodiscard]] bool HasWordWithPrefix(
+		const base::flat_set<QString> &words,
+		const QString &prefix) {
+	const auto i = words.lower_bound(prefix);
+	return (i != end(words)) && i->startsWith(prefix);
+}
+
+} // namespace
 
 IndexedList::IndexedList(SortMode sortMode, FilterId filterId)
 : _sortMode(sortMode)
 , _filterId(filterId)
+, _indexNames(!filterId)
 , _list(sortMode, filterId)
 , _empty(sortMode, filterId) {
 }
@@ -26,6 +49,9 @@ RowsByLetter IndexedList::addToEnd(Key key) {
 	}
 
 	auto result = RowsByLetter{ _list.addToEnd(key) };
+	if (!_indexNames) {
+		return result;
+	}
 	for (const auto &ch : key.entry()->chatListFirstLetters()) {
 		auto j = _index.find(ch);
 		if (j == _index.cend()) {
@@ -33,6 +59,7 @@ RowsByLetter IndexedList::addToEnd(Key key) {
 		}
 		result.letters.emplace(ch, j->second.addToEnd(key));
 	}
+	indexPrefixes(key);
 	return result;
 }
 
@@ -42,6 +69,9 @@ Row *IndexedList::addByName(Key key) {
 	}
 
 	const auto result = _list.addByName(key);
+	if (!_indexNames) {
+		return result;
+	}
 	for (const auto &ch : key.entry()->chatListFirstLetters()) {
 		auto j = _index.find(ch);
 		if (j == _index.cend()) {
@@ -49,6 +79,7 @@ Row *IndexedList::addByName(Key key) {
 		}
 		j->second.addByName(key);
 	}
+	indexPrefixes(key);
 	return result;
 }
 
@@ -70,7 +101,7 @@ bool IndexedList::updateHeight(Key key, float64 narrowRatio) {
 }
 
 void IndexedList::moveToTop(Key key) {
-	if (_list.moveToTop(key)) {
+	if (_list.moveToTop(key) && _indexNames) {
 		for (const auto &ch : key.entry()->chatListFirstLetters()) {
 			if (auto it = _index.find(ch); it != _index.cend()) {
 				it->second.moveToTop(key);
@@ -125,7 +156,8 @@ void IndexedList::adjustByName(
 	Expects(_sortMode == SortMode::Name);
 
 	const auto mainRow = _list.adjustByName(key);
-	if (!mainRow) return;
+	if (!mainRow || !_indexNames) return;
+	indexPrefixes(key);
 
 	auto toRemove = oldLetters;
 	auto toAdd = base::flat_set<QChar>();
@@ -162,7 +194,8 @@ void IndexedList::adjustNames(
 		const base::flat_set<QChar> &oldLetters) {
 	const auto key = Dialogs::Key(history);
 	auto mainRow = _list.getRow(key);
-	if (!mainRow) return;
+	if (!mainRow || !_indexNames) return;
+	indexPrefixes(key);
 
 	auto toRemove = oldLetters;
 	auto toAdd = base::flat_set<QChar>();
@@ -195,64 +228,116 @@ void IndexedList::adjustNames(
 }
 
 void IndexedList::remove(Key key, Row *replacedBy) {
-	if (_list.remove(key, replacedBy)) {
+	if (_list.remove(key, replacedBy) && _indexNames) {
 		for (const auto &ch : key.entry()->chatListFirstLetters()) {
 			if (const auto it = _index.find(ch); it != _index.cend()) {
 				it->second.remove(key, replacedBy);
 			}
 		}
+		unindexPrefixes(key);
 	}
 }
 
 void IndexedList::clear() {
 	_list.clear();
 	_index.clear();
+	_prefixIndex.clear();
+	_prefixesByKey.clear();
+}
+
+void IndexedList::indexPrefixes(Key key) {
+	auto now = ComputePrefixes(key);
+	auto &was = _prefixesByKey[key];
+	for (const auto &prefix : was) {
+		if (!now.contains(prefix)) {
+			const auto i = _prefixIndex.find(prefix);
+			if (i != end(_prefixIndex)
+				&& i->second.remove(key)
+				&& i->second.empty()) {
+				_prefixIndex.erase(i);
+			}
+		}
+	}
+	for (const auto &prefix : now) {
+		if (!was.contains(prefix)) {
+			_prefixIndex[prefix].emplace(key);
+		}
+	}
+	was = std::move(now);
+}
+
+void IndexedList::unindexPrefixes(Key key) {
+	const auto i = _prefixesByKey.find(key);
+	if (i == end(_prefixesByKey)) {
+		return;
+	}
+	for (const auto &prefix : i->second) {
+		const auto j = _prefixIndex.find(prefix);
+		if (j != end(_prefixIndex)
+			&& j->second.remove(key)
+			&& j->second.empty()) {
+			_prefixIndex.erase(j);
+		}
+	}
+	_prefixesByKey.erase(i);
 }
 
 std::vector<not_null<Row*>> IndexedList::filtered(
 		const QStringList &words) const {
-	const auto minimal = [&]() -> const Dialogs::List* {
-		if (empty()) {
-			return nullptr;
+	auto result = std::vector<not_null<Row*>>();
+	if (empty()) {
+		return result;
+	}
+	auto minimal = (const Dialogs::List*)nullptr;
+	auto prefixed = (const base::flat_set<Key>*)nullptr;
+	for (const auto &word : words) {
+		if (word.isEmpty()) {
+			continue;
+		}
+		const auto found = filtered(word[0]);
+		if (!found || found->empty()) {
+			return result;
+		} else if (!minimal || minimal->size() > found->size()) {
+			minimal = found;
 		}
-		auto result = (const Dialogs::List*)nullptr;
+		if (word.size() >= kPrefixLength) {
+			const auto i = _prefixIndex.find(word.mid(0, kPrefixLength));
+			if (i == end(_prefixIndex)) {
+				return result;
+			} else if (!prefixed || prefixed->size() > i->second.size()) {
+				prefixed = &i->second;
+			}
+		}
+	}
+	if (!minimal) {
+		return result;
+	}
+	const auto allFound = [&](not_null<Entry*> entry) {
+		const auto &nameWords = entry->chatListNameWords();
 		for (const auto &word : words) {
-			if (word.isEmpty()) {
-				continue;
+			if (!HasWordWithPrefix(nameWords, word)) {
+				return false;
 			}
-			const auto found = filtered(word[0]);
-			if (!found || found->empty()) {
-				return nullptr;
-			} else if (!result || result->size() > found->size()) {
-				result = found;
+		}
+		return true;
+	};
+	if (prefixed && int(prefixed->size()) < minimal->size()) {
+		result.reserve(prefixed->size());
+		for (const auto &key : *prefixed) {
+			if (allFound(key.entry())) {
+				if (const auto row = minimal->getRow(key)) {
+					result.push_back(row);
+				}
 			}
 		}
-		return result;
-	}();
-	auto result = std::vector<not_null<Row*>>();
-	if (!minimal || minimal->empty()) {
+		ranges::sort(result, ranges::less(), [](not_null<Row*> row) {
+			return row->index();
+		});
 		return result;
 	}
 	result.reserve(minimal->size());
 	for (const auto &row : *minimal) {
-		const auto &nameWords = row->entry()->chatListNameWords();
-		const auto found = [&](const QString &word) {
-			for (const auto &name : nameWords) {
-				if (name.startsWith(word)) {
-					return true;
-				}
-			}
-			return false;
-		};
-		const auto allFound = [&] {
-			for (const auto &word : words) {
-				if (!found(word)) {
-					return false;
-				}
-			}
-			return true;
-		}();
-		if (allFound) {
+		if (allFound(row->entry())) {
 			result.push_back(row);
 		}
 	}
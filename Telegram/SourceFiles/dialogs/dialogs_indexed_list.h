@@ -45,6 +45,8 @@ public:
 	[[nodiscard]] const List &all() const {
 		return _list;
 	}
+	// Chat filter lists are never searched by name, so they don't keep
+	// the letter and prefix indices and find nothing here.
 	[[nodiscard]] const List *filtered(QChar ch) const {
 		const auto i = _index.find(ch);
 		return (i != _index.end()) ? &i->second : nullptr;
@@ -90,12 +92,20 @@ private:
 		FilterId filterId,
 		not_null<History*> history,
 		const base::flat_set<QChar> &oldChars);
+	void indexPrefixes(Key key);
+	void unindexPrefixes(Key key);
 
 	SortMode _sortMode = SortMode();
 	FilterId _filterId = 0;
+	bool _indexNames = false;
 	List _list, _empty;
 	base::flat_map<QChar, List> _index;
 
+	// Keys by the first two letters of each name word, they narrow the
+	// candidates for a search when the first letter lists are too big.
+	base::flat_map<QString, base::flat_set<Key>> _prefixIndex;
+	std::map<Key, base::flat_set<QString>> _prefixesByKey;
+
 };
 
 } // namespace Dialogs
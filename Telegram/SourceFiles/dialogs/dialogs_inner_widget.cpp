@@ -23,6 +23,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "history/history_item.h"
 #include "core/application.h"
 #include "core/click_handler_types.h"
+#include "core/core_paint_profiler.h"
 #include "core/shortcuts.h"
 #include "ui/widgets/buttons.h"
 #include "ui/widgets/popup_menu.h"
@@ -88,6 +89,8 @@ namespace {
 constexpr auto kHashtagResultsLimit = 5;
 constexpr auto kStartReorderThreshold = 30;
 constexpr auto kQueryPreviewLimit = 32;
+constexpr auto kSearchPrefetchDelay = crl::time(300);
+constexpr auto kSearchPrefetchCount = 8;
 
 [[nodiscard]] int FixedOnTopDialogsCount(not_null<Dialogs::IndexedList*> list) {
 	auto result = 0;
@@ -220,6 +223,8 @@ InnerWidget::InnerWidget(
 , _childListShown(std::move(childListShown)) {
 	setAttribute(Qt::WA_OpaquePaintEvent, true);
 
+	_searchPrefetchTimer.setCallback([=] { prefetchSearchResults(); });
+
 	style::PaletteChanged(
 	) | rpl::start_with_next([=] {
 		_topicJumpCache = nullptr;
@@ -658,6 +663,8 @@ void InnerWidget::paintEvent(QPaintEvent *e) {
 	if (!_savedSublists && _controller->contentOverlapped(this, e)) {
 		return;
 	}
+	const auto profiler = Core::PaintProfiler::Scope(
+		Core::PaintProfiler::Section::Dialogs);
 	const auto activeEntry = _controller->activeChatEntryCurrent();
 	const auto videoPaused = _controller->isGifPausedAtLeastFor(
 		Window::GifPauseReason::Any);
@@ -709,6 +716,7 @@ void InnerWidget::paintEvent(QPaintEvent *e) {
 			&& _selectedTopicJump
 			&& (!_pressed || _pressedTopicJump);
 		Ui::RowPainter::Paint(p, row, validateVideoUserpic(row), context);
+		Core::PaintProfiler::CountElement();
 	};
 	if (_state == WidgetState::Default) {
 		const auto collapsedSkip = collapsedRowsOffset();
@@ -2711,6 +2719,7 @@ void InnerWidget::applySearchState(SearchState state) {
 			}
 		}
 		clearMouseSelection(true);
+		_searchPrefetchTimer.callOnce(kSearchPrefetchDelay);
 	}
 	if (_state != WidgetState::Default) {
 		_searchWaiting = true;
@@ -2751,6 +2760,22 @@ void InnerWidget::onHashtagFilterUpdate(QStringView newFilter) {
 			}
 		}
 	}
+	if (_hashtagResults.size() < kHashtagResultsLimit) {
+		// Add the most used hashtags of the loaded messages.
+		const auto prefix = _hashtagFilter.mid(1);
+		const auto &index = session().data().messagesSearchIndex();
+		for (const auto &tag : index.hashtags(prefix, kHashtagResultsLimit)) {
+			const auto already = ranges::any_of(_hashtagResults, [&](
+					const std::unique_ptr<HashtagResult> &result) {
+				return !result->tag.compare(tag, Qt::CaseInsensitive);
+			});
+			if (!already && tag.size() != prefix.size()) {
+				_hashtagResults.push_back(
+					std::make_unique<HashtagResult>(tag));
+				if (_hashtagResults.size() == kHashtagResultsLimit) break;
+			}
+		}
+	}
 	refresh(true);
 	clearMouseSelection(true);
 }
@@ -3111,6 +3136,42 @@ void InnerWidget::peerSearchReceived(
 		}
 	}
 	refresh();
+	_searchPrefetchTimer.callOnce(kSearchPrefetchDelay);
+}
+
+void InnerWidget::prefetchSearchResults() {
+	if (_state != WidgetState::Filtered) {
+		return;
+	}
+	// Runs only when the results didn't change for a while, so that
+	// the userpics of the intermediate queries results are not loaded.
+	const auto prefetchUserpic = [](
+			not_null<PeerData*> peer,
+			Ui::PeerUserpicView &view) {
+		if (!view.cloud) {
+			view = peer->createUserpicView();
+		}
+	};
+	auto &histories = session().data().histories();
+	const auto filtered = std::min(
+		int(_filterResults.size()),
+		kSearchPrefetchCount);
+	for (auto i = 0; i != filtered; ++i) {
+		const auto row = _filterResults[i].row;
+		if (const auto history = row->history()) {
+			prefetchUserpic(history->peer, row->userpicView());
+			if (!history->chatListMessageKnown()) {
+				histories.requestDialogEntry(history);
+			}
+		}
+	}
+	const auto peers = std::min(
+		int(_peerSearchResults.size()),
+		kSearchPrefetchCount);
+	for (auto i = 0; i != peers; ++i) {
+		const auto &result = _peerSearchResults[i];
+		prefetchUserpic(result->peer, result->row.userpicView());
+	}
 }
 
 Data::Folder *InnerWidget::shownFolder() const {
@@ -129,6 +129,7 @@ public:
 	void clearFilter();
 	void refresh(bool toTop = false);
 	void refreshEmpty();
+	void prefetchSearchResults();
 	void resizeEmpty();
 
 	[[nodiscard]] bool isUserpicPress() const;
@@ -545,6 +546,7 @@ private:
 	bool _chatPreviewScheduled = false;
 	std::optional<QPoint> _chatPreviewTouchGlobal;
 	base::Timer _touchDragPinnedTimer;
+	base::Timer _searchPrefetchTimer;
 	std::optional<QPoint> _touchDragStartGlobal;
 	std::optional<QPoint> _touchDragNowGlobal;
 	rpl::event_stream<> _touchCancelRequests;
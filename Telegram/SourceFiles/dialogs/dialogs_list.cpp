@@ -62,19 +62,22 @@ not_null<Row*> List::addByName(Key key) {
 void List::adjustByName(not_null<Row*> row) {
 	Expects(row->index() >= 0 && row->index() < _rows.size());
 
+	// All the other rows are sorted, so the new place is found by
+	// a binary search instead of a linear one from the old place.
 	const auto &key = row->entry()->chatListNameSortKey();
 	const auto index = row->index();
 	const auto i = _rows.begin() + index;
-	const auto before = std::find_if(i + 1, _rows.end(), [&](Row *row) {
-		return row->entry()->chatListNameSortKey().compare(key) >= 0;
+	const auto before = std::partition_point(i + 1, _rows.end(), [&](
+			not_null<Row*> row) {
+		return row->entry()->chatListNameSortKey().compare(key) < 0;
 	});
 	if (before != i + 1) {
 		rotate(i, i + 1, before);
 	} else if (i != _rows.begin()) {
-		const auto from = std::make_reverse_iterator(i);
-		const auto after = std::find_if(from, _rows.rend(), [&](Row *row) {
+		const auto after = std::partition_point(_rows.begin(), i, [&](
+				not_null<Row*> row) {
 			return row->entry()->chatListNameSortKey().compare(key) <= 0;
-		}).base();
+		});
 		if (after != i) {
 			rotate(after, i, i + 1);
 		}
@@ -87,16 +90,17 @@ void List::adjustByDate(not_null<Row*> row) {
 	const auto key = row->sortKey(_filterId);
 	const auto index = row->index();
 	const auto i = _rows.begin() + index;
-	const auto before = std::find_if(i + 1, _rows.end(), [&](Row *row) {
-		return (row->sortKey(_filterId) <= key);
+	const auto before = std::partition_point(i + 1, _rows.end(), [&](
+			not_null<Row*> row) {
+		return (row->sortKey(_filterId) > key);
 	});
 	if (before != i + 1) {
 		rotate(i, i + 1, before);
 	} else {
-		const auto from = std::make_reverse_iterator(i);
-		const auto after = std::find_if(from, _rows.rend(), [&](Row *row) {
+		const auto after = std::partition_point(_rows.begin(), i, [&](
+				not_null<Row*> row) {
 			return (row->sortKey(_filterId) >= key);
-		}).base();
+		});
 		if (after != i) {
 			rotate(after, i, i + 1);
 		}
@@ -15,6 +15,13 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "history/history.h"
 
 namespace Dialogs {
+namespace {
+
+#ifdef _DEBUG
+constexpr auto kValidateUnreadStateEach = 256;
+#endif // _DEBUG
+
+} // namespace
 
 MainList::MainList(
 	not_null<Main::Session*> session,
@@ -31,6 +38,9 @@ MainList::MainList(
 		_pinned.setLimit(limit);
 	}, _lifetime);
 
+	if (_filterId) {
+		return;
+	}
 	session->changes().realtimeNameUpdates(
 	) | rpl::start_with_next([=](const Data::NameUpdate &update) {
 		_all.peerNameChanged(_filterId, update.peer, update.oldFirstLetters);
@@ -125,6 +135,7 @@ void MainList::unreadStateChanged(
 		_cloudUnreadState += nowState - wasState;
 		finalizeCloudUnread();
 	}
+	validateUnreadState();
 }
 
 void MainList::unreadEntryChanged(
@@ -153,6 +164,40 @@ void MainList::unreadEntryChanged(
 		}
 		finalizeCloudUnread();
 	}
+	validateUnreadState();
+}
+
+void MainList::validateUnreadState() {
+#ifdef _DEBUG
+	// The counters are updated by the entry deltas only, check them
+	// against a full recount from time to time in debug builds.
+	if (++_unreadChangesToValidate < kValidateUnreadStateEach) {
+		return;
+	}
+	_unreadChangesToValidate = 0;
+	auto counted = UnreadState();
+	for (const auto &row : _all.all()) {
+		counted += row->entry()->chatListUnreadState();
+	}
+	const auto difference = counted - _unreadState;
+	if (difference.messages
+		|| difference.messagesMuted
+		|| difference.chats
+		|| difference.chatsMuted
+		|| difference.marks
+		|| difference.marksMuted
+		|| difference.reactions
+		|| difference.reactionsMuted
+		|| difference.mentions) {
+		LOG(("Unread Error: filter %1 counters differ by "
+			"%2 messages, %3 chats, %4 marks, %5 mentions."
+			).arg(_filterId
+			).arg(difference.messages
+			).arg(difference.chats
+			).arg(difference.marks
+			).arg(difference.mentions));
+	}
+#endif // _DEBUG
 }
 
 void MainList::updateCloudUnread(const MTPDdialogFolder &data) {
@@ -55,6 +55,7 @@ public:
 
 private:
 	void finalizeCloudUnread();
+	void validateUnreadState();
 	void recomputeFullListSize();
 
 	inline auto unreadStateChangeNotifier(bool notify);
@@ -67,6 +68,9 @@ private:
 	rpl::event_stream<UnreadState> _unreadStateChanges;
 	rpl::variable<int> _fullListSize = 0;
 	int _cloudListSize = 0;
+#ifdef _DEBUG
+	int _unreadChangesToValidate = 0;
+#endif // _DEBUG
 
 	bool _loaded = false;
 	bool _allAreMuted = false;
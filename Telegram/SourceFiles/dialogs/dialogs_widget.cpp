@@ -98,6 +98,7 @@ namespace {
 constexpr auto kSearchPerPage = 50;
 constexpr auto kStoriesExpandDuration = crl::time(200);
 constexpr auto kSearchRequestDelay = crl::time(900);
+constexpr auto kMinSearchRequestDelay = crl::time(300);
 
 base::options::toggle OptionForumHideChatsList({
 	.id = kOptionForumHideChatsList,
@@ -2254,6 +2255,8 @@ bool Widget::search(bool inCache, SearchRequestDelay delay) {
 				_peerSearchRequest = 0;
 				peerSearchReceived(i->second, 0);
 				result = true;
+			} else {
+				showRefinedPeerSearch(peerQuery);
 			}
 		} else if (_peerSearchQuery != peerQuery) {
 			_peerSearchQuery = peerQuery;
@@ -2267,6 +2270,7 @@ bool Widget::search(bool inCache, SearchRequestDelay delay) {
 				peerSearchFailed(error, requestId);
 			}).send();
 			_peerSearchQueries.emplace(_peerSearchRequest, _peerSearchQuery);
+			_peerSearchRequestSent = crl::now();
 		}
 	} else {
 		_api.request(base::take(_peerSearchRequest)).cancel();
@@ -2313,10 +2317,21 @@ void Widget::searchRequested(SearchRequestDelay delay) {
 		_searchTimer.cancel();
 		search();
 	} else {
-		_searchTimer.callOnce(kSearchRequestDelay);
+		_searchTimer.callOnce(searchRequestDelay());
 	}
 }
 
+crl::time Widget::searchRequestDelay() const {
+	// Don't wait for the next key press much longer than the server
+	// takes to answer, until the first answer use the default delay.
+	return _searchLatency
+		? std::clamp(
+			_searchLatency * 2,
+			kMinSearchRequestDelay,
+			kSearchRequestDelay)
+		: kSearchRequestDelay;
+}
+
 void Widget::showMainMenu() {
 	controller()->widget()->showMainMenu();
 }
@@ -2657,6 +2672,13 @@ void Widget::peerSearchReceived(
 		}
 	}
 	if (_peerSearchRequest == requestId) {
+		if (requestId && _peerSearchRequestSent) {
+			const auto latency = crl::now() - _peerSearchRequestSent;
+			_searchLatency = _searchLatency
+				? ((_searchLatency * 3 + latency) / 4)
+				: latency;
+			_peerSearchRequestSent = 0;
+		}
 		switch (result.type()) {
 		case mtpc_contacts_found: {
 			auto &d = result.c_contacts_found();
@@ -2671,6 +2693,51 @@ void Widget::peerSearchReceived(
 	}
 }
 
+void Widget::showRefinedPeerSearch(const QString &query) {
+	const auto words = TextUtilities::PrepareSearchWords(query);
+	if (words.isEmpty()) {
+		return;
+	}
+	const auto matches = [&](not_null<PeerData*> peer) {
+		const auto &nameWords = peer->nameWords();
+		const auto username = peer->username().toLower();
+		for (const auto &word : words) {
+			const auto i = nameWords.lower_bound(word);
+			if ((i == end(nameWords) || !i->startsWith(word))
+				&& !username.startsWith(word)) {
+				return false;
+			}
+		}
+		return true;
+	};
+	const auto refine = [&](const MTPVector<MTPPeer> &list) {
+		auto result = QVector<MTPPeer>();
+		for (const auto &mtpPeer : list.v) {
+			const auto peer = session().data().peerLoaded(
+				peerFromMTP(mtpPeer));
+			if (peer && matches(peer)) {
+				result.push_back(mtpPeer);
+			}
+		}
+		return result;
+	};
+
+	// Show the cached results of the longest shorter query that still
+	// match, until the results for the full query are received.
+	for (auto length = int(query.size()) - 1; length > 0; --length) {
+		const auto i = _peerSearchCache.find(query.mid(0, length));
+		if (i == end(_peerSearchCache)) {
+			continue;
+		}
+		const auto &data = i->second.c_contacts_found();
+		_inner->peerSearchReceived(
+			query,
+			refine(data.vmy_results()),
+			refine(data.vresults()));
+		return;
+	}
+}
+
 void Widget::searchApplyEmpty(SearchRequestType type, mtpRequestId id) {
 	_searchFull = _searchFullMigrated = true;
 	searchReceived(
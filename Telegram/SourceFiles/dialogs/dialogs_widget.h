@@ -160,6 +160,7 @@ private:
 	[[nodiscard]] int currentSearchQueryCursorPosition() const;
 	void clearSearchField();
 	void searchRequested(SearchRequestDelay delay);
+	[[nodiscard]] crl::time searchRequestDelay() const;
 	bool search(bool inCache = false, SearchRequestDelay after = {});
 	void searchTopics();
 	void searchMore();
@@ -172,6 +173,7 @@ private:
 	void peerSearchReceived(
 		const MTPcontacts_Found &result,
 		mtpRequestId requestId);
+	void showRefinedPeerSearch(const QString &query);
 	void escape();
 	void submit();
 	void cancelSearchRequest();
@@ -346,6 +348,8 @@ private:
 	QString _peerSearchQuery;
 	bool _peerSearchFull = false;
 	mtpRequestId _peerSearchRequest = 0;
+	crl::time _peerSearchRequestSent = 0;
+	crl::time _searchLatency = 0;
 
 	QString _topicSearchQuery;
 	TimeId _topicSearchOffsetDate = 0;
@@ -9,6 +9,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include <QGraphicsScene>
 #include <QGraphicsSceneMouseEvent>
+#include <QStyleOptionGraphicsItem>
 
 namespace Editor {
 namespace {
@@ -79,11 +80,13 @@ std::vector<QPointF> InterpolatedPoints(
 
 ItemCanvas::ItemCanvas() {
 	setAcceptedMouseButtons({});
+	setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
 }
 
 void ItemCanvas::clearPixmap() {
 	_hq = nullptr;
 	_p = nullptr;
+	_drawnRect = QRectF();
 
 	_pixmap = QPixmap(
 		(scene()->sceneRect().size() * style::DevicePixelRatio()).toSize());
@@ -96,6 +99,18 @@ void ItemCanvas::clearPixmap() {
 	_p->setBrush(_brushData.color);
 }
 
+void ItemCanvas::clearDrawn() {
+	if (_drawnRect.isEmpty()) {
+		return;
+	}
+	// The canvas has the size of the whole image, so instead of
+	// allocating it again after each stroke only the drawn part is erased.
+	_p->setCompositionMode(QPainter::CompositionMode_Clear);
+	_p->fillRect(_drawnRect, Qt::transparent);
+	_p->setCompositionMode(QPainter::CompositionMode_SourceOver);
+	update(base::take(_drawnRect));
+}
+
 void ItemCanvas::applyBrush(const QColor &color, float size) {
 	_brushData.color = color;
 	_brushData.size = size;
@@ -136,6 +151,7 @@ void ItemCanvas::drawLine(
 	const auto points = InterpolatedPoints(lastPoint, currentPoint);
 
 	_rectToUpdate |= NormalizedRect(currentPoint, lastPoint) + _brushMargins;
+	_drawnRect |= _rectToUpdate;
 
 	for (const auto &point : points) {
 		_p->drawEllipse(point, halfBrushSize, halfBrushSize);
@@ -180,17 +196,23 @@ void ItemCanvas::handleMouseReleaseEvent(
 			.position = _contentRect.topLeft(),
 		});
 	}
-	clearPixmap();
-	update();
+	clearDrawn();
 }
 
 void ItemCanvas::paint(
 		QPainter *p,
-		const QStyleOptionGraphicsItem *,
+		const QStyleOptionGraphicsItem *option,
 		QWidget *) {
-	p->fillRect(_rectToUpdate, Qt::transparent);
-	p->drawPixmap(0, 0, _pixmap);
 	_rectToUpdate = QRectF();
+	const auto exposed = option->exposedRect & boundingRect();
+	if (exposed.isEmpty()) {
+		return;
+	}
+	const auto ratio = style::DevicePixelRatio();
+	p->drawPixmap(
+		exposed,
+		_pixmap,
+		QRectF(exposed.topLeft() * ratio, exposed.size() * ratio));
 }
 
 rpl::producer<ItemCanvas::Content> ItemCanvas::grabContentRequests() const {
@@ -212,8 +234,7 @@ bool ItemCanvas::collidesWithPath(
 void ItemCanvas::cancelDrawing() {
 	_drawing = false;
 	_contentRect = QRectF();
-	clearPixmap();
-	update();
+	clearDrawn();
 }
 
 ItemCanvas::~ItemCanvas() {
@@ -52,6 +52,7 @@ protected:
 private:
 	void computeContentRect(const QPointF &p);
 	void drawLine(const QPointF &currentPoint, const QPointF &lastPoint);
+	void clearDrawn();
 
 	bool _drawing = false;
 
@@ -60,6 +61,7 @@ private:
 
 	QRectF _rectToUpdate;
 	QRectF _contentRect;
+	QRectF _drawnRect;
 	QMarginsF _brushMargins;
 
 	QPointF _lastPoint;
@@ -897,6 +897,9 @@ struct DialogInfo {
 	bool isLeftChannel = false;
 	QString relativePath;
 
+	// Messages up to this id were saved by the previous delta export.
+	int32 lastExportedId = 0;
+
 	// Filled when requesting dialog messages.
 	std::vector<int> messagesCountPerSplit;
 };
@@ -7,6 +7,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #include "export/export_api_wrap.h"
 
+#include "export/export_checkpoint.h"
 #include "export/export_settings.h"
 #include "export/data/export_data_types.h"
 #include "export/output/export_output_result.h"
@@ -15,6 +16,9 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "base/bytes.h"
 #include "base/options.h"
 #include "base/random.h"
+
+#include <QtCore/QCryptographicHash>
+
 #include <set>
 #include <deque>
 
@@ -22,9 +26,8 @@ namespace Export {
 namespace {
 
 constexpr auto kUserpicsSliceLimit = 100;
-constexpr auto kFileChunkSize = 128 * 1024;
-constexpr auto kFileRequestsCount = 2;
-//constexpr auto kFileNextRequestDelay = crl::time(20);
+constexpr auto kFileChunkSize = 512 * 1024;
+constexpr auto kFileRequestsCount = 4;
 constexpr auto kChatsSliceLimit = 100;
 constexpr auto kMessagesSliceLimit = 100;
 constexpr auto kTopPeerSliceLimit = 100;
@@ -67,6 +70,15 @@ LocationKey ComputeLocationKey(const Data::FileLocation &value) {
 	return result;
 }
 
+std::optional<Checkpoint::Key> ComputeCheckpointKey(
+		const Data::FileLocation &value) {
+	if (!value || value.data.type() == mtpc_inputTakeoutFileLocation) {
+		return std::nullopt;
+	}
+	const auto key = ComputeLocationKey(value);
+	return Checkpoint::Key{ .type = key.type, .id = key.id };
+}
+
 Settings::Type SettingsFromDialogsType(Data::DialogInfo::Type type) {
 	using DialogType = Data::DialogInfo::Type;
 	switch (type) {
@@ -178,9 +190,18 @@ struct ApiWrap::FileProcess {
 	struct Request {
 		int64 offset = 0;
 		QByteArray bytes;
+		mtpRequestId requestId = 0;
 	};
 	std::deque<Request> requests;
+	QCryptographicHash hash{ QCryptographicHash::Sha1 };
+
+	// File reference refresh, no parts are requested while it is active.
 	mtpRequestId requestId = 0;
+
+	[[nodiscard]] Request *findRequest(int64 offset) {
+		const auto i = ranges::find(requests, offset, &Request::offset);
+		return (i != end(requests)) ? &*i : nullptr;
+	}
 };
 
 struct ApiWrap::FileProgress {
@@ -218,7 +239,9 @@ struct ApiWrap::ChatProcess {
 	Fn<bool(Data::MessagesSlice&&)> handleSlice;
 	FnMut<void()> done;
 
-	FnMut<void(MTPmessages_Messages&&)> requestDone;
+	// Messages slice request, the counts are requested in parallel.
+	mtpRequestId requestId = 0;
+	int countsLeft = 0;
 
 	int localSplitIndex = 0;
 	int32 largestIdPlusOne = 1;
@@ -227,6 +250,17 @@ struct ApiWrap::ChatProcess {
 	std::optional<Data::MessagesSlice> slice;
 	bool lastSlice = false;
 	int fileIndex = 0;
+
+	// Delta exports skip the old messages and the migrated history.
+	[[nodiscard]] bool splitSkipped() const {
+		return (info.lastExportedId > 0)
+			&& (info.splits[localSplitIndex] < 0);
+	}
+	[[nodiscard]] int32 splitStartIdPlusOne() const {
+		return (info.splits[localSplitIndex] < 0)
+			? 1
+			: (info.lastExportedId + 1);
+	}
 };
 
 
@@ -238,7 +272,8 @@ public:
 
 	RequestBuilder(
 		Original &&builder,
-		Fn<void(const MTP::Error&)> commonFailHandler);
+		Fn<void(const MTP::Error&)> commonFailHandler,
+		Output::Stats *stats);
 
 	[[nodiscard]] RequestBuilder &done(FnMut<void()> &&handler);
 	[[nodiscard]] RequestBuilder &done(
@@ -251,15 +286,18 @@ public:
 private:
 	Original _builder;
 	Fn<void(const MTP::Error&)> _commonFailHandler;
+	Output::Stats *_stats = nullptr;
 
 };
 
 template <typename Request>
 ApiWrap::RequestBuilder<Request>::RequestBuilder(
 	Original &&builder,
-	Fn<void(const MTP::Error&)> commonFailHandler)
+	Fn<void(const MTP::Error&)> commonFailHandler,
+	Output::Stats *stats)
 : _builder(std::move(builder))
-, _commonFailHandler(std::move(commonFailHandler)) {
+, _commonFailHandler(std::move(commonFailHandler))
+, _stats(stats) {
 }
 
 template <typename Request>
@@ -267,7 +305,16 @@ auto ApiWrap::RequestBuilder<Request>::done(
 	FnMut<void()> &&handler
 ) -> RequestBuilder& {
 	if (handler) {
-		[[maybe_unused]] auto &silence_warning = _builder.done(std::move(handler));
+		[[maybe_unused]] auto &silence_warning = _builder.done(FnMut<void()>([
+			stats = _stats,
+			sent = crl::now(),
+			handler = std::move(handler)
+		]() mutable {
+			if (stats) {
+				stats->addRequest(crl::now() - sent);
+			}
+			handler();
+		}));
 	}
 	return *this;
 }
@@ -277,7 +324,17 @@ auto ApiWrap::RequestBuilder<Request>::done(
 	FnMut<void(Response &&)> &&handler
 ) -> RequestBuilder& {
 	if (handler) {
-		[[maybe_unused]] auto &silence_warning = _builder.done(std::move(handler));
+		[[maybe_unused]] auto &silence_warning = _builder.done(
+			FnMut<void(Response &&)>([
+				stats = _stats,
+				sent = crl::now(),
+				handler = std::move(handler)
+			](Response &&result) mutable {
+				if (stats) {
+					stats->addRequest(crl::now() - sent);
+				}
+				handler(std::move(result));
+			}));
 	}
 	return *this;
 }
@@ -353,7 +410,8 @@ auto ApiWrap::mainRequest(Request &&request) {
 
 	return RequestBuilder<MTPInvokeWithTakeout<Request>>(
 		std::move(original),
-		[=](const MTP::Error &result) { error(result); });
+		[=](const MTP::Error &result) { error(result); },
+		_stats);
 }
 
 template <typename Request>
@@ -372,8 +430,10 @@ auto ApiWrap::fileRequest(const Data::FileLocation &location, int64 offset) {
 	Expects(location.dcId != 0
 		|| location.data.type() == mtpc_inputTakeoutFileLocation);
 	Expects(_takeoutId.has_value());
+	Expects(_fileProcess != nullptr);
 	Expects(_fileProcess->requestId == 0);
 
+	const auto randomId = _fileProcess->randomId;
 	return std::move(_mtp.request(MTPInvokeWithTakeout<MTPupload_GetFile>(
 		MTP_long(*_takeoutId),
 		MTPupload_GetFile(
@@ -382,7 +442,12 @@ auto ApiWrap::fileRequest(const Data::FileLocation &location, int64 offset) {
 			MTP_long(offset),
 			MTP_int(kFileChunkSize))
 	)).fail([=](const MTP::Error &result) {
-		_fileProcess->requestId = 0;
+		if (!_fileProcess || _fileProcess->randomId != randomId) {
+			return;
+		}
+		if (const auto request = _fileProcess->findRequest(offset)) {
+			request->requestId = 0;
+		}
 		if (result.type() == u"TAKEOUT_FILE_EMPTY"_q
 			&& _otherDataProcess != nullptr) {
 			filePartDone(
@@ -397,8 +462,13 @@ auto ApiWrap::fileRequest(const Data::FileLocation &location, int64 offset) {
 			filePartUnavailable();
 		} else if (result.code() == 400
 			&& result.type().startsWith(u"FILE_REFERENCE_"_q)) {
-			filePartRefreshReference(offset);
+			// Parts failed with the old reference are sent again
+			// when the refreshed one is received.
+			if (!_fileProcess->requestId) {
+				filePartRefreshReference();
+			}
 		} else {
+			cancelFileRequests();
 			error(std::move(result));
 		}
 	}).toDC(MTP::ShiftDcId(location.dcId, MTP::kExportMediaDcShift)));
@@ -426,6 +496,11 @@ void ApiWrap::startExport(
 
 	_settings = std::make_unique<Settings>(settings);
 	_stats = stats;
+	_checkpoint = std::make_unique<Checkpoint>(_settings->path, *_settings);
+	if (const auto count = _checkpoint->count()) {
+		LOG(("Export Info: Resuming export, %1 files were written before."
+			).arg(count));
+	}
 	_startProcess = std::make_unique<StartProcess>();
 	_startProcess->done = std::move(done);
 
@@ -1183,8 +1258,14 @@ void ApiWrap::requestMessages(
 	_chatProcess->fileProgress = std::move(progress);
 	_chatProcess->handleSlice = std::move(slice);
 	_chatProcess->done = std::move(done);
+	_chatProcess->largestIdPlusOne = _chatProcess->splitStartIdPlusOne();
 
-	requestMessagesCount(0);
+	// Per split counts don't depend on each other, request them at once.
+	const auto splits = int(_chatProcess->info.splits.size());
+	_chatProcess->countsLeft = splits;
+	for (auto i = 0; i != splits; ++i) {
+		requestMessagesCount(i);
+	}
 }
 
 void ApiWrap::requestMessagesCount(int localSplitIndex) {
@@ -1255,8 +1336,8 @@ void ApiWrap::messagesCountLoaded(int localSplitIndex, int count) {
 	Expects(localSplitIndex < _chatProcess->info.splits.size());
 
 	_chatProcess->info.messagesCountPerSplit[localSplitIndex] = count;
-	if (localSplitIndex + 1 < _chatProcess->info.splits.size()) {
-		requestMessagesCount(localSplitIndex + 1);
+	if (--_chatProcess->countsLeft > 0) {
+		return;
 	} else if (_chatProcess->start(_chatProcess->info)) {
 		requestMessagesSlice();
 	}
@@ -1265,6 +1346,10 @@ void ApiWrap::messagesCountLoaded(int localSplitIndex, int count) {
 void ApiWrap::finishExport(FnMut<void()> done) {
 	const auto guard = gsl::finally([&] { _takeoutId = std::nullopt; });
 
+	if (_checkpoint) {
+		_checkpoint->finish();
+	}
+
 	mainRequest(MTPaccount_FinishTakeoutSession(
 		MTP_flags(MTPaccount_FinishTakeoutSession::Flag::f_success)
 	)).done(std::move(done)).send();
@@ -1276,8 +1361,7 @@ void ApiWrap::skipFile(uint64 randomId) {
 	}
 	LOG(("Export Info: File skipped."));
 	Assert(!_fileProcess->requests.empty());
-	Assert(_fileProcess->requestId != 0);
-	_mtp.request(base::take(_fileProcess->requestId)).cancel();
+	cancelFileRequests();
 	base::take(_fileProcess)->done(QString());
 }
 
@@ -1598,7 +1682,7 @@ void ApiWrap::requestMessagesSlice() {
 
 	const auto count = _chatProcess->info.messagesCountPerSplit[
 		_chatProcess->localSplitIndex];
-	if (!count) {
+	if (!count || _chatProcess->splitSkipped()) {
 		loadMessagesFiles({});
 		return;
 	}
@@ -1634,11 +1718,13 @@ void ApiWrap::requestChatMessages(
 		FnMut<void(MTPmessages_Messages&&)> done) {
 	Expects(_chatProcess != nullptr);
 
-	_chatProcess->requestDone = std::move(done);
+	using Done = FnMut<void(MTPmessages_Messages&&)>;
+	const auto shared = std::make_shared<Done>(std::move(done));
 	const auto doneHandler = [=](MTPmessages_Messages &&result) {
 		Expects(_chatProcess != nullptr);
 
-		base::take(_chatProcess->requestDone)(std::move(result));
+		_chatProcess->requestId = 0;
+		base::take(*shared)(std::move(result));
 	};
 	const auto splitsCount = int(_splits.size());
 	const auto realPeerInput = (splitIndex >= 0)
@@ -1648,35 +1734,41 @@ void ApiWrap::requestChatMessages(
 		? splitIndex
 		: (splitsCount + splitIndex);
 	if (_chatProcess->info.onlyMyMessages) {
-		splitRequest(realSplitIndex, MTPmessages_Search(
-			MTP_flags(MTPmessages_Search::Flag::f_from_id),
-			realPeerInput,
-			MTP_string(), // query
-			MTP_inputPeerSelf(),
-			MTPInputPeer(), // saved_peer_id
-			MTPVector<MTPReaction>(), // saved_reaction
-			MTPint(), // top_msg_id
-			MTP_inputMessagesFilterEmpty(),
-			MTP_int(0), // min_date
-			MTP_int(0), // max_date
-			MTP_int(offsetId),
-			MTP_int(addOffset),
-			MTP_int(limit),
-			MTP_int(0), // max_id
-			MTP_int(0), // min_id
-			MTP_long(0) // hash
-		)).done(doneHandler).send();
+		_chatProcess->requestId = splitRequest(
+			realSplitIndex,
+			MTPmessages_Search(
+				MTP_flags(MTPmessages_Search::Flag::f_from_id),
+				realPeerInput,
+				MTP_string(), // query
+				MTP_inputPeerSelf(),
+				MTPInputPeer(), // saved_peer_id
+				MTPVector<MTPReaction>(), // saved_reaction
+				MTPint(), // top_msg_id
+				MTP_inputMessagesFilterEmpty(),
+				MTP_int(0), // min_date
+				MTP_int(0), // max_date
+				MTP_int(offsetId),
+				MTP_int(addOffset),
+				MTP_int(limit),
+				MTP_int(0), // max_id
+				MTP_int(0), // min_id
+				MTP_long(0) // hash
+			)
+		).done(doneHandler).send();
 	} else {
-		splitRequest(realSplitIndex, MTPmessages_GetHistory(
-			realPeerInput,
-			MTP_int(offsetId),
-			MTP_int(0), // offset_date
-			MTP_int(addOffset),
-			MTP_int(limit),
-			MTP_int(0), // max_id
-			MTP_int(0), // min_id
-			MTP_long(0)  // hash
-		)).fail([=](const MTP::Error &error) {
+		_chatProcess->requestId = splitRequest(
+			realSplitIndex,
+			MTPmessages_GetHistory(
+				realPeerInput,
+				MTP_int(offsetId),
+				MTP_int(0), // offset_date
+				MTP_int(addOffset),
+				MTP_int(limit),
+				MTP_int(0), // max_id
+				MTP_int(0), // min_id
+				MTP_long(0)  // hash
+			)
+		).fail([=](const MTP::Error &error) {
 			Expects(_chatProcess != nullptr);
 
 			if (error.type() == u"CHANNEL_PRIVATE"_q) {
@@ -1691,7 +1783,7 @@ void ApiWrap::requestChatMessages(
 						offsetId,
 						addOffset,
 						limit,
-						base::take(_chatProcess->requestDone));
+						base::take(*shared));
 					return true;
 				}
 			}
@@ -1921,17 +2013,33 @@ void ApiWrap::finishMessagesSlice() {
 		if (splitIndex < 0) {
 			slice = AdjustMigrateMessageIds(std::move(slice));
 		}
-		if (!_chatProcess->handleSlice(std::move(slice))) {
-			return;
-		}
 	}
 	if (_chatProcess->lastSlice
 		&& (++_chatProcess->localSplitIndex
 			< _chatProcess->info.splits.size())) {
 		_chatProcess->lastSlice = false;
-		_chatProcess->largestIdPlusOne = 1;
+		_chatProcess->largestIdPlusOne = _chatProcess->splitStartIdPlusOne();
 	}
-	if (!_chatProcess->lastSlice) {
+
+	// Request the next slice before writing this one, so that the network
+	// request is in flight while the slice is being rendered. Empty splits
+	// are finished synchronously and must wait for the write to complete.
+	const auto prefetch = !_chatProcess->lastSlice
+		&& !_chatProcess->splitSkipped()
+		&& (_chatProcess->info.messagesCountPerSplit[
+			_chatProcess->localSplitIndex] > 0);
+	if (prefetch) {
+		requestMessagesSlice();
+	}
+	if (!slice.list.empty() && !_chatProcess->handleSlice(std::move(slice))) {
+		if (const auto requestId = base::take(_chatProcess->requestId)) {
+			_mtp.request(requestId).cancel();
+		}
+		return;
+	}
+	if (prefetch) {
+		return;
+	} else if (!_chatProcess->lastSlice) {
 		requestMessagesSlice();
 	} else {
 		finishMessages();
@@ -2084,19 +2192,76 @@ bool ApiWrap::writePreloadedFile(
 	if (const auto path = _fileCache->find(file.location)) {
 		file.relativePath = *path;
 		return true;
+	} else if (const auto path = findCheckpointFile(file.location)) {
+		file.relativePath = *path;
+		_fileCache->save(file.location, file.relativePath);
+		return true;
+	} else if (const auto path = findSharedMediaFile(file)) {
+		file.relativePath = *path;
+		_fileCache->save(file.location, file.relativePath);
+		return true;
 	} else if (!file.content.isEmpty()) {
 		const auto process = prepareFileProcess(file, origin);
-		if (const auto result = process->file.writeBlock(file.content)) {
+		auto &output = process->file;
+		if (const auto result = output.writeBlock(file.content); !result) {
+			ioError(result);
+		} else if (const auto result = output.flush(); !result) {
+			ioError(result);
+		} else {
 			file.relativePath = process->relativePath;
 			_fileCache->save(file.location, file.relativePath);
-		} else {
-			ioError(result);
 		}
 		return true;
 	}
 	return false;
 }
 
+void ApiWrap::setSharedMediaFolder(const QString &folder) {
+	_sharedMediaFolder = folder.endsWith('/') ? folder : (folder + '/');
+}
+
+QString ApiWrap::sharedMediaPath(const Data::File &file) const {
+	if (_sharedMediaFolder.isEmpty() || file.size <= 0) {
+		return QString();
+	}
+	const auto key = ComputeCheckpointKey(file.location);
+	if (!key) {
+		return QString();
+	}
+	const auto suffix = QFileInfo(file.suggestedPath).suffix();
+	return _sharedMediaFolder
+		+ QString::number(key->type, 16)
+		+ '_'
+		+ QString::number(key->id, 16)
+		+ (suffix.isEmpty() ? QString() : ('.' + suffix));
+}
+
+std::optional<QString> ApiWrap::findSharedMediaFile(
+		const Data::File &file) const {
+	Expects(_settings != nullptr);
+
+	const auto path = sharedMediaPath(file);
+	if (path.isEmpty()) {
+		return std::nullopt;
+	}
+	// Interrupted downloads are left with a smaller size.
+	const auto info = QFileInfo(path);
+	if (!info.exists() || info.size() != file.size) {
+		return std::nullopt;
+	}
+	return QDir(_settings->path).relativeFilePath(path);
+}
+
+std::optional<QString> ApiWrap::findCheckpointFile(
+		const Data::FileLocation &location) {
+	if (!_checkpoint) {
+		return std::nullopt;
+	} else if (const auto key = ComputeCheckpointKey(location)) {
+		return _checkpoint->find(*key);
+	}
+	return std::nullopt;
+}
+
 void ApiWrap::loadFile(
 		const Data::File &file,
 		const Data::FileOrigin &origin,
@@ -2122,7 +2287,7 @@ void ApiWrap::loadFile(
 
 	loadFilePart();
 
-	Ensures(_fileProcess->requestId != 0);
+	Ensures(!_fileProcess->requests.empty());
 }
 
 auto ApiWrap::prepareFileProcess(
@@ -2131,11 +2296,14 @@ auto ApiWrap::prepareFileProcess(
 -> std::unique_ptr<FileProcess> {
 	Expects(_settings != nullptr);
 
-	const auto relativePath = Output::File::PrepareRelativePath(
-		_settings->path,
-		file.suggestedPath);
+	const auto shared = sharedMediaPath(file);
+	const auto relativePath = !shared.isEmpty()
+		? QDir(_settings->path).relativeFilePath(shared)
+		: Output::File::PrepareRelativePath(
+			_settings->path,
+			file.suggestedPath);
 	auto result = std::make_unique<FileProcess>(
-		_settings->path + relativePath,
+		shared.isEmpty() ? (_settings->path + relativePath) : shared,
 		_stats);
 	result->relativePath = relativePath;
 	result->location = file.location;
@@ -2146,36 +2314,70 @@ auto ApiWrap::prepareFileProcess(
 }
 
 void ApiWrap::loadFilePart() {
-	if (!_fileProcess
-		|| _fileProcess->requestId
-		|| _fileProcess->requests.size() >= kFileRequestsCount
-		|| (_fileProcess->size > 0
-			&& _fileProcess->offset >= _fileProcess->size)) {
-		return;
-	}
+	// Files of unknown size are requested one part at a time,
+	// for the others several parts are kept in flight.
+	while (_fileProcess
+		&& !_fileProcess->requestId
+		&& _fileProcess->requests.size() < kFileRequestsCount
+		&& ((_fileProcess->size > 0)
+			? (_fileProcess->offset < _fileProcess->size)
+			: _fileProcess->requests.empty())) {
+		const auto offset = _fileProcess->offset;
+		_fileProcess->requests.push_back({ offset });
+		_fileProcess->offset += kFileChunkSize;
+		sendFilePart(offset);
+	}
+}
+
+void ApiWrap::sendFilePart(int64 offset) {
+	Expects(_fileProcess != nullptr);
+
+	const auto request = _fileProcess->findRequest(offset);
+	Assert(request != nullptr);
 
-	const auto offset = _fileProcess->offset;
-	_fileProcess->requests.push_back({ offset });
-	_fileProcess->requestId = fileRequest(
+	const auto randomId = _fileProcess->randomId;
+	const auto dcId = _fileProcess->location.dcId;
+	const auto sent = crl::now();
+	request->requestId = fileRequest(
 		_fileProcess->location,
-		_fileProcess->offset
+		offset
 	).done([=](const MTPupload_File &result) {
-		_fileProcess->requestId = 0;
-		filePartDone(offset, result);
+		if (_stats) {
+			_stats->addFileRequest(
+				dcId,
+				crl::now() - sent,
+				((result.type() == mtpc_upload_file)
+					? result.c_upload_file().vbytes().v.size()
+					: 0));
+		}
+		if (_fileProcess && _fileProcess->randomId == randomId) {
+			filePartDone(offset, result);
+		}
 	}).send();
-	_fileProcess->offset += kFileChunkSize;
+}
+
+void ApiWrap::resendFileParts() {
+	Expects(_fileProcess != nullptr);
+	Expects(_fileProcess->requestId == 0);
 
-	if (_fileProcess->size > 0
-		&& _fileProcess->requests.size() < kFileRequestsCount) {
-		// Only one request at a time supported right now.
-		//const auto runner = _runner;
-		//crl::on_main([=] {
-		//	QTimer::singleShot(kFileNextRequestDelay, [=] {
-		//		runner([=] {
-		//			loadFilePart();
-		//		});
-		//	});
-		//});
+	for (const auto &request : _fileProcess->requests) {
+		if (!request.requestId && request.bytes.isEmpty()) {
+			sendFilePart(request.offset);
+		}
+	}
+	loadFilePart();
+}
+
+void ApiWrap::cancelFileRequests() {
+	Expects(_fileProcess != nullptr);
+
+	if (const auto requestId = base::take(_fileProcess->requestId)) {
+		_mtp.request(requestId).cancel();
+	}
+	for (auto &request : _fileProcess->requests) {
+		if (const auto requestId = base::take(request.requestId)) {
+			_mtp.request(requestId).cancel();
+		}
 	}
 }
 
@@ -2184,12 +2386,14 @@ void ApiWrap::filePartDone(int64 offset, const MTPupload_File &result) {
 	Expects(!_fileProcess->requests.empty());
 
 	if (result.type() == mtpc_upload_fileCdnRedirect) {
+		cancelFileRequests();
 		error("Cdn redirect is not supported.");
 		return;
 	}
 	const auto &data = result.c_upload_file();
 	if (data.vbytes().v.isEmpty()) {
 		if (_fileProcess->size > 0) {
+			cancelFileRequests();
 			error("Empty bytes received in file part.");
 			return;
 		}
@@ -2199,23 +2403,23 @@ void ApiWrap::filePartDone(int64 offset, const MTPupload_File &result) {
 			return;
 		}
 	} else {
-		using Request = FileProcess::Request;
-		auto &requests = _fileProcess->requests;
-		const auto i = ranges::find(
-			requests,
-			offset,
-			[](const Request &request) { return request.offset; });
-		Assert(i != end(requests));
+		const auto request = _fileProcess->findRequest(offset);
+		Assert(request != nullptr);
 
-		i->bytes = data.vbytes().v;
+		request->requestId = 0;
+		request->bytes = data.vbytes().v;
 
+		// Parts may arrive out of order, they're written as they line up.
+		auto &requests = _fileProcess->requests;
 		auto &file = _fileProcess->file;
 		while (!requests.empty() && !requests.front().bytes.isEmpty()) {
 			const auto &bytes = requests.front().bytes;
 			if (const auto result = file.writeBlock(bytes); !result) {
+				cancelFileRequests();
 				ioError(result);
 				return;
 			}
+			_fileProcess->hash.addData(bytes);
 			requests.pop_front();
 		}
 
@@ -2233,13 +2437,25 @@ void ApiWrap::filePartDone(int64 offset, const MTPupload_File &result) {
 		}
 	}
 
+	if (const auto result = _fileProcess->file.flush(); !result) {
+		cancelFileRequests();
+		ioError(result);
+		return;
+	}
 	auto process = base::take(_fileProcess);
 	const auto relativePath = process->relativePath;
 	_fileCache->save(process->location, relativePath);
+	if (const auto key = ComputeCheckpointKey(process->location)) {
+		_checkpoint->save(
+			*key,
+			relativePath,
+			process->file.size(),
+			process->hash.result());
+	}
 	process->done(process->relativePath);
 }
 
-void ApiWrap::filePartRefreshReference(int64 offset) {
+void ApiWrap::filePartRefreshReference() {
 	Expects(_fileProcess != nullptr);
 	Expects(_fileProcess->requestId == 0);
 
@@ -2254,7 +2470,7 @@ void ApiWrap::filePartRefreshReference(int64 offset) {
 			return true;
 		}).done([=](const MTPstories_Stories &result) {
 			_fileProcess->requestId = 0;
-			filePartExtractReference(offset, result);
+			filePartExtractReference(result);
 		}).send();
 		return;
 	} else if (!origin.messageId) {
@@ -2282,7 +2498,7 @@ void ApiWrap::filePartRefreshReference(int64 offset) {
 			return true;
 		}).done([=](const MTPmessages_Messages &result) {
 			_fileProcess->requestId = 0;
-			filePartExtractReference(offset, result);
+			filePartExtractReference(result);
 		}).send();
 	} else {
 		_fileProcess->requestId = splitRequest(
@@ -2298,13 +2514,12 @@ void ApiWrap::filePartRefreshReference(int64 offset) {
 			return true;
 		}).done([=](const MTPmessages_Messages &result) {
 			_fileProcess->requestId = 0;
-			filePartExtractReference(offset, result);
+			filePartExtractReference(result);
 		}).send();
 	}
 }
 
 void ApiWrap::filePartExtractReference(
-		int64 offset,
 		const MTPmessages_Messages &result) {
 	Expects(_fileProcess != nullptr);
 	Expects(_fileProcess->requestId == 0);
@@ -2331,13 +2546,7 @@ void ApiWrap::filePartExtractReference(
 					_fileProcess->location,
 					message.thumb().file.location);
 				if (refresh1 || refresh2) {
-					_fileProcess->requestId = fileRequest(
-						_fileProcess->location,
-						offset
-					).done([=](const MTPupload_File &result) {
-						_fileProcess->requestId = 0;
-						filePartDone(offset, result);
-					}).send();
+					resendFileParts();
 					return;
 				}
 			}
@@ -2347,7 +2556,6 @@ void ApiWrap::filePartExtractReference(
 }
 
 void ApiWrap::filePartExtractReference(
-		int64 offset,
 		const MTPstories_Stories &result) {
 	Expects(_fileProcess != nullptr);
 	Expects(_fileProcess->requestId == 0);
@@ -2364,13 +2572,7 @@ void ApiWrap::filePartExtractReference(
 				_fileProcess->location,
 				story.thumb().file.location);
 			if (refresh1 || refresh2) {
-				_fileProcess->requestId = fileRequest(
-					_fileProcess->location,
-					offset
-				).done([=](const MTPupload_File &result) {
-					_fileProcess->requestId = 0;
-					filePartDone(offset, result);
-				}).send();
+				resendFileParts();
 				return;
 			}
 		}
@@ -2384,6 +2586,7 @@ void ApiWrap::filePartUnavailable() {
 
 	LOG(("Export Error: File unavailable."));
 
+	cancelFileRequests();
 	base::take(_fileProcess)->done(QString());
 }
 
@@ -37,6 +37,7 @@ class Stats;
 } // namespace Output
 
 struct Settings;
+class Checkpoint;
 
 class ApiWrap {
 public:
@@ -55,6 +56,10 @@ public:
 		Output::Stats *stats,
 		FnMut<void(StartInfo)> done);
 
+	// Media files of known size are kept there, named by their location,
+	// and reused by every chat and every export linking to this folder.
+	void setSharedMediaFolder(const QString &folder);
+
 	void requestDialogsList(
 		Fn<bool(int count)> progress,
 		FnMut<void(Data::DialogsInfo&&)> done);
@@ -210,21 +215,25 @@ private:
 	bool writePreloadedFile(
 		Data::File &file,
 		const Data::FileOrigin &origin);
+	[[nodiscard]] std::optional<QString> findCheckpointFile(
+		const Data::FileLocation &location);
+	[[nodiscard]] QString sharedMediaPath(const Data::File &file) const;
+	[[nodiscard]] std::optional<QString> findSharedMediaFile(
+		const Data::File &file) const;
 	void loadFile(
 		const Data::File &file,
 		const Data::FileOrigin &origin,
 		Fn<bool(FileProgress)> progress,
 		FnMut<void(QString)> done);
 	void loadFilePart();
+	void sendFilePart(int64 offset);
+	void resendFileParts();
+	void cancelFileRequests();
 	void filePartDone(int64 offset, const MTPupload_File &result);
 	void filePartUnavailable();
-	void filePartRefreshReference(int64 offset);
-	void filePartExtractReference(
-		int64 offset,
-		const MTPmessages_Messages &result);
-	void filePartExtractReference(
-		int64 offset,
-		const MTPstories_Stories &result);
+	void filePartRefreshReference();
+	void filePartExtractReference(const MTPmessages_Messages &result);
+	void filePartExtractReference(const MTPstories_Stories &result);
 
 	template <typename Request>
 	class RequestBuilder;
@@ -253,6 +262,8 @@ private:
 
 	std::unique_ptr<StartProcess> _startProcess;
 	std::unique_ptr<LoadedFileCache> _fileCache;
+	std::unique_ptr<Checkpoint> _checkpoint;
+	QString _sharedMediaFolder;
 	std::unique_ptr<ContactsProcess> _contactsProcess;
 	std::unique_ptr<UserpicsProcess> _userpicsProcess;
 	std::unique_ptr<StoriesProcess> _storiesProcess;
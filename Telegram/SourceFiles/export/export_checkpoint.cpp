@@ -0,0 +1,183 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "export/export_checkpoint.h"
+
+#include "export/export_settings.h"
+
+#include <QtCore/QCryptographicHash>
+
+namespace Export {
+namespace {
+
+constexpr auto kManifestName = ".export_checkpoint";
+constexpr auto kManifestVersion = 1;
+
+[[nodiscard]] QByteArray ComputeHeader(const Settings &settings) {
+	auto buffer = mtpBuffer();
+	settings.singlePeer.write(buffer);
+	auto data = u"%1 %2 %3 %4 %5 %6 %7 %8"_q
+		.arg(int(settings.format))
+		.arg(settings.types.value())
+		.arg(settings.fullChats.value())
+		.arg(settings.media.types.value())
+		.arg(settings.media.sizeLimit)
+		.arg(settings.singlePeerFrom)
+		.arg(settings.singlePeerTill)
+		.arg(settings.onlyNewMessages ? 1 : 0)
+		.toUtf8();
+	data.append(
+		reinterpret_cast<const char*>(buffer.data()),
+		buffer.size() * sizeof(mtpPrime));
+	const auto fingerprint = QCryptographicHash::hash(
+		data,
+		QCryptographicHash::Sha1).toHex();
+	return "TDESKTOP_EXPORT_CHECKPOINT "
+		+ QByteArray::number(kManifestVersion)
+		+ ' '
+		+ fingerprint
+		+ '\n';
+}
+
+[[nodiscard]] QString ManifestPath(const QString &folder) {
+	return folder + kManifestName;
+}
+
+} // namespace
+
+Checkpoint::Checkpoint(const QString &folder, const Settings &settings)
+: _folder(folder)
+, _header(ComputeHeader(settings))
+, _file(ManifestPath(folder)) {
+	load();
+}
+
+bool Checkpoint::Resumable(
+		const QString &folder,
+		const Settings &settings) {
+	auto file = QFile(ManifestPath(folder));
+	return file.open(QIODevice::ReadOnly)
+		&& (file.readLine() == ComputeHeader(settings));
+}
+
+void Checkpoint::load() {
+	if (!_file.open(QIODevice::ReadOnly)) {
+		return;
+	} else if (_file.readLine() != _header) {
+		_file.close();
+		return;
+	}
+	while (!_file.atEnd()) {
+		const auto line = _file.readLine();
+		if (!line.endsWith('\n')) {
+			// The last line could be written only partially.
+			break;
+		}
+		const auto parts = line.chopped(1).split('\t');
+		if (parts.size() != 5) {
+			continue;
+		}
+		const auto key = Key{
+			.type = parts[0].toULongLong(),
+			.id = parts[1].toULongLong(),
+		};
+		_entries[key] = Entry{
+			.relativePath = QString::fromUtf8(parts[4]),
+			.size = parts[2].toLongLong(),
+			.hash = QByteArray::fromHex(parts[3]),
+		};
+	}
+	_file.close();
+	_appending = true;
+}
+
+int Checkpoint::count() const {
+	return int(_entries.size());
+}
+
+std::optional<QString> Checkpoint::find(Key key) {
+	const auto i = _entries.find(key);
+	if (i == end(_entries)) {
+		return std::nullopt;
+	}
+	auto &entry = i->second;
+	if (!entry.verified) {
+		auto file = QFile(_folder + entry.relativePath);
+		if (!file.exists()
+			|| file.size() != entry.size
+			|| !file.open(QIODevice::ReadOnly)) {
+			_entries.erase(i);
+			return std::nullopt;
+		}
+		auto hash = QCryptographicHash(QCryptographicHash::Sha1);
+		if (!hash.addData(&file) || hash.result() != entry.hash) {
+			_entries.erase(i);
+			return std::nullopt;
+		}
+		entry.verified = true;
+	}
+	return entry.relativePath;
+}
+
+void Checkpoint::save(
+		Key key,
+		const QString &relativePath,
+		int64 size,
+		const QByteArray &hash) {
+	const auto line = QByteArray::number(key.type)
+		+ '\t'
+		+ QByteArray::number(key.id)
+		+ '\t'
+		+ QByteArray::number(size)
+		+ '\t'
+		+ hash.toHex()
+		+ '\t'
+		+ relativePath.toUtf8()
+		+ '\n';
+	if (write(line)) {
+		_entries[key] = Entry{
+			.relativePath = relativePath,
+			.size = size,
+			.hash = hash,
+			.verified = true,
+		};
+	}
+}
+
+bool Checkpoint::write(const QByteArray &line) {
+	if (_failed) {
+		return false;
+	} else if (!_file.isOpen()) {
+		const auto mode = _appending
+			? QIODevice::Append
+			: (QIODevice::WriteOnly | QIODevice::Truncate);
+		if (!_file.open(mode)
+			|| (!_appending && _file.write(_header) != _header.size())) {
+			LOG(("Export Error: Could not write checkpoint to '%1'."
+				).arg(_file.fileName()));
+			_failed = true;
+			_file.close();
+			return false;
+		}
+		_appending = true;
+	}
+	if (_file.write(line) != line.size() || !_file.flush()) {
+		_failed = true;
+		_file.close();
+		return false;
+	}
+	return true;
+}
+
+void Checkpoint::finish() {
+	_entries.clear();
+	_file.close();
+	_file.remove();
+	_failed = true;
+}
+
+} // namespace Export
@@ -0,0 +1,70 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include "base/flat_map.h"
+
+#include <QtCore/QFile>
+
+namespace Export {
+
+struct Settings;
+
+// Manifest of the media files already written to the export folder.
+// An export restarted with the same settings to the same folder takes
+// them from the disk instead of downloading again. The manifest is
+// removed when the export is finished successfully.
+class Checkpoint final {
+public:
+	struct Key {
+		uint64 type = 0;
+		uint64 id = 0;
+
+		friend inline auto operator<=>(Key, Key) = default;
+		friend inline bool operator==(Key, Key) = default;
+	};
+
+	Checkpoint(const QString &folder, const Settings &settings);
+
+	[[nodiscard]] static bool Resumable(
+		const QString &folder,
+		const Settings &settings);
+
+	[[nodiscard]] int count() const;
+
+	// Checks that the file is still there with the same size and hash.
+	[[nodiscard]] std::optional<QString> find(Key key);
+
+	void save(
+		Key key,
+		const QString &relativePath,
+		int64 size,
+		const QByteArray &hash);
+	void finish();
+
+private:
+	struct Entry {
+		QString relativePath;
+		int64 size = 0;
+		QByteArray hash;
+		bool verified = false;
+	};
+
+	void load();
+	bool write(const QByteArray &line);
+
+	const QString _folder;
+	const QByteArray _header;
+	QFile _file;
+	base::flat_map<Key, Entry> _entries;
+	bool _appending = false;
+	bool _failed = false;
+
+};
+
+} // namespace Export
@@ -8,9 +8,11 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "export/export_controller.h"
 
 #include "export/export_api_wrap.h"
+#include "export/export_delta.h"
 #include "export/export_settings.h"
 #include "export/data/export_data_types.h"
 #include "export/output/export_output_abstract.h"
+#include "export/output/export_output_archive.h"
 #include "export/output/export_output_result.h"
 #include "export/output/export_output_stats.h"
 #include "mtproto/mtp_instance.h"
@@ -20,12 +22,31 @@ namespace {
 
 const auto kNullStateCallback = [](ProcessingState&) {};
 
+// The estimate jumps a lot in the beginning of the export.
+constexpr auto kEtaMinElapsed = 10 * crl::time(1000);
+constexpr auto kEtaMinProgress = 0.01;
+
 Settings NormalizeSettings(const Settings &settings) {
+	auto result = base::duplicate(settings);
+	if (result.onlyNewMessages) {
+		// Delta exports need the folder with the shared media files.
+		result.packToArchive = false;
+	}
 	if (!settings.onlySinglePeer()) {
-		return base::duplicate(settings);
+		return result;
 	}
-	auto result = base::duplicate(settings);
 	result.types = result.fullChats = Settings::Type::AnyChatsMask;
+	result.onlyNewMessages = false;
+	result.packToArchive = false;
+	return result;
+}
+
+[[nodiscard]] QString ArchivePath(const QString &folder) {
+	const auto base = folder.endsWith('/') ? folder.chopped(1) : folder;
+	auto result = base + u".zip"_q;
+	for (auto i = 1; QFile::exists(result); ++i) {
+		result = base + u" (%1).zip"_q.arg(i);
+	}
 	return result;
 }
 
@@ -63,6 +84,7 @@ private:
 	void ioError(const QString &path);
 	bool ioCatchError(Output::Result result);
 	void setFinishedState();
+	[[nodiscard]] bool packToArchive();
 
 	//void requestPasswordState();
 	//void passwordStateDone(const MTPaccount_Password &password);
@@ -81,6 +103,14 @@ private:
 	void exportOtherData();
 	void exportDialogs();
 	void exportNextDialog();
+	void applyLastExportedIds();
+	void noteExportedMessages(const Data::MessagesSlice &slice);
+	void logDialogThroughput() const;
+	void logStats() const;
+	[[nodiscard]] crl::time estimateRemaining(
+		const ProcessingState &state) const;
+	[[nodiscard]] Output::Result measureWrite(
+		FnMut<Output::Result()> write);
 
 	template <typename Callback = const decltype(kNullStateCallback) &>
 	ProcessingState prepareState(
@@ -106,12 +136,22 @@ private:
 	ApiWrap _api;
 	Settings _settings;
 	Environment _environment;
+	crl::time _exportStarted = 0;
 
 	Data::DialogsInfo _dialogsInfo;
 	int _dialogIndex = -1;
 
+	// Delta export, see Settings::onlyNewMessages.
+	QString _lastExportedIdsFolder;
+	LastExportedIds _lastExportedIds;
+
+	// Set if the finished export was packed, see Settings::packToArchive.
+	QString _archivePath;
+
 	int _messagesWritten = 0;
 	int _messagesCount = 0;
+	crl::time _dialogStarted = 0;
+	crl::time _dialogWriteDuration = 0;
 
 	int _userpicsWritten = 0;
 	int _userpicsCount = 0;
@@ -252,7 +292,17 @@ void ControllerObject::startExport(
 	}
 	_settings = NormalizeSettings(settings);
 	_environment = environment;
+	_exportStarted = crl::now();
 
+	if (_settings.onlyNewMessages) {
+		_lastExportedIdsFolder = QDir(_settings.path).absolutePath();
+		_lastExportedIds = ReadLastExportedIds(_lastExportedIdsFolder);
+		_api.setSharedMediaFolder(_lastExportedIdsFolder + u"/media/"_q);
+	}
+	if (_settings.packToArchive) {
+		// The folder is removed after packing, it should be our own.
+		_settings.forceSubPath = true;
+	}
 	_settings.path = Output::NormalizePath(_settings);
 	_writer = Output::CreateWriter(_settings.format);
 	fillExportSteps();
@@ -344,6 +394,15 @@ void ControllerObject::exportNext() {
 			return;
 		}
 		_api.finishExport([=] {
+			if (!_lastExportedIdsFolder.isEmpty()) {
+				WriteLastExportedIds(
+					_lastExportedIdsFolder,
+					_lastExportedIds);
+			}
+			if (_settings.packToArchive && !packToArchive()) {
+				return;
+			}
+			logStats();
 			setFinishedState();
 		});
 		return;
@@ -388,6 +447,7 @@ void ControllerObject::collectDialogsList() {
 		return true;
 	}, [=](Data::DialogsInfo &&result) {
 		_dialogsInfo = std::move(result);
+		applyLastExportedIds();
 		exportNext();
 	});
 }
@@ -502,6 +562,8 @@ void ControllerObject::exportNextDialog() {
 				return false;
 			}
 			_messagesWritten = 0;
+			_dialogStarted = crl::now();
+			_dialogWriteDuration = 0;
 			_messagesCount = ranges::accumulate(
 				info.messagesCountPerSplit,
 				0);
@@ -511,16 +573,23 @@ void ControllerObject::exportNextDialog() {
 			setState(stateDialogs(progress));
 			return true;
 		}, [=](Data::MessagesSlice &&result) {
-			if (ioCatchError(_writer->writeDialogSlice(result))) {
+			const auto started = crl::now();
+			if (ioCatchError(measureWrite([&] {
+				return _writer->writeDialogSlice(result);
+			}))) {
 				return false;
 			}
+			_dialogWriteDuration += crl::now() - started;
 			_messagesWritten += result.list.size();
+			noteExportedMessages(result);
 			setState(stateDialogs(DownloadProgress()));
 			return true;
 		}, [=] {
 			if (ioCatchError(_writer->writeDialogEnd())) {
 				return;
 			}
+			logDialogThroughput();
+			logStats();
 			exportNextDialog();
 		});
 		return;
@@ -531,6 +600,97 @@ void ControllerObject::exportNextDialog() {
 	exportNext();
 }
 
+void ControllerObject::applyLastExportedIds() {
+	if (_lastExportedIdsFolder.isEmpty()) {
+		return;
+	}
+	const auto skip = [](const Data::DialogInfo &info) {
+		return (info.lastExportedId > 0)
+			&& (info.topMessageId <= info.lastExportedId);
+	};
+	const auto apply = [&](std::vector<Data::DialogInfo> &list) {
+		for (auto &info : list) {
+			const auto i = _lastExportedIds.find(info.peerId);
+			if (i != end(_lastExportedIds)) {
+				info.lastExportedId = i->second;
+			}
+		}
+		// Chats without new messages are not exported at all.
+		list.erase(ranges::remove_if(list, skip), end(list));
+	};
+	apply(_dialogsInfo.chats);
+	apply(_dialogsInfo.left);
+}
+
+void ControllerObject::noteExportedMessages(
+		const Data::MessagesSlice &slice) {
+	if (_lastExportedIdsFolder.isEmpty() || slice.list.empty()) {
+		return;
+	}
+	const auto info = _dialogsInfo.item(_dialogIndex);
+	Assert(info != nullptr);
+
+	// Migrated history messages have negative ids here.
+	auto &till = _lastExportedIds[info->peerId];
+	till = std::max(till, slice.list.back().id);
+}
+
+void ControllerObject::logDialogThroughput() const {
+	if (!_messagesWritten) {
+		return;
+	}
+	const auto total = std::max(crl::now() - _dialogStarted, crl::time(1));
+	const auto writing = std::max(_dialogWriteDuration, crl::time(1));
+	LOG(("Export Info: Chat of %1 messages took %2 ms, "
+		"%3 ms of it writing (%4 messages/s written, %5 messages/s total)."
+		).arg(_messagesWritten
+		).arg(total
+		).arg(_dialogWriteDuration
+		).arg(_messagesWritten * 1000 / writing
+		).arg(_messagesWritten * 1000 / total));
+}
+
+void ControllerObject::logStats() const {
+	LOG(("Export Stats: %1"
+		).arg(QString::fromUtf8(_stats.serialize(
+			crl::now() - _exportStarted))));
+}
+
+Output::Result ControllerObject::measureWrite(
+		FnMut<Output::Result()> write) {
+	// Disk writes are counted by Output::File, the rest is serializing.
+	const auto started = crl::profile();
+	const auto writing = _stats.writeDuration();
+	auto result = write();
+	const auto total = crl::profile() - started;
+	const auto disk = _stats.writeDuration() - writing;
+	_stats.addSerializeDuration(std::max(total - disk, crl::profile_time()));
+	return result;
+}
+
+crl::time ControllerObject::estimateRemaining(
+		const ProcessingState &state) const {
+	if (!state.substepsTotal) {
+		return 0;
+	}
+	const auto part = [](int index, int count) {
+		return (count > 0) ? std::clamp(index / float64(count), 0., 1.) : 0.;
+	};
+	auto current = part(state.entityIndex, state.entityCount);
+	if (state.step == Step::Dialogs && state.entityCount > 0) {
+		current += part(state.itemIndex, state.itemCount)
+			/ state.entityCount;
+	}
+	const auto progress = (state.substepsPassed
+		+ state.substepsNow * std::min(current, 1.))
+		/ float64(state.substepsTotal);
+	const auto elapsed = crl::now() - _exportStarted;
+	if (elapsed < kEtaMinElapsed || progress < kEtaMinProgress) {
+		return 0;
+	}
+	return crl::time(elapsed * (1. - std::min(progress, 1.)) / progress);
+}
+
 template <typename Callback>
 ProcessingState ControllerObject::prepareState(
 		Step step,
@@ -546,6 +706,7 @@ ProcessingState ControllerObject::prepareState(
 	result.substepsPassed = _substepsPassed;
 	result.substepsNow = substepsInStep(_lastProcessingStep);
 	result.substepsTotal = _substepsTotal;
+	result.eta = estimateRemaining(result);
 	return result;
 }
 
@@ -657,11 +818,28 @@ int ControllerObject::substepsInStep(Step step) const {
 
 void ControllerObject::setFinishedState() {
 	setState(FinishedState{
-		_writer->mainFilePath(),
+		(_archivePath.isEmpty() ? _writer->mainFilePath() : _archivePath),
 		_stats.filesCount(),
 		_stats.bytesCount() });
 }
 
+bool ControllerObject::packToArchive() {
+	const auto started = crl::now();
+	const auto path = ArchivePath(_settings.path);
+	const auto result = Output::PackFolder(_settings.path, path);
+	if (!result) {
+		QFile::remove(path);
+		ioError(result.path);
+		return false;
+	}
+	QDir(_settings.path).removeRecursively();
+	_archivePath = path;
+	LOG(("Export Info: Packed to '%1' in %2 ms."
+		).arg(path
+		).arg(crl::now() - started));
+	return true;
+}
+
 Controller::Controller(
 	QPointer<MTP::Instance> mtproto,
 	const MTPInputPeer &peer)
@@ -70,6 +70,9 @@ struct ProcessingState {
 	QString bytesName;
 	int64 bytesLoaded = 0;
 	int64 bytesCount = 0;
+
+	// Estimated time left for the whole export, zero if not known yet.
+	crl::time eta = 0;
 };
 
 struct ApiErrorState {
@@ -0,0 +1,67 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "export/export_delta.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QSaveFile>
+
+namespace Export {
+namespace {
+
+constexpr auto kStateName = ".export_last_ids";
+constexpr auto kStateHeader = "TDESKTOP_EXPORT_LAST_IDS 1\n";
+
+[[nodiscard]] QString StatePath(const QString &folder) {
+	return (folder.endsWith('/') ? folder : (folder + '/')) + kStateName;
+}
+
+} // namespace
+
+LastExportedIds ReadLastExportedIds(const QString &folder) {
+	auto file = QFile(StatePath(folder));
+	if (!file.open(QIODevice::ReadOnly)
+		|| file.readLine() != QByteArray(kStateHeader)) {
+		return {};
+	}
+	auto result = LastExportedIds();
+	while (!file.atEnd()) {
+		const auto parts = file.readLine().trimmed().split('\t');
+		if (parts.size() != 2) {
+			continue;
+		}
+		const auto peerId = PeerId(PeerIdHelper(parts[0].toULongLong()));
+		const auto messageId = parts[1].toInt();
+		if (peerId && messageId > 0) {
+			result.emplace(peerId, messageId);
+		}
+	}
+	return result;
+}
+
+bool WriteLastExportedIds(
+		const QString &folder,
+		const LastExportedIds &ids) {
+	auto data = QByteArray(kStateHeader);
+	for (const auto &[peerId, messageId] : ids) {
+		data.append(QByteArray::number(peerId.value)
+			+ '\t'
+			+ QByteArray::number(messageId)
+			+ '\n');
+	}
+	auto file = QSaveFile(StatePath(folder));
+	if (!file.open(QIODevice::WriteOnly)
+		|| file.write(data) != data.size()
+		|| !file.commit()) {
+		LOG(("Export Error: Could not write last exported ids to '%1'."
+			).arg(file.fileName()));
+		return false;
+	}
+	return true;
+}
+
+} // namespace Export
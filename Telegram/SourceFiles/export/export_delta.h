@@ -0,0 +1,24 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include "base/flat_map.h"
+#include "data/data_peer_id.h"
+
+namespace Export {
+
+// Highest exported message id for each peer, kept in the folder that
+// receives the exports made with Settings::onlyNewMessages.
+using LastExportedIds = base::flat_map<PeerId, int32>;
+
+[[nodiscard]] LastExportedIds ReadLastExportedIds(const QString &folder);
+bool WriteLastExportedIds(
+	const QString &folder,
+	const LastExportedIds &ids);
+
+} // namespace Export
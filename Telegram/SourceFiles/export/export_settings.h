@@ -88,6 +88,15 @@ struct Settings {
 
 	TimeId availableAt = 0;
 
+	// Export only messages newer than the ones saved by the last export
+	// with this option to the same path. Such exports share one folder
+	// of media files, so a file is downloaded only once.
+	bool onlyNewMessages = false;
+
+	// Pack the finished export to a single ZIP archive next to the
+	// export folder and remove the folder.
+	bool packToArchive = false;
+
 	bool onlySinglePeer() const {
 		return singlePeer.type() != mtpc_inputPeerEmpty;
 	}
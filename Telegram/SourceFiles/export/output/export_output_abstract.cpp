@@ -7,6 +7,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #include "export/output/export_output_abstract.h"
 
+#include "export/export_checkpoint.h"
 #include "export/output/export_output_html_and_json.h"
 #include "export/output/export_output_html.h"
 #include "export/output/export_output_json.h"
@@ -31,11 +32,26 @@ QString NormalizePath(const Settings &settings) {
 	if (list.isEmpty() && !settings.forceSubPath) {
 		return result;
 	}
+	const auto prefix = QString(settings.onlySinglePeer()
+		? "ChatExport_"
+		: "DataExport_");
+
+	// Continue an interrupted export with the same settings.
+	if (!settings.forceSubPath && Checkpoint::Resumable(result, settings)) {
+		return result;
+	}
+	for (const auto &entry : list) {
+		if (!entry.isDir() || !entry.fileName().startsWith(prefix)) {
+			continue;
+		}
+		const auto path = entry.absoluteFilePath() + '/';
+		if (Checkpoint::Resumable(path, settings)) {
+			return path;
+		}
+	}
+
 	const auto date = QDate::currentDate();
-	const auto base = QString(settings.onlySinglePeer()
-		? "ChatExport_%1"
-		: "DataExport_%1"
-	).arg(date.toString(Qt::ISODate));
+	const auto base = prefix + date.toString(Qt::ISODate);
 	const auto add = [&](int i) {
 		return base + (i ? " (" + QString::number(i) + ')' : QString());
 	};
@@ -0,0 +1,361 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "export/output/export_output_archive.h"
+
+#include "export/output/export_output_result.h"
+
+#include <QtCore/QDirIterator>
+
+#include <zlib.h>
+
+namespace Export {
+namespace Output {
+namespace {
+
+constexpr auto kChunkSize = 1024 * 1024;
+constexpr auto kVersionNeeded = uint16(45); // ZIP64.
+constexpr auto kFlagUtf8Names = uint16(0x0800);
+constexpr auto kMethodStored = uint16(0);
+constexpr auto kMethodDeflated = uint16(8);
+constexpr auto kZip64ExtraId = uint16(0x0001);
+constexpr auto kMaxUInt16 = uint16(0xFFFF);
+constexpr auto kMaxUInt32 = uint32(0xFFFFFFFFU);
+
+// The local header has the CRC at this offset.
+constexpr auto kLocalHeaderCrcOffset = 14;
+constexpr auto kLocalHeaderSize = 30;
+
+void AppendUInt16(QByteArray &to, uint16 value) {
+	to.append(char(value & 0xFF));
+	to.append(char((value >> 8) & 0xFF));
+}
+
+void AppendUInt32(QByteArray &to, uint32 value) {
+	AppendUInt16(to, uint16(value & 0xFFFF));
+	AppendUInt16(to, uint16(value >> 16));
+}
+
+void AppendUInt64(QByteArray &to, uint64 value) {
+	AppendUInt32(to, uint32(value & 0xFFFFFFFFULL));
+	AppendUInt32(to, uint32(value >> 32));
+}
+
+[[nodiscard]] bool Compressible(const QString &name) {
+	const auto lower = name.toLower();
+	const auto suffixes = {
+		".html", ".json", ".css", ".js", ".txt", ".vcf"
+	};
+	for (const auto suffix : suffixes) {
+		if (lower.endsWith(QLatin1String(suffix))) {
+			return true;
+		}
+	}
+	return false;
+}
+
+[[nodiscard]] std::pair<uint16, uint16> DosDateTime(
+		const QDateTime &value) {
+	const auto date = value.date();
+	const auto time = value.time();
+	if (!date.isValid() || date.year() < 1980) {
+		return { uint16((1 << 5) | 1), uint16(0) };
+	}
+	return {
+		uint16(((date.year() - 1980) << 9)
+			| (date.month() << 5)
+			| date.day()),
+		uint16((time.hour() << 11)
+			| (time.minute() << 5)
+			| (time.second() / 2)),
+	};
+}
+
+class ZipWriter final {
+public:
+	explicit ZipWriter(const QString &path);
+
+	[[nodiscard]] Result open();
+	[[nodiscard]] Result add(const QString &path, const QString &name);
+	[[nodiscard]] Result finish();
+
+private:
+	struct Entry {
+		QByteArray name;
+		uint16 method = 0;
+		uint16 date = 0;
+		uint16 time = 0;
+		uint32 crc = 0;
+		uint64 compressed = 0;
+		uint64 uncompressed = 0;
+		uint64 offset = 0;
+	};
+
+	[[nodiscard]] Result error() const;
+	[[nodiscard]] bool write(const QByteArray &data);
+	[[nodiscard]] bool writeData(
+		Entry &entry,
+		QFile &input,
+		z_stream *stream);
+	[[nodiscard]] bool patchLocalHeader(const Entry &entry);
+
+	QFile _file;
+	std::vector<Entry> _entries;
+	uint64 _offset = 0;
+
+};
+
+ZipWriter::ZipWriter(const QString &path) : _file(path) {
+}
+
+Result ZipWriter::open() {
+	return _file.open(QIODevice::WriteOnly | QIODevice::Truncate)
+		? Result::Success()
+		: error();
+}
+
+Result ZipWriter::error() const {
+	return Result(Result::Type::Error, _file.fileName());
+}
+
+bool ZipWriter::write(const QByteArray &data) {
+	if (_file.write(data) != data.size()) {
+		return false;
+	}
+	_offset += data.size();
+	return true;
+}
+
+Result ZipWriter::add(const QString &path, const QString &name) {
+	auto input = QFile(path);
+	if (!input.open(QIODevice::ReadOnly)) {
+		return Result(Result::Type::FatalError, path);
+	}
+	const auto modified = QFileInfo(input).lastModified();
+	const auto [date, time] = DosDateTime(modified);
+	auto entry = Entry{
+		.name = name.toUtf8(),
+		.method = Compressible(name) ? kMethodDeflated : kMethodStored,
+		.date = date,
+		.time = time,
+		.offset = _offset,
+	};
+
+	// Sizes and CRC are patched after the data is written.
+	auto header = QByteArray();
+	AppendUInt32(header, 0x04034b50U);
+	AppendUInt16(header, kVersionNeeded);
+	AppendUInt16(header, kFlagUtf8Names);
+	AppendUInt16(header, entry.method);
+	AppendUInt16(header, entry.time);
+	AppendUInt16(header, entry.date);
+	AppendUInt32(header, 0); // CRC.
+	AppendUInt32(header, kMaxUInt32);
+	AppendUInt32(header, kMaxUInt32);
+	AppendUInt16(header, uint16(entry.name.size()));
+	AppendUInt16(header, 20); // Extra field size.
+	header.append(entry.name);
+	AppendUInt16(header, kZip64ExtraId);
+	AppendUInt16(header, 16);
+	AppendUInt64(header, 0); // Uncompressed size.
+	AppendUInt64(header, 0); // Compressed size.
+	if (!write(header)) {
+		return error();
+	}
+
+	auto stream = z_stream();
+	const auto deflate = (entry.method == kMethodDeflated);
+	if (deflate
+		&& deflateInit2(
+			&stream,
+			Z_DEFAULT_COMPRESSION,
+			Z_DEFLATED,
+			-MAX_WBITS,
+			8,
+			Z_DEFAULT_STRATEGY) != Z_OK) {
+		return error();
+	}
+	const auto written = writeData(
+		entry,
+		input,
+		deflate ? &stream : nullptr);
+	if (deflate) {
+		deflateEnd(&stream);
+	}
+	if (!written) {
+		return error();
+	} else if (!patchLocalHeader(entry)) {
+		return error();
+	}
+	_entries.push_back(std::move(entry));
+	return Result::Success();
+}
+
+bool ZipWriter::writeData(Entry &entry, QFile &input, z_stream *stream) {
+	auto output = QByteArray(kChunkSize, Qt::Uninitialized);
+	auto crc = crc32(0, nullptr, 0);
+	const auto start = _offset;
+	while (true) {
+		const auto chunk = input.read(kChunkSize);
+		if (chunk.isEmpty() && !input.atEnd()) {
+			return false;
+		}
+		const auto last = input.atEnd();
+		crc = crc32(
+			crc,
+			reinterpret_cast<const Bytef*>(chunk.constData()),
+			uInt(chunk.size()));
+		entry.uncompressed += chunk.size();
+		if (!stream) {
+			if (!write(chunk)) {
+				return false;
+			}
+		} else {
+			stream->next_in = reinterpret_cast<Bytef*>(
+				const_cast<char*>(chunk.constData()));
+			stream->avail_in = uInt(chunk.size());
+			auto result = Z_OK;
+			do {
+				stream->next_out = reinterpret_cast<Bytef*>(output.data());
+				stream->avail_out = uInt(output.size());
+				result = ::deflate(stream, last ? Z_FINISH : Z_NO_FLUSH);
+				if (result == Z_STREAM_ERROR) {
+					return false;
+				}
+				const auto size = output.size() - int(stream->avail_out);
+				if (size > 0 && !write(output.mid(0, size))) {
+					return false;
+				}
+			} while (stream->avail_out == 0
+				|| (last && result != Z_STREAM_END));
+		}
+		if (last) {
+			break;
+		}
+	}
+	entry.crc = uint32(crc);
+	entry.compressed = _offset - start;
+	return true;
+}
+
+bool ZipWriter::patchLocalHeader(const Entry &entry) {
+	auto crc = QByteArray();
+	AppendUInt32(crc, entry.crc);
+	auto sizes = QByteArray();
+	AppendUInt64(sizes, entry.uncompressed);
+	AppendUInt64(sizes, entry.compressed);
+	const auto sizesOffset = entry.offset
+		+ kLocalHeaderSize
+		+ entry.name.size()
+		+ 4;
+	const auto result = _file.seek(entry.offset + kLocalHeaderCrcOffset)
+		&& (_file.write(crc) == crc.size())
+		&& _file.seek(sizesOffset)
+		&& (_file.write(sizes) == sizes.size())
+		&& _file.seek(_offset);
+	return result;
+}
+
+Result ZipWriter::finish() {
+	const auto directoryOffset = _offset;
+	for (const auto &entry : _entries) {
+		auto header = QByteArray();
+		AppendUInt32(header, 0x02014b50U);
+		AppendUInt16(header, kVersionNeeded); // Version made by.
+		AppendUInt16(header, kVersionNeeded);
+		AppendUInt16(header, kFlagUtf8Names);
+		AppendUInt16(header, entry.method);
+		AppendUInt16(header, entry.time);
+		AppendUInt16(header, entry.date);
+		AppendUInt32(header, entry.crc);
+		AppendUInt32(header, kMaxUInt32);
+		AppendUInt32(header, kMaxUInt32);
+		AppendUInt16(header, uint16(entry.name.size()));
+		AppendUInt16(header, 28); // Extra field size.
+		AppendUInt16(header, 0); // Comment size.
+		AppendUInt16(header, 0); // Disk number.
+		AppendUInt16(header, 0); // Internal attributes.
+		AppendUInt32(header, 0); // External attributes.
+		AppendUInt32(header, kMaxUInt32);
+		header.append(entry.name);
+		AppendUInt16(header, kZip64ExtraId);
+		AppendUInt16(header, 24);
+		AppendUInt64(header, entry.uncompressed);
+		AppendUInt64(header, entry.compressed);
+		AppendUInt64(header, entry.offset);
+		if (!write(header)) {
+			return error();
+		}
+	}
+	const auto directorySize = _offset - directoryOffset;
+	const auto zip64EndOffset = _offset;
+
+	auto end = QByteArray();
+	AppendUInt32(end, 0x06064b50U);
+	AppendUInt64(end, 44); // Size of the rest of the record.
+	AppendUInt16(end, kVersionNeeded);
+	AppendUInt16(end, kVersionNeeded);
+	AppendUInt32(end, 0); // This disk.
+	AppendUInt32(end, 0); // Disk with the central directory.
+	AppendUInt64(end, _entries.size());
+	AppendUInt64(end, _entries.size());
+	AppendUInt64(end, directorySize);
+	AppendUInt64(end, directoryOffset);
+
+	AppendUInt32(end, 0x07064b50U);
+	AppendUInt32(end, 0); // Disk with the ZIP64 end record.
+	AppendUInt64(end, zip64EndOffset);
+	AppendUInt32(end, 1); // Total disks.
+
+	AppendUInt32(end, 0x06054b50U);
+	AppendUInt16(end, 0); // This disk.
+	AppendUInt16(end, 0); // Disk with the central directory.
+	AppendUInt16(end, kMaxUInt16);
+	AppendUInt16(end, kMaxUInt16);
+	AppendUInt32(end, kMaxUInt32);
+	AppendUInt32(end, kMaxUInt32);
+	AppendUInt16(end, 0); // Comment size.
+	if (!write(end) || !_file.flush()) {
+		return error();
+	}
+	_file.close();
+	return Result::Success();
+}
+
+} // namespace
+
+Result PackFolder(const QString &folder, const QString &archivePath) {
+	auto writer = ZipWriter(archivePath);
+	if (const auto result = writer.open(); !result) {
+		return result;
+	}
+	const auto root = QDir(folder);
+	auto files = QStringList();
+	auto i = QDirIterator(
+		folder,
+		QDir::Files | QDir::Hidden | QDir::NoDotAndDotDot,
+		QDirIterator::Subdirectories);
+	while (i.hasNext()) {
+		const auto path = i.next();
+
+		// Skip the checkpoint and other export state files.
+		if (!i.fileName().startsWith(u".export_"_q)) {
+			files.push_back(path);
+		}
+	}
+	files.sort();
+	for (const auto &path : files) {
+		const auto name = root.relativeFilePath(path);
+		if (const auto result = writer.add(path, name); !result) {
+			return result;
+		}
+	}
+	return writer.finish();
+}
+
+} // namespace Output
+} // namespace Export
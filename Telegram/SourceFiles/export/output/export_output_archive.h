@@ -0,0 +1,24 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include <QtCore/QString>
+
+namespace Export {
+namespace Output {
+
+struct Result;
+
+// Packs the finished export folder to a single ZIP64 archive, streaming
+// file by file. Text files are deflated, media files are stored.
+[[nodiscard]] Result PackFolder(
+	const QString &folder,
+	const QString &archivePath);
+
+} // namespace Output
+} // namespace Export
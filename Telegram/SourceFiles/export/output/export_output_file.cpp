@@ -18,19 +18,52 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 namespace Export {
 namespace Output {
+namespace {
+
+constexpr auto kBufferSize = 256 * 1024;
+
+} // namespace
 
 File::File(const QString &path, Stats *stats) : _path(path), _stats(stats) {
 }
 
+File::~File() {
+	if (!_buffer.isEmpty() && !flush()) {
+		LOG(("Export Error: Could not flush '%1'.").arg(_path));
+	}
+}
+
 int64 File::size() const {
-	return _offset;
+	return _offset + _buffer.size();
 }
 
 bool File::empty() const {
-	return !_offset;
+	return !size();
 }
 
 Result File::writeBlock(const QByteArray &block) {
+	// An empty block still creates the file.
+	if (block.isEmpty() || _buffer.size() + block.size() > kBufferSize) {
+		if (const auto result = flush(); !result) {
+			return result;
+		}
+	}
+	if (block.size() >= kBufferSize) {
+		return write(block);
+	}
+	_buffer.append(block);
+	return Result::Success();
+}
+
+Result File::flush() {
+	const auto result = write(_buffer);
+	if (result) {
+		_buffer.clear();
+	}
+	return result;
+}
+
+Result File::write(const QByteArray &block) {
 	const auto result = writeBlockAttempt(block);
 	if (!result) {
 		_file.reset();
@@ -50,7 +83,12 @@ Result File::writeBlockAttempt(const QByteArray &block) {
 	if (!size) {
 		return Result::Success();
 	}
-	if (_file->write(block) == size && _file->flush()) {
+	const auto started = crl::profile();
+	const auto written = (_file->write(block) == size) && _file->flush();
+	if (_stats) {
+		_stats->addWriteDuration(crl::profile() - started);
+	}
+	if (written) {
 		_offset += size;
 		if (_stats) {
 			_stats->incrementBytes(size);
@@ -133,7 +171,11 @@ Result File::Copy(
 	if (bytes.size() != f.size()) {
 		return Result(Result::Type::FatalError, source);
 	}
-	return File(path, stats).writeBlock(bytes);
+	auto file = File(path, stats);
+	if (const auto result = file.writeBlock(bytes); !result) {
+		return result;
+	}
+	return file.flush();
 }
 
 } // namespace Output
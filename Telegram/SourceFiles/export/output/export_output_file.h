@@ -19,14 +19,18 @@ namespace Output {
 struct Result;
 class Stats;
 
+// Small blocks are gathered in memory and written together, those
+// are written to the disk only by flush() or with the next large block.
 class File {
 public:
 	File(const QString &path, Stats *stats);
+	~File();
 
 	[[nodiscard]] int64 size() const;
 	[[nodiscard]] bool empty() const;
 
 	[[nodiscard]] Result writeBlock(const QByteArray &block);
+	[[nodiscard]] Result flush();
 
 	[[nodiscard]] static QString PrepareRelativePath(
 		const QString &folder,
@@ -39,6 +43,7 @@ public:
 
 private:
 	[[nodiscard]] Result reopen();
+	[[nodiscard]] Result write(const QByteArray &block);
 	[[nodiscard]] Result writeBlockAttempt(const QByteArray &block);
 
 	[[nodiscard]] Result error() const;
@@ -47,6 +52,7 @@ private:
 	QString _path;
 	int64 _offset = 0;
 	std::optional<QFile> _file;
+	QByteArray _buffer;
 
 	Stats *_stats = nullptr;
 	bool _inStats = false;
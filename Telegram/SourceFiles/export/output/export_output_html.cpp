@@ -17,6 +17,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include <QtCore/QFile>
 #include <QtCore/QDateTime>
 
+#include <array>
+
 namespace Export {
 namespace Output {
 namespace {
@@ -105,49 +107,81 @@ auto CalculateThumbSize(
 	};
 }
 
+[[nodiscard]] constexpr std::array<bool, 256> ComputeSpecialChars() {
+	auto result = std::array<bool, 256>();
+	for (auto ch = 0; ch != 32; ++ch) {
+		result[ch] = true;
+	}
+	for (const auto ch : { '"', '&', '\'', '<', '>' }) {
+		result[uchar(ch)] = true;
+	}
+	result[0xE2] = true; // Possible line or paragraph separator.
+	return result;
+}
+
+constexpr auto kSpecialChars = ComputeSpecialChars();
+
+[[nodiscard]] bool IsSpecialChar(char ch) {
+	return kSpecialChars[uchar(ch)];
+}
+
+// Appends the escaped char, returns the count of bytes consumed.
+int AppendEscaped(QByteArray &to, const char *p, const char *end) {
+	const auto ch = *p;
+	if (ch == '\n') {
+		to.append("<br>", 4);
+	} else if (ch == '"') {
+		to.append("&quot;", 6);
+	} else if (ch == '&') {
+		to.append("&amp;", 5);
+	} else if (ch == '\'') {
+		to.append("&apos;", 6);
+	} else if (ch == '<') {
+		to.append("&lt;", 4);
+	} else if (ch == '>') {
+		to.append("&gt;", 4);
+	} else if (ch >= 0 && ch < 32) {
+		to.append("&#x", 3).append('0' + (ch >> 4));
+		const auto left = (ch & 0x0F);
+		if (left >= 10) {
+			to.append('A' + (left - 10));
+		} else {
+			to.append('0' + left);
+		}
+		to.append(';');
+	} else if (ch == char(0xE2)
+		&& (p + 2 < end)
+		&& *(p + 1) == char(0x80)
+		&& (*(p + 2) == char(0xA8) // Line separator.
+			|| *(p + 2) == char(0xA9))) { // Paragraph separator.
+		to.append("<br>", 4);
+		return 3;
+	} else {
+		to.append(ch);
+	}
+	return 1;
+}
+
 QByteArray SerializeString(const QByteArray &value) {
 	const auto size = value.size();
 	const auto begin = value.data();
 	const auto end = begin + size;
 
+	auto p = std::find_if(begin, end, IsSpecialChar);
+	if (p == end) {
+		// Nothing to escape, share the source bytes.
+		return value;
+	}
+
+	// Plain runs between the special chars are copied as a whole.
 	auto result = QByteArray();
-	result.reserve(size * 6);
-	for (auto p = begin; p != end; ++p) {
-		const auto ch = *p;
-		if (ch == '\n') {
-			result.append("<br>", 4);
-		} else if (ch == '"') {
-			result.append("&quot;", 6);
-		} else if (ch == '&') {
-			result.append("&amp;", 5);
-		} else if (ch == '\'') {
-			result.append("&apos;", 6);
-		} else if (ch == '<') {
-			result.append("&lt;", 4);
-		} else if (ch == '>') {
-			result.append("&gt;", 4);
-		} else if (ch >= 0 && ch < 32) {
-			result.append("&#x", 3).append('0' + (ch >> 4));
-			const auto left = (ch & 0x0F);
-			if (left >= 10) {
-				result.append('A' + (left - 10));
-			} else {
-				result.append('0' + left);
-			}
-			result.append(';');
-		} else if (ch == char(0xE2)
-			&& (p + 2 < end)
-			&& *(p + 1) == char(0x80)) {
-			if (*(p + 2) == char(0xA8)) { // Line separator.
-				result.append("<br>", 4);
-			} else if (*(p + 2) == char(0xA9)) { // Paragraph separator.
-				result.append("<br>", 4);
-			} else {
-				result.append(ch);
-			}
-		} else {
-			result.append(ch);
-		}
+	result.reserve(size + size / 4);
+	result.append(begin, p - begin);
+	while (p != end) {
+		p += AppendEscaped(result, p, end);
+		const auto till = std::find_if(p, end, IsSpecialChar);
+		result.append(p, till - p);
+		p = till;
 	}
 	return result;
 }
@@ -2435,7 +2469,10 @@ Result HtmlWriter::Wrap::close() {
 		while (!_context.empty()) {
 			block.append(_context.popTag());
 		}
-		return _file.writeBlock(block);
+		if (const auto result = _file.writeBlock(block); !result) {
+			return result;
+		}
+		return _file.flush();
 	}
 	return Result::Success();
 }
@@ -17,53 +17,85 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonValue>
 
+#include <array>
+
 namespace Export {
 namespace Output {
 namespace {
 
 using Context = details::JsonContext;
 
+[[nodiscard]] constexpr std::array<bool, 256> ComputeSpecialChars() {
+	auto result = std::array<bool, 256>();
+	for (auto ch = 0; ch != 32; ++ch) {
+		result[ch] = true;
+	}
+	result[uchar('"')] = true;
+	result[uchar('\\')] = true;
+	result[0xE2] = true; // Possible line or paragraph separator.
+	return result;
+}
+
+constexpr auto kSpecialChars = ComputeSpecialChars();
+
+[[nodiscard]] bool IsSpecialChar(char ch) {
+	return kSpecialChars[uchar(ch)];
+}
+
+// Appends the escaped char, returns the count of bytes consumed.
+int AppendEscaped(QByteArray &to, const char *p, const char *end) {
+	const auto ch = *p;
+	if (ch == '\n') {
+		to.append("\\n", 2);
+	} else if (ch == '\r') {
+		to.append("\\r", 2);
+	} else if (ch == '\t') {
+		to.append("\\t", 2);
+	} else if (ch == '"') {
+		to.append("\\\"", 2);
+	} else if (ch == '\\') {
+		to.append("\\\\", 2);
+	} else if (ch >= 0 && ch < 32) {
+		to.append("\\x", 2).append('0' + (ch >> 4));
+		const auto left = (ch & 0x0F);
+		if (left >= 10) {
+			to.append('A' + (left - 10));
+		} else {
+			to.append('0' + left);
+		}
+	} else if (ch == char(0xE2)
+		&& (p + 2 < end)
+		&& *(p + 1) == char(0x80)) {
+		if (*(p + 2) == char(0xA8)) { // Line separator.
+			to.append("\\u2028", 6);
+			return 3;
+		} else if (*(p + 2) == char(0xA9)) { // Paragraph separator.
+			to.append("\\u2029", 6);
+			return 3;
+		}
+		to.append(ch);
+	} else {
+		to.append(ch);
+	}
+	return 1;
+}
+
 QByteArray SerializeString(const QByteArray &value) {
 	const auto size = value.size();
 	const auto begin = value.data();
 	const auto end = begin + size;
 
+	// Plain runs between the special chars are copied as a whole.
 	auto result = QByteArray();
-	result.reserve(2 + size * 4);
+	result.reserve(2 + size + size / 8);
 	result.append('"');
-	for (auto p = begin; p != end; ++p) {
-		const auto ch = *p;
-		if (ch == '\n') {
-			result.append("\\n", 2);
-		} else if (ch == '\r') {
-			result.append("\\r", 2);
-		} else if (ch == '\t') {
-			result.append("\\t", 2);
-		} else if (ch == '"') {
-			result.append("\\\"", 2);
-		} else if (ch == '\\') {
-			result.append("\\\\", 2);
-		} else if (ch >= 0 && ch < 32) {
-			result.append("\\x", 2).append('0' + (ch >> 4));
-			const auto left = (ch & 0x0F);
-			if (left >= 10) {
-				result.append('A' + (left - 10));
-			} else {
-				result.append('0' + left);
-			}
-		} else if (ch == char(0xE2)
-			&& (p + 2 < end)
-			&& *(p + 1) == char(0x80)) {
-			if (*(p + 2) == char(0xA8)) { // Line separator.
-				result.append("\\u2028", 6);
-			} else if (*(p + 2) == char(0xA9)) { // Paragraph separator.
-				result.append("\\u2029", 6);
-			} else {
-				result.append(ch);
-			}
-		} else {
-			result.append(ch);
+	for (auto p = begin; p != end;) {
+		const auto till = std::find_if(p, end, IsSpecialChar);
+		result.append(p, till - p);
+		if (till == end) {
+			break;
 		}
+		p = till + AppendEscaped(result, till, end);
 	}
 	result.append('"');
 	return result;
@@ -1571,11 +1603,14 @@ Result JsonWriter::finish() {
 
 	if (_settings.onlySinglePeer()) {
 		Assert(_context.nesting.empty());
-		return Result::Success();
+		return _output->flush();
 	}
 	auto block = popNesting();
 	Assert(_context.nesting.empty());
-	return _output->writeBlock(block);
+	if (const auto result = _output->writeBlock(block); !result) {
+		return result;
+	}
+	return _output->flush();
 }
 
 QString JsonWriter::mainFilePath() {
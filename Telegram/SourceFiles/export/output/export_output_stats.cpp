@@ -7,12 +7,26 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #include "export/output/export_output_stats.h"
 
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+
 namespace Export {
 namespace Output {
 
 Stats::Stats(const Stats &other)
 : _files(other._files.load())
-, _bytes(other._bytes.load()) {
+, _bytes(other._bytes.load())
+, _requests(other._requests.load())
+, _slowRequests(other._slowRequests.load())
+, _requestsDuration(other._requestsDuration.load())
+, _slowRequestsDuration(other._slowRequestsDuration.load())
+, _requestMaxLatency(other._requestMaxLatency.load())
+, _writeDuration(other._writeDuration.load())
+, _serializeDuration(other._serializeDuration.load()) {
+	for (auto i = 0; i != kDcsCount; ++i) {
+		_dcBytes[i] = other._dcBytes[i].load();
+		_dcRequests[i] = other._dcRequests[i].load();
+	}
 }
 
 void Stats::incrementFiles() {
@@ -23,6 +37,34 @@ void Stats::incrementBytes(int count) {
 	_bytes += count;
 }
 
+void Stats::addRequest(crl::time latency) {
+	++_requests;
+	_requestsDuration += latency;
+	if (latency >= kSlowRequest) {
+		++_slowRequests;
+		_slowRequestsDuration += latency;
+	}
+	auto max = _requestMaxLatency.load();
+	while (latency > max
+		&& !_requestMaxLatency.compare_exchange_weak(max, latency)) {
+	}
+}
+
+void Stats::addFileRequest(int dcId, crl::time latency, int64 bytes) {
+	addRequest(latency);
+	const auto index = (dcId > 0 && dcId < kDcsCount) ? dcId : 0;
+	_dcBytes[index] += bytes;
+	++_dcRequests[index];
+}
+
+void Stats::addWriteDuration(crl::profile_time duration) {
+	_writeDuration += duration;
+}
+
+void Stats::addSerializeDuration(crl::profile_time duration) {
+	_serializeDuration += duration;
+}
+
 int Stats::filesCount() const {
 	return _files;
 }
@@ -31,5 +73,42 @@ int64 Stats::bytesCount() const {
 	return _bytes;
 }
 
+crl::profile_time Stats::writeDuration() const {
+	return _writeDuration;
+}
+
+QByteArray Stats::serialize(crl::time elapsed) const {
+	const auto seconds = std::max(elapsed, crl::time(1)) / 1000.;
+	const auto requests = _requests.load();
+	auto dcs = QJsonObject();
+	for (auto i = 0; i != kDcsCount; ++i) {
+		if (!_dcRequests[i]) {
+			continue;
+		}
+		const auto bytes = _dcBytes[i].load();
+		dcs.insert(QString::number(i), QJsonObject{
+			{ "requests", _dcRequests[i].load() },
+			{ "bytes", double(bytes) },
+			{ "bytes_per_second", double(qRound64(bytes / seconds)) },
+		});
+	}
+	const auto result = QJsonObject{
+		{ "elapsed_ms", double(elapsed) },
+		{ "files", _files.load() },
+		{ "bytes_written", double(_bytes.load()) },
+		{ "requests", requests },
+		{ "request_avg_ms", requests
+			? double(_requestsDuration.load() / requests)
+			: 0. },
+		{ "request_max_ms", double(_requestMaxLatency.load()) },
+		{ "slow_requests", _slowRequests.load() },
+		{ "slow_requests_ms", double(_slowRequestsDuration.load()) },
+		{ "download_dcs", dcs },
+		{ "serialize_ms", double(_serializeDuration.load() / 1000) },
+		{ "disk_write_ms", double(_writeDuration.load() / 1000) },
+	};
+	return QJsonDocument(result).toJson(QJsonDocument::Compact);
+}
+
 } // namespace Output
 } // namespace Export
@@ -8,6 +8,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #pragma once
 
 #include <atomic>
+#include <array>
 
 namespace Export {
 namespace Output {
@@ -20,13 +21,40 @@ public:
 	void incrementFiles();
 	void incrementBytes(int count);
 
+	// Timings of the export stages, reported by serialize().
+	void addRequest(crl::time latency);
+	void addFileRequest(int dcId, crl::time latency, int64 bytes);
+	void addWriteDuration(crl::profile_time duration);
+	void addSerializeDuration(crl::profile_time duration);
+
 	int filesCount() const;
 	int64 bytesCount() const;
+	crl::profile_time writeDuration() const;
+
+	// Single line JSON object for the log, rates are per wall time.
+	[[nodiscard]] QByteArray serialize(crl::time elapsed) const;
 
 private:
+	// Requests slower than that are most likely flood waits retried
+	// inside MTP::Instance, the export doesn't see them otherwise.
+	static constexpr auto kSlowRequest = crl::time(2000);
+
+	// Index zero is for unknown dc ids.
+	static constexpr auto kDcsCount = 6;
+
 	std::atomic<int> _files;
 	std::atomic<int64> _bytes;
 
+	std::atomic<int> _requests;
+	std::atomic<int> _slowRequests;
+	std::atomic<crl::time> _requestsDuration;
+	std::atomic<crl::time> _slowRequestsDuration;
+	std::atomic<crl::time> _requestMaxLatency;
+	std::array<std::atomic<int64>, kDcsCount> _dcBytes = {};
+	std::array<std::atomic<int>, kDcsCount> _dcRequests = {};
+	std::atomic<crl::profile_time> _writeDuration;
+	std::atomic<crl::profile_time> _serializeDuration;
+
 };
 
 } // namespace Output
@@ -133,6 +133,7 @@ Content ContentFromState(
 		break;
 	default: Unexpected("Step in ContentFromState.");
 	}
+	result.eta = state.eta;
 	const auto requiredRows = settings->onlySinglePeer() ? 2 : 3;
 	while (result.rows.size() < requiredRows) {
 		result.rows.emplace_back();
@@ -26,6 +26,7 @@ struct Content {
 	};
 
 	std::vector<Row> rows;
+	crl::time eta = 0;
 
 	static const QString kDoneId;
 
@@ -8,6 +8,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "export/view/export_view_progress.h"
 
 #include "ui/effects/animations.h"
+#include "ui/text/format_values.h"
 #include "ui/widgets/labels.h"
 #include "ui/widgets/buttons.h"
 #include "ui/wrap/fade_wrap.h"
@@ -310,6 +311,16 @@ void ProgressWidget::setupBottomButton(not_null<Ui::RoundButton*> button) {
 void ProgressWidget::updateState(Content &&content) {
 	if (!content.rows.empty() && content.rows[0].id == Content::kDoneId) {
 		showDone();
+	} else if (_etaSeconds != (content.eta / 1000)) {
+		_etaSeconds = content.eta / 1000;
+		_about->setText(_etaSeconds
+			? (tr::lng_export_progress(tr::now)
+				+ "\n\n"
+				+ tr::lng_export_progress_etaSeconds(
+					tr::now,
+					lt_time,
+					Ui::FormatDurationText(_etaSeconds)))
+			: tr::lng_export_progress(tr::now));
 	}
 
 	const auto wasCount = _rows.size();
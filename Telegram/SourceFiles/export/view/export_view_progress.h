@@ -54,6 +54,7 @@ private:
 	rpl::event_stream<> _doneClicks;
 
 	uint64 _fileRandomId = 0;
+	int64 _etaSeconds = 0;
 	base::Timer _fileShowSkipTimer;
 
 };
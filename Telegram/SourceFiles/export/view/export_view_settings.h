@@ -76,6 +76,8 @@ private:
 		not_null<Ui::VerticalLayout*> container,
 		const QString &text,
 		Types types);
+	void addOnlyNewOption(not_null<Ui::VerticalLayout*> container);
+	void addArchiveOption(not_null<Ui::VerticalLayout*> container);
 	void addMediaOptions(not_null<Ui::VerticalLayout*> container);
 	void addMediaOption(
 		not_null<Ui::VerticalLayout*> container,
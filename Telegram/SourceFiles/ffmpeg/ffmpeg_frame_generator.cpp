@@ -15,6 +15,11 @@ namespace {
 
 constexpr auto kMaxArea = 1920 * 1080 * 4;
 
+// Stickers and emoji are decoded by many generators at once, each one
+// already on a crl::async worker, so per-codec decoding threads only add
+// context switches and memory for every small animation.
+constexpr auto kSingleThreadArea = 512 * 512;
+
 } // namespace
 
 class FrameGenerator::Impl final {
@@ -103,7 +108,11 @@ FrameGenerator::Impl::Impl(const QByteArray &bytes)
 	const auto info = _format->streams[_streamId];
 	_rotation = ReadRotationFromMetadata(info);
 	//_aspect = ValidateAspectRatio(info->sample_aspect_ratio);
-	_codec = MakeCodecPointer({ .stream = info });
+	const auto area = info->codecpar->width * info->codecpar->height;
+	_codec = MakeCodecPointer({
+		.stream = info,
+		.threads = (area <= kSingleThreadArea) ? 1 : 0,
+	});
 }
 
 int FrameGenerator::Impl::Read(void *opaque, uint8_t *buf, int buf_size) {
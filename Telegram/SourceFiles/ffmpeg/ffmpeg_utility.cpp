@@ -337,7 +337,11 @@ CodecPointer MakeCodecPointer(CodecDescriptor descriptor) {
 		return {};
 	}
 	context->pkt_timebase = stream->time_base;
-	av_opt_set(context, "threads", "auto", 0);
+	if (descriptor.threads > 0) {
+		av_opt_set_int(context, "threads", descriptor.threads, 0);
+	} else {
+		av_opt_set(context, "threads", "auto", 0);
+	}
 	av_opt_set_int(context, "refcounted_frames", 1, 0);
 
 	const auto codec = FindDecoder(context);
@@ -349,6 +353,7 @@ CodecPointer MakeCodecPointer(CodecDescriptor descriptor) {
 	if (descriptor.hwAllowed) {
 		context->get_format = GetHwFormat;
 		context->opaque = context;
+		context->extra_hw_frames = descriptor.extraHwFrames;
 	} else {
 		DEBUG_LOG(("Video Info: Using software \"%2\" decoder."
 			).arg(codec->name));
@@ -146,6 +146,8 @@ using CodecPointer = std::unique_ptr<AVCodecContext, CodecDeleter>;
 
 struct CodecDescriptor {
 	not_null<AVStream*> stream;
+	int extraHwFrames = 0; // Decoded frames held by the caller at once.
+	int threads = 0; // Zero lets FFmpeg choose by the cores count.
 	bool hwAllowed = false;
 };
 [[nodiscard]] CodecPointer MakeCodecPointer(CodecDescriptor descriptor);
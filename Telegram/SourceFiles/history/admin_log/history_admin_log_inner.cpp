@@ -909,7 +909,20 @@ void InnerWidget::addEvents(Direction direction, const QVector<MTPChannelAdminLo
 		const auto &data = event.data();
 		const auto id = data.vid().v;
 		if (_eventIds.find(id) != _eventIds.end()) {
-			return;
+			continue;
+		}
+		if (const auto i = _hiddenEventItems.find(id)
+			; i != end(_hiddenEventItems)) {
+			// The order inside the event is already reversed.
+			for (auto &item : i->second) {
+				item->setAttachToPrevious(false);
+				item->setAttachToNext(false);
+				_itemsByData.emplace(item->data(), item.get());
+				addToItems.push_back(std::move(item));
+			}
+			_hiddenEventItems.erase(i);
+			_eventIds.emplace(id);
+			continue;
 		}
 		const auto rememberRealMsgId = (antiSpamUserId
 			== peerToUser(peerFromUser(data.vuser_id())));
@@ -924,6 +937,7 @@ void InnerWidget::addEvents(Direction direction, const QVector<MTPChannelAdminLo
 			}
 			_eventIds.emplace(id);
 			_itemsByData.emplace(item->data(), item.get());
+			_itemEventIds.emplace(item->data(), id);
 			if (rememberRealMsgId && realId) {
 				_antiSpamValidator.addEventMsgId(
 					item->data()->fullId(),
@@ -1159,7 +1173,13 @@ void InnerWidget::clearAfterFilterChange() {
 	_selectedItem = nullptr;
 	_selectedText = TextSelection();
 	_filterChanged = false;
-	_items.clear();
+	for (auto &item : base::take(_items)) {
+		const auto i = _itemEventIds.find(item->data());
+		if (i != end(_itemEventIds)) {
+			item->unloadHeavyPart();
+			_hiddenEventItems[i->second].push_back(std::move(item));
+		}
+	}
 	_eventIds.clear();
 	_itemsByData.clear();
 	updateEmptyText();
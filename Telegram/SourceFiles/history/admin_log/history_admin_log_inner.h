@@ -273,6 +273,11 @@ private:
 
 	std::vector<OwnedItem> _items;
 	std::set<uint64> _eventIds;
+
+	// Items of the events hidden by a filter or search change are kept,
+	// so that the events received again don't lay out their texts anew.
+	base::flat_map<uint64, std::vector<OwnedItem>> _hiddenEventItems;
+	base::flat_map<not_null<const HistoryItem*>, uint64> _itemEventIds;
 	std::map<not_null<const HistoryItem*>, not_null<Element*>> _itemsByData;
 	base::flat_map<not_null<const HistoryItem*>, TimeId> _itemDates;
 	base::flat_set<FullMsgId> _animatedStickersPlayed;
@@ -3014,27 +3014,70 @@ HistoryItem *History::lastEditableMessage() const {
 	return nullptr;
 }
 
-void History::resizeToWidth(int newWidth) {
+void History::resizeToWidth(int newWidth, int visibleTop, int visibleBottom) {
 	using Request = HistoryBlock::ResizeRequest;
 	const auto request = (_flags & Flag::PendingAllItemsResize)
 		? Request::ReinitAll
 		: (_width != newWidth)
 		? Request::ResizeAll
 		: Request::ResizePending;
-	if (request == Request::ResizePending && !hasPendingResizedItems()) {
+	if (request == Request::ResizePending
+		&& !hasPendingResizedItems()
+		&& !(_flags & Flag::HasLazyResizedBlocks)) {
 		return;
 	}
-	_flags &= ~(Flag::HasPendingResizedItems | Flag::PendingAllItemsResize);
-
+	_flags &= ~(Flag::HasPendingResizedItems
+		| Flag::PendingAllItemsResize
+		| Flag::HasLazyResizedBlocks);
+
+	// Laying out all the loaded messages on each window resize step is
+	// too slow in long chats, so blocks further than a screen away from
+	// the visible area are resized only when they are scrolled closer.
+	const auto margin = int64(visibleBottom) - visibleTop;
+	const auto near = [&](not_null<HistoryBlock*> block) {
+		return (block->y() < visibleBottom + margin)
+			&& (block->y() + block->height() > visibleTop - margin);
+	};
 	_width = newWidth;
 	int y = 0;
 	for (const auto &block : blocks) {
+		const auto stale = (request != Request::ReinitAll)
+			&& (block->width() > 0)
+			&& (block->width() != newWidth);
+		const auto lazy = stale && !near(block.get());
 		block->setY(y);
-		y += block->resizeGetHeight(newWidth, request);
+		if (lazy) {
+			_flags |= Flag::HasLazyResizedBlocks;
+			y += block->resizeGetHeight(
+				block->width(),
+				Request::ResizePending);
+		} else {
+			y += block->resizeGetHeight(
+				newWidth,
+				stale ? Request::ResizeAll : request);
+		}
 	}
 	_height = y;
 }
 
+bool History::hasLazyResizedBlocks(
+		int visibleTop,
+		int visibleBottom) const {
+	if (!(_flags & Flag::HasLazyResizedBlocks)) {
+		return false;
+	}
+	const auto margin = (visibleBottom - visibleTop) / 2;
+	for (const auto &block : blocks) {
+		if (block->y() >= visibleBottom + margin) {
+			break;
+		} else if (block->width() != _width
+			&& block->y() + block->height() > visibleTop - margin) {
+			return true;
+		}
+	}
+	return false;
+}
+
 void History::forceFullResize() {
 	_width = 0;
 	_flags |= Flag::HasPendingResizedItems;
@@ -3430,6 +3473,7 @@ void History::clear(ClearType type) {
 		}
 		clearNotifications();
 		owner().notifyHistoryCleared(this);
+		owner().histories().forgetCachedHistory(this);
 		if (unreadCountKnown()) {
 			setUnreadCount(0);
 		}
@@ -3602,6 +3646,7 @@ int HistoryBlock::resizeGetHeight(int newWidth, ResizeRequest request) {
 				: message->height();
 		}
 	}
+	_width = newWidth;
 	_height = y;
 	return _height;
 }
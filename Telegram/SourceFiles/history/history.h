@@ -279,7 +279,12 @@ public:
 	MsgId msgIdForRead() const;
 	HistoryItem *lastEditableMessage() const;
 
-	void resizeToWidth(int newWidth);
+	// Blocks far from [visibleTop, visibleBottom) keep their previous
+	// heights as placeholders, they are resized when scrolled close.
+	void resizeToWidth(int newWidth, int visibleTop, int visibleBottom);
+	[[nodiscard]] bool hasLazyResizedBlocks(
+		int visibleTop,
+		int visibleBottom) const;
 	void forceFullResize();
 	int height() const;
 
@@ -455,6 +460,7 @@ private:
 		FakeUnreadWhileOpened = (1 << 4),
 		HasPinnedMessages = (1 << 5),
 		ResolveChatListMessage = (1 << 6),
+		HasLazyResizedBlocks = (1 << 7),
 	};
 	using Flags = base::flags<Flag>;
 	friend inline constexpr auto is_flag_type(Flag) {
@@ -652,6 +658,9 @@ public:
 	void refreshView(not_null<Element*> view);
 
 	int resizeGetHeight(int newWidth, ResizeRequest request);
+	int width() const {
+		return _width;
+	}
 	int y() const {
 		return _y;
 	}
@@ -694,6 +703,7 @@ protected:
 	const not_null<History*> _history;
 
 	int _y = 0;
+	int _width = 0;
 	int _height = 0;
 	int _indexInHistory = -1;
 
@@ -10,6 +10,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "chat_helpers/stickers_emoji_pack.h"
 #include "core/file_utilities.h"
 #include "core/click_handler_types.h"
+#include "core/core_paint_profiler.h"
 #include "history/history_item_helpers.h"
 #include "history/view/controls/history_view_forward_panel.h"
 #include "api/api_report.h"
@@ -66,6 +67,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "base/qt/qt_common_adapters.h"
 #include "base/qt/qt_key_modifiers.h"
 #include "base/unixtime.h"
+#include "base/options.h"
 #include "base/call_delayed.h"
 #include "main/main_session.h"
 #include "main/main_session_settings.h"
@@ -82,6 +84,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/components/sponsored_messages.h"
 #include "data/data_session.h"
 #include "data/data_document.h"
+#include "data/data_media_preload.h"
+#include "data/data_auto_download.h"
 #include "data/data_channel.h"
 #include "data/data_forum_topic.h"
 #include "data/data_photo_media.h"
@@ -104,6 +108,27 @@ namespace {
 constexpr auto kScrollDateHideTimeout = 1000;
 constexpr auto kUnloadHeavyPartsPages = 2;
 constexpr auto kClearUserpicsAfter = 50;
+constexpr auto kPreloadVideosPagesAbove = 1;
+constexpr auto kPreloadVideosPagesBelow = 2;
+constexpr auto kMaxCachedViews = 64;
+constexpr auto kThroughputPeriod = 10 * crl::time(1000);
+constexpr auto kThroughputEnterCount = 20;
+constexpr auto kThroughputLeaveCount = 10;
+
+base::options::toggle CacheMessageViews({
+	.id = kOptionCacheMessageViews,
+	.name = "Cache static messages rendering",
+	.description = "Keep rendered text messages without media and "
+		"animations as images and draw them from there while scrolling.",
+});
+
+base::options::toggle ChatThroughputMode({
+	.id = kOptionChatThroughputMode,
+	.name = "Lite rendering in busy chats",
+	.description = "When more than two messages per second arrive in the "
+		"opened chat, draw custom emoji and spoilers static, bubbles "
+		"without gradients and don't play emoji interactions there.",
+});
 
 // Helper binary search for an item in a list that is not completely
 // above the given top of the visible area or below the given bottom of the visible area
@@ -190,6 +215,9 @@ void FillSponsoredMessagesMenu(
 
 } // namespace
 
+const char kOptionCacheMessageViews[] = "cache-message-views";
+const char kOptionChatThroughputMode[] = "chat-throughput-mode";
+
 // flick scroll taken from http://qt-project.org/doc/qt-4.8/demos-embedded-anomaly-src-flickcharm-cpp.html
 
 HistoryMainElementDelegateMixin::HistoryMainElementDelegateMixin() = default;
@@ -399,6 +427,17 @@ HistoryInner::HistoryInner(
 	refreshAboutView();
 
 	setMouseTracking(true);
+	if (ChatThroughputMode.value()) {
+		_throughputTimer.setCallback([=] { checkThroughputMode(); });
+		session().changes().realtimeMessageUpdates(
+			Data::MessageUpdate::Flag::NewAdded
+		) | rpl::filter([=](const Data::MessageUpdate &update) {
+			return (update.item->history() == _history);
+		}) | rpl::start_with_next([=] {
+			registerThroughputMessage();
+		}, lifetime());
+	}
+
 	_controller->gifPauseLevelChanged(
 	) | rpl::start_with_next([=] {
 		if (!elementAnimationsPaused()) {
@@ -410,6 +449,7 @@ HistoryInner::HistoryInner(
 	_controller->emojiInteractions().playRequests(
 	) | rpl::filter([=](const PlayRequest &request) {
 		return (request.item->history() == _history)
+			&& !_throughputMode
 			&& _controller->widget()->isActive();
 	}) | rpl::start_with_next([=](PlayRequest &&request) {
 		if (const auto view = viewByItem(request.item)) {
@@ -429,6 +469,7 @@ HistoryInner::HistoryInner(
 
 	session().data().peerDecorationsUpdated(
 	) | rpl::start_with_next([=] {
+		clearViewCache();
 		update();
 	}, lifetime());
 	session().data().itemRemoved(
@@ -470,9 +511,15 @@ HistoryInner::HistoryInner(
 		(Data::HistoryUpdate::Flag::OutboxRead
 			| Data::HistoryUpdate::Flag::TranslatedTo)
 	) | rpl::start_with_next([=] {
+		clearViewCache();
 		update();
 	}, lifetime());
 
+	_controller->chatStyle()->paletteChanged(
+	) | rpl::start_with_next([=] {
+		clearViewCache();
+	}, lifetime());
+
 	HistoryView::Reactions::SetupManagerList(
 		_reactionsManager.get(),
 		_reactionsItem.value());
@@ -701,6 +748,9 @@ void HistoryInner::repaintItem(const HistoryItem *item) {
 }
 
 void HistoryInner::repaintItem(const Element *view) {
+	if (view && !_viewCache.empty()) {
+		_viewCache.remove(view);
+	}
 	if (_widget->skipItemRepaint()) {
 		return;
 	}
@@ -996,17 +1046,47 @@ Ui::ChatPaintContext HistoryInner::preparePaintContext(
 		const QRect &clip) const {
 	const auto visibleAreaPositionGlobal = mapToGlobal(
 		QPoint(0, _visibleAreaTop));
-	return _controller->preparePaintContext({
+	auto result = _controller->preparePaintContext({
 		.theme = _theme.get(),
 		.clip = clip,
 		.visibleAreaPositionGlobal = visibleAreaPositionGlobal,
 		.visibleAreaTop = _visibleAreaTop,
 		.visibleAreaWidth = width(),
 	});
+	if (_throughputMode) {
+		result.paused = true;
+		result.bubblesPattern = nullptr;
+	}
+	return result;
+}
+
+void HistoryInner::registerThroughputMessage() {
+	_throughputMessages.push_back(crl::now());
+	checkThroughputMode();
+}
+
+void HistoryInner::checkThroughputMode() {
+	const auto now = crl::now();
+	while (!_throughputMessages.empty()
+		&& _throughputMessages.front() + kThroughputPeriod <= now) {
+		_throughputMessages.pop_front();
+	}
+	if (!_throughputMessages.empty()) {
+		_throughputTimer.callOnce(
+			_throughputMessages.front() + kThroughputPeriod - now);
+	}
+	const auto count = int(_throughputMessages.size());
+	const auto throughput = _throughputMode
+		? (count >= kThroughputLeaveCount)
+		: (count >= kThroughputEnterCount);
+	if (_throughputMode != throughput) {
+		_throughputMode = throughput;
+		update();
+	}
 }
 
 void HistoryInner::startEffectOnRead(not_null<HistoryItem*> item) {
-	if (item->history() == _history) {
+	if (item->history() == _history && !_throughputMode) {
 		if (const auto view = item->mainView()) {
 			_emojiInteractions->playEffectOnRead(view);
 		}
@@ -1022,6 +1102,10 @@ void HistoryInner::paintEvent(QPaintEvent *e) {
 		mouseActionUpdate();
 	}
 
+	const auto profiler = Core::PaintProfiler::Scope(_throughputMode
+		? Core::PaintProfiler::Section::HistoryThroughput
+		: Core::PaintProfiler::Section::History);
+
 	Painter p(this);
 	auto clip = e->rect();
 
@@ -1163,7 +1247,7 @@ void HistoryInner::paintEvent(QPaintEvent *e) {
 				selfromy - mtop,
 				seltoy - mtop);
 			context.highlight = _widget->itemHighlight(view->data());
-			view->draw(p, context);
+			drawView(p, view, context);
 			processPainted(view, top, height);
 
 			top += height;
@@ -1209,7 +1293,7 @@ void HistoryInner::paintEvent(QPaintEvent *e) {
 					selfromy - htop,
 					seltoy - htop);
 				context.highlight = _widget->itemHighlight(item);
-				view->draw(p, context);
+				drawView(p, view, context);
 				processPainted(view, top, height);
 			}
 			top += height;
@@ -1969,6 +2053,7 @@ void HistoryInner::itemRemoved(not_null<const HistoryItem*> item) {
 }
 
 void HistoryInner::viewRemoved(not_null<const Element*> view) {
+	_viewCache.remove(view);
 	const auto refresh = [&](auto &saved) {
 		if (saved == view) {
 			const auto now = viewByItem(view->data());
@@ -3279,9 +3364,22 @@ void HistoryInner::recountHistoryGeometry() {
 
 	updateBotInfo(false);
 
-	_history->resizeToWidth(_contentWidth);
+	const auto resize = [&](not_null<History*> history, int top) {
+		if (top >= 0 && _visibleAreaBottom > _visibleAreaTop) {
+			history->resizeToWidth(
+				_contentWidth,
+				_visibleAreaTop - top,
+				_visibleAreaBottom - top);
+		} else {
+			history->resizeToWidth(
+				_contentWidth,
+				0,
+				std::numeric_limits<int>::max());
+		}
+	};
+	resize(_history, historyTop());
 	if (_migrated) {
-		_migrated->resizeToWidth(_contentWidth);
+		resize(_migrated, migratedTop());
 	}
 
 	// With migrated history we perhaps do not need to display
@@ -3401,12 +3499,76 @@ void HistoryInner::visibleAreaUpdated(int top, int bottom) {
 			till);
 	}
 	checkActivation();
+	updateVideoPreloads();
 
 	_emojiInteractions->visibleAreaUpdated(
 		_visibleAreaTop,
 		_visibleAreaBottom);
 }
 
+void HistoryInner::updateVideoPreloads() {
+	using Entry = Data::VideoPreloadScheduler::Entry;
+
+	const auto visibleAreaHeight = _visibleAreaBottom - _visibleAreaTop;
+	const auto from = _visibleAreaTop
+		- kPreloadVideosPagesAbove * visibleAreaHeight;
+	const auto till = _visibleAreaBottom
+		+ kPreloadVideosPagesBelow * visibleAreaHeight;
+	const auto &settings = session().settings().autoDownload();
+
+	// Visible videos are streamed by their views, so only the videos
+	// that are about to be scrolled into the viewport are preloaded.
+	auto found = std::vector<std::pair<int, Entry>>();
+	const auto collect = [&](History *history, int historytop) {
+		if (!history || historytop < 0) {
+			return;
+		}
+		for (const auto &block : history->blocks) {
+			const auto blocktop = historytop + block->y();
+			if (blocktop >= till || blocktop + block->height() <= from) {
+				continue;
+			}
+			for (const auto &view : block->messages) {
+				const auto top = blocktop + view->y();
+				const auto bottom = top + view->height();
+				if (top >= till || bottom <= from) {
+					continue;
+				} else if (top < _visibleAreaBottom
+					&& bottom > _visibleAreaTop) {
+					continue;
+				}
+				const auto media = view->media();
+				const auto document = media ? media->getDocument() : nullptr;
+				if (!document
+					|| !(document->isVideoFile() || document->isAnimation())
+					|| !Data::AutoDownload::ShouldAutoPlay(
+						settings,
+						history->peer,
+						document)) {
+					continue;
+				}
+				const auto distance = (top >= _visibleAreaBottom)
+					? (top - _visibleAreaBottom)
+					: (_visibleAreaTop - bottom);
+				found.emplace_back(distance, Entry{
+					.video = document,
+					.context = view->data()->fullId(),
+				});
+			}
+		}
+	};
+	collect(_migrated, migratedTop());
+	collect(_history, historyTop());
+
+	ranges::sort(found, ranges::less(), &std::pair<int, Entry>::first);
+	auto entries = std::vector<Entry>();
+	entries.reserve(found.size());
+	for (const auto &[distance, entry] : found) {
+		entries.push_back(entry);
+	}
+	session().data().videoPreloads().setWindow(this, std::move(entries));
+}
+
 bool HistoryInner::displayScrollDate() const {
 	return (_visibleAreaTop <= height() - 2 * (_visibleAreaBottom - _visibleAreaTop));
 }
@@ -3534,6 +3696,7 @@ void HistoryInner::leaveEventHook(QEvent *e) {
 }
 
 HistoryInner::~HistoryInner() {
+	session().data().videoPreloads().clearWindow(this);
 	_aboutView = nullptr;
 	for (const auto &item : _animatedStickersPlayed) {
 		if (const auto view = item->mainView()) {
@@ -4478,6 +4641,94 @@ void HistoryInner::deleteItem(not_null<HistoryItem*> item) {
 	}
 }
 
+bool HistoryInner::hasLazyResizedBlocks() const {
+	const auto check = [&](not_null<History*> history, int top) {
+		return (top >= 0)
+			&& history->hasLazyResizedBlocks(
+				_visibleAreaTop - top,
+				_visibleAreaBottom - top);
+	};
+	return check(_history, historyTop())
+		|| (_migrated && check(_migrated, migratedTop()));
+}
+
+void HistoryInner::drawView(
+		Painter &p,
+		not_null<Element*> view,
+		const Ui::ChatPaintContext &context) {
+	Core::PaintProfiler::CountElement();
+	if (!canCacheView(view, context)) {
+		_viewCache.remove(view);
+		view->draw(p, context);
+		return;
+	}
+	const auto range = view->verticalRepaintRange();
+	const auto ratio = style::DevicePixelRatio();
+	const auto size = QSize(view->width(), range.height) * ratio;
+	auto i = _viewCache.find(view);
+	if (i == end(_viewCache)) {
+		if (_viewCache.size() >= kMaxCachedViews) {
+			const auto now = context.now;
+			for (auto j = begin(_viewCache); j != end(_viewCache);) {
+				if (j->second.used != now) {
+					j = _viewCache.erase(j);
+				} else {
+					++j;
+				}
+			}
+		}
+		i = _viewCache.emplace(view, CachedView()).first;
+	}
+	auto &cached = i->second;
+	if (cached.image.size() != size) {
+		cached.image = QImage(size, QImage::Format_ARGB32_Premultiplied);
+		cached.image.setDevicePixelRatio(ratio);
+		cached.image.fill(Qt::transparent);
+
+		auto q = Painter(&cached.image);
+		q.translate(0, -range.top);
+		auto full = context;
+		full.clip = QRect(0, range.top, view->width(), range.height);
+		view->draw(q, full);
+	}
+	cached.used = context.now;
+	p.drawImage(0, range.top, cached.image);
+}
+
+bool HistoryInner::canCacheView(
+		not_null<const Element*> view,
+		const Ui::ChatPaintContext &context) const {
+	if (!CacheMessageViews.value()) {
+		return false;
+	}
+	// Everything that can be animated or drawn differently without
+	// a repaint request for the view itself is drawn directly.
+	const auto item = view->data();
+	const auto active = [&](Element *other) {
+		return (other == view.get());
+	};
+	return !view->media()
+		&& !view->hasHeavyPart()
+		&& !item->isSending()
+		&& context.selection.empty()
+		&& (context.highlight.opacity == 0.)
+		&& !context.gestureHorizontal.translation
+		&& !(context.outbg && context.bubblesPattern)
+		&& !inSelectionMode()
+		&& !active(Element::Hovered())
+		&& !active(Element::Pressed())
+		&& !active(Element::Moused())
+		&& !_reactionsManager->lookupEffectArea(item->fullId())
+		&& !ranges::contains(
+			item->originalText().entities,
+			EntityType::Spoiler,
+			&EntityInText::type);
+}
+
+void HistoryInner::clearViewCache() {
+	_viewCache.clear();
+}
+
 bool HistoryInner::hasPendingResizedItems() const {
 	return _history->hasPendingResizedItems()
 		|| (_migrated && _migrated->hasPendingResizedItems());
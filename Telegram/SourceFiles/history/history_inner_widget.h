@@ -65,6 +65,9 @@ using namespace ::Ui;
 class VideoUserpic;
 } // namespace Dialogs::Ui
 
+extern const char kOptionCacheMessageViews[];
+extern const char kOptionChatThroughputMode[];
+
 class HistoryInner;
 class HistoryMainElementDelegate;
 class HistoryMainElementDelegateMixin {
@@ -183,6 +186,9 @@ public:
 	// updates history->scrollTopItem/scrollTopOffset
 	void visibleAreaUpdated(int top, int bottom);
 
+	// Some blocks near the visible area still wait for the last resize.
+	[[nodiscard]] bool hasLazyResizedBlocks() const;
+
 	int historyHeight() const;
 	int historyScrollTop() const;
 	int migratedTop() const;
@@ -305,6 +311,7 @@ private:
 
 	void scrollDateCheck();
 	void scrollDateHideByTimer();
+	void updateVideoPreloads();
 	bool canHaveFromUserpics() const;
 	void mouseActionStart(const QPoint &screenPos, Qt::MouseButton button);
 	void mouseActionUpdate();
@@ -432,6 +439,20 @@ private:
 
 	VideoUserpic *validateVideoUserpic(not_null<PeerData*> peer);
 
+	// Static views are blitted from a raster made at the last repaint.
+	void drawView(
+		Painter &p,
+		not_null<Element*> view,
+		const Ui::ChatPaintContext &context);
+	[[nodiscard]] bool canCacheView(
+		not_null<const Element*> view,
+		const Ui::ChatPaintContext &context) const;
+	void clearViewCache();
+
+	// Busy chats are drawn without animations and bubble gradients.
+	void registerThroughputMessage();
+	void checkThroughputMode();
+
 	// Does any of the shown histories has this flag set.
 	bool hasPendingResizedItems() const;
 
@@ -482,6 +503,16 @@ private:
 		not_null<PeerData*>,
 		std::unique_ptr<VideoUserpic>> _videoUserpics;
 
+	struct CachedView {
+		QImage image;
+		crl::time used = 0;
+	};
+	base::flat_map<not_null<const Element*>, CachedView> _viewCache;
+
+	std::deque<crl::time> _throughputMessages;
+	base::Timer _throughputTimer;
+	bool _throughputMode = false;
+
 	std::unique_ptr<HistoryView::Reactions::Manager> _reactionsManager;
 	rpl::variable<HistoryItem*> _reactionsItem;
 	HistoryItem *_pinnedItem = nullptr;
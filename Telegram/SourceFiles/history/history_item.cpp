@@ -17,6 +17,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "history/view/media/history_view_media_grouped.h"
 #include "history/history_item_components.h"
 #include "history/history_item_helpers.h"
+#include "history/history_object_pool.h"
 #include "history/history_unread_things.h"
 #include "history/history.h"
 #include "iv/iv_data.h"
@@ -755,6 +756,14 @@ HistoryItem::~HistoryItem() {
 	applyTTL(0);
 }
 
+void *HistoryItem::operator new(std::size_t size) {
+	return HistoryObjectAllocate(size);
+}
+
+void HistoryItem::operator delete(void *pointer, std::size_t size) noexcept {
+	HistoryObjectFree(pointer, size);
+}
+
 TimeId HistoryItem::date() const {
 	return _date;
 }
@@ -3313,7 +3322,9 @@ void HistoryItem::setTextValue(TextWithEntities text, bool force) {
 		history()->owner().registerHighlightProcess(processId, this);
 	}
 	const auto had = !_text.empty();
+	history()->owner().sharedTexts().share(text);
 	_text = std::move(text);
+	history()->owner().messagesSearchIndex().update(this);
 	RemoveComponents(HistoryMessageTranslation::Bit());
 	if (had || force) {
 		history()->owner().requestItemTextRefresh(this);
@@ -178,6 +178,9 @@ public:
 		not_null<GameData*> game);
 	~HistoryItem();
 
+	[[nodiscard]] static void *operator new(std::size_t size);
+	static void operator delete(void *pointer, std::size_t size) noexcept;
+
 	struct Destroyer {
 		void operator()(HistoryItem *value);
 	};
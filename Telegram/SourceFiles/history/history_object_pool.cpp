@@ -0,0 +1,91 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "history/history_object_pool.h"
+
+namespace {
+
+constexpr auto kGranularity = std::size_t(16);
+constexpr auto kMaxPooledSize = std::size_t(2048);
+constexpr auto kClassesCount = kMaxPooledSize / kGranularity;
+constexpr auto kSlabSize = std::size_t(64 * 1024);
+
+static_assert(kGranularity >= alignof(std::max_align_t));
+static_assert(kGranularity >= sizeof(void*));
+
+struct FreeBlock {
+	FreeBlock *next = nullptr;
+};
+
+class Pool final {
+public:
+	[[nodiscard]] void *allocate(std::size_t size);
+	void free(void *pointer, std::size_t size) noexcept;
+
+private:
+	[[nodiscard]] static std::size_t ClassIndex(std::size_t size);
+
+	std::array<FreeBlock*, kClassesCount> _free = { { nullptr } };
+	std::vector<std::unique_ptr<std::byte[]>> _slabs;
+	std::byte *_slabPosition = nullptr;
+	std::size_t _slabLeft = 0;
+
+};
+
+std::size_t Pool::ClassIndex(std::size_t size) {
+	return (size + kGranularity - 1) / kGranularity - 1;
+}
+
+void *Pool::allocate(std::size_t size) {
+	if (!size || size > kMaxPooledSize) {
+		return ::operator new(size);
+	}
+	const auto index = ClassIndex(size);
+	if (const auto block = _free[index]) {
+		_free[index] = block->next;
+		return block;
+	}
+	const auto rounded = (index + 1) * kGranularity;
+	if (_slabLeft < rounded) {
+		// The rest of the previous slab is lost, it is less than a block.
+		_slabs.push_back(std::make_unique<std::byte[]>(kSlabSize));
+		_slabPosition = _slabs.back().get();
+		_slabLeft = kSlabSize;
+	}
+	const auto result = _slabPosition;
+	_slabPosition += rounded;
+	_slabLeft -= rounded;
+	return result;
+}
+
+void Pool::free(void *pointer, std::size_t size) noexcept {
+	if (!pointer) {
+		return;
+	} else if (!size || size > kMaxPooledSize) {
+		::operator delete(pointer);
+		return;
+	}
+	const auto index = ClassIndex(size);
+	const auto block = new (pointer) FreeBlock{ _free[index] };
+	_free[index] = block;
+}
+
+[[nodiscard]] Pool &Instance() {
+	// Never destroyed, items may be freed by other static destructors.
+	static const auto result = new Pool();
+	return *result;
+}
+
+} // namespace
+
+void *HistoryObjectAllocate(std::size_t size) {
+	return Instance().allocate(size);
+}
+
+void HistoryObjectFree(void *pointer, std::size_t size) noexcept {
+	Instance().free(pointer, size);
+}
@@ -0,0 +1,15 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+// Memory for history items and their views is taken from large slabs
+// and freed blocks are reused for objects of the same size class, so
+// loading and unloading long histories doesn't go to the general heap
+// allocator for every message. Main thread only.
+[[nodiscard]] void *HistoryObjectAllocate(std::size_t size);
+void HistoryObjectFree(void *pointer, std::size_t size) noexcept;
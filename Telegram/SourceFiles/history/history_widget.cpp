@@ -179,6 +179,9 @@ namespace {
 
 constexpr auto kMessagesPerPageFirst = 30;
 constexpr auto kMessagesPerPage = 50;
+constexpr auto kPreloadedAroundLimit = 4;
+constexpr auto kPreloadedAroundTimeout = 60 * crl::time(1000);
+constexpr auto kPreloadedAroundRequestId = -2; // Not real mtpRequestId.
 constexpr auto kPreloadHeightsCount = 3; // when 3 screens to scroll left make a preload request
 constexpr auto kScrollToVoiceAfterScrolledMs = 1000;
 constexpr auto kSkipRepaintWhileScrollMs = 100;
@@ -573,8 +576,15 @@ HistoryWidget::HistoryWidget(
 		const auto item = view->data();
 		const auto history = item->history();
 		if (item->mainView() == view
-			&& (history == _history || history == _migrated)) {
-			updateHistoryGeometry();
+			&& (history == _history || history == _migrated)
+			&& !_historyGeometryUpdateScheduled) {
+			// The history is not painted until the pending views are
+			// resized, so many requests can share a single update.
+			_historyGeometryUpdateScheduled = true;
+			crl::on_main(this, [=] {
+				_historyGeometryUpdateScheduled = false;
+				updateHistoryGeometry();
+			});
 		}
 	}, lifetime());
 
@@ -671,6 +681,7 @@ HistoryWidget::HistoryWidget(
 		if ((flags & HistoryUpdateFlag::UnreadMentions)
 			|| (flags & HistoryUpdateFlag::UnreadReactions)) {
 			_cornerButtons.updateUnreadThingsVisibility();
+			preloadUnreadThingsContext();
 		}
 		if (flags & HistoryUpdateFlag::UnreadView) {
 			unreadCountUpdated();
@@ -2701,6 +2712,8 @@ void HistoryWidget::clearSupportPreloadRequest() {
 		histories.cancelRequest(_supportPreloadRequest);
 		_supportPreloadRequest = 0;
 	}
+	_supportPreloadHistory = nullptr;
+	_supportPreloadFinished = false;
 }
 
 void HistoryWidget::clearAllLoadRequests() {
@@ -2712,6 +2725,10 @@ void HistoryWidget::clearAllLoadRequests() {
 		histories.cancelRequest(_firstLoadRequest);
 		_firstLoadRequest = 0;
 	}
+	if (_firstLoadRefreshRequest) {
+		histories.cancelRequest(_firstLoadRefreshRequest);
+		_firstLoadRefreshRequest = 0;
+	}
 	if (_preloadRequest) {
 		histories.cancelRequest(_preloadRequest);
 		_preloadRequest = 0;
@@ -3489,9 +3506,48 @@ void HistoryWidget::messagesReceived(
 	}
 }
 
+void HistoryWidget::firstLoadReceived(
+		not_null<PeerData*> peer,
+		const MTPmessages_Messages &messages,
+		int requestId) {
+	if (!requestId || _firstLoadRefreshRequest != requestId) {
+		messagesReceived(peer, messages, requestId);
+		return;
+	}
+	_firstLoadRefreshRequest = 0;
+	if (peer != _peer || _delayedShowAtRequest) {
+		return;
+	}
+
+	// Replace the messages shown from the local cache.
+	_history->clear(History::ClearType::Unload);
+	_delayedShowAtRequest = requestId;
+	_delayedShowAtMsgId = ShowAtTheEndMsgId;
+	_delayedShowAtMsgHighlightPart = {};
+	_delayedShowAtMsgHighlightPartOffsetHint = 0;
+	messagesReceived(peer, messages, requestId);
+}
+
+void HistoryWidget::cachedHistoryReceived(
+		not_null<History*> history,
+		const MTPmessages_Messages &messages,
+		int requestId) {
+	if (_history != history
+		|| !requestId
+		|| _firstLoadRequest != requestId
+		|| !_history->isEmpty()) {
+		return;
+	}
+	messagesReceived(history->peer, messages, requestId);
+	if (!_firstLoadRequest) {
+		_firstLoadRefreshRequest = requestId;
+	}
+}
+
 void HistoryWidget::historyLoaded() {
 	_historyInited = false;
 	doneShow();
+	preloadUnreadThingsContext();
 }
 
 void HistoryWidget::windowShown() {
@@ -3507,6 +3563,7 @@ bool HistoryWidget::markingContentsRead() const {
 		&& _list
 		&& _historyInited
 		&& !_firstLoadRequest
+		&& !_firstLoadRefreshRequest
 		&& !_delayedShowAtRequest
 		&& !_showAnimation
 		&& controller()->widget()->markingAsRead();
@@ -3563,6 +3620,14 @@ void HistoryWidget::firstLoadMessages() {
 	const auto minId = 0;
 	const auto historyHash = uint64(0);
 
+	// Only the last page of the chat is kept in the local cache.
+	const auto cached = (from == _history)
+		&& !_migrated
+		&& !offsetId
+		&& !offset
+		&& _history->isEmpty();
+	const auto requestId = std::make_shared<int>();
+
 	const auto history = from;
 	const auto type = Data::Histories::RequestType::History;
 	auto &histories = history->owner().histories();
@@ -3578,13 +3643,27 @@ void HistoryWidget::firstLoadMessages() {
 			MTP_int(minId),
 			MTP_long(historyHash)
 		)).done([=](const MTPmessages_Messages &result) {
-			messagesReceived(history->peer, result, _firstLoadRequest);
+			if (cached) {
+				history->owner().histories().cacheHistory(history, result);
+			}
+			firstLoadReceived(history->peer, result, *requestId);
 			finish();
 		}).fail([=](const MTP::Error &error) {
-			messagesFailed(error, _firstLoadRequest);
+			if (_firstLoadRefreshRequest == *requestId) {
+				// Keep showing the messages from the local cache.
+				_firstLoadRefreshRequest = 0;
+			}
+			messagesFailed(error, *requestId);
 			finish();
 		}).send();
 	});
+	*requestId = _firstLoadRequest;
+	if (cached) {
+		histories.requestCachedHistory(history, crl::guard(this, [=](
+				const MTPmessages_Messages &result) {
+			cachedHistoryReceived(history, result, *requestId);
+		}));
+	}
 }
 
 void HistoryWidget::loadMessages() {
@@ -3729,6 +3808,14 @@ void HistoryWidget::delayedShowAt(
 	clearAllLoadRequests();
 	_delayedShowAtMsgId = showAtMsgId;
 
+	if (showAtMsgId > 0) {
+		if (const auto result = takePreloadedAround(showAtMsgId)) {
+			_delayedShowAtRequest = kPreloadedAroundRequestId;
+			messagesReceived(_history->peer, *result, _delayedShowAtRequest);
+			return;
+		}
+	}
+
 	DEBUG_LOG(("JumpToEnd(%1, %2, %3): Loading delayed around %4."
 		).arg(_history->peer->name()
 		).arg(_history->inboxReadTillId().bare
@@ -3793,11 +3880,88 @@ void HistoryWidget::delayedShowAt(
 	});
 }
 
+void HistoryWidget::preloadUnreadThingsContext() {
+	if (!_history || _firstLoadRequest || _delayedShowAtRequest) {
+		return;
+	}
+	const auto preload = [&](MsgId msgId) {
+		if (msgId > 0 && !_history->isReadyFor(msgId)) {
+			preloadAround(msgId);
+		}
+	};
+	auto &unreadThings = session().api().unreadThings();
+	if (unreadThings.trackMentions(_history)) {
+		preload(_history->unreadMentions().minLoaded());
+	}
+	if (unreadThings.trackReactions(_history)) {
+		preload(_history->unreadReactions().minLoaded());
+	}
+}
+
+void HistoryWidget::preloadAround(MsgId msgId) {
+	const auto history = _history;
+	const auto id = FullMsgId(history->peer->id, msgId);
+	const auto i = _preloadedAround.find(id);
+	if (_preloadAroundRequests.contains(id)
+		|| (i != end(_preloadedAround)
+			&& i->second.received + kPreloadedAroundTimeout > crl::now())) {
+		return;
+	}
+	const auto loadCount = kMessagesPerPage;
+	const auto type = Data::Histories::RequestType::History;
+	auto &histories = history->owner().histories();
+	_preloadAroundRequests.emplace(id);
+	histories.sendRequest(history, type, [=](Fn<void()> finish) {
+		return history->session().api().request(MTPmessages_GetHistory(
+			history->peer->input,
+			MTP_int(msgId),
+			MTP_int(0), // offset_date
+			MTP_int(-loadCount / 2),
+			MTP_int(loadCount),
+			MTP_int(0), // max_id
+			MTP_int(0), // min_id
+			MTP_long(0) // hash
+		)).done([=](const MTPmessages_Messages &result) {
+			_preloadAroundRequests.remove(id);
+			_preloadedAround[id] = { result, crl::now() };
+			while (_preloadedAround.size() > kPreloadedAroundLimit) {
+				_preloadedAround.erase(ranges::min_element(
+					_preloadedAround,
+					ranges::less(),
+					[](const auto &pair) { return pair.second.received; }));
+			}
+			finish();
+		}).fail([=] {
+			_preloadAroundRequests.remove(id);
+			finish();
+		}).send();
+	});
+}
+
+std::optional<MTPmessages_Messages> HistoryWidget::takePreloadedAround(
+		MsgId msgId) {
+	const auto i = _preloadedAround.find(
+		FullMsgId(_history->peer->id, msgId));
+	if (i == end(_preloadedAround)) {
+		return std::nullopt;
+	}
+	auto result = std::move(i->second);
+	_preloadedAround.erase(i);
+	if (result.received + kPreloadedAroundTimeout <= crl::now()) {
+		return std::nullopt;
+	}
+	return std::move(result.result);
+}
+
 void HistoryWidget::handleScroll() {
 	if (!_itemsRevealHeight) {
 		preloadHistoryIfNeeded();
 	}
 	visibleAreaUpdated();
+	if (_list && _list->hasLazyResizedBlocks()) {
+		// The scroll top item is already updated, it stays in place.
+		updateHistoryGeometry();
+	}
 	if (!_itemsRevealHeight) {
 		updatePinnedViewer();
 	}
@@ -3886,31 +4050,69 @@ void HistoryWidget::checkSupportPreload(bool force) {
 		|| _firstLoadRequest
 		|| _preloadRequest
 		|| _preloadDownRequest
-		|| (_supportPreloadRequest && !force)
+		|| ((_supportPreloadRequest || _supportPreloadFinished) && !force)
 		|| controller()->activeChatEntryCurrent().key.history() != _history) {
 		return;
 	}
 
-	const auto setting = session().settings().supportSwitch();
-	const auto command = Support::GetSwitchCommand(setting);
-	const auto descriptor = !command
-		? Dialogs::RowDescriptor()
-		: (*command == Shortcuts::Command::ChatNext)
-		? controller()->resolveChatNext()
-		: controller()->resolveChatPrevious();
-	auto history = descriptor.key.history();
-	if (!history || _supportPreloadHistory == history) {
+	const auto targets = supportPreloadTargets();
+	_supportPreloaded.erase(
+		ranges::remove_if(_supportPreloaded, [&](not_null<History*> h) {
+			return !ranges::contains(targets, h);
+		}),
+		end(_supportPreloaded));
+	if (_supportPreloadHistory) {
+		if (ranges::contains(targets, not_null(_supportPreloadHistory))) {
+			return;
+		}
+		clearSupportPreloadRequest();
+	}
+	const auto i = ranges::find_if(targets, [&](not_null<History*> h) {
+		return !ranges::contains(_supportPreloaded, h);
+	});
+	if (i == end(targets)) {
+		_supportPreloadFinished = true;
 		return;
 	}
-	clearSupportPreloadRequest();
+	const auto history = *i;
+	_supportPreloadFinished = false;
 	_supportPreloadHistory = history;
 	_supportPreloadRequest = Support::SendPreloadRequest(history, [=] {
 		_supportPreloadRequest = 0;
 		_supportPreloadHistory = nullptr;
 		crl::on_main(this, [=] { checkSupportPreload(); });
+	}, [=] {
+		_supportPreloadRequest = 0;
+		_supportPreloadHistory = nullptr;
+		_supportPreloaded.push_back(history);
+		crl::on_main(this, [=] { checkSupportPreload(); });
 	});
 }
 
+std::vector<not_null<History*>> HistoryWidget::supportPreloadTargets() const {
+	const auto setting = session().settings().supportSwitch();
+	const auto command = Support::GetSwitchCommand(setting);
+	const auto count = session().settings().supportPreloadChats();
+	auto result = std::vector<not_null<History*>>();
+	if (!command) {
+		return result;
+	}
+	auto descriptor = controller()->activeChatEntryCurrent();
+	while (int(result.size()) < count) {
+		descriptor = (*command == Shortcuts::Command::ChatNext)
+			? controller()->resolveChatNext(descriptor)
+			: controller()->resolveChatPrevious(descriptor);
+		const auto history = descriptor.key.history();
+		if (!history
+			|| history == _history
+			|| ranges::contains(result, not_null(history))) {
+			break;
+		}
+		result.push_back(history);
+	}
+	return result;
+}
+
 void HistoryWidget::checkReplyReturns() {
 	if (_firstLoadRequest
 		|| _scroll->isHidden()
@@ -157,6 +157,10 @@ public:
 		MsgId showAtMsgId,
 		const TextWithEntities &highlightPart,
 		int highlightPartOffsetHint);
+	void preloadUnreadThingsContext();
+	void preloadAround(MsgId msgId);
+	[[nodiscard]] std::optional<MTPmessages_Messages> takePreloadedAround(
+		MsgId msgId);
 
 	bool updateReplaceMediaButton();
 	void updateFieldPlaceholder();
@@ -556,6 +560,14 @@ private:
 
 	void messagesReceived(not_null<PeerData*> peer, const MTPmessages_Messages &messages, int requestId);
 	void messagesFailed(const MTP::Error &error, int requestId);
+	void firstLoadReceived(
+		not_null<PeerData*> peer,
+		const MTPmessages_Messages &messages,
+		int requestId);
+	void cachedHistoryReceived(
+		not_null<History*> history,
+		const MTPmessages_Messages &messages,
+		int requestId);
 	void addMessagesToFront(not_null<PeerData*> peer, const QVector<MTPMessage> &messages);
 	void addMessagesToBack(not_null<PeerData*> peer, const QVector<MTPMessage> &messages);
 
@@ -618,6 +630,7 @@ private:
 	[[nodiscard]] bool hasSilentToggle() const;
 
 	void checkSupportPreload(bool force = false);
+	[[nodiscard]] std::vector<not_null<History*>> supportPreloadTargets() const;
 	void handleSupportSwitch(not_null<History*> updated);
 
 	[[nodiscard]] bool isRecording() const;
@@ -687,6 +700,7 @@ private:
 
 	bool _preserveScrollTop = false;
 	bool _repaintFieldScheduled = false;
+	bool _historyGeometryUpdateScheduled = false;
 
 	mtpRequestId _saveEditMsgRequestId = 0;
 
@@ -705,6 +719,8 @@ private:
 	int _showAtMsgHighlightPartOffsetHint = 0;
 
 	int _firstLoadRequest = 0; // Not real mtpRequestId.
+	// Messages from the local cache are shown until this one is received.
+	int _firstLoadRefreshRequest = 0; // Not real mtpRequestId.
 	int _preloadRequest = 0; // Not real mtpRequestId.
 	int _preloadDownRequest = 0; // Not real mtpRequestId.
 
@@ -713,8 +729,19 @@ private:
 	int _delayedShowAtMsgHighlightPartOffsetHint = 0;
 	int _delayedShowAtRequest = 0; // Not real mtpRequestId.
 
+	// Slices around the next unread mention and reaction, so that
+	// jumping to them doesn't wait for the request.
+	struct PreloadedAround {
+		MTPmessages_Messages result;
+		crl::time received = 0;
+	};
+	base::flat_set<FullMsgId> _preloadAroundRequests;
+	base::flat_map<FullMsgId, PreloadedAround> _preloadedAround;
+
 	History *_supportPreloadHistory = nullptr;
 	int _supportPreloadRequest = 0; // Not real mtpRequestId.
+	std::vector<not_null<History*>> _supportPreloaded;
+	bool _supportPreloadFinished = false;
 
 	object_ptr<HistoryView::TopBarWidget> _topBar;
 	object_ptr<Ui::ContinuousScroll> _scroll;
@@ -41,6 +41,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 namespace HistoryView {
 namespace {
 
+constexpr auto kPreloadResultsAhead = 5;
+
 using SearchRequest = Api::MessagesSearchMerged::Request;
 
 [[nodiscard]] inline bool HasChooseFrom(not_null<History*> history) {
@@ -610,6 +612,7 @@ public:
 	BottomBar(not_null<Ui::RpWidget*> parent, bool fastShowChooseFrom);
 
 	void setTotal(int total);
+	void updateTotal(int total);
 	void setCurrent(int current);
 
 	[[nodiscard]] rpl::producer<Index> showItemRequests() const;
@@ -770,6 +773,13 @@ void BottomBar::setTotal(int total) {
 	setCurrent(1);
 }
 
+void BottomBar::updateTotal(int total) {
+	if (_total != total) {
+		_total = total;
+		updateText(_current.current());
+	}
+}
+
 void BottomBar::setCurrent(int current) {
 	_current.force_assign(current);
 }
@@ -939,6 +949,7 @@ ComposeSearch::Inner::Inner(
 
 	_apiSearch.nextFounds(
 	) | rpl::start_with_next([=] {
+		_bottomBar->updateTotal(_apiSearch.messages().total);
 		if (_pendingJump.data.token == _apiSearch.messages().nextToken) {
 			_pendingJump.jumps.fire_copy(_pendingJump.data.index);
 		}
@@ -952,7 +963,7 @@ ComposeSearch::Inner::Inner(
 		const auto &apiData = _apiSearch.messages();
 		const auto &messages = apiData.messages;
 		const auto size = int(messages.size());
-		if (index >= (size - 1) && size != apiData.total) {
+		if (index >= (size - kPreloadResultsAhead) && size != apiData.total) {
 			_apiSearch.searchMore();
 		}
 		if (index >= size || index < 0) {
@@ -8,6 +8,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "history/view/controls/history_view_webpage_processor.h"
 
 #include "base/unixtime.h"
+#include "data/data_types.h"
 #include "data/data_chat_participant_status.h"
 #include "data/data_file_origin.h"
 #include "data/data_session.h"
@@ -15,8 +16,34 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "history/history.h"
 #include "lang/lang_keys.h"
 #include "main/main_session.h"
+#include "storage/cache/storage_cache_database.h"
 
 namespace HistoryView::Controls {
+namespace {
+
+[[nodiscard]] QByteArray SerializeWebPage(const MTPWebPage &data) {
+	auto buffer = mtpBuffer();
+	data.write(buffer);
+	return QByteArray(
+		reinterpret_cast<const char*>(buffer.constData()),
+		buffer.size() * sizeof(mtpPrime));
+}
+
+[[nodiscard]] std::optional<MTPWebPage> DeserializeWebPage(
+		const QByteArray &bytes) {
+	if (bytes.isEmpty() || (bytes.size() % sizeof(mtpPrime))) {
+		return std::nullopt;
+	}
+	auto from = reinterpret_cast<const mtpPrime*>(bytes.constData());
+	const auto till = from + (bytes.size() / sizeof(mtpPrime));
+	auto result = MTPWebPage();
+	if (!result.read(from, till) || (from != till)) {
+		return std::nullopt;
+	}
+	return result;
+}
+
+} // namespace
 
 WebPageText TitleAndDescriptionFromWebPage(not_null<WebPageData*> d) {
 	QString resultTitle, resultDescription;
@@ -145,14 +172,18 @@ void WebpageResolver::request(const QString &link, bool force) {
 			page->pendingTill = 0;
 			page->failed = true;
 		}
-		_cache.emplace(link, page->failed ? nullptr : page.get());
+		_cache[link] = page->failed ? nullptr : page.get();
 		_resolved.fire_copy(link);
+		saveCached(link, data.vwebpage());
 	};
 	const auto fail = [=] {
-		_cache.emplace(link, nullptr);
+		_cache[link] = nullptr;
 		_resolved.fire_copy(link);
 	};
 	_requestLink = link;
+	if (!force) {
+		checkCached(link);
+	}
 	_requestId = _api.request(
 		MTPmessages_GetWebPagePreview(
 			MTP_flags(0),
@@ -177,10 +208,53 @@ void WebpageResolver::request(const QString &link, bool force) {
 
 void WebpageResolver::cancel(const QString &link) {
 	if (_requestLink == link) {
+		_requestLink = QString();
 		_api.request(base::take(_requestId)).cancel();
 	}
 }
 
+void WebpageResolver::checkCached(const QString &link) {
+	const auto weak = base::make_weak(this);
+	auto &cache = _session->data().cache();
+	cache.get(Data::WebPagePreviewCacheKey(link), [=](QByteArray &&value) {
+		crl::on_main(weak, [=, value = std::move(value)] {
+			cachedChecked(link, value);
+		});
+	});
+}
+
+void WebpageResolver::cachedChecked(
+		const QString &link,
+		const QByteArray &value) {
+	if (_requestLink != link || _cache.contains(link)) {
+		return;
+	}
+	const auto data = DeserializeWebPage(value);
+	if (!data || data->type() != mtpc_webPage) {
+		return;
+	}
+	// Shown until the request sent together with the check is finished.
+	const auto page = _session->data().processWebpage(*data);
+	if (!page->failed && !page->pendingTill) {
+		_cache.emplace(link, page.get());
+		_resolved.fire_copy(link);
+	}
+}
+
+void WebpageResolver::saveCached(
+		const QString &link,
+		const MTPWebPage &data) {
+	const auto key = Data::WebPagePreviewCacheKey(link);
+	auto &cache = _session->data().cache();
+	if (data.type() == mtpc_webPage) {
+		cache.put(key, Storage::Cache::Database::TaggedValue(
+			SerializeWebPage(data),
+			Data::kMessagesCacheTag));
+	} else if (data.type() == mtpc_webPageEmpty) {
+		cache.remove(key);
+	}
+}
+
 WebpageProcessor::WebpageProcessor(
 	not_null<History*> history,
 	not_null<Ui::InputField*> field)
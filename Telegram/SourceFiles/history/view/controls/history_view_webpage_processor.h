@@ -7,6 +7,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #pragma once
 
+#include "base/weak_ptr.h"
 #include "data/data_drafts.h"
 #include "chat_helpers/message_field.h"
 #include "mtproto/sender.h"
@@ -50,7 +51,7 @@ struct WebpageParsed {
 	}
 };
 
-class WebpageResolver final {
+class WebpageResolver final : public base::has_weak_ptr {
 public:
 	explicit WebpageResolver(not_null<Main::Session*> session);
 
@@ -66,6 +67,10 @@ public:
 	void cancel(const QString &link);
 
 private:
+	void checkCached(const QString &link);
+	void cachedChecked(const QString &link, const QByteArray &value);
+	void saveCached(const QString &link, const MTPWebPage &data);
+
 	const not_null<Main::Session*> _session;
 	MTP::Sender _api;
 	base::flat_map<QString, WebPageData*> _cache;
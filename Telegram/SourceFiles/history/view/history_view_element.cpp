@@ -7,6 +7,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #include "history/view/history_view_element.h"
 
+#include "history/history_object_pool.h"
 #include "history/view/history_view_service_message.h"
 #include "history/view/history_view_message.h"
 #include "history/view/media/history_view_media_grouped.h"
@@ -26,6 +27,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "core/application.h"
 #include "core/core_settings.h"
 #include "core/click_handler_types.h"
+#include "core/core_paint_profiler.h"
 #include "core/ui_integration.h"
 #include "main/main_app_config.h"
 #include "main/main_session.h"
@@ -1266,6 +1268,7 @@ void Element::recountDisplayDateInBlocks() {
 
 QSize Element::countOptimalSize() {
 	_flags &= ~Flag::NeedsResize;
+	Core::PaintProfiler::CountLayout();
 	return performCountOptimalSize();
 }
 
@@ -1273,6 +1276,7 @@ QSize Element::countCurrentSize(int newWidth) {
 	if (_flags & Flag::NeedsResize) {
 		initDimensions();
 	}
+	Core::PaintProfiler::CountLayout();
 	return performCountCurrentSize(newWidth);
 }
 
@@ -1876,6 +1880,14 @@ Element::~Element() {
 	history()->owner().unregisterItemView(this);
 }
 
+void *Element::operator new(std::size_t size) {
+	return HistoryObjectAllocate(size);
+}
+
+void Element::operator delete(void *pointer, std::size_t size) noexcept {
+	HistoryObjectFree(pointer, size);
+}
+
 void Element::Hovered(Element *view) {
 	HoveredElement = view;
 }
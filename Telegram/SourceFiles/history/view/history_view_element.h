@@ -577,6 +577,9 @@ public:
 
 	virtual ~Element();
 
+	[[nodiscard]] static void *operator new(std::size_t size);
+	static void operator delete(void *pointer, std::size_t size) noexcept;
+
 	static void Hovered(Element *view);
 	[[nodiscard]] static Element *Hovered();
 	static void Pressed(Element *view);
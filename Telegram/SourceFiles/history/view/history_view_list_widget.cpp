@@ -64,6 +64,10 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_folder.h"
 #include "data/data_media_types.h"
 #include "data/data_document.h"
+#include "data/data_document_media.h"
+#include "data/data_photo.h"
+#include "data/data_photo_media.h"
+#include "data/stickers/data_custom_emoji.h"
 #include "data/data_peer.h"
 #include "data/data_user.h"
 #include "data/data_chat.h"
@@ -84,6 +88,10 @@ constexpr auto kPreloadIfLessThanScreens = 2;
 constexpr auto kPreloadedScreensCountFull
 	= kPreloadedScreensCount + 1 + kPreloadedScreensCount;
 constexpr auto kClearUserpicsAfter = 50;
+constexpr auto kPrefetchAhead = crl::time(500);
+constexpr auto kPrefetchVelocityTimeout = crl::time(200);
+constexpr auto kPrefetchMinVelocity = 0.5; // Pixels per millisecond.
+constexpr auto kClearPrefetchedAfter = 100;
 
 [[nodiscard]] std::unique_ptr<TranslateTracker> MaybeTranslateTracker(
 		History *history) {
@@ -92,6 +100,28 @@ constexpr auto kClearUserpicsAfter = 50;
 
 } // namespace
 
+class ListWidget::PrefetchEmojiListener final
+	: public Data::CustomEmojiManager::Listener {
+public:
+	explicit PrefetchEmojiListener(not_null<Data::CustomEmojiManager*> manager)
+	: _manager(manager) {
+	}
+	~PrefetchEmojiListener() {
+		_manager->unregisterListener(this);
+	}
+
+	void resolve(DocumentId id) {
+		_manager->resolve(id, this);
+	}
+
+private:
+	void customEmojiResolveDone(not_null<DocumentData*> document) override {
+	}
+
+	const not_null<Data::CustomEmojiManager*> _manager;
+
+};
+
 const crl::time ListWidget::kItemRevealDuration = crl::time(150);
 
 WindowListDelegate::WindowListDelegate(
@@ -1081,6 +1111,7 @@ void ListWidget::visibleTopBottomUpdated(
 
 	const auto initializing = !(_visibleTop < _visibleBottom);
 	const auto scrolledUp = (visibleTop < _visibleTop);
+	const auto wasVisibleTop = _visibleTop;
 	_visibleTop = visibleTop;
 	_visibleBottom = visibleBottom;
 
@@ -1103,6 +1134,111 @@ void ListWidget::visibleTopBottomUpdated(
 	_applyUpdatedScrollState.call();
 
 	_emojiInteractions->visibleAreaUpdated(_visibleTop, _visibleBottom);
+
+	if (!initializing) {
+		updatePrefetch(wasVisibleTop, _visibleTop);
+	}
+
+	if (hasLazyResizedItems()) {
+		// The visible top item is already updated, it stays in place.
+		updateSize();
+	}
+}
+
+void ListWidget::updatePrefetch(int was, int now) {
+	const auto time = crl::now();
+	const auto elapsed = time - _prefetchTime;
+	const auto delta = now - was;
+	const auto available = _visibleBottom - _visibleTop;
+	_prefetchTime = time;
+	if (!delta) {
+		return;
+	} else if (std::abs(delta) > kPreloadedScreensCount * available) {
+		// That was a jump, not a scroll, nothing to predict from it.
+		cancelPrefetch();
+		return;
+	} else if (elapsed <= 0 || elapsed >= kPrefetchVelocityTimeout) {
+		_prefetchVelocity = 0.;
+		return;
+	}
+	const auto velocity = delta / float64(elapsed);
+	if (velocity * _prefetchVelocity < 0.) {
+		// The direction has changed, what we requested is not needed.
+		cancelPrefetch();
+	}
+	_prefetchVelocity = _prefetchVelocity
+		? ((_prefetchVelocity + velocity) / 2.)
+		: velocity;
+
+	const auto speed = std::abs(_prefetchVelocity);
+	if (speed < kPrefetchMinVelocity || _items.empty()) {
+		return;
+	}
+	const auto ahead = std::min(
+		int(speed * kPrefetchAhead),
+		kPreloadedScreensCount * available);
+	const auto down = (_prefetchVelocity > 0.);
+	const auto from = std::max(
+		down ? _visibleBottom : (_visibleTop - ahead),
+		_itemsTop);
+	const auto till = std::min(
+		down ? (_visibleBottom + ahead) : _visibleTop,
+		_itemsTop + _itemsHeight);
+	if (from >= till) {
+		return;
+	}
+	if (_prefetched.size() > kClearPrefetchedAfter) {
+		_prefetched.clear();
+	}
+	const auto fromIndex = findItemIndexByY(from);
+	const auto tillIndex = findItemIndexByY(till - 1) + 1;
+	for (auto i = fromIndex; i != tillIndex; ++i) {
+		prefetch(_items[i]);
+	}
+}
+
+void ListWidget::prefetch(not_null<Element*> view) {
+	const auto item = view->data();
+	const auto [i, ok] = _prefetched.emplace(item->fullId(), Prefetched());
+	if (!ok) {
+		return;
+	}
+	auto &entry = i->second;
+	if (const auto media = item->media()) {
+		if (const auto photo = media->photo()) {
+			entry.photo = photo->createMediaView();
+			entry.photo->wanted(Data::PhotoSize::Small, item->fullId());
+			entry.photo->automaticLoad(item->fullId(), item);
+		} else if (const auto document = media->document()) {
+			entry.document = document->createMediaView();
+			entry.document->thumbnailWanted(item->fullId());
+		}
+	}
+	if (view->hasFromPhoto()) {
+		if (const auto from = item->displayFrom()) {
+			if (!_userpics.contains(from)) {
+				_userpics.emplace(from, from->createUserpicView());
+				from->loadUserpic();
+			}
+		}
+	}
+	for (const auto &entity : item->originalText().entities) {
+		if (entity.type() != EntityType::CustomEmoji) {
+			continue;
+		} else if (const auto id = Data::ParseCustomEmojiData(entity.data())) {
+			if (!_prefetchEmojiListener) {
+				_prefetchEmojiListener = std::make_unique<PrefetchEmojiListener>(
+					&session().data().customEmojiManager());
+			}
+			_prefetchEmojiListener->resolve(id);
+		}
+	}
+}
+
+void ListWidget::cancelPrefetch() {
+	_prefetched.clear();
+	_prefetchEmojiListener = nullptr;
+	_prefetchVelocity = 0.;
 }
 
 void ListWidget::applyUpdatedScrollState() {
@@ -2025,14 +2161,21 @@ void ListWidget::revealItemsCallback() {
 int ListWidget::resizeGetHeight(int newWidth) {
 	update();
 
-	const auto resizeAllItems = (_itemsWidth != newWidth);
+	// Items far from the visible area keep the height for the width they
+	// were laid out for, they get resized when they are scrolled closer.
 	auto newHeight = 0;
+	_hasLazyResizedItems = false;
 	for (const auto &view : _items) {
+		const auto resize = view->pendingResize()
+			|| (view->width() != newWidth && nearVisibleArea(view));
 		view->setY(newHeight);
-		if (view->pendingResize() || resizeAllItems) {
+		if (resize) {
 			newHeight += view->resizeGetHeight(newWidth);
 		} else {
 			newHeight += view->height();
+			if (view->width() != newWidth) {
+				_hasLazyResizedItems = true;
+			}
 		}
 	}
 	if (newHeight > 0) {
@@ -2052,6 +2195,33 @@ int ListWidget::resizeGetHeight(int newWidth) {
 	return _itemsTop + _itemsHeight + st::historyPaddingBottom;
 }
 
+bool ListWidget::nearVisibleArea(not_null<const Element*> view) const {
+	if (!(_visibleTop < _visibleBottom) || !view->width()) {
+		return true;
+	}
+	const auto margin = _visibleBottom - _visibleTop;
+	const auto top = _itemsTop + view->y();
+	return (top < _visibleBottom + margin)
+		&& (top + view->height() > _visibleTop - margin);
+}
+
+bool ListWidget::hasLazyResizedItems() const {
+	if (!_hasLazyResizedItems) {
+		return false;
+	}
+	const auto margin = (_visibleBottom - _visibleTop) / 2;
+	for (const auto &view : _items) {
+		const auto top = _itemsTop + view->y();
+		if (top >= _visibleBottom + margin) {
+			break;
+		} else if (view->width() != _itemsWidth
+			&& top + view->height() > _visibleTop - margin) {
+			return true;
+		}
+	}
+	return false;
+}
+
 void ListWidget::restoreScrollPosition() {
 	auto newVisibleTop = _visibleTopItem
 		? (itemTop(_visibleTopItem) + _visibleTopFromItem)
@@ -2162,6 +2332,10 @@ void ListWidget::checkActivation() {
 void ListWidget::paintEvent(QPaintEvent *e) {
 	if (_delegate->listIgnorePaintEvent(this, e)) {
 		return;
+	} else if (!_itemResizePending.empty()) {
+		// Item geometry is outdated, repaint after resizePendingItems().
+		_itemResizePaintSkipped = true;
+		return;
 	} else if (_translateTracker) {
 		_translateTracker->startBunch();
 	}
@@ -3890,35 +4064,67 @@ void ListWidget::repaintItem(FullMsgId itemId) {
 }
 
 void ListWidget::resizeItem(not_null<Element*> view) {
-	const auto index = ranges::find(_items, view) - begin(_items);
-	if (index < int(_items.size())) {
-		refreshAttachmentsAtIndex(index);
+	// Reactions, translations and media loading often request resizes of
+	// many views at once, so they are applied together with a single
+	// updateSize() when the event loop gets control back.
+	if (_itemResizePending.empty()) {
+		crl::on_main(this, [=] {
+			resizePendingItems();
+		});
+	}
+	_itemResizePending.emplace(view);
+}
+
+void ListWidget::resizePendingItems() {
+	if (_itemResizePending.empty()) {
+		return;
+	}
+	const auto pending = base::take(_itemResizePending);
+	auto from = int(_items.size());
+	auto till = 0;
+	for (auto i = 0, count = int(_items.size()); i != count; ++i) {
+		if (pending.contains(_items[i])) {
+			from = std::min(from, i);
+			till = i + 1;
+		}
+	}
+	if (from < till) {
+		refreshAttachmentsAround(from, till);
+	}
+	if (base::take(_itemResizePaintSkipped)) {
+		update();
 	}
 }
 
 void ListWidget::refreshAttachmentsAtIndex(int index) {
 	Expects(index >= 0 && index < _items.size());
 
-	const auto from = [&] {
-		if (index > 0) {
-			for (auto i = index - 1; i != 0; --i) {
+	refreshAttachmentsAround(index, index + 1);
+}
+
+void ListWidget::refreshAttachmentsAround(int from, int till) {
+	Expects(from >= 0 && from < till && till <= _items.size());
+
+	const auto first = [&] {
+		if (from > 0) {
+			for (auto i = from - 1; i != 0; --i) {
 				if (!_items[i]->isHidden()) {
 					return i;
 				}
 			}
 		}
-		return index;
+		return from;
 	}();
-	const auto till = [&] {
+	const auto last = [&] {
 		const auto count = int(_items.size());
-		for (auto i = index + 1; i != count; ++i) {
+		for (auto i = till; i != count; ++i) {
 			if (!_items[i]->isHidden()) {
 				return i + 1;
 			}
 		}
-		return index + 1;
+		return till;
 	}();
-	refreshAttachmentsFromTill(from, till);
+	refreshAttachmentsFromTill(first, last);
 }
 
 void ListWidget::refreshAttachmentsFromTill(int from, int till) {
@@ -3994,6 +4200,10 @@ void ListWidget::viewReplaced(not_null<const Element*> was, Element *now) {
 			_itemRevealPending.emplace(now);
 		}
 	}
+	const auto k = _itemResizePending.find(was);
+	if (k != end(_itemResizePending)) {
+		_itemResizePending.erase(k);
+	}
 	const auto j = _itemRevealAnimations.find(was);
 	if (j != end(_itemRevealAnimations)) {
 		auto data = std::move(j->second);
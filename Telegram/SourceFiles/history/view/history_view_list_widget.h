@@ -41,6 +41,8 @@ class SessionController;
 
 namespace Data {
 struct Group;
+class PhotoMedia;
+class DocumentMedia;
 struct Reaction;
 struct AllowedReactions;
 struct ReactionId;
@@ -556,6 +558,7 @@ private:
 	void repaintItem(FullMsgId itemId);
 	void repaintItem(const Element *view);
 	void resizeItem(not_null<Element*> view);
+	void resizePendingItems();
 	void refreshItem(not_null<const Element*> view);
 	void itemRemoved(not_null<const HistoryItem*> item);
 	QPoint mapPointToItem(QPoint point, const Element *view) const;
@@ -578,8 +581,14 @@ private:
 	void updateVisibleTopItem();
 	void updateItemsGeometry();
 	void updateSize();
+	[[nodiscard]] bool nearVisibleArea(not_null<const Element*> view) const;
+	[[nodiscard]] bool hasLazyResizedItems() const;
+	void updatePrefetch(int was, int now);
+	void prefetch(not_null<Element*> view);
+	void cancelPrefetch();
 	void refreshAttachmentsFromTill(int from, int till);
 	void refreshAttachmentsAtIndex(int index);
+	void refreshAttachmentsAround(int from, int till);
 
 	void toggleScrollDateShown();
 	void repaintScrollDateCallback();
@@ -742,9 +751,12 @@ private:
 	ViewsMap _views, _viewsCapacity;
 	int _itemsTop = 0;
 	int _itemsWidth = 0;
+	bool _hasLazyResizedItems = false;
 	int _itemsHeight = 0;
 	int _itemAverageHeight = 0;
 	base::flat_set<not_null<Element*>> _itemRevealPending;
+	base::flat_set<not_null<Element*>> _itemResizePending;
+	bool _itemResizePaintSkipped = false;
 	base::flat_map<
 		not_null<Element*>,
 		ItemRevealAnimation> _itemRevealAnimations;
@@ -754,6 +766,16 @@ private:
 	base::flat_map<not_null<PeerData*>, Ui::PeerUserpicView> _userpicsCache;
 	base::flat_map<MsgId, Ui::PeerUserpicView> _hiddenSenderUserpics;
 
+	struct Prefetched {
+		std::shared_ptr<Data::PhotoMedia> photo;
+		std::shared_ptr<Data::DocumentMedia> document;
+	};
+	class PrefetchEmojiListener;
+	base::flat_map<FullMsgId, Prefetched> _prefetched;
+	std::unique_ptr<PrefetchEmojiListener> _prefetchEmojiListener;
+	crl::time _prefetchTime = 0;
+	float64 _prefetchVelocity = 0.;
+
 	const std::unique_ptr<Ui::PathShiftGradient> _pathGradient;
 	QPainterPath _highlightPathCache;
 
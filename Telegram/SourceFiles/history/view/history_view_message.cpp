@@ -568,6 +568,9 @@ void Message::animateReaction(Ui::ReactionFlyAnimationArgs &&args) {
 		return;
 	}
 	const auto repainter = [=] { repaint(); };
+	if (_reactions) {
+		history()->owner().registerHeavyViewPart(this);
+	}
 
 	const auto bubble = drawBubble();
 	const auto reactionsInBubble = _reactions && embedReactionsInBubble();
@@ -2337,6 +2340,7 @@ void Message::createTopicButtonRipple() {
 bool Message::hasHeavyPart() const {
 	return _comments
 		|| (_fromNameStatus && _fromNameStatus->custom)
+		|| (_reactions && _reactions->hasAnimations())
 		|| Element::hasHeavyPart();
 }
 
@@ -2344,6 +2348,9 @@ void Message::unloadHeavyPart() {
 	Element::unloadHeavyPart();
 	if (_reactions) {
 		_reactions->unloadCustomEmoji();
+
+		// Don't keep playing the effects out of the visible area.
+		_reactions->stopAnimations();
 	}
 	_comments = nullptr;
 	if (_fromNameStatus) {
@@ -55,6 +55,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "main/main_session.h"
 #include "main/main_session_settings.h"
 #include "data/components/scheduled_messages.h"
+#include "data/data_histories.h"
 #include "data/data_session.h"
 #include "data/data_user.h"
 #include "data/data_chat.h"
@@ -157,7 +158,7 @@ void RepliesMemento::setReadInformation(
 			}
 		}
 		if (!_replies) {
-			_replies = std::make_shared<Data::RepliesList>(
+			_replies = _history->owner().histories().repliesList(
 				_history,
 				_rootId);
 		}
@@ -2129,7 +2130,7 @@ void RepliesWidget::refreshReplies() {
 	auto old = base::take(_replies);
 	setReplies(_topic
 		? _topic->replies()
-		: std::make_shared<Data::RepliesList>(_history, _rootId));
+		: _history->owner().histories().repliesList(_history, _rootId));
 	if (old) {
 		_inner->refreshViewer();
 	}
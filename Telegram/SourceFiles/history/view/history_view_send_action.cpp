@@ -134,7 +134,11 @@ bool SendActionPainter::updateNeedsAnimating(
 	}, [&](const MTPDsendMessageCancelAction &) {
 		Unexpected("CancelAction here.");
 	});
-	return updateNeedsAnimating(now, true);
+
+	// Many actions come in one updates batch in large groups, so the
+	// string is built once on the next animation frame for all of them.
+	_changed = true;
+	return !_typing.empty() || !_sendActions.empty() || !_speaking.empty();
 }
 
 bool SendActionPainter::paint(
@@ -205,6 +209,9 @@ bool SendActionPainter::updateNeedsAnimating(crl::time now, bool force) {
 	if (!_weak) {
 		return false;
 	}
+	if (base::take(_changed)) {
+		force = true;
+	}
 	auto sendActionChanged = false;
 	auto speakingChanged = false;
 	for (auto i = begin(_typing); i != end(_typing);) {
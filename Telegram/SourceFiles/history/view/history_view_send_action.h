@@ -73,6 +73,7 @@ private:
 
 	int _animationLeft = 0;
 	int _spacesCount = 0;
+	bool _changed = false;
 
 };
 
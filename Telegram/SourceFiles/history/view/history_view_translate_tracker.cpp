@@ -20,6 +20,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "history/view/history_view_element.h"
 #include "main/main_session.h"
 #include "spellcheck/platform/platform_language.h"
+#include "storage/cache/storage_cache_database.h"
 
 namespace HistoryView {
 namespace {
@@ -30,6 +31,50 @@ constexpr auto kMaxCheckInBunch = 100;
 constexpr auto kRequestLengthLimit = 24 * 1024;
 constexpr auto kRequestCountLimit = 20;
 
+[[nodiscard]] Storage::Cache::Key CacheKey(
+		not_null<HistoryItem*> item,
+		LanguageId to) {
+	const auto edited = item->Get<HistoryMessageEdited>();
+	return Data::TranslationCacheKey(
+		item->fullId(),
+		edited ? edited->date : TimeId(),
+		to.twoLetterCode());
+}
+
+[[nodiscard]] QByteArray SerializeTranslation(
+		not_null<Main::Session*> session,
+		const TextWithEntities &text) {
+	auto buffer = mtpBuffer();
+	MTP_textWithEntities(
+		MTP_string(text.text),
+		Api::EntitiesToMTP(
+			session,
+			text.entities,
+			Api::ConvertOption::SkipLocal)).write(buffer);
+	return QByteArray(
+		reinterpret_cast<const char*>(buffer.constData()),
+		buffer.size() * sizeof(mtpPrime));
+}
+
+[[nodiscard]] TextWithEntities DeserializeTranslation(
+		not_null<Main::Session*> session,
+		const QByteArray &bytes) {
+	if (bytes.isEmpty() || (bytes.size() % sizeof(mtpPrime))) {
+		return {};
+	}
+	auto from = reinterpret_cast<const mtpPrime*>(bytes.constData());
+	const auto till = from + (bytes.size() / sizeof(mtpPrime));
+	auto result = MTPTextWithEntities();
+	if (!result.read(from, till) || (from != till)) {
+		return {};
+	}
+	const auto &data = result.data();
+	return {
+		qs(data.vtext()),
+		Api::EntitiesFromMTP(session, data.ventities().v),
+	};
+}
+
 } // namespace
 
 TranslateTracker::TranslateTracker(not_null<History*> history)
@@ -149,10 +194,47 @@ void TranslateTracker::switchTranslation(
 		not_null<HistoryItem*> item,
 		LanguageId id) {
 	if (item->translationShowRequiresRequest(id)) {
-		_itemsToRequest.emplace(
-			item->fullId(),
-			ItemToRequest{ int(item->originalText().text.size()) });
+		checkCached(item, id);
+	}
+}
+
+void TranslateTracker::checkCached(
+		not_null<HistoryItem*> item,
+		LanguageId to) {
+	const auto id = item->fullId();
+	_itemsCheckingCache[id] = to;
+	const auto weak = base::make_weak(this);
+	auto &cache = _history->owner().cache();
+	cache.get(CacheKey(item, to), [=](QByteArray &&value) {
+		crl::on_main(weak, [=, value = std::move(value)] {
+			cachedChecked(id, to, value);
+		});
+	});
+}
+
+void TranslateTracker::cachedChecked(
+		FullMsgId id,
+		LanguageId to,
+		const QByteArray &value) {
+	const auto i = _itemsCheckingCache.find(id);
+	if (i == end(_itemsCheckingCache) || i->second != to) {
+		return;
 	}
+	_itemsCheckingCache.erase(i);
+	const auto session = &_history->session();
+	const auto item = session->data().message(id);
+	if (!item) {
+		return;
+	}
+	auto text = DeserializeTranslation(session, value);
+	if (!text.empty()) {
+		item->translationDone(to, std::move(text));
+		return;
+	}
+	_itemsToRequest.emplace(
+		id,
+		ItemToRequest{ int(item->originalText().text.size()) });
+	requestSome();
 }
 
 void TranslateTracker::finishBunch() {
@@ -213,12 +295,15 @@ void TranslateTracker::addBunchFrom(
 }
 
 void TranslateTracker::cancelToRequest() {
-	if (!_itemsToRequest.empty()) {
-		const auto owner = &_history->owner();
-		for (const auto &[id, entry] : base::take(_itemsToRequest)) {
-			if (const auto item = owner->message(id)) {
-				item->translationShowRequiresRequest({});
-			}
+	const auto owner = &_history->owner();
+	for (const auto &[id, to] : base::take(_itemsCheckingCache)) {
+		if (const auto item = owner->message(id)) {
+			item->translationShowRequiresRequest({});
+		}
+	}
+	for (const auto &[id, entry] : base::take(_itemsToRequest)) {
+		if (const auto item = owner->message(id)) {
+			item->translationShowRequiresRequest({});
 		}
 	}
 }
@@ -296,6 +381,13 @@ void TranslateTracker::requestDone(
 				qs(data->vtext()),
 				Api::EntitiesFromMTP(session, data->ventities().v)
 			} : TextWithEntities();
+			if (!text.empty()) {
+				owner->cache().put(
+					CacheKey(item, to),
+					Storage::Cache::Database::TaggedValue(
+						SerializeTranslation(session, text),
+						Data::kMessagesCacheTag));
+			}
 			item->translationDone(to, std::move(text));
 		}
 		++index;
@@ -327,6 +419,11 @@ void TranslateTracker::applyLimit() {
 					}
 					_itemsToRequest.erase(j);
 				}
+				if (_itemsCheckingCache.remove(i->first)) {
+					if (const auto item = owner->message(i->first)) {
+						item->translationShowRequiresRequest({});
+					}
+				}
 				i = _itemsForRecognize.erase(i);
 			} else {
 				++i;
@@ -8,6 +8,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #pragma once
 
 #include "spellcheck/spellcheck_types.h"
+#include "base/weak_ptr.h"
 
 class History;
 class HistoryItem;
@@ -16,7 +17,7 @@ namespace HistoryView {
 
 class Element;
 
-class TranslateTracker final {
+class TranslateTracker final : public base::has_weak_ptr {
 public:
 	explicit TranslateTracker(not_null<History*> history);
 	~TranslateTracker();
@@ -53,6 +54,8 @@ private:
 	void cancelToRequest();
 	void cancelSentRequest();
 	void switchTranslation(not_null<HistoryItem*> item, LanguageId id);
+	void checkCached(not_null<HistoryItem*> item, LanguageId to);
+	void cachedChecked(FullMsgId id, LanguageId to, const QByteArray &value);
 
 	void requestDone(
 		LanguageId to,
@@ -68,6 +71,7 @@ private:
 	bool _allLoaded = false;
 
 	base::flat_map<not_null<HistoryItem*>, LanguageId> _switchTranslations;
+	base::flat_map<FullMsgId, LanguageId> _itemsCheckingCache;
 	base::flat_map<FullMsgId, ItemToRequest> _itemsToRequest;
 	std::vector<FullMsgId> _requested;
 	mtpRequestId _requestId = 0;
@@ -977,11 +977,7 @@ void Gif::validateSpoilerImageCache(
 	const auto embedded = _dataMedia->thumbnailInline();
 	const auto blurred = embedded ? embedded : downscale(normal);
 	_spoiler->background = Images::Round(
-		PrepareWithBlurredBackground(
-			outer,
-			::Media::Streaming::ExpandDecision(),
-			nullptr,
-			blurred),
+		PrepareSpoilerBackground(_spoiler.get(), outer, blurred),
 		MediaRoundingMask(rounding));
 	_spoiler->backgroundRounding = rounding;
 }
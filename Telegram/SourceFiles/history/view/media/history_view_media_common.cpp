@@ -26,6 +26,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_user.h"
 #include "history/view/history_view_element.h"
 #include "history/view/media/history_view_media_grouped.h"
+#include "history/view/media/history_view_media_spoiler.h"
 #include "history/view/media/history_view_photo.h"
 #include "history/view/media/history_view_gif.h"
 #include "history/view/media/history_view_document.h"
@@ -179,6 +180,49 @@ QImage PrepareWithBlurredBackground(
 	return background;
 }
 
+QImage PrepareSpoilerBackground(
+		not_null<MediaSpoiler*> spoiler,
+		QSize outer,
+		Image *blurred) {
+	const auto ratio = style::DevicePixelRatio();
+	auto background = QImage(
+		outer * ratio,
+		QImage::Format_ARGB32_Premultiplied);
+	background.setDevicePixelRatio(ratio);
+	if (!blurred || outer.isEmpty()) {
+		background.fill(Qt::black);
+		return background;
+	}
+	const auto &original = blurred->original();
+	if (spoiler->blurred.isNull()
+		|| spoiler->blurredSourceSize != original.size()) {
+		spoiler->blurred = ::Media::Streaming::PrepareBlurredBackground(
+			original.size(),
+			original);
+		spoiler->blurredSourceSize = original.size();
+	}
+
+	// Crop the same way PrepareBlurredBackground() does for the outer.
+	const auto size = spoiler->blurred.size();
+	const auto copyw = std::min(
+		size.width(),
+		std::max(outer.width() * size.height() / outer.height(), 1));
+	const auto copyh = std::min(
+		size.height(),
+		std::max(outer.height() * size.width() / outer.width(), 1));
+	const auto rect = QRect(QPoint(), outer);
+	auto p = QPainter(&background);
+	auto hq = PainterHighQualityEnabler(p);
+	p.drawImage(rect, spoiler->blurred, QRect(
+		(size.width() - copyw) / 2,
+		(size.height() - copyh) / 2,
+		copyw,
+		copyh));
+	p.fillRect(rect, QColor(0, 0, 0, 48));
+	p.end();
+	return background;
+}
+
 QSize CountDesiredMediaSize(QSize original) {
 	return DownscaledSize(
 		style::ConvertScale(original),
@@ -13,6 +13,7 @@ class Image;
 
 namespace HistoryView {
 class Element;
+struct MediaSpoiler;
 } // namespace HistoryView
 
 namespace Data {
@@ -68,6 +69,13 @@ void PaintInterpolatedIcon(
 	QImage large,
 	QImage blurred);
 
+// The blurred source is kept in the spoiler and survives the heavy part
+// unload, so resizing or showing the view again only scales it.
+[[nodiscard]] QImage PrepareSpoilerBackground(
+	not_null<MediaSpoiler*> spoiler,
+	QSize outer,
+	Image *blurred);
+
 [[nodiscard]] QSize CountDesiredMediaSize(QSize original);
 [[nodiscard]] QSize CountMediaSize(QSize desired, int newWidth);
 [[nodiscard]] QSize CountPhotoMediaSize(
@@ -22,6 +22,8 @@ struct MediaSpoiler {
 	QImage cornerCache;
 	QImage background;
 	std::optional<Ui::BubbleRounding> backgroundRounding;
+	QImage blurred;
+	QSize blurredSourceSize;
 	Ui::Animations::Simple revealAnimation;
 	bool revealed = false;
 };
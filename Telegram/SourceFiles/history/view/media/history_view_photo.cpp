@@ -508,8 +508,16 @@ void Photo::validateSpoilerImageCache(
 		&& _spoiler->backgroundRounding == rounding) {
 		return;
 	}
+	using Size = PhotoSize;
+	const auto embedded = _dataMedia->thumbnailInline();
+	const auto thumbnail = embedded
+		? embedded
+		: _dataMedia->image(Size::Thumbnail);
+	const auto blurred = thumbnail
+		? thumbnail
+		: _dataMedia->image(Size::Small);
 	_spoiler->background = Images::Round(
-		prepareImageCacheWithLarge(outer, nullptr),
+		PrepareSpoilerBackground(_spoiler.get(), outer, blurred),
 		MediaRoundingMask(rounding));
 	_spoiler->backgroundRounding = rounding;
 }
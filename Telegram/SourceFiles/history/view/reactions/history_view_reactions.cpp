@@ -118,6 +118,18 @@ void InlineList::unloadCustomEmoji() {
 	_customCache = QImage();
 }
 
+bool InlineList::hasAnimations() const {
+	return ranges::any_of(_buttons, [](const Button &button) {
+		return (button.animation != nullptr);
+	});
+}
+
+void InlineList::stopAnimations() {
+	for (const auto &button : _buttons) {
+		button.animation = nullptr;
+	}
+}
+
 void InlineList::layout() {
 	layoutButtons();
 	initDimensions();
@@ -74,6 +74,8 @@ public:
 	[[nodiscard]] std::vector<ReactionId> computeTagsList() const;
 	[[nodiscard]] bool hasCustomEmoji() const;
 	void unloadCustomEmoji();
+	[[nodiscard]] bool hasAnimations() const;
+	void stopAnimations();
 
 	void paint(
 		Painter &p,
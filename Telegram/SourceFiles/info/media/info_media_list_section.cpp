@@ -7,6 +7,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #include "info/media/info_media_list_section.h"
 
+#include "core/core_paint_profiler.h"
 #include "storage/storage_shared_media.h"
 #include "layout/layout_selection.h"
 #include "ui/painter.h"
@@ -235,6 +236,7 @@ void ListSection::paint(
 	auto localContext = context.layoutContext;
 	if (!_mosaic.empty()) {
 		auto paintItem = [&](not_null<BaseLayout*> item, QPoint point) {
+			Core::PaintProfiler::CountElement();
 			p.translate(point.x(), point.y());
 			item->paint(
 				p,
@@ -256,6 +258,7 @@ void ListSection::paint(
 		auto rect = findItemRect(item);
 		localContext.skipBorder = (rect.y() <= header + _itemsTop);
 		if (rect.intersects(clip)) {
+			Core::PaintProfiler::CountElement();
 			p.translate(rect.topLeft());
 			item->paint(
 				p,
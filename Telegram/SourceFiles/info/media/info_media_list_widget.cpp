@@ -13,6 +13,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "info/downloads/info_downloads_provider.h"
 #include "info/stories/info_stories_provider.h"
 #include "info/info_controller.h"
+#include "core/core_paint_profiler.h"
 #include "layout/layout_mosaic.h"
 #include "layout/layout_selection.h"
 #include "data/data_media_types.h"
@@ -72,6 +73,7 @@ namespace Media {
 namespace {
 
 constexpr auto kMediaCountForSearch = 10;
+constexpr auto kFastScrollSettleDelay = crl::time(200);
 
 } // namespace
 
@@ -159,6 +161,11 @@ void ListWidget::start() {
 
 	_controller->setSearchEnabledByContent(false);
 
+	_fastScrollTimer.setCallback([=] {
+		_fastScrolling = false;
+		update();
+	});
+
 	_provider->layoutRemoved(
 	) | rpl::start_with_next([=](not_null<BaseLayout*> layout) {
 		if (_overLayout == layout) {
@@ -634,6 +641,13 @@ auto ListWidget::foundItemInSection(
 void ListWidget::visibleTopBottomUpdated(
 		int visibleTop,
 		int visibleBottom) {
+	// Jumping more than a screen at once, for example by dragging the
+	// scrollbar, loads only the small thumbnails until the scroll settles.
+	const auto jump = std::abs(visibleTop - _visibleTop);
+	if (jump > (visibleBottom - visibleTop)) {
+		_fastScrolling = true;
+		_fastScrollTimer.callOnce(kFastScrollSettleDelay);
+	}
 	_visibleTop = visibleTop;
 	_visibleBottom = visibleBottom;
 
@@ -796,6 +810,8 @@ QMargins ListWidget::padding() const {
 }
 
 void ListWidget::paintEvent(QPaintEvent *e) {
+	const auto profiler = Core::PaintProfiler::Scope(
+		Core::PaintProfiler::Section::Overview);
 	Painter p(this);
 
 	auto outerWidth = width();
@@ -814,6 +830,7 @@ void ListWidget::paintEvent(QPaintEvent *e) {
 		&_dragSelected,
 		_dragSelectAction
 	};
+	context.layoutContext.scrolling = _fastScrolling;
 	for (auto it = fromSectionIt; it != tillSectionIt; ++it) {
 		auto top = it->top();
 		p.translate(0, top);
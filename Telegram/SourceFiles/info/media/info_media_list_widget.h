@@ -7,6 +7,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #pragma once
 
+#include "base/timer.h"
 #include "ui/rp_widget.h"
 #include "ui/widgets/tooltip.h"
 #include "info/media/info_media_widget.h"
@@ -284,6 +285,8 @@ private:
 	int _visibleBottom = 0;
 	ListScrollTopState _scrollTopState;
 	rpl::event_stream<int> _scrollToRequests;
+	base::Timer _fastScrollTimer;
+	bool _fastScrolling = false;
 
 	MouseAction _mouseAction = MouseAction::None;
 	TextSelectType _mouseSelectType = TextSelectType::Letters;
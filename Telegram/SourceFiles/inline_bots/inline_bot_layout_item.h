@@ -32,6 +32,7 @@ public:
 	, lastRow(lastRow) {
 	}
 	bool paused, lastRow;
+	bool scrolling = false; // Show thumbnails instead of starting players.
 	Ui::PathShiftGradient *pathGradient = nullptr;
 
 };
@@ -435,6 +435,19 @@ void Inner::deleteUnusedInlineLayouts() {
 	}
 }
 
+bool Inner::forgetResults(const Results &results) {
+	for (const auto &result : results) {
+		const auto i = _inlineLayouts.find(result.get());
+		if (i != end(_inlineLayouts) && i->second->position() >= 0) {
+			return false;
+		}
+	}
+	for (const auto &result : results) {
+		_inlineLayouts.erase(result.get());
+	}
+	return true;
+}
+
 void Inner::preloadImages() {
 	_mosaic.forEach([](not_null<const ItemBase*> item) {
 		item->preload();
@@ -58,6 +58,7 @@ struct CacheEntry {
 	QString switchPmStartToken;
 	QByteArray switchPmUrl;
 	Results results;
+	crl::time expires = 0;
 };
 
 class Inner
@@ -79,6 +80,10 @@ public:
 
 	void preloadImages();
 
+	// Destroys the layouts of the results before they are deleted.
+	// Returns false and keeps everything if some of them are shown.
+	[[nodiscard]] bool forgetResults(const Results &results);
+
 	void inlineItemLayoutChanged(const ItemBase *layout) override;
 	void inlineItemRepaint(const ItemBase *layout) override;
 	bool inlineItemVisible(const ItemBase *layout) override;
@@ -383,6 +383,8 @@ void Widget::inlineResultsDone(const MTPmessages_BotResults &result) {
 			it = _inlineCache.emplace(
 				_inlineQuery,
 				std::make_unique<CacheEntry>()).first;
+			it->second->expires = crl::now()
+				+ d.vcache_time().v * crl::time(1000);
 		}
 		auto entry = it->second.get();
 		entry->nextOffset = qs(d.vnext_offset().value_or_empty());
@@ -439,7 +441,14 @@ void Widget::queryInlineBot(UserData *bot, PeerData *peer, QString query) {
 			_inlineRequestId = 0;
 			_requesting.fire(false);
 		}
-		if (_inlineCache.find(query) != _inlineCache.cend()) {
+		auto i = _inlineCache.find(query);
+		if (i != _inlineCache.cend()
+			&& i->second->expires <= crl::now()
+			&& _inner->forgetResults(i->second->results)) {
+			_inlineCache.erase(i);
+			i = _inlineCache.end();
+		}
+		if (i != _inlineCache.cend()) {
 			_inlineRequestTimer.cancel();
 			_inlineQuery = _inlineNextQuery = query;
 			showInlineRows(true);
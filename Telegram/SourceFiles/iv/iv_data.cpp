@@ -58,7 +58,8 @@ Data::Data(const MTPDwebPage &webpage, const MTPPage &page)
 	.name = (webpage.vsite_name()
 		? qs(*webpage.vsite_name())
 		: SiteNameFromUrl(qs(webpage.vurl())))
-})) {
+}))
+, _cached(std::make_shared<Cached>()) {
 }
 
 QString Data::id() const {
@@ -69,6 +70,10 @@ bool Data::partial() const {
 	return _source->page.data().is_part();
 }
 
+const MTPPage &Data::page() const {
+	return _source->page;
+}
+
 Data::~Data() = default;
 
 void Data::updateCachedViews(int cachedViews) {
@@ -78,8 +83,28 @@ void Data::updateCachedViews(int cachedViews) {
 }
 
 void Data::prepare(const Options &options, Fn<void(Prepared)> done) const {
-	crl::async([source = *_source, options, done = std::move(done)] {
-		done(Prepare(source, options));
+	// Reopening the same page doesn't need to build it again.
+	const auto cachedViews = _source->updatedCachedViews;
+	if (_cached->ready && _cached->cachedViews == cachedViews) {
+		done(_cached->prepared);
+		return;
+	}
+	crl::async([
+		source = *_source,
+		options,
+		done = std::move(done),
+		cached = _cached
+	] {
+		auto result = Prepare(source, options);
+		const auto views = source.updatedCachedViews;
+		crl::on_main([=] {
+			*cached = Cached{
+				.prepared = result,
+				.cachedViews = views,
+				.ready = true,
+			};
+		});
+		done(std::move(result));
 	});
 }
 
@@ -44,13 +44,21 @@ public:
 
 	[[nodiscard]] QString id() const;
 	[[nodiscard]] bool partial() const;
+	[[nodiscard]] const MTPPage &page() const;
 
 	void updateCachedViews(int cachedViews);
 
 	void prepare(const Options &options, Fn<void(Prepared)> done) const;
 
 private:
+	struct Cached {
+		Prepared prepared;
+		int cachedViews = 0;
+		bool ready = false;
+	};
+
 	const std::unique_ptr<Source> _source;
+	const std::shared_ptr<Cached> _cached;
 
 };
 
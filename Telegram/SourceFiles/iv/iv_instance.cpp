@@ -219,6 +219,7 @@ void Shown::prepare(not_null<Data*> data, const QString &hash) {
 	const auto weak = base::make_weak(this);
 
 	_preparing = true;
+	_session->data().processInstantViewPage(data->page());
 	const auto id = _id = data->id();
 	data->prepare({}, [=](Prepared result) {
 		result.hash = hash;
@@ -751,6 +752,7 @@ void Shown::moveTo(not_null<Data*> data, QString hash) {
 void Shown::update(not_null<Data*> data) {
 	const auto weak = base::make_weak(this);
 
+	_session->data().processInstantViewPage(data->page());
 	const auto id = data->id();
 	data->prepare({}, [=](Prepared result) {
 		crl::on_main(weak, [=, result = std::move(result)]() mutable {
@@ -143,6 +143,11 @@ bool ValueParser::readTag() {
 
 bool ValueParser::parse() {
 	_failed = false;
+	if (std::find(_ch, _end, '{') == _end) {
+		// Most of the values don't have tags, convert those at once.
+		_result = QString::fromUtf8(_begin, _end - _begin);
+		return true;
+	}
 	_result.reserve(_end - _begin);
 	for (; _ch != _end; ++_ch) {
 		if (*_ch == '{') {
@@ -14,6 +14,10 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 namespace {
 
+// Debug logs are flushed not more often than that, a flush per line
+// makes the debug mode noticeably slower on busy threads.
+constexpr auto kDebugFlushTimeout = crl::time(100);
+
 std::atomic<int> ThreadCounter/* = 0*/;
 thread_local bool WritingEntryFlag/* = false*/;
 
@@ -122,11 +126,18 @@ public:
 			return;
 		}
 		file->write(msg.toUtf8());
-		file->flush();
+		if (type == LogDataMain) {
+			file->flush();
+		} else if (const auto now = crl::now()
+			; now - flushed[type] >= kDebugFlushTimeout) {
+			flushed[type] = now;
+			file->flush();
+		}
 	}
 
 private:
 	std::unique_ptr<QFile> files[LogDataCount];
+	crl::time flushed[LogDataCount] = { 0 };
 
 	int32 part = -1;
 
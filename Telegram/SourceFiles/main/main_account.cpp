@@ -55,6 +55,7 @@ Account::~Account() {
 	if (const auto session = maybeSession()) {
 		session->saveSettingsNowIfNeeded();
 		_local->writeSearchSuggestionsIfNeeded();
+		_local->writeInstalledSetsIfNeeded();
 	}
 	destroySession(DestroyReason::Quitting);
 }
@@ -83,6 +84,7 @@ void Account::start(std::unique_ptr<MTP::Config> config) {
 			Core::App().fallbackProductionConfig()));
 	_appConfig->start();
 	watchProxyChanges();
+	watchNetworkChanges();
 	watchSessionChanges();
 }
 
@@ -113,6 +115,20 @@ void Account::watchProxyChanges() {
 	}, _lifetime);
 }
 
+void Account::watchNetworkChanges() {
+	// Sent requests are kept in the sessions and resent when the new
+	// connections are ready, restarting skips the retry timeout.
+	Core::App().networkChanges(
+	) | rpl::start_with_next([=] {
+		if (_mtp) {
+			_mtp->restart();
+		}
+		if (_mtpForKeysDestroy) {
+			_mtpForKeysDestroy->restart();
+		}
+	}, _lifetime);
+}
+
 void Account::watchSessionChanges() {
 	sessionChanges(
 	) | rpl::start_with_next([=](Session *session) {
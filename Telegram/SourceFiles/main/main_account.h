@@ -131,6 +131,7 @@ private:
 		int streamVersion,
 		std::unique_ptr<SessionSettings> settings);
 	void watchProxyChanges();
+	void watchNetworkChanges();
 	void watchSessionChanges();
 	bool checkForUpdates(const MTP::Response &message);
 	bool checkForNewSession(const MTP::Response &message);
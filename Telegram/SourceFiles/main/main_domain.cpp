@@ -19,6 +19,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "mtproto/mtproto_config.h"
 #include "mtproto/mtproto_dc_options.h"
 #include "storage/storage_domain.h"
+#include "storage/download_manager_mtproto.h"
 #include "storage/storage_account.h"
 #include "storage/localstorage.h"
 #include "export/export_settings.h"
@@ -30,7 +31,8 @@ namespace Main {
 
 Domain::Domain(const QString &dataName)
 : _dataName(dataName)
-, _local(std::make_unique<Storage::Domain>(this, dataName)) {
+, _local(std::make_unique<Storage::Domain>(this, dataName))
+, _downloadArbiter(std::make_unique<Storage::DownloadArbiter>(this)) {
 	_active.changes(
 	) | rpl::take(1) | rpl::start_with_next([=] {
 		// In case we had a legacy passcoded app we start settings here.
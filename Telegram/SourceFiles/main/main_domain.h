@@ -12,6 +12,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 namespace Storage {
 class Domain;
+class DownloadArbiter;
 enum class StartResult : uchar;
 } // namespace Storage
 
@@ -48,6 +49,9 @@ public:
 	[[nodiscard]] Storage::Domain &local() const {
 		return *_local;
 	}
+	[[nodiscard]] Storage::DownloadArbiter &downloadArbiter() const {
+		return *_downloadArbiter;
+	}
 
 	[[nodiscard]] auto accounts() const
 		-> const std::vector<AccountWithIndex> &;
@@ -93,6 +97,7 @@ private:
 
 	const QString _dataName;
 	const std::unique_ptr<Storage::Domain> _local;
+	const std::unique_ptr<Storage::DownloadArbiter> _downloadArbiter;
 
 	std::vector<AccountWithIndex> _accounts;
 	rpl::event_stream<> _accountsChanges;
@@ -49,6 +49,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "support/support_helper.h"
 #include "lang/lang_keys.h"
 #include "core/application.h"
+#include "core/core_startup_trace.h"
 #include "ui/text/text_utilities.h"
 #include "ui/layers/generic_box.h"
 #include "styles/style_layers.h"
@@ -179,19 +180,35 @@ Session::Session(
 
 		// Storage::Account uses Main::Account::session() in those methods.
 		// So they can't be called during Main::Session construction.
-		local().readInstalledStickers();
-		local().readInstalledMasks();
-		local().readInstalledCustomEmoji();
-		local().readFeaturedStickers();
-		local().readFeaturedCustomEmoji();
-		local().readRecentStickers();
-		local().readRecentMasks();
-		local().readFavedStickers();
-		local().readSavedGifs();
-		data().stickers().notifyUpdated(Data::StickersType::Stickers);
-		data().stickers().notifyUpdated(Data::StickersType::Masks);
-		data().stickers().notifyUpdated(Data::StickersType::Emoji);
-		data().stickers().notifySavedGifsUpdated();
+		auto &stickers = data().stickers();
+		stickers.setSetsLocalLoader(crl::guard(this, [=] {
+			const auto trace = Core::StartupTrace::Span("Session stickers");
+			local().readInstalledStickers();
+			local().readInstalledCustomEmoji();
+			local().readFeaturedStickers();
+			local().readFeaturedCustomEmoji();
+			local().readRecentStickers();
+			local().readFavedStickers();
+		}));
+		stickers.setMasksLocalLoader(crl::guard(this, [=] {
+			local().readInstalledMasks();
+			local().readRecentMasks();
+		}));
+		stickers.setSavedGifsLocalLoader(crl::guard(this, [=] {
+			local().readSavedGifs();
+		}));
+
+		// Inactive accounts read their sets when switched to or when
+		// something asks for them, so the active one is ready first.
+		domain().activeValue(
+		) | rpl::filter([=](Main::Account *active) {
+			return !active || (active == _account.get());
+		}) | rpl::take(1) | rpl::start_with_next([=] {
+			auto &stickers = data().stickers();
+			stickers.ensureSetsLoaded();
+			stickers.notifyUpdated(Data::StickersType::Stickers);
+			stickers.notifyUpdated(Data::StickersType::Emoji);
+		}, _lifetime);
 	});
 
 #ifndef TDESKTOP_DISABLE_SPELLCHECK
@@ -324,7 +341,10 @@ void Session::saveSettings() {
 }
 
 void Session::saveSettingsDelayed(crl::time delay) {
-	_saveSettingsTimer.callOnce(delay);
+	if (!_saveSettingsTimer.isActive()
+		|| _saveSettingsTimer.remainingTime() > delay) {
+		_saveSettingsTimer.callOnce(delay);
+	}
 }
 
 void Session::saveSettingsNowIfNeeded() {
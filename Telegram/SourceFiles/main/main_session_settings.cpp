@@ -47,7 +47,7 @@ QByteArray SessionSettings::serialize() const {
 		+ _hiddenPinnedMessages.size() * (sizeof(quint64) * 3)
 		+ sizeof(qint32)
 		+ _groupEmojiSectionHidden.size() * sizeof(quint64)
-		+ sizeof(qint32) * 2;
+		+ sizeof(qint32) * 3;
 
 	auto result = QByteArray();
 	result.reserve(size);
@@ -101,7 +101,8 @@ QByteArray SessionSettings::serialize() const {
 		}
 		stream
 			<< qint32(_lastNonPremiumLimitDownload)
-			<< qint32(_lastNonPremiumLimitUpload);
+			<< qint32(_lastNonPremiumLimitUpload)
+			<< qint32(_supportPreloadChats);
 	}
 
 	Ensures(result.size() == size);
@@ -169,6 +170,7 @@ void SessionSettings::addFromSerialized(const QByteArray &serialized) {
 	qint32 legacySkipPremiumStickersSet = 0;
 	qint32 lastNonPremiumLimitDownload = 0;
 	qint32 lastNonPremiumLimitUpload = 0;
+	qint32 supportPreloadChats = _supportPreloadChats;
 
 	stream >> versionTag;
 	if (versionTag == kVersionTag) {
@@ -447,6 +449,9 @@ void SessionSettings::addFromSerialized(const QByteArray &serialized) {
 			>> lastNonPremiumLimitDownload
 			>> lastNonPremiumLimitUpload;
 	}
+	if (!stream.atEnd()) {
+		stream >> supportPreloadChats;
+	}
 	if (stream.status() != QDataStream::Ok) {
 		LOG(("App Error: "
 			"Bad data for SessionSettings::addFromSerialized()"));
@@ -494,6 +499,7 @@ void SessionSettings::addFromSerialized(const QByteArray &serialized) {
 	_mutePeriods = std::move(mutePeriods);
 	_lastNonPremiumLimitDownload = lastNonPremiumLimitDownload;
 	_lastNonPremiumLimitUpload = lastNonPremiumLimitUpload;
+	setSupportPreloadChats(supportPreloadChats);
 
 	if (version < 2) {
 		app.setLastSeenWarningSeen(appLastSeenWarningSeen == 1);
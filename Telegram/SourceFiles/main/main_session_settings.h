@@ -51,6 +51,12 @@ public:
 	void setSupportAllSearchResults(bool all);
 	[[nodiscard]] bool supportAllSearchResults() const;
 	[[nodiscard]] rpl::producer<bool> supportAllSearchResultsValue() const;
+	void setSupportPreloadChats(int count) {
+		_supportPreloadChats = std::clamp(count, 0, kMaxSupportPreloadChats);
+	}
+	[[nodiscard]] int supportPreloadChats() const {
+		return _supportPreloadChats;
+	}
 	void setSupportAllSilent(bool enabled) {
 		_supportAllSilent = enabled;
 	}
@@ -147,6 +153,8 @@ public:
 
 private:
 	static constexpr auto kDefaultSupportChatsLimitSlice = 7 * 24 * 60 * 60;
+	static constexpr auto kDefaultSupportPreloadChats = 1;
+	static constexpr auto kMaxSupportPreloadChats = 3;
 	static constexpr auto kPhotoEditorHintMaxShowsCount = 5;
 
 	struct ThreadId {
@@ -178,6 +186,7 @@ private:
 	bool _supportFixChatsOrder = true;
 	bool _supportTemplatesAutocomplete = true;
 	bool _supportAllSilent = false;
+	int _supportPreloadChats = kDefaultSupportPreloadChats;
 	rpl::variable<int> _supportChatsTimeSlice
 		= kDefaultSupportChatsLimitSlice;
 	rpl::variable<bool> _supportAllSearchResults = false;
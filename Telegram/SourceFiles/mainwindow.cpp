@@ -222,7 +222,7 @@ void MainWindow::clearPasscodeLock() {
 void MainWindow::setupIntro(
 		Intro::EnterPoint point,
 		QPixmap oldContentCache) {
-	auto animated = (_main || _passcodeLock);
+	const auto animated = introShowAnimated();
 
 	destroyLayer();
 	auto created = object_ptr<Intro::Widget>(
@@ -251,13 +251,20 @@ void MainWindow::setupIntro(
 	fixOrder();
 }
 
+bool MainWindow::introShowAnimated() const {
+	return _main || _passcodeLock;
+}
+
+bool MainWindow::mainShowAnimated() const {
+	return _intro || (_passcodeLock && !Core::App().passcodeLocked());
+}
+
 void MainWindow::setupMain(
 		MsgId singlePeerShowAtMsgId,
 		QPixmap oldContentCache) {
 	Expects(account().sessionExists());
 
-	const auto animated = _intro
-		|| (_passcodeLock && !Core::App().passcodeLocked());
+	const auto animated = mainShowAnimated();
 	const auto weakAnimatedLayer = (_main && _layer && !_passcodeLock)
 		? Ui::MakeWeak(_layer.get())
 		: nullptr;
@@ -52,6 +52,10 @@ public:
 	void setupIntro(Intro::EnterPoint point, QPixmap oldContentCache);
 	void setupMain(MsgId singlePeerShowAtMsgId, QPixmap oldContentCache);
 
+	// The old content is grabbed only if the new one slides in.
+	[[nodiscard]] bool introShowAnimated() const;
+	[[nodiscard]] bool mainShowAnimated() const;
+
 	void showSettings();
 
 	void setInnerFocus() override;
@@ -496,8 +496,9 @@ Mixer::Mixer(not_null<Audio::Instance*> instance)
 	connect(this, SIGNAL(stoppedOnError(AudioMsgId)), this, SIGNAL(updated(AudioMsgId)), Qt::QueuedConnection);
 	connect(this, SIGNAL(updated(AudioMsgId)), this, SLOT(onUpdated(AudioMsgId)));
 
-	_loaderThread.start();
-	_faderThread.start();
+	// Playback must not starve behind the UI or other busy threads.
+	_loaderThread.start(QThread::HighPriority);
+	_faderThread.start(QThread::TimeCriticalPriority);
 }
 
 // Thread: Main. Locks: AudioMutex.
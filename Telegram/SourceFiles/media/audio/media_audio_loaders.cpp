@@ -222,8 +222,15 @@ void Loaders::loadData(AudioMsgId audio, crl::time positionMs) {
 			errAtStart = false;
 		}
 
-		QMutexLocker lock(internal::audioPlayerMutex());
-		if (!checkLoader(type)) {
+		// Don't wait here for the main thread holding the lock, the track
+		// is checked once again with the lock before the data is queued.
+		const auto mutex = internal::audioPlayerMutex();
+		if (!mutex->tryLock()) {
+			continue;
+		}
+		const auto alive = (checkLoader(type) != nullptr);
+		mutex->unlock();
+		if (!alive) {
 			clear(type);
 			return;
 		}
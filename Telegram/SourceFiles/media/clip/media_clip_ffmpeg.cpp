@@ -193,6 +193,17 @@ crl::time FFMpegReaderImplementation::framePresentationTime() const {
 	return qMax(_frameTime + _frameTimeCorrection, crl::time(0));
 }
 
+int FFMpegReaderImplementation::frameIndex() const {
+	return _frameIndex;
+}
+
+void FFMpegReaderImplementation::skipFrame() {
+	Expects(_frameRead);
+
+	_frameRead = false;
+	FFmpeg::ClearFrameMemory(_frame.get());
+}
+
 crl::time FFMpegReaderImplementation::durationMs() const {
 	const auto rebase = [](int64_t duration, const AVRational &base) {
 		return (duration * 1000LL * base.num) / base.den;
@@ -39,6 +39,9 @@ public:
 		int &index,
 		const QSize &size) override;
 
+	int frameIndex() const override;
+	void skipFrame() override;
+
 	crl::time durationMs() const override;
 
 	bool start(Mode mode, crl::time &positionMs) override;
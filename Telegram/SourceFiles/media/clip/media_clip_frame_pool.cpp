@@ -0,0 +1,151 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "media/clip/media_clip_frame_pool.h"
+
+namespace Media {
+namespace Clip {
+namespace internal {
+namespace {
+
+constexpr auto kFramePoolBudget = int64(64 * 1024 * 1024);
+
+} // namespace
+
+void FramePool::acquire(const FramesKey &key) {
+	Expects(!key.empty());
+
+	QMutexLocker lock(&_mutex);
+	++_clips[key].users;
+}
+
+void FramePool::release(const FramesKey &key) {
+	Expects(!key.empty());
+
+	QMutexLocker lock(&_mutex);
+	const auto i = _clips.find(key);
+	Assert(i != end(_clips) && i->second.users > 0);
+
+	if (--i->second.users > 1) {
+		return;
+	}
+	// With a single reader left there is nobody to share frames with.
+	for (const auto &entry : i->second.entries) {
+		_bytes -= entry.bytes;
+	}
+	if (!i->second.users) {
+		_clips.erase(i);
+	} else {
+		i->second.entries.clear();
+	}
+}
+
+std::optional<SharedFrame> FramePool::find(
+		const FramesKey &key,
+		const FrameRequest &request,
+		int index) {
+	QMutexLocker lock(&_mutex);
+	const auto i = _clips.find(key);
+	if (i == end(_clips) || i->second.users < 2) {
+		return std::nullopt;
+	}
+	for (auto &entry : i->second.entries) {
+		if (entry.index == index && SameRequest(entry.request, request)) {
+			entry.used = ++_useCounter;
+			return entry.frame;
+		}
+	}
+	return std::nullopt;
+}
+
+void FramePool::store(
+		const FramesKey &key,
+		const FrameRequest &request,
+		int index,
+		const SharedFrame &frame) {
+	const auto bytes = ComputeBytes(frame);
+	if (bytes > kFramePoolBudget / 4) {
+		return;
+	}
+
+	QMutexLocker lock(&_mutex);
+	const auto i = _clips.find(key);
+	if (i == end(_clips) || i->second.users < 2) {
+		return;
+	}
+	auto &entries = i->second.entries;
+	const auto j = ranges::find_if(entries, [&](const Entry &entry) {
+		return (entry.index == index)
+			&& SameRequest(entry.request, request);
+	});
+	if (j != end(entries)) {
+		return;
+	}
+	evictTill(kFramePoolBudget - bytes);
+	entries.push_back({
+		.request = request,
+		.index = index,
+		.frame = frame,
+		.bytes = bytes,
+		.used = ++_useCounter,
+	});
+	_bytes += bytes;
+}
+
+int64 FramePool::bytes() {
+	QMutexLocker lock(&_mutex);
+	return _bytes;
+}
+
+FramePool &FramePool::Instance() {
+	static auto result = FramePool();
+	return result;
+}
+
+bool FramePool::SameRequest(const FrameRequest &a, const FrameRequest &b) {
+	return (a.frame == b.frame)
+		&& (a.outer == b.outer)
+		&& (a.factor == b.factor)
+		&& (a.radius == b.radius)
+		&& (a.corners == b.corners)
+		&& (a.colored == b.colored)
+		&& (a.keepAlpha == b.keepAlpha);
+}
+
+int64 FramePool::ComputeBytes(const SharedFrame &frame) {
+	const auto original = int64(frame.original.sizeInBytes());
+	return (frame.prepared.cacheKey() == frame.original.cacheKey())
+		? original
+		: (original + frame.prepared.sizeInBytes());
+}
+
+void FramePool::evictTill(int64 limit) {
+	while (_bytes > limit) {
+		auto oldest = (Entry*)nullptr;
+		auto oldestClip = (Clip*)nullptr;
+		for (auto &[key, clip] : _clips) {
+			for (auto &entry : clip.entries) {
+				if (!oldest || entry.used < oldest->used) {
+					oldest = &entry;
+					oldestClip = &clip;
+				}
+			}
+		}
+		if (!oldest) {
+			_bytes = 0;
+			return;
+		}
+		_bytes -= oldest->bytes;
+		oldestClip->entries.erase(
+			oldestClip->entries.begin()
+				+ (oldest - oldestClip->entries.data()));
+	}
+}
+
+} // namespace internal
+} // namespace Clip
+} // namespace Media
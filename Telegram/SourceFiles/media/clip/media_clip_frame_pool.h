@@ -0,0 +1,93 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include "media/clip/media_clip_reader.h"
+
+namespace Media {
+namespace Clip {
+namespace internal {
+
+// Identifies the same clip played by several readers, the in-memory data
+// is compared by pointer, because readers of the same document share it.
+struct FramesKey {
+	QString path;
+	const char *data = nullptr;
+	int64 size = 0;
+
+	[[nodiscard]] bool empty() const {
+		return path.isEmpty() && !data;
+	}
+
+	friend inline bool operator<(const FramesKey &a, const FramesKey &b) {
+		return std::tie(a.data, a.size, a.path)
+			< std::tie(b.data, b.size, b.path);
+	}
+	friend inline bool operator==(const FramesKey &a, const FramesKey &b) {
+		return (a.data == b.data) && (a.size == b.size) && (a.path == b.path);
+	}
+};
+
+struct SharedFrame {
+	QImage original;
+	QImage prepared;
+	bool alpha = false;
+};
+
+// Decoded frames of clips that are shown by several readers at once.
+// Frames are stored only while the clip has more than one reader and the
+// total size of all stored frames is limited. Thread safe.
+class FramePool final {
+public:
+	// Each ReaderPrivate of the clip holds the usage while it lives.
+	void acquire(const FramesKey &key);
+	void release(const FramesKey &key);
+
+	[[nodiscard]] std::optional<SharedFrame> find(
+		const FramesKey &key,
+		const FrameRequest &request,
+		int index);
+	void store(
+		const FramesKey &key,
+		const FrameRequest &request,
+		int index,
+		const SharedFrame &frame);
+
+	[[nodiscard]] int64 bytes();
+
+	[[nodiscard]] static FramePool &Instance();
+
+private:
+	struct Entry {
+		FrameRequest request;
+		int index = 0;
+		SharedFrame frame;
+		int64 bytes = 0;
+		uint64 used = 0;
+	};
+	struct Clip {
+		std::vector<Entry> entries;
+		int users = 0;
+	};
+
+	[[nodiscard]] static bool SameRequest(
+		const FrameRequest &a,
+		const FrameRequest &b);
+	[[nodiscard]] static int64 ComputeBytes(const SharedFrame &frame);
+	void evictTill(int64 limit);
+
+	QMutex _mutex;
+	base::flat_map<FramesKey, Clip> _clips;
+	int64 _bytes = 0;
+	uint64 _useCounter = 0;
+
+};
+
+} // namespace internal
+} // namespace Clip
+} // namespace Media
@@ -48,6 +48,10 @@ public:
 		int &index,
 		const QSize &size) = 0;
 
+	// Get current frame index in the loop or drop it without rendering.
+	virtual int frameIndex() const = 0;
+	virtual void skipFrame() = 0;
+
 	virtual crl::time durationMs() const = 0;
 
 	virtual bool start(Mode mode, crl::time &positionMs) = 0;
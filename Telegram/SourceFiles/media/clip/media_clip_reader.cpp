@@ -9,6 +9,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include "media/clip/media_clip_ffmpeg.h"
 #include "media/clip/media_clip_check_streaming.h"
+#include "media/clip/media_clip_frame_pool.h"
 #include "ui/chat/attach/attach_prepare.h"
 #include "ui/painter.h"
 #include "core/file_location.h"
@@ -37,6 +38,8 @@ constexpr auto kClipThreadsCount = 8;
 constexpr auto kAverageGifSize = 320 * 240;
 constexpr auto kWaitBeforeGifPause = crl::time(200);
 
+auto AliveReaders = 0;
+
 QImage PrepareFrame(
 		const FrameRequest &request,
 		const QImage &original,
@@ -203,6 +206,7 @@ Reader::Reader(const QByteArray &data, Callback &&callback)
 }
 
 void Reader::init(const Core::FileLocation &location, const QByteArray &data) {
+	++AliveReaders;
 	if (Workers.size() < kClipThreadsCount) {
 		_threadIndex = Workers.size();
 		Workers.push_back(std::make_unique<Worker>());
@@ -461,13 +465,22 @@ void Reader::finished() {
 
 Reader::~Reader() {
 	stop();
+	--AliveReaders;
+}
+
+int Reader::AliveCount() {
+	return AliveReaders;
 }
 
 class ReaderPrivate {
 public:
 	ReaderPrivate(Reader *reader, const Core::FileLocation &location, const QByteArray &data)
 	: _interface(reader)
-	, _data(data) {
+	, _data(data)
+	, _framesKey(ComputeFramesKey(location, _data)) {
+		if (!_framesKey.empty()) {
+			internal::FramePool::Instance().acquire(_framesKey);
+		}
 		if (_data.isEmpty()) {
 			_location = std::make_unique<Core::FileLocation>(location);
 			if (!_location->accessEnable()) {
@@ -570,16 +583,38 @@ public:
 	bool renderFrame() {
 		Expects(_request.valid());
 
-		if (!_implementation->renderFrame(frame()->original, frame()->alpha, frame()->index, _request.frame)) {
-			return false;
+		// Frame indices match between readers only if they start at zero.
+		auto &pool = internal::FramePool::Instance();
+		const auto shareable = !_framesKey.empty() && !_seekPositionMs;
+		const auto index = _implementation->frameIndex();
+		const auto shared = shareable
+			? pool.find(_framesKey, _request, index)
+			: std::nullopt;
+		if (shared) {
+			_implementation->skipFrame();
+			frame()->original = shared->original;
+			frame()->prepared = shared->prepared;
+			frame()->alpha = shared->alpha;
+			frame()->index = index;
+		} else {
+			if (!_implementation->renderFrame(frame()->original, frame()->alpha, frame()->index, _request.frame)) {
+				return false;
+			}
+			frame()->original.setDevicePixelRatio(_request.factor);
+			frame()->prepared = QImage();
+			frame()->prepared = PrepareFrame(
+				_request,
+				frame()->original,
+				frame()->alpha,
+				frame()->cache);
+			if (shareable) {
+				pool.store(_framesKey, _request, frame()->index, {
+					.original = frame()->original,
+					.prepared = frame()->prepared,
+					.alpha = frame()->alpha,
+				});
+			}
 		}
-		frame()->original.setDevicePixelRatio(_request.factor);
-		frame()->prepared = QImage();
-		frame()->prepared = PrepareFrame(
-			_request,
-			frame()->original,
-			frame()->alpha,
-			frame()->cache);
 		frame()->preparedColored = _request.colored;
 		frame()->when = _nextFrameWhen;
 		frame()->positionMs = _nextFramePositionMs;
@@ -642,14 +677,29 @@ public:
 	~ReaderPrivate() {
 		stop();
 		_data.clear();
+		if (!_framesKey.empty()) {
+			internal::FramePool::Instance().release(_framesKey);
+		}
 	}
 
 private:
+	[[nodiscard]] static internal::FramesKey ComputeFramesKey(
+			const Core::FileLocation &location,
+			const QByteArray &data) {
+		if (!data.isEmpty()) {
+			return { .data = data.constData(), .size = data.size() };
+		} else if (!location.name().isEmpty()) {
+			return { .path = location.name(), .size = location.size };
+		}
+		return {};
+	}
+
 	Reader *_interface;
 	State _state = State::Reading;
 	crl::time _seekPositionMs = 0;
 
 	QByteArray _data;
+	const internal::FramesKey _framesKey;
 	std::unique_ptr<Core::FileLocation> _location;
 	bool _accessed = false;
 
@@ -72,6 +72,9 @@ public:
 	Reader(const QString &filepath, Callback &&callback);
 	Reader(const QByteArray &data, Callback &&callback);
 
+	// Readers that are alive right now, for memory statistics.
+	[[nodiscard]] static int AliveCount();
+
 	// Reader can be already deleted.
 	static void SafeCallback(
 		Reader *reader,
@@ -12,6 +12,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_changes.h"
 #include "data/data_streaming.h"
 #include "data/data_file_click_handler.h"
+#include "data/data_media_preload.h"
 #include "base/options.h"
 #include "base/random.h"
 #include "base/power_save_blocker.h"
@@ -255,6 +256,7 @@ void Instance::setSession(not_null<Data*> data, Main::Session *session) {
 	if (data->session == session) {
 		return;
 	}
+	clearPreloadNext(data);
 	data->playlistLifetime.destroy();
 	data->playlistOtherLifetime.destroy();
 	data->sessionLifetime.destroy();
@@ -333,6 +335,7 @@ void Instance::playlistUpdated(not_null<Data*> data) {
 		data->playlistIndex = std::nullopt;
 		data->shuffleData = nullptr;
 	}
+	preloadNext(data);
 	data->playlistChanges.fire({});
 }
 
@@ -597,6 +600,43 @@ bool Instance::moveInPlaylist(
 	return false;
 }
 
+void Instance::preloadNext(not_null<Data*> data) {
+	if (!data->session) {
+		return;
+	}
+	using Entry = ::Data::VideoPreloadScheduler::Entry;
+
+	// The beginning of the next track is loaded to the cache while the
+	// current one plays, so the switch to it doesn't wait for the network.
+	// In the shuffle mode the next track is chosen only when it's needed.
+	auto entries = std::vector<Entry>();
+	const auto item = (!data->playlistIndex
+		|| OptionDisableAutoplayNext.value()
+		|| order(data) == OrderMode::Shuffle
+		|| repeat(data) == RepeatMode::One)
+		? nullptr
+		: itemByIndex(
+			data,
+			*data->playlistIndex
+				+ (order(data) == OrderMode::Reverse ? -1 : 1));
+	const auto media = item ? item->media() : nullptr;
+	const auto document = media ? media->document() : nullptr;
+	if (document
+		&& !media->ttlSeconds()
+		&& (document->isAudioFile()
+			|| document->isVoiceMessage()
+			|| document->isVideoMessage())) {
+		entries.push_back({ .video = document, .context = item->fullId() });
+	}
+	data->session->data().videoPreloads().setWindow(data, std::move(entries));
+}
+
+void Instance::clearPreloadNext(not_null<Data*> data) {
+	if (data->session) {
+		data->session->data().videoPreloads().clearWindow(data);
+	}
+}
+
 void Instance::updatePowerSaveBlocker(
 		not_null<Data*> data,
 		const TrackState &state) {
@@ -881,6 +921,7 @@ void Instance::stop(AudioMsgId::Type type) {
 
 void Instance::stopAndClear(not_null<Data*> data) {
 	stop(data->type);
+	clearPreloadNext(data);
 	*data = Data(data->type, data->overview);
 	_tracksFinished.fire_copy(data->type);
 }
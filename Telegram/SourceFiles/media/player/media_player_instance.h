@@ -238,6 +238,8 @@ private:
 	void validateOtherPlaylist(not_null<Data*> data);
 	void playlistUpdated(not_null<Data*> data);
 	bool moveInPlaylist(not_null<Data*> data, int delta, bool autonext);
+	void preloadNext(not_null<Data*> data);
+	void clearPreloadNext(not_null<Data*> data);
 	void updatePowerSaveBlocker(
 		not_null<Data*> data,
 		const TrackState &state);
@@ -15,6 +15,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_photo.h"
 #include "data/data_photo_media.h"
 #include "data/data_session.h"
+#include "data/data_streaming.h"
 #include "lang/lang_keys.h"
 #include "main/main_session.h"
 #include "media/stories/media_stories_controller.h"
@@ -53,6 +54,9 @@ public:
 
 	virtual QImage blurred() = 0;
 	virtual QImage good() = 0;
+	[[nodiscard]] virtual std::shared_ptr<Streaming::Document> warm() const {
+		return nullptr;
+	}
 };
 
 class Sibling::LoaderPhoto final : public Sibling::Loader {
@@ -84,6 +88,7 @@ public:
 
 	QImage blurred() override;
 	QImage good() override;
+	std::shared_ptr<Streaming::Document> warm() const override;
 
 private:
 	void waitForGoodThumbnail();
@@ -177,6 +182,10 @@ QImage Sibling::LoaderVideo::good() {
 	return QImage();
 }
 
+std::shared_ptr<Streaming::Document> Sibling::LoaderVideo::warm() const {
+	return _streamed ? _streamed->shared() : nullptr;
+}
+
 void Sibling::LoaderVideo::createStreamedPlayer() {
 	_streamed = std::make_unique<Streaming::Instance>(
 		_video,
@@ -250,7 +259,17 @@ Sibling::Sibling(
 	_goodShown.stop();
 }
 
-Sibling::~Sibling() = default;
+Sibling::~Sibling() {
+	if (_warm) {
+		// Let the switched to story pick up the player.
+		const auto maybeStory = _peer->owner().stories().lookup(_id);
+		if (maybeStory) {
+			if (const auto video = (*maybeStory)->document()) {
+				video->owner().streaming().keepAlive(video);
+			}
+		}
+	}
+}
 
 void Sibling::checkStory() {
 	const auto maybeStory = _peer->owner().stories().lookup(_id);
@@ -419,6 +438,7 @@ void Sibling::check() {
 	if (good.isNull()) {
 		return;
 	}
+	_warm = _loader->warm();
 	_loader = nullptr;
 	_good = std::move(good);
 	_goodShown.start([=] {
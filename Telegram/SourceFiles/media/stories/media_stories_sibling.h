@@ -16,6 +16,10 @@ namespace style {
 struct TextStyle;
 } // namespace style
 
+namespace Media::Streaming {
+class Document;
+} // namespace Media::Streaming
+
 namespace Media::Stories {
 
 class Controller;
@@ -76,6 +80,10 @@ private:
 
 	std::unique_ptr<Loader> _loader;
 
+	// The paused player with the first frame of the video, so that the
+	// story opens without reloading when the user switches to it.
+	std::shared_ptr<Streaming::Document> _warm;
+
 };
 
 } // namespace Media::Stories
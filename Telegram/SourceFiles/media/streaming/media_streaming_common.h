@@ -56,6 +56,15 @@ struct TrackState {
 	crl::time duration = kTimeUnknown;
 };
 
+struct PlaybackStatistics {
+	int decodedFrames = 0;
+	int droppedFrames = 0;
+	int lateFrames = 0;
+	int underruns = 0;
+	crl::profile_time decodeTime = 0; // Microseconds, total and max.
+	crl::profile_time decodeTimeMax = 0;
+};
+
 struct VideoInformation {
 	TrackState state;
 	QSize size;
@@ -18,6 +18,10 @@ namespace {
 constexpr auto kMaxSingleReadAmount = 8 * 1024 * 1024;
 constexpr auto kMaxQueuedPackets = 1024;
 
+// Mapped hardware frames stay with the video track frames queue,
+// together with the first and the skipped frames after a seek.
+constexpr auto kHwFramesHeld = 6;
+
 [[nodiscard]] bool UnreliableFormatDuration(
 		not_null<AVFormatContext*> format,
 		not_null<AVStream*> stream,
@@ -32,6 +36,22 @@ constexpr auto kMaxQueuedPackets = 1024;
 		).split(QChar(',')).contains(u"webm");
 }
 
+[[nodiscard]] std::vector<int64> KeyframeOffsets(
+		not_null<AVStream*> stream) {
+	auto result = std::vector<int64>();
+#if LIBAVFORMAT_VERSION_INT >= AV_VERSION_INT(58, 78, 100)
+	const auto count = avformat_index_get_entries_count(stream);
+	result.reserve(std::max(count, 0));
+	for (auto i = 0; i < count; ++i) {
+		const auto entry = avformat_index_get_entry(stream, i);
+		if (entry && (entry->flags & AVINDEX_KEYFRAME) && entry->pos > 0) {
+			result.push_back(entry->pos);
+		}
+	}
+#endif // LIBAVFORMAT_VERSION_INT >= 58.78.100
+	return result;
+}
+
 } // namespace
 
 File::Context::Context(
@@ -171,6 +191,7 @@ Stream File::Context::initStream(
 		}
 		result.codec = FFmpeg::MakeCodecPointer({
 			.stream = info,
+			.extraHwFrames = kHwFramesHeld,
 			.hwAllowed = options.hwAllow,
 		});
 		if (!result.codec) {
@@ -314,6 +335,10 @@ void File::Context::start(StartOptions options) {
 	_reader->headerDone();
 	if (_reader->isRemoteLoader()) {
 		sendFullInCache(true);
+		if (video.codec) {
+			_reader->setKeyframeOffsets(
+				KeyframeOffsets(format->streams[video.index]));
+		}
 	}
 	if (options.seekable && (video.codec || audio.codec)) {
 		seekToPosition(
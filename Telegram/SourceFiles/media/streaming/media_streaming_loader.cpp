@@ -16,6 +16,10 @@ bool LoadedPart::valid(int64 size) const {
 			|| (offset + bytes.size() == size));
 }
 
+bytes::const_span Loader::mapped() const {
+	return {};
+}
+
 bool operator<(
 		const PriorityQueue::Entry &a,
 		const PriorityQueue::Entry &b) {
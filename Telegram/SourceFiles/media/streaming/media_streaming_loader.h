@@ -46,6 +46,10 @@ public:
 		not_null<Storage::StreamedFileDownloader*> downloader) = 0;
 	virtual void clearAttachedDownloader() = 0;
 
+	// Any thread. Whole file contents if they are directly readable,
+	// the span should stay valid for the lifetime of the loader.
+	[[nodiscard]] virtual bytes::const_span mapped() const;
+
 	virtual ~Loader() = default;
 
 };
@@ -31,6 +31,23 @@ LoaderLocal::LoaderLocal(std::unique_ptr<QIODevice> device)
 
 	if (!_size || !_device->open(QIODevice::ReadOnly)) {
 		fail();
+	} else {
+		map();
+	}
+}
+
+void LoaderLocal::map() {
+	if (const auto buffer = dynamic_cast<QBuffer*>(_device.get())) {
+		const auto &data = std::as_const(*buffer).buffer();
+		if (data.size() == _size) {
+			_mapped = bytes::make_span(data);
+		}
+	} else if (const auto file = dynamic_cast<QFile*>(_device.get())) {
+		if (const auto data = file->map(0, _size)) {
+			_mapped = bytes::const_span(
+				reinterpret_cast<const bytes::type*>(data),
+				_size);
+		}
 	}
 }
 
@@ -93,6 +110,10 @@ void LoaderLocal::clearAttachedDownloader() {
 	Unexpected("Downloader detached from a local streaming loader.");
 }
 
+bytes::const_span LoaderLocal::mapped() const {
+	return _mapped;
+}
+
 std::unique_ptr<LoaderLocal> MakeFileLoader(const QString &path) {
 	return std::make_unique<LoaderLocal>(std::make_unique<QFile>(path));
 }
@@ -38,11 +38,15 @@ public:
 		not_null<Storage::StreamedFileDownloader*> downloader) override;
 	void clearAttachedDownloader() override;
 
+	[[nodiscard]] bytes::const_span mapped() const override;
+
 private:
 	void fail();
+	void map();
 
 	const std::unique_ptr<QIODevice> _device;
 	const int64 _size = 0;
+	bytes::const_span _mapped;
 	rpl::event_stream<LoadedPart> _parts;
 
 };
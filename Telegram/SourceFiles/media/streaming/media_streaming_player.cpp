@@ -14,6 +14,10 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "media/audio/media_audio.h" // for SupportsSpeedControl()
 #include "media/media_common.h"
 #include "data/data_document.h" // for DocumentData::duration()
+#include "base/options.h"
+
+#include <QtGui/QGuiApplication>
+#include <QtGui/QScreen>
 
 namespace Media {
 namespace Streaming {
@@ -23,11 +27,35 @@ constexpr auto kBufferFor = 3 * crl::time(1000);
 constexpr auto kLoadInAdvanceForRemote = 32 * crl::time(1000);
 constexpr auto kLoadInAdvanceForLocal = 5 * crl::time(1000);
 constexpr auto kMsFrequency = 1000; // 1000 ms per second.
+constexpr auto kDefaultRefreshRate = 60.;
+constexpr auto kMinRefreshRate = 24.;
 
 // If we played for 3 seconds and got stuck it looks like we're loading
 // slower than we're playing, so load full file in that case.
 //constexpr auto kLoadFullIfStuckAfterPlayback = 3 * crl::time(1000);
 
+base::options::toggle OptionVideoFramePacing({
+	.id = kOptionVideoFramePacing,
+	.name = "Align video frames to the display refresh",
+	.description = "Show each video frame on the display refresh "
+		"closest to its time instead of the first one after it.",
+});
+
+base::options::toggle OptionVideoPlaybackStatistics({
+	.id = kOptionVideoPlaybackStatistics,
+	.name = "Show video playback statistics",
+	.description = "Show decoded, late and dropped frames in the media "
+		"viewer and write them to the log when the playback stops.",
+});
+
+// Player doesn't know the screen it is painted on, use the primary one.
+[[nodiscard]] crl::time ComputeRefreshInterval() {
+	const auto screen = QGuiApplication::primaryScreen();
+	const auto rate = screen ? screen->refreshRate() : 0.;
+	return crl::time(base::SafeRound(kMsFrequency
+		/ ((rate >= kMinRefreshRate) ? rate : kDefaultRefreshRate)));
+}
+
 [[nodiscard]] bool FullTrackReceived(const TrackState &state) {
 	return (state.duration != kTimeUnknown)
 		&& (state.receivedTill == state.duration);
@@ -81,6 +109,9 @@ void SaveValidStartInformation(Information &to, Information &&from) {
 
 } // namespace
 
+const char kOptionVideoFramePacing[] = "video-frame-pacing";
+const char kOptionVideoPlaybackStatistics[] = "video-playback-statistics";
+
 Player::Player(std::shared_ptr<Reader> reader)
 : _file(std::make_unique<File>(std::move(reader)))
 , _remoteLoader(_file->isRemoteLoader())
@@ -94,10 +125,15 @@ not_null<FileDelegate*> Player::delegate() {
 void Player::checkNextFrameRender() {
 	Expects(_nextFrameTime != kTimeUnknown);
 
+	// With frame pacing the frame is rendered for the refresh that is
+	// the closest to its time, it may be up to half a refresh earlier.
 	const auto now = crl::now();
-	if (now < _nextFrameTime) {
+	const auto renderAt = _framePacing
+		? (_nextFrameTime - _refreshInterval / 2)
+		: _nextFrameTime;
+	if (now < renderAt) {
 		if (!_renderFrameTimer.isActive()) {
-			_renderFrameTimer.callOnce(_nextFrameTime - now);
+			_renderFrameTimer.callOnce(renderAt - now);
 		}
 	} else {
 		_renderFrameTimer.cancel();
@@ -120,6 +156,9 @@ void Player::renderFrame(crl::time now) {
 	Expects(_nextFrameTime != kTimeUnknown);
 	Expects(_nextFrameTime != kFrameDisplayTimeAlreadyDone);
 
+	if (now - _nextFrameTime > _refreshInterval) {
+		++_lateFrames;
+	}
 	const auto position = _video->markFrameDisplayed(now);
 	if (_options.waitForMarkAsShown) {
 		_currentFrameTime = _nextFrameTime;
@@ -138,7 +177,11 @@ bool Player::markFrameShown() {
 
 	if (_nextFrameTime == kFrameDisplayTimeAlreadyDone) {
 		_nextFrameTime = kTimeUnknown;
-		_video->addTimelineDelay(crl::now() - _currentFrameTime);
+
+		// Frames rendered ahead of time by the frame pacing are not
+		// allowed to move the timeline back.
+		_video->addTimelineDelay(
+			std::max(crl::now() - _currentFrameTime, crl::time(0)));
 	}
 	return _video->markFrameShown();
 }
@@ -713,6 +756,8 @@ void Player::start() {
 	Expects(_stage == Stage::Ready);
 
 	_stage = Stage::Started;
+	_framePacing = OptionVideoFramePacing.value();
+	_refreshInterval = ComputeRefreshInterval();
 	const auto guard = base::make_weak(&_sessionGuard);
 
 	rpl::merge(
@@ -721,6 +766,7 @@ void Player::start() {
 	) | rpl::filter([=] {
 		return !bothReceivedEnough(kBufferFor);
 	}) | rpl::start_with_next([=] {
+		++_underruns;
 		_pausedByWaitingForData = true;
 		updatePausedState();
 		_updates.fire({ WaitingForData{ true } });
@@ -785,6 +831,7 @@ void Player::checkVideoStep() {
 }
 
 void Player::stop(bool stillActive) {
+	logStatistics();
 	_file->stop(stillActive);
 	_sessionLifetime = rpl::lifetime();
 	_stage = Stage::Uninitialized;
@@ -794,6 +841,7 @@ void Player::stop(bool stillActive) {
 	_pausedByUser = _pausedByWaitingForData = _paused = false;
 	_renderFrameTimer.cancel();
 	_nextFrameTime = kTimeUnknown;
+	_lateFrames = _underruns = 0;
 	_audioFinished = false;
 	_videoFinished = false;
 	_pauseReading = false;
@@ -979,6 +1027,32 @@ crl::time Player::getCurrentReceivedTill(crl::time duration) const {
 		: result;
 }
 
+PlaybackStatistics Player::statistics() const {
+	auto result = _video ? _video->statistics() : PlaybackStatistics();
+	result.lateFrames = _lateFrames;
+	result.underruns = _underruns;
+	return result;
+}
+
+void Player::logStatistics() const {
+	if (!OptionVideoPlaybackStatistics.value() || !_video) {
+		return;
+	}
+	const auto stats = statistics();
+	if (!stats.decodedFrames) {
+		return;
+	}
+	LOG(("Streaming Info: Played %1 frames, %2 late, %3 dropped, "
+		"%4 underruns, decode average %5 mcs, max %6 mcs, refresh %7 ms."
+		).arg(stats.decodedFrames
+		).arg(stats.lateFrames
+		).arg(stats.droppedFrames
+		).arg(stats.underruns
+		).arg(stats.decodeTime / stats.decodedFrames
+		).arg(stats.decodeTimeMax
+		).arg(_refreshInterval));
+}
+
 void Player::lock() {
 	++_locks;
 }
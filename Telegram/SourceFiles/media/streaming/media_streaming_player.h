@@ -21,6 +21,9 @@ struct TrackState;
 namespace Media {
 namespace Streaming {
 
+extern const char kOptionVideoFramePacing[];
+extern const char kOptionVideoPlaybackStatistics[];
+
 class Reader;
 class File;
 class AudioTrack;
@@ -78,6 +81,7 @@ public:
 	void setLoaderPriority(int priority);
 
 	[[nodiscard]] Media::Player::TrackState prepareLegacyState() const;
+	[[nodiscard]] PlaybackStatistics statistics() const;
 
 	void lock();
 	void unlock();
@@ -126,6 +130,7 @@ private:
 	void videoPlayedTill(crl::time position);
 
 	void updatePausedState();
+	void logStatistics() const;
 	[[nodiscard]] bool trackReceivedEnough(
 		const TrackState &state,
 		crl::time amount) const;
@@ -199,6 +204,10 @@ private:
 	crl::time _pausedTime = kTimeUnknown;
 	crl::time _currentFrameTime = kTimeUnknown;
 	crl::time _nextFrameTime = kTimeUnknown;
+	crl::time _refreshInterval = 0;
+	bool _framePacing = false;
+	int _lateFrames = 0;
+	int _underruns = 0;
 	base::Timer _renderFrameTimer;
 	rpl::event_stream<Update, Error> _updates;
 	rpl::event_stream<bool> _fullInCache;
@@ -16,6 +16,11 @@ namespace Streaming {
 namespace {
 
 constexpr auto kPartSize = Loader::kPartSize;
+
+// Each slice is a single cache value, which is encrypted as a whole,
+// so reading any part of it decrypts the full slice. The slice size
+// can't be simply reduced, because the slice number is kept in the low
+// 9 bits of the cache key and the existing cached slices would break.
 constexpr auto kPartsInSlice = 64;
 constexpr auto kInSlice = uint32(kPartsInSlice * kPartSize);
 constexpr auto kMaxPartsInHeader = 64;
@@ -23,8 +28,16 @@ constexpr auto kMaxOnlyInHeader = 80 * kPartSize;
 constexpr auto kPartsOutsideFirstSliceGood = 8;
 constexpr auto kSlicesInMemory = 2;
 
-// 1 MB of parts are requested from cloud ahead of reading demand.
-constexpr auto kPreloadPartsAhead = 8;
+// From 1 MB to 4 MB of parts are requested from cloud ahead of reading
+// demand, depending on how much was received in a second recently.
+constexpr auto kPreloadPartsAheadMin = 8;
+constexpr auto kPreloadPartsAheadMax = 32;
+constexpr auto kPreloadDuration = crl::time(2000);
+constexpr auto kRateRoundDuration = crl::time(1000);
+
+// First parts of the next keyframes after the preloaded range are requested
+// as well, so that a short seek forward can start decoding right away.
+constexpr auto kPrefetchKeyframes = 2;
 constexpr auto kDownloaderRequestsLimit = 4;
 
 using PartsMap = base::flat_map<uint32, QByteArray>;
@@ -270,14 +283,14 @@ void Reader::Slice::addPart(uint32 offset, QByteArray bytes) {
 
 auto Reader::Slice::prepareFill(
 		uint32 from,
-		uint32 till) -> PrepareFillResult {
+		uint32 till,
+		int preloadParts) -> PrepareFillResult {
 	auto result = PrepareFillResult();
 
 	result.ready = false;
 	const auto fromOffset = (from / kPartSize) * kPartSize;
 	const auto tillPart = (till + kPartSize - 1) / kPartSize;
-	const auto preloadTillOffset = (tillPart + kPreloadPartsAhead)
-		* kPartSize;
+	const auto preloadTillOffset = (tillPart + preloadParts) * kPartSize;
 
 	const auto after = ranges::upper_bound(
 		parts,
@@ -527,6 +540,23 @@ bool Reader::Slices::checkFullInCache() const {
 	});
 }
 
+bool Reader::Slices::partMissing(uint32 offset) const {
+	using Flag = Slice::Flag;
+
+	if (offset >= _size
+		|| isFullInHeader()
+		|| _headerMode == HeaderMode::Unknown) {
+		return false;
+	}
+	const auto index = offset / kInSlice;
+	const auto &slice = _data[index];
+	if (_headerMode != HeaderMode::NoCache
+		&& !(slice.flags & Flag::LoadedFromCache)) {
+		return false;
+	}
+	return !slice.parts.contains(offset - index * kInSlice);
+}
+
 void Reader::Slices::processPart(
 		uint32 offset,
 		QByteArray &&bytes) {
@@ -548,7 +578,10 @@ void Reader::Slices::processPart(
 	checkSliceFullLoaded(index + 1);
 }
 
-auto Reader::Slices::fill(uint32 offset, bytes::span buffer) -> FillResult {
+auto Reader::Slices::fill(
+		uint32 offset,
+		bytes::span buffer,
+		int preloadParts) -> FillResult {
 	Expects(!buffer.empty());
 	Expects(offset < _size);
 	Expects(offset + buffer.size() <= _size);
@@ -562,7 +595,7 @@ auto Reader::Slices::fill(uint32 offset, bytes::span buffer) -> FillResult {
 		Assert(waitingForHeaderCache());
 		return {};
 	} else if (isFullInHeader()) {
-		return fillFromHeader(offset, buffer);
+		return fillFromHeader(offset, buffer, preloadParts);
 	}
 
 	auto result = FillResult();
@@ -605,9 +638,15 @@ auto Reader::Slices::fill(uint32 offset, bytes::span buffer) -> FillResult {
 	const auto secondTill = (till > (fromSlice + 1) * kInSlice)
 		? (till - (fromSlice + 1) * kInSlice)
 		: 0;
-	const auto first = _data[fromSlice].prepareFill(firstFrom, firstTill);
+	const auto first = _data[fromSlice].prepareFill(
+		firstFrom,
+		firstTill,
+		preloadParts);
 	const auto second = (fromSlice + 1 < tillSlice)
-		? _data[fromSlice + 1].prepareFill(secondFrom, secondTill)
+		? _data[fromSlice + 1].prepareFill(
+			secondFrom,
+			secondTill,
+			preloadParts)
 		: Slice::PrepareFillResult();
 	handlePrepareResult(fromSlice, first);
 	if (fromSlice + 1 < tillSlice) {
@@ -639,13 +678,15 @@ auto Reader::Slices::fill(uint32 offset, bytes::span buffer) -> FillResult {
 	return result;
 }
 
-auto Reader::Slices::fillFromHeader(uint32 offset, bytes::span buffer)
--> FillResult {
+auto Reader::Slices::fillFromHeader(
+		uint32 offset,
+		bytes::span buffer,
+		int preloadParts) -> FillResult {
 	auto result = FillResult();
 	const auto from = offset;
 	const auto till = uint32(offset + buffer.size());
 
-	const auto prepared = _header.prepareFill(from, till);
+	const auto prepared = _header.prepareFill(from, till, preloadParts);
 	for (const auto full : prepared.offsetsFromLoader.values()) {
 		if (full < _size) {
 			result.offsetsFromLoader.add(full);
@@ -843,8 +884,12 @@ Reader::Reader(
 	Storage::Cache::Database *cache)
 : _loader(std::move(loader))
 , _cache(cache)
-, _cacheHelper(cache ? InitCacheHelper(_loader->baseCacheKey()) : nullptr)
-, _slices(_loader->size(), _cacheHelper != nullptr) {
+, _mapped(_loader->mapped())
+, _cacheHelper((cache && _mapped.empty())
+	? InitCacheHelper(_loader->baseCacheKey())
+	: nullptr)
+, _slices(_loader->size(), _cacheHelper != nullptr)
+, _preloadParts(kPreloadPartsAheadMin) {
 	_loader->parts(
 	) | rpl::start_with_next([=](LoadedPart &&part) {
 		if (_attachedDownloader) {
@@ -1209,6 +1254,21 @@ int Reader::headerSize() const {
 	return _slices.headerSize();
 }
 
+void Reader::setKeyframeOffsets(std::vector<int64> offsets) {
+	const auto size = this->size();
+	_keyframeOffsets.clear();
+	_keyframeOffsets.reserve(offsets.size());
+	for (const auto offset : offsets) {
+		if (offset > 0 && offset < size) {
+			_keyframeOffsets.push_back(uint32(offset));
+		}
+	}
+	ranges::sort(_keyframeOffsets);
+	_keyframeOffsets.erase(
+		ranges::unique(_keyframeOffsets),
+		end(_keyframeOffsets));
+}
+
 bool Reader::fullInCache() const {
 	return _slices.fullInCache();
 }
@@ -1220,6 +1280,11 @@ Reader::FillState Reader::fill(
 	Expects(offset + buffer.size() <= size());
 	Expects(offset >= 0 && size() <= std::numeric_limits<uint32>::max());
 
+	if (!_mapped.empty()) {
+		bytes::copy(buffer, _mapped.subspan(offset, buffer.size()));
+		return FillState::Success;
+	}
+
 	const auto startWaiting = [&] {
 		if (_cacheHelper) {
 			_cacheHelper->waiting = notify.get();
@@ -1262,7 +1327,7 @@ Reader::FillState Reader::fill(
 Reader::FillState Reader::fillFromSlices(uint32 offset, bytes::span buffer) {
 	using namespace rpl::mappers;
 
-	auto result = _slices.fill(offset, buffer);
+	auto result = _slices.fill(offset, buffer, _preloadParts);
 	if (result.state != FillState::Success && _slices.headerWontBeFilled()) {
 		_streamingError = Error::NotStreamable;
 		return FillState::Failed;
@@ -1289,9 +1354,29 @@ Reader::FillState Reader::fillFromSlices(uint32 offset, bytes::span buffer) {
 		}
 		loadAtOffset(offset);
 	}
+	if (result.state == FillState::Success) {
+		prefetchKeyframes(offset, offset + buffer.size());
+	}
 	return result.state;
 }
 
+void Reader::prefetchKeyframes(uint32 offset, uint32 till) {
+	if (_keyframeOffsets.empty()) {
+		return;
+	}
+	const auto preloadTill = ((till + kPartSize - 1) / kPartSize
+		+ _preloadParts) * kPartSize;
+	auto i = ranges::lower_bound(_keyframeOffsets, preloadTill);
+	for (auto j = 0
+		; j != kPrefetchKeyframes && i != end(_keyframeOffsets)
+		; ++i, ++j) {
+		const auto part = (*i / kPartSize) * kPartSize;
+		if (_slices.partMissing(part)) {
+			loadAtOffset(part);
+		}
+	}
+}
+
 void Reader::cancelLoadInRange(uint32 from, uint32 till) {
 	Expects(from < till);
 
@@ -1352,6 +1437,7 @@ bool Reader::processLoadedParts() {
 	}
 
 	auto loaded = _loadedParts.take();
+	auto bytes = int64();
 	for (auto &part : loaded) {
 		if (!part.valid(size())) {
 			_streamingError = Error::LoadFailed;
@@ -1359,13 +1445,40 @@ bool Reader::processLoadedParts() {
 		} else if (!_loadingOffsets.remove(part.offset)) {
 			continue;
 		}
+		bytes += part.bytes.size();
 		_slices.processPart(
 			part.offset,
 			std::move(part.bytes));
 	}
+	if (bytes > 0) {
+		accumulateLoadedBytes(bytes);
+	}
 	return !loaded.empty();
 }
 
+void Reader::accumulateLoadedBytes(int64 bytes) {
+	const auto now = crl::now();
+	if (!_rateRoundStart) {
+		_rateRoundStart = now;
+	}
+	_rateRoundBytes += bytes;
+	const auto passed = now - _rateRoundStart;
+	if (passed < kRateRoundDuration) {
+		return;
+	}
+	// Pauses in reading demand only slowly lower the estimate.
+	const auto rate = _rateRoundBytes * 1000 / passed;
+	_bytesPerSecond = std::max(rate, _bytesPerSecond / 2);
+	_rateRoundStart = now;
+	_rateRoundBytes = 0;
+
+	const auto wanted = _bytesPerSecond * kPreloadDuration / 1000;
+	_preloadParts = int(std::clamp(
+		wanted / kPartSize,
+		int64(kPreloadPartsAheadMin),
+		int64(kPreloadPartsAheadMax)));
+}
+
 bool Reader::checkForSomethingMoreReceived() {
 	const auto result1 = processCacheResults();
 	const auto result2 = processLoadedParts();
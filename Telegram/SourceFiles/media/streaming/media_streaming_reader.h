@@ -58,6 +58,7 @@ public:
 	[[nodiscard]] std::optional<Error> streamingError() const;
 	void headerDone();
 	[[nodiscard]] int headerSize() const;
+	void setKeyframeOffsets(std::vector<int64> offsets);
 	[[nodiscard]] bool fullInCache() const;
 
 	// Thread safe.
@@ -82,7 +83,7 @@ public:
 	~Reader();
 
 private:
-	static constexpr auto kLoadFromRemoteMax = 8;
+	static constexpr auto kLoadFromRemoteMax = 32;
 
 	struct CacheHelper;
 
@@ -132,7 +133,10 @@ private:
 
 		void processCacheData(PartsMap &&data);
 		void addPart(uint32 offset, QByteArray bytes);
-		PrepareFillResult prepareFill(uint32 from, uint32 till);
+		PrepareFillResult prepareFill(
+			uint32 from,
+			uint32 till,
+			int preloadParts);
 
 		// Get up to kLoadFromRemoteMax not loaded parts in from-till range.
 		StackIntVector<kLoadFromRemoteMax> offsetsFromLoader(
@@ -163,9 +167,16 @@ private:
 		void processCachedSizes(const std::vector<int> &sizes);
 		void processPart(uint32 offset, QByteArray &&bytes);
 
-		[[nodiscard]] FillResult fill(uint32 offset, bytes::span buffer);
+		[[nodiscard]] FillResult fill(
+			uint32 offset,
+			bytes::span buffer,
+			int preloadParts);
 		[[nodiscard]] SerializedSlice unloadToCache();
 
+		// Checks only parts that are known to be not loaded, if the slice
+		// cache was not read yet the part is not reported as missing.
+		[[nodiscard]] bool partMissing(uint32 offset) const;
+
 		[[nodiscard]] QByteArray partForDownloader(uint32 offset) const;
 		[[nodiscard]] bool readCacheForDownloaderRequired(uint32 offset);
 
@@ -190,7 +201,8 @@ private:
 		[[nodiscard]] bool computeIsGoodHeader() const;
 		[[nodiscard]] FillResult fillFromHeader(
 			uint32 offset,
-			bytes::span buffer);
+			bytes::span buffer,
+			int preloadParts);
 		void unloadSlice(Slice &slice) const;
 		void checkSliceFullLoaded(int sliceNumber);
 		[[nodiscard]] bool checkFullInCache() const;
@@ -215,6 +227,8 @@ private:
 	void loadAtOffset(uint32 offset);
 	void checkLoadWillBeFirst(uint32 offset);
 	bool processLoadedParts();
+	void accumulateLoadedBytes(int64 bytes);
+	void prefetchKeyframes(uint32 offset, uint32 till);
 
 	bool checkForSomethingMoreReceived();
 
@@ -240,6 +254,9 @@ private:
 	const std::unique_ptr<Loader> _loader;
 	Storage::Cache::Database * const _cache = nullptr;
 
+	// Local file contents, filling from it skips slices altogether.
+	const bytes::const_span _mapped;
+
 	// shared_ptr is used to be able to have weak_ptr.
 	const std::shared_ptr<CacheHelper> _cacheHelper;
 
@@ -264,6 +281,11 @@ private:
 	bool _streamingActive = false;
 
 	// Streaming thread.
+	std::vector<uint32> _keyframeOffsets;
+	crl::time _rateRoundStart = 0;
+	int64 _rateRoundBytes = 0;
+	int64 _bytesPerSecond = 0;
+	int _preloadParts = 0;
 	std::deque<uint32> _offsetsForDownloader;
 	base::flat_set<uint32> _downloaderOffsetsRequested;
 	base::flat_map<uint32, std::optional<PartsMap>> _downloaderReadCache;
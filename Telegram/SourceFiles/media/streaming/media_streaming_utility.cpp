@@ -12,12 +12,26 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "ui/painter.h"
 #include "ffmpeg/ffmpeg_utility.h"
 
+extern "C" {
+#include <libavutil/hwcontext.h>
+} // extern "C"
+
 namespace Media {
 namespace Streaming {
 namespace {
 
 constexpr auto kSkipInvalidDataPackets = 10;
 
+// Mapping keeps the decoder surface alive while the frame is shown,
+// so only use it where the mapping is a direct view of the surface.
+[[nodiscard]] bool CanMapHwFrame(not_null<AVFrame*> frame) {
+	const auto frames = reinterpret_cast<AVHWFramesContext*>(
+		frame->hw_frames_ctx->data);
+	const auto type = frames->device_ctx->type;
+	return (type == AV_HWDEVICE_TYPE_VAAPI)
+		|| (type == AV_HWDEVICE_TYPE_VIDEOTOOLBOX);
+}
+
 } // namespace
 
 crl::time FramePosition(const Stream &stream) {
@@ -121,6 +135,22 @@ bool TransferFrame(
 		not_null<AVFrame*> transferredFrame) {
 	Expects(decodedFrame->hw_frames_ctx != nullptr);
 
+	if (!stream.hwFramesMapFailed && CanMapHwFrame(decodedFrame)) {
+		// Map the surface instead of copying it, the NV12 planes are
+		// uploaded to textures right from the mapped memory.
+		av_frame_unref(transferredFrame);
+		const auto error = FFmpeg::AvErrorWrap(av_hwframe_map(
+			transferredFrame,
+			decodedFrame,
+			AV_HWFRAME_MAP_READ));
+		if (!error) {
+			FFmpeg::ClearFrameMemory(decodedFrame);
+			return true;
+		}
+		LogError(u"av_hwframe_map"_q, error);
+		stream.hwFramesMapFailed = true;
+		av_frame_unref(transferredFrame);
+	}
 	const auto error = FFmpeg::AvErrorWrap(
 		av_hwframe_transfer_data(transferredFrame, decodedFrame, 0));
 	if (error) {
@@ -42,6 +42,7 @@ struct Stream {
 	int rotation = 0;
 	AVRational aspect = FFmpeg::kNormalAspect;
 	FFmpeg::SwscalePointer swscale;
+	bool hwFramesMapFailed = false;
 };
 
 [[nodiscard]] crl::time FramePosition(const Stream &stream);
@@ -320,6 +320,7 @@ auto VideoTrackObject::readEnoughFrames(crl::time trackTime)
 				|| !VideoTrack::IsStale(frame, trackTime)) {
 				return v::null;
 			}
+			_shared->frameDropped();
 		}
 	}, [&](Shared::PrepareNextCheck delay) -> ReadEnoughState {
 		return delay;
@@ -353,6 +354,7 @@ crl::time VideoTrackObject::computeDuration() const {
 }
 
 auto VideoTrackObject::readFrame(not_null<Frame*> frame) -> FrameResult {
+	const auto started = crl::profile();
 	if (const auto error = ReadNextFrame(_stream)) {
 		if (error.code() == AVERROR_EOF) {
 			if (!_options.loop) {
@@ -378,6 +380,7 @@ auto VideoTrackObject::readFrame(not_null<Frame*> frame) -> FrameResult {
 		fail(Error::InvalidData);
 		return FrameResult::Error;
 	}
+	_shared->frameDecoded(crl::profile() - started);
 	std::swap(frame->decoded, _stream.decodedFrame);
 	std::swap(frame->transferred, _stream.transferredFrame);
 	frame->index = _frameIndex++;
@@ -827,6 +830,7 @@ auto VideoTrack::Shared::prepareState(
 		} else if (IsStale(frame, trackTime)) {
 			std::swap(*frame, *next);
 			next->displayed = kDisplaySkipped;
+			frameDropped();
 			return next;
 		} else {
 			if (frame->position - trackTime + 1 <= 0) { // Debugging crash.
@@ -872,6 +876,28 @@ bool VideoTrack::Shared::firstPresentHappened() const {
 	Unexpected("Counter value in VideoTrack::Shared::firstPresentHappened.");
 }
 
+void VideoTrack::Shared::frameDecoded(crl::profile_time duration) {
+	_decodedFrames.fetch_add(1, std::memory_order_relaxed);
+	_decodeTime.fetch_add(duration, std::memory_order_relaxed);
+	if (_decodeTimeMax.load(std::memory_order_relaxed) < duration) {
+		// Only the wrapped object queue writes the counters.
+		_decodeTimeMax.store(duration, std::memory_order_relaxed);
+	}
+}
+
+void VideoTrack::Shared::frameDropped() {
+	_droppedFrames.fetch_add(1, std::memory_order_relaxed);
+}
+
+PlaybackStatistics VideoTrack::Shared::statistics() const {
+	return {
+		.decodedFrames = _decodedFrames.load(std::memory_order_relaxed),
+		.droppedFrames = _droppedFrames.load(std::memory_order_relaxed),
+		.decodeTime = _decodeTime.load(std::memory_order_relaxed),
+		.decodeTimeMax = _decodeTimeMax.load(std::memory_order_relaxed),
+	};
+}
+
 auto VideoTrack::Shared::presentFrame(
 	not_null<VideoTrackObject*> object,
 	TimePoint time,
@@ -1092,6 +1118,10 @@ crl::time VideoTrack::streamDuration() const {
 	return _streamDuration;
 }
 
+PlaybackStatistics VideoTrack::statistics() const {
+	return _shared->statistics();
+}
+
 void VideoTrack::process(std::vector<FFmpeg::Packet> &&packets) {
 	_wrapped.with([
 		packets = std::move(packets)
@@ -35,6 +35,7 @@ public:
 	[[nodiscard]] int streamIndex() const;
 	[[nodiscard]] AVRational streamTimeBase() const;
 	[[nodiscard]] crl::time streamDuration() const;
+	[[nodiscard]] PlaybackStatistics statistics() const;
 
 	// Called from the same unspecified thread.
 	void process(std::vector<FFmpeg::Packet> &&packets);
@@ -128,6 +129,11 @@ private:
 			float64 playbackSpeed,
 			bool dropStaleFrames);
 		[[nodiscard]] bool firstPresentHappened() const;
+		void frameDecoded(crl::profile_time duration);
+		void frameDropped();
+
+		// Thread-safe.
+		[[nodiscard]] PlaybackStatistics statistics() const;
 
 		// Called from the main thread.
 		// Returns the position of the displayed frame.
@@ -153,6 +159,11 @@ private:
 		// (_counter % 2) == 0 crl::queue can read _delay.
 		crl::time _delay = kTimeUnknown;
 
+		std::atomic<int> _decodedFrames = 0;
+		std::atomic<int> _droppedFrames = 0;
+		std::atomic<crl::profile_time> _decodeTime = 0;
+		std::atomic<crl::profile_time> _decodeTimeMax = 0;
+
 	};
 
 	static void PrepareFrameByRequests(
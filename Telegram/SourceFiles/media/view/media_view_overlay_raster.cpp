@@ -112,11 +112,39 @@ void OverlayWidget::RendererSW::paintTransformedStaticContent(
 		_p->fillRect(rect, _transparentBrush);
 	}
 	if (!image.isNull()) {
-		paintTransformedImage(image, rect, rotation);
+		paintTransformedImage(
+			index ? image : scaledStaticContent(image, rect, rotation),
+			rect,
+			rotation);
 	}
 	paintControlsFade(rect, geometry);
 }
 
+const QImage &OverlayWidget::RendererSW::scaledStaticContent(
+		const QImage &image,
+		QRect rect,
+		int rotation) {
+	// Downscaling a big image on each paint is slow, keep one scaled copy
+	// for the current zoom, so that moving the image only blits it.
+	const auto size = (((rotation % 180) == 90)
+		? rect.size().transposed()
+		: rect.size()) * style::DevicePixelRatio();
+	if (size.width() >= image.width() || size.height() >= image.height()) {
+		_scaledContent = QImage();
+		return image;
+	} else if (_owner->_geometryAnimation.animating()) {
+		return image;
+	} else if (_scaledContentKey != image.cacheKey()
+		|| _scaledContent.size() != size) {
+		_scaledContent = image.scaled(
+			size,
+			Qt::IgnoreAspectRatio,
+			Qt::SmoothTransformation);
+		_scaledContentKey = image.cacheKey();
+	}
+	return _scaledContent;
+}
+
 void OverlayWidget::RendererSW::paintControlsFade(
 		QRect content,
 		const ContentGeometry &geometry) {
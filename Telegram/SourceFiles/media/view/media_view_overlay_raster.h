@@ -33,6 +33,10 @@ private:
 		const QImage &image,
 		QRect rect,
 		int rotation);
+	[[nodiscard]] const QImage &scaledStaticContent(
+		const QImage &image,
+		QRect rect,
+		int rotation);
 	void paintControlsFade(QRect content, const ContentGeometry &geometry);
 	void paintRadialLoading(
 		QRect inner,
@@ -73,6 +77,9 @@ private:
 
 	QImage _overControlImage;
 
+	QImage _scaledContent;
+	qint64 _scaledContentKey = 0;
+
 	QImage _topShadowCache;
 	QColor _topShadowColor;
 
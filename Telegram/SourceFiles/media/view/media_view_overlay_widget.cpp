@@ -16,6 +16,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "boxes/premium_preview_box.h"
 #include "core/application.h"
 #include "core/click_handler_types.h"
+#include "core/core_paint_profiler.h"
 #include "core/file_utilities.h"
 #include "core/mime_type.h"
 #include "core/ui_integration.h"
@@ -78,6 +79,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "base/unixtime.h"
 #include "base/qt_signal_producer.h"
 #include "base/event_filter.h"
+#include "base/options.h"
 #include "main/main_account.h"
 #include "main/main_domain.h" // Domain::activeSessionValue.
 #include "main/main_session.h"
@@ -109,6 +111,8 @@ namespace View {
 namespace {
 
 constexpr auto kPreloadCount = 3;
+constexpr auto kFastPreloadCount = 6;
+constexpr auto kFastSwitchTimeout = crl::time(1000);
 constexpr auto kMaxZoomLevel = 7; // x8
 constexpr auto kZoomToScreenLevel = 1024;
 constexpr auto kOverlayLoaderPriority = 2;
@@ -226,6 +230,12 @@ QWidget *PipDelegate::pipParentWidget() {
 	return false;
 }
 
+[[nodiscard]] bool PlaybackStatisticsShown() {
+	using namespace Streaming;
+	return base::options::lookup<bool>(kOptionVideoPlaybackStatistics)
+		.value();
+}
+
 } // namespace
 
 class OverlayWidget::SponsoredButton : public Ui::RippleButton {
@@ -4629,6 +4639,10 @@ void OverlayWidget::updatePlaybackState() {
 	if (state.position != kTimeUnknown && state.length != kTimeUnknown) {
 		if (_streamed->controls) {
 			_streamed->controls->updatePlayback(state);
+			if (PlaybackStatisticsShown()) {
+				_streamed->controls->setStatistics(
+					_streamed->instance.player().statistics());
+			}
 			_touchbarTrackState.fire_copy(state);
 			updatePowerSaveBlocker(state);
 		}
@@ -4690,6 +4704,8 @@ Ui::GL::ChosenRenderer OverlayWidget::chooseRenderer(
 }
 
 void OverlayWidget::paint(not_null<Renderer*> renderer) {
+	const auto profiler = Core::PaintProfiler::Scope(
+		Core::PaintProfiler::Section::MediaViewer);
 	renderer->paintBackground();
 	if (contentShown()) {
 		if (videoShown()) {
@@ -5640,8 +5656,17 @@ void OverlayWidget::preloadData(int delta) {
 	if (!_index) {
 		return;
 	}
+	// When flicking quickly in one direction look further ahead.
+	const auto now = crl::now();
+	const auto fast = delta
+		&& (delta == _preloadDelta)
+		&& (now - _preloadDeltaAt < kFastSwitchTimeout);
+	_preloadDelta = delta;
+	_preloadDeltaAt = now;
+	const auto count = fast ? kFastPreloadCount : kPreloadCount;
+
 	auto from = *_index + (delta ? -delta : -1);
-	auto till = *_index + (delta ? delta * kPreloadCount : 1);
+	auto till = *_index + (delta ? delta * count : 1);
 	if (from > till) std::swap(from, till);
 
 	auto photos = base::flat_set<std::shared_ptr<Data::PhotoMedia>>();
@@ -11,6 +11,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "media/player/media_player_button.h"
 #include "media/player/media_player_dropdown.h"
 #include "media/view/media_view_playback_progress.h"
+#include "media/streaming/media_streaming_common.h"
 #include "ui/widgets/labels.h"
 #include "ui/widgets/continuous_sliders.h"
 #include "ui/effects/fade_animation.h"
@@ -23,6 +24,11 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 namespace Media {
 namespace View {
+namespace {
+
+constexpr auto kStatisticsUpdateDelay = crl::time(500);
+
+} // namespace
 
 PlaybackControls::PlaybackControls(
 	QWidget *parent,
@@ -258,6 +264,29 @@ void PlaybackControls::setLoadingProgress(int64 ready, int64 total) {
 	}
 }
 
+void PlaybackControls::setStatistics(
+		const Streaming::PlaybackStatistics &statistics) {
+	const auto now = crl::now();
+	if (_statistics && now - _statisticsUpdated < kStatisticsUpdateDelay) {
+		return;
+	}
+	_statisticsUpdated = now;
+	if (!_statistics) {
+		_statistics.create(this, st::mediaviewPlayProgressLabel);
+		_statistics->setVisible(!_fadeAnimation->animating());
+	}
+	const auto decode = statistics.decodedFrames
+		? (statistics.decodeTime / float64(statistics.decodedFrames))
+		: 0.;
+	_statistics->setText(u"%1 late, %2 dropped, %3 stalls, %4 ms"_q
+		.arg(statistics.lateFrames)
+		.arg(statistics.droppedFrames)
+		.arg(statistics.underruns)
+		.arg(decode / 1000., 0, 'f', 1));
+	updateStatisticsPosition();
+	refreshFadeCache();
+}
+
 void PlaybackControls::refreshFadeCache() {
 	if (!_fadeAnimation->animating()) {
 		return;
@@ -363,6 +392,20 @@ void PlaybackControls::resizeEvent(QResizeEvent *e) {
 		st::mediaviewVolumeWidth,
 		st::mediaviewPlayback.seekSize.height());
 	_volumeController->moveToLeft(left, st::mediaviewVolumeTop + (_volumeToggle->height() - _volumeController->height()) / 2);
+
+	updateStatisticsPosition();
+}
+
+void PlaybackControls::updateStatisticsPosition() {
+	if (!_statistics) {
+		return;
+	}
+	const auto left = _volumeController->x() + _volumeController->width();
+	const auto right = _playPauseResume->x();
+	const auto available = right - left;
+	const auto x = left + (available - _statistics->width()) / 2;
+	const auto y = _playPauseResume->y() + (_playPauseResume->height() - _statistics->height()) / 2;
+	_statistics->move(x, y);
 }
 
 void PlaybackControls::updateDownloadProgressPosition() {
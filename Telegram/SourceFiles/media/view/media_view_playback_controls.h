@@ -25,6 +25,10 @@ class SpeedButton;
 class SpeedController;
 } // namespace Player
 
+namespace Streaming {
+struct PlaybackStatistics;
+} // namespace Streaming
+
 namespace View {
 
 class PlaybackProgress;
@@ -58,6 +62,7 @@ public:
 
 	void updatePlayback(const Player::TrackState &state);
 	void setLoadingProgress(int64 ready, int64 total);
+	void setStatistics(const Streaming::PlaybackStatistics &statistics);
 	void setInFullScreen(bool inFullScreen);
 	[[nodiscard]] bool hasMenu() const;
 	[[nodiscard]] bool dragging() const;
@@ -82,6 +87,7 @@ private:
 	void updatePlaybackSpeed(float64 speed);
 	void updateVolumeToggleIcon();
 	void updateDownloadProgressPosition();
+	void updateStatisticsPosition();
 
 	void updatePlayPauseResumeState(const Player::TrackState &state);
 	void updateTimeTexts(const Player::TrackState &state);
@@ -101,6 +107,7 @@ private:
 	int64 _loadingReady = 0;
 	int64 _loadingTotal = 0;
 	int _loadingPercent = 0;
+	crl::time _statisticsUpdated = 0;
 
 	object_ptr<Ui::IconButton> _playPauseResume;
 	object_ptr<Ui::MediaSlider> _playbackSlider;
@@ -114,6 +121,7 @@ private:
 	object_ptr<Ui::LabelSimple> _playedAlready;
 	object_ptr<Ui::LabelSimple> _toPlayLeft;
 	object_ptr<Ui::LabelSimple> _downloadProgress = { nullptr };
+	object_ptr<Ui::LabelSimple> _statistics = { nullptr };
 	std::unique_ptr<Player::SpeedController> _speedController;
 	std::unique_ptr<Ui::FadeAnimation> _fadeAnimation;
 
@@ -21,6 +21,7 @@ constexpr auto kPacketSizeMax = int(0x01000000 * sizeof(mtpPrime));
 constexpr auto kFullConnectionTimeout = 8 * crl::time(1000);
 constexpr auto kSmallBufferSize = 256 * 1024;
 constexpr auto kMinPacketBuffer = 256;
+constexpr auto kDirectReadPacketSize = 16 * 1024;
 constexpr auto kConnectionStartPrefixSize = 64;
 
 } // namespace
@@ -38,6 +39,7 @@ public:
 	static constexpr auto kUnknownSize = -1;
 	static constexpr auto kInvalidSize = -2;
 	virtual int readPacketLength(bytes::const_span bytes) const = 0;
+	virtual int readPacketPrefixLength(bytes::const_span bytes) const = 0;
 	virtual bytes::const_span readPacket(bytes::const_span bytes) const = 0;
 
 	virtual QString debugPostfix() const = 0;
@@ -60,6 +62,7 @@ public:
 	bytes::span finalizePacket(mtpBuffer &buffer) override;
 
 	int readPacketLength(bytes::const_span bytes) const override;
+	int readPacketPrefixLength(bytes::const_span bytes) const override;
 	bytes::const_span readPacket(bytes::const_span bytes) const override;
 
 	QString debugPostfix() const override;
@@ -123,13 +126,20 @@ int TcpConnection::Protocol::Version0::readPacketLength(
 	return kInvalidSize;
 }
 
+int TcpConnection::Protocol::Version0::readPacketPrefixLength(
+		bytes::const_span bytes) const {
+	Expects(!bytes.empty());
+
+	return (static_cast<char>(bytes[0]) == 0x7F) ? 4 : 1;
+}
+
 bytes::const_span TcpConnection::Protocol::Version0::readPacket(
 		bytes::const_span bytes) const {
 	const auto size = readPacketLength(bytes);
 	Assert(size != kUnknownSize
 		&& size != kInvalidSize
 		&& size <= bytes.size());
-	const auto sizeLength = (static_cast<char>(bytes[0]) == 0x7F) ? 4 : 1;
+	const auto sizeLength = readPacketPrefixLength(bytes);
 	return bytes.subspan(sizeLength, size - sizeLength);
 }
 
@@ -175,6 +185,7 @@ public:
 	bytes::span finalizePacket(mtpBuffer &buffer) override;
 
 	int readPacketLength(bytes::const_span bytes) const override;
+	int readPacketPrefixLength(bytes::const_span bytes) const override;
 	bytes::const_span readPacket(bytes::const_span bytes) const override;
 
 	QString debugPostfix() const override;
@@ -215,13 +226,18 @@ int TcpConnection::Protocol::VersionD::readPacketLength(
 		: kInvalidSize;
 }
 
+int TcpConnection::Protocol::VersionD::readPacketPrefixLength(
+		bytes::const_span bytes) const {
+	return 4;
+}
+
 bytes::const_span TcpConnection::Protocol::VersionD::readPacket(
 		bytes::const_span bytes) const {
 	const auto size = readPacketLength(bytes);
 	Assert(size != kUnknownSize
 		&& size != kInvalidSize
 		&& size <= bytes.size());
-	const auto sizeLength = 4;
+	const auto sizeLength = readPacketPrefixLength(bytes);
 	return bytes.subspan(sizeLength, size - sizeLength);
 }
 
@@ -258,35 +274,36 @@ ConnectionPointer TcpConnection::clone(const ProxyData &proxy) {
 }
 
 void TcpConnection::ensureAvailableInBuffer(int amount) {
-	auto &buffer = _usingLargeBuffer ? _largeBuffer : _smallBuffer;
-	const auto full = bytes::make_span(buffer).subspan(
-		_offsetBytes);
+	Expects(amount <= kSmallBufferSize);
+
+	const auto full = bytes::make_span(_smallBuffer).subspan(_offsetBytes);
 	if (full.size() >= amount) {
 		return;
 	}
-	const auto read = full.subspan(0, _readBytes);
-	if (amount <= _smallBuffer.size()) {
-		if (_usingLargeBuffer) {
-			bytes::copy(_smallBuffer, read);
-			_usingLargeBuffer = false;
-			_largeBuffer.clear();
-		} else {
-			bytes::move(_smallBuffer, read);
-		}
-	} else if (amount <= _largeBuffer.size()) {
-		Assert(_usingLargeBuffer);
-		bytes::move(_largeBuffer, read);
-	} else {
-		auto enough = bytes::vector(amount);
-		bytes::copy(enough, read);
-		_largeBuffer = std::move(enough);
-		_usingLargeBuffer = true;
-	}
+	bytes::move(_smallBuffer, full.subspan(0, _readBytes));
+	_offsetBytes = 0;
+}
+
+void TcpConnection::startDirectPacket(
+		bytes::const_span available,
+		int packetSize) {
+	Expects(_packet.isEmpty());
+	Expects(available.size() < packetSize);
+
+	// Read the rest of a large packet right into the buffer that will
+	// be passed to the session, so it is never copied after decryption.
+	const auto prefix = _protocol->readPacketPrefixLength(available);
+	const auto payload = packetSize - prefix;
+	const auto already = available.subspan(prefix);
+	_packet.resize((payload + sizeof(mtpPrime) - 1) / sizeof(mtpPrime));
+	bytes::copy(bytes::make_span(_packet), already);
 	_offsetBytes = 0;
+	_readBytes = already.size();
+	_leftBytes = payload - _readBytes;
 }
 
 void TcpConnection::socketRead() {
-	Expects(_leftBytes > 0 || !_usingLargeBuffer);
+	Expects(_leftBytes > 0 || _packet.isEmpty());
 
 	if (!_socket || !_socket->isConnected()) {
 		CONNECTION_LOG_ERROR("Socket not connected in socketRead()");
@@ -298,32 +315,43 @@ void TcpConnection::socketRead() {
 		_smallBuffer.resize(kSmallBufferSize);
 	}
 	do {
+		const auto direct = !_packet.isEmpty();
 		const auto readLimit = (_leftBytes > 0)
 			? _leftBytes
 			: (kSmallBufferSize - _offsetBytes - _readBytes);
 		Assert(readLimit > 0);
 
-		auto &buffer = _usingLargeBuffer ? _largeBuffer : _smallBuffer;
-		const auto full = bytes::make_span(buffer).subspan(_offsetBytes);
+		const auto full = direct
+			? bytes::make_span(_packet)
+			: bytes::make_span(_smallBuffer).subspan(_offsetBytes);
 		const auto free = full.subspan(_readBytes);
 		const auto readCount = _socket->read(free.subspan(0, readLimit));
 		if (readCount > 0) {
 			const auto read = free.subspan(0, readCount);
-			aesCtrEncrypt(read, _receiveKey, &_receiveState);
+			_receiveStream.encrypt(read);
 			CONNECTION_LOG_INFO(u"Read %1 bytes"_q.arg(readCount));
 
 			_readBytes += readCount;
 			if (_leftBytes > 0) {
 				Assert(readCount <= _leftBytes);
 				_leftBytes -= readCount;
-				if (!_leftBytes) {
+				if (!_leftBytes && direct) {
+					auto packet = base::take(_packet);
+					packet.resize(_readBytes / sizeof(mtpPrime));
+					_offsetBytes = _readBytes = 0;
+
+					CONNECTION_LOG_INFO(u"Packet received, size = %1."_q
+						.arg(packet.size() * sizeof(mtpPrime)));
+					processPacket(std::move(packet));
+					if (!_socket || !_socket->isConnected()) {
+						return;
+					}
+				} else if (!_leftBytes) {
 					socketPacket(full.subspan(0, _readBytes));
 					if (!_socket || !_socket->isConnected()) {
 						return;
 					}
 
-					_usingLargeBuffer = false;
-					_largeBuffer.clear();
 					_offsetBytes = _readBytes = 0;
 				} else {
 					CONNECTION_LOG_INFO(
@@ -361,8 +389,12 @@ void TcpConnection::socketRead() {
 					} else {
 						_leftBytes = packetSize - available.size();
 
-						// If the next packet won't fit in the buffer.
-						ensureAvailableInBuffer(packetSize);
+						if (packetSize >= kDirectReadPacketSize) {
+							startDirectPacket(available, packetSize);
+						} else {
+							// If the next packet won't fit in the buffer.
+							ensureAvailableInBuffer(packetSize);
+						}
 
 						CONNECTION_LOG_INFO(u"Not enough %1 for packet! "
 							"full size %2 read %3"_q
@@ -439,7 +471,7 @@ void TcpConnection::sendData(mtpBuffer &&buffer) {
 	const auto bytes = _protocol->finalizePacket(buffer);
 	CONNECTION_LOG_INFO(u"TCP Info: write packet %1 bytes."_q
 		.arg(bytes.size()));
-	aesCtrEncrypt(bytes, _sendKey, &_sendState);
+	_sendStream.encrypt(bytes);
 	_socket->write(connectionStartPrefix, bytes);
 }
 
@@ -461,11 +493,11 @@ bytes::const_span TcpConnection::prepareConnectionStartPrefix(
 	} while (!_socket->isGoodStartNonce(nonce));
 
 	// prepare encryption key/iv
-	_protocol->prepareKey(
-		bytes::make_span(_sendKey),
-		nonce.subspan(8, CTRState::KeySize));
-	bytes::copy(
-		bytes::make_span(_sendState.ivec),
+	uchar keyBytes[CTRState::KeySize];
+	const auto key = bytes::make_span(keyBytes);
+	_protocol->prepareKey(key, nonce.subspan(8, CTRState::KeySize));
+	_sendStream = CTRStream(
+		key,
 		nonce.subspan(8 + CTRState::KeySize, CTRState::IvecSize));
 
 	// prepare decryption key/iv
@@ -473,11 +505,9 @@ bytes::const_span TcpConnection::prepareConnectionStartPrefix(
 	const auto reversed = bytes::make_span(reversedBytes);
 	bytes::copy(reversed, nonce.subspan(8, reversed.size()));
 	std::reverse(reversed.begin(), reversed.end());
-	_protocol->prepareKey(
-		bytes::make_span(_receiveKey),
-		reversed.subspan(0, CTRState::KeySize));
-	bytes::copy(
-		bytes::make_span(_receiveState.ivec),
+	_protocol->prepareKey(key, reversed.subspan(0, CTRState::KeySize));
+	_receiveStream = CTRStream(
+		key,
 		reversed.subspan(CTRState::KeySize, CTRState::IvecSize));
 
 	// write protocol and dc ids
@@ -487,7 +517,7 @@ bytes::const_span TcpConnection::prepareConnectionStartPrefix(
 	*dcId = _protocolDcId;
 
 	bytes::copy(buffer, nonce.subspan(0, 56));
-	aesCtrEncrypt(nonce, _sendKey, &_sendState);
+	_sendStream.encrypt(nonce);
 	bytes::copy(buffer.subspan(56), nonce.subspan(56));
 
 	return buffer;
@@ -585,8 +615,13 @@ crl::time TcpConnection::fullConnectTimeout() const {
 void TcpConnection::socketPacket(bytes::const_span bytes) {
 	Expects(_socket != nullptr);
 
+	processPacket(parsePacket(bytes));
+}
+
+void TcpConnection::processPacket(mtpBuffer &&data) {
+	Expects(_socket != nullptr);
+
 	// old quickack?..
-	const auto data = parsePacket(bytes);
 	if (data.size() == 1) {
 		if (data[0] != 0) {
 			error(data[0]);
@@ -596,7 +631,7 @@ void TcpConnection::socketPacket(bytes::const_span bytes) {
 	//} else if (data.size() == 2) {
 		// new quickack?..
 	} else if (_status == Status::Ready) {
-		_receivedQueue.push_back(data);
+		_receivedQueue.push_back(std::move(data));
 		receivedData();
 	} else if (_status == Status::Waiting) {
 		if (const auto res_pq = readPQFakeReply(data)) {
@@ -55,6 +55,7 @@ private:
 	bytes::const_span prepareConnectionStartPrefix(bytes::span buffer);
 
 	void socketPacket(bytes::const_span bytes);
+	void processPacket(mtpBuffer &&data);
 
 	void socketConnected();
 	void socketDisconnected();
@@ -62,6 +63,7 @@ private:
 
 	mtpBuffer parsePacket(bytes::const_span bytes);
 	void ensureAvailableInBuffer(int amount);
+	void startDirectPacket(bytes::const_span available, int packetSize);
 	static uint32 fourCharsToUInt(char ch1, char ch2, char ch3, char ch4) {
 		char ch[4] = { ch1, ch2, ch3, ch4 };
 		return *reinterpret_cast<uint32*>(ch);
@@ -75,13 +77,10 @@ private:
 	int _readBytes = 0;
 	int _leftBytes = 0;
 	bytes::vector _smallBuffer;
-	bytes::vector _largeBuffer;
-	bool _usingLargeBuffer = false;
+	mtpBuffer _packet;
 
-	uchar _sendKey[CTRState::KeySize];
-	CTRState _sendState;
-	uchar _receiveKey[CTRState::KeySize];
-	CTRState _receiveState;
+	CTRStream _sendStream;
+	CTRStream _receiveStream;
 	class Protocol;
 	std::unique_ptr<Protocol> _protocol;
 	int16 _protocolDcId = 0;
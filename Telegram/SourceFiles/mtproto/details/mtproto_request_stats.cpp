@@ -0,0 +1,160 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "mtproto/details/mtproto_request_stats.h"
+
+namespace MTP::details {
+namespace {
+
+// Upper bounds of latency histogram buckets, the last one is unbounded.
+constexpr auto kBucketBounds = std::array<crl::time, 8>{ {
+	50, 100, 250, 500, 1000, 2500, 5000, 10000
+} };
+
+} // namespace
+
+void RequestStats::Histogram::add(crl::time duration) {
+	const auto i = ranges::lower_bound(kBucketBounds, duration);
+	++buckets[std::distance(begin(kBucketBounds), i)];
+	total += duration;
+	max = std::max(max, duration);
+	++count;
+}
+
+crl::time RequestStats::Histogram::percentile(int percent) const {
+	const auto wanted = (count * percent + 99) / 100;
+	auto accumulated = 0;
+	for (auto i = 0; i != kBuckets; ++i) {
+		accumulated += buckets[i];
+		if (accumulated >= wanted) {
+			return (i < int(kBucketBounds.size())) ? kBucketBounds[i] : max;
+		}
+	}
+	return max;
+}
+
+bool RequestStats::enabled() const {
+	return _enabled;
+}
+
+void RequestStats::setEnabled(bool enabled) {
+	if (_enabled == enabled) {
+		return;
+	}
+	_enabled = enabled;
+	_pending.clear();
+	_entries.clear();
+	_queues.clear();
+	_enabledAt = enabled ? crl::now() : 0;
+}
+
+void RequestStats::sent(
+		mtpRequestId requestId,
+		ShiftedDcId shiftedDcId,
+		mtpTypeId method) {
+	if (!_enabled) {
+		return;
+	}
+	const auto i = _pending.find(requestId);
+	if (i != end(_pending)) {
+		// Request id was overridden, count the old request as retried.
+		i->second.sent = crl::now();
+		++entry(i->second)->retries;
+		return;
+	}
+	_pending.emplace(requestId, Pending{
+		.sent = crl::now(),
+		.shiftedDcId = shiftedDcId,
+		.method = method,
+	});
+	auto &queue = _queues[shiftedDcId];
+	queue.max = std::max(queue.max, ++queue.current);
+}
+
+void RequestStats::retried(mtpRequestId requestId) {
+	const auto i = _pending.find(requestId);
+	if (i != end(_pending)) {
+		++entry(i->second)->retries;
+	}
+}
+
+void RequestStats::delayed(
+		mtpRequestId requestId,
+		crl::time delay,
+		bool flood) {
+	const auto i = _pending.find(requestId);
+	if (i != end(_pending)) {
+		const auto found = entry(i->second);
+		++(flood ? found->floods : found->retries);
+		found->delayedTotal += delay;
+	}
+}
+
+void RequestStats::failed(mtpRequestId requestId) {
+	const auto i = _pending.find(requestId);
+	if (i != end(_pending)) {
+		i->second.failed = true;
+	}
+}
+
+void RequestStats::finished(mtpRequestId requestId) {
+	const auto i = _pending.find(requestId);
+	if (i == end(_pending)) {
+		return;
+	}
+	const auto pending = i->second;
+	_pending.erase(i);
+
+	const auto found = entry(pending);
+	found->latency.add(crl::now() - pending.sent);
+	if (pending.failed) {
+		++found->failed;
+	}
+	const auto j = _queues.find(pending.shiftedDcId);
+	if (j != end(_queues)) {
+		--j->second.current;
+	}
+}
+
+auto RequestStats::entry(const Pending &pending) -> Entry* {
+	return &_entries[std::make_pair(pending.shiftedDcId, pending.method)];
+}
+
+QString RequestStats::dump() const {
+	if (!_enabled) {
+		return u"MTP request stats are disabled."_q;
+	}
+	auto result = QStringList();
+	result.push_back(u"MTP request stats for the last %1 s."_q.arg(
+		(crl::now() - _enabledAt) / 1000));
+	for (const auto &[shiftedDcId, queue] : _queues) {
+		result.push_back(u"dc %1: in flight %2, max %3"_q
+			.arg(shiftedDcId)
+			.arg(queue.current)
+			.arg(queue.max));
+	}
+	for (const auto &[key, entry] : _entries) {
+		const auto &latency = entry.latency;
+		result.push_back(u"dc %1 method 0x%2: count %3, "
+			"avg %4 ms, p50 <= %5 ms, p90 <= %6 ms, max %7 ms, "
+			"failed %8, retries %9, floods %10, delayed %11 ms"_q
+			.arg(key.first)
+			.arg(key.second, 8, 16, QChar('0'))
+			.arg(latency.count)
+			.arg(latency.count ? (latency.total / latency.count) : 0)
+			.arg(latency.percentile(50))
+			.arg(latency.percentile(90))
+			.arg(latency.max)
+			.arg(entry.failed)
+			.arg(entry.retries)
+			.arg(entry.floods)
+			.arg(entry.delayedTotal));
+	}
+	return result.join('\n');
+}
+
+} // namespace MTP::details
@@ -0,0 +1,75 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include "mtproto/core_types.h"
+#include "base/flat_map.h"
+
+#include <crl/crl_time.h>
+
+namespace MTP::details {
+
+// Opt-in request latency, retry and queue depth statistics,
+// collected per shifted dc and per TL method. Main thread only.
+class RequestStats final {
+public:
+	[[nodiscard]] bool enabled() const;
+	void setEnabled(bool enabled);
+
+	void sent(
+		mtpRequestId requestId,
+		ShiftedDcId shiftedDcId,
+		mtpTypeId method);
+	void retried(mtpRequestId requestId);
+	void delayed(mtpRequestId requestId, crl::time delay, bool flood);
+	void failed(mtpRequestId requestId);
+	void finished(mtpRequestId requestId);
+
+	[[nodiscard]] QString dump() const;
+
+private:
+	struct Histogram {
+		static constexpr auto kBuckets = 9;
+
+		void add(crl::time duration);
+		[[nodiscard]] crl::time percentile(int percent) const;
+
+		std::array<int, kBuckets> buckets = { { 0 } };
+		crl::time total = 0;
+		crl::time max = 0;
+		int count = 0;
+	};
+	struct Entry {
+		Histogram latency;
+		crl::time delayedTotal = 0;
+		int failed = 0;
+		int retries = 0;
+		int floods = 0;
+	};
+	struct Pending {
+		crl::time sent = 0;
+		ShiftedDcId shiftedDcId = 0;
+		mtpTypeId method = 0;
+		bool failed = false;
+	};
+	struct Queue {
+		int current = 0;
+		int max = 0;
+	};
+
+	[[nodiscard]] Entry *entry(const Pending &pending);
+
+	base::flat_map<mtpRequestId, Pending> _pending;
+	base::flat_map<std::pair<ShiftedDcId, mtpTypeId>, Entry> _entries;
+	base::flat_map<ShiftedDcId, Queue> _queues;
+	crl::time _enabledAt = 0;
+	bool _enabled = false;
+
+};
+
+} // namespace MTP::details
@@ -12,6 +12,10 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 namespace MTP::details {
 namespace {
 
+// Up to 3 alignment ints, 4 more if the padding is shorter than 12 bytes
+// and 15 * 4 random ints, see CountPaddingPrimesCount.
+constexpr auto kMaxPaddingPrimes = uint32(3 + 4 + (0x0F << 2));
+
 uint32 CountPaddingPrimesCount(
 		uint32 requestSize,
 		bool forAuthKeyInner) {
@@ -46,8 +50,10 @@ SerializedRequest SerializedRequest::Prepare(
 
 	const auto finalSize = std::max(size, reserveSize);
 
+	// Reserve the padding as well, so that addPadding() before sending
+	// doesn't reallocate and copy the whole request, like a file part.
 	auto result = SerializedRequest(RequestConstructHider::Tag{});
-	result->reserve(kMessageBodyPosition + finalSize);
+	result->reserve(kMessageBodyPosition + finalSize + kMaxPaddingPrimes);
 	result->resize(kMessageBodyPosition);
 	result->back() = (size << 2);
 	result->lastSentTime = crl::now();
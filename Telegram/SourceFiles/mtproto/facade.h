@@ -113,6 +113,13 @@ inline ShiftedDcId destroyKeyNextDcId(ShiftedDcId shiftedDcId) {
 	return ShiftDcId(BareDcId(shiftedDcId), shift ? (shift + 1) : kDestroyKeyStartDcShift);
 }
 
+// Send latency budgets for request(...).afterDelay(...).
+// Requests the user is not waiting on are held for a moment so that
+// they share one container with whatever the session sends next.
+// Interactive requests are sent without a delay and flush the held ones.
+inline constexpr auto kBackgroundRequestDelay = crl::time(20);
+inline constexpr auto kIdleRequestDelay = crl::time(200);
+
 enum {
 	DisconnectedState = 0,
 	ConnectingState = 1,
@@ -8,6 +8,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "mtproto/mtp_instance.h"
 
 #include "mtproto/details/mtproto_dcenter.h"
+#include "mtproto/details/mtproto_request_stats.h"
 #include "mtproto/details/mtproto_rsa_public_key.h"
 #include "mtproto/special_config_request.h"
 #include "mtproto/session.h"
@@ -95,6 +96,10 @@ public:
 	void badConfigurationError();
 	void syncHttpUnixtime();
 
+	[[nodiscard]] bool requestStatsEnabled() const;
+	void setRequestStatsEnabled(bool enabled);
+	[[nodiscard]] QString requestStatsDump() const;
+
 	void restartedByTimeout(ShiftedDcId shiftedDcId);
 	[[nodiscard]] rpl::producer<ShiftedDcId> restartsByTimeout() const;
 
@@ -287,6 +292,8 @@ private:
 
 	rpl::event_stream<mtpRequestId> _nonPremiumDelayedRequests;
 
+	details::RequestStats _requestStats;
+
 	base::Timer _checkDelayedTimer;
 
 	Core::SettingsProxy &_proxySettings;
@@ -549,6 +556,18 @@ void Instance::Private::syncHttpUnixtime() {
 	}, isTestMode(), configValues().txtDomainString);
 }
 
+bool Instance::Private::requestStatsEnabled() const {
+	return _requestStats.enabled();
+}
+
+void Instance::Private::setRequestStatsEnabled(bool enabled) {
+	_requestStats.setEnabled(enabled);
+}
+
+QString Instance::Private::requestStatsDump() const {
+	return _requestStats.dump();
+}
+
 void Instance::Private::restartedByTimeout(ShiftedDcId shiftedDcId) {
 	_restartsByTimeout.fire_copy(shiftedDcId);
 }
@@ -1023,6 +1042,14 @@ void Instance::Private::sendRequest(
 	request->lastSentTime = crl::now();
 	request->needsLayer = needsLayer;
 
+	if (_requestStats.enabled()) {
+		const auto method = (request->size()
+			> SerializedRequest::kMessageBodyPosition)
+			? mtpTypeId((*request)[SerializedRequest::kMessageBodyPosition])
+			: mtpTypeId(0);
+		_requestStats.sent(requestId, realShiftedDcId, method);
+	}
+
 	if (afterRequestId) {
 		request->after = getRequest(afterRequestId);
 
@@ -1053,6 +1080,7 @@ void Instance::Private::unregisterRequest(mtpRequestId requestId) {
 	DEBUG_LOG(("MTP Info: unregistering request %1.").arg(requestId));
 
 	_requestsDelays.erase(requestId);
+	_requestStats.finished(requestId);
 
 	{
 		QWriteLocker locker(&_requestMapLock);
@@ -1158,6 +1186,7 @@ void Instance::Private::processCallback(const Response &response) {
 					error.description()));
 			const auto guard = QPointer<Instance>(_instance);
 			if (rpcErrorOccured(response, handler, error) && guard) {
+				_requestStats.failed(requestId);
 				unregisterRequest(requestId);
 			} else if (guard) {
 				QMutexLocker locker(&_parserMapLock);
@@ -1441,6 +1470,7 @@ bool Instance::Private::onErrorDefault(
 		registerRequest(
 			requestId,
 			(dcWithShift < 0) ? -newdcWithShift : newdcWithShift);
+		_requestStats.retried(requestId);
 		session->sendPrepared(request);
 		return true;
 	} else if (type == u"MSG_WAIT_TIMEOUT"_q || type == u"MSG_WAIT_FAILED"_q) {
@@ -1475,6 +1505,7 @@ bool Instance::Private::onErrorDefault(
 			return false;
 		}
 
+		_requestStats.retried(requestId);
 		if (!request->after) {
 			getSession(qAbs(dcWithShift))->sendPrepared(request);
 		} else {
@@ -1510,6 +1541,10 @@ bool Instance::Private::onErrorDefault(
 		} else if (m3.hasMatch()) {
 			secs = m3.captured(1).toInt();
 		}
+		_requestStats.delayed(
+			requestId,
+			secs * crl::time(1000),
+			(code >= 0 && code < 500));
 		auto sendAt = crl::now() + secs * 1000 + 10;
 		auto it = _delayedRequests.begin(), e = _delayedRequests.end();
 		for (; it != e; ++it) {
@@ -1565,6 +1600,7 @@ bool Instance::Private::onErrorDefault(
 		}
 		waiters.push_back(requestId);
 		if (badGuestDc) _badGuestDcRequests.insert(requestId);
+		_requestStats.retried(requestId);
 		return true;
 	} else if (type == u"CONNECTION_NOT_INITED"_q
 		|| type == u"CONNECTION_LAYER_INVALID"_q) {
@@ -1589,6 +1625,7 @@ bool Instance::Private::onErrorDefault(
 		const auto session = getSession(qAbs(dcWithShift));
 		request->needsLayer = true;
 		session->setConnectionNotInited();
+		_requestStats.retried(requestId);
 		session->sendPrepared(request);
 		return true;
 	} else if (type == u"CONNECTION_LANG_CODE_INVALID"_q) {
@@ -1908,6 +1945,18 @@ void Instance::syncHttpUnixtime() {
 	_private->syncHttpUnixtime();
 }
 
+bool Instance::requestStatsEnabled() const {
+	return _private->requestStatsEnabled();
+}
+
+void Instance::setRequestStatsEnabled(bool enabled) {
+	_private->setRequestStatsEnabled(enabled);
+}
+
+QString Instance::requestStatsDump() const {
+	return _private->requestStatsDump();
+}
+
 void Instance::restartedByTimeout(ShiftedDcId shiftedDcId) {
 	_private->restartedByTimeout(shiftedDcId);
 }
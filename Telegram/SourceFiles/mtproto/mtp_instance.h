@@ -137,6 +137,11 @@ public:
 	void setUserPhone(const QString &phone);
 	void badConfigurationError();
 
+	// Opt-in per dc and per method request latency statistics.
+	[[nodiscard]] bool requestStatsEnabled() const;
+	void setRequestStatsEnabled(bool enabled);
+	[[nodiscard]] QString requestStatsDump() const;
+
 	void restartedByTimeout(ShiftedDcId shiftedDcId);
 	[[nodiscard]] rpl::producer<ShiftedDcId> restartsByTimeout() const;
 
@@ -11,6 +11,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include <QtCore/QDataStream>
 
+#include <openssl/evp.h>
+
 namespace MTP {
 
 AuthKey::AuthKey(Type type, DcId dcId, const Data &data)
@@ -186,4 +188,64 @@ void aesCtrEncrypt(bytes::span data, const void *key, CTRState *state) {
 		(block128_f)AES_encrypt);
 }
 
+CTRStream::CTRStream(bytes::const_span key, bytes::const_span ivec)
+: _context(EVP_CIPHER_CTX_new()) {
+	Expects(key.size() == CTRState::KeySize);
+	Expects(ivec.size() == CTRState::IvecSize);
+
+	if (!_context) {
+		Unexpected("EVP_CIPHER_CTX_new in CTRStream.");
+	}
+	const auto result = EVP_EncryptInit_ex(
+		_context,
+		EVP_aes_256_ctr(),
+		nullptr,
+		reinterpret_cast<const uchar*>(key.data()),
+		reinterpret_cast<const uchar*>(ivec.data()));
+	if (result != 1) {
+		Unexpected("EVP_EncryptInit_ex in CTRStream.");
+	}
+}
+
+CTRStream::CTRStream(CTRStream &&other)
+: _context(base::take(other._context)) {
+}
+
+CTRStream &CTRStream::operator=(CTRStream &&other) {
+	if (this != &other) {
+		if (_context) {
+			EVP_CIPHER_CTX_free(_context);
+		}
+		_context = base::take(other._context);
+	}
+	return *this;
+}
+
+CTRStream::~CTRStream() {
+	if (_context) {
+		EVP_CIPHER_CTX_free(_context);
+	}
+}
+
+void CTRStream::encrypt(bytes::span data) {
+	Expects(_context != nullptr);
+	Expects(data.size() <= std::numeric_limits<int>::max());
+
+	if (data.empty()) {
+		return;
+	}
+	const auto size = int(data.size());
+	const auto buffer = reinterpret_cast<uchar*>(data.data());
+	auto written = 0;
+	const auto result = EVP_EncryptUpdate(
+		_context,
+		buffer,
+		&written,
+		buffer,
+		size);
+	if (result != 1 || written != size) {
+		Unexpected("EVP_EncryptUpdate in CTRStream.");
+	}
+}
+
 } // namespace MTP
@@ -11,6 +11,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include <array>
 #include <memory>
 
+struct evp_cipher_ctx_st;
+
 namespace MTP {
 
 class AuthKey {
@@ -122,4 +124,28 @@ struct CTRState {
 };
 void aesCtrEncrypt(bytes::span data, const void *key, CTRState *state);
 
+// Keeps the expanded key and the counter between calls, so a stream
+// is not re-keyed for every chunk. Goes through EVP, this way OpenSSL
+// picks AES-NI / VAES / ARMv8 crypto extensions at runtime and uses its
+// multi-block CTR code where available.
+class CTRStream final {
+public:
+	CTRStream() = default;
+	CTRStream(bytes::const_span key, bytes::const_span ivec);
+	CTRStream(CTRStream &&other);
+	CTRStream &operator=(CTRStream &&other);
+	~CTRStream();
+
+	// ctr used inplace, encrypt the data and leave it at the same place
+	void encrypt(bytes::span data);
+
+	[[nodiscard]] explicit operator bool() const {
+		return (_context != nullptr);
+	}
+
+private:
+	evp_cipher_ctx_st *_context = nullptr;
+
+};
+
 } // namespace MTP
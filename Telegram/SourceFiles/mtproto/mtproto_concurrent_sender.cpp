@@ -13,6 +13,11 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 namespace MTP {
 
+struct ConcurrentSender::PendingMethods {
+	QMutex mutex;
+	std::vector<InstanceMethod> list;
+};
+
 class ConcurrentSender::HandlerMaker final {
 public:
 	static DoneHandler MakeDone(
@@ -69,15 +74,23 @@ FailHandler ConcurrentSender::HandlerMaker::MakeFail(
 	};
 }
 
-template <typename Method>
-auto ConcurrentSender::with_instance(Method &&method)
--> std::enable_if_t<is_callable_v<Method, not_null<Instance*>>> {
-	crl::on_main([
-		weak = _weak,
-		method = std::forward<Method>(method)
-	]() mutable {
+void ConcurrentSender::with_instance(InstanceMethod &&method) {
+	auto lock = QMutexLocker(&_pending->mutex);
+	_pending->list.push_back(std::move(method));
+	if (_pending->list.size() > 1) {
+		return;
+	}
+	lock.unlock();
+
+	crl::on_main([weak = _weak, pending = _pending] {
+		auto list = [&] {
+			QMutexLocker lock(&pending->mutex);
+			return base::take(pending->list);
+		}();
 		if (const auto instance = weak.data()) {
-			std::move(method)(instance);
+			for (auto &method : list) {
+				std::move(method)(instance);
+			}
 		}
 	});
 }
@@ -139,7 +152,8 @@ ConcurrentSender::ConcurrentSender(
 	QPointer<Instance> weak,
 	Fn<void(FnMut<void()>)> runner)
 : _weak(weak)
-, _runner(runner) {
+, _runner(runner)
+, _pending(std::make_shared<PendingMethods>()) {
 }
 
 ConcurrentSender::~ConcurrentSender() {
@@ -182,7 +196,8 @@ void ConcurrentSender::senderRequestCancel(mtpRequestId requestId) {
 }
 
 void ConcurrentSender::senderRequestCancelAll() {
-	auto list = std::vector<mtpRequestId>(_requests.size());
+	auto list = std::vector<mtpRequestId>();
+	list.reserve(_requests.size());
 	for (const auto &pair : base::take(_requests)) {
 		list.push_back(pair.first);
 	}
@@ -26,14 +26,15 @@ namespace MTP {
 class Error;
 class Instance;
 
+// Responses are parsed and handled by the runner, only the request
+// bookkeeping in the Instance is done on the main thread. All the sends
+// and cancels made before the main thread gets to them are passed there
+// in a single call, so bulk users don't flood the main event loop.
 class ConcurrentSender : public base::has_weak_ptr {
-	template <typename ...Args>
-	static constexpr bool is_callable_v
-		= rpl::details::is_callable_v<Args...>;
+	struct PendingMethods;
+	using InstanceMethod = FnMut<void(not_null<Instance*>)>;
 
-	template <typename Method>
-	auto with_instance(Method &&method)
-	-> std::enable_if_t<is_callable_v<Method, not_null<Instance*>>>;
+	void with_instance(InstanceMethod &&method);
 
 	struct Handlers {
 		FnMut<bool(mtpRequestId requestId, bytes::const_span result)> done;
@@ -186,6 +187,7 @@ private:
 
 	const QPointer<Instance> _weak;
 	const Fn<void(FnMut<void()>)> _runner;
+	const std::shared_ptr<PendingMethods> _pending;
 	base::flat_map<mtpRequestId, Handlers> _requests;
 
 };
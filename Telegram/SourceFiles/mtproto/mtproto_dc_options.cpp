@@ -11,6 +11,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "mtproto/facade.h"
 #include "mtproto/connection_tcp.h"
 #include "storage/serialize_common.h"
+#include "base/unixtime.h"
 
 #include <QtCore/QFile>
 #include <QtCore/QRegularExpression>
@@ -18,7 +19,11 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 namespace MTP {
 namespace {
 
-constexpr auto kVersion = 2;
+constexpr auto kVersion = 3;
+
+constexpr auto kConnectHistoryLifetime = 30 * TimeId(86400);
+constexpr auto kFastConnectLatency = crl::time(300);
+constexpr auto kFailuresToDemote = 2;
 
 using namespace details;
 
@@ -127,6 +132,8 @@ DcOptions::DcOptions(const DcOptions &other)
 , _publicKeys(other._publicKeys)
 , _cdnPublicKeys(other._cdnPublicKeys)
 , _immutable(other._immutable) {
+	QMutexLocker lock(&other._connectHistoryMutex);
+	_connectHistory = other._connectHistory;
 }
 
 DcOptions::~DcOptions() = default;
@@ -438,6 +445,26 @@ QByteArray DcOptions::serialize() const {
 		}
 	}
 
+	// Connect history.
+	auto history = std::vector<std::pair<ConnectPath, ConnectStats>>();
+	{
+		QMutexLocker historyLock(&_connectHistoryMutex);
+		const auto old = base::unixtime::now() - kConnectHistoryLifetime;
+		history.reserve(_connectHistory.size());
+		for (const auto &[path, stats] : _connectHistory) {
+			if (stats.used > old) {
+				history.emplace_back(path, stats);
+			}
+		}
+	}
+	size += sizeof(qint32);
+	for (const auto &[path, stats] : history) {
+		// dcId + port + protocol + latency + successes + failures + used
+		size += 7 * sizeof(qint32);
+		size += sizeof(qint32) + path.ip.size();
+		size += sizeof(qint32) + path.proxy.size();
+	}
+
 	auto result = QByteArray();
 	result.reserve(size);
 	{
@@ -471,6 +498,21 @@ QByteArray DcOptions::serialize() const {
 				<< Serialize::bytes(key.n)
 				<< Serialize::bytes(key.e);
 		}
+
+		// Connect history.
+		stream << qint32(history.size());
+		for (const auto &[path, stats] : history) {
+			const auto latency = std::min(stats.latency, crl::time(1) << 30);
+			stream << qint32(path.dcId)
+				<< QByteArray::fromStdString(path.ip)
+				<< qint32(path.port)
+				<< qint32(path.protocol)
+				<< QByteArray::fromStdString(path.proxy)
+				<< qint32(latency)
+				<< qint32(stats.successes)
+				<< qint32(stats.failures)
+				<< qint32(stats.used);
+		}
 	}
 	return result;
 }
@@ -566,6 +608,53 @@ bool DcOptions::constructFromSerialized(const QByteArray &serialized) {
 			}
 		}
 	}
+
+	// Read connect history
+	if (!stream.atEnd() && version > 2) {
+		auto count = qint32(0);
+		stream >> count;
+		if (stream.status() != QDataStream::Ok) {
+			LOG(("MTP Error: Bad data for connect history in DcOptions::constructFromSerialized()"));
+			return false;
+		}
+
+		auto history = base::flat_map<ConnectPath, ConnectStats>();
+		for (auto i = 0; i != count; ++i) {
+			qint32 dcId = 0, port = 0, protocol = 0;
+			qint32 latency = 0, successes = 0, failures = 0, used = 0;
+			QByteArray ip, proxy;
+			stream
+				>> dcId
+				>> ip
+				>> port
+				>> protocol
+				>> proxy
+				>> latency
+				>> successes
+				>> failures
+				>> used;
+			if (stream.status() != QDataStream::Ok
+				|| protocol < 0
+				|| protocol >= Variants::ProtocolCount) {
+				LOG(("MTP Error: Bad data for connect history inside DcOptions::constructFromSerialized()"));
+				return false;
+			}
+			history.emplace(ConnectPath{
+				.dcId = DcId(dcId),
+				.ip = ip.toStdString(),
+				.port = port,
+				.protocol = Variants::Protocol(protocol),
+				.proxy = proxy.toStdString(),
+			}, ConnectStats{
+				.latency = latency,
+				.successes = successes,
+				.failures = failures,
+				.used = used,
+			});
+		}
+		QMutexLocker historyLock(&_connectHistoryMutex);
+		_connectHistory = std::move(history);
+	}
 	return true;
 }
 
@@ -699,6 +788,38 @@ auto DcOptions::lookup(
 	return result;
 }
 
+void DcOptions::recordConnectResult(
+		const ConnectPath &path,
+		crl::time latency) {
+	QMutexLocker lock(&_connectHistoryMutex);
+	auto &stats = _connectHistory[path];
+	stats.used = base::unixtime::now();
+	if (latency < 0) {
+		++stats.failures;
+		return;
+	}
+	stats.latency = stats.successes
+		? ((stats.latency * 3 + latency) / 4)
+		: latency;
+	++stats.successes;
+	stats.failures = 0;
+}
+
+int DcOptions::connectRank(const ConnectPath &path) const {
+	QMutexLocker lock(&_connectHistoryMutex);
+	const auto i = _connectHistory.find(path);
+	if (i == end(_connectHistory)) {
+		return 0;
+	}
+	const auto &stats = i->second;
+	if (stats.failures >= kFailuresToDemote) {
+		return -1;
+	} else if (!stats.successes) {
+		return 0;
+	}
+	return (stats.latency <= kFastConnectLatency) ? 2 : 1;
+}
+
 bool DcOptions::hasMediaOnlyOptionsFor(DcId dcId) const {
 	ReadLocker lock(this);
 	const auto i = _data.find(dcId);
@@ -10,6 +10,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "base/bytes.h"
 
 #include <QtCore/QReadWriteLock>
+#include <QtCore/QMutex>
 #include <string>
 #include <vector>
 #include <map>
@@ -105,6 +106,28 @@ public:
 		bool throughProxy) const;
 	[[nodiscard]] DcType dcType(ShiftedDcId shiftedDcId) const;
 
+	struct ConnectPath {
+		DcId dcId = 0;
+		std::string ip;
+		int port = 0;
+		Variants::Protocol protocol = Variants::Tcp;
+		std::string proxy; // host:port, empty for direct connections.
+
+		friend inline bool operator<(
+				const ConnectPath &a,
+				const ConnectPath &b) {
+			return std::tie(a.dcId, a.ip, a.port, a.protocol, a.proxy)
+				< std::tie(b.dcId, b.ip, b.port, b.protocol, b.proxy);
+		}
+	};
+
+	// Connect results of the test connections are saved with the options
+	// so that the next race prefers the paths that connected quickly
+	// before and doesn't wait for the ones that keep failing.
+	// Thread-safe, latency is -1 for a failed connect.
+	void recordConnectResult(const ConnectPath &path, crl::time latency);
+	[[nodiscard]] int connectRank(const ConnectPath &path) const;
+
 	void setCDNConfig(const MTPDcdnConfig &config);
 	[[nodiscard]] bool hasCDNKeysForDc(DcId dcId) const;
 	[[nodiscard]] details::RSAPublicKey getDcRSAKey(
@@ -134,6 +157,13 @@ private:
 		const base::flat_map<DcId, std::vector<Endpoint>> &b);
 	static void FilterIfHasWithFlag(Variants &variants, Flag flag);
 
+	struct ConnectStats {
+		crl::time latency = 0;
+		int successes = 0;
+		int failures = 0;
+		TimeId used = 0;
+	};
+
 	[[nodiscard]] bool hasMediaOnlyOptionsFor(DcId dcId) const;
 
 	void processFromList(const QVector<MTPDcOption> &options, bool overwrite);
@@ -156,6 +186,9 @@ private:
 		base::flat_map<uint64, details::RSAPublicKey>> _cdnPublicKeys;
 	mutable QReadWriteLock _useThroughLockers;
 
+	base::flat_map<ConnectPath, ConnectStats> _connectHistory;
+	mutable QMutex _connectHistoryMutex;
+
 	rpl::event_stream<DcId> _changed;
 	rpl::event_stream<> _cdnConfigChanged;
 
@@ -10,12 +10,28 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "mtproto/details/mtproto_dcenter.h"
 #include "mtproto/session_private.h"
 #include "mtproto/mtproto_auth_key.h"
+#include "mtproto/facade.h"
 #include "core/application.h"
 #include "core/core_settings.h"
 #include "base/unixtime.h"
 
 namespace MTP {
 namespace details {
+namespace {
+
+constexpr auto kMediaProxyConnectTimeout = 15 * crl::time(1000);
+constexpr auto kMediaProxyRetryTimeout = 5 * 60 * crl::time(1000);
+
+[[nodiscard]] int MediaSessionIndex(ShiftedDcId shiftedDcId) {
+	if (isDownloadDcId(shiftedDcId)) {
+		return GetDcIdShift(shiftedDcId) - kBaseDownloadDcShift;
+	} else if (isUploadDcId(shiftedDcId)) {
+		return GetDcIdShift(shiftedDcId) - kBaseUploadDcShift;
+	}
+	return -1;
+}
+
+} // namespace
 
 SessionOptions::SessionOptions(
 	const QString &systemLangCode,
@@ -161,7 +177,8 @@ Session::Session(
 , _dc(dc)
 , _data(std::make_shared<SessionData>(this))
 , _thread(thread)
-, _sender([=] { needToResumeAndSend(); }) {
+, _sender([=] { needToResumeAndSend(); })
+, _mediaProxyFailover([=] { mediaProxyFailed(); }) {
 	refreshOptions();
 	watchDcKeyChanges();
 	watchDcOptionsChanges();
@@ -238,8 +255,17 @@ void Session::restart() {
 
 void Session::refreshOptions() {
 	auto &settings = Core::App().settings().proxy();
-	const auto &proxy = settings.selected();
 	const auto isEnabled = settings.isEnabled();
+	const auto mediaIndex = MediaSessionIndex(_shiftedDcId);
+	const auto proxy = (isEnabled
+		&& mediaIndex > 0
+		&& crl::now() >= _mediaProxyFailedUntil)
+		? settings.selectedForMedia(mediaIndex)
+		: settings.selected();
+	_usingMediaProxy = isEnabled && (proxy != settings.selected());
+	if (!_usingMediaProxy) {
+		_mediaProxyFailover.cancel();
+	}
 	const auto proxyType = (isEnabled ? proxy.type : ProxyData::Type::None);
 	const auto useTcp = (proxyType != ProxyData::Type::Http);
 	const auto useHttp = (proxyType != ProxyData::Type::Mtproto);
@@ -341,9 +367,25 @@ void Session::needToResumeAndSend() {
 }
 
 void Session::connectionStateChange(int newState) {
+	if (!_usingMediaProxy || newState == ConnectedState) {
+		_mediaProxyFailover.cancel();
+	} else if (newState == ConnectingState
+		&& !_mediaProxyFailover.isActive()) {
+		_mediaProxyFailover.callOnce(kMediaProxyConnectTimeout);
+	}
 	_instance->onStateChange(_shiftedDcId, newState);
 }
 
+void Session::mediaProxyFailed() {
+	if (_killed || !_usingMediaProxy) {
+		return;
+	}
+	LOG(("MTP Info: session %1 could not connect through its proxy, "
+		"using the selected one.").arg(_shiftedDcId));
+	_mediaProxyFailedUntil = crl::now() + kMediaProxyRetryTimeout;
+	restart();
+}
+
 void Session::resetDone() {
 	_instance->onSessionReset(_shiftedDcId);
 }
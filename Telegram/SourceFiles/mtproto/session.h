@@ -188,6 +188,7 @@ private:
 	void watchDcOptionsChanges();
 
 	void killConnection();
+	void mediaProxyFailed();
 
 	[[nodiscard]] bool releaseGenericKeyCreationOnDone(
 		const AuthKeyPtr &temporaryKey,
@@ -214,6 +215,10 @@ private:
 
 	base::Timer _sender;
 
+	base::Timer _mediaProxyFailover;
+	crl::time _mediaProxyFailedUntil = 0;
+	bool _usingMediaProxy = false;
+
 	rpl::lifetime _lifetime;
 
 };
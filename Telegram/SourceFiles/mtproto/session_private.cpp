@@ -35,11 +35,14 @@ constexpr auto kMaxConnectedTimeout = crl::time(8000);
 constexpr auto kMinReceiveTimeout = crl::time(4000);
 constexpr auto kMaxReceiveTimeout = crl::time(64000);
 constexpr auto kMarkConnectionOldTimeout = crl::time(192000);
+constexpr auto kConnectRankWeight = 4;
 constexpr auto kPingDelayDisconnect = 60;
 constexpr auto kPingSendAfter = 30 * crl::time(1000);
 constexpr auto kPingSendAfterForce = 45 * crl::time(1000);
 constexpr auto kTemporaryExpiresIn = TimeId(86400);
 constexpr auto kBindKeyAdditionalExpiresTimeout = TimeId(30);
+constexpr auto kRenewTemporaryKeyBefore = TimeId(600);
+constexpr auto kRenewTemporaryKeyRetryTimeout = 60 * crl::time(1000);
 constexpr auto kKeyOldEnoughForDestroy = 60 * crl::time(1000);
 constexpr auto kSentContainerLives = 600 * crl::time(1000);
 constexpr auto kFastRequestDuration = crl::time(500);
@@ -66,6 +69,12 @@ auto SyncTimeRequestDuration = kFastRequestDuration;
 
 using namespace details;
 
+[[nodiscard]] std::string ConnectPathProxy(const ProxyData &proxy) {
+	return (proxy.type == ProxyData::Type::None)
+		? std::string()
+		: u"%1:%2"_q.arg(proxy.host).arg(proxy.port).toStdString();
+}
+
 [[nodiscard]] QString LogIdsVector(const QVector<MTPlong> &ids) {
 	if (!ids.size()) return "[]";
 	auto idsStr = QString("[%1").arg(ids.cbegin()->v);
@@ -161,6 +170,7 @@ SessionPrivate::SessionPrivate(
 , _pingSender(thread, [=] { sendPingByTimer(); })
 , _checkSentRequestsTimer(thread, [=] { checkSentRequests(); })
 , _clearOldContainersTimer(thread, [=] { clearOldContainers(); })
+, _renewTemporaryKeyTimer(thread, [=] { renewTemporaryKey(); })
 , _sessionData(std::move(data)) {
 	Expects(_shiftedDcId != 0);
 
@@ -187,17 +197,32 @@ void SessionPrivate::appendTestConnection(
 		const bytes::vector &protocolSecret) {
 	QWriteLocker lock(&_stateMutex);
 
-	const auto priority = (qthelp::is_ipv6(ip) ? 0 : 1)
+	auto path = DcOptions::ConnectPath{
+		.dcId = BareDcId(_shiftedDcId),
+		.ip = ip.toStdString(),
+		.port = port,
+		.protocol = protocol,
+		.proxy = ConnectPathProxy(_options->proxy),
+	};
+
+	// Paths that connected fast before outrank the static order below.
+	const auto rank = ip.isEmpty()
+		? 0
+		: _instance->dcOptions().connectRank(path);
+	const auto priority = kConnectRankWeight * rank
+		+ (qthelp::is_ipv6(ip) ? 0 : 1)
 		+ (protocol == DcOptions::Variants::Tcp ? 1 : 0)
 		+ (protocolSecret.empty() ? 0 : 1);
 	_testConnections.push_back({
-		AbstractConnection::Create(
+		.data = AbstractConnection::Create(
 			_instance,
 			protocol,
 			thread(),
 			protocolSecret,
 			_options->proxy),
-		priority
+		.priority = priority,
+		.path = std::move(path),
+		.started = crl::now(),
 	});
 	const auto weak = _testConnections.back().data.get();
 	connect(weak, &AbstractConnection::error, [=](int errorCode) {
@@ -1241,7 +1266,8 @@ void SessionPrivate::waitBetterFailed() {
 }
 
 void SessionPrivate::connectingTimedOut() {
-	for (const auto &connection : _testConnections) {
+	for (auto &connection : _testConnections) {
+		recordConnectResult(connection, false);
 		connection.data->timedOut();
 	}
 	doDisconnect();
@@ -1272,7 +1298,9 @@ void SessionPrivate::handleReceived() {
 		constexpr auto kMinimalEncryptedIntsCount = kEncryptedHeaderIntsCount + 4U; // + 1 data + 3 padding
 		constexpr auto kMinimalIntsCount = kExternalHeaderIntsCount + kMinimalEncryptedIntsCount;
 		auto intsCount = uint32(intsBuffer.size());
-		auto ints = intsBuffer.constData();
+
+		// The packet buffer is owned here, so decrypt it in place.
+		auto ints = intsBuffer.data();
 		if ((intsCount < kMinimalIntsCount) || (intsCount > kMaxMessageLength / kIntSize)) {
 			LOG(("TCP Error: bad message received, len %1").arg(intsCount * kIntSize));
 			return restart();
@@ -1288,12 +1316,11 @@ void SessionPrivate::handleReceived() {
 		auto encryptedInts = ints + kExternalHeaderIntsCount;
 		auto encryptedIntsCount = (intsCount - kExternalHeaderIntsCount) & ~0x03U;
 		auto encryptedBytesCount = encryptedIntsCount * kIntSize;
-		auto decryptedBuffer = QByteArray(encryptedBytesCount, Qt::Uninitialized);
 		auto msgKey = *(MTPint128*)(ints + 2);
 
-		aesIgeDecrypt(encryptedInts, decryptedBuffer.data(), encryptedBytesCount, _encryptionKey, msgKey);
+		aesIgeDecrypt(encryptedInts, encryptedInts, encryptedBytesCount, _encryptionKey, msgKey);
 
-		auto decryptedInts = reinterpret_cast<const mtpPrime*>(decryptedBuffer.constData());
+		auto decryptedInts = static_cast<const mtpPrime*>(encryptedInts);
 		auto serverSalt = *(uint64*)&decryptedInts[0];
 		auto session = *(uint64*)&decryptedInts[2];
 		auto msgId = *(uint64*)&decryptedInts[4];
@@ -2311,18 +2338,26 @@ void SessionPrivate::onConnected(
 		connection.get(),
 		[](const TestConnection &test) { return test.data.get(); });
 	Assert(i != end(_testConnections));
+	recordConnectResult(*i, true);
 	const auto my = i->priority;
 	const auto j = ranges::find_if(
 		_testConnections,
 		[&](const TestConnection &test) { return test.priority > my; });
-	if (j != end(_testConnections)) {
+
+	// After a reconnect don't wait for a better connection if this one
+	// is as good as the one that won the previous race in this session.
+	const auto goodEnough = (_connectedPriority >= 0)
+		&& (my >= _connectedPriority);
+	if (j != end(_testConnections) && !goodEnough) {
 		DEBUG_LOG(("MTP Info: connection %1 succeed, waiting for %2.").arg(
 			i->data->tag(),
 			j->data->tag()));
 		_waitForBetterTimer.callOnce(kWaitForBetterTimeout);
 	} else {
-		DEBUG_LOG(("MTP Info: connection through IPv4 succeed."));
+		DEBUG_LOG(("MTP Info: connection %1 succeed, using it."
+			).arg(i->data->tag()));
 		_waitForBetterTimer.cancel();
+		_connectedPriority = my;
 		_connection = std::move(i->data);
 		_testConnections.clear();
 		checkAuthKey();
@@ -2331,6 +2366,7 @@ void SessionPrivate::onConnected(
 
 void SessionPrivate::onDisconnected(
 		not_null<AbstractConnection*> connection) {
+	recordConnectFailed(connection);
 	removeTestConnection(connection);
 
 	if (_testConnections.empty()) {
@@ -2359,6 +2395,7 @@ void SessionPrivate::confirmBestConnection() {
 	DEBUG_LOG(("MTP Info: can't connect through better, using %1."
 		).arg(i->data->tag()));
 
+	_connectedPriority = i->priority;
 	_connection = std::move(i->data);
 	_testConnections.clear();
 
@@ -2375,6 +2412,30 @@ void SessionPrivate::removeTestConnection(
 		end(_testConnections));
 }
 
+void SessionPrivate::recordConnectResult(
+		TestConnection &test,
+		bool connected) {
+	if (test.reported || test.path.ip.empty()) {
+		// MTProto proxy connections don't use the dc options.
+		return;
+	}
+	test.reported = true;
+	_instance->dcOptions().recordConnectResult(
+		test.path,
+		connected ? (crl::now() - test.started) : crl::time(-1));
+}
+
+void SessionPrivate::recordConnectFailed(
+		not_null<AbstractConnection*> connection) {
+	const auto i = ranges::find(
+		_testConnections,
+		connection.get(),
+		[](const TestConnection &test) { return test.data.get(); });
+	if (i != end(_testConnections)) {
+		recordConnectResult(*i, false);
+	}
+}
+
 void SessionPrivate::checkAuthKey() {
 	if (_keyId) {
 		authKeyChecked();
@@ -2581,6 +2642,7 @@ void SessionPrivate::authKeyChecked() {
 	if (_sessionSalt && setState(ConnectedState)) {
 		resendAll();
 	} // else receive salt in bad_server_salt first, then try to send all the requests
+	scheduleTemporaryKeyRenewal();
 
 	_pingIdToSend = base::RandomValue<uint64>(); // get server_salt
 	_sessionData->queueNeedToResumeAndSend();
@@ -2597,6 +2659,7 @@ void SessionPrivate::onError(
 			instance->badConfigurationError();
 		});
 	}
+	recordConnectFailed(connection);
 	removeTestConnection(connection);
 
 	if (_testConnections.empty()) {
@@ -2633,6 +2696,43 @@ void SessionPrivate::destroyTemporaryKey() {
 	restart();
 }
 
+void SessionPrivate::scheduleTemporaryKeyRenewal() {
+	const auto expiresAt = _encryptionKey
+		? _encryptionKey->expiresAt()
+		: TimeId(0);
+	if (!expiresAt || _instance->isKeysDestroyer()) {
+		_renewTemporaryKeyTimer.cancel();
+		return;
+	}
+	const auto left = expiresAt
+		- kRenewTemporaryKeyBefore
+		- base::unixtime::now();
+	_renewTemporaryKeyTimer.callOnce(std::max(left, 0) * crl::time(1000));
+}
+
+void SessionPrivate::renewTemporaryKey() {
+	if (!_encryptionKey
+		|| !_encryptionKey->expiresAt()
+		|| _keyCreator
+		|| _instance->isKeysDestroyer()) {
+		return;
+	}
+	{
+		// Renew only when nothing waits for a response, so that
+		// a running download is not interrupted.
+		QReadLocker locker(_sessionData->haveSentMutex());
+		if (!_sessionData->haveSentMap().empty()) {
+			_renewTemporaryKeyTimer.callOnce(kRenewTemporaryKeyRetryTimeout);
+			return;
+		}
+	}
+	LOG(("MTP Info: temporary key in %1 expires soon, creating a new one."
+		).arg(_shiftedDcId));
+	_sessionData->destroyTemporaryKey(_encryptionKey->keyId());
+	applyAuthKey(nullptr);
+	restart();
+}
+
 bool SessionPrivate::sendSecureRequest(
 		SerializedRequest &&request,
 		bool needAnyResponse) {
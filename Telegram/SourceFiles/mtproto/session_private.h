@@ -56,6 +56,9 @@ private:
 	struct TestConnection {
 		ConnectionPointer data;
 		int priority = 0;
+		DcOptions::ConnectPath path;
+		crl::time started = 0;
+		bool reported = false;
 	};
 	struct SentContainer {
 		crl::time sent = 0;
@@ -96,6 +99,8 @@ private:
 
 	void confirmBestConnection();
 	void removeTestConnection(not_null<AbstractConnection*> connection);
+	void recordConnectResult(TestConnection &test, bool connected);
+	void recordConnectFailed(not_null<AbstractConnection*> connection);
 	[[nodiscard]] int16 getProtocolDcId() const;
 
 	void checkSentRequests();
@@ -166,6 +171,8 @@ private:
 	void checkAuthKey();
 	void authKeyChecked();
 	void destroyTemporaryKey();
+	void scheduleTemporaryKeyRenewal();
+	void renewTemporaryKey();
 	void clearUnboundKeyCreator();
 	void releaseKeyCreationOnFail();
 	void applyAuthKey(AuthKeyPtr &&encryptionKey);
@@ -204,6 +211,7 @@ private:
 	base::Timer _waitForConnectedTimer;
 	base::Timer _waitForReceivedTimer;
 	base::Timer _waitForBetterTimer;
+	int _connectedPriority = -1; // Priority of the last race winner.
 	crl::time _waitForReceived = 0;
 	crl::time _waitForConnected = 0;
 	crl::time _firstSentAt = -1;
@@ -215,6 +223,7 @@ private:
 	base::Timer _pingSender;
 	base::Timer _checkSentRequestsTimer;
 	base::Timer _clearOldContainersTimer;
+	base::Timer _renewTemporaryKeyTimer;
 
 	std::shared_ptr<SessionData> _sessionData;
 	std::unique_ptr<SessionOptions> _options;
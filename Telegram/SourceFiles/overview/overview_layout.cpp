@@ -68,36 +68,6 @@ constexpr auto kStoryRatio = 1.46;
 	return dimensions.width() * dimensions.height() <= kMaxInlineArea;
 }
 
-[[nodiscard]] QImage CropMediaFrame(QImage image, int width, int height) {
-	const auto ratio = style::DevicePixelRatio();
-	width *= ratio;
-	height *= ratio;
-	const auto finalize = [&](QImage result) {
-		result = result.scaled(
-			width,
-			height,
-			Qt::IgnoreAspectRatio,
-			Qt::SmoothTransformation);
-		result.setDevicePixelRatio(ratio);
-		return result;
-	};
-	if (image.width() * height == image.height() * width) {
-		if (image.width() != width) {
-			return finalize(std::move(image));
-		}
-		image.setDevicePixelRatio(ratio);
-		return image;
-	} else if (image.width() * height > image.height() * width) {
-		const auto use = (image.height() * width) / height;
-		const auto skip = (image.width() - use) / 2;
-		return finalize(image.copy(skip, 0, use, image.height()));
-	} else {
-		const auto use = (image.width() * height) / width;
-		const auto skip = (image.height() - use) / 2;
-		return finalize(image.copy(0, skip, image.width(), use));
-	}
-}
-
 } // namespace
 
 class Checkbox {
@@ -346,7 +316,9 @@ Photo::Photo(
 	}
 }
 
-Photo::~Photo() = default;
+Photo::~Photo() {
+	ThumbnailPreparer::Instance().cancel(this);
+}
 
 void Photo::initDimensions() {
 	_maxw = 2 * st::overviewPhotoMinSize;
@@ -364,26 +336,32 @@ int32 Photo::resizeGetHeight(int32 width) {
 
 void Photo::paint(Painter &p, const QRect &clip, TextSelection selection, const PaintContext *context) {
 	const auto selected = (selection == FullSelection);
-	const auto widthChanged = (_pix.width()
-		!= (_width * style::DevicePixelRatio()));
+	const auto widthChanged = (_pixKey.width != _width)
+		|| (_pixKey.ratio != style::DevicePixelRatio());
 	if (!_goodLoaded || widthChanged) {
 		ensureDataMediaCreated();
+		if (!context->scrolling) {
+			_dataMedia->wanted(Data::PhotoSize::Thumbnail, parent()->fullId());
+		}
 		const auto good = !_spoiler
 			&& (_dataMedia->loaded()
 				|| _dataMedia->image(Data::PhotoSize::Thumbnail));
 		if ((good && !_goodLoaded) || widthChanged) {
 			_goodLoaded = good;
-			_pix = QPixmap();
 			if (_goodLoaded) {
 				setPixFrom(_dataMedia->image(Data::PhotoSize::Large)
 					? _dataMedia->image(Data::PhotoSize::Large)
-					: _dataMedia->image(Data::PhotoSize::Thumbnail));
+					: _dataMedia->image(Data::PhotoSize::Thumbnail),
+					ThumbnailQuality::Good);
 			} else if (const auto small = _spoiler
 				? nullptr
 				: _dataMedia->image(Data::PhotoSize::Small)) {
-				setPixFrom(small);
+				setPixFrom(small, ThumbnailQuality::Small);
 			} else if (const auto blurred = _dataMedia->thumbnailInline()) {
-				setPixFrom(blurred);
+				setPixFrom(blurred, ThumbnailQuality::Inline);
+			} else {
+				_pixKey = ThumbnailKey();
+				_pix = QPixmap();
 			}
 		}
 	}
@@ -391,7 +369,8 @@ void Photo::paint(Painter &p, const QRect &clip, TextSelection selection, const
 	if (_pix.isNull()) {
 		p.fillRect(0, 0, _width, _height, st::overviewPhotoBg);
 	} else {
-		p.drawPixmap(0, 0, _pix);
+		// Until the new size is prepared the old one is scaled.
+		p.drawPixmap(QRect(0, 0, _width, _height), _pix);
 	}
 
 	if (_spoiler) {
@@ -420,15 +399,29 @@ void Photo::paint(Painter &p, const QRect &clip, TextSelection selection, const
 	paintCheckbox(p, { checkLeft, checkTop }, selected, context);
 }
 
-void Photo::setPixFrom(not_null<Image*> image) {
+void Photo::setPixFrom(not_null<Image*> image, ThumbnailQuality quality) {
 	Expects(_width > 0 && _height > 0);
 
-	auto img = image->original();
-	if (!_goodLoaded) {
-		img = Images::Blur(std::move(img));
+	const auto key = ThumbnailKey{
+		.id = _data->id,
+		.width = _width,
+		.height = _height,
+		.ratio = style::DevicePixelRatio(),
+		.quality = quality,
+		.blurred = !_goodLoaded,
+	};
+	if (_pixKey == key) {
+		return;
 	}
-	_pix = Ui::PixmapFromImage(
-		CropMediaFrame(std::move(img), _width, _height));
+	_pixKey = key;
+	ThumbnailPreparer::Instance().prepare(
+		key,
+		image->original(),
+		this,
+		crl::guard(this, [=](QImage result) {
+			_pix = Ui::PixmapFromImage(std::move(result));
+			delegate()->repaintItem(this);
+		}));
 
 	// In case we have inline thumbnail we can unload all images and we still
 	// won't get a blank image in the media viewer when the photo is opened.
@@ -446,13 +439,14 @@ void Photo::ensureDataMediaCreated() const {
 	if (_data->inlineThumbnailBytes().isEmpty()) {
 		_dataMedia->wanted(Data::PhotoSize::Small, parent()->fullId());
 	}
-	_dataMedia->wanted(Data::PhotoSize::Thumbnail, parent()->fullId());
 	delegate()->registerHeavyItem(this);
 }
 
 void Photo::clearSpoiler() {
 	if (_spoiler) {
 		_spoiler = nullptr;
+		ThumbnailPreparer::Instance().cancel(this);
+		_pixKey = ThumbnailKey();
 		_pix = QPixmap();
 		delegate()->repaintItem(this);
 	}
@@ -467,6 +461,9 @@ void Photo::itemDataChanged() {
 }
 
 void Photo::clearHeavyPart() {
+	if (ThumbnailPreparer::Instance().cancel(this)) {
+		_pixKey = ThumbnailKey();
+	}
 	_dataMedia = nullptr;
 }
 
@@ -496,7 +493,9 @@ Video::Video(
 	_data->loadThumbnail(parent->fullId());
 }
 
-Video::~Video() = default;
+Video::~Video() {
+	ThumbnailPreparer::Instance().cancel(this);
+}
 
 void Video::initDimensions() {
 	_maxw = 2 * st::overviewPhotoMinSize;
@@ -531,23 +530,42 @@ void Video::paint(Painter &p, const QRect &clip, TextSelection selection, const
 	const auto radial = isRadialAnimation();
 	const auto radialOpacity = radial ? _radial->opacity() : 0.;
 
+	const auto quality = good
+		? ThumbnailQuality::Good
+		: thumbnail
+		? ThumbnailQuality::Small
+		: ThumbnailQuality::Inline;
+	const auto key = ThumbnailKey{
+		.id = _data->id,
+		.width = _width,
+		.height = _height,
+		.ratio = style::DevicePixelRatio(),
+		.quality = quality,
+		.blurred = !(thumbnail || good),
+		.document = true,
+	};
+	const auto sizeChanged = (_pixKey.width != key.width)
+		|| (_pixKey.height != key.height)
+		|| (_pixKey.ratio != key.ratio);
 	if ((blurred || thumbnail || good)
-		&& ((_pix.width() != _width * style::DevicePixelRatio())
-			|| (_pixBlurred && (thumbnail || good)))) {
-		auto img = good
-			? good->original()
-			: thumbnail
-			? thumbnail->original()
-			: Images::Blur(blurred->original());
-		_pix = Ui::PixmapFromImage(
-			CropMediaFrame(std::move(img), _width, _height));
-		_pixBlurred = !(thumbnail || good);
+		&& (sizeChanged || (_pixKey.blurred && !key.blurred))) {
+		_pixKey = key;
+		const auto image = good ? good : thumbnail ? thumbnail : blurred;
+		ThumbnailPreparer::Instance().prepare(
+			key,
+			image->original(),
+			this,
+			crl::guard(this, [=](QImage result) {
+				_pix = Ui::PixmapFromImage(std::move(result));
+				delegate()->repaintItem(this);
+			}));
 	}
 
 	if (_pix.isNull()) {
 		p.fillRect(0, 0, _width, _height, st::overviewPhotoBg);
 	} else {
-		p.drawPixmap(0, 0, _pix);
+		// Until the new size is prepared the old one is scaled.
+		p.drawPixmap(QRect(0, 0, _width, _height), _pix);
 	}
 
 	if (_spoiler) {
@@ -638,6 +656,8 @@ void Video::ensureDataMediaCreated() const {
 void Video::clearSpoiler() {
 	if (_spoiler) {
 		_spoiler = nullptr;
+		ThumbnailPreparer::Instance().cancel(this);
+		_pixKey = ThumbnailKey();
 		_pix = QPixmap();
 		delegate()->repaintItem(this);
 	}
@@ -652,6 +672,9 @@ void Video::itemDataChanged() {
 }
 
 void Video::clearHeavyPart() {
+	if (ThumbnailPreparer::Instance().cancel(this)) {
+		_pixKey = ThumbnailKey();
+	}
 	_dataMedia = nullptr;
 }
 
@@ -9,6 +9,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include "layout/layout_item_base.h"
 #include "layout/layout_document_generic_preview.h"
+#include "overview/overview_layout_thumbnails.h"
 #include "media/clip/media_clip_reader.h"
 #include "core/click_handler_types.h"
 #include "ui/effects/animations.h"
@@ -47,6 +48,9 @@ public:
 	bool skipBorder = false;
 	bool paused = false;
 
+	// Fast scrolling, only the small thumbnails are requested.
+	bool scrolling = false;
+
 };
 
 class ItemBase : public LayoutItemBase, public base::has_weak_ptr {
@@ -212,7 +216,7 @@ public:
 
 private:
 	void ensureDataMediaCreated() const;
-	void setPixFrom(not_null<Image*> image);
+	void setPixFrom(not_null<Image*> image, ThumbnailQuality quality);
 	void clearSpoiler();
 
 	const not_null<PhotoData*> _data;
@@ -221,6 +225,7 @@ private:
 	std::unique_ptr<Ui::SpoilerAnimation> _spoiler;
 
 	QPixmap _pix;
+	ThumbnailKey _pixKey;
 	bool _goodLoaded = false;
 	bool _pinned = false;
 	bool _story = false;
@@ -323,7 +328,7 @@ private:
 	std::unique_ptr<Ui::SpoilerAnimation> _spoiler;
 
 	QPixmap _pix;
-	bool _pixBlurred = true;
+	ThumbnailKey _pixKey;
 	bool _pinned = false;
 	bool _story = false;
 
@@ -0,0 +1,180 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "overview/overview_layout_thumbnails.h"
+
+#include "ui/image/image_prepare.h"
+
+#include <QtCore/QThread>
+
+namespace Overview::Layout {
+namespace {
+
+constexpr auto kMaxRunningTasks = 4;
+constexpr auto kCacheBytesLimit = int64(48 * 1024 * 1024);
+
+[[nodiscard]] int64 ComputeBytes(const QImage &image) {
+	return int64(image.bytesPerLine()) * image.height();
+}
+
+[[nodiscard]] int MaxRunningTasks() {
+	static const auto result = std::clamp(
+		QThread::idealThreadCount() / 2,
+		1,
+		kMaxRunningTasks);
+	return result;
+}
+
+} // namespace
+
+QImage CropMediaFrame(QImage image, int width, int height, int ratio) {
+	width *= ratio;
+	height *= ratio;
+	const auto finalize = [&](QImage result) {
+		result = result.scaled(
+			width,
+			height,
+			Qt::IgnoreAspectRatio,
+			Qt::SmoothTransformation);
+		result.setDevicePixelRatio(ratio);
+		return result;
+	};
+	if (image.width() * height == image.height() * width) {
+		if (image.width() != width) {
+			return finalize(std::move(image));
+		}
+		image.setDevicePixelRatio(ratio);
+		return image;
+	} else if (image.width() * height > image.height() * width) {
+		const auto use = (image.height() * width) / height;
+		const auto skip = (image.width() - use) / 2;
+		return finalize(image.copy(skip, 0, use, image.height()));
+	} else {
+		const auto use = (image.width() * height) / width;
+		const auto skip = (image.height() - use) / 2;
+		return finalize(image.copy(0, skip, image.width(), use));
+	}
+}
+
+QImage ThumbnailPreparer::lookup(const ThumbnailKey &key) {
+	const auto i = _cache.find(key);
+	if (i == end(_cache)) {
+		return QImage();
+	}
+	i->second.used = ++_useCounter;
+	return i->second.image;
+}
+
+void ThumbnailPreparer::prepare(
+		const ThumbnailKey &key,
+		QImage original,
+		not_null<const void*> requester,
+		Done done) {
+	Expects(done != nullptr);
+
+	cancel(requester);
+	if (auto cached = lookup(key); !cached.isNull()) {
+		done(std::move(cached));
+		return;
+	}
+	auto task = Task{
+		.key = key,
+		.original = std::move(original),
+		.requester = requester.get(),
+		.done = std::move(done),
+	};
+	const auto i = _running.find(key);
+	if (i != end(_running)) {
+		i->second.push_back(std::move(task));
+		return;
+	}
+	_queue.push_back(std::move(task));
+	checkNext();
+}
+
+bool ThumbnailPreparer::cancel(not_null<const void*> requester) {
+	const auto proj = &Task::requester;
+	const auto remove = [&](std::vector<Task> &tasks) {
+		const auto i = ranges::remove(tasks, requester.get(), proj);
+		const auto removed = (i != end(tasks));
+		tasks.erase(i, end(tasks));
+		return removed;
+	};
+	auto result = remove(_queue);
+	for (auto &[key, waiting] : _running) {
+		// The running work is finished anyway, the result gets cached.
+		if (remove(waiting)) {
+			result = true;
+		}
+	}
+	return result;
+}
+
+void ThumbnailPreparer::checkNext() {
+	while (!_queue.empty() && int(_running.size()) < MaxRunningTasks()) {
+		auto task = std::move(_queue.back());
+		_queue.pop_back();
+
+		const auto key = task.key;
+		auto original = base::take(task.original);
+		auto &waiting = _running[key];
+		waiting.push_back(std::move(task));
+
+		crl::async([=, original = std::move(original)]() mutable {
+			if (key.blurred) {
+				original = Images::Blur(std::move(original));
+			}
+			auto result = CropMediaFrame(
+				std::move(original),
+				key.width,
+				key.height,
+				key.ratio);
+			crl::on_main([=, result = std::move(result)]() mutable {
+				Instance().finished(key, std::move(result));
+			});
+		});
+	}
+}
+
+void ThumbnailPreparer::finished(ThumbnailKey key, QImage result) {
+	auto waiting = std::vector<Task>();
+	if (const auto i = _running.find(key); i != end(_running)) {
+		waiting = std::move(i->second);
+		_running.erase(i);
+	}
+	remember(key, result);
+	for (auto &task : waiting) {
+		task.done(result);
+	}
+	checkNext();
+}
+
+void ThumbnailPreparer::remember(const ThumbnailKey &key, QImage image) {
+	const auto bytes = ComputeBytes(image);
+	if (image.isNull() || bytes > kCacheBytesLimit / 4) {
+		return;
+	}
+	while (_cacheBytes + bytes > kCacheBytesLimit && !_cache.empty()) {
+		const auto oldest = ranges::min_element(
+			_cache,
+			ranges::less(),
+			[](const auto &pair) { return pair.second.used; });
+		_cacheBytes -= ComputeBytes(oldest->second.image);
+		_cache.erase(oldest);
+	}
+	auto &entry = _cache[key];
+	_cacheBytes += bytes - ComputeBytes(entry.image);
+	entry.image = std::move(image);
+	entry.used = ++_useCounter;
+}
+
+ThumbnailPreparer &ThumbnailPreparer::Instance() {
+	static auto result = ThumbnailPreparer();
+	return result;
+}
+
+} // namespace Overview::Layout
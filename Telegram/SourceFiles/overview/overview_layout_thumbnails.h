@@ -0,0 +1,86 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include "base/flat_map.h"
+
+namespace Overview::Layout {
+
+enum class ThumbnailQuality : uchar {
+	Inline,
+	Small,
+	Good,
+};
+
+struct ThumbnailKey {
+	uint64 id = 0;
+	int width = 0;
+	int height = 0;
+	int ratio = 0;
+	ThumbnailQuality quality = ThumbnailQuality::Inline;
+	bool blurred = false;
+	bool document = false;
+
+	friend inline auto operator<=>(
+		const ThumbnailKey &,
+		const ThumbnailKey &) = default;
+	friend inline bool operator==(
+		const ThumbnailKey &,
+		const ThumbnailKey &) = default;
+};
+
+[[nodiscard]] QImage CropMediaFrame(
+	QImage image,
+	int width,
+	int height,
+	int ratio);
+
+// Blurs, crops and scales shared media grid thumbnails on worker threads.
+// The most recently requested thumbnails are prepared first, because
+// they belong to the items that were painted last. Main thread only.
+class ThumbnailPreparer final {
+public:
+	using Done = Fn<void(QImage)>;
+
+	// Returns a null image if this size is not prepared yet.
+	[[nodiscard]] QImage lookup(const ThumbnailKey &key);
+	void prepare(
+		const ThumbnailKey &key,
+		QImage original,
+		not_null<const void*> requester,
+		Done done);
+	// Returns true if a not finished request was cancelled.
+	bool cancel(not_null<const void*> requester);
+
+	[[nodiscard]] static ThumbnailPreparer &Instance();
+
+private:
+	struct Task {
+		ThumbnailKey key;
+		QImage original;
+		const void *requester = nullptr;
+		Done done;
+	};
+	struct Cached {
+		QImage image;
+		uint64 used = 0;
+	};
+
+	void checkNext();
+	void finished(ThumbnailKey key, QImage result);
+	void remember(const ThumbnailKey &key, QImage image);
+
+	std::vector<Task> _queue;
+	base::flat_map<ThumbnailKey, std::vector<Task>> _running;
+	base::flat_map<ThumbnailKey, Cached> _cache;
+	int64 _cacheBytes = 0;
+	uint64 _useCounter = 0;
+
+};
+
+} // namespace Overview::Layout
@@ -594,7 +594,7 @@ void SetupSystemIntegrationContent(
 			return (checked != settings->closeToTaskbar());
 		}) | rpl::start_with_next([=](bool checked) {
 			settings->setCloseToTaskbar(checked);
-			Local::writeSettings();
+			Core::App().saveSettingsDelayed();
 		}, closeToTaskbar->lifetime());
 	}
 
@@ -670,7 +670,7 @@ void SetupSystemIntegrationContent(
 		}) | rpl::start_with_next([](bool checked) {
 			cSetSendToMenu(checked);
 			psSendToMenu(checked);
-			Local::writeSettings();
+			Core::App().saveSettingsDelayed();
 		}, sendto->lifetime());
 	}
 }
@@ -1451,7 +1451,7 @@ void SetupDefaultThemes(
 		auto &colors = Core::App().settings().themesAccentColors();
 		if (colors.get(type) != color) {
 			colors.set(type, color);
-			Local::writeSettings();
+			Core::App().saveSettingsDelayed();
 		}
 		apply(*scheme);
 	}, container->lifetime());
@@ -1719,6 +1719,33 @@ void SetupSupportChatsLimitSlice(
 	});
 }
 
+void SetupSupportPreloadChats(
+		not_null<Window::SessionController*> controller,
+		not_null<Ui::VerticalLayout*> container) {
+	const auto options = std::vector<std::pair<int, QString>>{
+		{ 0, "Don't preload" },
+		{ 1, "1 chat" },
+		{ 2, "2 chats" },
+		{ 3, "3 chats" },
+	};
+	const auto group = std::make_shared<Ui::RadiobuttonGroup>(
+		controller->session().settings().supportPreloadChats());
+	for (const auto &[count, label] : options) {
+		container->add(
+			object_ptr<Ui::Radiobutton>(
+				container,
+				group,
+				count,
+				label,
+				st::settingsSendType),
+			st::settingsSendTypePadding);
+	}
+	group->setChangedCallback([=](int count) {
+		controller->session().settings().setSupportPreloadChats(count);
+		controller->session().saveSettingsDelayed();
+	});
+}
+
 void SetupSupport(
 		not_null<Window::SessionController*> controller,
 		not_null<Ui::VerticalLayout*> container) {
@@ -1777,6 +1804,14 @@ void SetupSupport(
 
 	Ui::AddSkip(inner, st::settingsCheckboxesSkip);
 
+	Ui::AddSubsectionTitle(
+		inner,
+		rpl::single(u"Preload next chats in the switch direction"_q));
+
+	SetupSupportPreloadChats(controller, inner);
+
+	Ui::AddSkip(inner, st::settingsCheckboxesSkip);
+
 	Ui::AddSkip(inner);
 }
 
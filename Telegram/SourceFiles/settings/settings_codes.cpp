@@ -12,6 +12,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "mainwindow.h"
 #include "data/data_session.h"
 #include "data/data_cloud_themes.h"
+#include "data/data_memory_report.h"
+#include "data/data_synthetic_account.h"
 #include "main/main_session.h"
 #include "main/main_account.h"
 #include "main/main_domain.h"
@@ -243,6 +245,88 @@ auto GenerateCodes() {
 			});
 		});
 	});
+	codes.emplace(u"mtpstats"_q, [](SessionController *window) {
+		if (!window) {
+			return;
+		}
+		const auto weak = base::make_weak(&window->session().account());
+		const auto &mtp = window->session().account().mtp();
+		if (!mtp.requestStatsEnabled()) {
+			Ui::show(Ui::MakeConfirmBox({
+				.text = u"Do you want to collect request statistics?"_q,
+				.confirmed = [=](Fn<void()> close) {
+					if (const auto strong = weak.get()) {
+						strong->mtp().setRequestStatsEnabled(true);
+					}
+					close();
+				},
+			}));
+			return;
+		}
+		const auto dump = mtp.requestStatsDump();
+		Ui::show(Ui::MakeConfirmBox({
+			.text = dump,
+			.confirmed = [=](Fn<void()> close) {
+				LOG(("MTP Stats:\n%1").arg(dump));
+				auto f = QFile(cWorkingDir() + u"mtp_stats.txt"_q);
+				if (f.open(QIODevice::WriteOnly)
+					&& f.write(dump.toUtf8()) > 0) {
+					Ui::Toast::Show("Saved to mtp_stats.txt and log.");
+				} else {
+					Ui::Toast::Show("Could not save the stats :(");
+				}
+				close();
+			},
+			.cancelled = [=](Fn<void()> close) {
+				if (const auto strong = weak.get()) {
+					strong->mtp().setRequestStatsEnabled(false);
+				}
+				close();
+			},
+			.confirmText = u"Save"_q,
+			.cancelText = u"Disable"_q,
+		}));
+	});
+	codes.emplace(u"memstats"_q, [](SessionController *window) {
+		if (!window) {
+			return;
+		}
+		const auto report = Data::CollectMemoryReport(
+			&window->session().data());
+		const auto json = Data::MemoryReportJson(report);
+		Ui::show(Ui::MakeConfirmBox({
+			.text = Data::MemoryReportText(report),
+			.confirmed = [=](Fn<void()> close) {
+				LOG(("Memory Stats:\n%1").arg(QString::fromUtf8(json)));
+				auto f = QFile(cWorkingDir() + u"memory_stats.json"_q);
+				if (f.open(QIODevice::WriteOnly) && f.write(json) > 0) {
+					Ui::Toast::Show("Saved to memory_stats.json and log.");
+				} else {
+					Ui::Toast::Show("Could not save the stats :(");
+				}
+				close();
+			},
+			.confirmText = u"Save"_q,
+		}));
+	});
+	codes.emplace(u"syntheticaccount"_q, [](SessionController *window) {
+		if (!window) {
+			return;
+		}
+		const auto weak = base::make_weak(window);
+		Ui::show(Ui::MakeConfirmBox({
+			.text = u"Fill this session with 50000 generated chats, "
+				"a large group and 1000 sticker sets?\n\n"
+				"They are not saved and disappear after restart."_q,
+			.confirmed = [=](Fn<void()> close) {
+				if (const auto strong = weak.get()) {
+					Data::FillSyntheticAccount(&strong->session().data());
+				}
+				close();
+			},
+			.confirmText = u"Generate"_q,
+		}));
+	});
 	codes.emplace(u"testchatcolors"_q, [](SessionController *window) {
 		const auto now = !Data::CloudThemes::TestingColors();
 		Data::CloudThemes::SetTestingColors(now);
@@ -15,15 +15,21 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "ui/vertical_list.h"
 #include "ui/gl/gl_detection.h"
 #include "ui/chat/chat_style_radius.h"
+#include "api/api_updates_recorder.h"
 #include "base/options.h"
+#include "calls/calls_statistics.h"
 #include "core/application.h"
+#include "core/core_paint_profiler.h"
+#include "core/core_settings_proxy.h"
 #include "core/launcher.h"
 #include "chat_helpers/tabbed_panel.h"
 #include "dialogs/dialogs_widget.h"
+#include "history/history_inner_widget.h"
 #include "info/profile/info_profile_actions.h"
 #include "lang/lang_keys.h"
 #include "mainwindow.h"
 #include "media/player/media_player_instance.h"
+#include "media/streaming/media_streaming_player.h"
 #include "webview/webview_embed.h"
 #include "window/main_window.h"
 #include "window/window_peer_menu.h"
@@ -32,6 +38,11 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "window/notifications_manager.h"
 #include "storage/localimageloader.h"
 #include "data/data_document_resolver.h"
+#include "data/data_changes.h"
+#include "data/data_histories.h"
+#include "data/data_messages_search_index.h"
+#include "data/data_session.h"
+#include "main/main_session.h"
 #include "styles/style_settings.h"
 #include "styles/style_layers.h"
 
@@ -147,18 +158,42 @@ void SetupExperimental(
 	addToggle(Info::Profile::kOptionShowPeerIdBelowAbout);
 	addToggle(Ui::kOptionUseSmallMsgBubbleRadius);
 	addToggle(Media::Player::kOptionDisableAutoplayNext);
+	addToggle(Media::Streaming::kOptionVideoFramePacing);
+	addToggle(Media::Streaming::kOptionVideoPlaybackStatistics);
 	addToggle(kOptionSendLargePhotos);
 	addToggle(Webview::kOptionWebviewDebugEnabled);
 	addToggle(Webview::kOptionWebviewLegacyEdge);
 	addToggle(kOptionAutoScrollInactiveChat);
+	addToggle(kOptionCacheMessageViews);
+	addToggle(kOptionChatThroughputMode);
 	addToggle(Window::Notifications::kOptionGNotification);
 	addToggle(Core::kOptionFreeType);
 	addToggle(Core::kOptionSkipUrlSchemeRegister);
+	addToggle(Core::kOptionPaintProfiler);
+	addToggle(Core::kOptionSpreadMediaOverProxies);
+	addToggle(Calls::kOptionCallStatistics);
 	addToggle(Data::kOptionExternalVideoPlayer);
+	addToggle(Data::kOptionCacheChatHistory);
+	addToggle(Data::kOptionUnloadColdHistories);
+	addToggle(Data::kOptionFrameAlignedChanges);
+	addToggle(Data::kOptionLocalMessagesSearch);
+	addToggle(Api::kOptionRecordUpdates);
 	addToggle(Window::kOptionNewWindowsSizeAsFirst);
 	addToggle(Window::kOptionDisableTouchbar);
 }
 
+void SetupLoadedViewsInfo(
+		not_null<Main::Session*> session,
+		not_null<Ui::VerticalLayout*> container) {
+	const auto &histories = session->data().histories();
+	const auto text = u"Loaded message views: %1 of %2 allowed."_q.arg(
+		histories.loadedViewsCount()
+	).arg(Data::Histories::LoadedViewsBudget());
+
+	Ui::AddSkip(container, st::settingsCheckboxesSkip);
+	Ui::AddDividerText(container, rpl::single(text));
+}
+
 } // namespace
 
 Experimental::Experimental(
@@ -177,6 +212,7 @@ void Experimental::setupContent(
 	const auto content = Ui::CreateChild<Ui::VerticalLayout>(this);
 
 	SetupExperimental(&controller->window(), content);
+	SetupLoadedViewsInfo(&controller->session(), content);
 
 	Ui::ResizeFitChild(this, content);
 }
@@ -644,7 +644,7 @@ void SetupInterfaceScale(
 			}));
 		} else if (scale != cConfigScale()) {
 			cSetConfigScale(scale);
-			Local::writeSettings();
+			Core::App().saveSettingsDelayed();
 		}
 	};
 
@@ -35,6 +35,27 @@ void PaintChartLine(
 
 	const auto ratio = ratios.ratio(line.id);
 
+	// With many more points than pixels we keep only the first, the last
+	// and the extreme points of each pixel column, the line looks the same.
+	const auto decimate = (localEnd - localStart) > 2 * c.rect.width();
+	auto column = std::optional<int>();
+	auto first = QPointF();
+	auto last = QPointF();
+	auto low = QPointF();
+	auto high = QPointF();
+	auto lowFirst = true;
+	const auto push = [&](const QPointF &point) {
+		if (chartPoints.isEmpty() || chartPoints.back() != point) {
+			chartPoints << point;
+		}
+	};
+	const auto pushColumn = [&] {
+		push(first);
+		push(lowFirst ? low : high);
+		push(lowFirst ? high : low);
+		push(last);
+	};
+
 	for (auto i = localStart; i <= localEnd; i++) {
 		if (line.y[i] < 0) {
 			continue;
@@ -45,7 +66,32 @@ void PaintChartLine(
 		const auto yPercentage = (line.y[i] * ratio - c.heightLimits.min)
 			/ float64(c.heightLimits.max - c.heightLimits.min);
 		const auto yPoint = (1. - yPercentage) * c.rect.height();
-		chartPoints << QPointF(xPoint, yPoint);
+		const auto point = QPointF(xPoint, yPoint);
+		if (!decimate) {
+			chartPoints << point;
+			continue;
+		}
+		const auto pointColumn = int(std::floor(xPoint));
+		if (column != pointColumn) {
+			if (column) {
+				pushColumn();
+			}
+			column = pointColumn;
+			first = last = low = high = point;
+			lowFirst = true;
+			continue;
+		}
+		last = point;
+		if (yPoint < low.y()) {
+			low = point;
+			lowFirst = false;
+		} else if (yPoint > high.y()) {
+			high = point;
+			lowFirst = true;
+		}
+	}
+	if (column) {
+		pushColumn();
 	}
 	p.setPen(QPen(
 		line.color,
@@ -11,6 +11,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "base/platform/base_platform_file_utilities.h"
 #include "base/openssl_help.h"
 #include "base/random.h"
+#include "core/core_startup_trace.h"
 
 #include <crl/crl_object_on_thread.h>
 #include <QtCore/QtEndian>
@@ -301,6 +302,7 @@ bool CheckStreamStatus(QDataStream &stream) {
 MTP::AuthKeyPtr CreateLocalKey(
 		const QByteArray &passcode,
 		const QByteArray &salt) {
+	const auto trace = Core::StartupTrace::Span("CreateLocalKey");
 	const auto s = bytes::make_span(salt);
 	const auto hash = openssl::Sha512(s, bytes::make_span(passcode), s);
 	const auto iterationsCount = passcode.isEmpty()
@@ -665,6 +667,23 @@ bool ReadEncryptedFile(
 	return ReadEncryptedFile(result, ToFilePart(fkey), basePath, key);
 }
 
+void PrefetchFiles(std::vector<QString> names, const QString &basePath) {
+	if (names.empty()) {
+		return;
+	}
+	crl::async([names = std::move(names), basePath] {
+		const auto trace = Core::StartupTrace::Span("PrefetchFiles");
+		for (const auto &name : names) {
+			for (const auto postfix : { 's', '0', '1' }) {
+				auto f = QFile(basePath + name + postfix);
+				if (f.open(QIODevice::ReadOnly)) {
+					[[maybe_unused]] const auto bytes = f.readAll();
+				}
+			}
+		}
+	});
+}
+
 void Sync() {
 	Manager.sync();
 }
@@ -106,6 +106,10 @@ bool ReadEncryptedFile(
 	const QString &basePath,
 	const MTP::AuthKeyPtr &key);
 
+// Reads the files on a background thread, so that the following
+// ReadFile() calls on the main thread are served from the disk cache.
+void PrefetchFiles(std::vector<QString> names, const QString &basePath);
+
 void Sync();
 void Finish();
 
@@ -10,6 +10,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "mtproto/facade.h"
 #include "mtproto/mtproto_auth_key.h"
 #include "mtproto/mtproto_response.h"
+#include "main/main_account.h"
+#include "main/main_domain.h"
 #include "main/main_session.h"
 #include "data/data_session.h"
 #include "data/data_document.h"
@@ -32,14 +34,113 @@ constexpr auto kMaxTrackedSuccesses = kRetryAddSessionSuccesses
 constexpr auto kRemoveSessionAfterTimeouts = 4;
 constexpr auto kResetDownloadPrioritiesTimeout = crl::time(200);
 constexpr auto kBadRequestDurationThreshold = 8 * crl::time(1000);
+constexpr auto kDeliveryRoundDuration = crl::time(1000);
+constexpr auto kDeliveryIdleTimeout = 4 * kDeliveryRoundDuration;
+constexpr auto kMinDurationWindow = 10 * crl::time(1000);
+constexpr auto kProbeDurationFactor = 2;
+constexpr auto kDrainDurationFactor = 4;
+constexpr auto kPipeFullCheckDelay = 2 * kDeliveryRoundDuration;
+constexpr auto kPipeFullGrowthPercent = 125;
+constexpr auto kPipeFullRetryTimeout = 30 * crl::time(1000);
+constexpr auto kPrewarmRecentTimeout = 10 * 60 * crl::time(1000);
+constexpr auto kMaxRequestedInAccounts = 2
+	* kMaxSessionsCount
+	* kMaxWaitedInSession;
+constexpr auto kBackgroundRequestedPercent = 25;
 
 // Each (session remove by timeouts) we wait for time:
 // kRetryAddSessionTimeout * max(removesCount, kMaxTrackedSessionRemoves)
 // and for successes in all remaining sessions:
 // kRetryAddSessionSuccesses * max(removesCount, kMaxTrackedSessionRemoves)
+//
+// We measure delivered bytes per second in each dc in rounds and keep
+// the max of the last rounds as the bottleneck estimate, together with
+// the shortest recent request duration. A session is allowed to wait
+// for more parts only while request durations stay close to the minimal
+// one, and waits for less when they grow (something is queueing).
+// After adding a session we check that the bottleneck estimate grew by
+// at least kPipeFullGrowthPercent, otherwise the link is saturated and
+// we don't add sessions for kPipeFullRetryTimeout.
 
 } // namespace
 
+DownloadArbiter::DownloadArbiter(not_null<Main::Domain*> domain)
+: _domain(domain) {
+}
+
+void DownloadArbiter::add(not_null<DownloadManagerMtproto*> manager) {
+	_requested.emplace(manager, 0);
+}
+
+void DownloadArbiter::remove(not_null<DownloadManagerMtproto*> manager) {
+	const auto i = _requested.find(manager);
+	if (i != end(_requested)) {
+		_totalRequested -= i->second;
+		_requested.erase(i);
+	}
+	_blocked.remove(manager);
+}
+
+bool DownloadArbiter::foreground(
+		not_null<DownloadManagerMtproto*> manager) const {
+	return _domain->started()
+		&& (_domain->active().maybeSession() == &manager->api().session());
+}
+
+int DownloadArbiter::allowed(
+		not_null<DownloadManagerMtproto*> manager,
+		int wanted) {
+	const auto i = _requested.find(manager);
+	Assert(i != end(_requested));
+
+	const auto mine = i->second;
+	auto limit = kMaxRequestedInAccounts - (_totalRequested - mine);
+	if (!foreground(manager)) {
+		const auto foregroundRequested = ranges::any_of(
+			_requested,
+			[&](const auto &pair) {
+				return (pair.second > 0) && foreground(pair.first);
+			});
+		const auto active = ranges::count_if(
+			_requested,
+			[&](const auto &pair) {
+				return (pair.first == manager) || (pair.second > 0);
+			});
+		const auto share = foregroundRequested
+			? (kMaxRequestedInAccounts * kBackgroundRequestedPercent / 100)
+			: kMaxRequestedInAccounts;
+		limit = std::min(limit, share / std::max(int(active), 1));
+	}
+	// Always allow one part, so that no account stays starving.
+	const auto result = mine
+		? std::clamp(limit - mine, 0, wanted)
+		: std::min(std::max(limit, kDownloadPartSize), wanted);
+	if (result < std::min(wanted, kDownloadPartSize)) {
+		_blocked.emplace(manager);
+	}
+	return result;
+}
+
+void DownloadArbiter::changeRequested(
+		not_null<DownloadManagerMtproto*> manager,
+		int delta) {
+	const auto i = _requested.find(manager);
+	Assert(i != end(_requested));
+
+	i->second += delta;
+	_totalRequested += delta;
+	if (delta >= 0 || _blocked.empty()) {
+		return;
+	}
+	// The manager itself will check its queues after the request is done.
+	_blocked.remove(manager);
+	for (const auto blocked : base::take(_blocked)) {
+		crl::on_main(blocked.get(), [=] {
+			blocked->checkSendNext();
+		});
+	}
+}
+
 void DownloadManagerMtproto::Queue::enqueue(
 		not_null<Task*> task,
 		int priority) {
@@ -109,6 +210,36 @@ void DownloadManagerMtproto::Queue::removeSession(int index) {
 	}
 }
 
+bool DownloadManagerMtproto::DcDeliveryRate::feed(
+		int amount,
+		crl::time sent,
+		crl::time received) {
+	const auto duration = received - sent;
+	if (!minDuration
+		|| duration <= minDuration
+		|| received - minDurationUpdated >= kMinDurationWindow) {
+		minDuration = std::max(duration, crl::time(1));
+		minDurationUpdated = received;
+	}
+	if (!roundStart || received - roundStart >= kDeliveryIdleTimeout) {
+		// We were idle for a while, start measuring from this request.
+		roundStart = sent;
+		roundDelivered = 0;
+	}
+	roundDelivered += amount;
+	const auto elapsed = received - roundStart;
+	if (elapsed < kDeliveryRoundDuration) {
+		return false;
+	}
+	current = roundDelivered * crl::time(1000) / elapsed;
+	rounds[roundIndex] = current;
+	roundIndex = (roundIndex + 1) % kRounds;
+	max = ranges::max(rounds);
+	roundStart = received;
+	roundDelivered = 0;
+	return true;
+}
+
 DownloadManagerMtproto::DcSessionBalanceData::DcSessionBalanceData()
 : maxWaitedAmount(kStartWaitedInSession) {
 }
@@ -119,8 +250,10 @@ DownloadManagerMtproto::DcBalanceData::DcBalanceData()
 
 DownloadManagerMtproto::DownloadManagerMtproto(not_null<ApiWrap*> api)
 : _api(api)
+, _arbiter(&api->session().domain().downloadArbiter())
 , _resetGenerationTimer([=] { resetGeneration(); })
 , _killSessionsTimer([=] { killSessions(); }) {
+	_arbiter->add(this);
 	_api->instance().restartsByTimeout(
 	) | rpl::filter([](MTP::ShiftedDcId shiftedDcId) {
 		return MTP::isDownloadDcId(shiftedDcId);
@@ -132,6 +265,7 @@ DownloadManagerMtproto::DownloadManagerMtproto(not_null<ApiWrap*> api)
 }
 
 DownloadManagerMtproto::~DownloadManagerMtproto() {
+	_arbiter->remove(this);
 	killSessions();
 }
 
@@ -139,6 +273,7 @@ void DownloadManagerMtproto::enqueue(not_null<Task*> task, int priority) {
 	const auto dcId = task->dcId();
 	auto &queue = _queues[dcId];
 	queue.enqueue(task, priority);
+	_lastUsed[dcId] = crl::now();
 	if (!_resetGenerationTimer.isActive()) {
 		_resetGenerationTimer.callOnce(kResetDownloadPrioritiesTimeout);
 	}
@@ -152,6 +287,31 @@ void DownloadManagerMtproto::remove(not_null<Task*> task) {
 	checkSendNext(dcId, queue);
 }
 
+void DownloadManagerMtproto::prewarmRecentDcs() {
+	const auto now = crl::now();
+	for (auto i = begin(_lastUsed); i != end(_lastUsed);) {
+		const auto dcId = i->first;
+		if (now - i->second > kPrewarmRecentTimeout) {
+			i = _lastUsed.erase(i);
+			continue;
+		}
+		++i;
+		const auto &balanceData = _balanceData[dcId];
+		if (balanceData.totalRequested > 0
+			|| _killSessionsWhen.contains(dcId)
+			|| _prewarmed.contains(dcId)) {
+			continue;
+		}
+		// Starting the session connects it and binds a temporary key,
+		// if nothing is requested it will be stopped by the kill timer.
+		DEBUG_LOG(("Download Info: prewarming download session in dc %1."
+			).arg(dcId));
+		_prewarmed.emplace(dcId);
+		api().instance().sendAnything(MTP::downloadDcId(dcId, 0));
+		killSessionsSchedule(dcId);
+	}
+}
+
 void DownloadManagerMtproto::resetGeneration() {
 	_resetGenerationTimer.cancel();
 	for (auto &[dcId, queue] : _queues) {
@@ -194,9 +354,16 @@ bool DownloadManagerMtproto::trySendNextPart(MTP::DcId dcId, Queue &queue) {
 	if (bestIndex < 0) {
 		return false;
 	}
+	const auto &best = sessions[bestIndex];
+	const auto available = _arbiter->allowed(
+		this,
+		best.maxWaitedAmount - best.requested);
+	if (available < kDownloadPartSize) {
+		return false;
+	}
 	const auto onlyHighestPriority = (balanceData.totalRequested > 0);
 	if (const auto task = queue.nextTask(onlyHighestPriority)) {
-		task->loadPart(bestIndex);
+		task->loadPart(bestIndex, available);
 		return true;
 	}
 	return false;
@@ -211,6 +378,7 @@ int DownloadManagerMtproto::changeRequestedAmount(
 	Assert(index < i->second.sessions.size());
 	const auto result = (i->second.sessions[index].requested += delta);
 	i->second.totalRequested += delta;
+	_arbiter->changeRequested(this, delta);
 	const auto findNonEmptySession = [](const DcBalanceData &data) {
 		using namespace rpl::mappers;
 		return ranges::find_if(
@@ -229,6 +397,7 @@ int DownloadManagerMtproto::changeRequestedAmount(
 void DownloadManagerMtproto::requestSucceeded(
 		MTP::DcId dcId,
 		int index,
+		int amount,
 		int amountAtRequestStart,
 		crl::time timeAtRequestStart) {
 	using namespace rpl::mappers;
@@ -241,13 +410,23 @@ void DownloadManagerMtproto::requestSucceeded(
 	const auto overloaded = (timeAtRequestStart <= dc.lastSessionRemove)
 		|| (amountAtRequestStart > data.maxWaitedAmount);
 	const auto parts = amountAtRequestStart / kDownloadPartSize;
-	const auto duration = (crl::now() - timeAtRequestStart);
+	const auto now = crl::now();
+	const auto duration = (now - timeAtRequestStart);
 	DEBUG_LOG(("Download (%1,%2) request done, duration: %3, parts: %4%5"
 		).arg(dcId
 		).arg(index
 		).arg(duration
 		).arg(parts
 		).arg(overloaded ? " (overloaded)" : ""));
+	if (dc.rate.feed(amount, timeAtRequestStart, now)) {
+		DEBUG_LOG(("Download (%1) delivery rate: %2 KB/s, max: %3 KB/s, "
+			"min duration: %4, sessions: %5"
+			).arg(dcId
+			).arg(dc.rate.current / 1024
+			).arg(dc.rate.max / 1024
+			).arg(dc.rate.minDuration
+			).arg(dc.sessions.size()));
+	}
 	if (overloaded) {
 		return;
 	}
@@ -259,8 +438,17 @@ void DownloadManagerMtproto::requestSucceeded(
 		});
 		return;
 	}
-	if (amountAtRequestStart == data.maxWaitedAmount
-		&& data.maxWaitedAmount < kMaxWaitedInSession) {
+	const auto minDuration = dc.rate.minDuration;
+	if (data.maxWaitedAmount > kStartWaitedInSession
+		&& duration > kDrainDurationFactor * minDuration) {
+		data.maxWaitedAmount -= kDownloadPartSize;
+		DEBUG_LOG(("Download (%1,%2) decreased max waited amount %3."
+			).arg(dcId
+			).arg(index
+			).arg(data.maxWaitedAmount));
+	} else if (amountAtRequestStart + kDownloadPartSize > data.maxWaitedAmount
+		&& data.maxWaitedAmount < kMaxWaitedInSession
+		&& duration <= kProbeDurationFactor * minDuration) {
 		data.maxWaitedAmount = std::min(
 			data.maxWaitedAmount + kDownloadPartSize,
 			kMaxWaitedInSession);
@@ -286,11 +474,29 @@ void DownloadManagerMtproto::requestSucceeded(
 	} else if (dc.sessions.size() == kMaxSessionsCount) {
 		return;
 	}
-	const auto now = crl::now();
 	const auto delay = (dc.sessionRemoveTimes + 1) * kRetryAddSessionTimeout;
 	if (dc.lastSessionRemove && now < dc.lastSessionRemove + delay) {
 		return;
+	} else if (dc.pipeFullDetected
+		&& now < dc.pipeFullDetected + kPipeFullRetryTimeout) {
+		return;
+	} else if (dc.rateAtSessionAdd) {
+		if (now < dc.lastSessionAdd + kPipeFullCheckDelay) {
+			return;
+		} else if (dc.rate.max * 100
+			< dc.rateAtSessionAdd * kPipeFullGrowthPercent) {
+			DEBUG_LOG(("Download (%1) rate didn't grow from %2 KB/s, "
+				"keeping sessions: %3"
+				).arg(dcId
+				).arg(dc.rateAtSessionAdd / 1024
+				).arg(dc.sessions.size()));
+			dc.pipeFullDetected = now;
+			dc.rateAtSessionAdd = 0;
+			return;
+		}
 	}
+	dc.rateAtSessionAdd = std::max(dc.rate.max, int64(1));
+	dc.lastSessionAdd = now;
 	dc.sessions.emplace_back();
 	DEBUG_LOG(("Download (%1,%2) adding, now sessions: %3"
 		).arg(dcId
@@ -309,6 +515,25 @@ int DownloadManagerMtproto::chooseSessionIndex(MTP::DcId dcId) const {
 	return (j - begin(sessions));
 }
 
+auto DownloadManagerMtproto::dcStats(MTP::DcId dcId) const -> DcStats {
+	const auto i = _balanceData.find(dcId);
+	if (i == end(_balanceData)) {
+		return {};
+	}
+	const auto &dc = i->second;
+	auto result = DcStats{
+		.bytesPerSecond = dc.rate.current,
+		.maxBytesPerSecond = dc.rate.max,
+		.minDuration = dc.rate.minDuration,
+		.sessions = int(dc.sessions.size()),
+		.requested = dc.totalRequested,
+	};
+	for (const auto &session : dc.sessions) {
+		result.maxRequested += session.maxWaitedAmount;
+	}
+	return result;
+}
+
 void DownloadManagerMtproto::sessionTimedOut(MTP::DcId dcId, int index) {
 	const auto i = _balanceData.find(dcId);
 	if (i == end(_balanceData)) {
@@ -396,6 +621,7 @@ void DownloadManagerMtproto::killSessions() {
 }
 
 void DownloadManagerMtproto::killSessions(MTP::DcId dcId) {
+	_prewarmed.remove(dcId);
 	const auto i = _balanceData.find(dcId);
 	if (i != end(_balanceData)) {
 		auto &dc = i->second;
@@ -475,20 +701,35 @@ void DownloadMtprotoTask::refreshFileReferenceFrom(
 	}
 }
 
-void DownloadMtprotoTask::loadPart(int sessionIndex) {
-	makeRequest({ takeNextRequestOffset(), sessionIndex });
+int DownloadMtprotoTask::nextRequestLimit(int available) const {
+	return Storage::kDownloadPartSize;
+}
+
+void DownloadMtprotoTask::loadPart(int sessionIndex, int available) {
+	Expects(available >= Storage::kDownloadPartSize);
+
+	const auto limit = nextRequestLimit(available);
+	Assert(limit > 0 && limit <= available);
+
+	const auto offset = takeNextRequestOffset(limit);
+	makeRequest({ offset, sessionIndex, limit });
 }
 
 void DownloadMtprotoTask::removeSession(int sessionIndex) {
 	struct Redirect {
 		mtpRequestId requestId = 0;
 		int64 offset = 0;
+		int limit = 0;
 	};
 	auto redirect = std::vector<Redirect>();
 	for (const auto &[requestId, requestData] : _sentRequests) {
 		if (requestData.sessionIndex == sessionIndex) {
 			redirect.reserve(_sentRequests.size());
-			redirect.push_back({ requestId, requestData.offset });
+			redirect.push_back({
+				requestId,
+				requestData.offset,
+				requestData.limit,
+			});
 		}
 	}
 	for (auto &[requestData, bytes] : _cdnUncheckedParts) {
@@ -498,13 +739,13 @@ void DownloadMtprotoTask::removeSession(int sessionIndex) {
 			requestData.sessionIndex = newIndex;
 		}
 	}
-	for (const auto &[requestId, offset] : redirect) {
+	for (const auto &[requestId, offset, limit] : redirect) {
 		const auto needMakeRequest = (requestId != _cdnHashesRequestId);
 		cancelRequest(requestId);
 		if (needMakeRequest) {
 			const auto newIndex = _owner->chooseSessionIndex(dcId());
 			Assert(newIndex < sessionIndex);
-			makeRequest({ offset, newIndex });
+			makeRequest({ offset, newIndex, limit });
 		}
 	}
 }
@@ -512,7 +753,7 @@ void DownloadMtprotoTask::removeSession(int sessionIndex) {
 mtpRequestId DownloadMtprotoTask::sendRequest(
 		const RequestData &requestData) {
 	const auto offset = requestData.offset;
-	const auto limit = Storage::kDownloadPartSize;
+	const auto limit = requestData.limit;
 	const auto shiftedDcId = MTP::downloadDcId(
 		_cdnDcId ? _cdnDcId : dcId(),
 		requestData.sessionIndex);
@@ -609,7 +850,7 @@ void DownloadMtprotoTask::requestMoreCdnFileHashes() {
 		requestData.sessionIndex);
 	_cdnHashesRequestId = api().request(MTPupload_GetCdnFileHashes(
 		MTP_bytes(_cdnToken),
-		MTP_long(requestData.offset)
+		MTP_long(firstMissingCdnHashOffset(requestData.offset))
 	)).done([=](const MTPVector<MTPFileHash> &result, mtpRequestId id) {
 		getCdnFileHashesDone(result, id);
 	}).fail([=](const MTP::Error &error, mtpRequestId id) {
@@ -687,19 +928,18 @@ void DownloadMtprotoTask::cdnPartLoaded(const MTPupload_CdnFile &result, mtpRequ
 		Expects(key.size() == MTP::CTRState::KeySize);
 		Expects(iv.size() == MTP::CTRState::IvecSize);
 
-		auto state = MTP::CTRState();
-		auto ivec = bytes::make_span(state.ivec);
-		std::copy(iv.begin(), iv.end(), ivec.begin());
+		auto ivec = std::array<uchar, MTP::CTRState::IvecSize>();
+		std::copy(iv.begin(), iv.end(), bytes::make_span(ivec).begin());
 
 		auto counterOffset = static_cast<uint32>(requestData.offset >> 4);
-		state.ivec[15] = static_cast<uchar>(counterOffset & 0xFF);
-		state.ivec[14] = static_cast<uchar>((counterOffset >> 8) & 0xFF);
-		state.ivec[13] = static_cast<uchar>((counterOffset >> 16) & 0xFF);
-		state.ivec[12] = static_cast<uchar>((counterOffset >> 24) & 0xFF);
+		ivec[15] = static_cast<uchar>(counterOffset & 0xFF);
+		ivec[14] = static_cast<uchar>((counterOffset >> 8) & 0xFF);
+		ivec[13] = static_cast<uchar>((counterOffset >> 16) & 0xFF);
+		ivec[12] = static_cast<uchar>((counterOffset >> 24) & 0xFF);
 
 		auto decryptInPlace = data.vbytes().v;
 		auto buffer = bytes::make_detached_span(decryptInPlace);
-		MTP::aesCtrEncrypt(buffer, key.data(), &state);
+		MTP::CTRStream(key, bytes::make_span(ivec)).encrypt(buffer);
 
 		switch (checkCdnFileHash(requestData.offset, buffer)) {
 		case CheckCdnHashResult::NoHash: {
@@ -721,17 +961,40 @@ void DownloadMtprotoTask::cdnPartLoaded(const MTPupload_CdnFile &result, mtpRequ
 	});
 }
 
+int64 DownloadMtprotoTask::firstMissingCdnHashOffset(int64 offset) const {
+	for (auto i = _cdnFileHashes.find(offset)
+		; (i != end(_cdnFileHashes)) && (i->second.limit > 0)
+		; i = _cdnFileHashes.find(offset)) {
+		offset += i->second.limit;
+	}
+	return offset;
+}
+
 DownloadMtprotoTask::CheckCdnHashResult DownloadMtprotoTask::checkCdnFileHash(
 		int64 offset,
 		bytes::const_span buffer) {
-	const auto cdnFileHashIt = _cdnFileHashes.find(offset);
-	if (cdnFileHashIt == _cdnFileHashes.cend()) {
-		return CheckCdnHashResult::NoHash;
-	}
-	const auto realHash = openssl::Sha256(buffer);
-	const auto receivedHash = bytes::make_span(cdnFileHashIt->second.hash);
-	if (bytes::compare(realHash, receivedHash)) {
-		return CheckCdnHashResult::Invalid;
+	// A part may span several hashed ranges, each is checked separately.
+	auto checked = int64(0);
+	const auto size = int64(buffer.size());
+	while (checked < size) {
+		const auto cdnFileHashIt = _cdnFileHashes.find(offset + checked);
+		if (cdnFileHashIt == _cdnFileHashes.cend()) {
+			return CheckCdnHashResult::NoHash;
+		}
+		const auto limit = int64(cdnFileHashIt->second.limit);
+		if (limit <= 0) {
+			return CheckCdnHashResult::Invalid;
+		}
+		const auto range = buffer.subspan(
+			checked,
+			std::min(limit, size - checked));
+		const auto realHash = openssl::Sha256(range);
+		const auto receivedHash = bytes::make_span(
+			cdnFileHashIt->second.hash);
+		if (bytes::compare(realHash, receivedHash)) {
+			return CheckCdnHashResult::Invalid;
+		}
+		checked += limit;
 	}
 	return CheckCdnHashResult::Good;
 }
@@ -754,7 +1017,7 @@ void DownloadMtprotoTask::getCdnFileHashesDone(
 	const auto requestData = finishSentRequest(
 		requestId,
 		FinishRequestReason::Redirect);
-	addCdnHashes(result.v);
+	const auto someMoreHashes = addCdnHashes(result.v);
 	auto someMoreChecked = false;
 	for (auto i = _cdnUncheckedParts.begin(); i != _cdnUncheckedParts.cend();) {
 		const auto uncheckedData = i->first;
@@ -786,7 +1049,7 @@ void DownloadMtprotoTask::getCdnFileHashesDone(
 		default: Unexpected("Result of checkCdnFileHash()");
 		}
 	}
-	if (!someMoreChecked) {
+	if (!someMoreChecked && !someMoreHashes) {
 		LOG(("API Error: "
 			"Could not find cdnFileHash for offset %1 "
 			"after getCdnFileHashes request."
@@ -807,7 +1070,7 @@ void DownloadMtprotoTask::placeSentRequest(
 	const auto amount = _owner->changeRequestedAmount(
 		dcId(),
 		requestData.sessionIndex,
-		Storage::kDownloadPartSize);
+		requestData.limit);
 	const auto &[i, ok1] = _sentRequests.emplace(requestId, requestData);
 	const auto &[j, ok2] = _requestByOffset.emplace(
 		requestData.offset,
@@ -851,7 +1114,7 @@ auto DownloadMtprotoTask::finishSentRequest(
 	_owner->changeRequestedAmount(
 		dcId(),
 		result.sessionIndex,
-		-Storage::kDownloadPartSize);
+		-result.limit);
 	_sentRequests.erase(it);
 	const auto ok = _requestByOffset.remove(result.offset);
 
@@ -863,6 +1126,7 @@ auto DownloadMtprotoTask::finishSentRequest(
 		_owner->requestSucceeded(
 			dcId(),
 			result.sessionIndex,
+			result.limit,
 			result.requestedInSession,
 			result.sent);
 	}
@@ -987,15 +1251,18 @@ void DownloadMtprotoTask::switchToCDN(
 		redirect.vfile_hashes().v);
 }
 
-void DownloadMtprotoTask::addCdnHashes(
+bool DownloadMtprotoTask::addCdnHashes(
 		const QVector<MTPFileHash> &hashes) {
+	auto result = false;
 	for (const auto &hash : hashes) {
 		hash.match([&](const MTPDfileHash &data) {
-			_cdnFileHashes.emplace(
+			const auto &[i, ok] = _cdnFileHashes.emplace(
 				data.voffset().v,
 				CdnFileHash{ data.vlimit().v, data.vhash().v });
+			result = result || ok;
 		});
 	}
+	return result;
 }
 
 void DownloadMtprotoTask::changeCDNParams(
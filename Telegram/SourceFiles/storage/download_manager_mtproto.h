@@ -13,24 +13,67 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 class ApiWrap;
 
+namespace Main {
+class Domain;
+} // namespace Main
+
 namespace MTP {
 class Error;
 } // namespace MTP
 
 namespace Storage {
 
-// Different part sizes are not supported for now :(
-// Because we start downloading with some part size
-// and then we get a CDN-redirect where we support only
-// fixed part size download for hash checking.
+// Parts are requested by kDownloadPartSize, bulk downloads may use
+// kDownloadBigPartSize parts at offsets aligned to that size.
+// CDN hashes are checked over each hashed range inside a part.
 constexpr auto kDownloadPartSize = 128 * 1024;
+constexpr auto kDownloadBigPartSize = 512 * 1024;
 
 class DownloadMtprotoTask;
+class DownloadManagerMtproto;
+
+// Shares one cap on in-flight download bytes between the accounts.
+// The active account may use all of it, the others share a part of it
+// while the active account is downloading and split it evenly otherwise.
+class DownloadArbiter final {
+public:
+	explicit DownloadArbiter(not_null<Main::Domain*> domain);
+
+	void add(not_null<DownloadManagerMtproto*> manager);
+	void remove(not_null<DownloadManagerMtproto*> manager);
+
+	[[nodiscard]] int allowed(
+		not_null<DownloadManagerMtproto*> manager,
+		int wanted);
+	void changeRequested(
+		not_null<DownloadManagerMtproto*> manager,
+		int delta);
+
+private:
+	[[nodiscard]] bool foreground(
+		not_null<DownloadManagerMtproto*> manager) const;
+
+	const not_null<Main::Domain*> _domain;
+
+	base::flat_map<not_null<DownloadManagerMtproto*>, int> _requested;
+	base::flat_set<not_null<DownloadManagerMtproto*>> _blocked;
+	int _totalRequested = 0;
+
+};
 
 class DownloadManagerMtproto final : public base::has_weak_ptr {
 public:
 	using Task = DownloadMtprotoTask;
 
+	struct DcStats {
+		int64 bytesPerSecond = 0; // Last full measurement round.
+		int64 maxBytesPerSecond = 0; // Bottleneck estimate.
+		crl::time minDuration = 0; // Shortest recent request.
+		int sessions = 0;
+		int requested = 0;
+		int maxRequested = 0;
+	};
+
 	explicit DownloadManagerMtproto(not_null<ApiWrap*> api);
 	~DownloadManagerMtproto();
 
@@ -40,6 +83,10 @@ public:
 
 	void enqueue(not_null<Task*> task, int priority);
 	void remove(not_null<Task*> task);
+	void checkSendNext();
+
+	// Connects download sessions to recently used dcs in advance.
+	void prewarmRecentDcs();
 
 	void notifyTaskFinished() {
 		_taskFinished.fire({});
@@ -52,10 +99,12 @@ public:
 	void requestSucceeded(
 		MTP::DcId dcId,
 		int index,
+		int amount,
 		int amountAtRequestStart,
 		crl::time timeAtRequestStart);
 	void checkSendNextAfterSuccess(MTP::DcId dcId);
 	[[nodiscard]] int chooseSessionIndex(MTP::DcId dcId) const;
+	[[nodiscard]] DcStats dcStats(MTP::DcId dcId) const;
 
 	void notifyNonPremiumDelay(DocumentId id) {
 		_nonPremiumDelays.fire_copy(id);
@@ -89,18 +138,35 @@ private:
 		int successes = 0; // Since last timeout in this dc in any session.
 		int maxWaitedAmount = 0;
 	};
+	struct DcDeliveryRate {
+		static constexpr auto kRounds = 10;
+
+		bool feed(int amount, crl::time sent, crl::time received);
+
+		std::array<int64, kRounds> rounds = { { 0 } };
+		int roundIndex = 0;
+		crl::time roundStart = 0;
+		int64 roundDelivered = 0;
+		int64 current = 0;
+		int64 max = 0;
+		crl::time minDuration = 0;
+		crl::time minDurationUpdated = 0;
+	};
 	struct DcBalanceData {
 		DcBalanceData();
 
 		std::vector<DcSessionBalanceData> sessions;
+		DcDeliveryRate rate;
 		crl::time lastSessionRemove = 0;
+		crl::time lastSessionAdd = 0;
+		crl::time pipeFullDetected = 0;
+		int64 rateAtSessionAdd = 0;
 		int sessionRemoveIndex = 0;
 		int sessionRemoveTimes = 0;
 		int timeouts = 0; // Since all sessions had successes >= required.
 		int totalRequested = 0;
 	};
 
-	void checkSendNext();
 	void checkSendNext(MTP::DcId dcId, Queue &queue);
 	bool trySendNextPart(MTP::DcId dcId, Queue &queue);
 
@@ -114,6 +180,7 @@ private:
 	void removeSession(MTP::DcId dcId);
 
 	const not_null<ApiWrap*> _api;
+	const not_null<DownloadArbiter*> _arbiter;
 
 	rpl::event_stream<> _taskFinished;
 	rpl::event_stream<DocumentId> _nonPremiumDelays;
@@ -124,6 +191,9 @@ private:
 	base::flat_map<MTP::DcId, crl::time> _killSessionsWhen;
 	base::Timer _killSessionsTimer;
 
+	base::flat_map<MTP::DcId, crl::time> _lastUsed;
+	base::flat_set<MTP::DcId> _prewarmed;
+
 	base::flat_map<MTP::DcId, Queue> _queues;
 	rpl::lifetime _lifetime;
 
@@ -155,7 +225,7 @@ public:
 	[[nodiscard]] const Location &location() const;
 
 	[[nodiscard]] virtual bool readyToRequest() const = 0;
-	void loadPart(int sessionIndex);
+	void loadPart(int sessionIndex, int available);
 	void removeSession(int sessionIndex);
 
 	void refreshFileReferenceFrom(
@@ -180,6 +250,7 @@ private:
 	struct RequestData {
 		int64 offset = 0;
 		mutable int sessionIndex = 0;
+		int limit = kDownloadPartSize;
 		int requestedInSession = 0;
 		crl::time sent = 0;
 
@@ -205,7 +276,8 @@ private:
 	};
 
 	// Called only if readyToRequest() == true.
-	[[nodiscard]] virtual int64 takeNextRequestOffset() = 0;
+	[[nodiscard]] virtual int nextRequestLimit(int available) const;
+	[[nodiscard]] virtual int64 takeNextRequestOffset(int limit) = 0;
 	virtual bool feedPart(int64 offset, const QByteArray &bytes) = 0;
 	virtual bool setWebFileSizeHook(int64 size);
 	virtual void cancelOnFail() = 0;
@@ -225,6 +297,7 @@ private:
 		const MTPVector<MTPFileHash> &result,
 		mtpRequestId requestId);
 	void requestMoreCdnFileHashes();
+	[[nodiscard]] int64 firstMissingCdnHashOffset(int64 offset) const;
 	void getCdnFileHashesDone(
 		const MTPVector<MTPFileHash> &result,
 		mtpRequestId requestId);
@@ -248,7 +321,7 @@ private:
 	void switchToCDN(
 		const RequestData &requestData,
 		const MTPDupload_fileCdnRedirect &redirect);
-	void addCdnHashes(const QVector<MTPFileHash> &hashes);
+	bool addCdnHashes(const QVector<MTPFileHash> &hashes);
 	void changeCDNParams(
 		const RequestData &requestData,
 		MTP::DcId dcId,
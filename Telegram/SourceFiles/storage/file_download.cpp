@@ -193,6 +193,10 @@ void FileLoader::permitLoadFromCloud() {
 	_fromCloud = LoadFromCloudOrLocal;
 }
 
+void FileLoader::setAutoLoading(bool autoLoading) {
+	_autoLoading = autoLoading;
+}
+
 void FileLoader::increaseLoadSize(int64 size, bool autoLoading) {
 	Expects(size > _loadSize);
 	Expects(size <= _fullSize);
@@ -211,6 +215,7 @@ void FileLoader::localLoaded(
 		const QImage &imageData) {
 	_localLoading = nullptr;
 	if (result.data.isEmpty()) {
+		_session->data().cacheLookupFinished(false);
 		_localStatus = LocalStatus::NotFound;
 		start();
 		return;
@@ -218,12 +223,14 @@ void FileLoader::localLoaded(
 	const auto partial = result.data.startsWith("partial:");
 	constexpr auto kPrefix = 8;
 	if (partial	&& result.data.size() < _loadSize + kPrefix) {
+		_session->data().cacheLookupFinished(false);
 		_localStatus = LocalStatus::NotFound;
 		if (checkForOpen()) {
 			startLoadingWithPartial(result.data);
 		}
 		return;
 	}
+	_session->data().cacheLookupFinished(true);
 	if (!imageData.isNull()) {
 		_imageFormat = imageFormat;
 		_imageData = imageData;
@@ -280,7 +287,8 @@ void FileLoader::loadLocal(const Storage::Cache::Key &key) {
 				std::move(image));
 		});
 	};
-	_session->data().cache().get(key, [=, callback = std::move(done)](
+	auto &cache = _session->data().cacheFor(_cacheTag, _fullSize);
+	cache.get(key, [=, callback = std::move(done)](
 			QByteArray &&value) mutable {
 		if (readImage && !value.startsWith("partial:")) {
 			crl::async([
@@ -458,7 +466,7 @@ bool FileLoader::finalizeResult() {
 		if ((_toCache == LoadToCacheAsWell)
 			&& (_data.size() <= Storage::kMaxFileInMemory)
 			&& (key.low || key.high)) {
-			_session->data().cache().put(
+			_session->data().cacheFor(_cacheTag, _fullSize).put(
 				cacheKey(),
 				Storage::Cache::Database::TaggedValue(
 					base::duplicate((!_fullSize || _data.size() == _fullSize)
@@ -467,6 +475,29 @@ bool FileLoader::finalizeResult() {
 					_cacheTag));
 		}
 	}
+	if (_locationType == UnknownFileLocation
+		&& _imageData.isNull()
+		&& !_data.isEmpty()) {
+		// Decode the image here instead of the first imageData() call,
+		// which comes from the main thread right in the done handler.
+		crl::async([weak = base::make_weak(this), data = _data] {
+			auto read = Images::Read({ .content = data });
+			crl::on_main(weak, [
+				=,
+				image = std::move(read.image),
+				format = std::move(read.format)
+			]() mutable {
+				if (_imageData.isNull() && !image.isNull()) {
+					_imageData = std::move(image);
+					_imageFormat = std::move(format);
+				}
+				const auto session = _session;
+				_updates.fire_done();
+				session->notifyDownloaderTaskFinished();
+			});
+		});
+		return true;
+	}
 	const auto session = _session;
 	_updates.fire_done();
 	session->notifyDownloaderTaskFinished();
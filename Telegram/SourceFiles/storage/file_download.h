@@ -107,6 +107,7 @@ public:
 
 	bool setFileName(const QString &filename); // set filename for loaders to cache
 	void permitLoadFromCloud();
+	void setAutoLoading(bool autoLoading);
 	void increaseLoadSize(int64 size, bool autoLoading);
 
 	void start();
@@ -16,6 +16,14 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "mtproto/mtproto_config.h"
 #include "mtproto/mtproto_auth_key.h"
 
+namespace {
+
+// Large automatic downloads wait for the files requested by the user.
+constexpr auto kLargeAutoLoadingSize = 10 * int64(1024 * 1024);
+constexpr auto kLargeAutoLoadingPriority = -1;
+
+} // namespace
+
 mtpFileLoader::mtpFileLoader(
 	not_null<Main::Session*> session,
 	const StorageFileLocation &location,
@@ -134,11 +142,24 @@ bool mtpFileLoader::readyToRequest() const {
 		&& (!_fullSize || _nextRequestOffset < _loadSize);
 }
 
-int64 mtpFileLoader::takeNextRequestOffset() {
+int mtpFileLoader::nextRequestLimit(int available) const {
+	constexpr auto kBig = Storage::kDownloadBigPartSize;
+
+	// Start with small parts for a fast first progress and use the big
+	// ones for the rest of large files, that needs less requests.
+	const auto big = v::is<StorageFileLocation>(location().data)
+		&& (available >= kBig)
+		&& (_nextRequestOffset >= kBig)
+		&& !(_nextRequestOffset % kBig)
+		&& (_loadSize - _nextRequestOffset >= kBig);
+	return big ? kBig : Storage::kDownloadPartSize;
+}
+
+int64 mtpFileLoader::takeNextRequestOffset(int limit) {
 	Expects(readyToRequest());
 
 	const auto result = _nextRequestOffset;
-	_nextRequestOffset += Storage::kDownloadPartSize;
+	_nextRequestOffset += limit;
 	return result;
 }
 
@@ -181,7 +202,8 @@ bool mtpFileLoader::setWebFileSizeHook(int64 size) {
 }
 
 void mtpFileLoader::startLoading() {
-	addToQueue();
+	const auto large = autoLoading() && (fullSize() > kLargeAutoLoadingSize);
+	addToQueue(large ? kLargeAutoLoadingPriority : 0);
 }
 
 void mtpFileLoader::startLoadingWithPartial(const QByteArray &data) {
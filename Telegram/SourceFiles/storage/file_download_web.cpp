@@ -15,7 +15,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 namespace {
 
-constexpr auto kMaxWebFileQueries = 8;
+constexpr auto kMaxWebFileQueries = 32;
+constexpr auto kMaxWebFileQueriesPerHost = 6;
 constexpr auto kMaxHttpRedirects = 5;
 constexpr auto kResetDownloadPrioritiesTimeout = crl::time(200);
 
@@ -43,7 +44,13 @@ struct Progress {
 	qint64 total = 0;
 };
 
-using Update = std::variant<Progress, QByteArray, Error>;
+// Received part of a streamed download, written to the file right away.
+struct Part {
+	qint64 offset = 0;
+	QByteArray bytes;
+};
+
+using Update = std::variant<Progress, Part, QByteArray, Error>;
 
 struct UpdateForLoader {
 	not_null<webFileLoader*> loader;
@@ -67,24 +74,29 @@ private:
 	struct Enqueued {
 		int id = 0;
 		QString url;
+		bool stream = false;
 	};
 	struct Sent {
 		QString url;
+		QString host;
 		not_null<QNetworkReply*> reply;
 		QByteArray data;
 		int64 ready = 0;
 		int64 total = 0;
+		int64 streamed = 0;
 		int redirectsLeft = kMaxHttpRedirects;
+		bool stream = false;
 	};
 
 	// Constructor.
 	void handleNetworkErrors();
 
 	// Worker thread.
-	void enqueue(int id, const QString &url);
+	void enqueue(int id, const QString &url, bool stream);
 	void remove(int id);
 	void resetGeneration();
 	void checkSendNext();
+	[[nodiscard]] bool hostBusy(const QString &url) const;
 	void send(const Enqueued &entry);
 	[[nodiscard]] not_null<QNetworkReply*> send(int id, const QString &url);
 	[[nodiscard]] Sent *findSent(int id, not_null<QNetworkReply*> reply);
@@ -108,6 +120,7 @@ private:
 	void finished(int id, not_null<QNetworkReply*> reply);
 	void deleteDeferred(not_null<QNetworkReply*> reply);
 	void queueProgressUpdate(int id, int64 ready, int64 total);
+	void queuePartUpdate(int id, int64 offset, QByteArray bytes);
 	void queueFailedUpdate(int id);
 	void queueFinishedUpdate(int id, const QByteArray &data);
 	void clear();
@@ -187,8 +200,9 @@ void WebLoadManager::enqueue(not_null<webFileLoader*> loader) {
 			: _ids.emplace(loader, ++_autoincrement).first->second;
 	}();
 	const auto url = loader->url();
+	const auto stream = loader->streamsToFile();
 	InvokeQueued(_network.get(), [=] {
-		enqueue(id, url);
+		enqueue(id, url, stream);
 	});
 }
 
@@ -204,7 +218,7 @@ void WebLoadManager::remove(not_null<webFileLoader*> loader) {
 	});
 }
 
-void WebLoadManager::enqueue(int id, const QString &url) {
+void WebLoadManager::enqueue(int id, const QString &url, bool stream) {
 	const auto i = ranges::find(_queue, id, &Enqueued::id);
 	if (i != end(_queue)) {
 		return;
@@ -212,7 +226,7 @@ void WebLoadManager::enqueue(int id, const QString &url) {
 	_previousGeneration.erase(
 		ranges::remove(_previousGeneration, id, &Enqueued::id),
 		end(_previousGeneration));
-	_queue.push_back(Enqueued{ id, url });
+	_queue.push_back(Enqueued{ id, url, stream });
 	if (!_resetGenerationTimer.isActive()) {
 		_resetGenerationTimer.callOnce(kResetDownloadPrioritiesTimeout);
 	}
@@ -238,22 +252,42 @@ void WebLoadManager::resetGeneration() {
 	std::swap(_queue, _previousGeneration);
 }
 
+bool WebLoadManager::hostBusy(const QString &url) const {
+	const auto host = QUrl(url).host();
+	return ranges::count(_sent, host, [](const auto &pair) {
+		return pair.second.host;
+	}) >= kMaxWebFileQueriesPerHost;
+}
+
 void WebLoadManager::checkSendNext() {
-	if (_sent.size() >= kMaxWebFileQueries
-		|| (_queue.empty() && _previousGeneration.empty())) {
-		return;
+	const auto takeNext = [&](std::deque<Enqueued> &queue) {
+		const auto i = ranges::find_if(queue, [&](const Enqueued &entry) {
+			return !hostBusy(entry.url);
+		});
+		if (i == end(queue)) {
+			return false;
+		}
+		const auto entry = *i;
+		queue.erase(i);
+		send(entry);
+		return true;
+	};
+	while (_sent.size() < kMaxWebFileQueries) {
+		if (!takeNext(_queue) && !takeNext(_previousGeneration)) {
+			return;
+		}
 	}
-	const auto entry = _queue.empty()
-		? _previousGeneration.front()
-		: _queue.front();
-	(_queue.empty() ? _previousGeneration : _queue).pop_front();
-	send(entry);
 }
 
 void WebLoadManager::send(const Enqueued &entry) {
 	const auto id = entry.id;
 	const auto url = entry.url;
-	_sent.emplace(id, Sent{ url, send(id, url) });
+	_sent.emplace(id, Sent{
+		.url = url,
+		.host = QUrl(url).host(),
+		.reply = send(id, url),
+		.stream = entry.stream,
+	});
 }
 
 void WebLoadManager::removeSent(int id) {
@@ -265,7 +299,13 @@ void WebLoadManager::removeSent(int id) {
 }
 
 not_null<QNetworkReply*> WebLoadManager::send(int id, const QString &url) {
-	const auto result = _network->get(QNetworkRequest(url));
+	auto request = QNetworkRequest(url);
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+	// Qt 6 negotiates HTTP/2 by default, many small requests
+	// to the same host are multiplexed over one pooled connection.
+	request.setAttribute(QNetworkRequest::Http2AllowedAttribute, true);
+#endif // Qt < 6.0.0
+	const auto result = _network->get(request);
 	const auto handleProgress = [=](qint64 ready, qint64 total) {
 		progress(id, result, ready, total);
 	};
@@ -324,8 +364,15 @@ void WebLoadManager::redirect(int id, not_null<QNetworkReply*> reply) {
 			failed(id, reply);
 			return;
 		}
+		if (sent->stream && sent->streamed > 0) {
+			LOG(("Network Error: "
+				"HTTP redirect after streamed data for: %1").arg(url));
+			failed(id, reply);
+			return;
+		}
 		deleteDeferred(reply);
 		sent->url = url;
+		sent->host = QUrl(url).host();
 		sent->reply = send(id, url);
 	}
 }
@@ -338,10 +385,22 @@ void WebLoadManager::notify(
 	if (const auto sent = findSent(id, reply)) {
 		sent->ready = ready;
 		sent->total = std::max(total, int64(0));
-		sent->data.append(reply->readAll());
+		if (sent->stream) {
+			auto bytes = reply->readAll();
+			if (!bytes.isEmpty()) {
+				const auto offset = sent->streamed;
+				sent->streamed += bytes.size();
+				queuePartUpdate(id, offset, std::move(bytes));
+			}
+		} else {
+			sent->data.append(reply->readAll());
+		}
+		const auto inMemoryLimit = sent->stream
+			? std::numeric_limits<int64>::max()
+			: int64(Storage::kMaxFileInMemory);
 		if (total == 0
-			|| total > Storage::kMaxFileInMemory
-			|| sent->data.size() > Storage::kMaxFileInMemory) {
+			|| total > inMemoryLimit
+			|| sent->data.size() > inMemoryLimit) {
 			LOG(("Network Error: "
 				"Bad size received for HTTP download progress "
 				"in WebLoadManager::onProgress(): %1 / %2 (bytes %3)"
@@ -412,6 +471,15 @@ void WebLoadManager::queueProgressUpdate(int id, int64 ready, int64 total) {
 	});
 }
 
+void WebLoadManager::queuePartUpdate(
+		int id,
+		int64 offset,
+		QByteArray bytes) {
+	crl::on_main(this, [=] {
+		sendUpdate(id, Part{ offset, bytes });
+	});
+}
+
 void WebLoadManager::queueFailedUpdate(int id) {
 	crl::on_main(this, [=] {
 		sendUpdate(id, Error{});
@@ -447,11 +515,11 @@ webFileLoader::webFileLoader(
 	uint8 cacheTag)
 : FileLoader(
 	session,
-	QString(),
+	to,
 	0,
 	0,
 	UnknownFileLocation,
-	LoadToCacheAsWell,
+	to.isEmpty() ? LoadToCacheAsWell : LoadToFileOnly,
 	fromCloud,
 	autoLoading,
 	cacheTag)
@@ -468,6 +536,10 @@ QString webFileLoader::url() const {
 	return _url;
 }
 
+bool webFileLoader::streamsToFile() const {
+	return !fileName().isEmpty();
+}
+
 void webFileLoader::startLoading() {
 	if (_finished) {
 		return;
@@ -478,6 +550,8 @@ void webFileLoader::startLoading() {
 		) | rpl::start_with_next([=](const Update &data) {
 			if (const auto progress = std::get_if<Progress>(&data)) {
 				loadProgress(progress->ready, progress->total);
+			} else if (const auto part = std::get_if<Part>(&data)) {
+				loadPart(part->offset, part->bytes);
 			} else if (const auto bytes = std::get_if<QByteArray>(&data)) {
 				loadFinished(*bytes);
 			} else {
@@ -498,6 +572,10 @@ void webFileLoader::loadProgress(qint64 ready, qint64 total) {
 	notifyAboutProgress();
 }
 
+void webFileLoader::loadPart(qint64 offset, const QByteArray &bytes) {
+	writeResultPart(offset, bytes::make_span(bytes));
+}
+
 void webFileLoader::loadFinished(const QByteArray &data) {
 	cancelRequest();
 	if (writeResultPart(0, bytes::make_span(data))) {
@@ -24,6 +24,9 @@ public:
 
 	[[nodiscard]] QString url() const;
 
+	// Loaders with a target file stream the body there as it arrives.
+	[[nodiscard]] bool streamsToFile() const;
+
 	int64 currentOffset() const override;
 
 private:
@@ -34,6 +37,7 @@ private:
 	std::optional<MediaKey> fileLocationKey() const override;
 
 	void loadProgress(qint64 ready, qint64 size);
+	void loadPart(qint64 offset, const QByteArray &bytes);
 	void loadFinished(const QByteArray &data);
 	void loadFailed();
 
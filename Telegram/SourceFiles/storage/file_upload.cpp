@@ -23,6 +23,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "main/main_session.h"
 #include "apiwrap.h"
 
+#include <QtCore/QFileInfo>
+
 namespace Storage {
 namespace {
 
@@ -63,6 +65,18 @@ constexpr auto kSlowRequestThreshold = 8 * crl::time(1000);
 // (it-s size + queued before size) >= 512kb.
 constexpr auto kAcceptAsFastIfTotalAtLeast = 512 * 1024;
 
+// Uploaded parts are kept on the server only for some time.
+constexpr auto kJournalTimeout = 60 * 60 * crl::time(1000);
+constexpr auto kJournalMaxEntries = 16;
+
+[[nodiscard]] QString JournalKey(const QString &filepath, int64 size) {
+	const auto modified = QFileInfo(filepath).lastModified();
+	return u"%1:%2:%3"_q
+		.arg(size)
+		.arg(modified.toMSecsSinceEpoch())
+		.arg(filepath);
+}
+
 [[nodiscard]] const char *ThumbnailFormat(const QString &mime) {
 	return Core::IsMimeSticker(mime) ? "WEBP" : "JPG";
 }
@@ -74,12 +88,16 @@ struct Uploader::Entry {
 
 	void setDocSize(int64 size);
 	bool setPartSize(int partSize);
+	[[nodiscard]] bool uploaded() const;
 
 	// const, but non-const for the move-assignment in the
 	FullMsgId itemId;
 	std::shared_ptr<FilePrepareResult> file;
 	not_null<std::vector<QByteArray>*> parts;
 	uint64 partsOfId = 0;
+	uint64 docUploadId = 0;
+	QString journalKey;
+	base::flat_set<ushort> docPartsJournaled;
 
 	int64 sentSize = 0;
 	ushort partsSent = 0;
@@ -121,7 +139,8 @@ Uploader::Entry::Entry(
 , partsOfId((file->type == SendMediaType::Photo
 	|| file->type == SendMediaType::Secure)
 		? file->id
-		: file->thumbId) {
+		: file->thumbId)
+, docUploadId(file->id) {
 	if (file->type == SendMediaType::File
 		|| file->type == SendMediaType::ThemeFile
 		|| file->type == SendMediaType::Audio) {
@@ -150,6 +169,13 @@ bool Uploader::Entry::setPartSize(int partSize) {
 	return (docPartsCount <= kDocumentMaxPartsCountDefault);
 }
 
+bool Uploader::Entry::uploaded() const {
+	return (partsSent >= parts->size())
+		&& (docPartsSent >= docPartsCount)
+		&& !partsWaiting
+		&& !docPartsWaiting;
+}
+
 Uploader::Uploader(not_null<ApiWrap*> api)
 : _api(api)
 , _nextTimer([=] { maybeSend(); })
@@ -331,6 +357,8 @@ void Uploader::upload(
 		}
 	}
 	_queue.push_back({ itemId, file });
+	applyJournal(&_queue.back());
+	maybeFinishUploaded();
 	if (!_nextTimer.isActive()) {
 		maybeSend();
 	}
@@ -344,7 +372,7 @@ void Uploader::failed(FullMsgId itemId) {
 		notifyFailed(entry);
 	}
 	cancelRequests(itemId);
-	maybeFinishFront();
+	maybeFinishUploaded();
 	crl::on_main(this, [=] {
 		maybeSend();
 	});
@@ -398,8 +426,8 @@ QByteArray Uploader::readDocPart(not_null<Entry*> entry) {
 		return result;
 	};
 	auto &content = entry->file->content;
+	const auto offset = entry->docPartsSent * int64(entry->docPartSize);
 	if (!content.isEmpty()) {
-		const auto offset = entry->docPartsSent * entry->docPartSize;
 		return checked(content.mid(offset, entry->docPartSize));
 	} else if (!entry->docFile) {
 		const auto filepath = entry->file->filepath;
@@ -408,9 +436,79 @@ QByteArray Uploader::readDocPart(not_null<Entry*> entry) {
 			return QByteArray();
 		}
 	}
+	if (entry->docFile->pos() != offset && !entry->docFile->seek(offset)) {
+		return QByteArray();
+	}
 	return checked(entry->docFile->read(entry->docPartSize));
 }
 
+void Uploader::applyJournal(not_null<Entry*> entry) {
+	const auto &file = entry->file;
+	if (file->filepath.isEmpty()
+		|| !file->content.isEmpty()
+		|| entry->docSize <= kUseBigFilesFrom) {
+		return;
+	}
+	clearStaleJournal();
+	entry->journalKey = JournalKey(file->filepath, entry->docSize);
+	const auto i = _journal.find(entry->journalKey);
+	if (i == end(_journal) || i->second.partSize != entry->docPartSize) {
+		return;
+	}
+	DEBUG_LOG(("Uploader: Resuming upload of %1, %2 of %3 parts done."
+		).arg(file->filepath
+		).arg(i->second.parts.size()
+		).arg(entry->docPartsCount));
+	entry->docUploadId = i->second.fileId;
+	entry->docPartsJournaled = i->second.parts;
+	skipJournaledParts(entry);
+}
+
+void Uploader::skipJournaledParts(not_null<Entry*> entry) {
+	auto &journaled = entry->docPartsJournaled;
+	while (entry->docPartsSent < entry->docPartsCount
+		&& journaled.contains(entry->docPartsSent)) {
+		const auto offset = entry->docPartsSent * int64(entry->docPartSize);
+		entry->docSentSize += std::min(
+			int64(entry->docPartSize),
+			entry->docSize - offset);
+		++entry->docPartsSent;
+	}
+}
+
+void Uploader::journalPart(const Entry &entry, ushort part) {
+	if (entry.journalKey.isEmpty()) {
+		return;
+	}
+	auto &journal = _journal[entry.journalKey];
+	if (journal.fileId != entry.docUploadId
+		|| journal.partSize != entry.docPartSize) {
+		journal = JournalEntry{
+			.fileId = entry.docUploadId,
+			.partSize = entry.docPartSize,
+		};
+	}
+	journal.parts.emplace(part);
+	journal.updated = crl::now();
+}
+
+void Uploader::clearStaleJournal() {
+	const auto now = crl::now();
+	for (auto i = begin(_journal); i != end(_journal);) {
+		if (now - i->second.updated >= kJournalTimeout) {
+			i = _journal.erase(i);
+		} else {
+			++i;
+		}
+	}
+	while (_journal.size() > kJournalMaxEntries) {
+		_journal.erase(ranges::min_element(
+			_journal,
+			ranges::less(),
+			[](const auto &pair) { return pair.second.updated; }));
+	}
+}
+
 bool Uploader::canAddDcIndex() const {
 	const auto count = int(_sentPerDcIndex.size());
 	return (count < kMaxSessionsCount)
@@ -502,13 +600,15 @@ auto Uploader::sendPendingPart(not_null<Entry*> entry, uchar dcIndex)
 	request.dcIndex = dcIndex;
 	if (request.bigPart) {
 		sendPreparedRequest(MTPupload_SaveBigFilePart(
-			MTP_long(entry->file->id),
+			MTP_long(entry->docUploadId),
 			MTP_int(part),
 			MTP_int(entry->docPartsCount),
 			MTP_bytes(bytes)
 		), std::move(request));
 	} else {
-		const auto id = request.docPart ? entry->file->id : entry->partsOfId;
+		const auto id = request.docPart
+			? entry->docUploadId
+			: entry->partsOfId;
 		sendPreparedRequest(MTPupload_SaveFilePart(
 			MTP_long(id),
 			MTP_int(part),
@@ -536,6 +636,7 @@ auto Uploader::sendDocPart(not_null<Entry*> entry, uchar dcIndex)
 	}
 	const auto part = entry->docPartsSent++;
 	++entry->docPartsWaiting;
+	skipJournaledParts(entry);
 
 	const auto send = [&](auto &&request, bool big) {
 		sendPreparedRequest(std::move(request), {
@@ -549,14 +650,14 @@ auto Uploader::sendDocPart(not_null<Entry*> entry, uchar dcIndex)
 	};
 	if (entry->docSize > kUseBigFilesFrom) {
 		send(MTPupload_SaveBigFilePart(
-			MTP_long(entry->file->id),
+			MTP_long(entry->docUploadId),
 			MTP_int(part),
 			MTP_int(entry->docPartsCount),
 			MTP_bytes(partBytes)
 		), true);
 	} else {
 		send(MTPupload_SaveFilePart(
-			MTP_long(entry->file->id),
+			MTP_long(entry->docUploadId),
 			MTP_int(part),
 			MTP_bytes(partBytes)
 		), false);
@@ -701,6 +802,10 @@ void Uploader::partLoaded(const MTPBool &result, mtpRequestId requestId) {
 	const auto itemId = request.itemId;
 
 	if (mtpIsFalse(result)) { // failed to upload current file
+		const auto i = ranges::find(_queue, itemId, &Entry::itemId);
+		if (i != end(_queue) && !i->journalKey.isEmpty()) {
+			_journal.remove(i->journalKey);
+		}
 		failed(itemId);
 		return;
 	}
@@ -742,6 +847,7 @@ void Uploader::partLoaded(const MTPBool &result, mtpRequestId requestId) {
 	if (request.docPart) {
 		--entry.docPartsWaiting;
 		entry.docSentSize += bytes;
+		journalPart(entry, request.part);
 	} else {
 		--entry.partsWaiting;
 		entry.sentSize += bytes;
@@ -775,9 +881,7 @@ void Uploader::partLoaded(const MTPBool &result, mtpRequestId requestId) {
 		_nonPremiumDelays.fire_copy(itemId);
 	}
 
-	if (!_queue.empty() && itemId == _queue.front().itemId) {
-		maybeFinishFront();
-	}
+	maybeFinishUploaded();
 	maybeSend();
 }
 
@@ -803,25 +907,44 @@ void Uploader::removeDcIndex() {
 	DEBUG_LOG(("Uploader: Removed dc index %1.").arg(dcIndex));
 }
 
-void Uploader::maybeFinishFront() {
-	while (!_queue.empty()) {
-		const auto &entry = _queue.front();
-		if (entry.partsSent >= entry.parts->size()
-			&& entry.docPartsSent >= entry.docPartsCount
-			&& !entry.partsWaiting
-			&& !entry.docPartsWaiting) {
-			finishFront();
-		} else {
+void Uploader::maybeFinishUploaded() {
+	// Ready handlers may change the queue, so look it up each time.
+	while (true) {
+		const auto index = findUploadedToFinish();
+		if (index < 0) {
 			break;
 		}
+		finish(index);
 	}
 }
 
-void Uploader::finishFront() {
-	Expects(!_queue.empty());
+int Uploader::findUploadedToFinish() const {
+	if (_queue.empty()) {
+		return -1;
+	}
+	// The album is sent by sendMultiMedia when all of its items are
+	// ready, so a small item doesn't wait for a large one before it.
+	const auto album = _queue.front().file->album.get();
+	for (auto i = 0, count = int(_queue.size()); i != count; ++i) {
+		const auto &entry = _queue[i];
+		if (i > 0 && (!album || entry.file->album.get() != album)) {
+			break;
+		} else if (entry.uploaded()) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+void Uploader::finish(int index) {
+	Expects(index >= 0 && index < int(_queue.size()));
 
-	auto entry = std::move(_queue.front());
-	_queue.erase(_queue.begin());
+	auto entry = std::move(_queue[index]);
+	_queue.erase(begin(_queue) + index);
+
+	if (!entry.journalKey.isEmpty()) {
+		_journal.remove(entry.journalKey);
+	}
 
 	const auto options = entry.file
 		? entry.file->to.options
@@ -862,11 +985,11 @@ void Uploader::finishFront() {
 
 		const auto file = (entry.docSize > kUseBigFilesFrom)
 			? MTP_inputFileBig(
-				MTP_long(entry.file->id),
+				MTP_long(entry.docUploadId),
 				MTP_int(entry.docPartsCount),
 				MTP_string(entry.file->filename))
 			: MTP_inputFile(
-				MTP_long(entry.file->id),
+				MTP_long(entry.docUploadId),
 				MTP_int(entry.docPartsCount),
 				MTP_string(entry.file->filename),
 				MTP_bytes(docMd5));
@@ -102,6 +102,12 @@ public:
 private:
 	struct Entry;
 	struct Request;
+	struct JournalEntry {
+		uint64 fileId = 0;
+		int partSize = 0;
+		base::flat_set<ushort> parts;
+		crl::time updated = 0;
+	};
 
 	enum class SendResult : uchar {
 		Success,
@@ -124,11 +130,19 @@ private:
 	[[nodiscard]] QByteArray readDocPart(not_null<Entry*> entry);
 	void removeDcIndex();
 
+	void applyJournal(not_null<Entry*> entry);
+	void skipJournaledParts(not_null<Entry*> entry);
+	void journalPart(const Entry &entry, ushort part);
+	void clearStaleJournal();
+
 	template <typename Prepared>
 	void sendPreparedRequest(Prepared &&prepared, Request &&request);
 
-	void maybeFinishFront();
-	void finishFront();
+	// Uploaded entries finish in the queue order, except for the items of
+	// the album at the front, those may finish in any order.
+	void maybeFinishUploaded();
+	[[nodiscard]] int findUploadedToFinish() const;
+	void finish(int index);
 
 	void partLoaded(const MTPBool &result, mtpRequestId requestId);
 	void partFailed(const MTP::Error &error, mtpRequestId requestId);
@@ -163,6 +177,9 @@ private:
 	crl::time _latestDcIndexRemoved = 0;
 	std::vector<Request> _pendingFromRemovedDcIndices;
 
+	// Confirmed parts of big files by local file, to resume re-uploads.
+	base::flat_map<QString, JournalEntry> _journal;
+
 	FullMsgId _pausedId;
 	base::Timer _nextTimer, _stopSessionsTimer;
 
@@ -222,7 +222,8 @@ int PhotoSideLimit() {
 	return PhotoSideLimit(SendLargePhotos.value());
 }
 
-TaskQueue::TaskQueue(crl::time stopTimeoutMs) {
+TaskQueue::TaskQueue(crl::time stopTimeoutMs, int workersCount)
+: _workersCount(std::max(workersCount, 1)) {
 	if (stopTimeoutMs > 0) {
 		_stopTimer = new QTimer(this);
 		connect(_stopTimer, SIGNAL(timeout()), this, SLOT(stop()));
@@ -238,7 +239,7 @@ TaskId TaskQueue::addTask(std::unique_ptr<Task> &&task) {
 		_tasksToProcess.push_back(std::move(task));
 	}
 
-	wakeThread();
+	wakeThreads();
 
 	return result;
 }
@@ -251,20 +252,23 @@ void TaskQueue::addTasks(std::vector<std::unique_ptr<Task>> &&tasks) {
 		}
 	}
 
-	wakeThread();
+	wakeThreads();
 }
 
-void TaskQueue::wakeThread() {
-	if (!_thread) {
-		_thread = new QThread();
+void TaskQueue::wakeThreads() {
+	if (_workers.empty()) {
+		_workers.reserve(_workersCount);
+		for (auto i = 0; i != _workersCount; ++i) {
+			const auto thread = new QThread();
+			const auto worker = new TaskQueueWorker(this);
+			worker->moveToThread(thread);
 
-		_worker = new TaskQueueWorker(this);
-		_worker->moveToThread(_thread);
+			connect(this, SIGNAL(taskAdded()), worker, SLOT(onTaskAdded()));
+			connect(worker, SIGNAL(taskProcessed()), this, SLOT(onTaskProcessed()));
 
-		connect(this, SIGNAL(taskAdded()), _worker, SLOT(onTaskAdded()));
-		connect(_worker, SIGNAL(taskProcessed()), this, SLOT(onTaskProcessed()));
-
-		_thread->start();
+			thread->start();
+			_workers.push_back({ .thread = thread, .worker = worker });
+		}
 	}
 	if (_stopTimer) _stopTimer->stop();
 	taskAdded();
@@ -280,15 +284,63 @@ void TaskQueue::cancelTask(TaskId id) {
 			queue.erase(i);
 		}
 	};
+	auto finishLater = false;
 	{
 		QMutexLocker lock(&_tasksToProcessMutex);
 		removeFrom(_tasksToProcess);
-		if (_taskInProcessId == id) {
-			_taskInProcessId = TaskId();
+		const auto i = ranges::find(_tasksInProcess, id, &InProcess::id);
+		if (i != end(_tasksInProcess)) {
+			_tasksInProcess.erase(i);
+
+			// Tasks that waited for the cancelled one can be finished now.
+			finishLater = moveProcessedToFinish();
 		}
 	}
+	{
+		QMutexLocker lock(&_tasksToFinishMutex);
+		removeFrom(_tasksToFinish);
+	}
+	if (finishLater) {
+		crl::on_main(this, [=] { onTaskProcessed(); });
+	}
+}
+
+std::unique_ptr<Task> TaskQueue::takeTaskToProcess() {
+	QMutexLocker lock(&_tasksToProcessMutex);
+	if (_tasksToProcess.empty()) {
+		return nullptr;
+	}
+	auto result = std::move(_tasksToProcess.front());
+	_tasksToProcess.pop_front();
+	_tasksInProcess.push_back({ .id = result->id() });
+	return result;
+}
+
+bool TaskQueue::taskProcessed(std::unique_ptr<Task> task) {
+	QMutexLocker lock(&_tasksToProcessMutex);
+	const auto i = ranges::find(_tasksInProcess, task->id(), &InProcess::id);
+	if (i == end(_tasksInProcess)) {
+		// Cancelled while processing, destroy it outside of the lock.
+		lock.unlock();
+		task = nullptr;
+		return false;
+	}
+	i->processed = std::move(task);
+	return moveProcessedToFinish();
+}
+
+bool TaskQueue::moveProcessedToFinish() {
+	if (_tasksInProcess.empty() || !_tasksInProcess.front().processed) {
+		return false;
+	}
 	QMutexLocker lock(&_tasksToFinishMutex);
-	removeFrom(_tasksToFinish);
+	const auto wasEmpty = _tasksToFinish.empty();
+	while (!_tasksInProcess.empty() && _tasksInProcess.front().processed) {
+		_tasksToFinish.push_back(
+			std::move(_tasksInProcess.front().processed));
+		_tasksInProcess.pop_front();
+	}
+	return wasEmpty;
 }
 
 void TaskQueue::onTaskProcessed() {
@@ -305,24 +357,28 @@ void TaskQueue::onTaskProcessed() {
 
 	if (_stopTimer) {
 		QMutexLocker lock(&_tasksToProcessMutex);
-		if (_tasksToProcess.empty() && !_taskInProcessId) {
+		if (_tasksToProcess.empty() && _tasksInProcess.empty()) {
 			_stopTimer->start();
 		}
 	}
 }
 
 void TaskQueue::stop() {
-	if (_thread) {
-		_thread->requestInterruption();
-		_thread->quit();
+	for (const auto &worker : _workers) {
+		worker.thread->requestInterruption();
+		worker.thread->quit();
+	}
+	if (!_workers.empty()) {
 		DEBUG_LOG(("Waiting for taskThread to finish"));
-		_thread->wait();
-		delete base::take(_worker);
-		delete base::take(_thread);
+	}
+	for (const auto &worker : base::take(_workers)) {
+		worker.thread->wait();
+		delete worker.worker;
+		delete worker.thread;
 	}
 	_tasksToProcess.clear();
 	_tasksToFinish.clear();
-	_taskInProcessId = TaskId();
+	_tasksInProcess.clear();
 }
 
 TaskQueue::~TaskQueue() {
@@ -334,38 +390,17 @@ void TaskQueueWorker::onTaskAdded() {
 	if (_inTaskAdded) return;
 	_inTaskAdded = true;
 
-	bool someTasksLeft = false;
-	do {
-		auto task = std::unique_ptr<Task>();
-		{
-			QMutexLocker lock(&_queue->_tasksToProcessMutex);
-			if (!_queue->_tasksToProcess.empty()) {
-				task = std::move(_queue->_tasksToProcess.front());
-				_queue->_tasksToProcess.pop_front();
-				_queue->_taskInProcessId = task->id();
-			}
+	while (!thread()->isInterruptionRequested()) {
+		auto task = _queue->takeTaskToProcess();
+		if (!task) {
+			break;
 		}
-
-		if (task) {
-			task->process();
-			bool emitTaskProcessed = false;
-			{
-				QMutexLocker lockToProcess(&_queue->_tasksToProcessMutex);
-				if (_queue->_taskInProcessId == task->id()) {
-					_queue->_taskInProcessId = TaskId();
-					someTasksLeft = !_queue->_tasksToProcess.empty();
-
-					QMutexLocker lockToFinish(&_queue->_tasksToFinishMutex);
-					emitTaskProcessed = _queue->_tasksToFinish.empty();
-					_queue->_tasksToFinish.push_back(std::move(task));
-				}
-			}
-			if (emitTaskProcessed) {
-				taskProcessed();
-			}
+		task->process();
+		if (_queue->taskProcessed(std::move(task))) {
+			taskProcessed();
 		}
 		QCoreApplication::processEvents();
-	} while (someTasksLeft && !thread()->isInterruptionRequested());
+	}
 
 	_inTaskAdded = false;
 }
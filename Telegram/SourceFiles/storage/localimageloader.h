@@ -56,7 +56,10 @@ class TaskQueue : public QObject {
 	Q_OBJECT
 
 public:
-	explicit TaskQueue(crl::time stopTimeoutMs = 0); // <= 0 - never stop worker
+	// stopTimeoutMs <= 0 - never stop workers.
+	// Tasks are processed by up to workersCount threads at once,
+	// but finish() is always called in the order the tasks were added.
+	explicit TaskQueue(crl::time stopTimeoutMs = 0, int workersCount = 1);
 
 	TaskId addTask(std::unique_ptr<Task> &&task);
 	void addTasks(std::vector<std::unique_ptr<Task>> &&tasks);
@@ -74,14 +77,30 @@ public Q_SLOTS:
 private:
 	friend class TaskQueueWorker;
 
-	void wakeThread();
+	struct InProcess {
+		TaskId id = kEmptyTaskId;
+		std::unique_ptr<Task> processed;
+	};
+	struct Worker {
+		QThread *thread = nullptr;
+		TaskQueueWorker *worker = nullptr;
+	};
+
+	void wakeThreads();
+
+	// Called from the worker threads.
+	[[nodiscard]] std::unique_ptr<Task> takeTaskToProcess();
+	[[nodiscard]] bool taskProcessed(std::unique_ptr<Task> task);
+
+	// Requires _tasksToProcessMutex to be locked.
+	[[nodiscard]] bool moveProcessedToFinish();
 
 	std::deque<std::unique_ptr<Task>> _tasksToProcess;
 	std::deque<std::unique_ptr<Task>> _tasksToFinish;
-	TaskId _taskInProcessId = TaskId();
+	std::deque<InProcess> _tasksInProcess;
 	QMutex _tasksToProcessMutex, _tasksToFinishMutex;
-	QThread *_thread = nullptr;
-	TaskQueueWorker *_worker = nullptr;
+	std::vector<Worker> _workers;
+	int _workersCount = 1;
 	QTimer *_stopTimer = nullptr;
 
 };
@@ -27,6 +27,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "history/history.h"
 #include "core/application.h"
 #include "core/core_settings.h"
+#include "core/core_startup_trace.h"
 #include "core/file_location.h"
 #include "data/components/recent_peers.h"
 #include "data/components/top_peers.h"
@@ -46,6 +47,7 @@ using namespace details;
 using Database = Cache::Database;
 
 constexpr auto kDelayedWriteTimeout = crl::time(1000);
+constexpr auto kMapJournalLimit = 64;
 constexpr auto kWriteSearchSuggestionsDelay = 5 * crl::time(1000);
 
 constexpr auto kStickersVersionTag = quint32(-1);
@@ -67,6 +69,12 @@ constexpr auto kMultiDraftTag = quint64(0xFFFF'FFFF'FFFF'FF03ULL);
 constexpr auto kMultiDraftCursorsTag = quint64(0xFFFF'FFFF'FFFF'FF04ULL);
 constexpr auto kRichDraftsTag = quint64(0xFFFF'FFFF'FFFF'FF05ULL);
 
+// Rewrite the cache index soon after it has grown stale,
+// but in small chunks, so that reads are not stuck behind the compactor.
+constexpr auto kCacheCompactAfterExcess = int64(2 * 1024 * 1024);
+constexpr auto kCacheCompactAfterFullSize = int64(16 * 1024 * 1024);
+constexpr auto kCacheCompactChunkSize = 4 * 1024;
+
 enum { // Local Storage Keys
 	lskUserMap = 0x00,
 	lskDraft = 0x01, // data: PeerId peer
@@ -130,6 +138,12 @@ auto EmptyMessageDraftSources()
 	return cWorkingDir() + u"tdata/tdld/"_q;
 }
 
+void ApplyCacheCompactionSettings(Cache::Database::Settings &settings) {
+	settings.compactAfterExcess = kCacheCompactAfterExcess;
+	settings.compactAfterFullSize = kCacheCompactAfterFullSize;
+	settings.compactChunkSize = kCacheCompactChunkSize;
+}
+
 } // namespace
 
 Account::Account(not_null<Main::Account*> owner, const QString &dataName)
@@ -145,13 +159,16 @@ Account::Account(not_null<Main::Account*> owner, const QString &dataName)
 , _cacheBigFileTotalTimeLimit(Database::Settings().totalTimeLimit)
 , _writeMapTimer([=] { writeMap(); })
 , _writeLocationsTimer([=] { writeLocations(); })
-, _writeSearchSuggestionsTimer([=] { writeSearchSuggestions(); }) {
+, _writeSearchSuggestionsTimer([=] { writeSearchSuggestions(); })
+, _writeInstalledSetsTimer([=] { writeInstalledSetsIfNeeded(); }) {
 }
 
 Account::~Account() {
 	Expects(!_writeSearchSuggestionsTimer.isActive());
 
-	if (_localKey && _mapChanged) {
+	if (_localKey && (_mapChanged || !_mapJournal.empty())) {
+		// Leave a complete map for the versions without the journal.
+		_mapChanged = true;
 		writeMap();
 	}
 }
@@ -175,11 +192,39 @@ std::unique_ptr<MTP::Config> Account::start(MTP::AuthKeyPtr localKey) {
 	Expects(localKey != nullptr);
 
 	_localKey = std::move(localKey);
-	readMapWith(_localKey);
+	{
+		const auto trace = Core::StartupTrace::Span("Account::readMap");
+		readMapWith(_localKey);
+	}
+	prefetchStickerSets();
 	clearLegacyFiles();
 	return readMtpConfig();
 }
 
+void Account::prefetchMap() const {
+	PrefetchFiles({ u"map"_q, u"mapj"_q }, _basePath);
+	PrefetchFiles({ ToFilePart(_dataNameKey) }, BaseGlobalPath());
+}
+
+void Account::prefetchStickerSets() const {
+	// Those are read right after the session is created.
+	const auto keys = {
+		_installedStickersKey,
+		_installedCustomEmojiKey,
+		_featuredStickersKey,
+		_featuredCustomEmojiKey,
+		_recentStickersKey,
+		_favedStickersKey,
+	};
+	auto names = std::vector<QString>();
+	for (const auto key : keys) {
+		if (key) {
+			names.push_back(ToFilePart(key));
+		}
+	}
+	PrefetchFiles(std::move(names), _basePath);
+}
+
 void Account::startAdded(MTP::AuthKeyPtr localKey) {
 	Expects(localKey != nullptr);
 
@@ -225,6 +270,9 @@ base::flat_set<QString> Account::collectGoodNames() const {
 		"map0",
 		"map1",
 		"maps",
+		"mapj0",
+		"mapj1",
+		"mapjs",
 		"configs",
 	};
 	const auto push = [&](FileKey key) {
@@ -428,6 +476,7 @@ Account::ReadMapResult Account::readMapWith(
 			return ReadMapResult::Failed;
 		}
 	}
+	readMapJournal(localKey, draftsMap, draftCursorsMap, draftsNotReadMap);
 
 	_localKey = std::move(localKey);
 
@@ -460,7 +509,7 @@ Account::ReadMapResult Account::readMapWith(
 	_webviewStorageIdBots.token = webviewStorageTokenBots;
 	_webviewStorageIdOther.token = webviewStorageTokenOther;
 
-	if (_oldMapVersion < AppVersion) {
+	if (_oldMapVersion < AppVersion || !_mapJournal.empty()) {
 		writeMapDelayed();
 	} else {
 		_mapChanged = false;
@@ -516,10 +565,6 @@ void Account::writeMap() {
 		QDir().mkpath(_basePath);
 	}
 
-	FileWriteDescriptor map(u"map"_q, _basePath);
-	map.writeData(QByteArray());
-	map.writeData(QByteArray());
-
 	uint32 mapSize = 0;
 	const auto self = [&] {
 		if (!_owner->sessionExists()) {
@@ -640,13 +685,116 @@ void Account::writeMap() {
 			<< _webviewStorageIdBots.token
 			<< _webviewStorageIdOther.token;
 	}
-	map.writeEncrypted(mapData, _localKey);
+	{
+		// The map should be on disk before the journal is cleared.
+		const auto sync = !_mapJournal.empty();
+		FileWriteDescriptor map(u"map"_q, _basePath, sync);
+		map.writeData(QByteArray());
+		map.writeData(QByteArray());
+		map.writeEncrypted(mapData, _localKey);
+	}
+	clearMapJournal();
 
 	_mapChanged = false;
 }
 
+void Account::readMapJournal(
+		const MTP::AuthKeyPtr &localKey,
+		base::flat_map<PeerId, FileKey> &draftsMap,
+		base::flat_map<PeerId, FileKey> &draftCursorsMap,
+		base::flat_map<PeerId, bool> &draftsNotReadMap) {
+	_mapJournal.clear();
+
+	FileReadDescriptor journal;
+	if (!ReadFile(journal, u"mapj"_q, _basePath)) {
+		return;
+	}
+	while (!journal.stream.atEnd()) {
+		auto encrypted = QByteArray();
+		journal.stream >> encrypted;
+
+		EncryptedDescriptor record;
+		if (!CheckStreamStatus(journal.stream)
+			|| !DecryptLocal(record, encrypted, localKey)) {
+			LOG(("App Error: could not decrypt map journal record."));
+			return;
+		}
+		quint32 keyType = 0;
+		quint64 peerIdSerialized = 0, key = 0;
+		record.stream >> keyType >> peerIdSerialized >> key;
+		if (!CheckStreamStatus(record.stream)) {
+			return;
+		}
+		const auto peerId = DeserializePeerId(peerIdSerialized);
+		switch (keyType) {
+		case lskDraft: {
+			if (key) {
+				draftsMap[peerId] = key;
+				draftsNotReadMap[peerId] = true;
+			} else {
+				draftsMap.remove(peerId);
+				draftsNotReadMap.remove(peerId);
+			}
+		} break;
+		case lskDraftPosition: {
+			if (key) {
+				draftCursorsMap[peerId] = key;
+			} else {
+				draftCursorsMap.remove(peerId);
+			}
+		} break;
+		default:
+			LOG(("App Error: unknown key type in map journal: %1"
+				).arg(keyType));
+			return;
+		}
+		_mapJournal.push_back(std::move(encrypted));
+	}
+}
+
+void Account::writeMapJournal(quint32 keyType, PeerId peerId, FileKey key) {
+	Expects(_localKey != nullptr);
+
+	if (_mapChanged) {
+		// Full map write is already scheduled, it will have this change.
+		return;
+	} else if (_mapJournal.size() >= kMapJournalLimit) {
+		writeMapDelayed();
+		return;
+	}
+	EncryptedDescriptor record(sizeof(quint32) + 2 * sizeof(quint64));
+	record.stream << keyType << SerializePeerId(peerId) << quint64(key);
+	_mapJournal.push_back(PrepareEncrypted(record, _localKey));
+
+	if (!_mapJournalWriteQueued) {
+		_mapJournalWriteQueued = true;
+		crl::on_main(_owner, [=] {
+			writeMapJournalFile();
+		});
+	}
+}
+
+void Account::writeMapJournalFile() {
+	_mapJournalWriteQueued = false;
+
+	FileWriteDescriptor journal(u"mapj"_q, _basePath);
+	for (const auto &record : _mapJournal) {
+		journal.writeData(record);
+	}
+}
+
+void Account::clearMapJournal() {
+	if (_mapJournal.empty()) {
+		return;
+	}
+	_mapJournal.clear();
+	writeMapJournalFile();
+}
+
 void Account::reset() {
 	_writeSearchSuggestionsTimer.cancel();
+	_writeInstalledSetsTimer.cancel();
+	_installedSetsToWrite.clear();
 
 	auto names = collectGoodNames();
 	_draftsMap.clear();
@@ -1172,7 +1320,7 @@ void Account::writeDrafts(not_null<History*> history) {
 		if (i != _draftsMap.cend()) {
 			ClearKey(i->second, _basePath);
 			_draftsMap.erase(i);
-			writeMapDelayed();
+			writeMapJournal(lskDraft, peerId, 0);
 		}
 
 		_draftsNotReadMap.remove(peerId);
@@ -1182,7 +1330,7 @@ void Account::writeDrafts(not_null<History*> history) {
 	auto i = _draftsMap.find(peerId);
 	if (i == _draftsMap.cend()) {
 		i = _draftsMap.emplace(peerId, GenerateKey(_basePath)).first;
-		writeMapQueued();
+		writeMapJournal(lskDraft, peerId, i->second);
 	}
 
 	auto size = int(sizeof(quint64) * 2 + sizeof(quint32));
@@ -1267,7 +1415,7 @@ void Account::writeDraftCursors(not_null<History*> history) {
 	auto i = _draftCursorsMap.find(peerId);
 	if (i == _draftCursorsMap.cend()) {
 		i = _draftCursorsMap.emplace(peerId, GenerateKey(_basePath)).first;
-		writeMapQueued();
+		writeMapJournal(lskDraftPosition, peerId, i->second);
 	}
 
 	auto size = int(sizeof(quint64) * 2
@@ -1307,7 +1455,7 @@ void Account::clearDraftCursors(PeerId peerId) {
 	if (i != _draftCursorsMap.cend()) {
 		ClearKey(i->second, _basePath);
 		_draftCursorsMap.erase(i);
-		writeMapDelayed();
+		writeMapJournal(lskDraftPosition, peerId, 0);
 	}
 }
 
@@ -1697,6 +1845,7 @@ Cache::Database::Settings Account::cacheSettings() const {
 	result.totalSizeLimit = _cacheTotalSizeLimit;
 	result.totalTimeLimit = _cacheTotalTimeLimit;
 	result.maxDataSize = kMaxFileInMemory;
+	ApplyCacheCompactionSettings(result);
 	return result;
 }
 
@@ -1733,6 +1882,7 @@ Cache::Database::Settings Account::cacheBigFileSettings() const {
 	result.totalSizeLimit = _cacheBigFileTotalSizeLimit;
 	result.totalTimeLimit = _cacheBigFileTotalTimeLimit;
 	result.maxDataSize = kMaxFileInMemory;
+	ApplyCacheCompactionSettings(result);
 	return result;
 }
 
@@ -2164,6 +2314,8 @@ void Account::readStickerSets(
 void Account::writeInstalledStickers() {
 	using SetFlag = Data::StickersSetFlag;
 
+	_installedSetsToWrite.remove(Data::StickersType::Stickers);
+
 	writeStickerSets(_installedStickersKey, [](const Data::StickersSet &set) {
 		if (set.id == Data::Stickers::CloudRecentSetId
 			|| set.id == Data::Stickers::FavedSetId
@@ -2274,6 +2426,8 @@ void Account::writeArchivedMasks() {
 void Account::writeInstalledMasks() {
 	using SetFlag = Data::StickersSetFlag;
 
+	_installedSetsToWrite.remove(Data::StickersType::Masks);
+
 	writeStickerSets(_installedMasksKey, [](const Data::StickersSet &set) {
 		if (!(set.flags & SetFlag::Installed)
 			|| (set.flags & SetFlag::Archived)
@@ -2286,6 +2440,7 @@ void Account::writeInstalledMasks() {
 }
 
 void Account::writeRecentMasks() {
+	_owner->session().data().stickers().ensureMasksLoaded();
 	writeStickerSets(_recentMasksKey, [](const Data::StickersSet &set) {
 		if (set.id != Data::Stickers::CloudRecentAttachedSetId
 			|| set.stickers.isEmpty()) {
@@ -2298,6 +2453,8 @@ void Account::writeRecentMasks() {
 void Account::writeInstalledCustomEmoji() {
 	using SetFlag = Data::StickersSetFlag;
 
+	_installedSetsToWrite.remove(Data::StickersType::Emoji);
+
 	writeStickerSets(_installedCustomEmojiKey, [](const Data::StickersSet &set) {
 		if (!(set.flags & SetFlag::Installed)
 			|| (set.flags & SetFlag::Archived)
@@ -2313,6 +2470,28 @@ void Account::writeInstalledCustomEmoji() {
 	}, _owner->session().data().stickers().emojiSetsOrder());
 }
 
+void Account::writeInstalledSetsDelayed(Data::StickersType type) {
+	_installedSetsToWrite.emplace(type);
+	if (!_writeInstalledSetsTimer.isActive()) {
+		_writeInstalledSetsTimer.callOnce(kDelayedWriteTimeout);
+	}
+}
+
+void Account::writeInstalledSetsIfNeeded() {
+	_writeInstalledSetsTimer.cancel();
+	if (!_owner->sessionExists()) {
+		_installedSetsToWrite.clear();
+		return;
+	}
+	for (const auto type : base::take(_installedSetsToWrite)) {
+		switch (type) {
+		case Data::StickersType::Stickers: writeInstalledStickers(); break;
+		case Data::StickersType::Masks: writeInstalledMasks(); break;
+		case Data::StickersType::Emoji: writeInstalledCustomEmoji(); break;
+		}
+	}
+}
+
 void Account::importOldRecentStickers() {
 	using SetFlag = Data::StickersSetFlag;
 
@@ -2765,6 +2944,8 @@ void Account::writeExportSettings(const Export::Settings &settings) {
 		&& settings.path == check.path
 		&& settings.format == check.format
 		&& settings.availableAt == check.availableAt
+		&& settings.onlyNewMessages == check.onlyNewMessages
+		&& settings.packToArchive == check.packToArchive
 		&& !settings.onlySinglePeer()) {
 		if (_exportSettingsKey) {
 			ClearKey(_exportSettingsKey, _basePath);
@@ -2779,7 +2960,7 @@ void Account::writeExportSettings(const Export::Settings &settings) {
 	}
 	quint32 size = sizeof(quint32) * 6
 		+ Serialize::stringSize(settings.path)
-		+ sizeof(qint32) * 2 + sizeof(quint64);
+		+ sizeof(qint32) * 3 + sizeof(quint64);
 	EncryptedDescriptor data(size);
 	data.stream
 		<< quint32(settings.types)
@@ -2812,6 +2993,8 @@ void Account::writeExportSettings(const Export::Settings &settings) {
 	});
 	data.stream << qint32(settings.singlePeerFrom);
 	data.stream << qint32(settings.singlePeerTill);
+	data.stream << qint32(settings.onlyNewMessages ? 1 : 0);
+	data.stream << qint32(settings.packToArchive ? 1 : 0);
 
 	FileWriteDescriptor file(_exportSettingsKey, _basePath);
 	file.writeEncrypted(data, _localKey);
@@ -2834,6 +3017,8 @@ Export::Settings Account::readExportSettings() {
 	quint64 singlePeerBareId = 0;
 	quint64 singlePeerAccessHash = 0;
 	qint32 singlePeerFrom = 0, singlePeerTill = 0;
+	qint32 onlyNewMessages = 0;
+	qint32 packToArchive = 0;
 	file.stream
 		>> types
 		>> fullChats
@@ -2864,6 +3049,12 @@ Export::Settings Account::readExportSettings() {
 	if (!file.stream.atEnd()) {
 		file.stream >> singlePeerFrom >> singlePeerTill;
 	}
+	if (!file.stream.atEnd()) {
+		file.stream >> onlyNewMessages;
+	}
+	if (!file.stream.atEnd()) {
+		file.stream >> packToArchive;
+	}
 	auto result = Export::Settings();
 	result.types = Export::Settings::Types::from_raw(types);
 	result.fullChats = Export::Settings::Types::from_raw(fullChats);
@@ -2904,6 +3095,8 @@ Export::Settings Account::readExportSettings() {
 	}();
 	result.singlePeerFrom = singlePeerFrom;
 	result.singlePeerTill = singlePeerTill;
+	result.onlyNewMessages = (onlyNewMessages == 1);
+	result.packToArchive = (packToArchive == 1);
 	return (file.stream.status() == QDataStream::Ok && result.validate())
 		? result
 		: Export::Settings();
@@ -31,6 +31,7 @@ class SessionSettings;
 
 namespace Data {
 class WallPaper;
+enum class StickersType : uchar;
 } // namespace Data
 
 namespace MTP {
@@ -68,6 +69,9 @@ public:
 	~Account();
 
 	[[nodiscard]] StartResult legacyStart(const QByteArray &passcode);
+
+	// Reads the files of start() from the disk on a background thread.
+	void prefetchMap() const;
 	[[nodiscard]] std::unique_ptr<MTP::Config> start(
 		MTP::AuthKeyPtr localKey);
 	void startAdded(MTP::AuthKeyPtr localKey);
@@ -139,6 +143,10 @@ public:
 	void writeInstalledCustomEmoji();
 	void writeFeaturedCustomEmoji();
 	void readInstalledCustomEmoji();
+
+	// Many sets can be received one by one, so the list is written once.
+	void writeInstalledSetsDelayed(Data::StickersType type);
+	void writeInstalledSetsIfNeeded();
 	void readFeaturedCustomEmoji();
 
 	void writeRecentHashtagsAndBots();
@@ -208,9 +216,18 @@ private:
 		MTP::AuthKeyPtr localKey,
 		const QByteArray &legacyPasscode = QByteArray());
 	void clearLegacyFiles();
+	void prefetchStickerSets() const;
 	void writeMapDelayed();
 	void writeMapQueued();
 	void writeMap();
+	void readMapJournal(
+		const MTP::AuthKeyPtr &localKey,
+		base::flat_map<PeerId, FileKey> &draftsMap,
+		base::flat_map<PeerId, FileKey> &draftCursorsMap,
+		base::flat_map<PeerId, bool> &draftsNotReadMap);
+	void writeMapJournal(quint32 keyType, PeerId peerId, FileKey key);
+	void writeMapJournalFile();
+	void clearMapJournal();
 
 	void readLocations();
 	void writeLocations();
@@ -322,9 +339,15 @@ private:
 	base::Timer _writeMapTimer;
 	base::Timer _writeLocationsTimer;
 	base::Timer _writeSearchSuggestionsTimer;
+	base::Timer _writeInstalledSetsTimer;
+	base::flat_set<Data::StickersType> _installedSetsToWrite;
 	bool _mapChanged = false;
 	bool _locationsChanged = false;
 
+	// Encrypted records of draft keys changes since the last map write.
+	std::vector<QByteArray> _mapJournal;
+	bool _mapJournalWriteQueued = false;
+
 };
 
 [[nodiscard]] Webview::StorageId TonSiteStorageId();
@@ -8,11 +8,13 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "storage/storage_domain.h"
 
 #include "storage/details/storage_file_utilities.h"
+#include "storage/storage_account.h"
 #include "storage/serialize_common.h"
 #include "mtproto/mtproto_config.h"
 #include "main/main_domain.h"
 #include "main/main_account.h"
 #include "base/random.h"
+#include "core/core_startup_trace.h"
 
 namespace Storage {
 namespace {
@@ -39,6 +41,7 @@ Domain::Domain(not_null<Main::Domain*> owner, const QString &dataName)
 Domain::~Domain() = default;
 
 StartResult Domain::start(const QByteArray &passcode) {
+	const auto trace = Core::StartupTrace::Span("Storage::Domain::start");
 	const auto modern = startModern(passcode);
 	if (modern == StartModernResult::Success) {
 		if (_oldVersion < AppVersion) {
@@ -167,9 +170,13 @@ Domain::StartModernResult Domain::startModern(
 
 	_oldVersion = keyData.version;
 
+	struct Prepared {
+		int index = 0;
+		std::unique_ptr<Main::Account> account;
+		std::unique_ptr<MTP::Config> config;
+	};
 	auto tried = base::flat_set<int>();
-	auto sessions = base::flat_set<uint64>();
-	auto active = 0;
+	auto accounts = std::vector<Prepared>();
 	for (auto i = 0; i != count; ++i) {
 		auto index = qint32();
 		info.stream >> index;
@@ -180,21 +187,32 @@ Domain::StartModernResult Domain::startModern(
 				_owner,
 				_dataName,
 				index);
-			auto config = account->prepareToStart(_localKey);
-			const auto sessionId = account->willHaveSessionUniqueId(
-				config.get());
-			if (!sessions.contains(sessionId)
-				&& (sessionId != 0 || (sessions.empty() && i + 1 == count))) {
-				if (sessions.empty()) {
-					active = index;
-				}
-				account->start(std::move(config));
-				_owner->accountAddedInStorage({
-					.index = index,
-					.account = std::move(account)
-				});
-				sessions.emplace(sessionId);
+
+			// Read the files of all accounts from the disk in parallel.
+			account->local().prefetchMap();
+			accounts.push_back({
+				.index = index,
+				.account = std::move(account),
+			});
+		}
+	}
+
+	auto sessions = base::flat_set<uint64>();
+	auto active = 0;
+	for (auto i = 0; i != int(accounts.size()); ++i) {
+		auto &prepared = accounts[i];
+		prepared.config = prepared.account->prepareToStart(_localKey);
+		const auto sessionId = prepared.account->willHaveSessionUniqueId(
+			prepared.config.get());
+		const auto last = (i + 1 == int(accounts.size()));
+		if (!sessions.contains(sessionId)
+			&& (sessionId != 0 || (sessions.empty() && last))) {
+			if (sessions.empty()) {
+				active = prepared.index;
 			}
+			sessions.emplace(sessionId);
+		} else {
+			prepared.account = nullptr;
 		}
 	}
 	if (sessions.empty()) {
@@ -205,6 +223,34 @@ Domain::StartModernResult Domain::startModern(
 	if (!info.stream.atEnd()) {
 		info.stream >> active;
 	}
+
+	// Start the active account first, so that its connection and its
+	// session bootstrap are not queued after the other accounts.
+	const auto start = [&](Prepared &prepared) {
+		if (const auto account = prepared.account.get()) {
+			account->start(base::take(prepared.config));
+		}
+	};
+	const auto isActive = [&](const Prepared &prepared) {
+		return (prepared.index == active);
+	};
+	const auto i = ranges::find_if(accounts, isActive);
+	if (i != end(accounts)) {
+		start(*i);
+	}
+	for (auto &prepared : accounts) {
+		if (!isActive(prepared)) {
+			start(prepared);
+		}
+	}
+	for (auto &prepared : accounts) {
+		if (prepared.account) {
+			_owner->accountAddedInStorage({
+				.index = prepared.index,
+				.account = std::move(prepared.account),
+			});
+		}
+	}
 	_owner->activateFromStorage(active);
 
 	Ensures(!sessions.empty());
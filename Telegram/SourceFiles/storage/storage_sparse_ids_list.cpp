@@ -8,6 +8,11 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "storage/storage_sparse_ids_list.h"
 
 namespace Storage {
+namespace {
+
+constexpr auto kInsertOneByOneLimit = 8;
+
+} // namespace
 
 SparseIdsList::Slice::Slice(
 	base::flat_set<MsgId> &&messages,
@@ -23,7 +28,24 @@ void SparseIdsList::Slice::merge(
 	Expects(moreNoSkipRange.from <= range.till);
 	Expects(range.from <= moreNoSkipRange.till);
 
-	messages.merge(std::begin(moreMessages), std::end(moreMessages));
+	const auto from = std::begin(moreMessages);
+	const auto till = std::end(moreMessages);
+	if (std::distance(from, till) <= kInsertOneByOneLimit) {
+		for (auto i = from; i != till; ++i) {
+			messages.insert(*i);
+		}
+	} else if (!messages.empty()
+		&& *ranges::min_element(from, till) > messages.back()) {
+		// Newer messages or the next slice being united with this one,
+		// appending them in order doesn't require sorting everything.
+		auto sorted = std::vector<MsgId>(from, till);
+		ranges::sort(sorted);
+		for (const auto id : sorted) {
+			messages.insert(id);
+		}
+	} else {
+		messages.merge(from, till);
+	}
 	range = {
 		qMin(range.from, moreNoSkipRange.from),
 		qMax(range.till, moreNoSkipRange.till)
@@ -8,7 +8,12 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "support/support_preload.h"
 
 #include "history/history.h"
+#include "history/history_item.h"
+#include "history/view/history_view_element.h"
 #include "data/data_peer.h"
+#include "data/data_photo.h"
+#include "data/data_photo_media.h"
+#include "data/data_media_types.h"
 #include "data/data_session.h"
 #include "data/data_histories.h"
 #include "main/main_session.h"
@@ -18,10 +23,43 @@ namespace Support {
 namespace {
 
 constexpr auto kPreloadMessagesCount = 50;
+constexpr auto kPreloadPhotosCount = 4;
+
+void PreloadFirstScreenPhotos(not_null<History*> history, MsgId around) {
+	auto items = std::vector<not_null<HistoryItem*>>();
+	for (const auto &block : history->blocks) {
+		for (const auto &view : block->messages) {
+			items.push_back(view->data());
+		}
+	}
+	if (around) {
+		items.erase(
+			begin(items),
+			ranges::find_if(items, [&](not_null<HistoryItem*> item) {
+				return (item->id >= around);
+			}));
+	} else {
+		ranges::reverse(items);
+	}
+	auto left = kPreloadPhotosCount;
+	for (const auto &item : items) {
+		if (!left) {
+			break;
+		}
+		const auto media = item->media();
+		if (const auto photo = media ? media->photo() : nullptr) {
+			photo->createMediaView()->automaticLoad(item->fullId(), item);
+			--left;
+		}
+	}
+}
 
 } // namespace
 
-int SendPreloadRequest(not_null<History*> history, Fn<void()> retry) {
+int SendPreloadRequest(
+		not_null<History*> history,
+		Fn<void()> retry,
+		Fn<void()> done) {
 	auto offsetId = MsgId();
 	auto offset = 0;
 	auto loadCount = kPreloadMessagesCount;
@@ -67,7 +105,9 @@ int SendPreloadRequest(not_null<History*> history, Fn<void()> retry) {
 				history->owner().processChats(data.vchats());
 				history->addOlderSlice(data.vmessages().v);
 			});
+			PreloadFirstScreenPhotos(history, offsetId);
 			finish();
+			done();
 		}).fail([=](const MTP::Error &error) {
 			finish();
 		}).send();
@@ -12,8 +12,10 @@ class History;
 namespace Support {
 
 // Returns histories().request, not api().request.
+// Photos of the first screen are preloaded by the auto download settings.
 [[nodiscard]] int SendPreloadRequest(
 	not_null<History*> history,
-	Fn<void()> retry);
+	Fn<void()> retry,
+	Fn<void()> done);
 
 } // namespace Support
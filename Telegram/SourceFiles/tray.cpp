@@ -105,7 +105,15 @@ void Tray::updateMenuText() {
 }
 
 void Tray::updateIconCounters() {
-	_tray.updateIcon();
+	// Each window requests an update for the same badge change.
+	if (_iconUpdateQueued) {
+		return;
+	}
+	_iconUpdateQueued = true;
+	crl::on_main(this, [=] {
+		_iconUpdateQueued = false;
+		_tray.updateIcon();
+	});
 }
 
 rpl::producer<> Tray::aboutToShowRequests() const {
@@ -7,11 +7,12 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #pragma once
 
+#include "base/weak_ptr.h"
 #include "platform/platform_tray.h"
 
 namespace Core {
 
-class Tray final {
+class Tray final : public base::has_weak_ptr {
 public:
 	Tray();
 
@@ -32,6 +33,7 @@ private:
 	Platform::Tray _tray;
 
 	bool _activeForTrayIconAction = false;
+	bool _iconUpdateQueued = false;
 	crl::time _lastTrayClickTime = 0;
 
 	rpl::event_stream<> _textUpdates;
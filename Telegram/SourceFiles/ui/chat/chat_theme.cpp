@@ -25,11 +25,18 @@ namespace {
 constexpr auto kCacheBackgroundTimeout = 1 * crl::time(1000);
 constexpr auto kCacheBackgroundFastTimeout = crl::time(200);
 constexpr auto kBackgroundFadeDuration = crl::time(200);
+constexpr auto kBackgroundPreviewDivider = 4;
 constexpr auto kMinimumTiledSize = 512;
 constexpr auto kMaxSize = 2960;
 constexpr auto kMaxContrastValue = 21.;
 constexpr auto kMinAcceptableContrast = 1.14;// 4.5;
 
+[[nodiscard]] QSize BackgroundPreviewArea(QSize area) {
+	return QSize(
+		std::max(area.width() / kBackgroundPreviewDivider, 1),
+		std::max(area.height() / kBackgroundPreviewDivider, 1));
+}
+
 [[nodiscard]] QColor DefaultBackgroundColor() {
 	return QColor(213, 223, 233);
 }
@@ -502,10 +509,14 @@ const BackgroundState &ChatTheme::backgroundState(QSize area) {
 	if (_backgroundState.now.pixmap.isNull()
 		&& !background().gradientForFill.isNull()) {
 		// We don't support direct painting of patterned gradients.
-		// So we need to sync-generate cache image here.
+		// So we need to sync-generate cache image here. Generate a low
+		// resolution one, it is stretched to the area until the full one
+		// is generated on a worker thread.
 		_cacheBackgroundArea = area;
-		setCachedBackground(CacheBackground(cacheBackgroundRequest(area)));
+		setCachedBackground(CacheBackground(
+			cacheBackgroundRequest(BackgroundPreviewArea(area))));
 		_cacheBackgroundTimer->cancel();
+		cacheBackgroundNow();
 	} else if (_backgroundState.now.area != area) {
 		if (_cacheBackgroundArea != area
 			|| (!_cacheBackgroundTimer->isActive()
@@ -530,7 +541,8 @@ bool ChatTheme::readyForBackgroundRotation() const {
 	return !On(PowerSaving::kChatBackground)
 		&& !_backgroundFade.animating()
 		&& !_cacheBackgroundTimer->isActive()
-		&& !_backgroundState.now.pixmap.isNull();
+		&& !_backgroundState.now.pixmap.isNull()
+		&& (_backgroundState.now.area == _cacheBackgroundArea);
 }
 
 void ChatTheme::generateNextBackgroundRotation() {
@@ -582,12 +594,41 @@ void ChatTheme::cacheBackground() {
 	const auto now = crl::now();
 	if (now - _lastBackgroundAreaChangeTime < kCacheBackgroundTimeout
 		&& QGuiApplication::mouseButtons() != 0) {
+		cacheBackgroundPreview();
 		_cacheBackgroundTimer->callOnce(kCacheBackgroundFastTimeout);
 		return;
 	}
 	cacheBackgroundNow();
 }
 
+void ChatTheme::cacheBackgroundPreview() {
+	// While the window is being resized we replace the stretched cache
+	// with a low resolution one of the right proportions and generate the
+	// full one only when the resize is finished.
+	const auto area = BackgroundPreviewArea(_cacheBackgroundArea);
+	if (_backgroundCachingRequest || _backgroundState.now.area == area) {
+		return;
+	}
+	const auto request = cacheBackgroundRequest(area);
+	if (!request) {
+		return;
+	}
+	cacheBackgroundAsync(request, [=](CacheBackgroundResult &&result) {
+		_backgroundCachingRequest = {};
+		const auto now = cacheBackgroundRequest(
+			BackgroundPreviewArea(_cacheBackgroundArea));
+		if (now != request) {
+			return;
+		}
+		_backgroundNext = {};
+		_backgroundFade.stop();
+		_backgroundState.was = {};
+		_backgroundState.now = std::move(result);
+		_backgroundState.shown = 1.;
+		_repaintBackgroundRequests.fire({});
+	});
+}
+
 void ChatTheme::cacheBackgroundNow() {
 	if (!_backgroundCachingRequest) {
 		if (const auto request = cacheBackgroundRequest(
@@ -173,6 +173,7 @@ public:
 private:
 	void cacheBackground();
 	void cacheBackgroundNow();
+	void cacheBackgroundPreview();
 	void cacheBackgroundAsync(
 		const CacheBackgroundRequest &request,
 		Fn<void(CacheBackgroundResult&&)> done = nullptr);
@@ -14,9 +14,29 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 namespace Ui {
 namespace Premium {
+namespace {
 
 constexpr auto kDeformationMax = 0.1;
 
+// Rendering the svg for each star in each frame is too expensive,
+// so it is rasterized once at the largest size a star can have.
+[[nodiscard]] QImage PrepareSprite(const QString &path, float64 side) {
+	const auto ratio = style::DevicePixelRatio();
+	const auto size = int(std::ceil(side * ratio));
+	auto result = QImage(
+		QSize(size, size),
+		QImage::Format_ARGB32_Premultiplied);
+	result.setDevicePixelRatio(ratio);
+	result.fill(Qt::transparent);
+	{
+		auto p = QPainter(&result);
+		QSvgRenderer(path).render(&p, QRectF(0, 0, side, side));
+	}
+	return result;
+}
+
+} // namespace
+
 MiniStars::MiniStars(
 	Fn<void(const QRect &r)> updateCallback,
 	bool opaque,
@@ -36,7 +56,9 @@ MiniStars::MiniStars(
 , _appearProgressTill(0.2)
 , _disappearProgressAfter(0.8)
 , _distanceProgressStart(0.5)
-, _sprite(u":/gui/icons/settings/starmini.svg"_q)
+, _sprite(PrepareSprite(
+	u":/gui/icons/settings/starmini.svg"_q,
+	(_size.from + _size.length) * (1. + kDeformationMax)))
 , _animation([=](crl::time now) {
 	if (now > _nextBirthTime && !_paused) {
 		createStar(now);
@@ -46,8 +68,9 @@ MiniStars::MiniStars(
 	}
 }) {
 	if (type == Type::BiStars) {
-		_secondSprite = std::make_unique<QSvgRenderer>(
-			u":/gui/icons/settings/star.svg"_q);
+		_secondSprite = PrepareSprite(
+			u":/gui/icons/settings/star.svg"_q,
+			(_size.from + _size.length) * (1. + kDeformationMax));
 	}
 	if (anim::Disabled()) {
 		const auto from = _deathTime.from + _deathTime.length;
@@ -76,7 +99,9 @@ crl::time MiniStars::timeNow() const {
 void MiniStars::paint(QPainter &p, const QRectF &rect) {
 	const auto center = rect.center();
 	const auto opacity = p.opacity();
+	const auto smooth = p.testRenderHint(QPainter::SmoothPixmapTransform);
 	const auto now = timeNow();
+	p.setRenderHint(QPainter::SmoothPixmapTransform);
 	for (const auto &ministar : _ministars) {
 		const auto progress = (now - ministar.birthTime)
 			/ float64(ministar.deathTime - ministar.birthTime);
@@ -87,8 +112,8 @@ void MiniStars::paint(QPainter &p, const QRectF &rect) {
 			progress / _appearProgressTill,
 			0.,
 			1.);
-		const auto rsin = float(std::sin(ministar.angle * M_PI / 180.));
-		const auto rcos = float(std::cos(ministar.angle * M_PI / 180.));
+		const auto rsin = ministar.angleSin;
+		const auto rcos = ministar.angleCos;
 		const auto end = QPointF(
 			rect.width() / kSizeFactor * rcos,
 			rect.height() / kSizeFactor * rsin);
@@ -125,10 +150,11 @@ void MiniStars::paint(QPainter &p, const QRectF &rect) {
 				- starHeight / 2.,
 			starWidth,
 			starHeight);
-		ministar.sprite->render(&p, renderRect);
+		p.drawImage(renderRect, *ministar.sprite);
 		_rectToUpdate |= renderRect.toRect();
 	}
 	p.setOpacity(opacity);
+	p.setRenderHint(QPainter::SmoothPixmapTransform, smooth);
 }
 
 void MiniStars::setPaused(bool paused) {
@@ -147,17 +173,20 @@ void MiniStars::createStar(crl::time now) {
 
 	const auto &angleInterval = _availableAngles[
 		uchar(next()) % _availableAngles.size()];
+	const auto angle = randomInterval(angleInterval, next()) * M_PI / 180.;
 
 	auto ministar = MiniStar{
 		.birthTime = now,
 		.deathTime = now + randomInterval(_deathTime, next()),
-		.angle = randomInterval(angleInterval, next()),
+		.angleSin = float(std::sin(angle)),
+		.angleCos = float(std::cos(angle)),
 		.size = float64(randomInterval(_size, next())),
 		.alpha = float64(randomInterval(_alpha, next())) / 100.,
 		.sinFactor = randomInterval(_sinFactor, next()) / 100.
 			* ((uchar(next()) % 2) == 1 ? 1. : -1.),
-		.sprite = ((randomInterval(_spritesCount, next()) && _secondSprite)
-			? _secondSprite.get()
+		.sprite = ((randomInterval(_spritesCount, next())
+				&& !_secondSprite.isNull())
+			? &_secondSprite
 			: &_sprite),
 	};
 	for (auto i = 0; i < _ministars.size(); i++) {
@@ -35,11 +35,12 @@ private:
 	struct MiniStar {
 		crl::time birthTime = 0;
 		crl::time deathTime = 0;
-		int angle = 0;
+		float64 angleSin = 0.;
+		float64 angleCos = 0.;
 		float64 size = 0.;
 		float64 alpha = 0.;
 		float64 sinFactor = 0.;
-		not_null<QSvgRenderer*> sprite;
+		not_null<const QImage*> sprite;
 	};
 
 	struct Interval {
@@ -65,8 +66,8 @@ private:
 	const float64 _disappearProgressAfter;
 	const float64 _distanceProgressStart;
 
-	QSvgRenderer _sprite;
-	std::unique_ptr<QSvgRenderer> _secondSprite;
+	QImage _sprite;
+	QImage _secondSprite;
 
 	Ui::Animations::Basic _animation;
 
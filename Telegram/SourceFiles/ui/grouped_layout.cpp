@@ -7,9 +7,15 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #include "ui/grouped_layout.h"
 
+#include "base/flat_map.h"
+
+#include <QtCore/QMutex>
+
 namespace Ui {
 namespace {
 
+constexpr auto kMaxCachedLayouts = 512;
+
 int Round(float64 value) {
 	return int(base::SafeRound(value));
 }
@@ -564,6 +570,33 @@ std::vector<GroupMediaLayout> ComplexLayouter::layout() const {
 	return result;
 }
 
+struct LayoutsCache {
+	QMutex mutex;
+	base::flat_map<std::vector<int>, std::vector<GroupMediaLayout>> map;
+};
+
+[[nodiscard]] LayoutsCache &GlobalLayoutsCache() {
+	static auto result = LayoutsCache();
+	return result;
+}
+
+[[nodiscard]] std::vector<int> LayoutKey(
+		const std::vector<QSize> &sizes,
+		int maxWidth,
+		int minWidth,
+		int spacing) {
+	auto result = std::vector<int>();
+	result.reserve(sizes.size() * 2 + 3);
+	result.push_back(maxWidth);
+	result.push_back(minWidth);
+	result.push_back(spacing);
+	for (const auto &size : sizes) {
+		result.push_back(size.width());
+		result.push_back(size.height());
+	}
+	return result;
+}
+
 } // namespace
 
 std::vector<GroupMediaLayout> LayoutMediaGroup(
@@ -571,7 +604,25 @@ std::vector<GroupMediaLayout> LayoutMediaGroup(
 		int maxWidth,
 		int minWidth,
 		int spacing) {
-	return Layouter(sizes, maxWidth, minWidth, spacing).layout();
+	// The same albums are laid out each time their views are created or
+	// invalidated, so the computed layouts are shared by all of them.
+	auto key = LayoutKey(sizes, maxWidth, minWidth, spacing);
+	auto &cache = GlobalLayoutsCache();
+	{
+		QMutexLocker lock(&cache.mutex);
+		const auto i = cache.map.find(key);
+		if (i != end(cache.map)) {
+			return i->second;
+		}
+	}
+	auto result = Layouter(sizes, maxWidth, minWidth, spacing).layout();
+
+	QMutexLocker lock(&cache.mutex);
+	if (cache.map.size() >= kMaxCachedLayouts) {
+		cache.map.clear();
+	}
+	cache.map.emplace(std::move(key), result);
+	return result;
 }
 
 RectParts GetCornersFromSides(RectParts sides) {
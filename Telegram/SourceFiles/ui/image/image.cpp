@@ -88,6 +88,14 @@ QImage Image::original() const {
 	return _data;
 }
 
+int64 Image::memoryBytes() const {
+	auto result = int64(_data.sizeInBytes());
+	for (const auto &[key, pixmap] : _cache) {
+		result += int64(pixmap.width()) * pixmap.height() * pixmap.depth() / 8;
+	}
+	return result;
+}
+
 const QPixmap &Image::cached(
 		int w,
 		int h,
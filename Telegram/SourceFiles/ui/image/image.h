@@ -36,6 +36,9 @@ public:
 
 	[[nodiscard]] QImage original() const;
 
+	// Pixel data of the original together with all cached pixmaps.
+	[[nodiscard]] int64 memoryBytes() const;
+
 	[[nodiscard]] const QPixmap &pix(
 			QSize size,
 			const Images::PrepareArgs &args = {}) const {
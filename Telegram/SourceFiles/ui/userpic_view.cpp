@@ -9,8 +9,96 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include "ui/empty_userpic.h"
 #include "ui/image/image_prepare.h"
+#include "base/flat_map.h"
 
 namespace Ui {
+namespace {
+
+constexpr auto kMaxSharedUserpics = 512;
+constexpr auto kMaxSharedUserpicSize = 160;
+
+struct SharedUserpicKey {
+	qint64 image = 0;
+	int size = 0;
+	int ratio = 0;
+	bool forum = false;
+
+	friend inline auto operator<=>(
+		SharedUserpicKey,
+		SharedUserpicKey) = default;
+	friend inline bool operator==(
+		SharedUserpicKey,
+		SharedUserpicKey) = default;
+};
+
+struct SharedUserpic {
+	QImage image;
+	uint64 used = 0;
+};
+
+struct SharedUserpics {
+	base::flat_map<SharedUserpicKey, SharedUserpic> map;
+	uint64 counter = 0;
+};
+
+[[nodiscard]] SharedUserpics &GlobalSharedUserpics() {
+	static auto result = SharedUserpics();
+	return result;
+}
+
+[[nodiscard]] QImage PrepareCloudUserpic(
+		const QImage &cloud,
+		int size,
+		bool forum) {
+	auto result = cloud.scaled(
+		QSize(size, size),
+		Qt::IgnoreAspectRatio,
+		Qt::SmoothTransformation);
+	return forum
+		? Images::Round(
+			std::move(result),
+			Images::CornersMask(size
+				* Ui::ForumUserpicRadiusMultiplier()
+				/ style::DevicePixelRatio()))
+		: Images::Circle(std::move(result));
+}
+
+// The same userpic is shown in the chats list, in the chat and in the
+// members list at the same size, so the rasterized images are shared.
+[[nodiscard]] QImage SharedCloudUserpic(
+		const QImage &cloud,
+		int size,
+		bool forum) {
+	if (size > kMaxSharedUserpicSize) {
+		return PrepareCloudUserpic(cloud, size, forum);
+	}
+	auto &shared = GlobalSharedUserpics();
+	const auto key = SharedUserpicKey{
+		.image = cloud.cacheKey(),
+		.size = size,
+		.ratio = style::DevicePixelRatio(),
+		.forum = forum,
+	};
+	const auto i = shared.map.find(key);
+	if (i != end(shared.map)) {
+		i->second.used = ++shared.counter;
+		return i->second.image;
+	}
+	if (shared.map.size() >= kMaxSharedUserpics) {
+		shared.map.erase(ranges::min_element(
+			shared.map,
+			ranges::less(),
+			[](const auto &pair) { return pair.second.used; }));
+	}
+	auto result = PrepareCloudUserpic(cloud, size, forum);
+	shared.map.emplace(key, SharedUserpic{
+		.image = result,
+		.used = ++shared.counter,
+	});
+	return result;
+}
+
+} // namespace
 
 float64 ForumUserpicRadiusMultiplier() {
 	return 0.3;
@@ -44,19 +132,7 @@ void ValidateUserpicCache(
 	view.paletteVersion = version;
 
 	if (cloud) {
-		view.cached = cloud->scaled(
-			full,
-			Qt::IgnoreAspectRatio,
-			Qt::SmoothTransformation);
-		if (forum) {
-			view.cached = Images::Round(
-				std::move(view.cached),
-				Images::CornersMask(size
-					* Ui::ForumUserpicRadiusMultiplier()
-					/ style::DevicePixelRatio()));
-		} else {
-			view.cached = Images::Circle(std::move(view.cached));
-		}
+		view.cached = SharedCloudUserpic(*cloud, size, forum);
 	} else {
 		if (view.cached.size() != full) {
 			view.cached = QImage(full, QImage::Format_ARGB32_Premultiplied);
@@ -20,6 +20,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "main/main_account.h" // Account::sessionValue.
 #include "main/main_domain.h"
 #include "core/application.h"
+#include "core/core_paint_profiler.h"
 #include "core/sandbox.h"
 #include "core/shortcuts.h"
 #include "lang/lang_keys.h"
@@ -365,6 +366,9 @@ MainWindow::MainWindow(not_null<Controller*> controller)
 
 	if (isPrimary()) {
 		Ui::Toast::SetDefaultParent(_body.data());
+		if (Core::PaintProfiler::Enabled()) {
+			_paintProfiler = Core::PaintProfiler::CreateOverlay(_body.data());
+		}
 	}
 
 	windowActiveValue(
@@ -216,6 +216,7 @@ private:
 	object_ptr<Ui::RpWidget> _outdated;
 	object_ptr<Ui::RpWidget> _body;
 	object_ptr<TWidget> _rightColumn = { nullptr };
+	object_ptr<Ui::RpWidget> _paintProfiler = { nullptr };
 
 	bool _isActive = false;
 
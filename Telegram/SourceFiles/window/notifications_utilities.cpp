@@ -21,14 +21,38 @@ namespace {
 // Delete notify photo file after 1 minute of not using.
 constexpr int kNotifyDeletePhotoAfterMs = 60000;
 
+constexpr auto kGeneratedUserpicsLimit = 64;
+
+struct GeneratedUserpic {
+	QImage image;
+	bool forum = false;
+};
+
 } // namespace
 
 QImage GenerateUserpic(not_null<PeerData*> peer, Ui::PeerUserpicView &view) {
-	return peer->isSelf()
-		? Ui::EmptyUserpic::GenerateSavedMessages(st::notifyMacPhotoSize)
-		: peer->isRepliesChat()
-		? Ui::EmptyUserpic::GenerateRepliesMessages(st::notifyMacPhotoSize)
-		: PeerData::GenerateUserpicImage(peer, view, st::notifyMacPhotoSize);
+	const auto size = st::notifyMacPhotoSize;
+	if (peer->isSelf()) {
+		return Ui::EmptyUserpic::GenerateSavedMessages(size);
+	} else if (peer->isRepliesChat()) {
+		return Ui::EmptyUserpic::GenerateRepliesMessages(size);
+	}
+
+	// A busy chat shows the same userpic many times in a row.
+	static auto Generated = base::flat_map<InMemoryKey, GeneratedUserpic>();
+	const auto key = peer->userpicUniqueKey(view);
+	const auto forum = peer->isForum();
+	const auto i = Generated.find(key);
+	if (i != end(Generated)
+		&& i->second.forum == forum
+		&& i->second.image.width() == size) {
+		return i->second.image;
+	} else if (Generated.size() >= kGeneratedUserpicsLimit) {
+		Generated.clear();
+	}
+	auto result = PeerData::GenerateUserpicImage(peer, view, size);
+	Generated[key] = { .image = result, .forum = forum };
+	return result;
 }
 
 CachedUserpics::CachedUserpics()
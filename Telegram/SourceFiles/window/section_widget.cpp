@@ -9,6 +9,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include "mainwidget.h"
 #include "mainwindow.h"
+#include "core/core_paint_profiler.h"
 #include "ui/ui_utility.h"
 #include "ui/chat/chat_theme.h"
 #include "ui/painter.h"
@@ -350,6 +351,8 @@ void SectionWidget::PaintBackground(
 		not_null<Ui::ChatTheme*> theme,
 		QSize fill,
 		QRect clip) {
+	const auto profiler = Core::PaintProfiler::Scope(
+		Core::PaintProfiler::Section::ChatBackground);
 	const auto &background = theme->background();
 	if (background.colorForFill) {
 		p.fillRect(clip, *background.colorForFill);
@@ -180,7 +180,14 @@ void Controller::showAccount(
 			: nullptr;
 		_sessionControllerValue = _sessionController.get();
 
-		auto oldContentCache = _widget.grabForSlideAnimation();
+		// Switching between authorized accounts is instant, so
+		// rendering the whole window offscreen is skipped then.
+		const auto animated = session
+			? _widget.mainShowAnimated()
+			: _widget.introShowAnimated();
+		auto oldContentCache = animated
+			? _widget.grabForSlideAnimation()
+			: QPixmap();
 		_widget.updateWindowIcon();
 		if (session) {
 			setupSideBar();
@@ -35,6 +35,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_download_manager.h"
 #include "data/data_saved_messages.h"
 #include "data/data_session.h"
+#include "data/data_histories.h"
 #include "data/data_file_origin.h"
 #include "data/data_folder.h"
 #include "data/data_channel.h"
@@ -1300,6 +1301,13 @@ SessionController::SessionController(
 		closeFolder();
 	}, lifetime());
 
+	activeChatChanges(
+	) | rpl::filter([](Dialogs::Key key) {
+		return key.history() != nullptr;
+	}) | rpl::start_with_next([=] {
+		session->downloader().prewarmRecentDcs();
+	}, lifetime());
+
 	session->data().chatsFilters().changed(
 	) | rpl::start_with_next([=] {
 		checkOpenedFilter();
@@ -1724,12 +1732,14 @@ void SessionController::setActiveChatEntry(Dialogs::RowDescriptor row) {
 	const auto was = _activeChatEntry.current().key.history();
 	const auto now = row.key.history();
 	if (was && was != now) {
+		session().data().histories().historyVisited(was);
 		_activeHistoryLifetime.destroy();
 		was->setFakeUnreadWhileOpened(false);
 		_invitePeekTimer.cancel();
 	}
 	_activeChatEntry = row;
 	if (now) {
+		session().data().histories().historyVisited(now);
 		now->setFakeUnreadWhileOpened(true);
 		if (const auto channel = now->peer->asChannel()
 			; channel && !channel->isForum()) {
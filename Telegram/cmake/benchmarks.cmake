@@ -0,0 +1,34 @@
+# This file is part of Telegram Desktop,
+# the official desktop application for the Telegram messaging service.
+#
+# For license and copyright information please follow this link:
+# https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+
+add_executable(benchmarks)
+init_target(benchmarks "(tests)")
+
+target_include_directories(benchmarks PRIVATE ${src_loc})
+
+target_precompile_headers(benchmarks PRIVATE ${src_loc}/benchmarks/benchmarks_pch.h)
+nice_target_sources(benchmarks ${src_loc}
+PRIVATE
+    benchmarks/benchmark_main.cpp
+    benchmarks/benchmark_main.h
+    benchmarks/benchmark_scheme.cpp
+    benchmarks/benchmark_sparse_ids.cpp
+    benchmarks/benchmarks_pch.h
+
+    storage/storage_sparse_ids_list.cpp
+    storage/storage_sparse_ids_list.h
+)
+
+target_link_libraries(benchmarks
+PRIVATE
+    tdesktop::td_scheme
+    desktop-app::lib_base
+    desktop-app::lib_crl
+    desktop-app::lib_ui
+    desktop-app::external_qt
+)
+
+set_target_properties(benchmarks PROPERTIES RUNTIME_OUTPUT_DIRECTORY ${CMAKE_BINARY_DIR})
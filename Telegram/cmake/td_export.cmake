@@ -13,8 +13,12 @@ nice_target_sources(td_export ${src_loc}
 PRIVATE
     export/export_api_wrap.cpp
     export/export_api_wrap.h
+    export/export_checkpoint.cpp
+    export/export_checkpoint.h
     export/export_controller.cpp
     export/export_controller.h
+    export/export_delta.cpp
+    export/export_delta.h
     export/export_pch.h
     export/export_settings.cpp
     export/export_settings.h
@@ -22,6 +26,8 @@ PRIVATE
     export/data/export_data_types.h
     export/output/export_output_abstract.cpp
     export/output/export_output_abstract.h
+    export/output/export_output_archive.cpp
+    export/output/export_output_archive.h
     export/output/export_output_file.cpp
     export/output/export_output_file.h
     export/output/export_output_html.cpp
@@ -44,4 +50,6 @@ target_link_libraries(td_export
 PUBLIC
     desktop-app::lib_base
     tdesktop::td_scheme
+PRIVATE
+    desktop-app::external_zlib
 )